@@ -117,7 +117,7 @@ void WCConstraintAngle::Initialize(void) {
 	}
 
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* constraintIcon = this->_document->Scene()->TextureManager()->TextureFromName("constraint32");
+	WSTexture* constraintIcon = this->_document->Scene()->TextureFromName("constraint32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, constraintIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -139,7 +139,7 @@ void WCConstraintCoincidence::Initialize(void) {
 		return;
 	}
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* contactIcon = this->_document->Scene()->TextureManager()->TextureFromName("contact32");
+	WSTexture* contactIcon = this->_document->Scene()->TextureFromName("contact32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, contactIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 }
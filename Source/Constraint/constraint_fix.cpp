@@ -124,7 +124,7 @@ WCConstraintFix::WCConstraintFix(WCSketch *sketch, const std::string &name, WCSk
 		return;
 	}
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* fixedIcon = this->_document->Scene()->TextureManager()->TextureFromName("fixed32");
+	WSTexture* fixedIcon = this->_document->Scene()->TextureFromName("fixed32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, fixedIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -157,7 +157,7 @@ WCConstraintFix::WCConstraintFix(xercesc::DOMElement *element, WCSerialDictionar
 		return;
 	}
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* fixedIcon = this->_document->Scene()->TextureManager()->TextureFromName("fixed32");
+	WSTexture* fixedIcon = this->_document->Scene()->TextureFromName("fixed32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, fixedIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -210,7 +210,7 @@ std::list<WCObject*> WCConstraintFix::DeletionDependencies(void) {
 
 void WCConstraintFix::OnSelection(const bool fromManager, std::list<WCVisualObject*> objects) {
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("fixedSelected32");
+	this->_texture = this->_document->Scene()->TextureFromName("fixedSelected32");
 	//Mark this as selected
 	this->_isSelected = true;
 }
@@ -218,7 +218,7 @@ void WCConstraintFix::OnSelection(const bool fromManager, std::list<WCVisualObje
 
 void WCConstraintFix::OnDeselection(const bool fromManager) {
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("fixed32");
+	this->_texture = this->_document->Scene()->TextureFromName("fixed32");
 	//Mark this as selected
 	this->_isSelected = false;
 }
@@ -108,9 +108,9 @@ void WCConstraintHorizontal::Initialize(void) {
 	}
 
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("horizontal32");
+	this->_texture = this->_document->Scene()->TextureFromName("horizontal32");
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* hvIcon = this->_document->Scene()->TextureManager()->TextureFromName("hvConstraint32");
+	WSTexture* hvIcon = this->_document->Scene()->TextureFromName("hvConstraint32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, hvIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -188,7 +188,7 @@ bool WCConstraintHorizontal::Regenerate(void) {
 
 void WCConstraintHorizontal::OnSelection(const bool fromManager, std::list<WCVisualObject*> objects) {
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("horizontalSelected32");
+	this->_texture = this->_document->Scene()->TextureFromName("horizontalSelected32");
 	//Mark this as selected
 	this->_isSelected = true;
 }
@@ -196,7 +196,7 @@ void WCConstraintHorizontal::OnSelection(const bool fromManager, std::list<WCVis
 
 void WCConstraintHorizontal::OnDeselection(const bool fromManager) {
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("horizontal32");
+	this->_texture = this->_document->Scene()->TextureFromName("horizontal32");
 	//Mark this as selected
 	this->_isSelected = false;
 }
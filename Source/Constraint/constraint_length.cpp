@@ -68,7 +68,7 @@ void WCConstraintLength::Initialize(void) {
 	//Create the measure
 	this->GenerateMeasure(0.25*this->_length, 0.5);
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* constraintIcon = this->_document->Scene()->TextureManager()->TextureFromName("constraint32");
+	WSTexture* constraintIcon = this->_document->Scene()->TextureFromName("constraint32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, constraintIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -87,7 +87,7 @@ void WCConstraintRadius::Initialize(const WPFloat &offset, const WPFloat &labelO
 	}
 
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* constraintIcon = this->_document->Scene()->TextureManager()->TextureFromName("constraint32");
+	WSTexture* constraintIcon = this->_document->Scene()->TextureFromName("constraint32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, constraintIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -139,7 +139,7 @@ WCConstraintRadius::WCConstraintRadius(xercesc::DOMElement *element, WCSerialDic
 	//Create the length controller
 	this->_controller = new WCConstraintRadiusController(this);
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* constraintIcon = this->_document->Scene()->TextureManager()->TextureFromName("constraint32");
+	WSTexture* constraintIcon = this->_document->Scene()->TextureFromName("constraint32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, constraintIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -105,9 +105,9 @@ void WCConstraintVertical::Initialize(void) {
 		return;
 	}
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("vertical32");
+	this->_texture = this->_document->Scene()->TextureFromName("vertical32");
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture* hvIcon = this->_document->Scene()->TextureManager()->TextureFromName("hvConstraint32");
+	WSTexture* hvIcon = this->_document->Scene()->TextureFromName("hvConstraint32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, hvIcon);
 	this->_sketch->ConstraintsTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -184,7 +184,7 @@ bool WCConstraintVertical::Regenerate(void) {
 
 void WCConstraintVertical::OnSelection(const bool fromManager, std::list<WCVisualObject*> objects) {
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("verticalSelected32");
+	this->_texture = this->_document->Scene()->TextureFromName("verticalSelected32");
 	//Mark this as selected
 	this->_isSelected = true;
 }
@@ -192,7 +192,7 @@ void WCConstraintVertical::OnSelection(const bool fromManager, std::list<WCVisua
 
 void WCConstraintVertical::OnDeselection(const bool fromManager) {
 	//Setup the icon texture
-	this->_texture = this->_document->Scene()->TextureManager()->TextureFromName("vertical32");
+	this->_texture = this->_document->Scene()->TextureFromName("vertical32");
 	//Mark this as not selected
 	this->_isSelected = false;
 }
@@ -52,62 +52,90 @@ bool WCConverterSTL::ExecuteExport(const std::string &filename, WSTopologyShell
 	WCTrimmedNurbsSurface *trim;
 	GLfloat *vertexBuffer;
 	GLint *indexBuffer;
-	WPUInt lodU = 2, lodV = 2;
+	std::vector<WPUInt> triangleCounts, trimCounts, slots, trimSlots;
+	std::vector<WSFaceUse*> faces;
+	std::vector<WCNurbsSurface*> surfaces;
+	std::vector<WCTrimmedNurbsSurface*> trims;
 
 	//Get the first face in the list of faces
 	firstFace = shell->faceUses;
 	nextFace = firstFace;
 	//Go through each surface of each shell
 	do {
-		//See if the face is a NURBS surface
+		//See if the face is a trimmed NURBS surface and queue it for tessellation
 		trim = dynamic_cast<WCTrimmedNurbsSurface*> (nextFace->surface);
 		if (trim) {
-			//Generate a tessellation of the surface
-			//...
+			trimSlots.push_back(faces.size());
+			trims.push_back(trim);
 		}
-		//Must be a trimmed surface
+		//Must be a plain NURBS surface
 		else {
-			//Cast to a NURBS surface
+			//Cast to a NURBS surface and queue it for tessellation
 			nurbs = dynamic_cast<WCNurbsSurface*> (nextFace->surface);
-			//Generate a client-side bufferes of the surface
-			std::vector<GLfloat*> bufferList = nurbs->GenerateClientBuffers(0.0, 1.0, lodU, 0.0, 1.0, lodV, true);
-			vertexBuffer = bufferList.at(0);
-			indexBuffer = (GLint*) bufferList.at(3);
-			//Determine number of triangles
-			numTriangles = (lodU - 1) * (lodV - 1) * 2;
-			//Go through the index and retrieve vertices
-			for (WPUInt i=0; i<numTriangles; i++) {
-				//Get the three indices
-				index1 = indexBuffer[i*3] * 4;
-				index2 = indexBuffer[i*3+1] * 4;
-				index3 = indexBuffer[i*3+2] * 4;
-				vertex1 = WCVector4(vertexBuffer[index1], vertexBuffer[index1+1], vertexBuffer[index1+2]);
-				vertex2 = WCVector4(vertexBuffer[index2], vertexBuffer[index2+1], vertexBuffer[index2+2]);
-				vertex3 = WCVector4(vertexBuffer[index3], vertexBuffer[index3+1], vertexBuffer[index3+2]);
-				//Calculate the norm
-				WCVector4 vec1 = vertex2 - vertex1;
-				WCVector4 vec2 = vertex3 - vertex1;
-				norm = vec2.CrossProduct(vec1).Normalize(true);
-				//Invert normal if surface is not aligned with faceUse
-				if (!nextFace->orientation) norm *= -1.0;
-				//Output facet to file
-				file << "facet normal " << std::fixed << norm.I() << " " << norm.J() << " " << norm.K() << std::endl;
-				file << "   outer loop\n";
-				file << "      vertex " << std::fixed << vertex1.I() << " " << vertex1.J() << " " << vertex1.K() << std::endl;
-				file << "      vertex " << std::fixed << vertex2.I() << " " << vertex2.J() << " " << vertex2.K() << std::endl;
-				file << "      vertex " << std::fixed << vertex3.I() << " " << vertex3.J() << " " << vertex3.K() << std::endl;
-				file << "   endloop\n";
-				file << "endfacet\n";
-			}
-			//Dispose of the buffers
-			nurbs->ReleaseBuffers(bufferList);
+			slots.push_back(faces.size());
+			surfaces.push_back(nurbs);
 		}
+		faces.push_back(nextFace);
 			
 		//Go to the next face
 		nextFace = nextFace->next;
 	//Only contine until the end of the list of faces
 	} while (nextFace != firstFace);
 
+	//Tessellate all of the surfaces at once to the export tolerance (trimmed faces one per thread)
+	std::vector< std::vector<GLfloat*> > plainLists = WCNurbsSurface::GenerateAdaptiveBuffers(surfaces, tol, triangleCounts, true);
+	std::vector< std::vector<GLfloat*> > trimLists = WCTrimmedNurbsSurface::GenerateTessellation(trims, tol, trimCounts);
+	//Put both back in face order
+	std::vector< std::vector<GLfloat*> > bufferLists(faces.size());
+	std::vector<WCNurbsSurface*> owners(faces.size());
+	std::vector<WPUInt> counts(faces.size());
+	for (WPUInt j=0; j<slots.size(); j++) {
+		bufferLists.at(slots.at(j)) = plainLists.at(j);
+		owners.at(slots.at(j)) = surfaces.at(j);
+		counts.at(slots.at(j)) = triangleCounts.at(j);
+	}
+	for (WPUInt j=0; j<trimSlots.size(); j++) {
+		bufferLists.at(trimSlots.at(j)) = trimLists.at(j);
+		owners.at(trimSlots.at(j)) = trims.at(j);
+		counts.at(trimSlots.at(j)) = trimCounts.at(j);
+	}
+	//Write the facets out in face order
+	for (WPUInt j=0; j<faces.size(); j++) {
+		nextFace = faces.at(j);
+		std::vector<GLfloat*> &bufferList = bufferLists.at(j);
+		if (bufferList.size() < 4) continue;
+		vertexBuffer = bufferList.at(0);
+		indexBuffer = (GLint*) bufferList.at(3);
+		//Determine number of triangles
+		numTriangles = counts.at(j);
+		//Go through the index and retrieve vertices
+		for (WPUInt i=0; i<numTriangles; i++) {
+			//Get the three indices
+			index1 = indexBuffer[i*3] * 4;
+			index2 = indexBuffer[i*3+1] * 4;
+			index3 = indexBuffer[i*3+2] * 4;
+			vertex1 = WCVector4(vertexBuffer[index1], vertexBuffer[index1+1], vertexBuffer[index1+2]);
+			vertex2 = WCVector4(vertexBuffer[index2], vertexBuffer[index2+1], vertexBuffer[index2+2]);
+			vertex3 = WCVector4(vertexBuffer[index3], vertexBuffer[index3+1], vertexBuffer[index3+2]);
+			//Calculate the norm
+			WCVector4 vec1 = vertex2 - vertex1;
+			WCVector4 vec2 = vertex3 - vertex1;
+			norm = vec2.CrossProduct(vec1).Normalize(true);
+			//Invert normal if surface is not aligned with faceUse
+			if (!nextFace->orientation) norm *= -1.0;
+			//Output facet to file
+			file << "facet normal " << std::fixed << norm.I() << " " << norm.J() << " " << norm.K() << std::endl;
+			file << "   outer loop\n";
+			file << "      vertex " << std::fixed << vertex1.I() << " " << vertex1.J() << " " << vertex1.K() << std::endl;
+			file << "      vertex " << std::fixed << vertex2.I() << " " << vertex2.J() << " " << vertex2.K() << std::endl;
+			file << "      vertex " << std::fixed << vertex3.I() << " " << vertex3.J() << " " << vertex3.K() << std::endl;
+			file << "   endloop\n";
+			file << "endfacet\n";
+		}
+		//Dispose of the buffers
+		owners.at(j)->ReleaseBuffers(bufferList);
+	}
+
 	//Close the solid information
 	file << "endsolid " << filename << std::endl;
 	//Close the file	
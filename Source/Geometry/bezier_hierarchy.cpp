@@ -0,0 +1,442 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <Geometry/bezier_hierarchy.h>
+#include <Geometry/nurbs.h>
+#include <algorithm>
+
+
+/***********************************************~***************************************************/
+
+
+//Orders pieces by the centre of their boxes along one axis
+struct _BezierPieceLess {
+	WPUInt axis;
+	_BezierPieceLess(const WPUInt &a) : axis(a) { }
+	bool operator()(const WSBezierPiece &a, const WSBezierPiece &b) const {
+		return (a.lo[axis] + a.hi[axis]) < (b.lo[axis] + b.hi[axis]); }
+};
+
+
+//Cartesian position of a homogeneous point
+static inline void _BezierCartesian(const WPFloat *hcp, WPFloat *pt) {
+	pt[0] = hcp[0] / hcp[3];
+	pt[1] = hcp[1] / hcp[3];
+	pt[2] = hcp[2] / hcp[3];
+}
+
+
+//Bounding box of the Cartesian control hull
+static void _BezierHullBox(const WPFloat *hcp, const WPUInt &count, WPFloat *lo, WPFloat *hi) {
+	WPFloat pt[3];
+	_BezierCartesian(hcp, lo);
+	_BezierCartesian(hcp, hi);
+	for (WPUInt i=1; i<count; i++) {
+		_BezierCartesian(hcp + i*4, pt);
+		for (WPUInt k=0; k<3; k++) {
+			lo[k] = STDMIN(lo[k], pt[k]);
+			hi[k] = STDMAX(hi[k], pt[k]);
+		}
+	}
+}
+
+
+//Distance from a control point to where a linear piece would put it
+static inline WPFloat _BezierLinearDeviation(const WPFloat *hcp, const WPFloat *a, const WPFloat *b, const WPFloat &t) {
+	WPFloat pt[3], pa[3], pb[3], d, dist = 0.0;
+	_BezierCartesian(hcp, pt);
+	_BezierCartesian(a, pa);
+	_BezierCartesian(b, pb);
+	for (WPUInt k=0; k<3; k++) {
+		d = pt[k] - (pa[k] + t * (pb[k] - pa[k]));
+		dist += d * d;
+	}
+	return sqrt(dist);
+}
+
+
+//Distance from a point to a box, zero inside
+static inline WPFloat _BezierBoxDistance(const WPFloat *pt, const WPFloat *lo, const WPFloat *hi) {
+	WPFloat d, dist = 0.0;
+	for (WPUInt k=0; k<3; k++) {
+		d = STDMAX(lo[k] - pt[k], STDMAX(0.0, pt[k] - hi[k]));
+		dist += d * d;
+	}
+	return sqrt(dist);
+}
+
+
+//Ray against a box grown by radius (only the forward half of the ray counts)
+static bool _BezierRayBox(const WPFloat *base, const WPFloat *dir, const WPFloat &radius, const WPFloat *lo, const WPFloat *hi) {
+	WPFloat tMin = 0.0, tMax = 1.0e300, t0, t1;
+	for (WPUInt k=0; k<3; k++) {
+		if (fabs(dir[k]) < 1.0e-300) {
+			if ((base[k] < lo[k] - radius) || (base[k] > hi[k] + radius)) return false;
+			continue;
+		}
+		t0 = (lo[k] - radius - base[k]) / dir[k];
+		t1 = (hi[k] + radius - base[k]) / dir[k];
+		if (t0 > t1) std::swap(t0, t1);
+		tMin = STDMAX(tMin, t0);
+		tMax = STDMIN(tMax, t1);
+		if (tMin > tMax) return false;
+	}
+	return true;
+}
+
+
+//Boxes within radius of each other
+static inline bool _BezierBoxOverlap(const WPFloat *loA, const WPFloat *hiA, const WPFloat *loB, const WPFloat *hiB, const WPFloat &radius) {
+	for (WPUInt k=0; k<3; k++)
+		if ((loA[k] - radius > hiB[k]) || (loB[k] - radius > hiA[k])) return false;
+	return true;
+}
+
+
+/***********************************************~***************************************************/
+
+
+void WCBezierHierarchy::AddCurvePiece(const WPFloat *hcp, const WPFloat &u0, const WPFloat &u1, const WPUInt &depth) {
+	WPUInt p = this->_degreeU;
+	//Flat once every control point sits where a line would put it
+	WPFloat deviation = 0.0;
+	for (WPUInt i=1; i<p; i++)
+		deviation = STDMAX(deviation, _BezierLinearDeviation(hcp + i*4, hcp, hcp + p*4, (WPFloat)i / (WPFloat)p));
+	if ((deviation > this->_tolerance) && (depth < BEZIERHIERARCHY_MAX_DEPTH)) {
+		std::vector<WPFloat> left((p+1)*4), right((p+1)*4);
+		WCNurbs::SubdivideBezier(p, hcp, 4, 0.5, &left[0], &right[0]);
+		WPFloat mid = 0.5 * (u0 + u1);
+		this->AddCurvePiece(&left[0], u0, mid, depth + 1);
+		this->AddCurvePiece(&right[0], mid, u1, depth + 1);
+		return;
+	}
+	//Keep the piece
+	WSBezierPiece piece;
+	piece.uMin = u0;
+	piece.uMax = u1;
+	piece.vMin = piece.vMax = 0.0;
+	piece.offset = (WPUInt)this->_points.size();
+	_BezierHullBox(hcp, p+1, piece.lo, piece.hi);
+	this->_points.insert(this->_points.end(), hcp, hcp + (p+1)*4);
+	this->_pieces.push_back(piece);
+}
+
+
+void WCBezierHierarchy::AddSurfacePiece(const WPFloat *hcp, const WPFloat &u0, const WPFloat &u1,
+	const WPFloat &v0, const WPFloat &v1, const WPUInt &depth) {
+	WPUInt pU = this->_degreeU, pV = this->_degreeV, row = (pU+1)*4, count = (pU+1)*(pV+1);
+	//Deviation of the rows and columns from straight lines, split across the worse direction
+	WPFloat devU = 0.0, devV = 0.0;
+	for (WPUInt j=0; j<=pV; j++)
+		for (WPUInt i=1; i<pU; i++)
+			devU = STDMAX(devU, _BezierLinearDeviation(hcp + j*row + i*4, hcp + j*row, hcp + j*row + pU*4, (WPFloat)i / (WPFloat)pU));
+	for (WPUInt i=0; i<=pU; i++)
+		for (WPUInt j=1; j<pV; j++)
+			devV = STDMAX(devV, _BezierLinearDeviation(hcp + j*row + i*4, hcp + i*4, hcp + pV*row + i*4, (WPFloat)j / (WPFloat)pV));
+	//Twist of the corners away from a parallelogram
+	WPFloat twist = 0.0, c00[3], c10[3], c01[3], c11[3];
+	_BezierCartesian(hcp, c00);
+	_BezierCartesian(hcp + pU*4, c10);
+	_BezierCartesian(hcp + pV*row, c01);
+	_BezierCartesian(hcp + pV*row + pU*4, c11);
+	for (WPUInt k=0; k<3; k++) twist += (c00[k] - c10[k] - c01[k] + c11[k]) * (c00[k] - c10[k] - c01[k] + c11[k]);
+	twist = 0.25 * sqrt(twist);
+	if ((STDMAX(STDMAX(devU, devV), twist) > this->_tolerance) && (depth < BEZIERHIERARCHY_MAX_DEPTH)) {
+		std::vector<WPFloat> left(count*4), right(count*4);
+		WPFloat tmpL[16], tmpR[16];
+		if (devU >= devV) {
+			//Split every row at the middle of u
+			for (WPUInt j=0; j<=pV; j++)
+				WCNurbs::SubdivideBezier(pU, hcp + j*row, 4, 0.5, &left[j*row], &right[j*row]);
+			WPFloat mid = 0.5 * (u0 + u1);
+			this->AddSurfacePiece(&left[0], u0, mid, v0, v1, depth + 1);
+			this->AddSurfacePiece(&right[0], mid, u1, v0, v1, depth + 1);
+		}
+		else {
+			//Split every column at the middle of v
+			for (WPUInt i=0; i<=pU; i++) {
+				WCNurbs::SubdivideBezier(pV, hcp + i*4, row, 0.5, tmpL, tmpR);
+				for (WPUInt j=0; j<=pV; j++) {
+					memcpy(&left[j*row + i*4], tmpL + j*4, 4 * sizeof(WPFloat));
+					memcpy(&right[j*row + i*4], tmpR + j*4, 4 * sizeof(WPFloat));
+				}
+			}
+			WPFloat mid = 0.5 * (v0 + v1);
+			this->AddSurfacePiece(&left[0], u0, u1, v0, mid, depth + 1);
+			this->AddSurfacePiece(&right[0], u0, u1, mid, v1, depth + 1);
+		}
+		return;
+	}
+	//Keep the piece
+	WSBezierPiece piece;
+	piece.uMin = u0;
+	piece.uMax = u1;
+	piece.vMin = v0;
+	piece.vMax = v1;
+	piece.offset = (WPUInt)this->_points.size();
+	_BezierHullBox(hcp, count, piece.lo, piece.hi);
+	this->_points.insert(this->_points.end(), hcp, hcp + count*4);
+	this->_pieces.push_back(piece);
+}
+
+
+void WCBezierHierarchy::BuildNodes(const WPUInt &first, const WPUInt &count) {
+	WPUInt index = (WPUInt)this->_nodes.size();
+	this->_nodes.push_back(WSBezierNode());
+	//Box everything below, and the spread of the piece centres
+	WPFloat lo[3], hi[3], cLo[3], cHi[3], c;
+	for (WPUInt k=0; k<3; k++) {
+		lo[k] = cLo[k] = 1.0e300;
+		hi[k] = cHi[k] = -1.0e300;
+	}
+	for (WPUInt i=first; i<first+count; i++) {
+		const WSBezierPiece &piece = this->_pieces[i];
+		for (WPUInt k=0; k<3; k++) {
+			lo[k] = STDMIN(lo[k], piece.lo[k]);
+			hi[k] = STDMAX(hi[k], piece.hi[k]);
+			c = piece.lo[k] + piece.hi[k];
+			cLo[k] = STDMIN(cLo[k], c);
+			cHi[k] = STDMAX(cHi[k], c);
+		}
+	}
+	WSBezierNode &node = this->_nodes[index];
+	memcpy(node.lo, lo, 3 * sizeof(WPFloat));
+	memcpy(node.hi, hi, 3 * sizeof(WPFloat));
+	node.first = first;
+	node.right = 0;
+	//Small sets become leaves
+	if (count <= BEZIERHIERARCHY_LEAF_PIECES) {
+		node.count = count;
+		return;
+	}
+	node.count = 0;
+	//Median split along the widest spread of centres
+	WPUInt axis = 0;
+	if (cHi[1] - cLo[1] > cHi[axis] - cLo[axis]) axis = 1;
+	if (cHi[2] - cLo[2] > cHi[axis] - cLo[axis]) axis = 2;
+	WPUInt half = count / 2;
+	std::nth_element(this->_pieces.begin() + first, this->_pieces.begin() + first + half,
+		this->_pieces.begin() + first + count, _BezierPieceLess(axis));
+	this->BuildNodes(first, half);
+	this->_nodes[index].right = (WPUInt)this->_nodes.size();
+	this->BuildNodes(first + half, count - half);
+}
+
+
+/***********************************************~***************************************************/
+
+
+WCBezierHierarchy::WCBezierHierarchy(const WPUInt &degree, const WPUInt &segments, const WPFloat *points,
+	const WPFloat *breaks, const WPFloat &tolerance) : _degreeU(degree), _degreeV(0), _tolerance(tolerance),
+	_points(), _pieces(), _nodes() {
+	//Make sure the inputs are reasonable
+	if ((points == NULL) || (breaks == NULL) || (degree == 0) || (degree > NURBS_BASIS_MAX_DEGREE)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCBezierHierarchy::WCBezierHierarchy - Invalid curve segments.");
+		return;
+	}
+	for (WPUInt k=0; k<segments; k++)
+		this->AddCurvePiece(points + k*(degree+1)*4, breaks[k], breaks[k+1], 0);
+	if (this->_pieces.size() > 0) this->BuildNodes(0, (WPUInt)this->_pieces.size());
+}
+
+
+WCBezierHierarchy::WCBezierHierarchy(const WPUInt &degreeU, const WPUInt &degreeV, const WPUInt &numU, const WPUInt &numV,
+	const WPFloat *points, const WPFloat *breaksU, const WPFloat *breaksV, const WPFloat &tolerance) :
+	_degreeU(degreeU), _degreeV(degreeV), _tolerance(tolerance), _points(), _pieces(), _nodes() {
+	//Make sure the inputs are reasonable (column splits use a 16 value workspace)
+	if ((points == NULL) || (breaksU == NULL) || (breaksV == NULL) || (degreeU == 0) || (degreeV == 0) ||
+		(degreeU > 3) || (degreeV > 3)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCBezierHierarchy::WCBezierHierarchy - Invalid surface patches.");
+		this->_degreeV = 0;
+		return;
+	}
+	WPUInt size = (degreeU+1) * (degreeV+1) * 4;
+	for (WPUInt j=0; j<numV; j++)
+		for (WPUInt i=0; i<numU; i++)
+			this->AddSurfacePiece(points + (j*numU + i)*size, breaksU[i], breaksU[i+1], breaksV[j], breaksV[j+1], 0);
+	if (this->_pieces.size() > 0) this->BuildNodes(0, (WPUInt)this->_pieces.size());
+}
+
+
+void WCBezierHierarchy::RayQuery(const WCVector4 &base, const WCVector4 &direction, const WPFloat &radius,
+	std::vector<WPUInt> &pieces) const {
+	if (this->_nodes.empty()) return;
+	WPFloat b[3] = { base.I(), base.J(), base.K() };
+	WPFloat d[3] = { direction.I(), direction.J(), direction.K() };
+	WPUInt stack[BEZIERHIERARCHY_STACK_SIZE], top = 0;
+	stack[top++] = 0;
+	while (top > 0) {
+		WPUInt index = stack[--top];
+		const WSBezierNode &node = this->_nodes[index];
+		if (!_BezierRayBox(b, d, radius, node.lo, node.hi)) continue;
+		if (node.count > 0) {
+			for (WPUInt i=node.first; i<node.first+node.count; i++)
+				if (_BezierRayBox(b, d, radius, this->_pieces[i].lo, this->_pieces[i].hi)) pieces.push_back(i);
+		}
+		else {
+			stack[top++] = node.right;
+			stack[top++] = index + 1;
+		}
+	}
+}
+
+
+void WCBezierHierarchy::PointQuery(const WCVector4 &point, const WPFloat &radius, std::vector<WPUInt> &pieces) const {
+	if (this->_nodes.empty()) return;
+	WPFloat pt[3] = { point.I(), point.J(), point.K() };
+	WPUInt stack[BEZIERHIERARCHY_STACK_SIZE], top = 0;
+	stack[top++] = 0;
+	while (top > 0) {
+		WPUInt index = stack[--top];
+		const WSBezierNode &node = this->_nodes[index];
+		if (_BezierBoxDistance(pt, node.lo, node.hi) > radius) continue;
+		if (node.count > 0) {
+			for (WPUInt i=node.first; i<node.first+node.count; i++)
+				if (_BezierBoxDistance(pt, this->_pieces[i].lo, this->_pieces[i].hi) <= radius) pieces.push_back(i);
+		}
+		else {
+			stack[top++] = node.right;
+			stack[top++] = index + 1;
+		}
+	}
+}
+
+
+WPFloat WCBezierHierarchy::Distance(const WCVector4 &point, WPFloat &u, WPFloat &v) const {
+	u = v = 0.0;
+	if (this->_nodes.empty()) return -1.0;
+	WPFloat pt[3] = { point.I(), point.J(), point.K() };
+	WPFloat best = 1.0e300, dist, s, t, a[3], b[3], c[3], d[3], e1[3], e2[3], q[3], rel[3];
+	WPUInt stack[BEZIERHIERARCHY_STACK_SIZE], top = 0, pU = this->_degreeU, row = (pU+1)*4;
+	stack[top++] = 0;
+	//Branch and bound - a box no closer than the best so far can not hold anything better
+	while (top > 0) {
+		WPUInt index = stack[--top];
+		const WSBezierNode &node = this->_nodes[index];
+		if (_BezierBoxDistance(pt, node.lo, node.hi) >= best) continue;
+		if (node.count == 0) {
+			//Visit the nearer child first
+			WPUInt left = index + 1, right = node.right;
+			if (_BezierBoxDistance(pt, this->_nodes[left].lo, this->_nodes[left].hi) <
+				_BezierBoxDistance(pt, this->_nodes[right].lo, this->_nodes[right].hi)) std::swap(left, right);
+			stack[top++] = left;
+			stack[top++] = right;
+			continue;
+		}
+		for (WPUInt i=node.first; i<node.first+node.count; i++) {
+			const WSBezierPiece &piece = this->_pieces[i];
+			if (_BezierBoxDistance(pt, piece.lo, piece.hi) >= best) continue;
+			const WPFloat *hcp = &this->_points[piece.offset];
+			//Pieces are flat to tolerance, so project onto their chord or corner plane
+			if (!this->IsSurface()) {
+				_BezierCartesian(hcp, a);
+				_BezierCartesian(hcp + pU*4, b);
+				WPFloat num = 0.0, den = 0.0;
+				for (WPUInt k=0; k<3; k++) {
+					e1[k] = b[k] - a[k];
+					num += (pt[k] - a[k]) * e1[k];
+					den += e1[k] * e1[k];
+				}
+				s = (den > 0.0) ? STDMAX(0.0, STDMIN(1.0, num / den)) : 0.0;
+				t = 0.0;
+				for (WPUInt k=0; k<3; k++) q[k] = a[k] + s * e1[k];
+			}
+			else {
+				_BezierCartesian(hcp, a);
+				_BezierCartesian(hcp + pU*4, b);
+				_BezierCartesian(hcp + this->_degreeV*row, c);
+				_BezierCartesian(hcp + this->_degreeV*row + pU*4, d);
+				WPFloat m11 = 0.0, m12 = 0.0, m22 = 0.0, r1 = 0.0, r2 = 0.0;
+				for (WPUInt k=0; k<3; k++) {
+					e1[k] = b[k] - a[k];
+					e2[k] = c[k] - a[k];
+					rel[k] = pt[k] - a[k];
+					m11 += e1[k] * e1[k];
+					m12 += e1[k] * e2[k];
+					m22 += e2[k] * e2[k];
+					r1 += rel[k] * e1[k];
+					r2 += rel[k] * e2[k];
+				}
+				WPFloat det = m11 * m22 - m12 * m12;
+				s = (det > 0.0) ? (r1 * m22 - r2 * m12) / det : 0.0;
+				t = (det > 0.0) ? (r2 * m11 - r1 * m12) / det : 0.0;
+				s = STDMAX(0.0, STDMIN(1.0, s));
+				t = STDMAX(0.0, STDMIN(1.0, t));
+				//Bilinear point at the projected parameters
+				for (WPUInt k=0; k<3; k++)
+					q[k] = (1.0 - s) * (1.0 - t) * a[k] + s * (1.0 - t) * b[k] + (1.0 - s) * t * c[k] + s * t * d[k];
+			}
+			dist = sqrt((pt[0] - q[0]) * (pt[0] - q[0]) + (pt[1] - q[1]) * (pt[1] - q[1]) + (pt[2] - q[2]) * (pt[2] - q[2]));
+			if (dist < best) {
+				best = dist;
+				u = piece.uMin + s * (piece.uMax - piece.uMin);
+				v = piece.vMin + t * (piece.vMax - piece.vMin);
+			}
+		}
+	}
+	return best;
+}
+
+
+void WCBezierHierarchy::Overlaps(const WCBezierHierarchy &other, const WPFloat &radius,
+	std::vector< std::pair<WPUInt,WPUInt> > &pairs) const {
+	if (this->_nodes.empty() || other._nodes.empty()) return;
+	std::vector< std::pair<WPUInt,WPUInt> > stack;
+	stack.push_back(std::make_pair((WPUInt)0, (WPUInt)0));
+	while (!stack.empty()) {
+		std::pair<WPUInt,WPUInt> top = stack.back();
+		stack.pop_back();
+		const WSBezierNode &a = this->_nodes[top.first];
+		const WSBezierNode &b = other._nodes[top.second];
+		if (!_BezierBoxOverlap(a.lo, a.hi, b.lo, b.hi, radius)) continue;
+		//Two leaves - compare their pieces
+		if ((a.count > 0) && (b.count > 0)) {
+			for (WPUInt i=a.first; i<a.first+a.count; i++)
+				for (WPUInt j=b.first; j<b.first+b.count; j++)
+					if (_BezierBoxOverlap(this->_pieces[i].lo, this->_pieces[i].hi, other._pieces[j].lo, other._pieces[j].hi, radius))
+						pairs.push_back(std::make_pair(i, j));
+			continue;
+		}
+		//Otherwise descend the inner node with the larger box
+		WPFloat sizeA = (a.hi[0] - a.lo[0]) + (a.hi[1] - a.lo[1]) + (a.hi[2] - a.lo[2]);
+		WPFloat sizeB = (b.hi[0] - b.lo[0]) + (b.hi[1] - b.lo[1]) + (b.hi[2] - b.lo[2]);
+		if ((b.count > 0) || ((a.count == 0) && (sizeA >= sizeB))) {
+			stack.push_back(std::make_pair(top.first + 1, top.second));
+			stack.push_back(std::make_pair(a.right, top.second));
+		}
+		else {
+			stack.push_back(std::make_pair(top.first, top.second + 1));
+			stack.push_back(std::make_pair(top.first, b.right));
+		}
+	}
+}
+
+
+/***********************************************~***************************************************/
+
@@ -0,0 +1,125 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+#ifndef __BEZIER_HIERARCHY_H__
+#define __BEZIER_HIERARCHY_H__
+
+
+/*** Included Header Files ***/
+#include <Geometry/wgeol.h>
+
+
+/*** Locally Defined Values ***/
+#define BEZIERHIERARCHY_LEAF_PIECES				4			//Most pieces held by one leaf node
+#define BEZIERHIERARCHY_MAX_DEPTH				10			//Most halvings of one Bezier piece while refining
+#define BEZIERHIERARCHY_STACK_SIZE				64			//Traversal stack depth
+
+
+/*** Namespace Declaration ***/
+namespace __WILDCAT_NAMESPACE__ {
+
+
+/*** Class Predefines ***/
+//None
+
+
+/***********************************************~***************************************************/
+
+
+//One Bezier segment or patch - degree+1 (curve) or (degreeU+1)*(degreeV+1) (surface) homogeneous points
+struct WSBezierPiece {
+	WPFloat										uMin, uMax, vMin, vMax;								//!< Parametric box (v is zero for curves)
+	WPFloat										lo[3], hi[3];										//!< Bounding box of the control hull
+	WPUInt										offset;												//!< First value of the piece in the point array
+};
+
+
+//Nodes are stored depth first - the left child always follows its parent
+struct WSBezierNode {
+	WPFloat										lo[3], hi[3];										//!< Bounding box of every piece below
+	WPUInt										first, count;										//!< Piece range of a leaf (count is zero for inner nodes)
+	WPUInt										right;												//!< Index of the right child
+};
+
+
+/***********************************************~***************************************************/
+
+
+class WCBezierHierarchy {
+protected:
+	WPUInt										_degreeU, _degreeV;									//!< Piece degrees (degreeV is zero for curves)
+	WPFloat										_tolerance;											//!< Flatness the pieces were refined to
+	std::vector<WPFloat>						_points;											//!< Homogeneous control points of every piece
+	std::vector<WSBezierPiece>					_pieces;											//!< Leaf pieces, ordered by the tree
+	std::vector<WSBezierNode>					_nodes;												//!< Tree nodes, root first
+private:
+	void AddCurvePiece(const WPFloat *hcp, const WPFloat &u0, const WPFloat &u1, const WPUInt &depth);	//!< Refine and add one curve segment
+	void AddSurfacePiece(const WPFloat *hcp, const WPFloat &u0, const WPFloat &u1,					//!< Refine and add one surface patch
+												const WPFloat &v0, const WPFloat &v1, const WPUInt &depth);
+	void BuildNodes(const WPUInt &first, const WPUInt &count);										//!< Median split the pieces into a subtree
+	//Hidden Constructors
+	WCBezierHierarchy();																			//!< Deny access to default constructor
+	WCBezierHierarchy(const WCBezierHierarchy &hierarchy);											//!< Deny access to copy constructor
+	WCBezierHierarchy& operator=(const WCBezierHierarchy &hierarchy);								//!< Deny access to equals operator
+public:
+	//Constructors and Destructors
+	WCBezierHierarchy(const WPUInt &degree, const WPUInt &segments, const WPFloat *points,			//!< Curve constructor - from Bezier segments
+												const WPFloat *breaks, const WPFloat &tolerance);
+	WCBezierHierarchy(const WPUInt &degreeU, const WPUInt &degreeV, const WPUInt &numU,				//!< Surface constructor - from Bezier patches (v major)
+												const WPUInt &numV, const WPFloat *points, const WPFloat *breaksU,
+												const WPFloat *breaksV, const WPFloat &tolerance);
+	~WCBezierHierarchy()						{ }													//!< Default destructor
+
+	//Member Access Methods
+	inline bool IsSurface(void) const			{ return this->_degreeV != 0; }						//!< Built from a surface
+	inline WPUInt DegreeU(void) const			{ return this->_degreeU; }							//!< Get the U (or curve) degree
+	inline WPUInt DegreeV(void) const			{ return this->_degreeV; }							//!< Get the V degree
+	inline WPFloat Tolerance(void) const		{ return this->_tolerance; }						//!< Get the refinement tolerance
+	inline WPUInt NumberPieces(void) const		{ return (WPUInt)this->_pieces.size(); }			//!< Get the number of pieces
+	inline const WSBezierPiece& Piece(const WPUInt &index) const { return this->_pieces[index]; }	//!< Get a piece
+	inline const WPFloat* PiecePoints(const WPUInt &index) const									//!< Get the homogeneous points of a piece
+												{ return &this->_points[this->_pieces[index].offset]; }
+	inline WPUInt NumberNodes(void) const		{ return (WPUInt)this->_nodes.size(); }				//!< Get the number of tree nodes
+	inline const WSBezierNode& Node(const WPUInt &index) const { return this->_nodes[index]; }		//!< Get a tree node
+
+	//Query Methods
+	void RayQuery(const WCVector4 &base, const WCVector4 &direction, const WPFloat &radius,		//!< Pieces whose box (grown by radius) the ray passes
+												std::vector<WPUInt> &pieces) const;
+	void PointQuery(const WCVector4 &point, const WPFloat &radius, std::vector<WPUInt> &pieces) const;	//!< Pieces whose box is within radius of a point
+	WPFloat Distance(const WCVector4 &point, WPFloat &u, WPFloat &v) const;						//!< Approximate distance and parameters of the closest point
+	void Overlaps(const WCBezierHierarchy &other, const WPFloat &radius,							//!< Piece pairs whose boxes are within radius
+												std::vector< std::pair<WPUInt,WPUInt> > &pairs) const;
+};
+
+
+/***********************************************~***************************************************/
+
+
+}	   // End Wildcat Namespace
+#endif //__BEZIER_HIERARCHY_H__
+
@@ -30,6 +30,7 @@
 #include <Geometry/geometric_algorithms.h>
 #include <Geometry/geometric_line.h>
 #include <Geometry/nurbs_curve.h>
+#include <algorithm>
 
 
 /***********************************************~***************************************************/
@@ -239,168 +240,56 @@ void __WILDCAT_NAMESPACE__::SplitArc(const WCVector4 &p0, const WCVector4 &p1, c
 /***********************************************~***************************************************/
 
 
-struct WCHeapNode {
-	WCVector4 point;
-	WPFloat angle;
-	WPFloat distance;
-	WCHeapNode *left, *right;
-};
-
-
-void _ConvexHullFlattenRecursive(WCHeapNode *node, std::list<WCVector4> &list) {
-	//Add left children (if any)
-	if (node->left != NULL) _ConvexHullFlattenRecursive(node->left, list);
-	//Add this node
-	list.push_back(node->point);
-//	std::cout << "ConvexSort: " << node->point << std::endl;
-	//Add right children (if any)
-	if (node->right != NULL) _ConvexHullFlattenRecursive(node->right, list);
-	//Delete the node
-	delete node;
-}
-
-
-void _ConvexHullRecursivePlaceNode(WCHeapNode *refNode, WCHeapNode *node, const WPFloat &tol) {
-	//Check same angle case
-	if ( fabs(node->angle - refNode->angle) < tol) {
-		//Check distances
-		if (node->distance > refNode->distance) {
-			//If node distance is greater, replace contents of refNode
-			refNode->point = node->point;
-			refNode->distance = node->distance;
-		}
-		//Delete the new node
-		delete node;
-		return;
-	}
-	//Check left child
-	if (node->angle < refNode->angle) {
-		//Check to see if there is a left-child
-		if (refNode->left == NULL) refNode->left = node;
-		//If there is, recurse down the tree
-		else _ConvexHullRecursivePlaceNode(refNode->left, node, tol);
-		return;
+//Polar order about the hull's low point - exact orientation, nearer first along a ray
+struct _ConvexHull2DCompare {
+	WPFloat x, y;
+	bool operator()(const WCVector4 &a, const WCVector4 &b) const {
+		WPFloat orient = Orient2D(this->x, this->y, a.I(), a.J(), b.I(), b.J());
+		if (orient != 0.0) return orient > 0.0;
+		return (STDFABS(a.I() - this->x) + STDFABS(a.J() - this->y)) < (STDFABS(b.I() - this->x) + STDFABS(b.J() - this->y));
 	}
-	//Must be right child
-	if (refNode->right == NULL) refNode->right = node;
-	else _ConvexHullRecursivePlaceNode(refNode->right, node, tol);
-}
-
-
-/*** Modified version of a heap sort - sort criteria is the angle from reference point.
-	Duplicate angle points have the nearest discarded ***/
-void _ConvexHull2DSort(const WCVector4 &refPoint, std::list<WCVector4> &pointList, const WPFloat &tol) {
-	std::list<WCVector4>::iterator pointIter = pointList.begin();
-	WCHeapNode *root = new WCHeapNode(), *node;
-	root->point = *pointIter;
-	root->angle = atan2((*pointIter).J() - refPoint.J(), (*pointIter).I() - refPoint.I());
-	root->distance = refPoint.Distance( *pointIter );
-	root->left = NULL;
-	root->right = NULL;
-	//Loop through all of the points and build heap
-	for (pointIter++ ; pointIter != pointList.end(); pointIter++) {
-		node = new WCHeapNode();
-		node->point = *pointIter;
-		node->angle = atan2((*pointIter).J() - refPoint.J(), (*pointIter).I() - refPoint.I());
-		node->distance = refPoint.Distance( *pointIter );
-		node->left = NULL;
-		node->right = NULL;
-		_ConvexHullRecursivePlaceNode(root, node, tol);
-	}
-	//Flatten heap into pointList (flatten deletes the nodes)
-	pointList.clear();
-	_ConvexHullFlattenRecursive(root, pointList);
-/*** DEBUG ***
-	for (pointIter = pointList.begin(); pointIter != pointList.end(); pointIter++) 
-		std::cout << "CB2DSort Point: " << *pointIter << std::endl;
-/*** DEBUG ***/
-}
+};
 
 
 /*** ConvexHull2D algorithm taken from "Introduction to Algorithms" by T. Cormen, C. Leiserson, R. Rivest, and C. Stein 
-	 Referred to as Graham's Scan ***/
-std::list<WCVector4> __WILDCAT_NAMESPACE__::ConvexHull2D(std::list<WCVector4> pointList, const WPFloat &tol) {
+	 Referred to as Graham's Scan.  All turn and angle tests use the exact orientation predicate, so collinear and
+	 repeated points are dropped without tolerances.  The hull is returned clockwise, ending with the low point. ***/
+std::list<WCVector4> __WILDCAT_NAMESPACE__::ConvexHull2D(std::list<WCVector4> pointList) {
 	//Check for size 1, 2, or 3
 	if (pointList.size() < 3) return pointList;
-	std::list<WCVector4> outputList;
 	
 	//Find the left-most lowest point
 	WCVector4 lowPoint = pointList.front();
-	std::list<WCVector4>::iterator iter, lowIter = pointList.begin();
+	std::list<WCVector4>::iterator iter;
 	for (iter = pointList.begin(); iter != pointList.end(); iter++) {
 		//Check if lowest outright, or if equal in lowness then more left
-		if (((*iter).J() < lowPoint.J()) || (((*iter).J() == lowPoint.J()) && ((*iter).I() < lowPoint.I()))) {
-			//Copy the point
-			lowPoint = *iter;
-			//Mark the iterator
-			lowIter = iter;
-		}
+		if (((*iter).J() < lowPoint.J()) || (((*iter).J() == lowPoint.J()) && ((*iter).I() < lowPoint.I()))) lowPoint = *iter;
 	}
-	//Add low point to the output list and remove from point list
-	pointList.erase(lowIter);
-	outputList.push_back(lowPoint);
-
-	//Sort the remaining points using lowPoint as reference
-	_ConvexHull2DSort(lowPoint, pointList, tol);
-	
-	//Remove next two points from pointList and add to outputList
-	WCVector4 nextToTop = pointList.front();
-	outputList.push_front( pointList.front() );
-	pointList.pop_front();
-	WCVector4 top = pointList.front();
-	outputList.push_front( pointList.front() );
-	pointList.pop_front();
-	
-	//Process remaining points in pointList
-	WPFloat angle1, angle2;
-	for (iter = pointList.begin(); iter != pointList.end(); iter++) {
-		//Repeat until turn is to the left
-		do {
-			//Calculate angle's 1 and 2
-			angle1 = atan2(top.J() - nextToTop.J(), top.I() - nextToTop.I());
-			if (angle1 < 0.0) angle1 += 2.0 * M_PI;
-			angle2 = atan2((*iter).J() - top.J(), (*iter).I() - top.I());
-			if (angle2 < 0.0) angle2 += 2.0 * M_PI;
-			//If there is a non-left angle
-			if (angle2 <= (angle1+tol)) {
-				//Remove the no-longer-needed last element
-				outputList.pop_front();
-				//Get new top and nextToTop values
-				top = outputList.front();
-				outputList.pop_front();
-				nextToTop = outputList.front();
-				outputList.push_front(top);
-			}
-		} while ((angle2 <= (angle1+tol)) && (outputList.size() >= 2));
-		//Left turn
-		outputList.push_front( *iter );
-		nextToTop = top;
-		top = *iter;
-	}
-	
-	//Special Case - Selected lowPoint is in line with point to the left and point to the right (due to floating point issues)
-	//   0 ---- LP ---- LP-1
-	//Get 0
-	WCVector4 first = outputList.front();
-	//Get LP-1
-	iter = outputList.end(); iter--; iter--;
-	WCVector4 nextLast = *iter;
-	//Calculate angle from first to lowPoint
-	angle1 = atan2(first.I() - lowPoint.I(), first.J() - lowPoint.J());
-	if (angle1 < 0.0) angle1 += 2.0 * M_PI;
-	angle2 = atan2(lowPoint.I() - nextLast.I(), lowPoint.J() - nextLast.J());
-	if (angle2 < 0.0) angle2 += 2.0 * M_PI;
-	//If angles are within tolerance
-	if (fabs(angle1 - angle2) < tol) {
-		//Remove the last point
-		outputList.pop_back();
+	//Sort the remaining points by angle from lowPoint (copies of lowPoint are dropped)
+	std::vector<WCVector4> sorted;
+	for (iter = pointList.begin(); iter != pointList.end(); iter++)
+		if (((*iter).I() != lowPoint.I()) || ((*iter).J() != lowPoint.J())) sorted.push_back(*iter);
+	_ConvexHull2DCompare compare;
+	compare.x = lowPoint.I();
+	compare.y = lowPoint.J();
+	std::sort(sorted.begin(), sorted.end(), compare);
+	//Points sharing an angle keep only the farthest
+	std::vector<WCVector4> stack(1, lowPoint);
+	std::vector<WCVector4>::iterator sortIter;
+	for (sortIter = sorted.begin(); sortIter != sorted.end(); sortIter++) {
+		if ((sortIter + 1 != sorted.end()) &&
+			(Orient2D(lowPoint.I(), lowPoint.J(), (*sortIter).I(), (*sortIter).J(), (*(sortIter+1)).I(), (*(sortIter+1)).J()) == 0.0)) continue;
+		//Pop until the turn is strictly to the left
+		while ((stack.size() >= 2) && (Orient2D(stack[stack.size()-2].I(), stack[stack.size()-2].J(), stack.back().I(), stack.back().J(),
+			(*sortIter).I(), (*sortIter).J()) <= 0.0)) stack.pop_back();
+		stack.push_back(*sortIter);
 	}
 /*** DEBUG ***
-	//Print out the output list
-	for (iter = outputList.begin(); iter != outputList.end(); iter++) std::cout << *iter << std::endl;
+	//Print out the hull
+	for (sortIter = stack.begin(); sortIter != stack.end(); sortIter++) std::cout << *sortIter << std::endl;
 /*** DEBUG ***/
-	//Return the convex hull
-	return outputList;
+	//Return the convex hull (last pushed first, low point last)
+	return std::list<WCVector4>(stack.rbegin(), stack.rend());
 }
 
 
@@ -502,7 +391,7 @@ std::list<WCVector4> __WILDCAT_NAMESPACE__::MinimumBoundingRectangle(const std::
 	}
 
 	//Generate the convex hull of the planar points
-	std::list<WCVector4> convexHull = ConvexHull2D(planarPoints, 0.0001);
+	std::list<WCVector4> convexHull = ConvexHull2D(planarPoints);
 	std::list<WCVector4>::iterator convexIter;
 /*** DEBUG ***
 	for(convexIter = convexHull.begin(); convexIter != convexHull.end(); convexIter++)
@@ -570,9 +459,9 @@ void __WILDCAT_NAMESPACE__::BuildBoundaryList(std::list<std::pair<WCGeometricCur
 			if (nurb != NULL) {
 				//If detailed, get all evaluated points
 				if (detailed) {
-					//Need to determine best LOD
-					WPUInt lod = 256; //(WPUInt)(nurb->Length(tolerance) / tolerance);
-					GLfloat* data = nurb->GenerateClientBuffer(0.0, 1.0, lod, true);
+					//Tessellate to the tolerance (flat stretches need few points)
+					WPUInt lod;
+					GLfloat* data = nurb->GenerateAdaptiveBuffer(tolerance, NURBSCURVE_ADAPTIVE_ANGLE, lod, NULL, true);
 					//Process forwards
 					if ((*curveIter).second) {
 						for (WPUInt i=1; i<lod; i++) {
@@ -32,6 +32,7 @@
 
 /*** Included Header Files ***/
 #include <Geometry/wgeol.h>
+#include <Geometry/geometric_predicates.h>
 
 
 /*** Locally Defined Values ***/
@@ -51,16 +52,15 @@ class WCGeometricCurve;
 
 inline bool IsOnRight2D(const WPFloat &startX, const WPFloat &startY, const WPFloat &endX, const WPFloat &endY, 
 	const WPFloat &pointX, const WPFloat &pointY) {
-	WPFloat tmp = (endX - startX) * (startY - pointY) - (startX - pointX) * (endY - startY);
-	if (tmp >= 0.0) return true;
-	else return false;
+	//Collinear points count as on the right
+	return Orient2D(startX, startY, endX, endY, pointX, pointY) <= 0.0;
 }
 
 
 inline WPFloat PointToLineDistance2D(const WPFloat &startX, const WPFloat &startY, const WPFloat &endX, const WPFloat &endY, 
 	const WPFloat &pointX, const WPFloat &pointY, const bool &abs=true) {
-	//Calculate the distance
-	WPFloat num = (endX - startX) * (startY - pointY) - (startX - pointX) * (endY - startY);
+	//Calculate the distance (positive on the right)
+	WPFloat num = -Orient2D(startX, startY, endX, endY, pointX, pointY);
 	if ((num < 0.0) && abs) num *= -1.0;
 	WPFloat den = sqrt( pow( endX - startX, 2) + pow( endY - startY, 2) );
 	if (den < 0.001) return 100000000.0;
@@ -117,14 +117,21 @@ WPFloat Angle(const WCVector4 &p0, const WCVector4 &p1, const WCVector4 &p2);
 void SplitArc(const WCVector4 &p0, const WCVector4 &p1, const WCVector4 &p2, WCVector4 &q1, WCVector4 &s, WCVector4 &r1);
 
 
-std::list<WCVector4> ConvexHull2D(std::list<WCVector4> pointList, const WPFloat &tol);
+std::list<WCVector4> ConvexHull2D(std::list<WCVector4> pointList);
 
 
 std::list<WCVector4> MinimumBoundingRectangle(const std::list<WCVector4> &pointList, const WCMatrix4 &toPlane, const WCMatrix4 &fromPlane);
 
 
-GLint* TriangulatePolygon(const std::list<WCVector4> &pointList);
-GLint* TriangulatePolygon(GLfloat *pointList, const GLuint &numPoints);
+//Ear-clipping triangulation of an outer loop plus holes (x,y pairs); holes holds the first point index of each hole.
+//Triangles follow the winding of the outer loop; returns the triangle count.
+WPUInt TriangulatePolygon(const std::vector<WPFloat> &points, const std::vector<WPUInt> &holes, std::vector<GLuint> &triangles);
+
+
+//Constrained Delaunay triangulation of the even-odd inside of closed 2D loops (x,y pairs) plus extra sample points.
+//Indices number the loop points in order and then the samples; triangles are counter-clockwise.
+bool ConstrainedTriangulation2D(const std::vector< std::vector<WPFloat> > &loops, const std::vector<WPFloat> &samples,
+												std::vector<GLuint> &triangles);
 
 	
 void BuildBoundaryList(std::list<std::pair<WCGeometricCurve*,bool> > &curveList, std::list<WCVector4> &outputList,
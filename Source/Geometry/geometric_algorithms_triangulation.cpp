@@ -28,176 +28,862 @@
 
 /*** Included Header Files ***/
 #include <Geometry/geometric_algorithms.h>
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+
+/*** Locally Defined Values ***/
+#define TRIANGULATE_HASH_CUTOFF					80
+#define TRIANGULATE_CDT_EPSILON					1.0e-10
 
 
 /***********************************************~***************************************************/
 
 
-struct TriangulateVertex {
-	int id;
-	WCVector4 vertex;
-	WPFloat internalAngle;
-	TriangulateVertex *left, *right;
+//Polygon vertex for ear clipping - ring links plus z-order links for the hashed ear test
+struct _TriangulateNode {
+	WPUInt										i;
+	WPFloat										x, y;
+	WPUInt										z;
+	bool										steiner;
+	_TriangulateNode							*prev, *next, *prevZ, *nextZ;
 };
 
 
-/***********************************************~***************************************************/
+//Node storage and bounds shared by one triangulation (deque keeps node addresses stable)
+struct _TriangulateEarcut {
+	std::deque<_TriangulateNode>				nodes;
+	std::vector<GLuint>							*triangles;
+	WPFloat										minX, minY, invSize;
+};
+
+
+static _TriangulateNode* _TriangulateInsertNode(_TriangulateEarcut &ec, const WPUInt &i, const WPFloat &x, const WPFloat &y,
+	_TriangulateNode *last) {
+	_TriangulateNode node = { i, x, y, 0, false, NULL, NULL, NULL, NULL };
+	ec.nodes.push_back(node);
+	_TriangulateNode *p = &ec.nodes.back();
+	if (last == NULL) {
+		p->prev = p;
+		p->next = p;
+	}
+	else {
+		p->next = last->next;
+		p->prev = last;
+		last->next->prev = p;
+		last->next = p;
+	}
+	return p;
+}
+
+
+static void _TriangulateRemoveNode(_TriangulateNode *p) {
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+	if (p->prevZ != NULL) p->prevZ->nextZ = p->nextZ;
+	if (p->nextZ != NULL) p->nextZ->prevZ = p->prevZ;
+}
+
+
+//Twice the signed area of p,q,r (exact sign) - negative for a counter-clockwise turn
+static inline WPFloat _TriangulateArea(const _TriangulateNode *p, const _TriangulateNode *q, const _TriangulateNode *r) {
+	return -Orient2D(p->x, p->y, q->x, q->y, r->x, r->y);
+}
+
+
+static inline bool _TriangulateEquals(const _TriangulateNode *p, const _TriangulateNode *q) {
+	return (p->x == q->x) && (p->y == q->y);
+}
+
+
+static inline bool _TriangulateInTriangle(const WPFloat &ax, const WPFloat &ay, const WPFloat &bx, const WPFloat &by,
+	const WPFloat &cx, const WPFloat &cy, const WPFloat &px, const WPFloat &py) {
+	return (Orient2D(px, py, cx, cy, ax, ay) >= 0.0) && (Orient2D(px, py, ax, ay, bx, by) >= 0.0) &&
+		(Orient2D(px, py, bx, by, cx, cy) >= 0.0);
+}
+
+
+static inline bool _TriangulateIntersects(const _TriangulateNode *p1, const _TriangulateNode *q1, const _TriangulateNode *p2,
+	const _TriangulateNode *q2) {
+	return SegmentsIntersect2D(p1->x, p1->y, q1->x, q1->y, p2->x, p2->y, q2->x, q2->y);
+}
+
+
+static bool _TriangulateIntersectsPolygon(const _TriangulateNode *a, const _TriangulateNode *b) {
+	const _TriangulateNode *p = a;
+	do {
+		if ((p->i != a->i) && (p->next->i != a->i) && (p->i != b->i) && (p->next->i != b->i) && _TriangulateIntersects(p, p->next, a, b))
+			return true;
+		p = p->next;
+	} while (p != a);
+	return false;
+}
+
+
+static bool _TriangulateLocallyInside(const _TriangulateNode *a, const _TriangulateNode *b) {
+	if (_TriangulateArea(a->prev, a, a->next) < 0.0)
+		return (_TriangulateArea(a, b, a->next) >= 0.0) && (_TriangulateArea(a, a->prev, b) >= 0.0);
+	return (_TriangulateArea(a, b, a->prev) < 0.0) || (_TriangulateArea(a, a->next, b) < 0.0);
+}
+
+
+static bool _TriangulateMiddleInside(const _TriangulateNode *a, const _TriangulateNode *b) {
+	const _TriangulateNode *p = a;
+	bool inside = false;
+	WPFloat px = (a->x + b->x) * 0.5, py = (a->y + b->y) * 0.5, orient;
+	do {
+		//Edge crosses the ray to the right of the midpoint
+		if ((p->y > py) != (p->next->y > py)) {
+			orient = Orient2D(p->x, p->y, p->next->x, p->next->y, px, py);
+			if ((p->next->y > p->y) ? (orient > 0.0) : (orient < 0.0)) inside = !inside;
+		}
+		p = p->next;
+	} while (p != a);
+	return inside;
+}
 
 
-WPFloat _TriangulateInternalAngle(TriangulateVertex* vert) {
-	WCVector4 v0 = vert->left->vertex - vert->vertex;
-	WCVector4 v1 = vert->right->vertex - vert->vertex;
-	WCVector4 cross = v1.CrossProduct(v0);
-	//Determine the angle
-	WPFloat retVal = acos( v0.DotProduct(v1) / (v0.Magnitude() * v1.Magnitude()) );
-	//If cross.K is negative, invert the angle
-	if (cross.K() < 0.0) retVal =  2.0 * M_PI - retVal;
-	return retVal;
+static bool _TriangulateValidDiagonal(const _TriangulateNode *a, const _TriangulateNode *b) {
+	//Does not cut an edge, lies inside, and does not leave a zero-area sliver
+	if ((a->next->i == b->i) || (a->prev->i == b->i) || _TriangulateIntersectsPolygon(a, b)) return false;
+	if (_TriangulateLocallyInside(a, b) && _TriangulateLocallyInside(b, a) && _TriangulateMiddleInside(a, b) &&
+		((_TriangulateArea(a->prev, a, b->prev) != 0.0) || (_TriangulateArea(a, b->prev, b) != 0.0))) return true;
+	return _TriangulateEquals(a, b) && (_TriangulateArea(a->prev, a, a->next) > 0.0) && (_TriangulateArea(b->prev, b, b->next) > 0.0);
 }
 
 
-bool _TriangulateIsInside(WCVector4 &ear, WCVector4 &left, WCVector4 &right, WCVector4 &pt) {
-	//Check if on right of ear to left, left to right, right to ear
-	bool earToLeft = IsOnRight2D(ear.I(), ear.J(), left.I(), left.J(), pt.I(), pt.J());
-	bool leftToRight = IsOnRight2D(left.I(), left.J(), right.I(), right.J(), pt.I(), pt.J());
-	bool rightToEar = IsOnRight2D(right.I(), right.J(), ear.I(), ear.J(), pt.I(), pt.J());
-	//Must be on right side of all three to be inside
-	if (earToLeft && leftToRight && rightToEar) return true;
-	else return false;
+static _TriangulateNode* _TriangulateSplit(_TriangulateEarcut &ec, _TriangulateNode *a, _TriangulateNode *b) {
+	//Join a and b with a doubled edge - the two rings share the diagonal
+	_TriangulateNode *a2 = _TriangulateInsertNode(ec, a->i, a->x, a->y, NULL);
+	_TriangulateNode *b2 = _TriangulateInsertNode(ec, b->i, b->x, b->y, NULL);
+	_TriangulateNode *an = a->next, *bp = b->prev;
+	a->next = b;
+	b->prev = a;
+	a2->next = an;
+	an->prev = a2;
+	b2->next = a2;
+	a2->prev = b2;
+	bp->next = b2;
+	b2->prev = bp;
+	return b2;
 }
 
 
-std::list<TriangulateVertex*>::iterator _TriangulateFindEar(std::list<TriangulateVertex*> &vertexList) {
-	std::list<TriangulateVertex*>::iterator outerIter, innerIter;
-	TriangulateVertex* tmpVert;
-	bool noneInside;
-	
-	//Outer loop
-	for (outerIter = vertexList.begin(); outerIter != vertexList.end(); outerIter++) {
-		//Reset none inside
-		noneInside = true;
-		//Only consider ears that are reflex
-		if ( (*outerIter)->internalAngle < M_PI ) {
-			tmpVert = (*outerIter)->left->left;
-			//Inner loop
-			do {
-				//Test to see if this vertex is inside the triangle formed with outerIter as the ear
-				if (_TriangulateIsInside( (*outerIter)->vertex, (*outerIter)->left->vertex, (*outerIter)->right->vertex, tmpVert->vertex ))
-					noneInside = false;
-				//Otherwise, move to the next vert
-				tmpVert = tmpVert->left;
-			//Keep going until right is reached
-			} while (tmpVert != (*outerIter)->right);
-			//Check to see if noneInside is true
-			if (noneInside) return outerIter;
+static _TriangulateNode* _TriangulateFilter(_TriangulateNode *start, _TriangulateNode *end=NULL) {
+	//Drop duplicate and collinear points
+	if (start == NULL) return start;
+	if (end == NULL) end = start;
+	_TriangulateNode *p = start;
+	bool again;
+	do {
+		again = false;
+		if (!p->steiner && (_TriangulateEquals(p, p->next) || (_TriangulateArea(p->prev, p, p->next) == 0.0))) {
+			_TriangulateRemoveNode(p);
+			p = end = p->prev;
+			if (p == p->next) break;
+			again = true;
 		}
+		else p = p->next;
+	} while (again || (p != end));
+	return end;
+}
+
+
+static _TriangulateNode* _TriangulateLinkedList(_TriangulateEarcut &ec, const std::vector<WPFloat> &points, const WPUInt &start,
+	const WPUInt &end, const bool &counterClockwise) {
+	//Shoelace sum is positive for a counter-clockwise ring
+	WPFloat sum = 0.0;
+	WPUInt i, j;
+	for (i=start, j=end-1; i<end; j=i++) sum += (points[j*2] - points[i*2]) * (points[i*2+1] + points[j*2+1]);
+	_TriangulateNode *last = NULL;
+	if (counterClockwise == (sum > 0.0)) for (i=start; i<end; i++) last = _TriangulateInsertNode(ec, i, points[i*2], points[i*2+1], last);
+	else for (i=end; i>start; i--) last = _TriangulateInsertNode(ec, i-1, points[(i-1)*2], points[(i-1)*2+1], last);
+	if ((last != NULL) && _TriangulateEquals(last, last->next)) {
+		_TriangulateRemoveNode(last);
+		last = last->next;
 	}
-	//Error - should not reach here
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "TriangulateFindEar - no ear found in entire profile:" << vertexList.size());
-	for (outerIter = vertexList.begin(); outerIter != vertexList.end(); outerIter++) {
-		std::cout << "E: " << (*outerIter)->vertex << std::endl;
+	return last;
+}
+
+
+static WPUInt _TriangulateZOrder(const _TriangulateEarcut &ec, const WPFloat &px, const WPFloat &py) {
+	//Interleave 15-bit grid coordinates into a Morton code
+	WPUInt x = (WPUInt)((px - ec.minX) * ec.invSize), y = (WPUInt)((py - ec.minY) * ec.invSize);
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+	y = (y | (y << 8)) & 0x00FF00FF;
+	y = (y | (y << 4)) & 0x0F0F0F0F;
+	y = (y | (y << 2)) & 0x33333333;
+	y = (y | (y << 1)) & 0x55555555;
+	return x | (y << 1);
+}
+
+
+static void _TriangulateIndexCurve(_TriangulateEarcut &ec, _TriangulateNode *start) {
+	_TriangulateNode *p = start;
+	do {
+		if (p->z == 0) p->z = _TriangulateZOrder(ec, p->x, p->y);
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p = p->next;
+	} while (p != start);
+	p->prevZ->nextZ = NULL;
+	p->prevZ = NULL;
+	//Merge sort the z links (bottom-up, no recursion)
+	_TriangulateNode *list = p, *q, *e, *tail;
+	WPUInt i, numMerges, pSize, qSize, inSize = 1;
+	do {
+		p = list;
+		list = tail = NULL;
+		numMerges = 0;
+		while (p != NULL) {
+			numMerges++;
+			q = p;
+			pSize = 0;
+			for (i=0; (i<inSize) && (q != NULL); i++) {
+				pSize++;
+				q = q->nextZ;
+			}
+			qSize = inSize;
+			while ((pSize > 0) || ((qSize > 0) && (q != NULL))) {
+				if ((pSize != 0) && ((qSize == 0) || (q == NULL) || (p->z <= q->z))) {
+					e = p;
+					p = p->nextZ;
+					pSize--;
+				}
+				else {
+					e = q;
+					q = q->nextZ;
+					qSize--;
+				}
+				if (tail != NULL) tail->nextZ = e;
+				else list = e;
+				e->prevZ = tail;
+				tail = e;
+			}
+			p = q;
+		}
+		tail->nextZ = NULL;
+		inSize *= 2;
+	} while (numMerges > 1);
+}
+
+
+static bool _TriangulateIsEar(const _TriangulateEarcut &ec, const _TriangulateNode *ear) {
+	const _TriangulateNode *a = ear->prev, *b = ear, *c = ear->next, *p, *n;
+	//Reflex corners are never ears
+	if (_TriangulateArea(a, b, c) >= 0.0) return false;
+	WPFloat x0 = STDMIN(a->x, STDMIN(b->x, c->x)), y0 = STDMIN(a->y, STDMIN(b->y, c->y));
+	WPFloat x1 = STDMAX(a->x, STDMAX(b->x, c->x)), y1 = STDMAX(a->y, STDMAX(b->y, c->y));
+	if (ec.invSize == 0.0) {
+		//Small polygons just walk the ring
+		for (p=c->next; p!=a; p=p->next)
+			if ((p->x >= x0) && (p->x <= x1) && (p->y >= y0) && (p->y <= y1) &&
+				_TriangulateInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && (_TriangulateArea(p->prev, p, p->next) >= 0.0))
+				return false;
+		return true;
 	}
-	return outerIter;
+	//Otherwise only points whose z-order falls inside the ear's box can be in it
+	WPUInt minZ = _TriangulateZOrder(ec, x0, y0), maxZ = _TriangulateZOrder(ec, x1, y1);
+	for (p=ear->prevZ; (p != NULL) && (p->z >= minZ); p=p->prevZ)
+		if ((p != a) && (p != c) && (p->x >= x0) && (p->x <= x1) && (p->y >= y0) && (p->y <= y1) &&
+			_TriangulateInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && (_TriangulateArea(p->prev, p, p->next) >= 0.0))
+			return false;
+	for (n=ear->nextZ; (n != NULL) && (n->z <= maxZ); n=n->nextZ)
+		if ((n != a) && (n != c) && (n->x >= x0) && (n->x <= x1) && (n->y >= y0) && (n->y <= y1) &&
+			_TriangulateInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, n->x, n->y) && (_TriangulateArea(n->prev, n, n->next) >= 0.0))
+			return false;
+	return true;
+}
+
+
+static void _TriangulateEmit(_TriangulateEarcut &ec, const _TriangulateNode *a, const _TriangulateNode *b, const _TriangulateNode *c) {
+	ec.triangles->push_back((GLuint)a->i);
+	ec.triangles->push_back((GLuint)b->i);
+	ec.triangles->push_back((GLuint)c->i);
+}
+
+
+static _TriangulateNode* _TriangulateCureIntersections(_TriangulateEarcut &ec, _TriangulateNode *start) {
+	//Clip tiny self-intersections left by bad input
+	_TriangulateNode *p = start, *a, *b;
+	do {
+		a = p->prev;
+		b = p->next->next;
+		if (!_TriangulateEquals(a, b) && _TriangulateIntersects(a, p, p->next, b) && _TriangulateLocallyInside(a, b) &&
+			_TriangulateLocallyInside(b, a)) {
+			_TriangulateEmit(ec, a, p, b);
+			_TriangulateRemoveNode(p);
+			_TriangulateRemoveNode(p->next);
+			p = start = b;
+		}
+		p = p->next;
+	} while (p != start);
+	return _TriangulateFilter(p);
+}
+
+
+static void _TriangulateLinked(_TriangulateEarcut &ec, _TriangulateNode *ear, const int &pass);
+
+
+static void _TriangulateSplitEarcut(_TriangulateEarcut &ec, _TriangulateNode *start) {
+	//Look for any valid diagonal and triangulate both halves
+	_TriangulateNode *a = start, *b, *c;
+	do {
+		for (b=a->next->next; b!=a->prev; b=b->next) {
+			if ((a->i != b->i) && _TriangulateValidDiagonal(a, b)) {
+				c = _TriangulateSplit(ec, a, b);
+				a = _TriangulateFilter(a, a->next);
+				c = _TriangulateFilter(c, c->next);
+				_TriangulateLinked(ec, a, 0);
+				_TriangulateLinked(ec, c, 0);
+				return;
+			}
+		}
+		a = a->next;
+	} while (a != start);
+}
+
+
+static void _TriangulateLinked(_TriangulateEarcut &ec, _TriangulateNode *ear, const int &pass) {
+	if (ear == NULL) return;
+	if ((pass == 0) && (ec.invSize != 0.0)) _TriangulateIndexCurve(ec, ear);
+	_TriangulateNode *stop = ear, *prev, *next;
+	//Clip ears until only a triangle's worth of ring is left
+	while (ear->prev != ear->next) {
+		prev = ear->prev;
+		next = ear->next;
+		if (_TriangulateIsEar(ec, ear)) {
+			_TriangulateEmit(ec, prev, ear, next);
+			_TriangulateRemoveNode(ear);
+			ear = stop = next->next;
+			continue;
+		}
+		ear = next;
+		//A full lap without an ear - filter, then cure intersections, then split the ring
+		if (ear == stop) {
+			if (pass == 0) _TriangulateLinked(ec, _TriangulateFilter(ear), 1);
+			else if (pass == 1) _TriangulateLinked(ec, _TriangulateCureIntersections(ec, _TriangulateFilter(ear)), 2);
+			else _TriangulateSplitEarcut(ec, ear);
+			break;
+		}
+	}
+}
+
+
+static _TriangulateNode* _TriangulateHoleBridge(_TriangulateNode *hole, _TriangulateNode *outer) {
+	//Find the outer edge hit by a ray to the left of the hole point
+	_TriangulateNode *p = outer, *m = NULL;
+	WPFloat hx = hole->x, hy = hole->y, qx = -std::numeric_limits<WPFloat>::max(), x;
+	do {
+		if ((hy <= p->y) && (hy >= p->next->y) && (p->next->y != p->y)) {
+			x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+			if ((x <= hx) && (x > qx)) {
+				qx = x;
+				m = (p->x < p->next->x) ? p : p->next;
+				if (x == hx) return m;
+			}
+		}
+		p = p->next;
+	} while (p != outer);
+	if (m == NULL) return NULL;
+	//Of the points inside the triangle hole-hit-m, take the one with the smallest angle to the ray
+	_TriangulateNode *stop = m;
+	WPFloat mx = m->x, my = m->y, tanMin = std::numeric_limits<WPFloat>::max(), tan;
+	p = m;
+	do {
+		if ((hx >= p->x) && (p->x >= mx) && (hx != p->x) &&
+			_TriangulateInTriangle((hy < my) ? hx : qx, hy, mx, my, (hy < my) ? qx : hx, hy, p->x, p->y)) {
+			tan = STDFABS(hy - p->y) / (hx - p->x);
+			if (_TriangulateLocallyInside(p, hole) && ((tan < tanMin) || ((tan == tanMin) && ((p->x > m->x) ||
+				((p->x == m->x) && (_TriangulateArea(m->prev, m, p->prev) < 0.0) && (_TriangulateArea(p->next, m, m->next) < 0.0)))))) {
+				m = p;
+				tanMin = tan;
+			}
+		}
+		p = p->next;
+	} while (p != stop);
+	return m;
+}
+
+
+static bool _TriangulateCompareX(const _TriangulateNode *a, const _TriangulateNode *b) {
+	return a->x < b->x;
 }
 
 
 /***********************************************~***************************************************/
 
 
-GLint* __WILDCAT_NAMESPACE__::TriangulatePolygon(const std::list<WCVector4> &pointList) {
-/*** DEBUG ***
-	std::list<WCVector4>::const_iterator plIter;
-	for (plIter = pointList.begin(); plIter != pointList.end(); plIter++) std::cout << *plIter << std::endl;
-/*** DEBUG ***/
-	//Make sure there are at least 4 points
-	if (pointList.size() < 4) {
-		//Trivial case
-		if (pointList.size() == 3) {
-			GLint *tris = new GLint[3];
-			tris[0] = 0;
-			tris[1] = 1;
-			tris[2] = 2;
-			return tris;
-		}
-		//Error case
+WPUInt __WILDCAT_NAMESPACE__::TriangulatePolygon(const std::vector<WPFloat> &points, const std::vector<WPUInt> &holes,
+	std::vector<GLuint> &triangles) {
+	triangles.clear();
+	WPUInt numPoints = (WPUInt)points.size() / 2, outerEnd = holes.empty() ? numPoints : holes.front(), i, end;
+	if (outerEnd < 3) {
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "TriangulatePolygon - Too few points.");
-		//throw error
-		return NULL;
-	}
-	
-	//Create vertex structs for each point
-	std::list<WCVector4>::const_iterator pointIter = pointList.begin();
-	std::list<TriangulateVertex*> vertexList;
-	int id = 0;
-	TriangulateVertex *vert, *rightVert = NULL;
-	//Process remaining vertices
-	for (pointIter = pointList.begin(); pointIter != pointList.end(); pointIter++) {
-		//Create the new vertex
-		vert = new TriangulateVertex();
-		//See about cleaning up last vert
-		if (rightVert != NULL) rightVert->left = vert;
-		vert->id = id++;
-		vert->vertex = *pointIter;
-		vert->right = rightVert;
-		//Add vertex to list and vector
-		vertexList.push_back(vert);
-		//Swap vert into rightVert
-		rightVert = vert;
-	}
-	//Clean up first and last verts
-	vertexList.front()->right = vertexList.back();
-	vertexList.back()->left = vertexList.front();
-
-	//Determine the type of each vertex (and list it)
-	std::list<TriangulateVertex*>::iterator vertIter;
-	for (vertIter = vertexList.begin(); vertIter != vertexList.end(); vertIter++) {
-		(*vertIter)->internalAngle = _TriangulateInternalAngle( *vertIter );
-//		std::cout << "Vert(" << *vertIter << "): " << (*vertIter)->id << ", " << (*vertIter)->internalAngle << " :: " << (*vertIter)->vertex << std::endl;
-//		std::cout << "\tLeft: " << (*vertIter)->left << ", Right: " << (*vertIter)->right << std::endl;
-	}
-
-	//Triangle list
-	GLint *triangles = new GLint[(pointList.size() - 2) * 3];
-	GLint triIndex = 0;
-	std::list<TriangulateVertex*>::iterator earIter;
-	
+		return 0;
+	}
+	_TriangulateEarcut ec;
+	ec.triangles = &triangles;
+	ec.minX = ec.minY = ec.invSize = 0.0;
+	_TriangulateNode *outer = _TriangulateLinkedList(ec, points, 0, outerEnd, true), *list;
+	if ((outer == NULL) || (outer->next == outer->prev)) return 0;
+	//Bridge each hole (left to right) into the outer ring
+	std::vector<_TriangulateNode*> queue;
+	for (i=0; i<holes.size(); i++) {
+		end = (i + 1 < holes.size()) ? holes[i+1] : numPoints;
+		if (end <= holes[i]) continue;
+		list = _TriangulateLinkedList(ec, points, holes[i], end, false);
+		if (list == list->next) list->steiner = true;
+		//Start from the leftmost point
+		_TriangulateNode *p = list, *left = list;
+		do {
+			if ((p->x < left->x) || ((p->x == left->x) && (p->y < left->y))) left = p;
+			p = p->next;
+		} while (p != list);
+		queue.push_back(left);
+	}
+	std::sort(queue.begin(), queue.end(), _TriangulateCompareX);
+	_TriangulateNode *bridge;
+	for (i=0; i<queue.size(); i++) {
+		bridge = _TriangulateHoleBridge(queue[i], outer);
+		if (bridge == NULL) continue;
+		list = _TriangulateSplit(ec, bridge, queue[i]);
+		_TriangulateFilter(list, list->next);
+		outer = _TriangulateFilter(bridge, bridge->next);
+	}
+	//Larger polygons hash their points along a z-order curve
+	if (numPoints > TRIANGULATE_HASH_CUTOFF) {
+		WPFloat maxX = ec.minX = points[0], maxY = ec.minY = points[1];
+		for (i=1; i<outerEnd; i++) {
+			ec.minX = STDMIN(ec.minX, points[i*2]);
+			ec.minY = STDMIN(ec.minY, points[i*2+1]);
+			maxX = STDMAX(maxX, points[i*2]);
+			maxY = STDMAX(maxY, points[i*2+1]);
+		}
+		ec.invSize = STDMAX(maxX - ec.minX, maxY - ec.minY);
+		ec.invSize = (ec.invSize != 0.0) ? 32767.0 / ec.invSize : 0.0;
+	}
+	_TriangulateLinked(ec, outer, 0);
+	//Triangles come out counter-clockwise - match the winding of the outer loop
+	WPFloat sum = 0.0;
+	WPUInt j;
+	for (i=0, j=outerEnd-1; i<outerEnd; j=i++) sum += (points[j*2] - points[i*2]) * (points[i*2+1] + points[j*2+1]);
+	if (sum < 0.0) for (i=0; i<triangles.size(); i+=3) std::swap(triangles[i+1], triangles[i+2]);
+	return (WPUInt)triangles.size() / 3;
+}
+
+
+/***********************************************~***************************************************/
+
+
+//Triangle of a constrained triangulation - edge i is opposite v[i], n[i] is the triangle across it
+struct _TriangulateCDTTriangle {
+	WPUInt										v[3];
+	WPInt										n[3];
+	bool										c[3];
+};
+
+
+//Working state of one constrained triangulation (three super vertices follow the inputs)
+struct _TriangulateCDT {
+	std::vector<WPFloat>						x, y;
+	std::vector<_TriangulateCDTTriangle>		tris;
+	std::vector<WPInt>							vertexTri;
+	WPInt										last;
+	WPFloat										epsilon;
+};
+
+
+static inline WPFloat _TriangulateOrient(const _TriangulateCDT &cdt, const WPUInt &a, const WPUInt &b, const WPUInt &c) {
+	return Orient2D(cdt.x[a], cdt.y[a], cdt.x[b], cdt.y[b], cdt.x[c], cdt.y[c]);
+}
+
+
+static inline WPFloat _TriangulateInCircle(const _TriangulateCDT &cdt, const _TriangulateCDTTriangle &tri, const WPUInt &d) {
+	//Positive when d is inside the circumcircle of the counter-clockwise triangle
+	return InCircle2D(cdt.x[tri.v[0]], cdt.y[tri.v[0]], cdt.x[tri.v[1]], cdt.y[tri.v[1]], cdt.x[tri.v[2]], cdt.y[tri.v[2]],
+		cdt.x[d], cdt.y[d]);
+}
+
+
+static void _TriangulateSet(_TriangulateCDT &cdt, const WPInt &t, const WPUInt &a, const WPUInt &b, const WPUInt &c,
+	const WPInt &na, const WPInt &nb, const WPInt &nc, const bool &ca, const bool &cb, const bool &cc) {
+	_TriangulateCDTTriangle &tri = cdt.tris[t];
+	tri.v[0] = a; tri.v[1] = b; tri.v[2] = c;
+	tri.n[0] = na; tri.n[1] = nb; tri.n[2] = nc;
+	tri.c[0] = ca; tri.c[1] = cb; tri.c[2] = cc;
+	cdt.vertexTri[a] = cdt.vertexTri[b] = cdt.vertexTri[c] = t;
+}
+
+
+static void _TriangulateRelink(_TriangulateCDT &cdt, const WPInt &t, const WPInt &from, const WPInt &to) {
+	if (t < 0) return;
+	for (WPUInt k=0; k<3; k++) if (cdt.tris[t].n[k] == from) cdt.tris[t].n[k] = to;
+}
+
+
+static WPUInt _TriangulateIndex(const _TriangulateCDTTriangle &tri, const WPUInt &vertex) {
+	return (tri.v[0] == vertex) ? 0 : ((tri.v[1] == vertex) ? 1 : 2);
+}
+
+
+static void _TriangulateFlip(_TriangulateCDT &cdt, const WPInt &t, const WPUInt &i) {
+	//Triangles (p,a,b) and (q,b,a) become (p,a,q) and (q,b,p)
+	_TriangulateCDTTriangle T = cdt.tris[t];
+	WPInt u = T.n[i];
+	_TriangulateCDTTriangle U = cdt.tris[u];
+	WPUInt j = (U.n[0] == t) ? 0 : ((U.n[1] == t) ? 1 : 2);
+	WPUInt i1 = (i + 1) % 3, i2 = (i + 2) % 3, j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+	_TriangulateSet(cdt, t, T.v[i], T.v[i1], U.v[j], U.n[j1], u, T.n[i2], U.c[j1], false, T.c[i2]);
+	_TriangulateSet(cdt, u, U.v[j], U.v[j1], T.v[i], T.n[i1], t, U.n[j2], T.c[i1], false, U.c[j2]);
+	_TriangulateRelink(cdt, U.n[j1], u, t);
+	_TriangulateRelink(cdt, T.n[i1], t, u);
+}
+
+
+static void _TriangulateLegalize(_TriangulateCDT &cdt, std::vector<WPInt> &stack, const WPUInt &p) {
+	WPInt t, u;
+	WPUInt i, j;
+	while (!stack.empty()) {
+		t = stack.back();
+		stack.pop_back();
+		i = _TriangulateIndex(cdt.tris[t], p);
+		u = cdt.tris[t].n[i];
+		if ((u < 0) || cdt.tris[t].c[i]) continue;
+		j = (cdt.tris[u].n[0] == t) ? 0 : ((cdt.tris[u].n[1] == t) ? 1 : 2);
+		if (_TriangulateInCircle(cdt, cdt.tris[t], cdt.tris[u].v[j]) <= 0.0) continue;
+		//Both new triangles keep p, and their edges opposite p need checking
+		_TriangulateFlip(cdt, t, i);
+		stack.push_back(t);
+		stack.push_back(u);
+	}
+}
+
+
+static WPInt _TriangulateLocate(_TriangulateCDT &cdt, const WPUInt &p) {
+	WPInt t = cdt.last, next;
+	WPUInt k, steps;
+	//Walk toward the point, then fall back to a full scan if the walk wanders
+	for (steps=0; steps<cdt.tris.size(); steps++) {
+		next = -1;
+		for (k=0; (k<3) && (next < 0); k++)
+			if (_TriangulateOrient(cdt, cdt.tris[t].v[(k+1)%3], cdt.tris[t].v[(k+2)%3], p) < 0.0) next = cdt.tris[t].n[k];
+		if (next < 0) return t;
+		t = next;
+	}
+	for (t=0; t<(WPInt)cdt.tris.size(); t++) {
+		for (k=0; k<3; k++)
+			if (_TriangulateOrient(cdt, cdt.tris[t].v[(k+1)%3], cdt.tris[t].v[(k+2)%3], p) < 0.0) break;
+		if (k == 3) return t;
+	}
+	return -1;
+}
+
+
+static WPInt _TriangulateInsert(_TriangulateCDT &cdt, const WPUInt &p) {
+	WPInt t = _TriangulateLocate(cdt, p);
+	if (t < 0) return -1;
+	_TriangulateCDTTriangle T = cdt.tris[t];
+	WPUInt k, edge = 3;
+	WPFloat dx, dy, best = 0.0, o;
+	//Coincident points merge into the existing vertex
+	for (k=0; k<3; k++) {
+		dx = cdt.x[T.v[k]] - cdt.x[p];
+		dy = cdt.y[T.v[k]] - cdt.y[p];
+		if (dx * dx + dy * dy <= cdt.epsilon * cdt.epsilon) return (WPInt)T.v[k];
+	}
+	//Points within epsilon of an edge split that edge
+	for (k=0; k<3; k++) {
+		dx = cdt.x[T.v[(k+2)%3]] - cdt.x[T.v[(k+1)%3]];
+		dy = cdt.y[T.v[(k+2)%3]] - cdt.y[T.v[(k+1)%3]];
+		o = _TriangulateOrient(cdt, T.v[(k+1)%3], T.v[(k+2)%3], p) / sqrt(dx * dx + dy * dy);
+		if ((o <= cdt.epsilon) && ((edge == 3) || (o < best))) { edge = k; best = o; }
+	}
+	std::vector<WPInt> stack;
+	WPInt t1 = (WPInt)cdt.tris.size(), t2 = t1 + 1;
+	if ((edge == 3) || (T.n[edge] < 0)) {
+		//Split (a,b,c) into (a,b,p), (b,c,p) and (c,a,p)
+		cdt.tris.resize(cdt.tris.size() + 2);
+		_TriangulateSet(cdt, t, T.v[0], T.v[1], p, t1, t2, T.n[2], false, false, T.c[2]);
+		_TriangulateSet(cdt, t1, T.v[1], T.v[2], p, t2, t, T.n[0], false, false, T.c[0]);
+		_TriangulateSet(cdt, t2, T.v[2], T.v[0], p, t, t1, T.n[1], false, false, T.c[1]);
+		_TriangulateRelink(cdt, T.n[0], t, t1);
+		_TriangulateRelink(cdt, T.n[1], t, t2);
+		stack.push_back(t);
+		stack.push_back(t1);
+		stack.push_back(t2);
+	}
+	else {
+		//Split edge (a,b) of (c,a,b) and its neighbour (d,b,a) into four triangles around p
+		WPInt u = T.n[edge];
+		_TriangulateCDTTriangle U = cdt.tris[u];
+		WPUInt j = (U.n[0] == t) ? 0 : ((U.n[1] == t) ? 1 : 2);
+		WPUInt i1 = (edge + 1) % 3, i2 = (edge + 2) % 3, j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+		WPUInt c = T.v[edge], a = T.v[i1], b = T.v[i2], d = U.v[j];
+		bool split = T.c[edge];
+		cdt.tris.resize(cdt.tris.size() + 2);
+		_TriangulateSet(cdt, t, c, a, p, t2, t1, T.n[i2], split, false, T.c[i2]);
+		_TriangulateSet(cdt, t1, c, p, b, u, T.n[i1], t, split, T.c[i1], false);
+		_TriangulateSet(cdt, u, d, b, p, t1, t2, U.n[j2], split, false, U.c[j2]);
+		_TriangulateSet(cdt, t2, d, p, a, t, U.n[j1], u, split, U.c[j1], false);
+		_TriangulateRelink(cdt, T.n[i1], t, t1);
+		_TriangulateRelink(cdt, U.n[j1], u, t2);
+		stack.push_back(t);
+		stack.push_back(t1);
+		stack.push_back(u);
+		stack.push_back(t2);
+	}
+	_TriangulateLegalize(cdt, stack, p);
+	cdt.last = t;
+	return (WPInt)p;
+}
+
+
+static bool _TriangulateFindEdge(_TriangulateCDT &cdt, const WPUInt &a, const WPUInt &b, WPInt &t, WPUInt &k) {
+	//Turn around a until a triangle holding b turns up
+	WPInt start = cdt.vertexTri[a];
+	WPUInt i, j, turn;
+	for (turn=0; turn<2; turn++) {
+		t = start;
+		do {
+			const _TriangulateCDTTriangle &tri = cdt.tris[t];
+			i = _TriangulateIndex(tri, a);
+			for (j=0; j<3; j++) {
+				if (tri.v[j] == b) {
+					k = 3 - i - j;
+					return true;
+				}
+			}
+			t = tri.n[(turn == 0) ? (i + 1) % 3 : (i + 2) % 3];
+		} while ((t >= 0) && (t != start));
+		if (t == start) return false;
+	}
+	return false;
+}
+
+
+static bool _TriangulateConvex(const _TriangulateCDT &cdt, const WPInt &t, const WPUInt &k) {
+	//The quad around edge k of t is strictly convex when p-q separates the edge ends
+	const _TriangulateCDTTriangle &T = cdt.tris[t], &U = cdt.tris[T.n[k]];
+	WPUInt j = (U.n[0] == t) ? 0 : ((U.n[1] == t) ? 1 : 2);
+	WPFloat o1 = _TriangulateOrient(cdt, T.v[k], U.v[j], T.v[(k+1)%3]);
+	WPFloat o2 = _TriangulateOrient(cdt, T.v[k], U.v[j], T.v[(k+2)%3]);
+	return ((o1 < 0.0) && (o2 > 0.0)) || ((o1 > 0.0) && (o2 < 0.0));
+}
+
+
+static bool _TriangulateMark(_TriangulateCDT &cdt, const WPUInt &a, const WPUInt &b) {
+	WPInt t, u;
+	WPUInt k;
+	if (!_TriangulateFindEdge(cdt, a, b, t, k)) return false;
+	//Both sides of the edge carry the flag
+	cdt.tris[t].c[k] = true;
+	u = cdt.tris[t].n[k];
+	if (u >= 0) cdt.tris[u].c[(cdt.tris[u].n[0] == t) ? 0 : ((cdt.tris[u].n[1] == t) ? 1 : 2)] = true;
+	return true;
+}
+
+
+static bool _TriangulateConstrain(_TriangulateCDT &cdt, const WPUInt &a, const WPUInt &b, std::list<std::pair<WPUInt,WPUInt> > &work) {
+	//Already an edge - just mark it
+	if (_TriangulateMark(cdt, a, b)) return true;
+	WPInt t, u;
+	WPUInt k, i, r, l, w, tries;
+	WPFloat dx = cdt.x[b] - cdt.x[a], dy = cdt.y[b] - cdt.y[a];
+	WPFloat length = sqrt(dx * dx + dy * dy), tol = cdt.epsilon * length, sr, sl;
+	WPUInt target = b;
+	std::list<std::pair<WPUInt,WPUInt> > crossing, created;
+	//Find the triangle around a that the segment leaves through
+	WPInt start = cdt.vertexTri[a];
+	bool found = false;
+	t = start;
 	do {
-		//Find an ear
-		earIter = _TriangulateFindEar(vertexList);
-		//Add a triangle
-		triangles[triIndex*3] = (*earIter)->right->id;
-		triangles[triIndex*3+1] = (*earIter)->id;
-		triangles[triIndex*3+2] = (*earIter)->left->id;
-		triIndex++;
-		//Remove the ear (both in list and in linked-list
-		(*earIter)->left->right = (*earIter)->right;
-		(*earIter)->right->left = (*earIter)->left;
-		//Recompute angles for left and right points
-		(*earIter)->left->internalAngle = _TriangulateInternalAngle( (*earIter)->left );
-		(*earIter)->right->internalAngle = _TriangulateInternalAngle( (*earIter)->right );
-		vertexList.erase(earIter);
-	//Keep going until only 3 vertices are left
-	} while (vertexList.size() > 3);
-	//Add the last triangle
-	earIter = vertexList.begin();
-	triangles[triIndex*3] = (*earIter)->right->id;
-	triangles[triIndex*3+1] = (*earIter)->id;
-	triangles[triIndex*3+2] = (*earIter)->left->id;	
-	//Return the list of triangles
-	return triangles;
-}
-
-
-GLint* __WILDCAT_NAMESPACE__::TriangulatePolygon(GLfloat *pointList, const GLuint &numPoints) {
-	//Really really hacky -- create list of points
-	std::list<WCVector4> pList;
-	WCVector4 pt;
-	for (GLuint i=0; i<numPoints; i++) {
-		//Create point
-		pt.Set(pointList[i*4], pointList[i*4+1], 0.0, 1.0);
-		pList.push_back(pt);
-	}
-	//Return the pointer to the list
-	return TriangulatePolygon(pList);
+		i = _TriangulateIndex(cdt.tris[t], a);
+		r = cdt.tris[t].v[(i+1)%3];
+		l = cdt.tris[t].v[(i+2)%3];
+		sr = _TriangulateOrient(cdt, a, b, r);
+		sl = _TriangulateOrient(cdt, a, b, l);
+		//A vertex lying on the segment splits the constraint there
+		if ((STDFABS(sr) <= tol) && ((cdt.x[r] - cdt.x[a]) * dx + (cdt.y[r] - cdt.y[a]) * dy > 0.0)) { target = r; break; }
+		if ((STDFABS(sl) <= tol) && ((cdt.x[l] - cdt.x[a]) * dx + (cdt.y[l] - cdt.y[a]) * dy > 0.0)) { target = l; break; }
+		if ((sr < 0.0) && (sl > 0.0)) { found = true; break; }
+		t = cdt.tris[t].n[(i+1)%3];
+	} while ((t >= 0) && (t != start));
+	if (target != b) {
+		work.push_front(std::make_pair(target, b));
+		work.push_front(std::make_pair(a, target));
+		return true;
+	}
+	if (!found) return false;
+	//Walk across every edge the segment crosses (crossing another constraint means the loops intersect)
+	while (true) {
+		crossing.push_back(std::make_pair(r, l));
+		i = 3 - _TriangulateIndex(cdt.tris[t], r) - _TriangulateIndex(cdt.tris[t], l);
+		if (cdt.tris[t].c[i]) return false;
+		u = cdt.tris[t].n[i];
+		if (u < 0) return false;
+		w = cdt.tris[u].v[3 - _TriangulateIndex(cdt.tris[u], r) - _TriangulateIndex(cdt.tris[u], l)];
+		if (w == b) break;
+		sr = _TriangulateOrient(cdt, a, b, w);
+		if (STDFABS(sr) <= tol) {
+			//Stop at the vertex on the segment and finish the rest later
+			target = w;
+			work.push_front(std::make_pair(w, b));
+			break;
+		}
+		if (sr < 0.0) r = w;
+		else l = w;
+		t = u;
+	}
+	//Flip crossing edges away (Sloan) - edges in non-convex quads wait for their neighbours
+	WPUInt p, q;
+	for (tries=0; !crossing.empty(); tries++) {
+		if (tries > 64 * (cdt.tris.size() + 16)) return false;
+		r = crossing.front().first;
+		l = crossing.front().second;
+		crossing.pop_front();
+		if (!_TriangulateFindEdge(cdt, r, l, t, k)) return false;
+		if (!_TriangulateConvex(cdt, t, k)) {
+			crossing.push_back(std::make_pair(r, l));
+			continue;
+		}
+		p = cdt.tris[t].v[k];
+		_TriangulateFlip(cdt, t, k);
+		q = cdt.tris[t].v[2];
+		sr = _TriangulateOrient(cdt, a, target, p);
+		sl = _TriangulateOrient(cdt, a, target, q);
+		if ((p != a) && (p != target) && (q != a) && (q != target) && (((sr < 0.0) && (sl > 0.0)) || ((sr > 0.0) && (sl < 0.0))))
+			crossing.push_back(std::make_pair(p, q));
+		else created.push_back(std::make_pair(p, q));
+	}
+	//Restore the Delaunay property around the new edges
+	std::list<std::pair<WPUInt,WPUInt> >::iterator edgeIter;
+	bool swapped = true;
+	for (tries=0; swapped && (tries < 64); tries++) {
+		swapped = false;
+		for (edgeIter=created.begin(); edgeIter!=created.end(); edgeIter++) {
+			p = (*edgeIter).first;
+			q = (*edgeIter).second;
+			if (((p == a) && (q == target)) || ((p == target) && (q == a))) continue;
+			if (!_TriangulateFindEdge(cdt, p, q, t, k)) continue;
+			u = cdt.tris[t].n[k];
+			if ((u < 0) || cdt.tris[t].c[k] || !_TriangulateConvex(cdt, t, k)) continue;
+			i = (cdt.tris[u].n[0] == t) ? 0 : ((cdt.tris[u].n[1] == t) ? 1 : 2);
+			if (_TriangulateInCircle(cdt, cdt.tris[t], cdt.tris[u].v[i]) <= 0.0) continue;
+			w = cdt.tris[t].v[k];
+			_TriangulateFlip(cdt, t, k);
+			*edgeIter = std::make_pair(w, cdt.tris[t].v[2]);
+			swapped = true;
+		}
+	}
+	//The segment is now an edge
+	return _TriangulateMark(cdt, a, target);
 }
 
+
+/***********************************************~***************************************************/
+
+
+bool __WILDCAT_NAMESPACE__::ConstrainedTriangulation2D(const std::vector< std::vector<WPFloat> > &loops,
+	const std::vector<WPFloat> &samples, std::vector<GLuint> &triangles) {
+	triangles.clear();
+	//Count the inputs - loop points first, then samples
+	WPUInt numLoop = 0, numPoints, i, k, l, n;
+	for (l=0; l<loops.size(); l++) numLoop += loops[l].size() / 2;
+	numPoints = numLoop + samples.size() / 2;
+	if (numLoop < 3) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "ConstrainedTriangulation2D - Too few loop points.");
+		return false;
+	}
+	_TriangulateCDT cdt;
+	cdt.x.resize(numPoints + 3);
+	cdt.y.resize(numPoints + 3);
+	for (l=0, i=0; l<loops.size(); l++) {
+		for (k=0; k<loops[l].size()/2; k++, i++) {
+			cdt.x[i] = loops[l][k*2];
+			cdt.y[i] = loops[l][k*2+1];
+		}
+	}
+	for (k=0; k<samples.size()/2; k++, i++) {
+		cdt.x[i] = samples[k*2];
+		cdt.y[i] = samples[k*2+1];
+	}
+	//Super triangle well outside the bounds of every point
+	WPFloat xMin = cdt.x[0], xMax = cdt.x[0], yMin = cdt.y[0], yMax = cdt.y[0];
+	for (i=1; i<numPoints; i++) {
+		xMin = STDMIN(xMin, cdt.x[i]);
+		xMax = STDMAX(xMax, cdt.x[i]);
+		yMin = STDMIN(yMin, cdt.y[i]);
+		yMax = STDMAX(yMax, cdt.y[i]);
+	}
+	WPFloat size = STDMAX(STDMAX(xMax - xMin, yMax - yMin), TRIANGULATE_CDT_EPSILON);
+	WPFloat cx = (xMin + xMax) * 0.5, cy = (yMin + yMax) * 0.5;
+	cdt.x[numPoints] = cx - 20.0 * size;
+	cdt.y[numPoints] = cy - size;
+	cdt.x[numPoints+1] = cx + 20.0 * size;
+	cdt.y[numPoints+1] = cy - size;
+	cdt.x[numPoints+2] = cx;
+	cdt.y[numPoints+2] = cy + 20.0 * size;
+	cdt.epsilon = size * TRIANGULATE_CDT_EPSILON;
+	cdt.vertexTri.assign(numPoints + 3, -1);
+	cdt.tris.resize(1);
+	cdt.last = 0;
+	_TriangulateSet(cdt, 0, numPoints, numPoints+1, numPoints+2, -1, -1, -1, false, false, false);
+
+	//Insert every point (coincident ones map onto the first)
+	std::vector<WPUInt> map(numPoints);
+	WPInt vertex;
+	for (i=0; i<numPoints; i++) {
+		vertex = _TriangulateInsert(cdt, i);
+		if (vertex < 0) {
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "ConstrainedTriangulation2D - Unable to locate point " << i << ".");
+			return false;
+		}
+		map[i] = (WPUInt)vertex;
+	}
+	//Force every loop edge into the triangulation
+	std::list<std::pair<WPUInt,WPUInt> > work;
+	for (l=0, i=0; l<loops.size(); i+=n, l++) {
+		n = loops[l].size() / 2;
+		for (k=0; k<n; k++) work.push_back(std::make_pair(map[i+k], map[i+(k+1)%n]));
+	}
+	std::pair<WPUInt,WPUInt> segment;
+	while (!work.empty()) {
+		segment = work.front();
+		work.pop_front();
+		if (segment.first == segment.second) continue;
+		if (!_TriangulateConstrain(cdt, segment.first, segment.second, work)) {
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "ConstrainedTriangulation2D - Unable to recover loop edge (loops may intersect).");
+			return false;
+		}
+	}
+
+	//Flood out from the super triangle - crossing a loop edge toggles inside and outside
+	std::vector<int> parity(cdt.tris.size(), -1);
+	std::vector<WPInt> stack(1, cdt.vertexTri[numPoints]);
+	WPInt t, u;
+	parity[stack.back()] = 0;
+	while (!stack.empty()) {
+		t = stack.back();
+		stack.pop_back();
+		for (k=0; k<3; k++) {
+			u = cdt.tris[t].n[k];
+			if ((u < 0) || (parity[u] >= 0)) continue;
+			parity[u] = parity[t] ^ (cdt.tris[t].c[k] ? 1 : 0);
+			stack.push_back(u);
+		}
+	}
+	//Copy out the counter-clockwise inside triangles
+	for (t=0; t<(WPInt)cdt.tris.size(); t++) {
+		if ((parity[t] != 1) || (cdt.tris[t].v[0] >= numPoints) || (cdt.tris[t].v[1] >= numPoints) || (cdt.tris[t].v[2] >= numPoints)) continue;
+		for (k=0; k<3; k++) triangles.push_back((GLuint)cdt.tris[t].v[k]);
+	}
+	return true;
+}
+
+
+/***********************************************~***************************************************/
@@ -108,6 +108,10 @@ std::list<WCIntersectionResult> GeometricIntersection(WCNurbsCurve *left, WCGeom
 std::list<WCIntersectionResult> GeometricIntersection(WCNurbsCurve *left, WCNurbsCurve *right, const WPFloat &tol, const unsigned int &flags=INTERSECT_GEN_ALL);
 std::list<WCIntersectionResult> GeometricIntersection(WCNurbsCurve *left, WCNurbsSurface *right, const WPFloat &tol, const unsigned int &flags=INTERSECT_GEN_ALL);
 std::list<WCIntersectionResult> GeometricIntersection(WCNurbsCurve *left, WCTrimmedNurbsSurface *right, const WPFloat &tol, const unsigned int &flags=INTERSECT_GEN_ALL);
+WPUInt CurveCurveIntersection(WCNurbsCurve *left, WCNurbsCurve *right, const WPFloat &tol, const unsigned int &flags,
+												std::vector<WCIntersectionResult> &results);
+WPUInt CurveLineIntersection(WCNurbsCurve *left, WCGeometricLine *right, const WPFloat &tol, const unsigned int &flags,
+												std::vector<WCIntersectionResult> &results);
 
 
 /*** Surface-Object Functions ***/
@@ -116,6 +120,14 @@ std::list<WCIntersectionResult> GeometricIntersection(WCNurbsSurface *left, WCGe
 std::list<WCIntersectionResult> GeometricIntersection(WCNurbsSurface *left, WCNurbsCurve *right, const WPFloat &tol, const unsigned int &flags=INTERSECT_GEN_ALL);
 std::list<WCIntersectionResult> GeometricIntersection(WCNurbsSurface *left, WCNurbsSurface *right, const WPFloat &tol, const unsigned int &flags=INTERSECT_GEN_ALL);
 std::list<WCIntersectionResult> GeometricIntersection(WCNurbsSurface *left, WCTrimmedNurbsSurface *right, const WPFloat &tol, const unsigned int &flags=INTERSECT_GEN_ALL);
+WPUInt SurfaceLineIntersection(WCNurbsSurface *left, WCGeometricLine *right, const WPFloat &tol, const unsigned int &flags,
+												std::vector<WCIntersectionResult> &results);
+WPUInt SurfaceCurveIntersection(WCNurbsSurface *left, WCNurbsCurve *right, const WPFloat &tol, const unsigned int &flags,
+												std::vector<WCIntersectionResult> &results);
+WPUInt SurfaceSurfaceIntersection(WCNurbsSurface *left, WCNurbsSurface *right, const WPFloat &tol, const unsigned int &flags,
+												std::vector<WCIntersectionResult> &results,
+												const std::vector< std::vector<WPFloat> > *leftLoops=NULL,
+												const std::vector< std::vector<WPFloat> > *rightLoops=NULL);
 
 
 /*** TrimSurface-Object Functions ***/
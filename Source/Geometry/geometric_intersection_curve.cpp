@@ -32,11 +32,16 @@
 #include <Geometry/geometric_point.h>
 #include <Geometry/geometric_line.h>
 #include <Geometry/nurbs_curve.h>
+#include <Geometry/nurbs.h>
+#include <Geometry/bezier_hierarchy.h>
+#include <algorithm>
 
 
 /*** Locally Defined Values ***/
-#define CLI_LINE_CUTOFF							0.075
-#define CCI_CURVE_CUTOFF						3
+#define CPI_CHORD_FACTOR						0.25
+#define CCI_MAX_ITERATIONS						24
+#define CCI_MAX_HALVINGS						8
+#define CCI_EPSILON								0.000000000001
 
 
 /***********************************************~***************************************************/
@@ -57,16 +62,16 @@ std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCN
 	//See if point is within curve bounding box
 	if (left->BoundingBox().Intersection( right->BoundingBox() )) return results;
 
-	//Determine estimated length of curve and LOD
-	WPUInt lod = STDMIN((WPUInt)(left->EstimateLength() / tol), (WPUInt)WCAdapter::GetMax2DTextureSize());
-	GLfloat *data = left->GenerateClientBuffer(0.0, 1.0, lod, true);
+	//Tessellate adaptively so the polyline stays well inside the tolerance of the curve
+	WPUInt lod;
+	std::vector<WPFloat> params;
+	GLfloat *data = left->GenerateAdaptiveBuffer(tol * CPI_CHORD_FACTOR, NURBSCURVE_ADAPTIVE_ANGLE, lod, &params, true);
 
 	//Initialize the p0 vector and other variables
 	WCVector4 p0((WPFloat)data[0], (WPFloat)data[1], (WPFloat)data[2], 1.0);
 	WCVector4 p1, direction, tmpVec;
 	WPFloat u, dist, lastU=-1.0;
 	WPUInt index=4;
-	WPFloat paraFactor = 1.0 / (lod - 1);
 
 	//Loop through remaining vertices and test each
 	for (WPUInt i=1; i<lod; i++) {
@@ -87,7 +92,7 @@ std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCN
 			//See distance is within tolerance
 			if (tmpVec.Distance(right->Data()) <= tol) {
 				//Convert u from segment to curve
-				u = (i - 1 + u) * paraFactor;
+				u = params.at(i-1) + (params.at(i) - params.at(i-1)) * u;
 				//Do consecutive hit check (u is always greater than lastU)
 				if (u - lastU > tol) {
 					//Create a hit result
@@ -121,171 +126,15 @@ std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCN
 /***********************************************~***************************************************/
 
 
+/*** GeometricIntersection -- Curve and Line ***
+ * This algorithm tries to intersect a line with a NURBS curve.  The result can be zero to many hits and may include a linear overlap.
+ *	The work is done on the CPU by CurveLineIntersection.
+ ***/
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCNurbsCurve *left,
 	 WCGeometricLine *right, const WPFloat &tol, const unsigned int &flags) {
-	std::list<WCIntersectionResult> results;
-	//See if line intersects curve bounding box
-	if (left->BoundingBox().Intersection(right->BoundingBox())) return results;
-
-	//LOD is smaller of length/tolerance and maximum texture size
-//	WPUInt lod = STDMIN((WPUInt)(left->EstimateLength() / tol), (WPUInt)WCAdapter::GetMax2DTextureSize());
-	WPUInt lod = STDMIN((WPUInt)(left->EstimateLength() / tol), (WPUInt)512);
-	//Setup the left texture
-	GLuint leftTex = left->GenerateTextureBuffer(0.0, 1.0, lod, true);
-
-	//Set program values
-	glUseProgram(left->Context()->CurveLineProgram());
-	glUniform2f(left->Context()->IntersectionLocations()[INTERSECTION_CLI_PARAMS], (GLfloat)lod, (GLfloat)tol);
-	glUniform4f(left->Context()->IntersectionLocations()[INTERSECTION_CLI_LBEGIN], 
-				(GLfloat)right->Begin().I(), (GLfloat)right->Begin().J(), (GLfloat)right->Begin().K(), 1.0);
-	glUniform4f(left->Context()->IntersectionLocations()[INTERSECTION_CLI_LEND],
-				(GLfloat)right->End().I(), (GLfloat)right->End().J(), (GLfloat)right->End().K(), 1.0);
-
-	//Save the viewport setting
-	glPushAttrib(GL_VIEWPORT_BIT | GL_POLYGON_BIT | GL_ENABLE_BIT | GL_TEXTURE_BIT);
-	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
-	//Set some GL settings
-	glDisable(GL_BLEND);
-	glDisable(GL_DEPTH_TEST);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	//Setup left texture
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, leftTex);
-	//Bind to the framebuffer
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, left->Context()->CurveCurveFramebuffer());
-	//Set up the viewport and polygon mode
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-	//Ready the input quad
-	GLfloat quad[] = { -1.0, -1.0, -1.0, 1.0, 1.0, 1.0, 1.0, -1.0 };
-	glVertexPointer(2, GL_FLOAT, 0, quad);
-	//Render the quad
-	glDrawArrays(GL_QUADS, 0, 4);
-	//Check for errors
-	if (glGetError() != GL_NO_ERROR)
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "_CurveLine Intersection - Render.");
-
-	//Read the results from the framebuffer
-	GLfloat *cciData = new GLfloat[lod * 4];
-	glReadPixels(0, 0, lod, 1, GL_RGBA, GL_FLOAT, cciData);
-	//Clean up the GL state
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
-	//Delete data array
-	left->ReleaseTexture(leftTex);	
-	glPopAttrib();
-	glPopClientAttrib();
-	//Check for errors
-	if (glGetError() != GL_NO_ERROR)
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "_CurveLine Intersection - GL Clean up.");
-/*** DEBUG ***
-	std::cout << "Debug output for CLI\n";
-	for (int i=0; i<lod; i++) {
-		 if (cciData[i*4] != -1.0) {
-			 std::cout << i << ": " << cciData[i*4] << ", " << cciData[i*4+1] << ", " << cciData[i*4+2] << ", " << cciData[i*4+3] << std::endl;
-		 }
-	}
-/*** DEBUG ***/
-
-	/*** Scan output for intersection results ***/
-
-	WPFloat paraFactor = 1.0 / lod, mua, mub;
-	WCVector4 point;	
-	WCIntersectionResult hit;
-	WPUInt lookAhead, diff;
-	std::vector<WCVector4> curvePoints;
-	//Loop through the output
-	for (WPUInt i=0; i<lod; i++) {
-		//A non -1.0 in the first place indicates a hit
-		if (cciData[i*4] != -1.0) {
-			//Look ahead to see how many hits in a row there are
-			lookAhead = i + 1;
-			while ((cciData[lookAhead * 4] != -1.0) && (lookAhead <lod)) lookAhead++;
-			diff = lookAhead - i;
-			//Get the first and last points
-			WCVector4 start(cciData[i*4+1], cciData[i*4+2], cciData[i*4+3], 1.0);
-			WCVector4 end(cciData[lookAhead*4-3], cciData[lookAhead*4-2], cciData[lookAhead*4-1], 1.0);
-			WPFloat dist = start.Distance(end);
-			//See how long the overlap is
-			if (dist > CLI_LINE_CUTOFF) {
-				//Determine left and right start and stop parametric values
-				WPFloat leftStart = i * paraFactor;
-				WPFloat leftEnd = (lookAhead-1) * paraFactor;
-				WPFloat rightStart = cciData[i*4];
-				WPFloat rightEnd = cciData[lookAhead*4-4];
-				//Set hit param values
-				hit.leftParam.I(leftStart);
-				hit.leftParam.J(leftEnd);
-				hit.rightParam.I(rightStart);
-				hit.rightParam.J(rightEnd);
-				//Set hit type
-				hit.type = IntersectLine;
-				//Set hit boundary values
-				hit.leftBoundary = ( (leftStart < paraFactor) || (leftEnd > 1.0-paraFactor) );
-				hit.rightBoundary = ( (rightStart < paraFactor) || (rightEnd > 1.0-paraFactor) );
-				//Check if culling end-point intersections
-				if (!(flags & INTERSECT_CULL_BOUNDARY) ||  (!hit.leftBoundary && !hit.rightBoundary)) {
-					//See if genObj
-					if (flags & INTERSECT_GEN_LINES) {
-						//Determine line start and end values
-						WCVector4 ptA = right->Evaluate(rightStart);
-						WCVector4 ptB = right->Evaluate(rightEnd);
-						//Create new line
-						WCGeometricLine *newLine = new WCGeometricLine(ptA, ptB);
-						//Add to result struct
-						hit.object = newLine;
-					}
-					else hit.object = NULL;
-					//Add the intersection to the list
-//					std::cout << "CLI - " << hit << std::endl;
-					results.push_back(hit);
-				}
-			}
-			//Diff <= CLI_CURVE_CUTOFF is a point
-			else {
-				//Find average of mua, mub, and point
-				mua = 0.0;
-				mub = 0.0;
-				point.Set(0.0, 0.0, 0.0, 0.0);
-				//Accumulate the values
-				for (WPUInt j=i; j<lookAhead; j++) {
-					mua += (j * paraFactor);
-					mub += cciData[j*4];
-					point += WCVector4(cciData[j*4+1], cciData[j*4+2], cciData[j*4+3], 1.0);
-				}
-				//Average the values
-				mua = STDMAX(0.0, STDMIN(mua / diff, 1.0));
-				//Determine actual overall parametric value on right
-				mub = STDMAX(0.0, STDMIN(mub / diff, 1.0));
-				//Get intersection point
-				point /= diff;
-				//Create intersection result
-				hit.type = IntersectPoint;
-				hit.leftParam.I(mua);
-				hit.rightParam.I(mub);
-				hit.leftBoundary = (mua <= paraFactor) || (mua >= 1.0 - paraFactor);
-				hit.rightBoundary = (mub <= paraFactor) || (mub >= 1.0 - paraFactor);
-				//Check if culling end-point intersections
-				if (!(flags & INTERSECT_CULL_BOUNDARY) ||  (!hit.leftBoundary && !hit.rightBoundary)) {
-					//See if genObj
-					if (flags & INTERSECT_GEN_POINTS) {
-						//Create new point
-						WCGeometricPoint *newPoint = new WCGeometricPoint(point);
-						//Add to result struct
-						hit.object = newPoint;
-					}
-					else hit.object = NULL;
-					//Add the intersection to the list
-//					std::cout << "CLI - " << hit << point << std::endl;
-					results.push_back(hit);
-				}
-			}
-			//Increment i to lookAhead
-			i = lookAhead;
-		}
-	}
-	//Delete the data buffer
-	delete cciData;
-	//Return the results
-	return results;
+	std::vector<WCIntersectionResult> hits;
+	CurveLineIntersection(left, right, tol, flags, hits);
+	return std::list<WCIntersectionResult>(hits.begin(), hits.end());
 }
 
 /***********************************************~***************************************************/
@@ -396,203 +245,398 @@ std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCN
 /***********************************************~***************************************************/
 
 
-/*** GeometricIntersection -- Curve and Curve ***
- * This algorithm tries to intersect a NURBS curve with a NURBS curve.  The result can be zero to many hits and may include an extended overlap.
+//One refined curve-curve hit - parameters on both curves and the point between them
+struct _CCIHit {
+	WPFloat										left, right;
+	WPFloat										point[3];
+	bool operator<(const _CCIHit &hit) const	{ return this->left < hit.left; }
+};
+
+
+//Cartesian point and first derivative of a Bezier piece at t in [0,1]
+static void _CCIPiecePoint(const WPUInt &degree, const WPFloat *hcp, const WPFloat &t, WPFloat *c, WPFloat *d) {
+	WPFloat h[4], hd[4];
+	WCNurbs::EvaluateBezierDerivative(degree, hcp, 4, t, h, hd);
+	for (WPUInt i=0; i<3; i++) {
+		c[i] = h[i] / h[3];
+		d[i] = (hd[i] - hd[3] * c[i]) / h[3];
+	}
+}
+
+
+//Closest points between segments a0-a1 and b0-b1 (parameters clamped to [0,1]) - true if the segments are parallel
+static bool _CCISegmentClosest(const WPFloat *a0, const WPFloat *a1, const WPFloat *b0, const WPFloat *b1, WPFloat &s, WPFloat &t) {
+	WPFloat d1[3], d2[3], r[3], a = 0.0, e = 0.0, f = 0.0, c = 0.0, b = 0.0;
+	for (WPUInt i=0; i<3; i++) {
+		d1[i] = a1[i] - a0[i];
+		d2[i] = b1[i] - b0[i];
+		r[i] = a0[i] - b0[i];
+		a += d1[i] * d1[i];
+		e += d2[i] * d2[i];
+		f += d2[i] * r[i];
+		c += d1[i] * r[i];
+		b += d1[i] * d2[i];
+	}
+	s = t = 0.0;
+	if ((a <= CCI_EPSILON) && (e <= CCI_EPSILON)) return false;
+	if (a <= CCI_EPSILON) { t = STDMAX(0.0, STDMIN(1.0, f / e)); return false; }
+	if (e <= CCI_EPSILON) { s = STDMAX(0.0, STDMIN(1.0, -c / a)); return false; }
+	//Parallel segments take any s, then clamp t and go back for s
+	WPFloat denom = a * e - b * b;
+	bool parallel = (denom <= CCI_EPSILON * a * e);
+	if (!parallel) s = STDMAX(0.0, STDMIN(1.0, (b * f - c * e) / denom));
+	t = (b * s + f) / e;
+	if (t < 0.0) { t = 0.0; s = STDMAX(0.0, STDMIN(1.0, -c / a)); }
+	else if (t > 1.0) { t = 1.0; s = STDMAX(0.0, STDMIN(1.0, (b - c) / a)); }
+	return parallel;
+}
+
+
+//Gauss-Newton on |A(s) - B(t)|, inside both pieces - returns the final gap
+static WPFloat _CCIRefine(const WPUInt &degA, const WPFloat *hcpA, const WPUInt &degB, const WPFloat *hcpB,
+	WPFloat &s, WPFloat &t, WPFloat *point) {
+	WPFloat ca[3], da[3], cb[3], db[3], r[3], nca[3], nda[3], ncb[3], ndb[3];
+	WPFloat a11, a12, a22, b1, b2, det, ds, dt, ns, nt, dist, nextDist;
+	WPUInt iter, half, i;
+	_CCIPiecePoint(degA, hcpA, s, ca, da);
+	_CCIPiecePoint(degB, hcpB, t, cb, db);
+	for (i=0; i<3; i++) r[i] = ca[i] - cb[i];
+	dist = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+	for (iter=0; (iter<CCI_MAX_ITERATIONS) && (dist > CCI_EPSILON); iter++) {
+		a11 = da[0] * da[0] + da[1] * da[1] + da[2] * da[2];
+		a12 = -(da[0] * db[0] + da[1] * db[1] + da[2] * db[2]);
+		a22 = db[0] * db[0] + db[1] * db[1] + db[2] * db[2];
+		b1 = -(da[0] * r[0] + da[1] * r[1] + da[2] * r[2]);
+		b2 = db[0] * r[0] + db[1] * r[1] + db[2] * r[2];
+		det = a11 * a22 - a12 * a12;
+		//Tangent curves make the system singular - step each curve on its own
+		if (det <= CCI_EPSILON * a11 * a22) {
+			ds = (a11 > 0.0) ? b1 / a11 : 0.0;
+			dt = (a22 > 0.0) ? b2 / a22 : 0.0;
+		}
+		else {
+			ds = (b1 * a22 - b2 * a12) / det;
+			dt = (a11 * b2 - a12 * b1) / det;
+		}
+		//Halve the step until the gap closes
+		for (half=0; half<CCI_MAX_HALVINGS; half++, ds *= 0.5, dt *= 0.5) {
+			ns = STDMAX(0.0, STDMIN(1.0, s + ds));
+			nt = STDMAX(0.0, STDMIN(1.0, t + dt));
+			_CCIPiecePoint(degA, hcpA, ns, nca, nda);
+			_CCIPiecePoint(degB, hcpB, nt, ncb, ndb);
+			nextDist = sqrt((nca[0] - ncb[0]) * (nca[0] - ncb[0]) + (nca[1] - ncb[1]) * (nca[1] - ncb[1]) +
+				(nca[2] - ncb[2]) * (nca[2] - ncb[2]));
+			if (nextDist <= dist) break;
+		}
+		if (half == CCI_MAX_HALVINGS) break;
+		ds = ns - s;
+		dt = nt - t;
+		s = ns;
+		t = nt;
+		dist = nextDist;
+		for (i=0; i<3; i++) {
+			ca[i] = nca[i];	da[i] = nda[i];
+			cb[i] = ncb[i];	db[i] = ndb[i];
+			r[i] = ca[i] - cb[i];
+		}
+		if (fabs(ds) + fabs(dt) < CCI_EPSILON) break;
+	}
+	for (i=0; i<3; i++) point[i] = 0.5 * (ca[i] + cb[i]);
+	return dist;
+}
+
+
+//Same hit if within tol on every axis
+static bool _CCISameHit(const _CCIHit &a, const _CCIHit &b, const WPFloat &tol) {
+	return (fabs(a.point[0] - b.point[0]) <= tol) && (fabs(a.point[1] - b.point[1]) <= tol) && (fabs(a.point[2] - b.point[2]) <= tol);
+}
+
+
+//Hits within tol of each other in space are the same hit - hits must be sorted along the left curve, so one pass against
+//	the last kept hit finds them (plus the seam of a closed left curve, where u = 0 and u = 1 meet)
+static void _CCIUnique(const std::vector<_CCIHit> &hits, const WPFloat &tol, std::vector<_CCIHit> &unique) {
+	for (WPUInt i=0; i<hits.size(); i++)
+		if (unique.empty() || !_CCISameHit(unique.back(), hits[i], tol)) unique.push_back(hits[i]);
+	if ((unique.size() > 1) && _CCISameHit(unique.front(), unique.back(), tol)) unique.pop_back();
+}
+
+
+//Cartesian point of the curve at u from its hierarchy pieces - false if no piece holds u
+static bool _CCICurvePoint(const WCBezierHierarchy *tree, const WPFloat &u, WPFloat *c) {
+	WPFloat d[3];
+	for (WPUInt i=0; i<tree->NumberPieces(); i++) {
+		const WSBezierPiece &piece = tree->Piece(i);
+		if ((u < piece.uMin) || (u > piece.uMax)) continue;
+		_CCIPiecePoint(tree->DegreeU(), tree->PiecePoints(i), (u - piece.uMin) / (piece.uMax - piece.uMin), c, d);
+		return true;
+	}
+	return false;
+}
+
+
+//Raise the multiplicity of knot u to the degree - true if it already was or the insertion worked
+static bool _CCIFullKnot(WCNurbsCurve &curve, const WPFloat &u) {
+	WPUInt p = curve.Degree(), m = 0;
+	WPFloat *kp = curve.KnotPoints();
+	for (WPUInt i=0; i<curve.NumberKnotPoints(); i++) if (kp[i] == u) m++;
+	return (m >= p) || curve.InsertKnot(u, p - m);
+}
+
+
+//Exact copy of the curve between u0 and u1, cut out at full multiplicity knots and rescaled to [0,1]
+static WCNurbsCurve* _CCISubCurve(WCNurbsCurve *curve, const WPFloat &u0, const WPFloat &u1) {
+	WPUInt p = curve->Degree(), i, first;
+	//Degree one curves have no knots - keep the polyline corners between the end points
+	if (p == 1) {
+		WPFloat c[3];
+		std::vector<WCVector4> controlPoints = curve->ControlPoints(), corners;
+		if (!_CCICurvePoint(curve->Hierarchy(), u0, c)) return NULL;
+		corners.push_back(WCVector4(c[0], c[1], c[2], 1.0));
+		WPUInt n = (WPUInt)controlPoints.size();
+		for (i=1; i+1<n; i++)
+			if (((WPFloat)i / (n - 1) > u0) && ((WPFloat)i / (n - 1) < u1)) corners.push_back(controlPoints.at(i));
+		if (!_CCICurvePoint(curve->Hierarchy(), u1, c)) return NULL;
+		corners.push_back(WCVector4(c[0], c[1], c[2], 1.0));
+		return new WCNurbsCurve(curve->Context(), 1, corners, WCNurbsMode::Default(), std::vector<WPFloat>());
+	}
+	WCNurbsCurve copy(*curve);
+	if (!_CCIFullKnot(copy, u0) || !_CCIFullKnot(copy, u1)) return NULL;
+	std::vector<WCVector4> controlPoints = copy.ControlPoints();
+	WPFloat *kp = copy.KnotPoints();
+	//The last u0 knot sits p places after the first control point of the piece
+	for (first=0; (first+1<copy.NumberKnotPoints()) && (kp[first+1] <= u0); first++) ;
+	std::vector<WPFloat> knots(p+1, u0);
+	for (i=first+1; kp[i] < u1; i++) knots.push_back(kp[i]);
+	knots.insert(knots.end(), p+1, u1);
+	//Curves evaluate over [0,1]
+	for (i=0; i<knots.size(); i++) knots[i] = (knots[i] - u0) / (u1 - u0);
+	std::vector<WCVector4> points(controlPoints.begin() + (first - p), controlPoints.begin() + (first - p) + (knots.size() - p - 1));
+	return new WCNurbsCurve(curve->Context(), p, points, WCNurbsMode::Custom(), knots);
+}
+
+
+/*** CurveCurveIntersection ***
+ * CPU intersection of two NURBS curves.  Both curves are split into Bezier pieces held in their bounding hierarchies.  Piece
+ *	pairs whose boxes come within tol are seeded from the closest points of their chords and refined by Gauss-Newton on the
+ *	pieces themselves, which also finds tangential hits.  Hits are then merged:
+ *		1) Hits within tol of each other on both curves are the same hit
+ *		2) Runs of hits whose midpoints also lie on the other curve are an overlap (IntersectCurve)
+ *		3) Must check flags for CULL_BOUNDARY case and only add hit as appropriate
+ *	Results are appended to the caller's vector, so a reused vector does no per-hit allocation.
  ***/
-std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCNurbsCurve *left, WCNurbsCurve *right,
-	const WPFloat &tol, const unsigned int &flags) {
-	std::list<WCIntersectionResult> results;
+WPUInt __WILDCAT_NAMESPACE__::CurveCurveIntersection(WCNurbsCurve *left, WCNurbsCurve *right, const WPFloat &tol,
+	const unsigned int &flags, std::vector<WCIntersectionResult> &results) {
 	//Check if self intersection
-	if (left == right) return results;
-	//See if bounding boxes intersect
-	if (left->BoundingBox().Intersection(right->BoundingBox())) return results;
-	
-	/*** Setup programs and texture locations ***/
-
-	WPFloat length = STDMAX(left->EstimateLength(), right->EstimateLength());
-	WPUInt lod = STDMIN((WPUInt)(length / tol), (WPUInt)WCAdapter::GetMax2DTextureSize());
-	WPFloat paraFactor = 1.0 / lod, mua, mub;
-	WCVector4 point;
-	GLfloat *leftData = left->GenerateClientBuffer(0.0, 1.0, lod, true);
-	GLfloat *rightData = right->GenerateClientBuffer(0.0, 1.0, lod, true);
-	//Set program values
-	glUseProgram(left->Context()->CurveCurveProgram());
-	glUniform2f(left->Context()->IntersectionLocations()[INTERSECTION_CCI_PARAMS], (GLfloat)lod, (GLfloat)tol);
-
-	/*** Bind to framebuffer object ***/
-	
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, left->Context()->CurveCurveFramebuffer());
-	//Check to make sure the framebuffer is ready
-	GLenum retVal = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
-	//Check the status of the framebuffer object
-	if (retVal != GL_FRAMEBUFFER_COMPLETE_EXT) { 
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "_CurveCurve Intersection - Framebuffer is not complete.");
-		return results;
+	if ((left == NULL) || (right == NULL) || (left == right)) return 0;
+	const WCBezierHierarchy *leftTree = left->Hierarchy();
+	const WCBezierHierarchy *rightTree = right->Hierarchy();
+	if ((leftTree == NULL) || (rightTree == NULL)) return 0;
+	//Broad phase - piece pairs whose boxes are within tol
+	std::vector< std::pair<WPUInt,WPUInt> > pairs;
+	leftTree->Overlaps(*rightTree, tol, pairs);
+	if (pairs.empty()) return 0;
+
+	/*** Refine each candidate pair ***/
+
+	WPUInt degA = leftTree->DegreeU(), degB = rightTree->DegreeU(), i, j, k, seeds;
+	WPFloat a0[3], a1[3], b0[3], b1[3], s, t, gap;
+	std::vector<_CCIHit> hits;
+	_CCIHit hit;
+	for (i=0; i<pairs.size(); i++) {
+		const WSBezierPiece &pieceA = leftTree->Piece(pairs[i].first);
+		const WSBezierPiece &pieceB = rightTree->Piece(pairs[i].second);
+		const WPFloat *hcpA = leftTree->PiecePoints(pairs[i].first);
+		const WPFloat *hcpB = rightTree->PiecePoints(pairs[i].second);
+		for (k=0; k<3; k++) {
+			a0[k] = hcpA[k] / hcpA[3];
+			a1[k] = hcpA[degA*4+k] / hcpA[degA*4+3];
+			b0[k] = hcpB[k] / hcpB[3];
+			b1[k] = hcpB[degB*4+k] / hcpB[degB*4+3];
+		}
+		//Parallel chords may overlap, so seed from both ends of the left piece
+		seeds = _CCISegmentClosest(a0, a1, b0, b1, s, t) ? 2 : 1;
+		for (j=0; j<seeds; j++) {
+			if (j == 1) {
+				_CCISegmentClosest(a1, a1, b0, b1, s, t);
+				s = 1.0;
+			}
+			gap = _CCIRefine(degA, hcpA, degB, hcpB, s, t, hit.point);
+			if (gap > tol) continue;
+			hit.left = pieceA.uMin + s * (pieceA.uMax - pieceA.uMin);
+			hit.right = pieceB.uMin + t * (pieceB.uMax - pieceB.uMin);
+			hits.push_back(hit);
+		}
 	}
-	
-	/*** Setup Left texture ***/
-	
-	//Setup and copy the data into the texture
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	//Set up texture
-	glActiveTexture(GL_TEXTURE0);	
-	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, left->Context()->CCILeftTex());	
-	glTexSubImage2D(GL_TEXTURE_RECTANGLE_ARB, 0, 0, 0, lod, 1, GL_RGBA, GL_FLOAT, leftData);
-	//Delete data array
-	left->ReleaseBuffer(leftData);
-	
-	/*** Setup Right texture ***/
-	
-	//Setup and copy the data into the texture
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	//Set up texture
-	glActiveTexture(GL_TEXTURE1);	
-	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, left->Context()->CCIRightTex());	
-	glTexSubImage2D(GL_TEXTURE_RECTANGLE_ARB, 0, 0, 0, lod, 1, GL_RGBA, GL_FLOAT, rightData);
-	//Delete data array
-	right->ReleaseBuffer(rightData);
-	
-	
-	/*** Setup Viewport and Render***/
-	
-	//Save the viewport setting
-	glPushAttrib(GL_VIEWPORT_BIT);
-	//Disable some settings
-	glDisable(GL_BLEND);
-	glDisable(GL_DEPTH_TEST);
-	//Set the viewport
-	glViewport(0, 0, lod, 1);
-	//Draw into the framebuffer
-	GLfloat vertData[] = { -1.0, -1.0, -1.0, 1.0, 1.0, 1.0, 1.0, -1.0 };
-	//Turn on vertex arrays
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, 0, vertData);
-	//--- Draw ---
-	glDrawArrays(GL_QUADS, 0, 4);
-	//Clean up
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glPopAttrib();
-	//Re-enable some settings
-	glEnable(GL_BLEND);
-	glEnable(GL_DEPTH_TEST);
-	//Check for errors
-	if (glGetError() != GL_NO_ERROR)
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "_CurveCurve Intersection - Render.");
-	
-	/*** Save output texture into array using simple memory read ***/
-	
-	GLfloat *cciData = new GLfloat[lod * 4];
-	glReadPixels(0, 0, lod, 1, GL_RGBA, GL_FLOAT, cciData);
-	//Clean up the framebuffer object and cp/kp textures
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
-	//Stop using a program
-	glUseProgram(0);
-	//Check for errors
-	if (glGetError() != GL_NO_ERROR)
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "_CurveCurve Intersection - Clean up.");
-/*** DEBUG ***
-	for (int i=0; i<lod; i++) {
-		if (cciData[i*4] != -1.0) {
-			CLOGGER_ERROR(WCLogManager::RootLogger(), i << ": " << cciData[i*4] << ", " << cciData[i*4+1] << ", " << cciData[i*4+2] << ", " << cciData[i*4+3]);
+	if (hits.empty()) return 0;
+
+	/*** Merge duplicates and overlaps ***/
+
+	std::sort(hits.begin(), hits.end());
+	std::vector<_CCIHit> unique;
+	_CCIUnique(hits, tol, unique);
+	//Curve end points come from the Bezier segments, which are clamped to the ends
+	const WPFloat *points, *breaks;
+	WPUInt segments = left->BezierSegments(points, breaks), last = (segments * (degA + 1) - 1) * 4;
+	WCVector4 leftStart(points[0] / points[3], points[1] / points[3], points[2] / points[3], 1.0);
+	WCVector4 leftEnd(points[last] / points[last+3], points[last+1] / points[last+3], points[last+2] / points[last+3], 1.0);
+	segments = right->BezierSegments(points, breaks);
+	last = (segments * (degB + 1) - 1) * 4;
+	WCVector4 rightStart(points[0] / points[3], points[1] / points[3], points[2] / points[3], 1.0);
+	WCVector4 rightEnd(points[last] / points[last+3], points[last+1] / points[last+3], points[last+2] / points[last+3], 1.0);
+	WPUInt count = 0;
+	WPFloat mid[4], near[3], u;
+	WCIntersectionResult result;
+	WCVector4 point, other;
+	for (i=0; i<unique.size(); i=last+1) {
+		//Extend the run while the curves stay together between neighbouring hits (hierarchies, so degree one curves work too)
+		for (last=i; last+1<unique.size(); last++) {
+			if (!_CCICurvePoint(leftTree, 0.5 * (unique[last].left + unique[last+1].left), mid)) break;
+			mid[3] = 1.0;
+			if (!right->InvertPoints(mid, 1, &u) || !_CCICurvePoint(rightTree, u, near)) break;
+			if ((mid[0] - near[0]) * (mid[0] - near[0]) + (mid[1] - near[1]) * (mid[1] - near[1]) +
+				(mid[2] - near[2]) * (mid[2] - near[2]) > tol * tol) break;
+		}
+		point.Set(unique[i].point[0], unique[i].point[1], unique[i].point[2], 1.0);
+		other.Set(unique[last].point[0], unique[last].point[1], unique[last].point[2], 1.0);
+		result.leftBoundary = (point.Distance(leftStart) <= tol) || (point.Distance(leftEnd) <= tol) ||
+			(other.Distance(leftStart) <= tol) || (other.Distance(leftEnd) <= tol);
+		result.rightBoundary = (point.Distance(rightStart) <= tol) || (point.Distance(rightEnd) <= tol) ||
+			(other.Distance(rightStart) <= tol) || (other.Distance(rightEnd) <= tol);
+		result.object = NULL;
+		//Check if culling end-point intersections
+		if ((flags & INTERSECT_CULL_BOUNDARY) && (result.leftBoundary || result.rightBoundary)) continue;
+		if (last == i) {
+			result.type = IntersectPoint;
+			result.leftParam = WCVector4(unique[i].left, 0.0, 0.0, 0.0);
+			result.rightParam = WCVector4(unique[i].right, 0.0, 0.0, 0.0);
+			if (flags & INTERSECT_GEN_POINTS) result.object = new WCGeometricPoint(point);
+		}
+		else {
+			result.type = IntersectCurve;
+			result.leftParam = WCVector4(unique[i].left, unique[last].left, 0.0, 0.0);
+			result.rightParam = WCVector4(unique[i].right, unique[last].right, 0.0, 0.0);
+			if (flags & INTERSECT_GEN_CURVES) result.object = _CCISubCurve(left, unique[i].left, unique[last].left);
 		}
+		results.push_back(result);
+		count++;
 	}
-/*** DEBUG ***/
-
-	/*** Scan output for intersection results ***/
-
-	WCIntersectionResult hit;
-	WPUInt lookAhead, diff;
-	std::vector<WCVector4> curvePoints;
-	//Loop through the output
-	for (WPUInt i=0; i<lod; i++) {
-		//A non -1.0 in the first place indicates a hit
-		if (cciData[i*4] != -1.0) {
-			//Look ahead to see how many hits in a row there are
-			lookAhead = i + 1;
-			while ((cciData[lookAhead * 4] != -1.0) && (lookAhead <lod)) lookAhead++;
-			diff = lookAhead - i;
-			//Diff > CCI_CURVE_CUTOFF is a curve
-			if (diff > CCI_CURVE_CUTOFF) {
-				//Determine start and stop parameters for left
-				hit.type = IntersectCurve;
-				hit.leftParam.I( STDMAX(0.0, STDMIN(i * paraFactor, 1.0)) );
-				hit.leftParam.J( STDMAX(0.0, STDMIN((lookAhead-1) * paraFactor, 1.0)) );
-				//Determine start and stop parameters for right
-				hit.rightParam.I(0.0);
-				hit.rightParam.J(1.0);
-				//Determine boundary values
-				hit.leftBoundary = false;
-				hit.rightBoundary = false;
-				//Check if culling end-point intersections
-				if (!(flags & INTERSECT_CULL_BOUNDARY) ||  (!hit.leftBoundary && !hit.rightBoundary)) {
-					//See if genObj
-					if (flags & INTERSECT_GEN_CURVES) {
-						//Accumulate the points into a vector
-						for (WPUInt j=i; j<lookAhead; j++) {
-							//Get the point data
-							point = WCVector4(cciData[j*4+1], cciData[j*4+2], cciData[j*4+3], 1.0);
-							//Add to the vector
-							curvePoints.push_back(point);
-						}
-						//Create the curve
-						WCNurbsCurve* newCurve = WCNurbsCurve::GlobalInterpolation(curvePoints, 3);
-						//Add to result struct
-						hit.object = newCurve;
-					}
-					else hit.object = NULL;
-					//Add the intersection to the list
-//					std::cout << "CCI - " << hit << point << std::endl;
-					results.push_back(hit);
-				}
-			}
-			// Diff <= CCI_CURVE_CUTOFF, must be a point
-			else {
-				//Find average of mua, mub, and point
-				mua = 0.0;
-				mub = 0.0;
-				point.Set(0.0, 0.0, 0.0, 0.0);
-				//Accumulate the values
-				for (WPUInt j=i; j<lookAhead; j++) {
-					mua += (j * paraFactor);
-					mub += (cciData[j*4] * paraFactor);
-					point += WCVector4(cciData[j*4+1], cciData[j*4+2], cciData[j*4+3], 1.0);
-				}
-				//Average the values
-				mua = STDMAX(0.0, STDMIN(mua / diff, 1.0));
-				//Determine actual overall parametric value on right
-				mub = STDMAX(0.0, STDMIN(mub / diff, 1.0));
-				//Get intersection point
-				point /= diff;
-				//Create intersection result
-				hit.type = IntersectPoint;
-				hit.leftParam.I(mua);
-				hit.rightParam.I(mub);
-				hit.leftBoundary = (mua <= paraFactor) || (mua >= 1.0 - paraFactor);
-				hit.rightBoundary = (mub <= paraFactor) || (mub >= 1.0 - paraFactor);
-				//Check if culling end-point intersections
-				if (!(flags & INTERSECT_CULL_BOUNDARY) ||  (!hit.leftBoundary && !hit.rightBoundary)) {
-					//See if genObj
-					if (flags & INTERSECT_GEN_POINTS) {
-						//Create new point
-						WCGeometricPoint *newPoint = new WCGeometricPoint(point);
-						//Add to result struct
-						hit.object = newPoint;
-					}
-					else hit.object = NULL;
-					//Add the intersection to the list
-//					std::cout << "CCI - " << hit << point << std::endl;
-					results.push_back(hit);
-				}
+	//Return the number of results added
+	return count;
+}
+
+
+/***********************************************~***************************************************/
+
+
+/*** CurveLineIntersection ***
+ * CPU intersection of a NURBS curve and a line segment.  Curve pieces whose boxes the line passes near are refined by Gauss-Newton
+ *	against the segment, held as a single degree one piece.  Runs of hits whose midpoints also lie on the segment are an overlap
+ *	(IntersectLine).  The line parameter runs 0 to 1 from Begin to End.  Results are appended to the caller's vector.
+ ***/
+WPUInt __WILDCAT_NAMESPACE__::CurveLineIntersection(WCNurbsCurve *left, WCGeometricLine *right, const WPFloat &tol,
+	const unsigned int &flags, std::vector<WCIntersectionResult> &results) {
+	if ((left == NULL) || (right == NULL)) return 0;
+	const WCBezierHierarchy *tree = left->Hierarchy();
+	if (tree == NULL) return 0;
+	WCVector4 begin = right->Begin(), end = right->End();
+	WPFloat segment[8] = { begin.I(), begin.J(), begin.K(), 1.0, end.I(), end.J(), end.K(), 1.0 };
+	std::vector<WPUInt> candidates;
+	tree->RayQuery(begin, end - begin, tol, candidates);
+	if (candidates.empty()) return 0;
+
+	/*** Refine each candidate piece ***/
+
+	WPUInt degree = tree->DegreeU(), i, j, k, seeds;
+	WPFloat a0[3], a1[3], s, t, gap;
+	std::vector<_CCIHit> hits;
+	_CCIHit hit;
+	for (i=0; i<candidates.size(); i++) {
+		const WSBezierPiece &piece = tree->Piece(candidates[i]);
+		const WPFloat *hcp = tree->PiecePoints(candidates[i]);
+		for (k=0; k<3; k++) {
+			a0[k] = hcp[k] / hcp[3];
+			a1[k] = hcp[degree*4+k] / hcp[degree*4+3];
+		}
+		//A chord parallel to the line may overlap it, so seed from both ends of the piece
+		seeds = _CCISegmentClosest(a0, a1, segment, segment+4, s, t) ? 2 : 1;
+		for (j=0; j<seeds; j++) {
+			if (j == 1) {
+				_CCISegmentClosest(a1, a1, segment, segment+4, s, t);
+				s = 1.0;
 			}
-			//Increment i to lookAhead
-			i = lookAhead;
+			gap = _CCIRefine(degree, hcp, 1, segment, s, t, hit.point);
+			if (gap > tol) continue;
+			hit.left = piece.uMin + s * (piece.uMax - piece.uMin);
+			hit.right = t;
+			hits.push_back(hit);
 		}
 	}
-	//Delete the data buffer
-	delete cciData;
-	
-	//Return the results
-	return results;
+	if (hits.empty()) return 0;
+
+	/*** Merge duplicates and overlaps ***/
+
+	std::sort(hits.begin(), hits.end());
+	std::vector<_CCIHit> unique;
+	_CCIUnique(hits, tol, unique);
+	//Curve end points come from the Bezier segments, which are clamped to the ends
+	const WPFloat *points, *breaks;
+	WPUInt segments = left->BezierSegments(points, breaks), last = (segments * (degree + 1) - 1) * 4;
+	WCVector4 leftStart(points[0] / points[3], points[1] / points[3], points[2] / points[3], 1.0);
+	WCVector4 leftEnd(points[last] / points[last+3], points[last+1] / points[last+3], points[last+2] / points[last+3], 1.0);
+	WPUInt count = 0;
+	WPFloat mid[3];
+	WCIntersectionResult result;
+	WCVector4 point, other;
+	for (i=0; i<unique.size(); i=last+1) {
+		//Extend the run while the curve stays on the segment between neighbouring hits
+		for (last=i; last+1<unique.size(); last++) {
+			if (!_CCICurvePoint(tree, 0.5 * (unique[last].left + unique[last+1].left), mid)) break;
+			_CCISegmentClosest(mid, mid, segment, segment+4, s, t);
+			point.Set(mid[0], mid[1], mid[2], 1.0);
+			if (point.Distance(right->Evaluate(t)) > tol) break;
+		}
+		point.Set(unique[i].point[0], unique[i].point[1], unique[i].point[2], 1.0);
+		other.Set(unique[last].point[0], unique[last].point[1], unique[last].point[2], 1.0);
+		result.leftBoundary = (point.Distance(leftStart) <= tol) || (point.Distance(leftEnd) <= tol) ||
+			(other.Distance(leftStart) <= tol) || (other.Distance(leftEnd) <= tol);
+		result.rightBoundary = (point.Distance(begin) <= tol) || (point.Distance(end) <= tol) ||
+			(other.Distance(begin) <= tol) || (other.Distance(end) <= tol);
+		result.object = NULL;
+		//Check if culling end-point intersections
+		if ((flags & INTERSECT_CULL_BOUNDARY) && (result.leftBoundary || result.rightBoundary)) continue;
+		if (last == i) {
+			result.type = IntersectPoint;
+			result.leftParam = WCVector4(unique[i].left, 0.0, 0.0, 0.0);
+			result.rightParam = WCVector4(unique[i].right, 0.0, 0.0, 0.0);
+			if (flags & INTERSECT_GEN_POINTS) result.object = new WCGeometricPoint(point);
+		}
+		else {
+			result.type = IntersectLine;
+			result.leftParam = WCVector4(unique[i].left, unique[last].left, 0.0, 0.0);
+			result.rightParam = WCVector4(unique[i].right, unique[last].right, 0.0, 0.0);
+			if (flags & INTERSECT_GEN_LINES)
+				result.object = new WCGeometricLine(right->Evaluate(unique[i].right), right->Evaluate(unique[last].right));
+		}
+		results.push_back(result);
+		count++;
+	}
+	//Return the number of results added
+	return count;
+}
+
+
+/***********************************************~***************************************************/
+
+
+/*** GeometricIntersection -- Curve and Curve ***
+ * This algorithm tries to intersect a NURBS curve with a NURBS curve.  The result can be zero to many hits and may include an extended overlap.
+ *	The work is done on the CPU by CurveCurveIntersection.
+ ***/
+std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCNurbsCurve *left, WCNurbsCurve *right,
+	const WPFloat &tol, const unsigned int &flags) {
+	std::vector<WCIntersectionResult> hits;
+	CurveCurveIntersection(left, right, tol, flags, hits);
+	return std::list<WCIntersectionResult>(hits.begin(), hits.end());
 }
 
 
@@ -33,6 +33,180 @@
 #include <Geometry/geometric_line.h>
 #include <Geometry/nurbs_curve.h>
 #include <Geometry/nurbs_surface.h>
+#include <Geometry/nurbs.h>
+#include <Geometry/bezier_hierarchy.h>
+#include <Utility/matrix.h>
+#include <Utility/thread_pool.h>
+
+
+/*** Locally Defined Values ***/
+#define SCI_MAX_ITERATIONS						24
+#define SCI_MAX_HALVINGS						8
+#define SCI_EPSILON								0.000000000001
+#define SSI_SEED_BLOCK							16
+#define SSI_SEED_SIZE							8
+#define SSI_MAX_POINTS							4096
+#define SSI_MAX_ANGLE							10.0
+#define SSI_MIN_STEP							0.0001
+#define SSI_STEP_FRACTION						0.05
+#define SSI_COVER_FACTOR						0.1
+#define SSI_CONVERGE_FACTOR						0.01
+#define SSI_CORRECTOR_ITERATIONS				12
+#define SSI_TANGENT_EPSILON						0.000001
+#define SSI_CURVE_DEGREE						3
+
+
+/***********************************************~***************************************************/
+
+
+//One refined surface-curve hit - surface u,v and curve t, with the point between them
+struct _SCIHit {
+	WPFloat										u, v, t;
+	WPFloat										point[3];
+};
+
+
+//Cartesian point and partials of a rational Bezier patch (v major rows) at u,v in [0,1]
+static void _SCIPatchPoint(const WPUInt &pU, const WPUInt &pV, const WPFloat *hcp, const WPFloat &u, const WPFloat &v,
+	WPFloat *s, WPFloat *su, WPFloat *sv) {
+	WPFloat rows[NURBS_BASIS_MAX_ORDER*4], rowsU[NURBS_BASIS_MAX_ORDER*4], h[4], hu[4], hv[4];
+	//Collapse each row in u, then the column of row results in v
+	for (WPUInt r=0; r<=pV; r++)
+		WCNurbs::EvaluateBezierDerivative(pU, hcp + r * (pU+1) * 4, 4, u, rows + r * 4, rowsU + r * 4);
+	WCNurbs::EvaluateBezierDerivative(pV, rows, 4, v, h, hv);
+	WCNurbs::EvaluateBezier(pV, rowsU, 4, v, hu);
+	for (WPUInt i=0; i<3; i++) {
+		s[i] = h[i] / h[3];
+		su[i] = (hu[i] - hu[3] * s[i]) / h[3];
+		sv[i] = (hv[i] - hv[3] * s[i]) / h[3];
+	}
+}
+
+
+//Cartesian point and first derivative of a Bezier curve piece at t in [0,1]
+static void _SCIPiecePoint(const WPUInt &degree, const WPFloat *hcp, const WPFloat &t, WPFloat *c, WPFloat *d) {
+	WPFloat h[4], hd[4];
+	WCNurbs::EvaluateBezierDerivative(degree, hcp, 4, t, h, hd);
+	for (WPUInt i=0; i<3; i++) {
+		c[i] = h[i] / h[3];
+		d[i] = (hd[i] - hd[3] * c[i]) / h[3];
+	}
+}
+
+
+//Gauss-Newton on |S(u,v) - C(t)| inside a patch and a curve piece - returns the final gap
+static WPFloat _SCIRefine(const WPUInt &pU, const WPUInt &pV, const WPFloat *patch, const WPUInt &degree, const WPFloat *piece,
+	WPFloat &u, WPFloat &v, WPFloat &t, WPFloat *point) {
+	WPFloat s[3], su[3], sv[3], c[3], ct[3], ns[3], nsu[3], nsv[3], nc[3], nct[3], r[3], col[3][3];
+	WPFloat moved, nu, nv, nt, dist, nextDist;
+	WCMatrixN<3,3> normal;
+	WCVectorN<3> gradient, step;
+	WPUInt iter, half, i, j, k;
+	_SCIPatchPoint(pU, pV, patch, u, v, s, su, sv);
+	_SCIPiecePoint(degree, piece, t, c, ct);
+	for (i=0; i<3; i++) r[i] = s[i] - c[i];
+	dist = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+	for (iter=0; (iter<SCI_MAX_ITERATIONS) && (dist > SCI_EPSILON); iter++) {
+		//Normal equations of the Jacobian [Su Sv -C']
+		for (i=0; i<3; i++) {
+			col[0][i] = su[i];
+			col[1][i] = sv[i];
+			col[2][i] = -ct[i];
+		}
+		for (j=0; j<3; j++) {
+			gradient.Set(j, -(col[j][0] * r[0] + col[j][1] * r[1] + col[j][2] * r[2]));
+			for (k=0; k<3; k++) normal.Set(j, k, col[j][0] * col[k][0] + col[j][1] * col[k][1] + col[j][2] * col[k][2]);
+		}
+		//Tangent contact makes the system singular - step each parameter on its own
+		if (!normal.Solve(gradient, step, SCI_EPSILON)) {
+			for (j=0; j<3; j++) step.Set(j, (normal.Get(j, j) > 0.0) ? gradient.Get(j) / normal.Get(j, j) : 0.0);
+		}
+		//Halve the step until the gap closes
+		for (half=0; half<SCI_MAX_HALVINGS; half++, step = step * 0.5) {
+			nu = STDMAX(0.0, STDMIN(1.0, u + step.Get(0)));
+			nv = STDMAX(0.0, STDMIN(1.0, v + step.Get(1)));
+			nt = STDMAX(0.0, STDMIN(1.0, t + step.Get(2)));
+			_SCIPatchPoint(pU, pV, patch, nu, nv, ns, nsu, nsv);
+			_SCIPiecePoint(degree, piece, nt, nc, nct);
+			nextDist = sqrt((ns[0] - nc[0]) * (ns[0] - nc[0]) + (ns[1] - nc[1]) * (ns[1] - nc[1]) + (ns[2] - nc[2]) * (ns[2] - nc[2]));
+			if (nextDist <= dist) break;
+		}
+		if (half == SCI_MAX_HALVINGS) break;
+		moved = fabs(nu - u) + fabs(nv - v) + fabs(nt - t);
+		u = nu;
+		v = nv;
+		t = nt;
+		dist = nextDist;
+		for (i=0; i<3; i++) {
+			s[i] = ns[i];	su[i] = nsu[i];	sv[i] = nsv[i];
+			c[i] = nc[i];	ct[i] = nct[i];
+			r[i] = s[i] - c[i];
+		}
+		if (moved < SCI_EPSILON) break;
+	}
+	for (i=0; i<3; i++) point[i] = 0.5 * (s[i] + c[i]);
+	return dist;
+}
+
+
+//Refine every candidate patch and curve piece pair, then report the distinct hits
+static WPUInt _SCIIntersect(WCNurbsSurface *surface, const WCBezierHierarchy *tree, const std::vector< std::pair<WPUInt,WPUInt> > &pairs,
+	const WPUInt &degree, const WPFloat *pieces, const WPFloat *pieceRanges, const WCVector4 &curveStart, const WCVector4 &curveEnd,
+	const WPFloat &tol, const unsigned int &flags, std::vector<WCIntersectionResult> &results) {
+	WPUInt pU = tree->DegreeU(), pV = tree->DegreeV(), i, j, k;
+	WPFloat center[3], su[3], sv[3], d[3], dd, t, gap;
+	std::vector<_SCIHit> hits;
+	_SCIHit hit;
+	for (i=0; i<pairs.size(); i++) {
+		const WSBezierPiece &patch = tree->Piece(pairs[i].first);
+		const WPFloat *hcp = tree->PiecePoints(pairs[i].first);
+		const WPFloat *piece = pieces + pairs[i].second * (degree+1) * 4;
+		//Seed from the patch centre and its projection onto the piece chord
+		_SCIPatchPoint(pU, pV, hcp, 0.5, 0.5, center, su, sv);
+		for (k=0, t=0.0, dd=0.0; k<3; k++) {
+			d[k] = piece[degree*4+k] / piece[degree*4+3] - piece[k] / piece[3];
+			t += d[k] * (center[k] - piece[k] / piece[3]);
+			dd += d[k] * d[k];
+		}
+		hit.u = 0.5;
+		hit.v = 0.5;
+		hit.t = (dd > SCI_EPSILON) ? STDMAX(0.0, STDMIN(1.0, t / dd)) : 0.0;
+		gap = _SCIRefine(pU, pV, hcp, degree, piece, hit.u, hit.v, hit.t, hit.point);
+		if (gap > tol) continue;
+		hit.u = patch.uMin + hit.u * (patch.uMax - patch.uMin);
+		hit.v = patch.vMin + hit.v * (patch.vMax - patch.vMin);
+		hit.t = pieceRanges[pairs[i].second*2] + hit.t * (pieceRanges[pairs[i].second*2+1] - pieceRanges[pairs[i].second*2]);
+		//Neighbouring patches and pieces find the same hit
+		for (j=0; j<hits.size(); j++)
+			if ((fabs(hits[j].point[0] - hit.point[0]) <= tol) && (fabs(hits[j].point[1] - hit.point[1]) <= tol) &&
+				(fabs(hits[j].point[2] - hit.point[2]) <= tol)) break;
+		if (j == hits.size()) hits.push_back(hit);
+	}
+	//Surface boundary is the edge of the knot domain
+	WPFloat *kpU = surface->KnotPointsU(), *kpV = surface->KnotPointsV();
+	WPFloat uMin = kpU[0], uMax = kpU[surface->NumberKnotPointsU()-1];
+	WPFloat vMin = kpV[0], vMax = kpV[surface->NumberKnotPointsV()-1];
+	WPFloat eps = SCI_EPSILON * STDMAX(1.0, STDMAX(uMax - uMin, vMax - vMin));
+	WCIntersectionResult result;
+	WCVector4 point;
+	WPUInt count = 0;
+	for (i=0; i<hits.size(); i++) {
+		point.Set(hits[i].point[0], hits[i].point[1], hits[i].point[2], 1.0);
+		result.type = IntersectPoint;
+		result.leftParam = WCVector4(hits[i].u, hits[i].v, 0.0, 0.0);
+		result.rightParam = WCVector4(hits[i].t, 0.0, 0.0, 0.0);
+		result.leftBoundary = (hits[i].u - uMin <= eps) || (uMax - hits[i].u <= eps) || (hits[i].v - vMin <= eps) || (vMax - hits[i].v <= eps);
+		result.rightBoundary = (point.Distance(curveStart) <= tol) || (point.Distance(curveEnd) <= tol);
+		result.object = NULL;
+		//Must check flags for CULL_BOUNDARY case and only add hit as appropriate
+		if ((flags & INTERSECT_CULL_BOUNDARY) && (result.leftBoundary || result.rightBoundary)) continue;
+		if (flags & INTERSECT_GEN_POINTS) result.object = new WCGeometricPoint(point);
+		results.push_back(result);
+		count++;
+	}
+	//Return the number of results added
+	return count;
+}
 
 
 /***********************************************~***************************************************/
@@ -41,149 +215,549 @@
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCNurbsSurface *left,
 	WCGeometricPoint *right, const WPFloat &tol, const unsigned int &flags) {
 	std::list<WCIntersectionResult> results;
-	//See if point is within surface bounding box
-	if (left->BoundingBox().Intersection(right->BoundingBox())) return results;
-
-	//Determine estimated area of surface and LODs
-	WPUInt lodU = STDMIN((WPUInt)(WCNurbs::EstimateLengthU(left->ControlPoints(), left->NumberControlPointsU()) / tol), (WPUInt)WCAdapter::GetMax2DTextureSize());
-	WPUInt lodV = STDMIN((WPUInt)(WCNurbs::EstimateLengthV(left->ControlPoints(), left->NumberControlPointsV()) / tol), (WPUInt)WCAdapter::GetMax2DTextureSize());
-	//Generate surface to precision of tol and place into local buffer
-	std::vector<GLfloat*> buffers = left->GenerateClientBuffers(0.0, 1.0, lodU, 0.0, 1.0, lodV, true);
-	GLfloat* vertexBuffer = buffers.at(NURBSSURFACE_VERTEX_BUFFER);
-	GLuint* indexBuffer = (GLuint*)buffers.at(NURBSSURFACE_INDEX_BUFFER);
-
-	//Determine number of triangles in the surface
+	//Project the point onto the surface - the inversion is seeded from the surface hierarchy
 	WCVector4 p = right->Data();
-	WPUInt indexA, indexB, indexC;
-	WCVector4 v0, v1, v2, v1v0, v2v0, d, dNorm, pvec, tvec, qvec;
-	WPFloat det, u, v, t;
-	WPUInt numTris = (lodU - 1) * (lodV - 1) * 2;
-	//Compare point against each triangle within buffer
-	for (WPUInt triIndex=0; triIndex < numTris; triIndex++) {
-		//Get the indices for the three vertices
-		indexA = indexBuffer[triIndex];
-		indexB = indexBuffer[triIndex+1];
-		indexC = indexBuffer[triIndex+2];
-		//Get the vertex values for the triangle
-		v0 = WCVector4(vertexBuffer[indexA]);
-		v1 = WCVector4(vertexBuffer[indexB]);
-		v2 = WCVector4(vertexBuffer[indexC]);
-
-		//Get vXv0 vectors and normal
-		v1v0 = v1 - v0;
-		v2v0 = v2 - v0;
-		d = v1v0.CrossProduct(v2v0);
-		dNorm = d;
-		dNorm.Normalize();
-
-		//Calculate determinant
-		pvec = d.CrossProduct(v2v0);
-		det = pvec.DotProduct(v1v0);
-		//Get tvec and U
-		tvec = p - v0;
-		u = tvec.DotProduct(pvec);
-		//Make sure u is within bounds
-		if (u >= 0.0 && u <= det) {
-			qvec = tvec.CrossProduct(v1v0);
-			//Calculate and bounds test v
-			v = d.DotProduct(qvec);
-			if (v >= 0.0 && u + v <= det) {
-				//Calculate t and scale u and v
-				t = v2v0.DotProduct(qvec);
-				det = 1.0 / det;
-				t *= det;
-				//Make sure t is very small
-				//...
-				u *= det;
-				v *= det;
-				//Convert u and v into surface u and v values
-				//...
-
-				//Create intersection result for the point
-				WCIntersectionResult hit;
-				hit.type = IntersectPoint;
-//				hit.leftBoundary = (u < tol) || (1.0 - u < tol);
-//				hit.rightBoundary = true;
-//				hit.leftParam.I(u);
-//				hit.rightParam = right->Data();
-				//Do boundary cull check, insert if ok
-				if (!(flags * INTERSECT_CULL_BOUNDARY) || !hit.leftBoundary) {
-					//Add the hit to the list
-					results.push_back(hit);
-				}
+	WPFloat u, v;
+	if (!left->InvertPoint(p, u, v)) return results;
+	if (left->Evaluate(u, v).Distance(p) > tol) return results;
+	//Surface boundary is the edge of the knot domain
+	WPFloat *kpU = left->KnotPointsU(), *kpV = left->KnotPointsV();
+	WPFloat eps = SCI_EPSILON * STDMAX(1.0, STDMAX(kpU[left->NumberKnotPointsU()-1] - kpU[0], kpV[left->NumberKnotPointsV()-1] - kpV[0]));
+	//Create intersection result for the point
+	WCIntersectionResult hit;
+	hit.type = IntersectPoint;
+	hit.leftParam = WCVector4(u, v, 0.0, 0.0);
+	hit.rightParam = p;
+	hit.leftBoundary = (u - kpU[0] <= eps) || (kpU[left->NumberKnotPointsU()-1] - u <= eps) ||
+		(v - kpV[0] <= eps) || (kpV[left->NumberKnotPointsV()-1] - v <= eps);
+	hit.rightBoundary = true;
+	hit.object = NULL;
+	//Do boundary cull check, insert if ok
+	if ((flags & INTERSECT_CULL_BOUNDARY) && hit.leftBoundary) return results;
+	if (flags & INTERSECT_GEN_POINTS) hit.object = new WCGeometricPoint(p);
+	results.push_back(hit);
+	//Return the results
+	return results;
+}
+
+
+/*** SurfaceLineIntersection ***
+ * CPU intersection of a NURBS surface and a line segment.  Patches of the surface hierarchy the segment passes near are refined by
+ *	Gauss-Newton on the patch and the segment together.  The line parameter runs 0 to 1 from Begin to End.  Results are appended
+ *	to the caller's vector.
+ ***/
+WPUInt __WILDCAT_NAMESPACE__::SurfaceLineIntersection(WCNurbsSurface *left, WCGeometricLine *right, const WPFloat &tol,
+	const unsigned int &flags, std::vector<WCIntersectionResult> &results) {
+	if ((left == NULL) || (right == NULL)) return 0;
+	const WCBezierHierarchy *tree = left->Hierarchy();
+	if (tree == NULL) return 0;
+	//The segment is a single degree one piece
+	WCVector4 begin = right->Begin(), end = right->End();
+	WPFloat segment[8] = { begin.I(), begin.J(), begin.K(), 1.0, end.I(), end.J(), end.K(), 1.0 }, range[2] = { 0.0, 1.0 };
+	std::vector<WPUInt> candidates;
+	tree->RayQuery(begin, end - begin, tol, candidates);
+	std::vector< std::pair<WPUInt,WPUInt> > pairs;
+	for (WPUInt i=0; i<candidates.size(); i++) pairs.push_back(std::make_pair(candidates[i], (WPUInt)0));
+	return _SCIIntersect(left, tree, pairs, 1, segment, range, begin, end, tol, flags, results);
+}
+
+
+/*** SurfaceCurveIntersection ***
+ * CPU intersection of a NURBS surface and a NURBS curve.  The two bounding hierarchies are walked together and each close patch and
+ *	curve piece pair is refined by Gauss-Newton.  Results are appended to the caller's vector.
+ ***/
+WPUInt __WILDCAT_NAMESPACE__::SurfaceCurveIntersection(WCNurbsSurface *left, WCNurbsCurve *right, const WPFloat &tol,
+	const unsigned int &flags, std::vector<WCIntersectionResult> &results) {
+	if ((left == NULL) || (right == NULL)) return 0;
+	const WCBezierHierarchy *tree = left->Hierarchy();
+	const WCBezierHierarchy *curveTree = right->Hierarchy();
+	if ((tree == NULL) || (curveTree == NULL)) return 0;
+	std::vector< std::pair<WPUInt,WPUInt> > pairs;
+	tree->Overlaps(*curveTree, tol, pairs);
+	if (pairs.empty()) return 0;
+	//Curve pieces are packed into one array in hierarchy order
+	WPUInt degree = curveTree->DegreeU(), size = (degree+1) * 4, i;
+	std::vector<WPFloat> pieces(curveTree->NumberPieces() * size), ranges(curveTree->NumberPieces() * 2);
+	for (i=0; i<curveTree->NumberPieces(); i++) {
+		memcpy(&pieces[i*size], curveTree->PiecePoints(i), size * sizeof(WPFloat));
+		ranges[i*2] = curveTree->Piece(i).uMin;
+		ranges[i*2+1] = curveTree->Piece(i).uMax;
+	}
+	//Curve end points come from the Bezier segments, which are clamped to the ends
+	const WPFloat *points, *breaks;
+	WPUInt segments = right->BezierSegments(points, breaks), last = (segments * (degree+1) - 1) * 4;
+	WCVector4 start(points[0] / points[3], points[1] / points[3], points[2] / points[3], 1.0);
+	WCVector4 end(points[last] / points[last+3], points[last+1] / points[last+3], points[last+2] / points[last+3], 1.0);
+	return _SCIIntersect(left, tree, pairs, degree, &pieces[0], &ranges[0], start, end, tol, flags, results);
+}
+
+
+/*** Surface-Surface Helpers ***/
+
+
+//Minimum norm Gauss-Newton on |S1(u1,v1) - S2(u2,v2)| inside two patches - returns the final gap
+static WPFloat _SSIRefinePatches(const WPUInt &pU1, const WPUInt &pV1, const WPFloat *patch1, const WPUInt &pU2, const WPUInt &pV2,
+	const WPFloat *patch2, WPFloat *x, WPFloat *point) {
+	WPFloat s1[3], s2[3], d[4][3], n1[3], n2[3], nd[4][3], r[3], nx[4], step[4], jg[3];
+	WPFloat dist, nextDist, alpha, moved, sign[4] = { 1.0, 1.0, -1.0, -1.0 };
+	WCMatrixN<3,3> m;
+	WCVectorN<3> b, y;
+	WPUInt iter, half, i, j, k;
+	_SCIPatchPoint(pU1, pV1, patch1, x[0], x[1], s1, d[0], d[1]);
+	_SCIPatchPoint(pU2, pV2, patch2, x[2], x[3], s2, d[2], d[3]);
+	for (i=0; i<3; i++) r[i] = s1[i] - s2[i];
+	dist = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+	for (iter=0; (iter<SCI_MAX_ITERATIONS) && (dist > SCI_EPSILON); iter++) {
+		//Columns of the Jacobian are S1u, S1v, -S2u, -S2v (the signs drop out of J J^T)
+		for (i=0; i<3; i++) {
+			b.Set(i, -r[i]);
+			for (j=0; j<3; j++) m.Set(i, j, d[0][i] * d[0][j] + d[1][i] * d[1][j] + d[2][i] * d[2][j] + d[3][i] * d[3][j]);
+		}
+		if (m.Solve(b, y, SCI_EPSILON)) {
+			for (k=0; k<4; k++) step[k] = sign[k] * (d[k][0] * y.Get(0) + d[k][1] * y.Get(1) + d[k][2] * y.Get(2));
+		}
+		//Parallel tangent planes - fall back to a line search down the gradient
+		else {
+			for (k=0; k<4; k++) step[k] = -sign[k] * (d[k][0] * r[0] + d[k][1] * r[1] + d[k][2] * r[2]);
+			for (i=0; i<3; i++) jg[i] = d[0][i] * step[0] + d[1][i] * step[1] - d[2][i] * step[2] - d[3][i] * step[3];
+			alpha = jg[0] * jg[0] + jg[1] * jg[1] + jg[2] * jg[2];
+			if (alpha <= 0.0) break;
+			alpha = -(jg[0] * r[0] + jg[1] * r[1] + jg[2] * r[2]) / alpha;
+			for (k=0; k<4; k++) step[k] *= alpha;
+		}
+		//Halve the step until the gap closes
+		for (half=0; half<SCI_MAX_HALVINGS; half++) {
+			for (k=0; k<4; k++) nx[k] = STDMAX(0.0, STDMIN(1.0, x[k] + step[k]));
+			_SCIPatchPoint(pU1, pV1, patch1, nx[0], nx[1], n1, nd[0], nd[1]);
+			_SCIPatchPoint(pU2, pV2, patch2, nx[2], nx[3], n2, nd[2], nd[3]);
+			nextDist = sqrt((n1[0] - n2[0]) * (n1[0] - n2[0]) + (n1[1] - n2[1]) * (n1[1] - n2[1]) + (n1[2] - n2[2]) * (n1[2] - n2[2]));
+			if (nextDist <= dist) break;
+			for (k=0; k<4; k++) step[k] *= 0.5;
+		}
+		if (half == SCI_MAX_HALVINGS) break;
+		for (k=0, moved=0.0; k<4; k++) {
+			moved += fabs(nx[k] - x[k]);
+			x[k] = nx[k];
+		}
+		dist = nextDist;
+		for (i=0; i<3; i++) {
+			s1[i] = n1[i];
+			s2[i] = n2[i];
+			r[i] = s1[i] - s2[i];
+			for (k=0; k<4; k++) d[k][i] = nd[k][i];
+		}
+		if (moved < SCI_EPSILON) break;
+	}
+	for (i=0; i<3; i++) point[i] = 0.5 * (s1[i] + s2[i]);
+	return dist;
+}
+
+
+//Seeds for a run of patch pairs - u1,v1,u2,v2 in surface parameters, the point, and the gap
+struct _SSISeedJob {
+	const WCBezierHierarchy						*left, *right;
+	const std::pair<WPUInt,WPUInt>				*pairs;
+	WPUInt										count;
+	WPFloat										*seeds;
+};
+
+
+static void _SSISeedTask(void *data, const WPUInt &index) {
+	_SSISeedJob *job = (_SSISeedJob*)data;
+	WPUInt last = STDMIN(job->count, (index + 1) * SSI_SEED_BLOCK);
+	for (WPUInt i=index*SSI_SEED_BLOCK; i<last; i++) {
+		const WSBezierPiece &a = job->left->Piece(job->pairs[i].first);
+		const WSBezierPiece &b = job->right->Piece(job->pairs[i].second);
+		WPFloat *seed = job->seeds + i * SSI_SEED_SIZE;
+		//Start from the patch centres
+		seed[0] = seed[1] = seed[2] = seed[3] = 0.5;
+		seed[7] = _SSIRefinePatches(job->left->DegreeU(), job->left->DegreeV(), job->left->PiecePoints(job->pairs[i].first),
+			job->right->DegreeU(), job->right->DegreeV(), job->right->PiecePoints(job->pairs[i].second), seed, seed + 4);
+		seed[0] = a.uMin + seed[0] * (a.uMax - a.uMin);
+		seed[1] = a.vMin + seed[1] * (a.vMax - a.vMin);
+		seed[2] = b.uMin + seed[2] * (b.uMax - b.uMin);
+		seed[3] = b.vMin + seed[3] * (b.vMax - b.vMin);
+	}
+}
+
+
+//One surface of the pair as seen by the marcher
+struct _SSISide {
+	WCNurbsSurface								*surface;
+	WPFloat										uMin, uMax, vMin, vMax;
+	const std::vector< std::vector<WPFloat> >	*loops;
+};
+
+
+static void _SSIEvaluate(const _SSISide &side, const WPFloat &u, const WPFloat &v, WPFloat *p, WPFloat *su, WPFloat *sv) {
+	WCVector4 du, dv;
+	WCVector4 point = side.surface->EvaluatePartials(u, v, du, dv);
+	p[0] = point.I();	p[1] = point.J();	p[2] = point.K();
+	su[0] = du.I();		su[1] = du.J();		su[2] = du.K();
+	sv[0] = dv.I();		sv[1] = dv.J();		sv[2] = dv.K();
+}
+
+
+static bool _SSIInside(const _SSISide &side, const WPFloat &u, const WPFloat &v) {
+	return (side.loops == NULL) || WCNurbsSurface::InsideLoops(*side.loops, u, v);
+}
+
+
+//Clamp u1,v1,u2,v2 to both domains - returns bit 1 or 2 for each surface whose edge was reached
+static WPUInt _SSIClamp(const _SSISide *sides, WPFloat *x) {
+	WPUInt edges = 0;
+	if ((x[0] <= sides[0].uMin) || (x[0] >= sides[0].uMax) || (x[1] <= sides[0].vMin) || (x[1] >= sides[0].vMax)) edges |= 1;
+	if ((x[2] <= sides[1].uMin) || (x[2] >= sides[1].uMax) || (x[3] <= sides[1].vMin) || (x[3] >= sides[1].vMax)) edges |= 2;
+	x[0] = STDMAX(sides[0].uMin, STDMIN(sides[0].uMax, x[0]));
+	x[1] = STDMAX(sides[0].vMin, STDMIN(sides[0].vMax, x[1]));
+	x[2] = STDMAX(sides[1].uMin, STDMIN(sides[1].uMax, x[2]));
+	x[3] = STDMAX(sides[1].vMin, STDMIN(sides[1].vMax, x[3]));
+	return edges;
+}
+
+
+//Unit direction of the intersection (N1 x N2) - false where the surfaces are tangent
+static bool _SSITangent(const WPFloat *su1, const WPFloat *sv1, const WPFloat *su2, const WPFloat *sv2, WPFloat *t) {
+	WPFloat n1[3] = { su1[1] * sv1[2] - su1[2] * sv1[1], su1[2] * sv1[0] - su1[0] * sv1[2], su1[0] * sv1[1] - su1[1] * sv1[0] };
+	WPFloat n2[3] = { su2[1] * sv2[2] - su2[2] * sv2[1], su2[2] * sv2[0] - su2[0] * sv2[2], su2[0] * sv2[1] - su2[1] * sv2[0] };
+	t[0] = n1[1] * n2[2] - n1[2] * n2[1];
+	t[1] = n1[2] * n2[0] - n1[0] * n2[2];
+	t[2] = n1[0] * n2[1] - n1[1] * n2[0];
+	WPFloat mag = sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+	WPFloat scale = sqrt((n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]) * (n2[0] * n2[0] + n2[1] * n2[1] + n2[2] * n2[2]));
+	if (mag <= SSI_TANGENT_EPSILON * scale) return false;
+	t[0] /= mag;
+	t[1] /= mag;
+	t[2] /= mag;
+	return true;
+}
+
+
+//Parameter step along a surface that best moves it by delta (least squares in the tangent plane)
+static void _SSIParamStep(const WPFloat *su, const WPFloat *sv, const WPFloat *delta, WPFloat &du, WPFloat &dv) {
+	WPFloat a11 = su[0] * su[0] + su[1] * su[1] + su[2] * su[2];
+	WPFloat a12 = su[0] * sv[0] + su[1] * sv[1] + su[2] * sv[2];
+	WPFloat a22 = sv[0] * sv[0] + sv[1] * sv[1] + sv[2] * sv[2];
+	WPFloat b1 = su[0] * delta[0] + su[1] * delta[1] + su[2] * delta[2];
+	WPFloat b2 = sv[0] * delta[0] + sv[1] * delta[1] + sv[2] * delta[2];
+	WPFloat det = a11 * a22 - a12 * a12;
+	if (det <= SCI_EPSILON * a11 * a22) {
+		du = (a11 > 0.0) ? b1 / a11 : 0.0;
+		dv = (a22 > 0.0) ? b2 / a22 : 0.0;
+	}
+	else {
+		du = (b1 * a22 - b2 * a12) / det;
+		dv = (a11 * b2 - a12 * b1) / det;
+	}
+}
+
+
+//Newton back onto both surfaces within the plane through pred normal to dir - returns the gap, sets the edge bits it stopped on
+static WPFloat _SSICorrect(const _SSISide *sides, WPFloat *x, const WPFloat *pred, const WPFloat *dir, const WPFloat &tol,
+	WPFloat *point, WPFloat *d, WPUInt &edges) {
+	WPFloat s1[3], s2[3], dist = 0.0;
+	WCMatrixN<4,4> m;
+	WCVectorN<4> b, step;
+	WPUInt iter, i;
+	for (iter=0; iter<=SSI_CORRECTOR_ITERATIONS; iter++) {
+		_SSIEvaluate(sides[0], x[0], x[1], s1, d, d + 3);
+		_SSIEvaluate(sides[1], x[2], x[3], s2, d + 6, d + 9);
+		for (i=0; i<3; i++) point[i] = 0.5 * (s1[i] + s2[i]);
+		dist = sqrt((s1[0] - s2[0]) * (s1[0] - s2[0]) + (s1[1] - s2[1]) * (s1[1] - s2[1]) + (s1[2] - s2[2]) * (s1[2] - s2[2]));
+		if ((dist <= SSI_CONVERGE_FACTOR * tol) || (iter == SSI_CORRECTOR_ITERATIONS)) break;
+		//Three rows keep the surfaces together, the fourth holds the point in the plane
+		for (i=0; i<3; i++) {
+			m.Set(i, 0, d[i]);
+			m.Set(i, 1, d[3+i]);
+			m.Set(i, 2, -d[6+i]);
+			m.Set(i, 3, -d[9+i]);
+			b.Set(i, s2[i] - s1[i]);
+		}
+		m.Set(3, 0, dir[0] * d[0] + dir[1] * d[1] + dir[2] * d[2]);
+		m.Set(3, 1, dir[0] * d[3] + dir[1] * d[4] + dir[2] * d[5]);
+		m.Set(3, 2, 0.0);
+		m.Set(3, 3, 0.0);
+		b.Set(3, -(dir[0] * (s1[0] - pred[0]) + dir[1] * (s1[1] - pred[1]) + dir[2] * (s1[2] - pred[2])));
+		if (!m.Solve(b, step, SCI_EPSILON)) break;
+		for (i=0; i<4; i++) x[i] += step.Get(i);
+		//Keep to both domains, noting where the point was pushed back
+		if (_SSIClamp(sides, x) != 0) break;
+	}
+	//A point pushed back onto an edge has to be settled there
+	edges = _SSIClamp(sides, x);
+	if (edges != 0) {
+		_SSIEvaluate(sides[0], x[0], x[1], s1, d, d + 3);
+		_SSIEvaluate(sides[1], x[2], x[3], s2, d + 6, d + 9);
+		WPFloat delta[3], du, dv;
+		for (iter=0; iter<SSI_CORRECTOR_ITERATIONS; iter++) {
+			for (i=0; i<3; i++) delta[i] = 0.5 * (s2[i] - s1[i]);
+			dist = 2.0 * sqrt(delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2]);
+			if (dist <= SSI_CONVERGE_FACTOR * tol) break;
+			//Each surface moves half way, clamped to its domain
+			_SSIParamStep(d, d + 3, delta, du, dv);
+			x[0] = STDMAX(sides[0].uMin, STDMIN(sides[0].uMax, x[0] + du));
+			x[1] = STDMAX(sides[0].vMin, STDMIN(sides[0].vMax, x[1] + dv));
+			for (i=0; i<3; i++) delta[i] = -delta[i];
+			_SSIParamStep(d + 6, d + 9, delta, du, dv);
+			x[2] = STDMAX(sides[1].uMin, STDMIN(sides[1].uMax, x[2] + du));
+			x[3] = STDMAX(sides[1].vMin, STDMIN(sides[1].vMax, x[3] + dv));
+			_SSIEvaluate(sides[0], x[0], x[1], s1, d, d + 3);
+			_SSIEvaluate(sides[1], x[2], x[3], s2, d + 6, d + 9);
+		}
+		for (i=0; i<3; i++) point[i] = 0.5 * (s1[i] + s2[i]);
+		dist = sqrt((s1[0] - s2[0]) * (s1[0] - s2[0]) + (s1[1] - s2[1]) * (s1[1] - s2[1]) + (s1[2] - s2[2]) * (s1[2] - s2[2]));
+	}
+	return dist;
+}
+
+
+//March one way from a seed - appends u1,v1,u2,v2,x,y,z records, returns true if the branch closed on its start
+static bool _SSIMarch(const _SSISide *sides, const WPFloat *seed, const WPFloat &sign, const WPFloat &hMax, const WPFloat &tol,
+	std::vector<WPFloat> &trace, WPUInt &edges) {
+	WPFloat x[4], nx[4], p[3], np[3], d[12], nd[12], t[3], nt[3], pred[3], delta[3], du, dv, h = hMax, cosine, gap;
+	WPFloat cosMax = cos(SSI_MAX_ANGLE * M_PI / 180.0), cosGrow = cos(0.5 * SSI_MAX_ANGLE * M_PI / 180.0), hMin = STDMAX(tol, hMax * SSI_MIN_STEP);
+	WPUInt i, hitEdges = 0;
+	for (i=0; i<4; i++) x[i] = seed[i];
+	_SSIEvaluate(sides[0], x[0], x[1], p, d, d + 3);
+	_SSIEvaluate(sides[1], x[2], x[3], np, d + 6, d + 9);
+	edges = 0;
+	if (!_SSITangent(d, d + 3, d + 6, d + 9, t)) return false;
+	for (i=0; i<3; i++) {
+		t[i] *= sign;
+		p[i] = seed[4+i];
+	}
+	WPUInt count = 0;
+	while (count < SSI_MAX_POINTS) {
+		//Predict along the tangent, then correct in the plane normal to it
+		for (i=0; i<3; i++) {
+			delta[i] = h * t[i];
+			pred[i] = p[i] + delta[i];
+		}
+		_SSIParamStep(d, d + 3, delta, du, dv);
+		nx[0] = x[0] + du;
+		nx[1] = x[1] + dv;
+		_SSIParamStep(d + 6, d + 9, delta, du, dv);
+		nx[2] = x[2] + du;
+		nx[3] = x[3] + dv;
+		_SSIClamp(sides, nx);
+		gap = _SSICorrect(sides, nx, pred, t, tol, np, nd, hitEdges);
+		//Reject steps that fail, turn too sharply, jump too far, or leave the trims
+		bool accept = (gap <= tol) && _SSITangent(nd, nd + 3, nd + 6, nd + 9, nt);
+		if (accept) {
+			cosine = nt[0] * t[0] + nt[1] * t[1] + nt[2] * t[2];
+			if (cosine < 0.0) {
+				for (i=0; i<3; i++) nt[i] = -nt[i];
+				cosine = -cosine;
+			}
+			WPFloat jump = sqrt((np[0] - p[0]) * (np[0] - p[0]) + (np[1] - p[1]) * (np[1] - p[1]) + (np[2] - p[2]) * (np[2] - p[2]));
+			accept = ((cosine >= cosMax) || (h <= hMin)) && (jump <= 2.0 * h + tol) && (jump > 0.1 * tol);
+			if (!_SSIInside(sides[0], nx[0], nx[1])) {
+				accept = false;
+				hitEdges |= 1;
+			}
+			if (!_SSIInside(sides[1], nx[2], nx[3])) {
+				accept = false;
+				hitEdges |= 2;
 			}
 		}
+		if (!accept) {
+			//Stop once the step cannot shrink any further
+			if (h <= hMin) {
+				edges = hitEdges;
+				return false;
+			}
+			h = STDMAX(hMin, 0.5 * h);
+			continue;
+		}
+		for (i=0; i<4; i++) {
+			x[i] = nx[i];
+			trace.push_back(x[i]);
+		}
+		for (i=0; i<3; i++) {
+			p[i] = np[i];
+			t[i] = nt[i];
+			trace.push_back(p[i]);
+		}
+		for (i=0; i<12; i++) d[i] = nd[i];
+		count++;
+		//Stop on a domain edge
+		if (hitEdges != 0) {
+			edges = hitEdges;
+			return false;
+		}
+		//Closed loops come back to the seed
+		if ((count > 2) && (sqrt((p[0] - seed[4]) * (p[0] - seed[4]) + (p[1] - seed[5]) * (p[1] - seed[5]) +
+			(p[2] - seed[6]) * (p[2] - seed[6])) < h)) return true;
+		if (cosine >= cosGrow) h = STDMIN(hMax, 1.5 * h);
 	}
+	CLOGGER_WARN(WCLogManager::RootLogger(), "_SSIMarch - Reached the point limit.");
+	return false;
+}
 
-	//Release the surface buffers
-	left->ReleaseBuffers(buffers);
-	//Return the results
-	return results;
+
+//Distance from a point to the polyline of a trace (7 values per record)
+static WPFloat _SSITraceDistance(const std::vector<WPFloat> &trace, const WPFloat *point) {
+	WPFloat best = -1.0, seg[3], rel[3], len, s, dist;
+	WPUInt count = (WPUInt)trace.size() / 7, i, k;
+	for (i=0; i<count; i++) {
+		const WPFloat *a = &trace[i*7+4];
+		const WPFloat *b = (i+1 < count) ? &trace[(i+1)*7+4] : a;
+		for (k=0, len=0.0, s=0.0; k<3; k++) {
+			seg[k] = b[k] - a[k];
+			rel[k] = point[k] - a[k];
+			len += seg[k] * seg[k];
+			s += seg[k] * rel[k];
+		}
+		s = (len > 0.0) ? STDMAX(0.0, STDMIN(1.0, s / len)) : 0.0;
+		for (k=0, dist=0.0; k<3; k++) dist += (rel[k] - s * seg[k]) * (rel[k] - s * seg[k]);
+		dist = sqrt(dist);
+		if ((best < 0.0) || (dist < best)) best = dist;
+	}
+	return best;
+}
+
+
+/*** SurfaceSurfaceIntersection ***
+ * CPU intersection of two NURBS surfaces.  The patch hierarchies are walked together and every close pair of patches is refined
+ *	(in parallel) to a seed point on both surfaces.  From each seed not already on a traced curve the intersection is marched both
+ *	ways with a predictor along N1 x N2 and a Newton corrector in the plane normal to it.  The step grows on straight runs and is
+ *	halved where the curve turns, the corrector fails, or the march leaves either domain or its trim loops (if given).  Each
+ *	branch becomes an IntersectCurve with leftParam and rightParam holding the start and end u,v pairs; the boundary flags mark
+ *	curves that end on that surface's edge or trim.  Seeds where the surfaces only touch become IntersectPoint results.
+ ***/
+WPUInt __WILDCAT_NAMESPACE__::SurfaceSurfaceIntersection(WCNurbsSurface *left, WCNurbsSurface *right, const WPFloat &tol,
+	const unsigned int &flags, std::vector<WCIntersectionResult> &results,
+	const std::vector< std::vector<WPFloat> > *leftLoops, const std::vector< std::vector<WPFloat> > *rightLoops) {
+	//Check if self intersection
+	if ((left == NULL) || (right == NULL) || (left == right)) return 0;
+	const WCBezierHierarchy *leftTree = left->Hierarchy();
+	const WCBezierHierarchy *rightTree = right->Hierarchy();
+	if ((leftTree == NULL) || (rightTree == NULL) || (leftTree->NumberNodes() == 0) || (rightTree->NumberNodes() == 0)) return 0;
+	std::vector< std::pair<WPUInt,WPUInt> > pairs;
+	leftTree->Overlaps(*rightTree, tol, pairs);
+	if (pairs.empty()) return 0;
+
+	/*** Seed every patch pair ***/
+
+	std::vector<WPFloat> seeds(pairs.size() * SSI_SEED_SIZE);
+	_SSISeedJob job = { leftTree, rightTree, &pairs[0], (WPUInt)pairs.size(), &seeds[0] };
+	WPUInt blocks = (job.count + SSI_SEED_BLOCK - 1) / SSI_SEED_BLOCK, i, k;
+	if (blocks == 1) _SSISeedTask(&job, 0);
+	else WCThreadPool::Shared()->ParallelFor(blocks, _SSISeedTask, &job);
+
+	/*** March from each seed not yet covered ***/
+
+	_SSISide sides[2];
+	sides[0].surface = left;
+	sides[0].uMin = left->KnotPointsU()[0];
+	sides[0].uMax = left->KnotPointsU()[left->NumberKnotPointsU()-1];
+	sides[0].vMin = left->KnotPointsV()[0];
+	sides[0].vMax = left->KnotPointsV()[left->NumberKnotPointsV()-1];
+	sides[0].loops = leftLoops;
+	sides[1].surface = right;
+	sides[1].uMin = right->KnotPointsU()[0];
+	sides[1].uMax = right->KnotPointsU()[right->NumberKnotPointsU()-1];
+	sides[1].vMin = right->KnotPointsV()[0];
+	sides[1].vMax = right->KnotPointsV()[right->NumberKnotPointsV()-1];
+	sides[1].loops = rightLoops;
+	//Steps are a fraction of the smaller surface
+	const WSBezierNode &leftRoot = leftTree->Node(0), &rightRoot = rightTree->Node(0);
+	WPFloat leftSize = sqrt((leftRoot.hi[0] - leftRoot.lo[0]) * (leftRoot.hi[0] - leftRoot.lo[0]) +
+		(leftRoot.hi[1] - leftRoot.lo[1]) * (leftRoot.hi[1] - leftRoot.lo[1]) + (leftRoot.hi[2] - leftRoot.lo[2]) * (leftRoot.hi[2] - leftRoot.lo[2]));
+	WPFloat rightSize = sqrt((rightRoot.hi[0] - rightRoot.lo[0]) * (rightRoot.hi[0] - rightRoot.lo[0]) +
+		(rightRoot.hi[1] - rightRoot.lo[1]) * (rightRoot.hi[1] - rightRoot.lo[1]) + (rightRoot.hi[2] - rightRoot.lo[2]) * (rightRoot.hi[2] - rightRoot.lo[2]));
+	WPFloat hMax = STDMAX(tol, SSI_STEP_FRACTION * STDMIN(leftSize, rightSize));
+	WPFloat cover = SSI_COVER_FACTOR * hMax + tol, d[12], p[3], t[3];
+	std::vector< std::vector<WPFloat> > traces;
+	std::vector<WPFloat> forward, backward, touches;
+	WPUInt count = 0, startEdges, endEdges;
+	WCIntersectionResult result;
+	for (i=0; i<pairs.size(); i++) {
+		WPFloat *seed = &seeds[i * SSI_SEED_SIZE];
+		if (seed[7] > tol) continue;
+		if (!_SSIInside(sides[0], seed[0], seed[1]) || !_SSIInside(sides[1], seed[2], seed[3])) continue;
+		//Skip seeds already on a traced curve or a touching point
+		for (k=0; k<traces.size(); k++) if (_SSITraceDistance(traces[k], seed + 4) <= cover) break;
+		if (k < traces.size()) continue;
+		for (k=0; k<touches.size(); k+=3)
+			if (fabs(touches[k] - seed[4]) + fabs(touches[k+1] - seed[5]) + fabs(touches[k+2] - seed[6]) <= cover) break;
+		if (k < touches.size()) continue;
+		//Surfaces that only touch give a point
+		_SSIEvaluate(sides[0], seed[0], seed[1], p, d, d + 3);
+		_SSIEvaluate(sides[1], seed[2], seed[3], p, d + 6, d + 9);
+		if (!_SSITangent(d, d + 3, d + 6, d + 9, t)) {
+			touches.insert(touches.end(), seed + 4, seed + 7);
+			WCVector4 point(seed[4], seed[5], seed[6], 1.0);
+			result.type = IntersectPoint;
+			result.leftParam = WCVector4(seed[0], seed[1], 0.0, 0.0);
+			result.rightParam = WCVector4(seed[2], seed[3], 0.0, 0.0);
+			result.leftBoundary = (seed[0] <= sides[0].uMin) || (seed[0] >= sides[0].uMax) || (seed[1] <= sides[0].vMin) || (seed[1] >= sides[0].vMax);
+			result.rightBoundary = (seed[2] <= sides[1].uMin) || (seed[2] >= sides[1].uMax) || (seed[3] <= sides[1].vMin) || (seed[3] >= sides[1].vMax);
+			result.object = NULL;
+			//Must check flags for CULL_BOUNDARY case and only add hit as appropriate
+			if ((flags & INTERSECT_CULL_BOUNDARY) && (result.leftBoundary || result.rightBoundary)) continue;
+			if (flags & INTERSECT_GEN_POINTS) result.object = new WCGeometricPoint(point);
+			results.push_back(result);
+			count++;
+			continue;
+		}
+		//Trace both ways from the seed, unless the first way closes on itself
+		forward.clear();
+		backward.clear();
+		bool closed = _SSIMarch(sides, seed, 1.0, hMax, tol, forward, endEdges);
+		startEdges = 0;
+		if (!closed) _SSIMarch(sides, seed, -1.0, hMax, tol, backward, startEdges);
+		std::vector<WPFloat> trace;
+		for (k=backward.size()/7; k-->0; ) trace.insert(trace.end(), backward.begin() + k*7, backward.begin() + (k+1)*7);
+		trace.insert(trace.end(), seed, seed + 7);
+		trace.insert(trace.end(), forward.begin(), forward.end());
+		if (closed) trace.insert(trace.end(), seed, seed + 7);
+		traces.push_back(trace);
+		WPUInt last = (WPUInt)trace.size() / 7 - 1;
+		if (last == 0) continue;
+		result.type = IntersectCurve;
+		result.leftParam = WCVector4(trace[0], trace[1], trace[last*7], trace[last*7+1]);
+		result.rightParam = WCVector4(trace[2], trace[3], trace[last*7+2], trace[last*7+3]);
+		result.leftBoundary = ((startEdges | endEdges) & 1) != 0;
+		result.rightBoundary = ((startEdges | endEdges) & 2) != 0;
+		result.object = NULL;
+		if (flags & INTERSECT_GEN_CURVES) {
+			std::vector<WCVector4> points;
+			for (k=0; k<=last; k++) points.push_back( WCVector4(trace[k*7+4], trace[k*7+5], trace[k*7+6], 1.0) );
+			result.object = WCNurbsCurve::GlobalInterpolation(left->Context(), points, SSI_CURVE_DEGREE);
+		}
+		results.push_back(result);
+		count++;
+	}
+	//Return the number of results added
+	return count;
 }
 
 
+/***********************************************~***************************************************/
+
+
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCNurbsSurface *left,
 	WCGeometricLine *right, const WPFloat &tol, const unsigned int &flags) {
-	std::list<WCIntersectionResult> results;
-	//See if line intersects surface bounding box
-	if (left->BoundingBox().Intersection(right->BoundingBox())) return results;
-	
-	//Determine estimated area of surface and LODs
-	WPUInt lodU = STDMIN((WPUInt)(WCNurbs::EstimateLengthU(left->ControlPoints(), left->NumberControlPointsU()) / tol), (WPUInt)WCAdapter::GetMax2DTextureSize());
-	WPUInt lodV = STDMIN((WPUInt)(WCNurbs::EstimateLengthV(left->ControlPoints(), left->NumberControlPointsV()) / tol), (WPUInt)WCAdapter::GetMax2DTextureSize());
-	//Generate surface to precision of tol and place into local buffer
-	std::vector<GLuint> textures;
-	left->GenerateTextureBuffers(0.0, 1.0, lodU, 0.0, 1.0, lodV, textures, true);
-	GLuint vertexTex = textures.at(NURBSSURFACE_VERTEX_BUFFER);
-	GLuint indexTex = textures.at(NURBSSURFACE_INDEX_BUFFER);
-	if (vertexTex == indexTex) { }
-	//Set program values
-	glUseProgram(left->Context()->SurfaceLineProgram());
-	glUniform3f(left->Context()->IntersectionLocations()[INTERSECTION_SLI_PARAMS], (GLfloat)lodU, (GLfloat)lodV, (GLfloat)tol);
-	glUniform4f(left->Context()->IntersectionLocations()[INTERSECTION_SLI_LBEGIN], 
-				(GLfloat)right->Begin().I(), (GLfloat)right->Begin().J(), (GLfloat)right->Begin().K(), 1.0);
-	glUniform4f(left->Context()->IntersectionLocations()[INTERSECTION_SLI_LEND],
-				(GLfloat)right->End().I(), (GLfloat)right->End().J(), (GLfloat)right->End().K(), 1.0);
-
-	//Try to intersect line with each triangle within buffer
-	//...
-	left->ReleaseTextures(textures);
-	return results;
+	std::vector<WCIntersectionResult> hits;
+	SurfaceLineIntersection(left, right, tol, flags, hits);
+	return std::list<WCIntersectionResult>(hits.begin(), hits.end());
 }
 
 
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCNurbsSurface *left,
 	WCNurbsCurve *right, const WPFloat &tol, const unsigned int &flags) {
-	std::list<WCIntersectionResult> results;
-	//See if curve bounding box intersects surface bounding box
-	if (left->BoundingBox().Intersection(right->BoundingBox())) return results;
-	
-	//Otherwise, generate surface to precision of tol and place into local buffer
-	//...
-
-	//Generate curve to precision of tol and place into local buffer
-	//...
-	
-	//Try to intersect all sections of curve in buffer with each triangle in buffer
-	//...
-	
-	return results;
+	std::vector<WCIntersectionResult> hits;
+	SurfaceCurveIntersection(left, right, tol, flags, hits);
+	return std::list<WCIntersectionResult>(hits.begin(), hits.end());
 }
 
 
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCNurbsSurface *left,
 	WCNurbsSurface *right, const WPFloat &tol, const unsigned int &flags) {
-	std::list<WCIntersectionResult> results;
-	//See if left bounding box intersects right bounding box
-	if (left->BoundingBox().Intersection(right->BoundingBox())) return results;
-	
-	//Otherwise, generate left and right to precision of tol and place into local buffers
-	//...
-	
-	//Try to intersect all triangles of left with each triangle in right
-	//...
-	
-	return results;
+	std::vector<WCIntersectionResult> hits;
+	SurfaceSurfaceIntersection(left, right, tol, flags, hits);
+	return std::list<WCIntersectionResult>(hits.begin(), hits.end());
 }
 
 
@@ -38,81 +38,70 @@
 /***********************************************~***************************************************/
 
 
+//Keep the point hits that lie inside the trims, making their points only once they survive
+static std::list<WCIntersectionResult> _TrimSurfaceFilter(WCTrimmedNurbsSurface *surface, const std::vector< std::vector<WPFloat> > &loops,
+	std::vector<WCIntersectionResult> &hits, const unsigned int &flags) {
+	std::list<WCIntersectionResult> results;
+	for (WPUInt i=0; i<hits.size(); i++) {
+		if (!loops.empty() && !WCNurbsSurface::InsideLoops(loops, hits[i].leftParam.I(), hits[i].leftParam.J())) continue;
+		if (flags & INTERSECT_GEN_POINTS)
+			hits[i].object = new WCGeometricPoint(surface->Evaluate(hits[i].leftParam.I(), hits[i].leftParam.J()));
+		results.push_back(hits[i]);
+	}
+	return results;
+}
+
+
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCTrimmedNurbsSurface *left,
 	WCGeometricPoint *right, const WPFloat &tol, const unsigned int &flags) {
-	//See if point is within surface bounding box
-	//...
-	
-	//Otherwise, generate surface to precision of tol and place into local buffer
-	//...
-	
-	//Compare point against each triangle within buffer
-	//...
-	
-	return std::list<WCIntersectionResult>();
+	//Intersect with the untrimmed surface, then keep what lies inside the trims
+	std::list<WCIntersectionResult> list = GeometricIntersection((WCNurbsSurface*)left, right, tol, flags & ~INTERSECT_GEN_POINTS);
+	std::vector<WCIntersectionResult> hits(list.begin(), list.end());
+	std::vector< std::vector<WPFloat> > loops;
+	left->TrimLoops(STDMAX(tol, NURBSSURFACE_HIERARCHY_ACCURACY), loops);
+	return _TrimSurfaceFilter(left, loops, hits, flags);
 }
 
 
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCTrimmedNurbsSurface *left,
 	WCGeometricLine *right, const WPFloat &tol, const unsigned int &flags) {
-	//See if line intersects surface bounding box
-	//...
-	
-	//Otherwise, generate surface to precision of tol and place into local buffer
-	//...
-	
-	//Try to intersect line with each triangle within buffer
-	//...
-	
-	return std::list<WCIntersectionResult>();
+	std::vector<WCIntersectionResult> hits;
+	SurfaceLineIntersection(left, right, tol, flags & ~INTERSECT_GEN_POINTS, hits);
+	std::vector< std::vector<WPFloat> > loops;
+	left->TrimLoops(STDMAX(tol, NURBSSURFACE_HIERARCHY_ACCURACY), loops);
+	return _TrimSurfaceFilter(left, loops, hits, flags);
 }
 
 
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCTrimmedNurbsSurface *left,
 	WCNurbsCurve *right, const WPFloat &tol, const unsigned int &flags) {
-	//See if curve bounding box intersects surface bounding box
-	//...
-	
-	//Otherwise, generate surface to precision of tol and place into local buffer
-	//...
-	
-	//Generate curve to precision of tol and place into local buffer
-	//...
-	
-	//Try to intersect all sections of curve in buffer with each triangle in buffer
-	//...
-	
-	return std::list<WCIntersectionResult>();
+	std::vector<WCIntersectionResult> hits;
+	SurfaceCurveIntersection(left, right, tol, flags & ~INTERSECT_GEN_POINTS, hits);
+	std::vector< std::vector<WPFloat> > loops;
+	left->TrimLoops(STDMAX(tol, NURBSSURFACE_HIERARCHY_ACCURACY), loops);
+	return _TrimSurfaceFilter(left, loops, hits, flags);
 }
 
 
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCTrimmedNurbsSurface *left,
 	WCNurbsSurface *right, const WPFloat &tol, const unsigned int &flags) {
-	//See if left bounding box intersects right bounding box
-	//...
-	
-	//Otherwise, generate left and right to precision of tol and place into local buffers
-	//...
-	
-	//Try to intersect all triangles of left with each triangle in right
-	//...
-	
-	return std::list<WCIntersectionResult>();
+	//The marcher stops at the trims itself
+	std::vector< std::vector<WPFloat> > loops;
+	left->TrimLoops(STDMAX(tol, NURBSSURFACE_HIERARCHY_ACCURACY), loops);
+	std::vector<WCIntersectionResult> hits;
+	SurfaceSurfaceIntersection(left, right, tol, flags, hits, loops.empty() ? NULL : &loops, NULL);
+	return std::list<WCIntersectionResult>(hits.begin(), hits.end());
 }
 
 
 std::list<WCIntersectionResult> __WILDCAT_NAMESPACE__::GeometricIntersection(WCTrimmedNurbsSurface *left,
 	WCTrimmedNurbsSurface *right, const WPFloat &tol, const unsigned int &flags) {
-	//See if left bounding box intersects right bounding box
-	//...
-	
-	//Otherwise, generate left and right to precision of tol and place into local buffers
-	//...
-	
-	//Try to intersect all triangles of left with each triangle in right
-	//...
-	
-	return std::list<WCIntersectionResult>();
+	std::vector< std::vector<WPFloat> > leftLoops, rightLoops;
+	left->TrimLoops(STDMAX(tol, NURBSSURFACE_HIERARCHY_ACCURACY), leftLoops);
+	right->TrimLoops(STDMAX(tol, NURBSSURFACE_HIERARCHY_ACCURACY), rightLoops);
+	std::vector<WCIntersectionResult> hits;
+	SurfaceSurfaceIntersection(left, right, tol, flags, hits, leftLoops.empty() ? NULL : &leftLoops, rightLoops.empty() ? NULL : &rightLoops);
+	return std::list<WCIntersectionResult>(hits.begin(), hits.end());
 }
 
 
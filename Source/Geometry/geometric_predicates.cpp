@@ -0,0 +1,205 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+
+/*** Included Header Files ***/
+#include <Geometry/geometric_predicates.h>
+
+
+/*** Locally Defined Values ***/
+//Dekker splitter for doubles (2^27 + 1) - the error-free transforms rely on IEEE rounding, so no fast-math or FMA contraction
+#define PREDICATES_SPLITTER						134217729.0
+
+
+//Keep the compiler from fusing a * b + c here, whatever the project flags say (fast-math must still stay off for this file)
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 6)))
+#pragma GCC optimize ("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract (off)
+#endif
+
+
+/***********************************************~***************************************************/
+
+
+//Expansions hold non-overlapping components in increasing magnitude with zeros removed; their sum is the exact value
+
+
+static inline void _PredicatesTwoSum(const WPFloat &a, const WPFloat &b, WPFloat &x, WPFloat &y) {
+	x = a + b;
+	WPFloat bVirtual = x - a, aVirtual = x - bVirtual;
+	y = (a - aVirtual) + (b - bVirtual);
+}
+
+
+static inline void _PredicatesSplit(const WPFloat &a, WPFloat &high, WPFloat &low) {
+	WPFloat c = PREDICATES_SPLITTER * a, big = c - a;
+	high = c - big;
+	low = a - high;
+}
+
+
+static inline void _PredicatesTwoProduct(const WPFloat &a, const WPFloat &b, WPFloat &x, WPFloat &y) {
+	x = a * b;
+	WPFloat aHigh, aLow, bHigh, bLow;
+	_PredicatesSplit(a, aHigh, aLow);
+	_PredicatesSplit(b, bHigh, bLow);
+	WPFloat err = x - aHigh * bHigh;
+	err -= aLow * bHigh;
+	err -= aHigh * bLow;
+	y = aLow * bLow - err;
+}
+
+
+static std::vector<WPFloat> _PredicatesDifference(const WPFloat &a, const WPFloat &b) {
+	//Exact a - b as a two-component expansion
+	std::vector<WPFloat> e;
+	WPFloat x, y;
+	_PredicatesTwoSum(a, -b, x, y);
+	if (y != 0.0) e.push_back(y);
+	if (x != 0.0) e.push_back(x);
+	return e;
+}
+
+
+static void _PredicatesGrow(std::vector<WPFloat> &e, const WPFloat &b) {
+	//Add one value to an expansion in place
+	std::vector<WPFloat> h;
+	WPFloat q = b, sum, err;
+	for (WPUInt i=0; i<e.size(); i++) {
+		_PredicatesTwoSum(q, e[i], sum, err);
+		q = sum;
+		if (err != 0.0) h.push_back(err);
+	}
+	if ((q != 0.0) || h.empty()) h.push_back(q);
+	e.swap(h);
+}
+
+
+static std::vector<WPFloat> _PredicatesSum(const std::vector<WPFloat> &e, const std::vector<WPFloat> &f) {
+	std::vector<WPFloat> h(e);
+	for (WPUInt i=0; i<f.size(); i++) _PredicatesGrow(h, f[i]);
+	return h;
+}
+
+
+static std::vector<WPFloat> _PredicatesScale(const std::vector<WPFloat> &e, const WPFloat &b) {
+	//Multiply an expansion by one value
+	std::vector<WPFloat> h;
+	if (e.empty() || (b == 0.0)) return h;
+	WPFloat q, hh, product1, product0, sum;
+	_PredicatesTwoProduct(e[0], b, q, hh);
+	if (hh != 0.0) h.push_back(hh);
+	for (WPUInt i=1; i<e.size(); i++) {
+		_PredicatesTwoProduct(e[i], b, product1, product0);
+		_PredicatesTwoSum(q, product0, sum, hh);
+		if (hh != 0.0) h.push_back(hh);
+		_PredicatesTwoSum(product1, sum, q, hh);
+		if (hh != 0.0) h.push_back(hh);
+	}
+	if (q != 0.0) h.push_back(q);
+	return h;
+}
+
+
+static std::vector<WPFloat> _PredicatesProduct(const std::vector<WPFloat> &e, const std::vector<WPFloat> &f) {
+	std::vector<WPFloat> h;
+	for (WPUInt i=0; i<f.size(); i++) h = _PredicatesSum(h, _PredicatesScale(e, f[i]));
+	return h;
+}
+
+
+static std::vector<WPFloat> _PredicatesNegate(std::vector<WPFloat> e) {
+	for (WPUInt i=0; i<e.size(); i++) e[i] = -e[i];
+	return e;
+}
+
+
+static WPFloat _PredicatesEstimate(const std::vector<WPFloat> &e) {
+	//Smallest first, so the rounded sum keeps the sign of the largest component
+	WPFloat sum = 0.0;
+	for (WPUInt i=0; i<e.size(); i++) sum += e[i];
+	return sum;
+}
+
+
+static int _PredicatesSign(const WPFloat &value) {
+	return (value > 0.0) ? 1 : ((value < 0.0) ? -1 : 0);
+}
+
+
+/***********************************************~***************************************************/
+
+
+WPFloat __WILDCAT_NAMESPACE__::Orient2DExact(const WPFloat &ax, const WPFloat &ay, const WPFloat &bx, const WPFloat &by,
+	const WPFloat &cx, const WPFloat &cy) {
+	//(a - c) x (b - c) with exact differences and products
+	std::vector<WPFloat> left = _PredicatesProduct(_PredicatesDifference(ax, cx), _PredicatesDifference(by, cy));
+	std::vector<WPFloat> right = _PredicatesProduct(_PredicatesDifference(ay, cy), _PredicatesDifference(bx, cx));
+	return _PredicatesEstimate(_PredicatesSum(left, _PredicatesNegate(right)));
+}
+
+
+WPFloat __WILDCAT_NAMESPACE__::InCircle2DExact(const WPFloat &ax, const WPFloat &ay, const WPFloat &bx, const WPFloat &by,
+	const WPFloat &cx, const WPFloat &cy, const WPFloat &dx, const WPFloat &dy) {
+	std::vector<WPFloat> adx = _PredicatesDifference(ax, dx), ady = _PredicatesDifference(ay, dy);
+	std::vector<WPFloat> bdx = _PredicatesDifference(bx, dx), bdy = _PredicatesDifference(by, dy);
+	std::vector<WPFloat> cdx = _PredicatesDifference(cx, dx), cdy = _PredicatesDifference(cy, dy);
+	//Lifted distances to d and the 2x2 minors they multiply
+	std::vector<WPFloat> aLift = _PredicatesSum(_PredicatesProduct(adx, adx), _PredicatesProduct(ady, ady));
+	std::vector<WPFloat> bLift = _PredicatesSum(_PredicatesProduct(bdx, bdx), _PredicatesProduct(bdy, bdy));
+	std::vector<WPFloat> cLift = _PredicatesSum(_PredicatesProduct(cdx, cdx), _PredicatesProduct(cdy, cdy));
+	std::vector<WPFloat> bc = _PredicatesSum(_PredicatesProduct(bdx, cdy), _PredicatesNegate(_PredicatesProduct(cdx, bdy)));
+	std::vector<WPFloat> ca = _PredicatesSum(_PredicatesProduct(cdx, ady), _PredicatesNegate(_PredicatesProduct(adx, cdy)));
+	std::vector<WPFloat> ab = _PredicatesSum(_PredicatesProduct(adx, bdy), _PredicatesNegate(_PredicatesProduct(bdx, ady)));
+	std::vector<WPFloat> det = _PredicatesSum(_PredicatesProduct(aLift, bc), _PredicatesProduct(bLift, ca));
+	return _PredicatesEstimate(_PredicatesSum(det, _PredicatesProduct(cLift, ab)));
+}
+
+
+bool __WILDCAT_NAMESPACE__::SegmentsIntersect2D(const WPFloat &p1x, const WPFloat &p1y, const WPFloat &q1x, const WPFloat &q1y,
+	const WPFloat &p2x, const WPFloat &p2y, const WPFloat &q2x, const WPFloat &q2y) {
+	int o1 = _PredicatesSign(Orient2D(p1x, p1y, q1x, q1y, p2x, p2y));
+	int o2 = _PredicatesSign(Orient2D(p1x, p1y, q1x, q1y, q2x, q2y));
+	int o3 = _PredicatesSign(Orient2D(p2x, p2y, q2x, q2y, p1x, p1y));
+	int o4 = _PredicatesSign(Orient2D(p2x, p2y, q2x, q2y, q1x, q1y));
+	//Proper crossing
+	if ((o1 != o2) && (o3 != o4)) return true;
+	//Collinear endpoints only count when they fall within the other segment's box
+	if ((o1 == 0) && (p2x >= STDMIN(p1x, q1x)) && (p2x <= STDMAX(p1x, q1x)) && (p2y >= STDMIN(p1y, q1y)) && (p2y <= STDMAX(p1y, q1y))) return true;
+	if ((o2 == 0) && (q2x >= STDMIN(p1x, q1x)) && (q2x <= STDMAX(p1x, q1x)) && (q2y >= STDMIN(p1y, q1y)) && (q2y <= STDMAX(p1y, q1y))) return true;
+	if ((o3 == 0) && (p1x >= STDMIN(p2x, q2x)) && (p1x <= STDMAX(p2x, q2x)) && (p1y >= STDMIN(p2y, q2y)) && (p1y <= STDMAX(p2y, q2y))) return true;
+	if ((o4 == 0) && (q1x >= STDMIN(p2x, q2x)) && (q1x <= STDMAX(p2x, q2x)) && (q1y >= STDMIN(p2y, q2y)) && (q1y <= STDMAX(p2y, q2y))) return true;
+	return false;
+}
+
+
+/***********************************************~***************************************************/
+
@@ -0,0 +1,103 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+#ifndef __GEOMETRIC_PREDICATES_H__
+#define __GEOMETRIC_PREDICATES_H__
+
+
+/*** Included Header Files ***/
+#include <Utility/wutil.h>
+
+
+/*** Locally Defined Values ***/
+#define PREDICATES_EPSILON						1.1102230246251565e-16
+#define PREDICATES_ORIENT_BOUND					((3.0 + 16.0 * PREDICATES_EPSILON) * PREDICATES_EPSILON)
+#define PREDICATES_INCIRCLE_BOUND				((10.0 + 96.0 * PREDICATES_EPSILON) * PREDICATES_EPSILON)
+
+
+/*** Namespace Declaration ***/
+namespace __WILDCAT_NAMESPACE__ {
+
+
+/***********************************************~***************************************************/
+
+
+//Exact fallbacks for the filtered predicates below - only called when the filter cannot decide the sign
+WPFloat Orient2DExact(const WPFloat &ax, const WPFloat &ay, const WPFloat &bx, const WPFloat &by,
+												const WPFloat &cx, const WPFloat &cy);
+WPFloat InCircle2DExact(const WPFloat &ax, const WPFloat &ay, const WPFloat &bx, const WPFloat &by,
+												const WPFloat &cx, const WPFloat &cy, const WPFloat &dx, const WPFloat &dy);
+
+
+//Twice the signed area of a,b,c - positive when counter-clockwise, negative when clockwise, exactly zero when collinear.
+inline WPFloat Orient2D(const WPFloat &ax, const WPFloat &ay, const WPFloat &bx, const WPFloat &by,
+	const WPFloat &cx, const WPFloat &cy) {
+	WPFloat detLeft = (ax - cx) * (by - cy);
+	WPFloat detRight = (ay - cy) * (bx - cx);
+	WPFloat det = detLeft - detRight, detSum;
+	//Opposite signs (or a zero term) cannot cancel
+	if (detLeft > 0.0) {
+		if (detRight <= 0.0) return det;
+		detSum = detLeft + detRight;
+	}
+	else if (detLeft < 0.0) {
+		if (detRight >= 0.0) return det;
+		detSum = -detLeft - detRight;
+	}
+	else return det;
+	WPFloat bound = PREDICATES_ORIENT_BOUND * detSum;
+	if ((det >= bound) || (-det >= bound)) return det;
+	return Orient2DExact(ax, ay, bx, by, cx, cy);
+}
+
+
+//Positive when d lies inside the circle through the counter-clockwise a,b,c, negative outside, exactly zero on it.
+inline WPFloat InCircle2D(const WPFloat &ax, const WPFloat &ay, const WPFloat &bx, const WPFloat &by,
+	const WPFloat &cx, const WPFloat &cy, const WPFloat &dx, const WPFloat &dy) {
+	WPFloat adx = ax - dx, ady = ay - dy, bdx = bx - dx, bdy = by - dy, cdx = cx - dx, cdy = cy - dy;
+	WPFloat bdxcdy = bdx * cdy, cdxbdy = cdx * bdy, cdxady = cdx * ady, adxcdy = adx * cdy, adxbdy = adx * bdy, bdxady = bdx * ady;
+	WPFloat aLift = adx * adx + ady * ady, bLift = bdx * bdx + bdy * bdy, cLift = cdx * cdx + cdy * cdy;
+	WPFloat det = aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady);
+	WPFloat permanent = (STDFABS(bdxcdy) + STDFABS(cdxbdy)) * aLift + (STDFABS(cdxady) + STDFABS(adxcdy)) * bLift +
+		(STDFABS(adxbdy) + STDFABS(bdxady)) * cLift;
+	WPFloat bound = PREDICATES_INCIRCLE_BOUND * permanent;
+	if ((det > bound) || (-det > bound)) return det;
+	return InCircle2DExact(ax, ay, bx, by, cx, cy, dx, dy);
+}
+
+
+//True when the closed segments p1-q1 and p2-q2 share a point, including touching ends and collinear overlap.
+bool SegmentsIntersect2D(const WPFloat &p1x, const WPFloat &p1y, const WPFloat &q1x, const WPFloat &q1y,
+												const WPFloat &p2x, const WPFloat &p2y, const WPFloat &q2x, const WPFloat &q2y);
+
+
+/***********************************************~***************************************************/
+
+
+}	   // End Wildcat Namespace
+#endif //__GEOMETRIC_PREDICATES_H__
+
@@ -60,7 +60,7 @@ WCGeometricObject::WCGeometricObject(xercesc::DOMElement *element, WCSerialDicti
 	std::string renderProgName = WCSerializeableObject::GetStringAttrib(element, "renderProg");
 	//Make sure context exists, then get the shader ID
 	if (this->_context)
-		this->_renderProg = this->_context->ShaderManager()->ProgramFromName(renderProgName);
+		this->_renderProg = this->_context->ProgramFromName(renderProgName);
 	//Get the color value
 	this->_color.FromElement(  WCSerializeableObject::ElementFromName(element,"Color") );
 }
@@ -84,7 +84,7 @@ xercesc::DOMElement* WCGeometricObject::Serialize(xercesc::DOMDocument *document
 	WCSerializeableObject::AddBoolAttrib(element, "visible", this->_isVisible);
 	//Set the renderProg attribute
 	std::string renderProgName = "NULL";
-	if (this->_context)
+	if ((this->_context) && (this->_context->ShaderManager()))
 		renderProgName = this->_context->ShaderManager()->NameFromProgramID(this->_renderProg);
 	WCSerializeableObject::AddStringAttrib(element, "renderProg", renderProgName);
 	//Add the color value
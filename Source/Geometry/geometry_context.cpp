@@ -665,7 +665,24 @@ void WCGeometryContext::StopIntersection(void) {
 /***********************************************~***************************************************/
 
 
-WCGeometryContext::WCGeometryContext(WCGLContext *context, WCShaderManager *shaderManager) : _glContext(context), _shaderManager(shaderManager) {
+WCGeometryContext::WCGeometryContext() : _glContext(NULL), _shaderManager(NULL), _isSoftware(true),
+	_ncPerfLevel(NURBSCURVE_PERFLEVEL_LOW), _ncLocations(NULL), _ncDefault(0), _ncDefault23(0), _ncBezier23(0),
+	_ncMinCPBufferSize(0), _ncMinKPBufferSize(0), _ncVertsPerBatch(0), _ncCPBuffer(0), _ncKPBuffer(0),
+	_ncCPTex(0), _ncKPTex(0), _ncOutTex(0), _ncMaxTexSize(0), _ncFramebuffer(0),
+	_nsPerfLevel(NURBSSURFACE_PERFLEVEL_LOW), _nsLocations(NULL), _nsDefault(0), _nsDefault23(0), _nsBezier23(0),
+	_nsMinCPBufferSize(0), _nsMinKPBufferSize(0), _nsVertsPerBatch(0), _nsCPBuffer(0), _nsKPUBuffer(0), _nsKPVBuffer(0),
+	_nsCPTex(0), _nsKPUTex(0), _nsKPVTex(0), _nsVertTex(0), _nsNormTex(0), _nsTexTex(0), _nsMaxTexSize(0), _nsFramebuffer(0),
+	_tsLocations(NULL), _tsMaxTexSize(0), _tsPointInversion(0), _tsTriangulate(0), _tsInTex(0), _tsSurfTex(0), _tsOutTex(0),
+	_tsFramebuffer(0), _iLocations(NULL), _cliM(0), _cciM(0), _sliM(0), _sciM(0), _ssiM(0), _tliM(0), _tciM(0), _tsiM(0), _ttiM(0),
+	_cciLeftTex(0), _cciRightTex(0), _ssiLeftTex(0), _ssiRightTex(0), _cciOutTex(0), _ssiOutTex(0), _cciFramebuffer(0),
+	_ssiFramebuffer(0) {
+	//No GL objects are created - the low performance level and zero texture sizes send all generation to the CPU
+	CLOGGER_DEBUG(WCLogManager::RootLogger(), "WCGeometryContext::WCGeometryContext - Running in software mode.");
+}
+
+
+WCGeometryContext::WCGeometryContext(WCGLContext *context, WCShaderManager *shaderManager) : _glContext(context), _shaderManager(shaderManager),
+	_isSoftware(false) {
 	//Check to make sure context and shader manager are valid
 	ASSERT(context);
 	ASSERT(shaderManager);
@@ -691,6 +708,8 @@ WCGeometryContext::WCGeometryContext(WCGLContext *context, WCShaderManager *shad
 
 
 WCGeometryContext::~WCGeometryContext() {
+	//Software contexts hold no GL objects
+	if (this->_isSoftware) return;
 	//Conclude all NURBS curve parameters
 	this->StopCurve();
 	//Conclude all NURBS surface parameters
@@ -709,8 +728,11 @@ std::ostream& __WILDCAT_NAMESPACE__::operator<<(std::ostream& out, const WCGeome
 	out << "GeometryContext(" << &context << ")\n";
 	out << "\t GLContext: " << context._glContext << std::endl;
 	out << "\t Shader Manager: " << context._shaderManager << std::endl;
+	out << "\t Software: " << context._isSoftware << std::endl;
 	out << "*** Curve Parameters ***\n";
 	out << "\t Perf Level: " << context._ncPerfLevel << std::endl;
+	//Software contexts have no programs or GL objects to show
+	if (context._isSoftware) return out;
 	out << "\t Locations:\n";
 	out << "\t\t CP Default: " << context._ncLocations[NURBSCURVE_LOC_CP_DEFAULT] << std::endl;
 	out << "\t\t CP Default23: " << context._ncLocations[NURBSCURVE_LOC_CP_DEFAULT23] << std::endl;
@@ -54,6 +54,7 @@ private:
 	//General Context Objects
 	WCGLContext									*_glContext;										//!< Pointer to GL context
 	WCShaderManager								*_shaderManager;									//!< Pointer to shader manager for GL context
+	bool										_isSoftware;										//!< No GL objects - all work runs on the CPU
 		
 	//NURBS Curve Objects
 	int											_ncPerfLevel;										//!< Static performance level indicator
@@ -102,18 +103,19 @@ private:
 	void StopIntersection(void);																	//!< Destroy all Intersection global objects
 	
 	//Deny Access
-	WCGeometryContext();																			//!< Deny access to default constructor
 	WCGeometryContext(const WCGeometryContext &context);											//!< Deny access to copy constructor
 	WCGeometryContext& operator=(const WCGeometryContext &context);									//!< Deny access to equals operator
 	
 public:
 	//Constructors and Destructors
+	WCGeometryContext();																			//!< Software (headless) constructor
 	WCGeometryContext(WCGLContext *context, WCShaderManager *shaderManager);						//!< Primary constructor
 	~WCGeometryContext();																			//!< Default destructor
 	
 	//General Access Methods
 	inline WCGLContext* Context(void)			{ return this->_glContext; }						//!< Get the GL context
 	inline WCShaderManager* ShaderManager(void)	{ return this->_shaderManager; }					//!< Get the shader manager
+	inline bool IsSoftware(void) const			{ return this->_isSoftware; }						//!< Is this a software (headless) context
 	
 	//NURBS Curve Access Methods
 	inline WPUInt CurvePerformanceLevel(void) const		{ return this->_ncPerfLevel; }				//!< Get curve generation performance level
@@ -29,6 +29,7 @@
 /*** Included Header Files ***/
 #include <Geometry/nurbs.h>
 #include <Geometry/geometric_algorithms.h>
+#include <algorithm>
 
 
 /***********************************************~***************************************************/
@@ -72,6 +73,15 @@ WPFloat __bezier_coef7[] = {-1.0, 7.0, -21.0, 35.0, -35.0, 21.0, -7.0, 1.0,
 WPFloat* __bezier_coef[8] = { NULL, __bezier_coef1, __bezier_coef2, __bezier_coef3, __bezier_coef4, __bezier_coef5, __bezier_coef6, __bezier_coef7};
 
 
+//Eight point Gauss-Legendre rule - exact for polynomials up to degree 15
+const WPFloat WCNurbs::GaussNodes[NURBS_GAUSS_POINTS] = {
+	-0.9602898564975363, -0.7966664774136267, -0.5255324099163290, -0.1834346424956498,
+	 0.1834346424956498,  0.5255324099163290,  0.7966664774136267,  0.9602898564975363 };
+const WPFloat WCNurbs::GaussWeights[NURBS_GAUSS_POINTS] = {
+	 0.1012285362903763,  0.2223810344533745,  0.3137066458778873,  0.3626837833783620,
+	 0.3626837833783620,  0.3137066458778873,  0.2223810344533745,  0.1012285362903763 };
+
+
 /***********************************************~***************************************************/
 
 
@@ -94,20 +104,17 @@ WPUInt WCNurbs::FindSpan(const WPUInt &numCP, const WPUInt &degree, const WPFloa
 
 
 WPUInt WCNurbs::FindUniformSpan(const WPUInt &numCP, const WPUInt &degree, const WPFloat &u, const WPFloat *knotPoints) {
-	//Check special case
-	if (u >= knotPoints[numCP+degree]) return numCP+degree;
-	//Setup search
-	WPUInt low = 0;
-	WPUInt high = numCP + degree;
-	WPUInt mid = (low + high) / 2;
-	//Start binary search
-	while ((u < knotPoints[mid]) || (u >= knotPoints[mid+1])) {
-		if (u < knotPoints[mid]) high = mid;
-		else low = mid;
-		mid = (low + high) / 2;
-	}
+	//Check special cases
+	if (u >= knotPoints[numCP]) return numCP-1;
+	if (u <= knotPoints[degree]) return degree;
+	//Interior knots are evenly spaced - calculate the span directly
+	WPFloat range = knotPoints[numCP] - knotPoints[degree];
+	WPUInt span = degree + (WPUInt)((u - knotPoints[degree]) * (WPFloat)(numCP - degree) / range);
+	//Correct for any round-off
+	while ((span > degree) && (u < knotPoints[span])) span--;
+	while ((span < numCP-1) && (u >= knotPoints[span+1])) span++;
 	//Return the span value
-	return mid;
+	return span;
 }
 
 
@@ -122,27 +129,40 @@ void WCNurbs::FindSpanMultiplicity(const WPUInt &numCP, const WPUInt &degree, co
 
 
 WPFloat* WCNurbs::BasisValues(const WPUInt &span, const WPFloat &u, const WPUInt &degree, const WPFloat *knotPoints, const WPUInt &der) {
-	//Allocate arrays for ndu and a
-	WPFloat **ndu = new WPFloat*[degree+1];
-	for (WPUInt i=0; i<=degree; i++) ndu[i] = new WPFloat[degree+1];
-	WPFloat **a = new WPFloat*[2];
-	a[0] = new WPFloat[degree+1];
-	a[1] = new WPFloat[degree+1];
-
-	WPFloat *left = new WPFloat[degree+1];
-	WPFloat *right = new WPFloat[degree+1];
-	int j, k, r, j1, j2, s1, s2, rk, pk;
-	WPFloat saved, temp, d;
-	WPUInt useDer = STDMIN(der, degree-1);
-	
 	//Allocate space for the output
 	WPFloat *ders = new WPFloat[(der+1) * (degree+1)];
 	//Check to make sure memory is allocated
-	if (ders == NULL) 
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::BasisValues - Not able to allocate memory for results array.");
+	if (ders == NULL) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::BasisValues - Not able to allocate memory for results array.");
+		return NULL;
+	}
+	//Calculate the values into the new array
+	if (!WCNurbs::BasisValues(span, u, degree, knotPoints, der, ders)) {
+		delete [] ders;
+		return NULL;
+	}
+	//Return the array
+	return ders;
+}
+
+
+bool WCNurbs::BasisValues(const WPUInt &span, const WPFloat &u, const WPUInt &degree, const WPFloat *knotPoints,
+	const WPUInt &der, WPFloat *ders) {
+	//Make sure the workspace is large enough
+	if (degree > NURBS_BASIS_MAX_DEGREE) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::BasisValues - Degree exceeds NURBS_BASIS_MAX_DEGREE.");
+		return false;
+	}
+	//Fixed size workspace (no heap allocation)
+	WPFloat ndu[NURBS_BASIS_MAX_ORDER][NURBS_BASIS_MAX_ORDER];
+	WPFloat a[2][NURBS_BASIS_MAX_ORDER];
+	WPFloat left[NURBS_BASIS_MAX_ORDER], right[NURBS_BASIS_MAX_ORDER];
+	int j, k, r, j1, j2, s1, s2, rk, pk;
+	WPFloat saved, temp, d;
+	WPUInt useDer = STDMIN(der, degree);
 	//Set all values to zero
 	memset(ders, 0, sizeof(WPFloat)*(der+1)*(degree+1));
-		
+
 	//Calculate basis values
 	ndu[0][0] = 1.0;
 	for (j=1; j<=(int)degree; j++) {
@@ -159,21 +179,9 @@ WPFloat* WCNurbs::BasisValues(const WPUInt &span, const WPFloat &u, const WPUInt
 	}
 	//Copy the basis values into the results
 	for (j=0; j<=(int)degree; j++) ders[j] = ndu[j][degree];
-	//Delete left and right arrays
-	delete left;
-	delete right;
 	//Check for der==0 optimization
-	if (der == 0) {
-			//Delete arrays
-			for (WPUInt i=0; i<degree; i++) delete ndu[i];
-			delete ndu;
-			delete a[0];
-			delete a[1];
-			delete a;
-			//Return the values
-			return ders;
-	}
-	
+	if (der == 0) return true;
+
 	//Loop over function index
 	for (r=0; r<=(int)degree; r++) {
 		s1 = 0;
@@ -205,12 +213,6 @@ WPFloat* WCNurbs::BasisValues(const WPUInt &span, const WPFloat &u, const WPUInt
 			j = s1; s1 = s2; s2 = j;
 		}
 	}
-	//Delete ndu and A arrays
-	for (WPUInt i=0; i<=degree; i++) delete ndu[i];
-	delete ndu;
-	delete a[0];
-	delete a[1];
-	delete a;
 	
 	//Multiply each der value by the factorial
 	r = degree;
@@ -219,13 +221,8 @@ WPFloat* WCNurbs::BasisValues(const WPUInt &span, const WPFloat &u, const WPUInt
 			ders[k*(degree+1)+j] *= r;
 		r *= (degree - k);
 	}
-
-	/*** Debug ***
-	for (k=0; k<(der+1)*(degree+1); k++) 
-		std::cout << "ders[" << k << "]: " << ders[k] << std::endl;	
-/*** Debug ***/
-	//Return the array
-	return ders;
+	//All is good
+	return true;
 }
 
 			
@@ -310,7 +307,7 @@ WPFloat* WCNurbs::LoadCustomKnotPoints(const std::vector<WPFloat> &inPoints) {
 		return NULL;
 	}
 	
-	WPFloat min = knotPoints[0];
+	WPFloat min = inPoints.at(0);
 	//Copy the data into the array
 	for (WPUInt i=0; i<inPoints.size(); i++) {
 		knotPoints[i] = inPoints.at(i);
@@ -498,3 +495,441 @@ void WCNurbs::EllipsePoints(const WCVector4 &center, const WCVector4 &xUnit, con
 
 /***********************************************~***************************************************/
 
+
+#define NURBS_BEZIER_DISPATCH(call)												\
+	switch(degree) {															\
+		case 1: WCBezier<1>::call; return true;									\
+		case 2: WCBezier<2>::call; return true;									\
+		case 3: WCBezier<3>::call; return true;									\
+		case 4: WCBezier<4>::call; return true;									\
+		case 5: WCBezier<5>::call; return true;									\
+		case 6: WCBezier<6>::call; return true;									\
+		case 7: WCBezier<7>::call; return true;									\
+		default: return false;													\
+	}
+
+
+bool WCNurbs::EvaluateBezier(const WPUInt &degree, const WPFloat *hcp, const WPUInt &stride,
+	const WPFloat &u, WPFloat *point) {
+	NURBS_BEZIER_DISPATCH(Evaluate(hcp, stride, u, point))
+}
+
+
+bool WCNurbs::EvaluateBezierDerivative(const WPUInt &degree, const WPFloat *hcp, const WPUInt &stride,
+	const WPFloat &u, WPFloat *point, WPFloat *derivative) {
+	NURBS_BEZIER_DISPATCH(EvaluateDerivative(hcp, stride, u, point, derivative))
+}
+
+
+bool WCNurbs::SubdivideBezier(const WPUInt &degree, const WPFloat *hcp, const WPUInt &stride,
+	const WPFloat &u, WPFloat *left, WPFloat *right) {
+	NURBS_BEZIER_DISPATCH(Subdivide(hcp, stride, u, left, right))
+}
+
+
+/***********************************************~***************************************************/
+
+
+//Knot vectors must be sized to the points and clamped at both ends (round-off in the end knots is snapped)
+static bool _NurbsCheckKnots(const char *name, const WPUInt &degree, std::vector<WPFloat> &knots,
+	const std::vector<WPFloat> &points, const WPUInt &dim) {
+	if ((degree < 1) || (dim == 0) || (dim % 4 != 0) || (points.size() % dim != 0)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::" << name << " - Invalid degree or point layout.");
+		return false;
+	}
+	WPUInt numCP = (WPUInt)points.size() / dim;
+	if ((numCP <= degree) || (knots.size() != numCP + degree + 1)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::" << name << " - Knot vector does not match the points.");
+		return false;
+	}
+	WPFloat eps = NURBS_KNOT_EXACT_TOLERANCE * (knots.back() - knots.front());
+	for (WPUInt i=1; i<=degree; i++) {
+		if ((fabs(knots[i] - knots[0]) > eps) || (fabs(knots[knots.size()-1-i] - knots.back()) > eps)) {
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::" << name << " - Knot vector is not clamped.");
+			return false;
+		}
+		knots[i] = knots[0];
+		knots[knots.size()-1-i] = knots.back();
+	}
+	return true;
+}
+
+
+//Collect the distinct interior knots and their multiplicities
+static void _NurbsInteriorKnots(const WPUInt &degree, const std::vector<WPFloat> &knots,
+	std::vector<WPFloat> &values, std::vector<WPUInt> &multiplicities) {
+	WPUInt last = (WPUInt)knots.size() - degree - 1;
+	for (WPUInt i=degree+1; i<last; i++) {
+		if ((values.size() > 0) && (values.back() == knots[i])) multiplicities.back()++;
+		else {
+			values.push_back(knots[i]);
+			multiplicities.push_back(1);
+		}
+	}
+}
+
+
+//Largest homogeneous distance between matching fours of two rows
+static WPFloat _NurbsRowDistance(const WPFloat *a, const WPFloat *b, const WPUInt &dim) {
+	WPFloat dist = 0.0, dx, dy, dz, dw;
+	for (WPUInt i=0; i<dim; i+=4) {
+		dx = a[i] - b[i];
+		dy = a[i+1] - b[i+1];
+		dz = a[i+2] - b[i+2];
+		dw = a[i+3] - b[i+3];
+		dist = STDMAX(dist, sqrt(dx*dx + dy*dy + dz*dz + dw*dw));
+	}
+	return dist;
+}
+
+
+//Elevate one Bezier segment of rows by times
+static void _NurbsElevateBezier(const WPFloat *src, const WPUInt &degree, const WPUInt &times,
+	const WPUInt &dim, WPFloat *dst) {
+	WPUInt ph = degree + times;
+	//Binomial table up to the new degree
+	WPFloat bin[NURBS_BASIS_MAX_ORDER+1][NURBS_BASIS_MAX_ORDER+1];
+	for (WPUInt n=0; n<=ph; n++) {
+		bin[n][0] = bin[n][n] = 1.0;
+		for (WPUInt k=1; k<n; k++) bin[n][k] = bin[n-1][k-1] + bin[n-1][k];
+	}
+	//Q_i = sum C(p,j) C(t,i-j) / C(p+t,i) P_j
+	for (WPUInt i=0; i<=ph; i++) {
+		for (WPUInt d=0; d<dim; d++) dst[i*dim+d] = 0.0;
+		WPUInt lo = (i > times) ? i - times : 0;
+		WPUInt hi = STDMIN(degree, i);
+		for (WPUInt j=lo; j<=hi; j++) {
+			WPFloat coef = bin[degree][j] * bin[times][i-j] / bin[ph][i];
+			for (WPUInt d=0; d<dim; d++) dst[i*dim+d] += coef * src[j*dim+d];
+		}
+	}
+}
+
+
+//Build a clamped knot vector with every interior value at the given multiplicity
+static void _NurbsBezierKnots(const WPUInt &degree, const WPFloat &start, const WPFloat &stop,
+	const std::vector<WPFloat> &interior, const WPUInt &multiplicity, std::vector<WPFloat> &knots) {
+	knots.assign(degree+1, start);
+	for (WPUInt i=0; i<interior.size(); i++) knots.insert(knots.end(), multiplicity, interior[i]);
+	knots.insert(knots.end(), degree+1, stop);
+}
+
+
+bool WCNurbs::RefineKnots(const WPUInt &degree, std::vector<WPFloat> &knots, std::vector<WPFloat> &points,
+	const WPUInt &dim, const std::vector<WPFloat> &insert) {
+	if (!_NurbsCheckKnots("RefineKnots", degree, knots, points, dim)) return false;
+	if (insert.size() == 0) return true;
+	WPUInt numCP = (WPUInt)points.size() / dim;
+	//New knots must lie strictly inside the domain
+	std::vector<WPFloat> sorted(insert);
+	std::sort(sorted.begin(), sorted.end());
+	if ((sorted.front() <= knots[degree]) || (sorted.back() >= knots[numCP])) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::RefineKnots - Knots must be inside the parametric domain.");
+		return false;
+	}
+	//Merge into the refined knot vector tau
+	std::vector<WPFloat> tau(knots.size() + sorted.size());
+	std::merge(knots.begin(), knots.end(), sorted.begin(), sorted.end(), tau.begin());
+	WPUInt newCP = numCP + (WPUInt)sorted.size();
+	std::vector<WPFloat> refined(newCP * dim);
+	WPFloat *work = new WPFloat[(degree+1) * dim];
+	//Oslo: Q_j is the blossom of the original span at tau_{j+1} .. tau_{j+p}
+	for (WPUInt j=0; j<newCP; j++) {
+		WPUInt mu = WCNurbs::FindSpan(numCP, degree, tau[j], &knots[0]);
+		WPUInt base = mu - degree;
+		memcpy(work, &points[base*dim], (degree+1) * dim * sizeof(WPFloat));
+		for (WPUInt r=1; r<=degree; r++) {
+			WPFloat x = tau[j+r];
+			for (WPUInt i=mu; i>=base+r; i--) {
+				WPFloat alpha = (x - knots[i]) / (knots[i+degree-r+1] - knots[i]);
+				WPFloat *dst = work + (i-base)*dim;
+				const WPFloat *prev = dst - dim;
+				for (WPUInt d=0; d<dim; d++) dst[d] = (1.0 - alpha) * prev[d] + alpha * dst[d];
+			}
+		}
+		memcpy(&refined[j*dim], work + degree*dim, dim * sizeof(WPFloat));
+	}
+	delete [] work;
+	//Swap in the results
+	knots.swap(tau);
+	points.swap(refined);
+	return true;
+}
+
+
+WPUInt WCNurbs::InsertKnot(const WPUInt &degree, std::vector<WPFloat> &knots, std::vector<WPFloat> &points,
+	const WPUInt &dim, const WPFloat &u, const WPUInt &times) {
+	if (!_NurbsCheckKnots("InsertKnot", degree, knots, points, dim)) return 0;
+	//Never raise the multiplicity past the degree
+	WPUInt s = (WPUInt)std::count(knots.begin(), knots.end(), u);
+	if (s >= degree) return 0;
+	WPUInt count = STDMIN(times, degree - s);
+	if (count == 0) return 0;
+	std::vector<WPFloat> insert(count, u);
+	if (!WCNurbs::RefineKnots(degree, knots, points, dim, insert)) return 0;
+	return count;
+}
+
+
+WPUInt WCNurbs::RemoveKnot(const WPUInt &degree, std::vector<WPFloat> &knots, std::vector<WPFloat> &points,
+	const WPUInt &dim, const WPFloat &u, const WPUInt &times, const WPFloat &tolerance) {
+	if (!_NurbsCheckKnots("RemoveKnot", degree, knots, points, dim)) return 0;
+	WPInt p = (WPInt)degree, n = (WPInt)(points.size() / dim) - 1, m = n + p + 1, ord = p + 1;
+	//Find the last occurrence of the interior knot and its multiplicity
+	WPInt r = -1, s = 0;
+	for (WPInt i=p+1; i<=n; i++) {
+		if (knots[i] == u) {
+			r = i;
+			s++;
+		}
+	}
+	if ((r < 0) || (times == 0)) return 0;
+	WPInt num = STDMIN((WPInt)times, s);
+	//Scale the tolerance into homogeneous space (Piegl & Tiller eq. 5.30)
+	WPFloat wMin = 1.0e300, pMax = 0.0, w;
+	for (WPUInt i=0; i<points.size(); i+=4) {
+		w = points[i+3];
+		wMin = STDMIN(wMin, w);
+		if (w > 0.0) pMax = STDMAX(pMax, sqrt(points[i]*points[i] + points[i+1]*points[i+1] + points[i+2]*points[i+2]) / w);
+	}
+	WPFloat tol = tolerance * wMin / (1.0 + pMax);
+	//Knot removal (Piegl & Tiller A5.8)
+	WPInt fout = (2*r - s - p) / 2, last = r - s, first = r - p, t;
+	WPFloat *temp = new WPFloat[(2*p + 3) * dim];
+	WPFloat alfi, alfj;
+	for (t=0; t<num; t++) {
+		WPInt off = first - 1;
+		memcpy(temp, &points[off*dim], dim * sizeof(WPFloat));
+		memcpy(temp + (last+1-off)*dim, &points[(last+1)*dim], dim * sizeof(WPFloat));
+		WPInt i = first, j = last, ii = 1, jj = last - off;
+		bool removable = false;
+		while (j - i > t) {
+			alfi = (u - knots[i]) / (knots[i+ord+t] - knots[i]);
+			alfj = (u - knots[j-t]) / (knots[j+ord] - knots[j-t]);
+			for (WPUInt d=0; d<dim; d++) {
+				temp[ii*dim+d] = (points[i*dim+d] - (1.0 - alfi) * temp[(ii-1)*dim+d]) / alfi;
+				temp[jj*dim+d] = (points[j*dim+d] - alfj * temp[(jj+1)*dim+d]) / (1.0 - alfj);
+			}
+			i++; ii++;
+			j--; jj--;
+		}
+		//Check whether the two sides meet
+		if (j - i < t) removable = (_NurbsRowDistance(temp + (ii-1)*dim, temp + (jj+1)*dim, dim) <= tol);
+		else {
+			alfi = (u - knots[i]) / (knots[i+ord+t] - knots[i]);
+			WPFloat *check = new WPFloat[dim];
+			for (WPUInt d=0; d<dim; d++) check[d] = alfi * temp[(ii+t+1)*dim+d] + (1.0 - alfi) * temp[(ii-1)*dim+d];
+			removable = (_NurbsRowDistance(&points[i*dim], check, dim) <= tol);
+			delete [] check;
+		}
+		if (!removable) break;
+		//Accept the new control points
+		i = first;
+		j = last;
+		while (j - i > t) {
+			memcpy(&points[i*dim], temp + (i-off)*dim, dim * sizeof(WPFloat));
+			memcpy(&points[j*dim], temp + (j-off)*dim, dim * sizeof(WPFloat));
+			i++;
+			j--;
+		}
+		first--;
+		last++;
+	}
+	delete [] temp;
+	if (t == 0) return 0;
+	//Shift the knots and control points down
+	for (WPInt k=r+1; k<=m; k++) knots[k-t] = knots[k];
+	knots.resize(m + 1 - t);
+	WPInt j = fout, i = fout;
+	for (WPInt k=1; k<t; k++) {
+		if (k % 2 == 1) i++;
+		else j--;
+	}
+	for (WPInt k=i+1; k<=n; k++, j++) memcpy(&points[j*dim], &points[k*dim], dim * sizeof(WPFloat));
+	points.resize((n + 1 - t) * dim);
+	return (WPUInt)t;
+}
+
+
+WPUInt WCNurbs::DecomposeBezier(const WPUInt &degree, std::vector<WPFloat> &knots, std::vector<WPFloat> &points,
+	const WPUInt &dim) {
+	if (!_NurbsCheckKnots("DecomposeBezier", degree, knots, points, dim)) return 0;
+	std::vector<WPFloat> values, insert;
+	std::vector<WPUInt> multiplicities;
+	_NurbsInteriorKnots(degree, knots, values, multiplicities);
+	//Bring every interior knot up to the degree
+	for (WPUInt i=0; i<values.size(); i++)
+		if (multiplicities[i] < degree) insert.insert(insert.end(), degree - multiplicities[i], values[i]);
+	if (!WCNurbs::RefineKnots(degree, knots, points, dim, insert)) return 0;
+	return (WPUInt)values.size() + 1;
+}
+
+
+bool WCNurbs::ElevateDegree(WPUInt &degree, std::vector<WPFloat> &knots, std::vector<WPFloat> &points,
+	const WPUInt &dim, const WPUInt &times) {
+	if (!_NurbsCheckKnots("ElevateDegree", degree, knots, points, dim)) return false;
+	if (times == 0) return true;
+	WPUInt p = degree, ph = degree + times;
+	if (ph > NURBS_BASIS_MAX_DEGREE) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::ElevateDegree - Degree " << ph << " is out of range.");
+		return false;
+	}
+	std::vector<WPFloat> values;
+	std::vector<WPUInt> multiplicities;
+	_NurbsInteriorKnots(p, knots, values, multiplicities);
+	//Split into Bezier segments and elevate each one
+	std::vector<WPFloat> bezKnots(knots), bezPoints(points);
+	WPUInt segments = WCNurbs::DecomposeBezier(p, bezKnots, bezPoints, dim);
+	if (segments == 0) return false;
+	std::vector<WPFloat> newPoints((segments*ph + 1) * dim);
+	for (WPUInt k=0; k<segments; k++)
+		_NurbsElevateBezier(&bezPoints[k*p*dim], p, times, dim, &newPoints[k*ph*dim]);
+	std::vector<WPFloat> newKnots;
+	_NurbsBezierKnots(ph, knots.front(), knots.back(), values, ph, newKnots);
+	//Elevated knots keep their continuity, so strip the extra multiplicity back off
+	for (WPUInt i=0; i<values.size(); i++)
+		WCNurbs::RemoveKnot(ph, newKnots, newPoints, dim, values[i], p - multiplicities[i], NURBS_KNOT_EXACT_TOLERANCE);
+	degree = ph;
+	knots.swap(newKnots);
+	points.swap(newPoints);
+	return true;
+}
+
+
+bool WCNurbs::ReduceDegree(WPUInt &degree, std::vector<WPFloat> &knots, std::vector<WPFloat> &points,
+	const WPUInt &dim, const WPFloat &tolerance) {
+	if (!_NurbsCheckKnots("ReduceDegree", degree, knots, points, dim)) return false;
+	if (degree < 2) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbs::ReduceDegree - Degree must be at least two.");
+		return false;
+	}
+	WPUInt p = degree, ph = degree - 1;
+	std::vector<WPFloat> values;
+	std::vector<WPUInt> multiplicities;
+	_NurbsInteriorKnots(p, knots, values, multiplicities);
+	std::vector<WPFloat> bezKnots(knots), bezPoints(points);
+	WPUInt segments = WCNurbs::DecomposeBezier(p, bezKnots, bezPoints, dim);
+	if (segments == 0) return false;
+	//Reduce each segment (Piegl & Tiller eq. 5.41 - 5.45)
+	std::vector<WPFloat> newPoints((segments*ph + 1) * dim);
+	WPFloat *check = new WPFloat[(p + 1) * dim];
+	WPInt r = (WPInt)(p - 1) / 2;
+	bool ok = true;
+	for (WPUInt k=0; (k<segments) && ok; k++) {
+		const WPFloat *P = &bezPoints[k*p*dim];
+		WPFloat *Q = &newPoints[k*ph*dim];
+		WPFloat alpha;
+		memcpy(Q, P, dim * sizeof(WPFloat));
+		memcpy(Q + ph*dim, P + p*dim, dim * sizeof(WPFloat));
+		WPInt leftEnd = (p % 2 == 0) ? r : r - 1;
+		for (WPInt i=1; i<=leftEnd; i++) {
+			alpha = (WPFloat)i / (WPFloat)p;
+			for (WPUInt d=0; d<dim; d++) Q[i*dim+d] = (P[i*dim+d] - alpha * Q[(i-1)*dim+d]) / (1.0 - alpha);
+		}
+		for (WPInt i=(WPInt)p-2; i>r; i--) {
+			alpha = (WPFloat)(i+1) / (WPFloat)p;
+			for (WPUInt d=0; d<dim; d++) Q[i*dim+d] = (P[(i+1)*dim+d] - (1.0 - alpha) * Q[(i+1)*dim+d]) / alpha;
+		}
+		//Odd degrees average the two estimates of the middle point
+		if ((p % 2 == 1) && (r > 0)) {
+			WPFloat aL = (WPFloat)r / (WPFloat)p, aR = (WPFloat)(r+1) / (WPFloat)p;
+			for (WPUInt d=0; d<dim; d++)
+				Q[r*dim+d] = 0.5 * ((P[r*dim+d] - aL * Q[(r-1)*dim+d]) / (1.0 - aL) +
+					(P[(r+1)*dim+d] - (1.0 - aR) * Q[(r+1)*dim+d]) / aR);
+		}
+		//Measure the error by elevating back and comparing Cartesian control points
+		_NurbsElevateBezier(Q, ph, 1, dim, check);
+		for (WPUInt i=0; (i<=p) && ok; i++) {
+			for (WPUInt d=0; (d<dim) && ok; d+=4) {
+				const WPFloat *a = P + i*dim + d, *b = check + i*dim + d;
+				if ((a[3] <= 0.0) || (b[3] <= 0.0)) ok = false;
+				else {
+					WPFloat dx = a[0]/a[3] - b[0]/b[3], dy = a[1]/a[3] - b[1]/b[3], dz = a[2]/a[3] - b[2]/b[3];
+					ok = (sqrt(dx*dx + dy*dy + dz*dz) <= tolerance / 2.0);
+				}
+			}
+		}
+	}
+	delete [] check;
+	if (!ok) return false;
+	//Join the segments and remove knots back towards the original continuity
+	std::vector<WPFloat> newKnots;
+	_NurbsBezierKnots(ph, knots.front(), knots.back(), values, ph, newKnots);
+	for (WPUInt i=0; i<values.size(); i++)
+		WCNurbs::RemoveKnot(ph, newKnots, newPoints, dim, values[i], p - multiplicities[i], tolerance / 2.0);
+	degree = ph;
+	knots.swap(newKnots);
+	points.swap(newPoints);
+	return true;
+}
+
+
+/***********************************************~***************************************************/
+
+
+bool WCNurbsBasisCache::IsValid(const WPUInt &numCP, const WPUInt &degree, const WPFloat *knotPoints,
+	const WPFloat &start, const WPFloat &stop, const WPUInt &lod, const WPUInt &der) const {
+	//Check the simple parts of the key first
+	if ((this->_lod == 0) || (knotPoints == NULL)) return false;
+	if ((this->_numCP != numCP) || (this->_degree != degree) || (this->_lod != lod) || (this->_der != der)) return false;
+	if ((this->_start != start) || (this->_stop != stop)) return false;
+	//Now check the knot vector
+	for (WPUInt i=0; i<numCP+degree+1; i++)
+		if (this->_knotPoints[i] != knotPoints[i]) return false;
+	//Everything matches
+	return true;
+}
+
+
+bool WCNurbsBasisCache::Build(const WPUInt &numCP, const WPUInt &degree, const WPFloat *knotPoints,
+	const WPFloat &start, const WPFloat &stop, const WPUInt &lod, const WPUInt &der) {
+	//Make sure the inputs are reasonable
+	if ((knotPoints == NULL) || (lod == 0) || (degree > NURBS_BASIS_MAX_DEGREE)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsBasisCache::Build - Invalid input parameters.");
+		this->Clear();
+		return false;
+	}
+	//Record the key
+	WPUInt kp = numCP + degree + 1;
+	this->_numCP = numCP;
+	this->_degree = degree;
+	this->_lod = lod;
+	this->_der = der;
+	this->_start = start;
+	this->_stop = stop;
+	this->_knotPoints.assign(knotPoints, knotPoints + kp);
+	//Size the sample arrays
+	WPUInt stride = (der + 1) * (degree + 1);
+	this->_spans.resize(lod);
+	this->_params.resize(lod);
+	this->_values.resize(lod * stride);
+	//Evaluate each sample, walking forward through the spans
+	WPFloat du = (lod > 1) ? (stop - start) / (WPFloat)(lod - 1) : 0.0;
+	WPFloat u;
+	WPUInt span = WCNurbs::FindSpan(numCP, degree, STDMAX(knotPoints[0], STDMIN(knotPoints[kp-1], start)), knotPoints);
+	for (WPUInt i=0; i<lod; i++) {
+		u = (i == lod-1) ? stop : start + du * i;
+		u = STDMAX(knotPoints[0], STDMIN(knotPoints[kp-1], u));
+		if (u < knotPoints[span]) span = WCNurbs::FindSpan(numCP, degree, u, knotPoints);
+		while ((span < numCP-1) && (u >= knotPoints[span+1])) span++;
+		this->_spans[i] = span;
+		this->_params[i] = u;
+		WCNurbs::BasisValues(span, u, degree, knotPoints, der, &this->_values[i * stride]);
+	}
+	//All is good
+	return true;
+}
+
+
+void WCNurbsBasisCache::Clear(void) {
+	//Reset the key and release the arrays
+	this->_lod = 0;
+	this->_knotPoints.clear();
+	this->_spans.clear();
+	this->_params.clear();
+	this->_values.clear();
+}
+
+
+/***********************************************~***************************************************/
+
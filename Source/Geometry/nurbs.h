@@ -36,6 +36,14 @@
 
 /*** Locally Defined Values ***/
 extern WPFloat* __bezier_coef[8];
+//Basis function workspace bounds (must cover NURBSCURVE_MAX_DEGREE and NURBSSURFACE_MAX_DEGREE)
+#define NURBS_BASIS_MAX_DEGREE					7
+#define NURBS_BASIS_MAX_ORDER					(NURBS_BASIS_MAX_DEGREE+1)
+#define NURBS_BASIS_MAX_VALUES					(NURBS_BASIS_MAX_ORDER*NURBS_BASIS_MAX_ORDER)
+//Quadrature rule size
+#define NURBS_GAUSS_POINTS						8
+//Knot removal tolerance used where the removal is exact in theory
+#define NURBS_KNOT_EXACT_TOLERANCE				1.0e-9
 
 
 /*** Namespace Declaration ***/
@@ -51,15 +59,19 @@ namespace __WILDCAT_NAMESPACE__ {
 
 class WCNurbs {																			
 public:
+	static const WPFloat GaussNodes[NURBS_GAUSS_POINTS];											//!< Gauss-Legendre nodes on [-1, 1]
+	static const WPFloat GaussWeights[NURBS_GAUSS_POINTS];											//!< Gauss-Legendre weights on [-1, 1]
 	static WPUInt FindSpan(const WPUInt &numCP, const WPUInt &degree,								//!< Find the span of the index value
 												const WPFloat &u, const WPFloat *knotPoints);
-	static WPUInt FindUniformSpan(const WPUInt &numCP, const WPUInt &degree,						//!< Find the span of the index value for a uniform array
+	static WPUInt FindUniformSpan(const WPUInt &numCP, const WPUInt &degree,						//!< Find the span in constant time for uniform interior knots
 												const WPFloat &u, const WPFloat *knotPoints);
 	static void FindSpanMultiplicity(const WPUInt &numCP, const WPUInt &degree,						//!< Find the span and multiplicity
 												const WPFloat &u, const WPFloat *knotPoints, 
 												WPUInt &span, WPUInt &multiplicity);
 	static WPFloat *BasisValues(const WPUInt &span, const WPFloat &u, const WPUInt &degree,			//!< Calculate the basis functions on U
 												const WPFloat *knotPoints, const WPUInt &der=0);	
+	static bool BasisValues(const WPUInt &span, const WPFloat &u, const WPUInt &degree,				//!< Calculate the basis functions on U into caller storage
+												const WPFloat *knotPoints, const WPUInt &der, WPFloat *ders);
 	static WPFloat* LoadDefaultKnotPoints(const WPUInt &kp, const WPUInt &degree);					//!< Initialize an array to default knot values
 	static WPFloat* LoadBezierKnotPoints(const WPUInt &kp);											//!< Initialize an array to bezier knot values
 	static WPFloat* LoadUniformKnotPoints(const WPUInt &kp);										//!< Initialize an array to uniform knot values
@@ -74,12 +86,124 @@ public:
 	static void EllipsePoints(const WCVector4 &center, const WCVector4 &xUnit, const WCVector4 &yUnit,	//!< Generate elliptical curve points
 												const WPFloat &major, const WPFloat &minor,
 												std::vector<WCVector4> &controlPoints, std::vector<WPFloat> &knotPoints);
+	//Bezier Methods - dispatch on degree to WCBezier<D>, false if degree is out of range
+	static bool EvaluateBezier(const WPUInt &degree, const WPFloat *hcp, const WPUInt &stride,		//!< Homogeneous point by rational Horner
+												const WPFloat &u, WPFloat *point);
+	static bool EvaluateBezierDerivative(const WPUInt &degree, const WPFloat *hcp,					//!< Homogeneous point and first derivative by de Casteljau
+												const WPUInt &stride, const WPFloat &u, WPFloat *point, WPFloat *derivative);
+	static bool SubdivideBezier(const WPUInt &degree, const WPFloat *hcp, const WPUInt &stride,		//!< Split at u into two Bezier control polygons
+												const WPFloat &u, WPFloat *left, WPFloat *right);
+	//Knot Methods - points are rows of dim values made of homogeneous fours, knots must be clamped
+	static bool RefineKnots(const WPUInt &degree, std::vector<WPFloat> &knots,						//!< Oslo refinement by a sorted or unsorted set of new knots
+												std::vector<WPFloat> &points, const WPUInt &dim, const std::vector<WPFloat> &insert);
+	static WPUInt InsertKnot(const WPUInt &degree, std::vector<WPFloat> &knots,					//!< Insert a knot up to times, returns the count inserted
+												std::vector<WPFloat> &points, const WPUInt &dim, const WPFloat &u, const WPUInt &times);
+	static WPUInt RemoveKnot(const WPUInt &degree, std::vector<WPFloat> &knots,					//!< Remove a knot up to times within tolerance, returns the count removed
+												std::vector<WPFloat> &points, const WPUInt &dim, const WPFloat &u, const WPUInt &times,
+												const WPFloat &tolerance);
+	static WPUInt DecomposeBezier(const WPUInt &degree, std::vector<WPFloat> &knots,				//!< Raise all interior knots to degree, returns the segment count
+												std::vector<WPFloat> &points, const WPUInt &dim);
+	static bool ElevateDegree(WPUInt &degree, std::vector<WPFloat> &knots,							//!< Exact degree elevation by times
+												std::vector<WPFloat> &points, const WPUInt &dim, const WPUInt &times);
+	static bool ReduceDegree(WPUInt &degree, std::vector<WPFloat> &knots,							//!< Degree reduction by one within tolerance, false leaves inputs unchanged
+												std::vector<WPFloat> &points, const WPUInt &dim, const WPFloat &tolerance);
 };
  
 
 /***********************************************~****************************************************/
 
 
+class WCNurbsBasisCache {
+protected:
+	WPUInt										_degree, _numCP, _lod, _der;						//!< Key - degree, control points, samples and derivatives
+	WPFloat										_start, _stop;										//!< Key - parametric range
+	std::vector<WPFloat>						_knotPoints;										//!< Key - knot vector
+	std::vector<WPUInt>							_spans;												//!< Span of each sample
+	std::vector<WPFloat>						_params;											//!< Parametric value of each sample
+	std::vector<WPFloat>						_values;											//!< Basis values (and derivatives) of each sample
+public:
+	//Constructors and Destructors
+	WCNurbsBasisCache() : _degree(0), _numCP(0), _lod(0), _der(0), _start(0.0), _stop(0.0),		//!< Default constructor
+												_knotPoints(), _spans(), _params(), _values() { }
+	~WCNurbsBasisCache()						{ }													//!< Default destructor
+
+	//Member Access Methods
+	inline WPUInt Span(const WPUInt &index) const		{ return this->_spans[index]; }				//!< Get the span of a sample
+	inline WPFloat Parameter(const WPUInt &index) const { return this->_params[index]; }			//!< Get the parametric value of a sample
+	inline const WPFloat* Values(const WPUInt &index) const											//!< Get the basis values of a sample
+												{ return &this->_values[index * (this->_der + 1) * (this->_degree + 1)]; }
+
+	//Original Member Methods
+	bool IsValid(const WPUInt &numCP, const WPUInt &degree, const WPFloat *knotPoints,				//!< Check if the cache matches the key
+												const WPFloat &start, const WPFloat &stop, const WPUInt &lod, const WPUInt &der) const;
+	bool Build(const WPUInt &numCP, const WPUInt &degree, const WPFloat *knotPoints,				//!< Evaluate and store the basis for lod samples
+												const WPFloat &start, const WPFloat &stop, const WPUInt &lod, const WPUInt &der);
+	void Clear(void);																				//!< Release all cached data
+};
+
+
+/***********************************************~****************************************************/
+
+
+/*** Compile-time Bezier evaluation on homogeneous (wx, wy, wz, w) control points.  Point i starts at
+	 hcp[i*stride], so stride 4 walks a packed polygon and larger strides walk a surface column. ***/
+template <WPUInt D>
+class WCBezier {
+public:
+	static inline void Evaluate(const WPFloat *hcp, const WPUInt &stride, const WPFloat &u, WPFloat *point) {
+		//Horner on the Bernstein form: ((P0 s + C(D,1) u P1) s + C(D,2) u^2 P2) s ...
+		WPFloat s = 1.0 - u, fact = 1.0, coef = 1.0, scale;
+		const WPFloat *pt;
+		for (WPUInt k=0; k<4; k++) point[k] = hcp[k] * s;
+		for (WPUInt i=1; i<D; i++) {
+			fact *= u;
+			coef = coef * (WPFloat)(D - i + 1) / (WPFloat)i;
+			scale = fact * coef;
+			pt = hcp + i * stride;
+			for (WPUInt k=0; k<4; k++) point[k] = (point[k] + scale * pt[k]) * s;
+		}
+		scale = fact * u;
+		pt = hcp + D * stride;
+		for (WPUInt k=0; k<4; k++) point[k] += scale * pt[k];
+	}
+	static inline void EvaluateDerivative(const WPFloat *hcp, const WPUInt &stride, const WPFloat &u,
+		WPFloat *point, WPFloat *derivative) {
+		//Run de Casteljau down to the last two points, whose difference is the hodograph
+		WPFloat q[(D+1)*4], s = 1.0 - u;
+		for (WPUInt i=0; i<=D; i++)
+			for (WPUInt k=0; k<4; k++) q[i*4+k] = hcp[i*stride+k];
+		for (WPUInt r=1; r<D; r++)
+			for (WPUInt i=0; i<=D-r; i++)
+				for (WPUInt k=0; k<4; k++) q[i*4+k] = s * q[i*4+k] + u * q[i*4+4+k];
+		for (WPUInt k=0; k<4; k++) {
+			derivative[k] = (WPFloat)D * (q[4+k] - q[k]);
+			point[k] = s * q[k] + u * q[4+k];
+		}
+	}
+	static inline void Subdivide(const WPFloat *hcp, const WPUInt &stride, const WPFloat &u, WPFloat *left, WPFloat *right) {
+		//The triangle edges are the two halves - left and right are packed (stride 4)
+		WPFloat q[(D+1)*4], s = 1.0 - u;
+		for (WPUInt i=0; i<=D; i++)
+			for (WPUInt k=0; k<4; k++) q[i*4+k] = hcp[i*stride+k];
+		for (WPUInt k=0; k<4; k++) {
+			left[k] = q[k];
+			right[D*4+k] = q[D*4+k];
+		}
+		for (WPUInt r=1; r<=D; r++) {
+			for (WPUInt i=0; i<=D-r; i++)
+				for (WPUInt k=0; k<4; k++) q[i*4+k] = s * q[i*4+k] + u * q[i*4+4+k];
+			for (WPUInt k=0; k<4; k++) {
+				left[r*4+k] = q[k];
+				right[(D-r)*4+k] = q[(D-r)*4+k];
+			}
+		}
+	}
+};
+
+
+/***********************************************~****************************************************/
+
+
 }	   // End Wildcat Namespace
 #endif //__NURBS_H__
 
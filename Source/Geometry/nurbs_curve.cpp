@@ -34,6 +34,10 @@
 #include <Geometry/nurbs.h>
 #include <Geometry/geometric_line.h>
 #include <Geometry/ray.h>
+#include <Geometry/bezier_hierarchy.h>
+#include <Utility/tessellation_cache.h>
+#include <Utility/thread_pool.h>
+#include <algorithm>
 
 
 /*** Extern Variables ***/
@@ -42,12 +46,417 @@ extern WPFloat* __bezier_coef[8];
 /*** Locally Defined Values ***/
 //Accuracy Constants
 #define NURBSCURVE_INVERSION_MAX_ITERATIONS		12
+#define NURBSCURVE_INVERSION_MAX_HALVINGS		8
+#define NURBSCURVE_INVERSION_EPSILON			0.000000000001
+#define NURBSCURVE_INVERSION_BLOCK				64			//Points per batch inversion task
 #define NURBSCURVE_EPSILON_ONE					0.0001
 #define NURBSCURVE_EPSILON_TWO					0.0001
 #define NURBSCURVE_EQUALITY_EPSILON				0.001
-#define NURBSCURVE_RENDER_ACCURACY				0.12
+#define NURBSCURVE_RENDER_CHORD					0.002
 #define NURBSCURVE_RENDER_LOWER					0.85
 #define NURBSCURVE_RENDER_UPPER					1.55
+#define NURBSCURVE_GAUSS_MAX_DEPTH				12
+//Tessellation cache kinds
+#define NURBSCURVE_CACHE_CLIENT					0
+#define NURBSCURVE_CACHE_ADAPTIVE				1
+//Basis workspace check
+#if NURBSCURVE_MAX_DEGREE > NURBS_BASIS_MAX_DEGREE
+#error NURBS_BASIS_MAX_DEGREE must be at least NURBSCURVE_MAX_DEGREE
+#endif
+
+
+/***********************************************~***************************************************/
+
+
+template <class T>
+static void _NurbsCurveEvaluateSpans(const WPUInt &degree, const WPUInt &numCP, const WPFloat *knotPoints, const WPFloat *hcp,
+	const bool &uniform, const WPFloat *params, const WPUInt &count, T *data) {
+	WPFloat bv[NURBS_BASIS_MAX_ORDER];
+	WPFloat u, x, y, z, w, *pt;
+	WPFloat uMin = knotPoints[0], uMax = knotPoints[numCP+degree];
+	WPUInt span = 0, i, j;
+	bool haveSpan = false;
+	//Loop through all of the parametric values
+	for (i=0; i<count; i++) {
+		//Get the u value and bound it
+		u = STDMAX(uMin, STDMIN(uMax, params[i]));
+		//Constant time lookup for uniform knots
+		if (uniform) span = WCNurbs::FindUniformSpan(numCP, degree, u, knotPoints);
+		//Otherwise walk forward from the last span (binary search only if moving backwards)
+		else if (!haveSpan || (u < knotPoints[span])) {
+			span = WCNurbs::FindSpan(numCP, degree, u, knotPoints);
+			haveSpan = true;
+		}
+		else while ((span < numCP-1) && (u >= knotPoints[span+1])) span++;
+		//Calculate the basis values
+		WCNurbs::BasisValues(span, u, degree, knotPoints, 0, bv);
+		//Sum the weighted control points
+		x = y = z = w = 0.0;
+		pt = (WPFloat*)hcp + (span - degree) * 4;
+		for (j=0; j<=degree; j++) {
+			x += pt[0] * bv[j];
+			y += pt[1] * bv[j];
+			z += pt[2] * bv[j];
+			w += pt[3] * bv[j];
+			pt += 4;
+		}
+		//Do the w-divide and record the point
+		data[i*4]	= (T)(x / w);
+		data[i*4+1] = (T)(y / w);
+		data[i*4+2] = (T)(z / w);
+		data[i*4+3] = (T)1.0;
+	}
+}
+
+
+template <class T>
+static void _NurbsCurveEvaluateRange(const WPUInt &degree, const WPUInt &numCP, const WPFloat *knotPoints, const WPFloat *hcp,
+	const WPFloat &start, const WPFloat &du, const WPUInt &count, T *data) {
+	WPFloat bv[NURBS_BASIS_MAX_VALUES], coef[NURBS_BASIS_MAX_ORDER][4];
+	WPFloat u, t, x, y, z, w, a=0.0, fact, *pt;
+	WPFloat uMin = knotPoints[0], uMax = knotPoints[numCP+degree];
+	WPUInt span = 0, i, j, k;
+	bool haveSpan = false, newSpan;
+	//Loop through all of the evenly spaced values
+	for (i=0; i<count; i++) {
+		u = STDMAX(uMin, STDMIN(uMax, start + du * i));
+		//Find the first span, then walk forward as u advances
+		newSpan = false;
+		if (!haveSpan || (u < knotPoints[span])) {
+			span = WCNurbs::FindSpan(numCP, degree, u, knotPoints);
+			haveSpan = newSpan = true;
+		}
+		while ((span < numCP-1) && (u >= knotPoints[span+1])) { span++; newSpan = true; }
+		if (newSpan) {
+			//Expand the span into a Taylor polynomial about its first knot
+			a = knotPoints[span];
+			WCNurbs::BasisValues(span, a, degree, knotPoints, degree, bv);
+			fact = 1.0;
+			for (k=0; k<=degree; k++) {
+				if (k > 1) fact *= k;
+				coef[k][0] = coef[k][1] = coef[k][2] = coef[k][3] = 0.0;
+				pt = (WPFloat*)hcp + (span - degree) * 4;
+				for (j=0; j<=degree; j++) {
+					coef[k][0] += pt[0] * bv[k*(degree+1)+j];
+					coef[k][1] += pt[1] * bv[k*(degree+1)+j];
+					coef[k][2] += pt[2] * bv[k*(degree+1)+j];
+					coef[k][3] += pt[3] * bv[k*(degree+1)+j];
+					pt += 4;
+				}
+				coef[k][0] /= fact;
+				coef[k][1] /= fact;
+				coef[k][2] /= fact;
+				coef[k][3] /= fact;
+			}
+		}
+		//Horner evaluation of the span polynomial
+		t = u - a;
+		x = coef[degree][0];
+		y = coef[degree][1];
+		z = coef[degree][2];
+		w = coef[degree][3];
+		for (k=degree; k>0; k--) {
+			x = x * t + coef[k-1][0];
+			y = y * t + coef[k-1][1];
+			z = z * t + coef[k-1][2];
+			w = w * t + coef[k-1][3];
+		}
+		//Do the w-divide and record the point
+		data[i*4]	= (T)(x / w);
+		data[i*4+1] = (T)(y / w);
+		data[i*4+2] = (T)(z / w);
+		data[i*4+3] = (T)1.0;
+	}
+}
+
+
+template <class T>
+static void _NurbsCurveEvaluateLinear(const std::vector<WCVector4> &controlPoints, const WPUInt &numCP,
+	const WPFloat *params, const WPFloat &start, const WPFloat &du, const WPUInt &count, T *data) {
+	WPFloat u, t;
+	WPUInt i, seg;
+	WCVector4 pt;
+	//Degree 1 curves are evenly parameterized polylines
+	for (i=0; i<count; i++) {
+		u = (params != NULL) ? params[i] : start + du * i;
+		u = STDMAX(0.0, STDMIN(1.0, u)) * (numCP - 1);
+		seg = STDMIN((WPUInt)u, numCP - 2);
+		t = u - seg;
+		pt = controlPoints.at(seg) * (1.0 - t) + controlPoints.at(seg+1) * t;
+		data[i*4]	= (T)pt.I();
+		data[i*4+1] = (T)pt.J();
+		data[i*4+2] = (T)pt.K();
+		data[i*4+3] = (T)1.0;
+	}
+}
+
+
+template <class T>
+static void _NurbsCurveEvaluateMany(const WPUInt &degree, const bool &uniform, const WPUInt &numCP, const WPFloat *knotPoints,
+	const std::vector<WCVector4> &controlPoints, const WPFloat *params, const WPFloat &start, const WPFloat &stop,
+	const WPUInt &count, T *data) {
+	//Check for trivial case
+	if ((count == 0) || (data == NULL)) return;
+	WPFloat du = (count > 1) ? (stop - start) / (WPFloat)(count - 1) : 0.0;
+	//Special case for degree 1 curves (no knot vector)
+	if ((degree == 1) || (knotPoints == NULL)) {
+		_NurbsCurveEvaluateLinear(controlPoints, numCP, params, start, du, count, data);
+		return;
+	}
+	//Flatten the control points into homogeneous coordinates once for the batch
+	WPFloat *hcp = new WPFloat[numCP * 4];
+	WCVector4 pt;
+	for (WPUInt i=0; i<numCP; i++) {
+		pt = controlPoints.at(i);
+		hcp[i*4]   = pt.I() * pt.L();
+		hcp[i*4+1] = pt.J() * pt.L();
+		hcp[i*4+2] = pt.K() * pt.L();
+		hcp[i*4+3] = pt.L();
+	}
+	//Evenly spaced values use span polynomials, arbitrary values use the basis functions directly
+	if (params == NULL) _NurbsCurveEvaluateRange(degree, numCP, knotPoints, hcp, start, du, count, data);
+	else _NurbsCurveEvaluateSpans(degree, numCP, knotPoints, hcp, uniform, params, count, data);
+	//Clean up
+	delete [] hcp;
+}
+
+
+static void _NurbsCurveCachedSamples(const WCNurbsBasisCache &cache, const WPUInt &degree, const WPFloat *hcp,
+	const WPUInt &cpOffset, const WPUInt &first, const WPUInt &last, GLfloat *data) {
+	const WPFloat *bv, *pt;
+	WPFloat x, y, z, w;
+	//Multiply the cached basis with the control net (hcp starts at cpOffset) for samples first to last
+	for (WPUInt i=first; i<=last; i++) {
+		bv = cache.Values(i);
+		pt = hcp + (cache.Span(i) - degree - cpOffset) * 4;
+		x = y = z = w = 0.0;
+		for (WPUInt j=0; j<=degree; j++) {
+			x += pt[0] * bv[j];
+			y += pt[1] * bv[j];
+			z += pt[2] * bv[j];
+			w += pt[3] * bv[j];
+			pt += 4;
+		}
+		data[0] = (GLfloat)(x / w);
+		data[1] = (GLfloat)(y / w);
+		data[2] = (GLfloat)(z / w);
+		data[3] = 1.0;
+		data += 4;
+	}
+}
+
+
+struct _NurbsCurveAdaptiveJob {
+	WPUInt										degree, span;
+	const WPFloat								*knotPoints, *hcp;
+	WPFloat										chordSq, cosAngle;
+};
+
+
+static void _NurbsCurveSpanPoint(const _NurbsCurveAdaptiveJob &job, const WPFloat &u, WPFloat *point) {
+	WPFloat bv[NURBS_BASIS_MAX_ORDER], w = 0.0;
+	const WPFloat *pt = job.hcp + (job.span - job.degree) * 4;
+	//The span is known, so go straight to the basis values
+	WCNurbs::BasisValues(job.span, u, job.degree, job.knotPoints, 0, bv);
+	point[0] = point[1] = point[2] = 0.0;
+	for (WPUInt j=0; j<=job.degree; j++) {
+		point[0] += pt[0] * bv[j];
+		point[1] += pt[1] * bv[j];
+		point[2] += pt[2] * bv[j];
+		w += pt[3] * bv[j];
+		pt += 4;
+	}
+	//Do the w-divide
+	point[0] /= w;
+	point[1] /= w;
+	point[2] /= w;
+}
+
+
+static void _NurbsCurveAdaptiveSegment(const _NurbsCurveAdaptiveJob &job, const WPFloat &a, const WPFloat *pa, const WPFloat &b,
+	const WPFloat *pb, const WPUInt &depth, std::vector<WPFloat> &params, std::vector<GLfloat> &verts) {
+	WPFloat m = (a + b) * 0.5, pm[3], chord[3], d1[3], d2[3], t, l1, l2, cc;
+	bool split = false;
+	if (depth < NURBSCURVE_ADAPTIVE_MAX_DEPTH) {
+		_NurbsCurveSpanPoint(job, m, pm);
+		chord[0] = pb[0] - pa[0];	chord[1] = pb[1] - pa[1];	chord[2] = pb[2] - pa[2];
+		d1[0] = pm[0] - pa[0];		d1[1] = pm[1] - pa[1];		d1[2] = pm[2] - pa[2];
+		d2[0] = pb[0] - pm[0];		d2[1] = pb[1] - pm[1];		d2[2] = pb[2] - pm[2];
+		//Chord height - distance from the midpoint to the chord
+		cc = chord[0] * chord[0] + chord[1] * chord[1] + chord[2] * chord[2];
+		t = (cc > 0.0) ? STDMAX(0.0, STDMIN(1.0, (d1[0] * chord[0] + d1[1] * chord[1] + d1[2] * chord[2]) / cc)) : 0.0;
+		l1 = (d1[0] - chord[0] * t) * (d1[0] - chord[0] * t) + (d1[1] - chord[1] * t) * (d1[1] - chord[1] * t) +
+			 (d1[2] - chord[2] * t) * (d1[2] - chord[2] * t);
+		split = (l1 > job.chordSq);
+		//Angle - turn between the two half chords (skip degenerate halves)
+		if (!split) {
+			l1 = d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2];
+			l2 = d2[0] * d2[0] + d2[1] * d2[1] + d2[2] * d2[2];
+			if ((l1 > 0.0) && (l2 > 0.0))
+				split = ((d1[0] * d2[0] + d1[1] * d2[1] + d1[2] * d2[2]) < job.cosAngle * sqrt(l1 * l2));
+		}
+	}
+	//Bisect until within tolerance
+	if (split) {
+		_NurbsCurveAdaptiveSegment(job, a, pa, m, pm, depth+1, params, verts);
+		_NurbsCurveAdaptiveSegment(job, m, pm, b, pb, depth+1, params, verts);
+	}
+	//Otherwise record the start of the segment (the end belongs to the next one)
+	else {
+		params.push_back(a);
+		verts.push_back((GLfloat)pa[0]);
+		verts.push_back((GLfloat)pa[1]);
+		verts.push_back((GLfloat)pa[2]);
+		verts.push_back(1.0);
+	}
+}
+
+
+static void _NurbsCurveAdaptiveSpan(const _NurbsCurveAdaptiveJob &job, std::vector<WPFloat> &params, std::vector<GLfloat> &verts) {
+	WPFloat a = job.knotPoints[job.span], b = job.knotPoints[job.span+1];
+	WPFloat u0 = a, u1, p0[3], p1[3];
+	//Seed with degree+1 segments so an inflection can not hide from the midpoint test
+	_NurbsCurveSpanPoint(job, u0, p0);
+	for (WPUInt k=1; k<=job.degree+1; k++) {
+		u1 = (k == job.degree+1) ? b : a + (b - a) * k / (job.degree + 1);
+		_NurbsCurveSpanPoint(job, u1, p1);
+		_NurbsCurveAdaptiveSegment(job, u0, p0, u1, p1, 0, params, verts);
+		u0 = u1;
+		p0[0] = p1[0];	p0[1] = p1[1];	p0[2] = p1[2];
+	}
+}
+
+
+static WPFloat _NurbsCurveSpanSpeed(const _NurbsCurveAdaptiveJob &job, const WPFloat &u) {
+	WPFloat bv[NURBS_BASIS_MAX_VALUES], a[4] = { 0.0, 0.0, 0.0, 0.0 }, d[4] = { 0.0, 0.0, 0.0, 0.0 };
+	const WPFloat *pt = job.hcp + (job.span - job.degree) * 4;
+	//Values and first derivatives of the basis
+	WCNurbs::BasisValues(job.span, u, job.degree, job.knotPoints, 1, bv);
+	for (WPUInt j=0; j<=job.degree; j++) {
+		for (WPUInt k=0; k<4; k++) {
+			a[k] += pt[k] * bv[j];
+			d[k] += pt[k] * bv[job.degree+1+j];
+		}
+		pt += 4;
+	}
+	//Quotient rule - C' = (A' - w'C) / w
+	WPFloat dx = (d[0] - d[3] * a[0] / a[3]) / a[3];
+	WPFloat dy = (d[1] - d[3] * a[1] / a[3]) / a[3];
+	WPFloat dz = (d[2] - d[3] * a[2] / a[3]) / a[3];
+	return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+
+static WPFloat _NurbsCurveGaussLength(const _NurbsCurveAdaptiveJob &job, const WPFloat &a, const WPFloat &b) {
+	WPFloat mid = (a + b) * 0.5, half = (b - a) * 0.5, sum = 0.0;
+	for (WPUInt i=0; i<NURBS_GAUSS_POINTS; i++)
+		sum += WCNurbs::GaussWeights[i] * _NurbsCurveSpanSpeed(job, mid + half * WCNurbs::GaussNodes[i]);
+	return sum * half;
+}
+
+
+static void _NurbsCurveArcInterval(const _NurbsCurveAdaptiveJob &job, const WPFloat &a, const WPFloat &b, const WPFloat &whole,
+	const WPFloat &tolerance, const WPUInt &depth, std::vector<WPFloat> &params, std::vector<WPFloat> &lengths) {
+	WPFloat mid = (a + b) * 0.5;
+	WPFloat left = _NurbsCurveGaussLength(job, a, mid);
+	WPFloat right = _NurbsCurveGaussLength(job, mid, b);
+	//Accept when the halves agree with the whole
+	if ((depth >= NURBSCURVE_GAUSS_MAX_DEPTH) || (fabs(left + right - whole) <= tolerance)) {
+		params.push_back(b);
+		lengths.push_back(lengths.back() + left + right);
+		return;
+	}
+	_NurbsCurveArcInterval(job, a, mid, left, tolerance * 0.5, depth+1, params, lengths);
+	_NurbsCurveArcInterval(job, mid, b, right, tolerance * 0.5, depth+1, params, lengths);
+}
+
+
+//Shared state for point inversion - the flattened curve, its hierarchy and the batch arrays
+struct _NurbsCurveInversionJob {
+	WPUInt										degree, numCP;
+	const WPFloat								*knotPoints, *hcp;
+	const WCBezierHierarchy						*hierarchy;
+	WPFloat										uMin, uMax;
+	bool										closed;
+	const WPFloat								*points;
+	WPFloat										*params;
+	WPUInt										count;
+};
+
+
+static void _NurbsCurveInversionPoint(const _NurbsCurveInversionJob &job, const WPFloat &u, WPFloat *c, WPFloat *d1, WPFloat *d2) {
+	WPFloat bv[NURBS_BASIS_MAX_VALUES], a[3][4];
+	WPUInt span = WCNurbs::FindSpan(job.numCP, job.degree, u, job.knotPoints), n = job.degree + 1, j, k, i;
+	memset(a, 0, sizeof(a));
+	//Values, first and second derivatives of the homogeneous curve
+	WCNurbs::BasisValues(span, u, job.degree, job.knotPoints, 2, bv);
+	const WPFloat *pt = job.hcp + (span - job.degree) * 4;
+	for (j=0; j<n; j++, pt += 4)
+		for (k=0; k<3; k++)
+			for (i=0; i<4; i++) a[k][i] += pt[i] * bv[k*n+j];
+	//Quotient rule - C = A/w, C' = (A' - w'C)/w, C'' = (A'' - 2w'C' - w''C)/w
+	for (i=0; i<3; i++) {
+		c[i] = a[0][i] / a[0][3];
+		d1[i] = (a[1][i] - a[1][3] * c[i]) / a[0][3];
+		d2[i] = (a[2][i] - 2.0 * a[1][3] * d1[i] - a[2][3] * c[i]) / a[0][3];
+	}
+}
+
+
+static WPFloat _NurbsCurveInvert(const _NurbsCurveInversionJob &job, const WPFloat *point, WPFloat &u) {
+	WPFloat v, c[3], d1[3], d2[3], nc[3], nd1[3], nd2[3], r[3], f, df, speedSq, du, next, dist, nextDist;
+	WPUInt iter, half, i;
+	//Seed from the closest hierarchy piece - global, so no local minimum traps
+	job.hierarchy->Distance(WCVector4(point[0], point[1], point[2], 1.0), u, v);
+	_NurbsCurveInversionPoint(job, u, c, d1, d2);
+	for (i=0; i<3; i++) r[i] = c[i] - point[i];
+	dist = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+	//Newton on C'.(C - P), never letting the distance grow
+	for (iter=0; iter<NURBSCURVE_INVERSION_MAX_ITERATIONS; iter++) {
+		f = d1[0] * r[0] + d1[1] * r[1] + d1[2] * r[2];
+		speedSq = d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2];
+		df = d2[0] * r[0] + d2[1] * r[1] + d2[2] * r[2] + speedSq;
+		//Away from a minimum the full derivative can point the wrong way - drop to Gauss-Newton
+		if (df <= 0.0) df = speedSq;
+		//Degenerate (cusp or stationary point) - keep what we have
+		if (df <= 0.0) break;
+		du = -f / df;
+		//Halve the step until the distance drops, wrapping closed curves and clamping open ones
+		for (half=0; half<NURBSCURVE_INVERSION_MAX_HALVINGS; half++, du *= 0.5) {
+			next = u + du;
+			if (job.closed) {
+				if (next < job.uMin) next += job.uMax - job.uMin;
+				else if (next > job.uMax) next -= job.uMax - job.uMin;
+			}
+			else next = STDMAX(job.uMin, STDMIN(job.uMax, next));
+			_NurbsCurveInversionPoint(job, next, nc, nd1, nd2);
+			nextDist = sqrt((nc[0] - point[0]) * (nc[0] - point[0]) + (nc[1] - point[1]) * (nc[1] - point[1]) +
+				(nc[2] - point[2]) * (nc[2] - point[2]));
+			if (nextDist <= dist) break;
+		}
+		if (half == NURBSCURVE_INVERSION_MAX_HALVINGS) break;
+		du = next - u;
+		u = next;
+		dist = nextDist;
+		for (i=0; i<3; i++) {
+			c[i] = nc[i];
+			d1[i] = nd1[i];
+			d2[i] = nd2[i];
+			r[i] = c[i] - point[i];
+		}
+		//Stop once the step moves the point less than epsilon
+		if (fabs(du) * sqrt(speedSq) < NURBSCURVE_INVERSION_EPSILON) break;
+	}
+	return dist;
+}
+
+
+static void _NurbsCurveInversionTask(void *data, const WPUInt &index) {
+	_NurbsCurveInversionJob *job = (_NurbsCurveInversionJob*)data;
+	WPUInt last = STDMIN(job->count, (index + 1) * NURBSCURVE_INVERSION_BLOCK);
+	for (WPUInt i=index*NURBSCURVE_INVERSION_BLOCK; i<last; i++)
+		_NurbsCurveInvert(*job, job->points + i*4, job->params[i]);
+}
 
 
 /***********************************************~***************************************************/
@@ -393,24 +802,30 @@ GLfloat* WCNurbsCurve::GenerateCurveMedium(const WPFloat &start, const WPFloat &
 	
 
 GLfloat* WCNurbsCurve::GenerateCurveLow(const WPFloat &start, const WPFloat &stop, const WPUInt &lod, const bool &server, GLuint &buffer) {
-	//Setup some variables
-//	WPFloat u = this->_knotPoints[0];
-	WPFloat u = start;
-//	WPFloat range = this->_knotPoints[this->_kp-1] - this->_knotPoints[0];
-	GLfloat range = (GLfloat)(stop - start);
-	WPFloat du = range / ((GLfloat)(lod-1));
-	WCVector4 pt;
 	GLuint size = lod * NURBSCURVE_FLOATS_PER_VERTEX;
 	//Create a temporary array (LOD vertices)
 	GLfloat *data = new GLfloat[size];
-	for (WPUInt i=0; i<lod; i++) {
-		pt = this->Evaluate(u);
-		data[i*4] =   (GLfloat)pt.I();
-		data[i*4+1] = (GLfloat)pt.J();
-		data[i*4+2] = (GLfloat)pt.K();
-		data[i*4+3] = (GLfloat)pt.L();
-		//Increment u (up to kp-1)
-		u = STDMIN(u+du, this->_knotPoints[this->_kp-1]);				
+	//Basis only depends on knots, degree and lod - reuse it when just the control points have moved
+	if ((this->_knotPoints == NULL) || 
+		(!this->_basisCache.IsValid(this->_cp, this->_degree, this->_knotPoints, start, stop, lod, 0) &&
+		 !this->_basisCache.Build(this->_cp, this->_degree, this->_knotPoints, start, stop, lod, 0))) {
+		//Fall back to direct evaluation
+		this->EvaluateMany(start, stop, lod, data);
+	}
+	else {
+		//Flatten the control points into homogeneous coordinates
+		WPFloat *hcp = new WPFloat[this->_cp * 4];
+		WCVector4 cp;
+		for (WPUInt i=0; i<this->_cp; i++) {
+			cp = this->_controlPoints.at(i);
+			hcp[i*4]   = cp.I() * cp.L();
+			hcp[i*4+1] = cp.J() * cp.L();
+			hcp[i*4+2] = cp.K() * cp.L();
+			hcp[i*4+3] = cp.L();
+		}
+		//Multiply the cached basis with the control net
+		_NurbsCurveCachedSamples(this->_basisCache, this->_degree, hcp, 0, 0, lod-1, data);
+		delete [] hcp;
 	}
 /*** Debug ***
 	 std::cout << "Generate Low Verts: " << lod << std::endl;	
@@ -509,13 +924,108 @@ GLfloat* WCNurbsCurve::GenerateCurveOne(const bool &server, GLuint &buffer) {
 }
 
 
+void WCNurbsCurve::GenerateCurveAdaptive(const WPFloat &chordTolerance, GLuint &buffer) {
+	//Clean spans can be copied over if only a range of control points has moved since the last pass
+	bool partial = !this->_isFullyDirty && (this->_dirtyLow <= this->_dirtyHigh) && (buffer != 0) &&
+		(this->_altBuffer != NULL) && (this->_spanStarts.size() == this->_cp + 1);
+	//Flatten the control points into homogeneous coordinates
+	WPFloat *hcp = new WPFloat[this->_cp * 4];
+	WCVector4 cp;
+	for (WPUInt i=0; i<this->_cp; i++) {
+		cp = this->_controlPoints.at(i);
+		hcp[i*4]   = cp.I() * cp.L();
+		hcp[i*4+1] = cp.J() * cp.L();
+		hcp[i*4+2] = cp.K() * cp.L();
+		hcp[i*4+3] = cp.L();
+	}
+	_NurbsCurveAdaptiveJob job;
+	job.degree = this->_degree;
+	job.knotPoints = this->_knotPoints;
+	job.hcp = hcp;
+	job.chordSq = chordTolerance * chordTolerance;
+	job.cosAngle = cos(NURBSCURVE_ADAPTIVE_ANGLE * M_PI / 180.0);
+	std::vector<WPFloat> params;
+	std::vector<GLfloat> verts;
+	std::vector<WPUInt> spanStarts(this->_cp + 1, 0);
+	WPUInt i, first, last;
+	//Loop through all non-empty knot spans
+	for (job.span=this->_degree; job.span<this->_cp; job.span++) {
+		spanStarts[job.span] = (WPUInt)params.size();
+		if (this->_knotPoints[job.span] >= this->_knotPoints[job.span+1]) continue;
+		//Control point k only affects spans k to k+degree
+		if (partial && ((job.span < this->_dirtyLow) || (job.span > this->_dirtyHigh + this->_degree))) {
+			first = this->_spanStarts[job.span];
+			last = this->_spanStarts[job.span+1];
+			params.insert(params.end(), this->_params.begin() + first, this->_params.begin() + last);
+			verts.insert(verts.end(), this->_altBuffer + first * 4, this->_altBuffer + last * 4);
+		}
+		else _NurbsCurveAdaptiveSpan(job, params, verts);
+	}
+	//Close with the end of the last span
+	WPFloat end[3];
+	job.span = this->_cp - 1;
+	spanStarts[this->_cp] = (WPUInt)params.size();
+	_NurbsCurveSpanPoint(job, this->_knotPoints[this->_cp], end);
+	params.push_back(this->_knotPoints[this->_cp]);
+	verts.push_back((GLfloat)end[0]);
+	verts.push_back((GLfloat)end[1]);
+	verts.push_back((GLfloat)end[2]);
+	verts.push_back(1.0);
+	delete [] hcp;
+
+	//Gen buffer if needed and bind to it
+	if (!buffer) glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	//Same vertex count - upload only the dirty spans (plus the vertex that closes them)
+	if (partial && (params.size() == this->_lod)) {
+		first = spanStarts[STDMAX(this->_dirtyLow, this->_degree)];
+		last = spanStarts[STDMIN(this->_dirtyHigh + this->_degree + 1, this->_cp)];
+		glBufferSubData(GL_ARRAY_BUFFER, first * NURBSCURVE_FLOATS_PER_VERTEX * sizeof(GLfloat),
+			(last - first + 1) * NURBSCURVE_FLOATS_PER_VERTEX * sizeof(GLfloat), &verts[first * 4]);
+	}
+	//Otherwise replace the whole buffer
+	else glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(GLfloat), &verts[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	//Keep a CPU copy so the next control point edit can reuse the clean spans
+	this->ReleaseBuffer(this->_altBuffer);
+	this->_altBuffer = new GLfloat[verts.size()];
+	for (i=0; i<verts.size(); i++) this->_altBuffer[i] = verts[i];
+	this->_params.swap(params);
+	this->_spanStarts.swap(spanStarts);
+	this->_tolerance = chordTolerance;
+	this->_lod = (WPUInt)this->_params.size();
+	//Check for errors
+	if (glGetError() != GL_NO_ERROR) CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::GenerateCurveAdaptive - GL error at Cleanup.");
+}
+
+
+void WCNurbsCurve::MarkControlPointsDirty(const WPUInt &low, const WPUInt &high) {
+	//Grow the dirty range (unless the whole curve is already dirty)
+	if (!this->_isFullyDirty) {
+		if (this->_dirtyLow > this->_dirtyHigh) {
+			this->_dirtyLow = low;
+			this->_dirtyHigh = high;
+		}
+		else {
+			this->_dirtyLow = STDMIN(this->_dirtyLow, low);
+			this->_dirtyHigh = STDMAX(this->_dirtyHigh, high);
+		}
+	}
+	//Bypass the override so the range is kept
+	this->_revision++;
+	this->WCVisualObject::IsVisualDirty(true);
+}
+
+
 /***********************************************~***************************************************/
 
 
 WCNurbsCurve::WCNurbsCurve(WCGeometryContext *context, const WPUInt &degree, const std::vector<WCVector4> &controlPoints, 
 	const WCNurbsMode &mode, const std::vector<WPFloat> &knotPoints) : ::WCGeometricCurve(context),
 	_degree(degree), _mode(mode), _cp((WPUInt)controlPoints.size()), _kp(0), _controlPoints(controlPoints), _knotPoints(NULL),
-	_length(0.0), _lod(0), _buffer(0), _altBuffer(NULL) {
+	_length(0.0), _lod(0), _buffer(0), _altBuffer(NULL), _tolerance(0.0), _params(), _spanStarts(), _isFullyDirty(true), _dirtyLow(1), _dirtyHigh(0), _revision(0),
+	_arcTolerance(0.0), _arcRevision(0), _arcParams(), _arcLengths(), _arcHcp(),
+	_bezierRevision(0), _bezierPoints(), _bezierBreaks(), _hierarchy(NULL), _hierarchyRevision(0) {
 	//Make sure cpCollection is non-null
 	if (this->_cp == 0) { CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::WCNurbsCurve - Empty control points vector."); return;	}
 	//Check to make sure there are at least 2 control points
@@ -552,7 +1062,9 @@ WCNurbsCurve::WCNurbsCurve(WCGeometryContext *context, const WPUInt &degree, con
 WCNurbsCurve::WCNurbsCurve(const WCNurbsCurve &curve) :
 	::WCGeometricCurve(curve), _degree(curve._degree), _mode(curve._mode),
 	_cp(curve._cp), _kp(curve._kp), _controlPoints(curve._controlPoints), _knotPoints(NULL),
-	_length(curve._length), _lod(0), _buffer(0), _altBuffer(NULL) {
+	_length(curve._length), _lod(0), _buffer(0), _altBuffer(NULL), _tolerance(0.0), _params(), _spanStarts(), _isFullyDirty(true), _dirtyLow(1), _dirtyHigh(0), _revision(0),
+	_arcTolerance(0.0), _arcRevision(0), _arcParams(), _arcLengths(), _arcHcp(),
+	_bezierRevision(0), _bezierPoints(), _bezierBreaks(), _hierarchy(NULL), _hierarchyRevision(0) {
 	//Do some more setup only if degree is not 1
 	if (this->_degree != 1) {
 		//Set up the knot vector
@@ -572,7 +1084,9 @@ WCNurbsCurve::WCNurbsCurve(const WCNurbsCurve &curve) :
 WCNurbsCurve::WCNurbsCurve(xercesc::DOMElement *element, WCSerialDictionary *dictionary) : 
 	::WCGeometricCurve( WCSerializeableObject::ElementFromName(element,"GeometricCurve"), dictionary ),
 	_degree(), _mode(WCNurbsMode::Default()), _cp(), _kp(), _controlPoints(), _knotPoints(),
-	_length(0.0), _lod(0), _buffer(0), _altBuffer(NULL) {
+	_length(0.0), _lod(0), _buffer(0), _altBuffer(NULL), _tolerance(0.0), _params(), _spanStarts(), _isFullyDirty(true), _dirtyLow(1), _dirtyHigh(0), _revision(0),
+	_arcTolerance(0.0), _arcRevision(0), _arcParams(), _arcLengths(), _arcHcp(),
+	_bezierRevision(0), _bezierPoints(), _bezierBreaks(), _hierarchy(NULL), _hierarchyRevision(0) {
 	//Make sure element if not null
 	if (element == NULL) {
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::WCNurbsCurve - NULL Element passed.");
@@ -649,6 +1163,10 @@ WCNurbsCurve::~WCNurbsCurve() {
 	//See if need to Delete the buffers
 	this->ReleaseBuffer(this->_buffer);
 	this->ReleaseBuffer(this->_altBuffer);
+	//Drop any cached tessellations
+	WCTessellationCache::Shared()->Invalidate(this);
+	//Delete the bounding hierarchy
+	if (this->_hierarchy != NULL) delete this->_hierarchy;
 	//Delete the knot point array
 	if (this->_knotPoints) delete this->_knotPoints;
 }
@@ -660,14 +1178,33 @@ void WCNurbsCurve::ControlPoints(const std::vector<WCVector4> &controlPoints) {
 		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsCurve::ControlPoints - Wrong number of points.");
 		return;
 	}
+	//Find the range of control points that actually changed
+	WPUInt low = this->_cp, high = 0;
+	for (WPUInt i=0; i<this->_cp; i++) {
+		if (this->_controlPoints.at(i) != controlPoints.at(i)) {
+			low = STDMIN(low, i);
+			high = i;
+		}
+	}
+	//Nothing to do if nothing changed
+	if (low > high) return;
 	//Update control points
 	this->_controlPoints = controlPoints;
-	//Mark the object as dirty
-	this->IsVisualDirty(true);
+	//Only the spans touching the changed points need regenerating
+	this->MarkControlPointsDirty(low, high);
 	this->IsSerialDirty(true);
 }
 
 
+void WCNurbsCurve::IsVisualDirty(const bool &status) {
+	//Any general change means a full regeneration, clean means nothing is pending
+	this->_isFullyDirty = status;
+	this->_dirtyLow = 1;
+	this->_dirtyHigh = 0;
+	this->WCVisualObject::IsVisualDirty(status);
+}
+
+
 void WCNurbsCurve::KnotPoints(const std::vector<WPFloat> &knotPoints) {
 	//Make sure number of knot points is the same
 	if (knotPoints.size() != this->_kp) {
@@ -679,6 +1216,7 @@ void WCNurbsCurve::KnotPoints(const std::vector<WPFloat> &knotPoints) {
 	//Update knot points
 	this->_knotPoints = WCNurbs::LoadCustomKnotPoints(knotPoints);
 	//Mark the object as dirty
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 }
@@ -712,6 +1250,7 @@ WPUInt WCNurbsCurve::Degree(const WPUInt &degree) {
 		this->LoadKnotPoints();
 	}
 	//Mark the object as dirty
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 	//Return the degree value
@@ -720,6 +1259,34 @@ WPUInt WCNurbsCurve::Degree(const WPUInt &degree) {
 
 
 WCVisualObject* WCNurbsCurve::HitTest(const WCRay &ray, const WPFloat &tolerance) {
+	const WCBezierHierarchy *hierarchy = this->Hierarchy();
+	if (hierarchy == NULL) return NULL;
+	//Only pieces whose boxes come within reach of the ray need a closer look
+	WPFloat reach = tolerance + hierarchy->Tolerance();
+	std::vector<WPUInt> pieces;
+	hierarchy->RayQuery(ray.Base(), ray.Direction(), reach, pieces);
+	WCVector4 base = ray.Base(), dir = ray.Direction();
+	dir.L(0.0);
+	WPFloat dd = dir.DotProduct(dir);
+	if (dd == 0.0) return NULL;
+	WPUInt p = hierarchy->DegreeU();
+	for (WPUInt i=0; i<pieces.size(); i++) {
+		//Pieces are flat to the hierarchy tolerance - test the ray against their chord
+		const WPFloat *hcp = hierarchy->PiecePoints(pieces.at(i));
+		WCVector4 a(hcp[0] / hcp[3], hcp[1] / hcp[3], hcp[2] / hcp[3], 0.0);
+		WCVector4 b(hcp[p*4] / hcp[p*4+3], hcp[p*4+1] / hcp[p*4+3], hcp[p*4+2] / hcp[p*4+3], 0.0);
+		WCVector4 e = b - a, w = a - base;
+		w.L(0.0);
+		WPFloat ee = e.DotProduct(e), de = dir.DotProduct(e), dw = dir.DotProduct(w), ew = e.DotProduct(w);
+		WPFloat denom = dd * ee - de * de, s = 0.0;
+		//Closest chord parameter to the ray line, then the ray parameter for that
+		if ((ee > 0.0) && (denom > 1.0e-12 * dd * ee)) s = STDMAX(0.0, STDMIN(1.0, (de * dw - dd * ew) / denom));
+		WCVector4 q = a + e * s;
+		WPFloat t = STDMAX(0.0, dir.DotProduct(q - base) / dd);
+		WCVector4 gap = q - (base + dir * t);
+		gap.L(0.0);
+		if (gap.Magnitude() <= reach) return this;
+	}
 	return NULL;
 }
 
@@ -729,6 +1296,7 @@ void WCNurbsCurve::ApplyTransform(const WCMatrix4 &transform) {
 	for (WPUInt i=0; i<this->_cp; i++)
 		this->_controlPoints.at(i) = transform * this->_controlPoints.at(i);
 	//Make sure curve is regenerated
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 }
@@ -739,6 +1307,7 @@ void WCNurbsCurve::ApplyTranslation(const WCVector4 &translation) {
 	for (WPUInt i=0; i<this->_cp; i++)
 		this->_controlPoints.at(i) = this->_controlPoints.at(i) + translation;
 	//Make sure curve is regenerated
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 }
@@ -748,21 +1317,29 @@ void WCNurbsCurve::Render(const GLuint &defaultProg, const WCColor &color, const
 	//Do nothing if not visible
 	if (!this->_isVisible) return;
 
-	//Determine best LOD
-	WPUInt lod = (WPUInt)STDMAX((WPFloat)this->_cp, this->_length * sqrt(zoom) / NURBSCURVE_RENDER_ACCURACY);
-	WPFloat factor = (WPFloat)this->_lod / (WPFloat)lod;
-	//See if need to regenerate
-	if ((factor < NURBSCURVE_RENDER_LOWER) || (factor > NURBSCURVE_RENDER_UPPER))  {
-		//Set the new lod
-		this->_lod = lod;
-		//Mark as dirty
-		this->IsVisualDirty(true);
+	//Degree 1 curves are drawn as their control polygon
+	if (this->_degree == 1) {
+		if (this->IsVisualDirty()) {
+			this->GenerateServerBuffer(0.0, 1.0, this->_lod, this->_buffer, true);
+			this->IsVisualDirty(false);
+		}
 	}
-	//Check to see if curve needs to be generated
-	if (this->IsVisualDirty()) {
-		this->GenerateServerBuffer(0.0, 1.0, this->_lod, this->_buffer, true);
-		//Mark as clean
-		this->IsVisualDirty(false);
+	//Otherwise tessellate to a chord height that shrinks as the view zooms in
+	else {
+		WPFloat tolerance = NURBSCURVE_RENDER_CHORD / STDMAX(zoom, NURBSCURVE_EPSILON_ONE);
+		WPFloat factor = this->_tolerance / tolerance;
+		//See if need to regenerate
+		if ((factor < NURBSCURVE_RENDER_LOWER) || (factor > NURBSCURVE_RENDER_UPPER)) {
+			//Set the new tolerance and mark as dirty
+			this->_tolerance = tolerance;
+			this->IsVisualDirty(true);
+		}
+		//Check to see if curve needs to be generated (only the dirty spans if possible)
+		if (this->IsVisualDirty()) {
+			this->GenerateCurveAdaptive(this->_tolerance, this->_buffer);
+			//Mark as clean
+			this->IsVisualDirty(false);
+		}
 	}
 
 	//Set the rendering program
@@ -803,6 +1380,7 @@ void WCNurbsCurve::Render(const GLuint &defaultProg, const WCColor &color, const
 
 void WCNurbsCurve::ReceiveNotice(WCObjectMsg msg, WCObject *sender) {
 	//Something has changed in the control points - mark as dirty
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 	//Update Length estimate in case length changed
@@ -812,32 +1390,132 @@ void WCNurbsCurve::ReceiveNotice(WCObjectMsg msg, WCObject *sender) {
 }
 
 
+WPHash WCNurbsCurve::ContentHash(void) {
+	WCContentHash hash;
+	hash.Add(this->_degree);
+	hash.Add(this->_cp);
+	//Knot vector and control points
+	if (this->_knotPoints != NULL) for (WPUInt i=0; i<this->_kp; i++) hash.Add(this->_knotPoints[i]);
+	for (WPUInt i=0; i<this->_controlPoints.size(); i++) hash.Add(this->_controlPoints.at(i));
+	return hash.Value();
+}
+
+
 WPFloat WCNurbsCurve::Length(const WPFloat &tolerance) {
-	//Check if serial dirty or length set to 0.0
-	if (this->IsSerialDirty() || this->_length == 0.0) {
-		//Estimate the length of the curve and needed LOD
-		WPFloat length = WCNurbs::EstimateLength(this->_controlPoints);
-		WPUInt lod = (WPUInt)(length / tolerance);
-		//Get client buffer of vertex data
-		GLfloat *verts = this->GenerateClientBuffer(0.0, 1.0, lod, true);
-		//Set up points
-		WCVector4 p0(verts[0], verts[1], verts[2], verts[3]), p1;
-		//Loop through the vertex data
-		for (WPUInt i=1; i<this->_lod; i++) {
-			p1 = WCVector4(verts[i*4], verts[i*4+1], verts[i*4+2], 1.0);
-			length += p1.Distance(p0);
-			p0 = p1;
-		}
-		//Make sure to delete the vert data
-		this->ReleaseBuffer(verts);
-		//Set the length
-		this->_length = length;
-	}
+	//Integrate |C'(u)| span by span (reuses the table if still good)
+	this->BuildArcLengthTable(tolerance);
+	//Set the length
+	this->_length = this->_arcLengths.back();
 	//Return the length
 	return this->_length;
 }
 
 
+WPFloat WCNurbsCurve::LengthAtParameter(const WPFloat &u, const WPFloat &tolerance) {
+	this->BuildArcLengthTable(tolerance);
+	//Clamp to the parametric range
+	if (u <= this->_arcParams.front()) return 0.0;
+	if (u >= this->_arcParams.back()) return this->_arcLengths.back();
+	//Find the table interval, then integrate the rest of the way
+	WPUInt i = (WPUInt)(std::upper_bound(this->_arcParams.begin(), this->_arcParams.end(), u) - this->_arcParams.begin()) - 1;
+	WPFloat a = this->_arcParams.at(i);
+	if (u == a) return this->_arcLengths.at(i);
+	//Polyline segments have constant speed
+	if ((this->_degree == 1) || (this->_knotPoints == NULL)) return this->_arcLengths.at(i) + (this->_arcLengths.at(i+1) - this->_arcLengths.at(i)) *
+		(u - a) / (this->_arcParams.at(i+1) - a);
+	_NurbsCurveAdaptiveJob job = { this->_degree, WCNurbs::FindSpan(this->_cp, this->_degree, (a + u) * 0.5, this->_knotPoints),
+		this->_knotPoints, &this->_arcHcp[0], 0.0, 0.0 };
+	return this->_arcLengths.at(i) + _NurbsCurveGaussLength(job, a, u);
+}
+
+
+WPFloat WCNurbsCurve::ParameterAtLength(const WPFloat &length, const WPFloat &tolerance) {
+	this->BuildArcLengthTable(tolerance);
+	//Clamp to the length of the curve
+	if (length <= 0.0) return this->_arcParams.front();
+	if (length >= this->_arcLengths.back()) return this->_arcParams.back();
+	//Find the table interval holding this length
+	WPUInt i = (WPUInt)(std::upper_bound(this->_arcLengths.begin(), this->_arcLengths.end(), length) - this->_arcLengths.begin()) - 1;
+	WPFloat lo = this->_arcParams.at(i), hi = this->_arcParams.at(i+1);
+	WPFloat base = this->_arcLengths.at(i), target = length - base;
+	WPFloat span = this->_arcLengths.at(i+1) - base;
+	if (span <= 0.0) return lo;
+	if ((this->_degree == 1) || (this->_knotPoints == NULL)) return lo + (hi - lo) * target / span;
+	_NurbsCurveAdaptiveJob job = { this->_degree, WCNurbs::FindSpan(this->_cp, this->_degree, (lo + hi) * 0.5, this->_knotPoints),
+		this->_knotPoints, &this->_arcHcp[0], 0.0, 0.0 };
+	//Newton on s(u) - length, falling back to bisection to stay in the bracket
+	WPFloat a = lo, u = lo + (hi - lo) * target / span, f, speed;
+	for (WPUInt iter=0; iter<NURBSCURVE_INVERSION_MAX_ITERATIONS; iter++) {
+		f = _NurbsCurveGaussLength(job, a, u) - target;
+		if (fabs(f) <= tolerance * 0.01) break;
+		if (f > 0.0) hi = u;
+		else lo = u;
+		speed = _NurbsCurveSpanSpeed(job, u);
+		u = (speed > 0.0) ? u - f / speed : lo - 1.0;
+		if ((u <= lo) || (u >= hi)) u = (lo + hi) * 0.5;
+	}
+	return u;
+}
+
+
+std::vector<WPFloat> WCNurbsCurve::ParametersByLength(const WPUInt &count, const WPFloat &tolerance) {
+	std::vector<WPFloat> params;
+	if (count < 2) return params;
+	//Equal arc length steps, ends taken exactly
+	WPFloat length = this->Length(tolerance);
+	params.push_back(this->_arcParams.front());
+	for (WPUInt i=1; i<count-1; i++) params.push_back(this->ParameterAtLength(length * i / (count - 1), tolerance));
+	params.push_back(this->_arcParams.back());
+	return params;
+}
+
+
+void WCNurbsCurve::BuildArcLengthTable(const WPFloat &tolerance) {
+	//Still good for this revision and at least as tight as asked for
+	if ((this->_arcTolerance > 0.0) && (this->_arcRevision == this->_revision) && (this->_arcTolerance <= tolerance)) return;
+	//Degree 1 curves are evenly parameterized polylines with no knot vector - the table is exact
+	if ((this->_degree == 1) || (this->_knotPoints == NULL)) {
+		this->_arcParams.assign(1, 0.0);
+		this->_arcLengths.assign(1, 0.0);
+		WCVector4 chord;
+		for (WPUInt i=1; i<this->_cp; i++) {
+			chord = this->_controlPoints.at(i) - this->_controlPoints.at(i-1);
+			this->_arcParams.push_back((WPFloat)i / (WPFloat)(this->_cp - 1));
+			this->_arcLengths.push_back(this->_arcLengths.back() + sqrt(chord.I() * chord.I() + chord.J() * chord.J() + chord.K() * chord.K()));
+		}
+		this->_arcTolerance = tolerance;
+		this->_arcRevision = this->_revision;
+		return;
+	}
+	//Flatten the control points into homogeneous coordinates
+	this->_arcHcp.resize(this->_cp * 4);
+	WCVector4 cp;
+	for (WPUInt i=0; i<this->_cp; i++) {
+		cp = this->_controlPoints.at(i);
+		this->_arcHcp[i*4]   = cp.I() * cp.L();
+		this->_arcHcp[i*4+1] = cp.J() * cp.L();
+		this->_arcHcp[i*4+2] = cp.K() * cp.L();
+		this->_arcHcp[i*4+3] = cp.L();
+	}
+	_NurbsCurveAdaptiveJob job = { this->_degree, 0, this->_knotPoints, &this->_arcHcp[0], 0.0, 0.0 };
+	this->_arcParams.assign(1, this->_knotPoints[this->_degree]);
+	this->_arcLengths.assign(1, 0.0);
+	//Share the tolerance between the non-empty spans
+	WPUInt numSpans = 0;
+	for (job.span=this->_degree; job.span<this->_cp; job.span++)
+		if (this->_knotPoints[job.span] < this->_knotPoints[job.span+1]) numSpans++;
+	WPFloat spanTolerance = tolerance / STDMAX(numSpans, (WPUInt)1);
+	WPFloat a, b;
+	for (job.span=this->_degree; job.span<this->_cp; job.span++) {
+		a = this->_knotPoints[job.span];
+		b = this->_knotPoints[job.span+1];
+		if (a < b) _NurbsCurveArcInterval(job, a, b, _NurbsCurveGaussLength(job, a, b), spanTolerance, 0, this->_arcParams, this->_arcLengths);
+	}
+	this->_arcTolerance = tolerance;
+	this->_arcRevision = this->_revision;
+}
+
+
 WCVector4 WCNurbsCurve::Evaluate(const WPFloat &u) {
 	WCVector4 c;
 	WPFloat eval = u;
@@ -847,38 +1525,17 @@ WCVector4 WCNurbsCurve::Evaluate(const WPFloat &u) {
 
 	//Bezier case
 	if (this->_mode == WCNurbsMode::Bezier()) {
-		WCMatrix n(this->_degree+1, this->_degree+1, __bezier_coef[this->_degree]);
-		WPFloat *pts = new WPFloat[(this->_degree+1)*4];
-		WCVector w(this->_degree+1, 0.0);
-		WCVector4 tmpVec;
+		//Flatten the homogeneous control points and run the degree-specialized evaluator
+		WPFloat hcp[NURBS_BASIS_MAX_ORDER*4], pt[4];
 		for (WPUInt i=0; i<=this->_degree; i++) {
-			tmpVec = this->_controlPoints.at(i);
-			pts[i*4]	= tmpVec.I(); 
-			pts[i*4+1]	= tmpVec.J(); 
-			pts[i*4+2]	= tmpVec.K(); 
-			pts[i*4+3]	= tmpVec.L();
-			w.Set(i, tmpVec.L());
-		}
-		WCMatrix g(this->_degree+1, 4, pts);
-		delete pts;
-		WCMatrix ng = n * g;
-		//Calculate t vector
-		WCVector t(this->_degree+1, 1.0);			
-		WPFloat mag = eval;
-		//Setup t vector
-		for (int j=this->_degree-1; j>=0; j--) {
-			t.Set(j, mag);
-			mag *= u;
+			hcp[i*4]	= this->_controlPoints.at(i).I() * this->_controlPoints.at(i).L();
+			hcp[i*4+1]	= this->_controlPoints.at(i).J() * this->_controlPoints.at(i).L();
+			hcp[i*4+2]	= this->_controlPoints.at(i).K() * this->_controlPoints.at(i).L();
+			hcp[i*4+3]	= this->_controlPoints.at(i).L();
 		}
-		//Calculate the point
-		c = (t * ng).ToVector4();
-		//Calculate w
-//		WPFloat wFloat = t.DotProduct(n * w);
-//		std::cout << w << std::endl;
-//		std::cout << wFloat << std::endl;
-//		std::cout << c << std::endl;
-//		c /= c.L();
-//		c.L(1.0);
+		if (!WCNurbs::EvaluateBezier(this->_degree, hcp, 4, eval, pt)) return c;
+		//Do the w-divide
+		c.Set(pt[0] / pt[3], pt[1] / pt[3], pt[2] / pt[3], 1.0);
 		return c;
 	}
 	//Default & custom case
@@ -887,9 +1544,9 @@ WCVector4 WCNurbsCurve::Evaluate(const WPFloat &u) {
 		WPUInt span = WCNurbs::FindSpan(this->_cp, this->_degree, eval, this->_knotPoints);
 		WCVector4 c, p0;
 
-		WPFloat* basisValues = WCNurbs::BasisValues(span, eval, this->_degree, this->_knotPoints);
+		WPFloat basisValues[NURBS_BASIS_MAX_ORDER];
 		//Return if error
-		if (basisValues == NULL) return WCVector4();
+		if (!WCNurbs::BasisValues(span, eval, this->_degree, this->_knotPoints, 0, basisValues)) return WCVector4();
 		WPFloat w = 0.0;
 		//Evaluate the point
 		for(WPUInt j=0; j<=this->_degree; j++) {
@@ -897,8 +1554,6 @@ WCVector4 WCNurbsCurve::Evaluate(const WPFloat &u) {
 			w += p0.L() * basisValues[j];
 			c += p0 * p0.L() * basisValues[j];
 		}
-		//Make sure to delete basis values
-		delete basisValues;		
 		//Do the w-divide
 		c = c / w;
 		//Set W = 1.0
@@ -912,6 +1567,28 @@ WCVector4 WCNurbsCurve::Evaluate(const WPFloat &u) {
 }
 
 
+void WCNurbsCurve::EvaluateMany(const WPFloat *params, const WPUInt &count, GLfloat *data) {
+	_NurbsCurveEvaluateMany(this->_degree, this->_mode == WCNurbsMode::Default(), this->_cp, this->_knotPoints, this->_controlPoints, params, 0.0, 0.0, count, data);
+}
+
+
+void WCNurbsCurve::EvaluateMany(const WPFloat *params, const WPUInt &count, WPFloat *data) {
+	_NurbsCurveEvaluateMany(this->_degree, this->_mode == WCNurbsMode::Default(), this->_cp, this->_knotPoints, this->_controlPoints, params, 0.0, 0.0, count, data);
+}
+
+
+void WCNurbsCurve::EvaluateMany(const WPFloat &start, const WPFloat &stop, const WPUInt &count, GLfloat *data) {
+	_NurbsCurveEvaluateMany(this->_degree, this->_mode == WCNurbsMode::Default(), this->_cp, this->_knotPoints, this->_controlPoints,
+		(const WPFloat*)NULL, start, stop, count, data);
+}
+
+
+void WCNurbsCurve::EvaluateMany(const WPFloat &start, const WPFloat &stop, const WPUInt &count, WPFloat *data) {
+	_NurbsCurveEvaluateMany(this->_degree, this->_mode == WCNurbsMode::Default(), this->_cp, this->_knotPoints, this->_controlPoints,
+		(const WPFloat*)NULL, start, stop, count, data);
+}
+
+
 /*** Need to normalize rational derivatives ***/
 WCVector4 WCNurbsCurve::Derivative(const WPFloat &u, const WPUInt &der) {
 	WPFloat eval = u;
@@ -924,9 +1601,9 @@ WCVector4 WCNurbsCurve::Derivative(const WPFloat &u, const WPUInt &der) {
 
 	//Now find the derivative of the curve at the point
 	WPUInt span = WCNurbs::FindSpan(this->_cp, this->_degree, eval, this->_knotPoints);
-	WPFloat* basisValues = WCNurbs::BasisValues(span, eval, this->_degree, this->_knotPoints, der);
+	WPFloat basisValues[NURBS_BASIS_MAX_VALUES];
 	//Return if error
-	if (basisValues == NULL) return WCVector4();	
+	if (!WCNurbs::BasisValues(span, eval, this->_degree, this->_knotPoints, derivative, basisValues)) return WCVector4();
 	
 	//Declare some temparary values
 	WCVector4 c;
@@ -951,8 +1628,6 @@ WCVector4 WCNurbsCurve::Derivative(const WPFloat &u, const WPUInt &der) {
 	c = c / w;
 	//Set W = 1.0
 	c.L(1.0);
-	//Make sure to delete the basisValues array
-	delete basisValues;
 	//Return the derivative vector
 	return c;		
 }
@@ -967,10 +1642,28 @@ WCRay WCNurbsCurve::Tangent(const WPFloat &u) {
 	if (eval < this->_knotPoints[0]) eval = this->_knotPoints[0];
 	if (eval > this->_knotPoints[this->_kp-1]) eval = this->_knotPoints[this->_kp-1];
 
+	//Bezier curves use the degree-specialized de Casteljau evaluator
+	if (this->_mode == WCNurbsMode::Bezier()) {
+		WPFloat hcp[NURBS_BASIS_MAX_ORDER*4], pt[4], der[4];
+		for (WPUInt i=0; i<=this->_degree; i++) {
+			hcp[i*4]	= this->_controlPoints.at(i).I() * this->_controlPoints.at(i).L();
+			hcp[i*4+1]	= this->_controlPoints.at(i).J() * this->_controlPoints.at(i).L();
+			hcp[i*4+2]	= this->_controlPoints.at(i).K() * this->_controlPoints.at(i).L();
+			hcp[i*4+3]	= this->_controlPoints.at(i).L();
+		}
+		if (!WCNurbs::EvaluateBezierDerivative(this->_degree, hcp, 4, eval, pt, der)) return WCRay(WCVector4(), WCVector4());
+		WCVector4 n(pt[0], pt[1], pt[2], 0.0), nDer(der[0], der[1], der[2], 0.0);
+		WCVector4 c = n / pt[3];
+		c.L(1.0);
+		WCVector4 cDer = ((nDer * pt[3]) - (n * der[3])) / (pt[3] * pt[3]);
+		cDer.Normalize(true);
+		return WCRay(c, cDer);
+	}
+
 	//Now find the derivative of the curve at the point
 	WPUInt span = WCNurbs::FindSpan(this->_cp, this->_degree, eval, this->_knotPoints);
-	WPFloat* basisValues = WCNurbs::BasisValues(span, eval, this->_degree, this->_knotPoints, 1);
-	if (basisValues == NULL) return WCRay(WCVector4(), WCVector4());
+	WPFloat basisValues[2*NURBS_BASIS_MAX_ORDER];
+	if (!WCNurbs::BasisValues(span, eval, this->_degree, this->_knotPoints, 1, basisValues)) return WCRay(WCVector4(), WCVector4());
 	//Declare some temparary values
 	WCVector4 n, nDer;
 	WCVector4 pt;
@@ -983,8 +1676,6 @@ WCRay WCNurbsCurve::Tangent(const WPFloat &u) {
 		n	 +=	pt * pt.L() * basisValues[i];
 		nDer += pt * pt.L() * basisValues[i+this->_degree+1];
 	}
-	//Make sure to delete basisValues
-	delete basisValues;
 	//Calculate c and cDer
 	WCVector4 c = n / d;
 	c.L(1.0);
@@ -997,164 +1688,53 @@ WCRay WCNurbsCurve::Tangent(const WPFloat &u) {
 
 
 std::pair<WCVector4,WPFloat> WCNurbsCurve::PointInversion(const WCVector4 &point) {
-	WPFloat u;
-	//Get base vector for point
-	WCVector4 refPoint = point;
-	refPoint.K(0.0);
-	WCVector4 curvePoint;
-	int index=-1;
-	WPUInt i;
-	WPFloat dist, minDist=10000000.0;
+	WPFloat pt[4] = { point.I(), point.J(), point.K(), 1.0 }, u;
+	if (!this->InvertPoints(pt, 1, &u)) return std::make_pair(WCVector4(), -1.0);
+	return std::make_pair(this->Evaluate(u), u);
+}
 
-	//Calculate a starting u value
-	if (this->_degree == 1) {
-		WCVector4 x2x1, x1x0, tmp;
-		WPFloat t;
-		//Loop through all control points to find the closest
-		for (i=0; i<this->_cp-1; i++) {
-			//Calculate distance from point to line segment
-			x2x1 = this->_controlPoints.at(i+1) - this->_controlPoints.at(i);
-			x1x0 = this->_controlPoints.at(i) - refPoint;
-			//Calculate the distance metric for this segment
-			tmp = x2x1.CrossProduct(x1x0);
-			dist = tmp.Magnitude() / x2x1.Magnitude();
-			//Find the parametric t value
-			t = -1.0 * x1x0.DotProduct(x2x1) / pow( x2x1.Magnitude(), 2);			
-			//Check to see if this is the smallest so far
-			if ((dist < minDist) && (t >= 0.0) && (t <= 1.0)) {
-				//Save the distance
-				minDist = dist;
-				//Save the index
-				index = i;
-				//Save the t
-				u = t;
-			}
-		}
-		//Check to make sure some reasonable index was found
-		if (index == -1) return std::make_pair(WCVector4(), -1.0);
-		//Now find the point on the line segment and return it
-		WCVector4 p = this->_controlPoints.at(index) + (this->_controlPoints.at(index+1) - this->_controlPoints.at(index)) * u;
-		return std::make_pair(p, u);
-	}
-
-	//Check to see if curve needs to be generated
-	if (this->IsVisualDirty())	switch (this->_context->CurvePerformanceLevel()) {
-		//Switch on performance level
-//		case NURBSCURVE_PERFLEVEL_HIGH:		this->GenerateCurveHigh(); break;
-//		case NURBSCURVE_PERFLEVEL_MEDIUM:	this->GenerateCurveMedium(); break;
-//		case NURBSCURVE_PERFLEVEL_LOW:		this->GenerateCurveLow(); break;				
-		//Mark as clean
-			this->IsVisualDirty(true);
-	}
-	//Otherwise use tessellated vertices
-	glBindBuffer(GL_ARRAY_BUFFER, this->_buffer);
-	GLfloat *data = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_READ_ONLY);
-	//Loop through all points and find closest
-	for (i=0; i<this->_lod; i++) {
-		//Create a point from the data set
-		curvePoint.Set(data[i*4], data[i*4+1], data[i*4+2], data[i*4+3]);
-		//Calculate distance from the reference point
-		dist = refPoint.Distance(curvePoint);
-		//Is this closer
-		if (dist < minDist) {
-			//Set the min distance
-			minDist = dist;
-			//Save the point index
-			index = i;
-		}
-	}
-	//Make sure to unmap the buffer
-	glUnmapBuffer(GL_ARRAY_BUFFER);
-	//Calculate the u value for the initial minimum point
-	u = index * this->_knotPoints[this->_kp-1] / (this->_lod+1);
-	
-	//Initialize metrics
-	WPFloat *basisValues;
-	WCVector4 pt, vDist;
-	dist = minDist;
-	WCVector4 c, cDer, c2Der;
-	WCVector4 n, nDer, n2Der;
-	WPFloat top, bottom, uNx, w, wDer, w2Der, w2, w3;
-	//Loop until condition 1, 2, or 4 is met
-	int j = 0;
-	while (j <= NURBSCURVE_INVERSION_MAX_ITERATIONS) {
-		//Init the point values
-		c.Set(0.0, 0.0, 0.0, 0.0);
-		w = 0.0;
-		wDer = 0.0;
-		w2Der = 0.0;
-		cDer.Set(0.0, 0.0, 0.0, 0.0);
-		c2Der.Set(0.0, 0.0, 0.0, 0.0);
-		//Find the span and basis values up to second derivative
-		index = WCNurbs::FindSpan(this->_cp, this->_degree, u, this->_knotPoints);
-		basisValues = WCNurbs::BasisValues(index, u, this->_degree, this->_knotPoints, 2);
-		//Calculate C, C', and C''
-		for (i=0; i<=this->_degree; i++) {
-			pt = this->_controlPoints.at(index-this->_degree+i);
-			//C, C', and C''
-			n +=	 pt * basisValues[i];
-			nDer +=  pt * basisValues[i+this->_degree+1];
-			n2Der += pt * basisValues[i+2*this->_degree+2];
-			//w, w', and w''
-			w +=	 pt.L() * basisValues[i];
-			wDer +=	 pt.L() * basisValues[i+this->_degree+1];
-			w2Der += pt.L() * basisValues[i+2*this->_degree+2];
-		}
-		//Make sure to delete the basis values
-		delete basisValues;
-		//Calculate C
-		c = n / w;
-		c.L(1.0);
-		//Calculate C'
-		w2 = w * w;
-		cDer = ((nDer * w) - (n * wDer)) / w2;
-		cDer.L(1.0);
-		//Calculate C''
-		w3 = w2 * w;
-		c2Der = ((n2Der * w2) - (nDer * wDer * 2.0) - (n * w2Der * w) + (n * wDer * wDer * 2.0)) / w3;
-		c2Der.L(1.0);
-
-		//Calculate metrics
-		vDist = c - refPoint;
-		dist = vDist.Magnitude();
-
-		/*** Check for condition 1 ***/
-		if (dist < NURBSCURVE_EPSILON_ONE) return std::make_pair(c,u);
-		
-		//Do some interim calculations
-		top = cDer.DotProduct(vDist);
-		bottom = cDer.Magnitude();
-		/*** Check condition 2 ***/
-		if (( STDFABS(top) / (bottom*dist) ) <= NURBSCURVE_EPSILON_TWO) return std::make_pair(c, u);
-		
-		//Calculate next u
-		bottom = c2Der.DotProduct(vDist) + (bottom * bottom);
-		uNx = u - (top / bottom);
-		//Adjust u by rule (3) if necessary (closed and open curves)
-		if (this->_isClosed) {
-			if (uNx < this->_knotPoints[index]) uNx = this->_knotPoints[index+1] - this->_knotPoints[index] + uNx;
-			else if (uNx > this->_knotPoints[index+1]) uNx = this->_knotPoints[index] + uNx - this->_knotPoints[index+1];
-		}
-		else {
-			if (uNx < this->_knotPoints[index]) uNx = this->_knotPoints[index];
-			else if (uNx > this->_knotPoints[index+1]) uNx = this->_knotPoints[index+1];
-		}
-		
-		/*** Check rule (4) for halting ***/
-		top = (cDer * (uNx - u)).Magnitude();
-		if (top <= NURBSCURVE_EPSILON_ONE) return std::make_pair(c, u);
 
-		//Swap the u value to the next u value
-		u = uNx;
-		//Increment max loop counter
-		j++;
-	}
-	//Return the point on the curve
-	return std::make_pair(c, u);		
+bool WCNurbsCurve::InvertPoints(const WPFloat *points, const WPUInt &count, WPFloat *params) {
+	//Make sure the inputs are reasonable
+	if ((points == NULL) || (params == NULL)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::InvertPoints - NULL points or parameters.");
+		return false;
+	}
+	if (count == 0) return true;
+	//Build the hierarchy up front, the workers only read it
+	const WCBezierHierarchy *hierarchy = this->Hierarchy();
+	if (hierarchy == NULL) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::InvertPoints - No Bezier hierarchy.");
+		return false;
+	}
+	std::vector<WPFloat> knots, hcp;
+	this->HomogeneousData(knots, hcp);
+	_NurbsCurveInversionJob job = { this->_degree, this->_cp, &knots[0], &hcp[0], hierarchy,
+		knots[this->_degree], knots[this->_cp], this->_isClosed, points, params, count };
+	//Blocks of points - one block runs inline, more go to the shared pool
+	WPUInt blocks = (count + NURBSCURVE_INVERSION_BLOCK - 1) / NURBSCURVE_INVERSION_BLOCK;
+	if (blocks == 1) _NurbsCurveInversionTask(&job, 0);
+	else WCThreadPool::Shared()->ParallelFor(blocks, _NurbsCurveInversionTask, &job);
+	return true;
 }
 
 
 GLfloat* WCNurbsCurve::GenerateClientBuffer(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lod, const bool &managed) {
+	//Managed buffers are shared through the tessellation cache
+	if (managed) {
+		WCTessellationKey key(this, this->_revision, NURBSCURVE_CACHE_CLIENT);
+		key.values[0] = uStart;
+		key.values[1] = uStop;
+		key.values[2] = (WPFloat)lod;
+		WCTessellation tess;
+		if (!WCTessellationCache::Shared()->Acquire(key, tess)) {
+			tess.buffers.push_back(this->GenerateClientBuffer(uStart, uStop, lod, false));
+			tess.counts.push_back(lod);
+			WCTessellationCache::Shared()->Insert(key, tess, lod * 4 * sizeof(GLfloat));
+		}
+		lod = tess.counts.at(0);
+		return tess.buffers.at(0);
+	}
 	GLuint dummy = 0;
 	GLfloat* buffer;
 	//Make sure LOD >= 2
@@ -1194,12 +1774,100 @@ GLfloat* WCNurbsCurve::GenerateClientBuffer(const WPFloat &uStart, const WPFloat
 
 
 void WCNurbsCurve::ReleaseBuffer(GLfloat* buffer) {
-	//For now just delete the buffer
-	if (buffer != NULL) delete buffer;
+	//Managed buffers go back to the cache, everything else is deleted
+	if (buffer == NULL) return;
+	if (!WCTessellationCache::Shared()->Release(buffer)) delete [] buffer;
+}
+
+
+GLfloat* WCNurbsCurve::GenerateAdaptiveBuffer(const WPFloat &chordTolerance, const WPFloat &angleTolerance, WPUInt &count,
+	std::vector<WPFloat> *params, const bool &managed) {
+	//Managed buffers are shared through the tessellation cache
+	if (managed) {
+		WCTessellationKey key(this, this->_revision, NURBSCURVE_CACHE_ADAPTIVE);
+		key.values[0] = chordTolerance;
+		key.values[1] = angleTolerance;
+		WCTessellation tess;
+		if (!WCTessellationCache::Shared()->Acquire(key, tess)) {
+			//Try the active store before generating (and then save it there) - held so it can not be freed mid lookup
+			WCTessellationStore *store = WCTessellationStore::AcquireActive();
+			WPHash hash = (store != NULL) ? this->ContentHash() : 0;
+			if ((store == NULL) || (!store->Find(hash, key, tess)) || (tess.buffers.size() != 1) || (tess.counts.size() != 1)) {
+				for (WPUInt i=0; i<tess.buffers.size(); i++) delete [] tess.buffers.at(i);
+				tess.buffers.clear();
+				tess.counts.clear();
+				tess.buffers.push_back(this->GenerateAdaptiveBuffer(chordTolerance, angleTolerance, count, &tess.params, false));
+				tess.counts.push_back(count);
+				if (store != NULL) store->Store(hash, key, tess, std::vector<WPUInt>(1, count * 4));
+			}
+			WCTessellationStore::Release(store);
+			count = tess.counts.at(0);
+			WCTessellationCache::Shared()->Insert(key, tess, count * (4 * sizeof(GLfloat) + sizeof(WPFloat)));
+		}
+		count = tess.counts.at(0);
+		if (params != NULL) *params = tess.params;
+		return tess.buffers.at(0);
+	}
+	GLfloat *buffer;
+	WPUInt i;
+	//Degree 1 curves are exactly their control polygon
+	if (this->_degree == 1) {
+		GLuint dummy = 0;
+		count = this->_cp;
+		buffer = this->GenerateCurveOne(false, dummy);
+		if (params != NULL) {
+			params->resize(count);
+			for (i=0; i<count; i++) params->at(i) = (WPFloat)i / (WPFloat)(count - 1);
+		}
+		return buffer;
+	}
+	//Flatten the control points into homogeneous coordinates
+	WPFloat *hcp = new WPFloat[this->_cp * 4];
+	WCVector4 cp;
+	for (i=0; i<this->_cp; i++) {
+		cp = this->_controlPoints.at(i);
+		hcp[i*4]   = cp.I() * cp.L();
+		hcp[i*4+1] = cp.J() * cp.L();
+		hcp[i*4+2] = cp.K() * cp.L();
+		hcp[i*4+3] = cp.L();
+	}
+	_NurbsCurveAdaptiveJob job;
+	job.degree = this->_degree;
+	job.knotPoints = this->_knotPoints;
+	job.hcp = hcp;
+	job.chordSq = chordTolerance * chordTolerance;
+	//An angle outside of (0, 180) disables the angle test
+	job.cosAngle = ((angleTolerance > 0.0) && (angleTolerance < 180.0)) ? cos(angleTolerance * M_PI / 180.0) : -2.0;
+	std::vector<WPFloat> values;
+	std::vector<GLfloat> verts;
+	//Tessellate each non-empty knot span on its own
+	for (job.span=this->_degree; job.span<this->_cp; job.span++)
+		if (this->_knotPoints[job.span] < this->_knotPoints[job.span+1]) _NurbsCurveAdaptiveSpan(job, values, verts);
+	//Close with the end of the last span
+	WPFloat end[3];
+	job.span = this->_cp - 1;
+	_NurbsCurveSpanPoint(job, this->_knotPoints[this->_cp], end);
+	values.push_back(this->_knotPoints[this->_cp]);
+	verts.push_back((GLfloat)end[0]);
+	verts.push_back((GLfloat)end[1]);
+	verts.push_back((GLfloat)end[2]);
+	verts.push_back(1.0);
+	delete [] hcp;
+	//Copy out the vertices (and parametric values if wanted)
+	count = (WPUInt)values.size();
+	buffer = new GLfloat[verts.size()];
+	for (i=0; i<verts.size(); i++) buffer[i] = verts[i];
+	if (params != NULL) params->swap(values);
+	return buffer;
 }
 
 
 void WCNurbsCurve::GenerateServerBuffer(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lod, GLuint &buffer, const bool &managed) {
+	//Software contexts have no GL to hold the buffer - use GenerateClientBuffer
+	if ((this->_context != NULL) && this->_context->IsSoftware()) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::GenerateServerBuffer - No GL in a software context.");
+		return;
+	}
 	//Make sure LOD >= 2
 	if (lod < 2) lod = 2;
 
@@ -1236,6 +1904,11 @@ void WCNurbsCurve::ReleaseBuffer(GLuint &buffer) {
 
 
 GLuint WCNurbsCurve::GenerateTextureBuffer(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lod, const bool &managed) {
+	//Software contexts have no GL to hold the texture
+	if ((this->_context != NULL) && this->_context->IsSoftware()) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::GenerateTextureBuffer - No GL in a software context.");
+		return 0;
+	}
 	GLuint texture = 0;
 	//Generate the texture
 	glGenTextures(1, &texture);
@@ -1293,28 +1966,153 @@ void WCNurbsCurve::ReleaseTexture(GLuint &texture) {
 }
 
 
-void WCNurbsCurve::InsertKnot(const WPFloat &u, const WPUInt &multiplicity) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::RefineKnot - Not yet implemented.");
+void WCNurbsCurve::HomogeneousData(std::vector<WPFloat> &knots, std::vector<WPFloat> &hcp) {
+	//Degree one curves are uniform polylines without a knot array
+	if (this->_knotPoints == NULL) {
+		WPFloat *uniform = WCNurbs::LoadDefaultKnotPoints(this->_kp, this->_degree);
+		knots.assign(uniform, uniform + this->_kp);
+		delete [] uniform;
+	}
+	else knots.assign(this->_knotPoints, this->_knotPoints + this->_kp);
+	//Control points as (xw, yw, zw, w)
+	hcp.resize(this->_cp * 4);
+	for (WPUInt i=0; i<this->_cp; i++) {
+		const WCVector4 &cp = this->_controlPoints[i];
+		hcp[i*4]   = cp.I() * cp.L();
+		hcp[i*4+1] = cp.J() * cp.L();
+		hcp[i*4+2] = cp.K() * cp.L();
+		hcp[i*4+3] = cp.L();
+	}
+}
+
+
+bool WCNurbsCurve::Redefine(const WPUInt &degree, const std::vector<WPFloat> &knots, const std::vector<WPFloat> &hcp) {
+	WPUInt cp = (WPUInt)hcp.size() / 4;
+	//Make sure the result still fits the curve limits
+	if ((degree < 2) || (degree > NURBSCURVE_MAX_DEGREE) || (cp > NURBSCURVE_MAX_CONTROLPOINTS)) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsCurve::Redefine - Result exceeds curve limits (degree " << degree << ", " << cp << " control points).");
+		return false;
+	}
+	//Replace the knot vector
+	if (this->_knotPoints != NULL) delete [] this->_knotPoints;
+	this->_degree = degree;
+	this->_cp = cp;
+	this->_kp = (WPUInt)knots.size();
+	this->_mode = WCNurbsMode::Custom();
+	this->_knotPoints = WCNurbs::LoadCustomKnotPoints(knots);
+	//Back to Cartesian control points with weights
+	this->_controlPoints.resize(cp);
+	for (WPUInt i=0; i<cp; i++)
+		this->_controlPoints[i].Set(hcp[i*4] / hcp[i*4+3], hcp[i*4+1] / hcp[i*4+3], hcp[i*4+2] / hcp[i*4+3], hcp[i*4+3]);
+	this->_lod = this->_cp;
+	this->_length = WCNurbs::EstimateLength(this->_controlPoints);
+	this->_bounds->Set(this->_controlPoints);
+	//Mark the object as dirty
+	this->_revision++;
+	this->IsVisualDirty(true);
+	this->IsSerialDirty(true);
+	return true;
 }
 
 
-void WCNurbsCurve::RefineKnot(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::RefineKnot - Not yet implemented.");
+bool WCNurbsCurve::InsertKnot(const WPFloat &u, const WPUInt &multiplicity) {
+	//Polylines have no knot vector to refine
+	if (this->_degree == 1) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsCurve::InsertKnot - Not supported for degree one curves.");
+		return false;
+	}
+	std::vector<WPFloat> knots, hcp;
+	this->HomogeneousData(knots, hcp);
+	//Boehm insertion (via the refinement path), multiplicity is capped at the degree
+	if (WCNurbs::InsertKnot(this->_degree, knots, hcp, 4, u, multiplicity) == 0) return false;
+	return this->Redefine(this->_degree, knots, hcp);
 }
 
 
-void WCNurbsCurve::RemoveKnot(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::RemoveKnot - Not yet implemented.");
+bool WCNurbsCurve::RefineKnot(const std::vector<WPFloat> &insert) {
+	if (this->_degree == 1) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsCurve::RefineKnot - Not supported for degree one curves.");
+		return false;
+	}
+	std::vector<WPFloat> knots, hcp;
+	this->HomogeneousData(knots, hcp);
+	if (!WCNurbs::RefineKnots(this->_degree, knots, hcp, 4, insert)) return false;
+	return this->Redefine(this->_degree, knots, hcp);
 }
 
 
-void WCNurbsCurve::ElevateDegree(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::ElevateDegree - Not yet implemented.");
+WPUInt WCNurbsCurve::RemoveKnot(const WPFloat &u, const WPUInt &count, const WPFloat &tolerance) {
+	if (this->_degree == 1) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsCurve::RemoveKnot - Not supported for degree one curves.");
+		return 0;
+	}
+	std::vector<WPFloat> knots, hcp;
+	this->HomogeneousData(knots, hcp);
+	WPUInt removed = WCNurbs::RemoveKnot(this->_degree, knots, hcp, 4, u, count, tolerance);
+	if ((removed == 0) || (!this->Redefine(this->_degree, knots, hcp))) return 0;
+	return removed;
 }
 
 
-void WCNurbsCurve::ReduceDegree(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::ReduceDegree - Not yet implemented.");
+bool WCNurbsCurve::ElevateDegree(const WPUInt &times) {
+	std::vector<WPFloat> knots, hcp;
+	this->HomogeneousData(knots, hcp);
+	WPUInt degree = this->_degree;
+	if (!WCNurbs::ElevateDegree(degree, knots, hcp, 4, times)) return false;
+	return this->Redefine(degree, knots, hcp);
+}
+
+
+bool WCNurbsCurve::ReduceDegree(const WPFloat &tolerance) {
+	//Reducing to degree one would need a uniform polyline
+	if (this->_degree <= 2) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsCurve::ReduceDegree - Degree must be at least three.");
+		return false;
+	}
+	std::vector<WPFloat> knots, hcp;
+	this->HomogeneousData(knots, hcp);
+	WPUInt degree = this->_degree;
+	if (!WCNurbs::ReduceDegree(degree, knots, hcp, 4, tolerance)) return false;
+	return this->Redefine(degree, knots, hcp);
+}
+
+
+WPUInt WCNurbsCurve::BezierSegments(const WPFloat* &points, const WPFloat* &breaks) {
+	//Extract again only if the geometry has changed
+	if ((this->_bezierBreaks.size() == 0) || (this->_bezierRevision != this->_revision)) {
+		std::vector<WPFloat> knots, hcp;
+		this->HomogeneousData(knots, hcp);
+		WPUInt segments = WCNurbs::DecomposeBezier(this->_degree, knots, hcp, 4);
+		WPUInt p = this->_degree;
+		this->_bezierPoints.resize(segments * (p+1) * 4);
+		this->_bezierBreaks.resize(segments + 1);
+		//Neighbouring segments share their end points in the decomposed polygon
+		for (WPUInt k=0; k<segments; k++) {
+			memcpy(&this->_bezierPoints[k*(p+1)*4], &hcp[k*p*4], (p+1) * 4 * sizeof(WPFloat));
+			this->_bezierBreaks[k] = knots[p + k*p];
+		}
+		if (segments > 0) this->_bezierBreaks[segments] = knots.back();
+		else this->_bezierBreaks.clear();
+		this->_bezierRevision = this->_revision;
+	}
+	points = this->_bezierPoints.size() ? &this->_bezierPoints[0] : NULL;
+	breaks = this->_bezierBreaks.size() ? &this->_bezierBreaks[0] : NULL;
+	return this->_bezierBreaks.size() ? (WPUInt)this->_bezierBreaks.size() - 1 : 0;
+}
+
+
+const WCBezierHierarchy* WCNurbsCurve::Hierarchy(const WPFloat &tolerance) {
+	//Rebuild only if the geometry or the tolerance has changed
+	if ((this->_hierarchy != NULL) && (this->_hierarchyRevision == this->_revision) &&
+		(this->_hierarchy->Tolerance() == tolerance)) return this->_hierarchy;
+	if (this->_hierarchy != NULL) delete this->_hierarchy;
+	this->_hierarchy = NULL;
+	const WPFloat *points, *breaks;
+	WPUInt segments = this->BezierSegments(points, breaks);
+	if (segments == 0) return NULL;
+	this->_hierarchy = new WCBezierHierarchy(this->_degree, segments, points, breaks, tolerance);
+	this->_hierarchyRevision = this->_revision;
+	return this->_hierarchy;
 }
 
 	
@@ -1338,6 +2136,7 @@ WCNurbsCurve& WCNurbsCurve::operator=(const WCNurbsCurve &curve) {
 	this->_mode = curve._mode;
 	this->_length = curve._length;
 	//Mark as dirty
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 	//Return this object
@@ -1419,9 +2218,68 @@ xercesc::DOMElement* WCNurbsCurve::Serialize(xercesc::DOMDocument *document, WCS
 /***********************************************~***************************************************/
 
 
-WCNurbsCurve* WCNurbsCurve::GlobalInterpolation(const std::vector<WCVector4> &pts, const WPUInt &degree) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::GlobalInterpolation - Not yet implemented.");
-	return NULL;
+WCNurbsCurve* WCNurbsCurve::GlobalInterpolation(WCGeometryContext *context, const std::vector<WCVector4> &pts, const WPUInt &degree) {
+	//Make sure there is something to interpolate
+	if ((pts.size() < 2) || (degree == 0)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::GlobalInterpolation - Need two points and a positive degree.");
+		return NULL;
+	}
+	WPUInt n = (WPUInt)pts.size() - 1, p = STDMIN(STDMIN(degree, n), (WPUInt)NURBSCURVE_MAX_DEGREE), k, i, j, c;
+	//Chord length parameters
+	std::vector<WPFloat> params(n+1, 0.0);
+	for (k=1; k<=n; k++) params[k] = params[k-1] + pts[k].Distance(pts[k-1]);
+	if (params[n] <= 0.0) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::GlobalInterpolation - Points are coincident.");
+		return NULL;
+	}
+	for (k=1; k<n; k++) params[k] /= params[n];
+	params[n] = 1.0;
+	//Straight polylines need no knots
+	if (p == 1) return new WCNurbsCurve(context, 1, pts, WCNurbsMode::Default(), std::vector<WPFloat>());
+	//Knots by averaging the parameters, clamped at both ends
+	std::vector<WPFloat> knots(n+p+2, 0.0);
+	for (j=1; j<=n-p; j++) {
+		for (i=j; i<j+p; i++) knots[j+p] += params[i];
+		knots[j+p] /= (WPFloat)p;
+	}
+	for (j=n+1; j<=n+p+1; j++) knots[j] = 1.0;
+	//Each collocation row holds p+1 basis values starting at column span-p - the system stays in that band
+	std::vector<WPFloat> band((n+1) * (p+1)), rhs((n+1) * 3);
+	std::vector<WPUInt> first(n+1);
+	for (k=0; k<=n; k++) {
+		WPUInt span = WCNurbs::FindSpan(n+1, p, params[k], &knots[0]);
+		first[k] = span - p;
+		if (!WCNurbs::BasisValues(span, params[k], p, &knots[0], 0, &band[k*(p+1)])) return NULL;
+		rhs[k*3] = pts[k].I();
+		rhs[k*3+1] = pts[k].J();
+		rhs[k*3+2] = pts[k].K();
+	}
+	//Gaussian elimination without pivoting (the collocation matrix is totally positive)
+	WPFloat pivot, factor;
+	for (j=0; j<=n; j++) {
+		pivot = band[j*(p+1) + j - first[j]];
+		if (fabs(pivot) < NURBSCURVE_KNOT_TOLERANCE) {
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsCurve::GlobalInterpolation - Singular system.");
+			return NULL;
+		}
+		for (i=j+1; (i<=n) && (first[i]<=j); i++) {
+			factor = band[i*(p+1) + j - first[i]] / pivot;
+			if (factor == 0.0) continue;
+			for (c=j; c<=first[j]+p; c++) band[i*(p+1) + c - first[i]] -= factor * band[j*(p+1) + c - first[j]];
+			for (c=0; c<3; c++) rhs[i*3+c] -= factor * rhs[j*3+c];
+		}
+	}
+	//Back substitution in place of the right hand side
+	for (j=n+1; j-->0; ) {
+		for (c=j+1; c<=first[j]+p; c++)
+			for (i=0; i<3; i++) rhs[j*3+i] -= band[j*(p+1) + c - first[j]] * rhs[c*3+i];
+		pivot = band[j*(p+1) + j - first[j]];
+		for (i=0; i<3; i++) rhs[j*3+i] /= pivot;
+	}
+	std::vector<WCVector4> controlPoints;
+	for (j=0; j<=n; j++) controlPoints.push_back( WCVector4(rhs[j*3], rhs[j*3+1], rhs[j*3+2], 1.0) );
+	//Create the curve
+	return new WCNurbsCurve(context, p, controlPoints, WCNurbsMode::Custom(), knots);
 }
 
 
@@ -34,6 +34,7 @@
 #include <Geometry/wgeol.h>
 #include <Geometry/geometric_types.h>
 #include <Geometry/nurbs.h>
+#include <Utility/tessellation_store.h>
 
 
 /*** Locally Defined Values ***/
@@ -59,6 +60,10 @@
 #define NURBSCURVE_LOC_PARAMS2_BEZIER23			11
 //Accuracy Constants
 #define NURBSCURVE_LENGTH_ACCURACY				0.001
+#define NURBSCURVE_ADAPTIVE_ANGLE				15.0		//Max turn between adaptive segments (degrees)
+#define NURBSCURVE_ADAPTIVE_MAX_DEPTH			8			//Max bisections of a starting segment
+#define NURBSCURVE_KNOT_TOLERANCE				0.001		//Default deviation for knot removal and degree reduction
+#define NURBSCURVE_HIERARCHY_ACCURACY			0.001		//Default flatness of bounding hierarchy pieces
 //Performance Levels
 #define NURBSCURVE_PERFLEVEL_HIGH				0
 #define NURBSCURVE_PERFLEVEL_MEDIUM				1
@@ -71,6 +76,7 @@ namespace __WILDCAT_NAMESPACE__ {
 
 /*** Class Predefines ***/
 class WCGeometryContext;
+class WCBezierHierarchy;
 
 
 /***********************************************~***************************************************/
@@ -88,6 +94,21 @@ protected:
 	WPUInt										_lod;												//!< Vertex buffer level of detail
 	GLuint										_buffer;											//!< Vertex buffer - GPU side
 	GLfloat										*_altBuffer;										//!< Vertex buffer - CPU side
+	WPFloat										_tolerance;											//!< Chord height of the adaptive vertex buffer
+	std::vector<WPFloat>						_params;											//!< Parametric value of each buffer vertex
+	std::vector<WPUInt>							_spanStarts;										//!< First buffer vertex of each knot span
+	WCNurbsBasisCache							_basisCache;										//!< Basis values for Low tessellation
+	bool										_isFullyDirty;										//!< Whole vertex buffer needs regenerating
+	WPUInt										_dirtyLow, _dirtyHigh;								//!< Range of control points changed since generation
+	WPUInt										_revision;											//!< Geometry revision - keys the tessellation cache
+	WPFloat										_arcTolerance;										//!< Tolerance of the arc length table (0 if none)
+	WPUInt										_arcRevision;										//!< Revision the arc length table was built at
+	std::vector<WPFloat>						_arcParams, _arcLengths;							//!< Arc length table - parameter and length from start
+	std::vector<WPFloat>						_arcHcp;											//!< Homogeneous control points for the table
+	WPUInt										_bezierRevision;									//!< Revision the Bezier segments were extracted at
+	std::vector<WPFloat>						_bezierPoints, _bezierBreaks;						//!< Homogeneous Bezier segments and their parametric breaks
+	WCBezierHierarchy							*_hierarchy;										//!< Bounding hierarchy over the Bezier segments
+	WPUInt										_hierarchyRevision;									//!< Revision the hierarchy was built at
 private:
 	//Private Methods
 	void GenerateKnotPointsVBO(void);																//!< Generate the knot points VBO	
@@ -103,6 +124,12 @@ private:
 	GLfloat* GenerateCurveLow(const WPFloat &start, const WPFloat &stop, const WPUInt &lod,			//!< Generate GL using Low perf level
 							  const bool &server, GLuint &buffer);
 	GLfloat* GenerateCurveOne(const bool &server, GLuint &buffer);									//!< For 1st degree curves
+	void GenerateCurveAdaptive(const WPFloat &chordTolerance, GLuint &buffer);						//!< Adaptive tessellation in VRAM (dirty spans only if possible)
+	void MarkControlPointsDirty(const WPUInt &low, const WPUInt &high);								//!< Mark a range of control points as changed
+	void BuildArcLengthTable(const WPFloat &tolerance);												//!< Gauss-Legendre arc length table (cached per revision)
+	void HomogeneousData(std::vector<WPFloat> &knots, std::vector<WPFloat> &hcp);					//!< Copy out the knots and homogeneous control points
+	bool Redefine(const WPUInt &degree, const std::vector<WPFloat> &knots,							//!< Replace degree, knots and control points after a knot operation
+												const std::vector<WPFloat> &hcp);
 	//Hidden Constructors
 	WCNurbsCurve();																					//!< Deny access to default constructor
 public:
@@ -115,8 +142,12 @@ public:
 	~WCNurbsCurve();																				//!< Default destructor
 	
 	//General Access Methods
+	virtual void IsVisualDirty(const bool &status);													//!< Set the dirty flag (whole curve)
+	virtual inline bool IsVisualDirty(void) const	{ return this->WCVisualObject::IsVisualDirty(); }	//!< Get the dirty flag
+	inline WPUInt Revision(void) const			{ return this->_revision; }							//!< Get the geometry revision
+	WPHash ContentHash(void);																		//!< Hash of degree, knots and control points
 	inline std::vector<WCVector4> ControlPoints(void)	{ return this->_controlPoints; }			//!< Get the control points vector
-	void ControlPoints(const std::vector<WCVector4> &controlPoints);								//!< Set the control points vector
+	void ControlPoints(const std::vector<WCVector4> &controlPoints);								//!< Set the control points vector (only changed spans regenerate)
 	inline WPUInt NumberControlPoints(void) const{ return this->_cp; }								//!< Get the number of control points
 	inline WPFloat* KnotPoints(void)			{ return this->_knotPoints; }						//!< Get the array of knot points
 	void KnotPoints(const std::vector<WPFloat> &knotPoints);										//!< Set the knot points vector
@@ -127,8 +158,17 @@ public:
 	
 	//Inherited Member Methods
 	WPFloat Length(const WPFloat &tolerance=NURBSCURVE_LENGTH_ACCURACY);							//!< Calculate the length of the curve
+	WPFloat LengthAtParameter(const WPFloat &u, const WPFloat &tolerance=NURBSCURVE_LENGTH_ACCURACY);//!< Arc length from the start to u
+	WPFloat ParameterAtLength(const WPFloat &length,												//!< Parameter at an arc length from the start
+												const WPFloat &tolerance=NURBSCURVE_LENGTH_ACCURACY);
+	std::vector<WPFloat> ParametersByLength(const WPUInt &count,									//!< Parameters evenly spaced by arc length
+												const WPFloat &tolerance=NURBSCURVE_LENGTH_ACCURACY);
 	inline WPFloat EstimateLength(void)			{ return WCNurbs::EstimateLength(this->_controlPoints); } //!< Estimate the length of the curve
 	WCVector4 Evaluate(const WPFloat &u);															//!< Evaluate a specific point on the curve
+	void EvaluateMany(const WPFloat *params, const WPUInt &count, GLfloat *data);					//!< Evaluate an array of parametric values (4 floats per point)
+	void EvaluateMany(const WPFloat *params, const WPUInt &count, WPFloat *data);					//!< Evaluate an array of parametric values (4 doubles per point)
+	void EvaluateMany(const WPFloat &start, const WPFloat &stop, const WPUInt &count, GLfloat *data);//!< Evaluate count evenly spaced values (4 floats per point)
+	void EvaluateMany(const WPFloat &start, const WPFloat &stop, const WPUInt &count, WPFloat *data);//!< Evaluate count evenly spaced values (4 doubles per point)
 	WCVisualObject* HitTest(const WCRay &ray, const WPFloat &tolerance);							//!< Hit test with a ray
 	void ApplyTransform(const WCMatrix4 &transform);												//!< Apply a transform to the curve
 	void ApplyTranslation(const WCVector4 &translation);											//!< Apply a linear translation to the object
@@ -139,6 +179,8 @@ public:
 	GLfloat* GenerateClientBuffer(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lod, 		//!< Generate up to LOD vert - put in RAM
 												const bool &managed);
 	void ReleaseBuffer(GLfloat* buffer);															//!< Manage the release of buffer resources
+	GLfloat* GenerateAdaptiveBuffer(const WPFloat &chordTolerance, const WPFloat &angleTolerance,	//!< Generate a non-uniform polyline within tolerance - put in RAM
+												WPUInt &count, std::vector<WPFloat> *params=NULL, const bool &managed=false);
 	void GenerateServerBuffer(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lod,				//!< Generate up to LOD vert - put in VRAM
 												GLuint &buffer, const bool &managed);
 	void ReleaseBuffer(GLuint &buffer);																//!< Manage the release of buffer resources
@@ -148,11 +190,15 @@ public:
 	WCVector4 Derivative(const WPFloat &u, const WPUInt &der);										//!< Evaluate the derivative at a specific point
 	WCRay Tangent(const WPFloat &u);																//!< Get the tangent to the curve at U
 	std::pair<WCVector4,WPFloat> PointInversion(const WCVector4 &point);							//!< Get the closest point on the curve from the given point
-	void InsertKnot(const WPFloat &u, const WPUInt &multiplicity=1);								//!< Insert a knot at parametric value u
-	void RefineKnot(void);																			//!< Refine the curve with multiple knot insertions
-	void RemoveKnot(void);																			//!< Remove knots from the curve
-	void ElevateDegree(void);																		//!< Elevate the degree of the curve
-	void ReduceDegree(void);																		//!< Reduce the degree of the curve 	
+	bool InvertPoints(const WPFloat *points, const WPUInt &count, WPFloat *params);				//!< Closest parameters for many points (4 doubles each, in parallel)
+	bool InsertKnot(const WPFloat &u, const WPUInt &multiplicity=1);								//!< Insert a knot at parametric value u
+	bool RefineKnot(const std::vector<WPFloat> &knots);												//!< Refine the curve with multiple knot insertions
+	WPUInt RemoveKnot(const WPFloat &u, const WPUInt &count=1,										//!< Remove a knot within tolerance, returns the count removed
+												const WPFloat &tolerance=NURBSCURVE_KNOT_TOLERANCE);
+	bool ElevateDegree(const WPUInt &times=1);														//!< Elevate the degree of the curve
+	bool ReduceDegree(const WPFloat &tolerance=NURBSCURVE_KNOT_TOLERANCE);							//!< Reduce the degree of the curve by one within tolerance
+	WPUInt BezierSegments(const WPFloat* &points, const WPFloat* &breaks);							//!< Homogeneous Bezier segments (degree+1 points each) and breaks (cached per revision)
+	const WCBezierHierarchy* Hierarchy(const WPFloat &tolerance=NURBSCURVE_HIERARCHY_ACCURACY);	//!< Bounding hierarchy over the segments (built lazily, cached per revision)
 	
 	//Operator Overloads
 	WCNurbsCurve& operator=(const WCNurbsCurve &curve);												//!< Equals operator
@@ -162,7 +208,8 @@ public:
 	xercesc::DOMElement* Serialize(xercesc::DOMDocument *document, WCSerialDictionary *dict);		//!< Serialize the object
 	
 	/*** Static Creation Methods ***/
-	static WCNurbsCurve* GlobalInterpolation(const std::vector<WCVector4> &pts, const WPUInt &degree);	//!< Global curve interpolation
+	static WCNurbsCurve* GlobalInterpolation(WCGeometryContext *context,							//!< Global curve interpolation (chord length, averaged knots)
+												const std::vector<WCVector4> &pts, const WPUInt &degree);
 	static WCNurbsCurve* LocalInterpolation(const std::vector<WCVector4> &pts, const WPUInt &degree);	//!< Local curve interpolation
 	static WCNurbsCurve* CircularArc(WCGeometryContext *context, const WCVector4 &center,			//!< Generate a circular arc curve
 												const WCVector4 &xUnit, const WCVector4 &yUnit, const WPFloat &radius, 
@@ -34,6 +34,9 @@
 #include <Geometry/nurbs_curve.h>
 #include <Geometry/geometric_algorithms.h>
 #include <Geometry/ray.h>
+#include <Geometry/bezier_hierarchy.h>
+#include <Utility/thread_pool.h>
+#include <Utility/tessellation_cache.h>
  
 
 /*** Extern Variables ***/
@@ -42,12 +45,680 @@ extern WPFloat* __bezier_coef[8];
 
 /*** Locally Defined Values ***/
 #define NURBSSURFACE_INVERSION_MAX_ITERATIONS	12
+#define NURBSSURFACE_INVERSION_EPSILON			0.000000000001
+#define NURBSSURFACE_INVERSION_MAX_HALVINGS		8
+#define NURBSSURFACE_INVERSION_BLOCK			64			//Points per batch inversion task
 #define NURBSSURFACE_EPSILON_ONE				0.0001
 #define NURBSSURFACE_EPSILON_TWO				0.0001
 #define NURBSSURFACE_EQUALITY_EPSILON			0.001
-#define NURBSSURFACE_RENDER_ACCURACY			0.20
+#define NURBSSURFACE_RENDER_CHORD				0.005
 #define NURBSSURFACE_RENDER_LOWER				0.85
 #define NURBSSURFACE_RENDER_UPPER				1.55
+//Tessellation cache kinds
+#define NURBSSURFACE_CACHE_CLIENT				0
+#define NURBSSURFACE_CACHE_ADAPTIVE				1
+//Mass Constants
+#define NURBSSURFACE_MASS_TERMS					11
+//Basis workspace check
+#if NURBSSURFACE_MAX_DEGREE > NURBS_BASIS_MAX_DEGREE
+#error NURBS_BASIS_MAX_DEGREE must be at least NURBSSURFACE_MAX_DEGREE
+#endif
+
+
+/***********************************************~***************************************************/
+
+
+static void _NurbsSurfaceCachedSamples(const WCNurbsBasisCache &cacheU, const WCNurbsBasisCache &cacheV,
+	const WPUInt &degreeU, const WPUInt &degreeV, const WPUInt &cpU, const WPFloat *hcp,
+	const WPUInt &iFirst, const WPUInt &iLast, const WPUInt &jFirst, const WPUInt &jLast,
+	GLfloat *vData, GLfloat *nData, GLfloat *tData) {
+	//Row arrays for the net contracted along V (value and V derivative)
+	WPFloat *row = new WPFloat[cpU * 4];
+	WPFloat *rowV = new WPFloat[cpU * 4];
+	const WPFloat *bvU, *bvV, *dbvU, *dbvV, *q, *qV, *cp;
+	WPFloat S[4], Su[4], Sv[4], nx, ny, nz, mag;
+	WPUInt spanU, spanV, j, k, l, c;
+	//Loop through v
+	for (WPUInt i=iFirst; i<=iLast; i++) {
+		//Contract the control net along V once per row
+		spanV = cacheV.Span(i);
+		bvV = cacheV.Values(i);
+		dbvV = bvV + degreeV + 1;
+		for (l=0; l<cpU*4; l++) row[l] = rowV[l] = 0.0;
+		for (k=0; k<=degreeV; k++) {
+			cp = hcp + (spanV - degreeV + k) * cpU * 4;
+			for (l=0; l<cpU*4; l++) {
+				row[l] += cp[l] * bvV[k];
+				rowV[l] += cp[l] * dbvV[k];
+			}
+		}
+		//Loop through u
+		for (j=jFirst; j<=jLast; j++) {
+			/*** Calculate point and normal ***/
+			spanU = cacheU.Span(j);
+			bvU = cacheU.Values(j);
+			dbvU = bvU + degreeU + 1;
+			q = row + (spanU - degreeU) * 4;
+			qV = rowV + (spanU - degreeU) * 4;
+			for (c=0; c<4; c++) S[c] = Su[c] = Sv[c] = 0.0;
+			for (l=0; l<=degreeU; l++) {
+				for (c=0; c<4; c++) {
+					S[c] += q[c] * bvU[l];
+					Su[c] += q[c] * dbvU[l];
+					Sv[c] += qV[c] * bvU[l];
+				}
+				q += 4;
+				qV += 4;
+			}
+			//Do the w-divide
+			for (c=0; c<3; c++) {
+				S[c] /= S[3];
+				//Rational derivatives (scaled by w, direction is all that matters)
+				Su[c] = Su[c] - S[c] * Su[3];
+				Sv[c] = Sv[c] - S[c] * Sv[3];
+			}
+			//Cross sU and sV and normalize to get normal vector
+			nx = Su[1] * Sv[2] - Su[2] * Sv[1];
+			ny = Su[2] * Sv[0] - Su[0] * Sv[2];
+			nz = Su[0] * Sv[1] - Su[1] * Sv[0];
+			mag = sqrt(nx*nx + ny*ny + nz*nz);
+			if (mag > 0.0) { nx /= mag; ny /= mag; nz /= mag; }
+			//Place data into arrays
+			*vData++ = (GLfloat)S[0];
+			*vData++ = (GLfloat)S[1];
+			*vData++ = (GLfloat)S[2];
+			*vData++ = 1.0;
+			*nData++ = (GLfloat)nx;
+			*nData++ = (GLfloat)ny;
+			*nData++ = (GLfloat)nz;
+			*nData++ = 0.0;
+			if (tData != NULL) {
+				*tData++ = (GLfloat)cacheU.Parameter(j);
+				*tData++ = (GLfloat)cacheV.Parameter(i);
+			}
+		}
+	}
+	//Clean up the work arrays
+	delete [] row;
+	delete [] rowV;
+}
+
+
+//Shared state for one GenerateSurfaceLow pass - each task fills a disjoint block of rows
+struct _NurbsSurfaceLowJob {
+	const WCNurbsBasisCache						*cacheU, *cacheV;
+	WPUInt										degreeU, degreeV, cpU, lodU, lodV, rowsPerTile;
+	const WPFloat								*hcp;
+	GLfloat										*vData, *nData, *tData;
+};
+
+
+static void _NurbsSurfaceLowTile(void *data, const WPUInt &index) {
+	_NurbsSurfaceLowJob *job = (_NurbsSurfaceLowJob*)data;
+	WPUInt first = index * job->rowsPerTile;
+	WPUInt last = STDMIN(first + job->rowsPerTile, job->lodV) - 1;
+	WPUInt offset = first * job->lodU;
+	_NurbsSurfaceCachedSamples(*job->cacheU, *job->cacheV, job->degreeU, job->degreeV, job->cpU, job->hcp,
+		first, last, 0, job->lodU-1, job->vData + offset * NURBSSURFACE_FLOATS_PER_VERTEX,
+		job->nData + offset * NURBSSURFACE_FLOATS_PER_NORMAL, job->tData + offset * NURBSSURFACE_FLOATS_PER_TEXCOORD);
+}
+
+
+//Shared state for a batch of GenerateClientBuffers calls - each task owns one surface
+struct _NurbsSurfaceBatchJob {
+	const std::vector<WCNurbsSurface*>			*surfaces;
+	std::vector< std::vector<GLfloat*> >		*buffers;
+	std::vector<WPUInt>							indices;
+	WPUInt										lodU, lodV;
+	bool										managed;
+};
+
+
+static void _NurbsSurfaceBatchTask(void *data, const WPUInt &index) {
+	_NurbsSurfaceBatchJob *job = (_NurbsSurfaceBatchJob*)data;
+	WPUInt lodU = job->lodU, lodV = job->lodV, surface = job->indices.at(index);
+	job->buffers->at(surface) = job->surfaces->at(surface)->GenerateClientBuffers(0.0, 1.0, lodU, 0.0, 1.0, lodV, job->managed);
+}
+
+
+//Shared state for a batch of adaptive tessellations - each task owns one surface
+struct _NurbsSurfaceAdaptiveBatchJob {
+	const std::vector<WCNurbsSurface*>			*surfaces;
+	std::vector< std::vector<GLfloat*> >		*buffers;
+	std::vector<WPUInt>							*numTriangles;
+	WPFloat										chordTolerance;
+	bool										managed;
+};
+
+
+static void _NurbsSurfaceAdaptiveBatchTask(void *data, const WPUInt &index) {
+	_NurbsSurfaceAdaptiveBatchJob *job = (_NurbsSurfaceAdaptiveBatchJob*)data;
+	WPUInt numVerts;
+	job->buffers->at(index) = job->surfaces->at(index)->GenerateAdaptiveBuffers(job->chordTolerance, numVerts,
+		job->numTriangles->at(index), job->managed);
+}
+
+
+//Shared state for adaptive tessellation - the flattened control net and both knot vectors
+struct _NurbsSurfaceAdaptiveJob {
+	WPUInt										degreeU, degreeV, cpU;
+	const WPFloat								*knotPointsU, *knotPointsV, *hcp;
+};
+
+
+static void _NurbsSurfaceSpanPoint(const _NurbsSurfaceAdaptiveJob &job, const WPUInt &spanU, const WPUInt &spanV,
+	const WPFloat &u, const WPFloat &v, WPFloat *point, WPFloat *normal, WPFloat *derivs=NULL) {
+	WPFloat bvU[2 * NURBS_BASIS_MAX_ORDER], bvV[2 * NURBS_BASIS_MAX_ORDER];
+	WPFloat S[4] = { 0.0, 0.0, 0.0, 0.0 }, Su[4] = { 0.0, 0.0, 0.0, 0.0 }, Sv[4] = { 0.0, 0.0, 0.0, 0.0 };
+	WPFloat nx, ny, nz, mag;
+	const WPFloat *cp;
+	WPUInt k, l, c;
+	//The spans are known, so go straight to the basis values (and first derivatives)
+	WCNurbs::BasisValues(spanU, u, job.degreeU, job.knotPointsU, 1, bvU);
+	WCNurbs::BasisValues(spanV, v, job.degreeV, job.knotPointsV, 1, bvV);
+	for (k=0; k<=job.degreeV; k++) {
+		cp = job.hcp + ((spanV - job.degreeV + k) * job.cpU + spanU - job.degreeU) * 4;
+		for (l=0; l<=job.degreeU; l++) {
+			for (c=0; c<4; c++) {
+				S[c] += cp[c] * bvU[l] * bvV[k];
+				Su[c] += cp[c] * bvU[l+job.degreeU+1] * bvV[k];
+				Sv[c] += cp[c] * bvU[l] * bvV[k+job.degreeV+1];
+			}
+			cp += 4;
+		}
+	}
+	//Do the w-divide
+	for (c=0; c<3; c++) {
+		point[c] = S[c] / S[3];
+		//Rational derivatives (scaled by w, direction is all that matters)
+		Su[c] = Su[c] - point[c] * Su[3];
+		Sv[c] = Sv[c] - point[c] * Sv[3];
+		//True derivatives only when asked for (Su and then Sv)
+		if (derivs != NULL) {
+			derivs[c] = Su[c] / S[3];
+			derivs[c+3] = Sv[c] / S[3];
+		}
+	}
+	if (normal == NULL) return;
+	//Cross sU and sV and normalize to get normal vector
+	nx = Su[1] * Sv[2] - Su[2] * Sv[1];
+	ny = Su[2] * Sv[0] - Su[0] * Sv[2];
+	nz = Su[0] * Sv[1] - Su[1] * Sv[0];
+	mag = sqrt(nx*nx + ny*ny + nz*nz);
+	if (mag > 0.0) { nx /= mag; ny /= mag; nz /= mag; }
+	normal[0] = nx;
+	normal[1] = ny;
+	normal[2] = nz;
+}
+
+
+static void _NurbsSurfaceAdaptiveVertex(const _NurbsSurfaceAdaptiveJob &job, const WPUInt &spanU, const WPUInt &spanV,
+	const WPFloat &u, const WPFloat &v, const WPUInt &index, GLfloat *vData, GLfloat *nData, GLfloat *tData) {
+	WPFloat pt[3], nm[3];
+	_NurbsSurfaceSpanPoint(job, spanU, spanV, u, v, pt, nm);
+	//Place data into arrays
+	vData[index*4]	 = (GLfloat)pt[0];
+	vData[index*4+1] = (GLfloat)pt[1];
+	vData[index*4+2] = (GLfloat)pt[2];
+	vData[index*4+3] = 1.0;
+	nData[index*4]	 = (GLfloat)nm[0];
+	nData[index*4+1] = (GLfloat)nm[1];
+	nData[index*4+2] = (GLfloat)nm[2];
+	nData[index*4+3] = 0.0;
+	//Texcoords stay in knot space like the uniform generators (trimmed tessellation reads them back as u,v)
+	if (tData == NULL) return;
+	tData[index*2]	 = (GLfloat)u;
+	tData[index*2+1] = (GLfloat)v;
+}
+
+
+static void _NurbsSurfacePatchSegments(const _NurbsSurfaceAdaptiveJob &job, const WPUInt &spanU, const WPUInt &spanV,
+	const WPFloat &chordTolerance, WPUInt &segU, WPUInt &segV) {
+	const WPUInt q = NURBSSURFACE_ADAPTIVE_PROBES, row = NURBSSURFACE_ADAPTIVE_PROBES + 1;
+	WPFloat pt[row * row * 3], nm[row * row * 3], d[3];
+	WPFloat u0 = job.knotPointsU[spanU], du = (job.knotPointsU[spanU+1] - u0) / q;
+	WPFloat v0 = job.knotPointsV[spanV], dv = (job.knotPointsV[spanV+1] - v0) / q;
+	WPFloat duu = 0.0, dvv = 0.0, duv = 0.0;
+	WPUInt a, b, c, idx;
+	//Sample the patch on a small probe grid
+	for (b=0; b<=q; b++)
+		for (a=0; a<=q; a++)
+			_NurbsSurfaceSpanPoint(job, spanU, spanV, u0 + du * a, v0 + dv * b, pt + (b * row + a) * 3, nm + (b * row + a) * 3);
+	//Largest second differences along the normal (tangential ones only slide vertices within the surface)
+	for (b=0; b<=q; b++) {
+		for (a=0; a<=q; a++) {
+			idx = (b * row + a) * 3;
+			if ((a > 0) && (a < q)) {
+				for (c=0; c<3; c++) d[c] = pt[idx+3+c] - 2.0 * pt[idx+c] + pt[idx-3+c];
+				duu = STDMAX(duu, STDFABS(d[0] * nm[idx] + d[1] * nm[idx+1] + d[2] * nm[idx+2]));
+			}
+			if ((b > 0) && (b < q)) {
+				for (c=0; c<3; c++) d[c] = pt[idx+row*3+c] - 2.0 * pt[idx+c] + pt[idx-row*3+c];
+				dvv = STDMAX(dvv, STDFABS(d[0] * nm[idx] + d[1] * nm[idx+1] + d[2] * nm[idx+2]));
+			}
+			if ((a < q) && (b < q)) {
+				for (c=0; c<3; c++) d[c] = pt[idx+row*3+3+c] - pt[idx+row*3+c] - pt[idx+3+c] + pt[idx+c];
+				duv = STDMAX(duv, STDFABS(d[0] * nm[idx] + d[1] * nm[idx+1] + d[2] * nm[idx+2]));
+			}
+		}
+	}
+	//Scale the differences up to derivatives over the whole patch
+	duu *= q * q;
+	dvv *= q * q;
+	duv *= q * q;
+	//Interpolating over n segments deviates by about D / 8n^2 per direction, plus the twist term
+	if (chordTolerance <= 0.0) segU = segV = NURBSSURFACE_ADAPTIVE_MAX_SEGMENTS;
+	else {
+		segU = (WPUInt)ceil(sqrt((duu + duv) / (4.0 * chordTolerance)));
+		segV = (WPUInt)ceil(sqrt((dvv + duv) / (4.0 * chordTolerance)));
+	}
+	segU = STDMAX((WPUInt)1, STDMIN(segU, (WPUInt)NURBSSURFACE_ADAPTIVE_MAX_SEGMENTS));
+	segV = STDMAX((WPUInt)1, STDMIN(segV, (WPUInt)NURBSSURFACE_ADAPTIVE_MAX_SEGMENTS));
+}
+
+
+static void _NurbsSurfaceStitch(const std::vector<GLuint> &outer, const std::vector<GLuint> &inner, const bool &flip,
+	std::vector<GLuint> &triangles) {
+	WPUInt i = 0, k = 0, numOuter = (WPUInt)outer.size() - 1, numInner = (WPUInt)inner.size() - 1;
+	WPFloat nextOuter, nextInner;
+	GLuint a, b, c;
+	//Zip the two rows together - outer spans [0,1], inner spans [1/n, 1-1/n] for n = numInner + 2
+	while ((i < numOuter) || (k < numInner)) {
+		nextOuter = (i < numOuter) ? (WPFloat)(i + 1) / numOuter : 2.0;
+		nextInner = (k < numInner) ? (WPFloat)(k + 2) / (numInner + 2) : 2.0;
+		//Advance whichever row has the next vertex first
+		a = outer.at(i);
+		b = inner.at(k);
+		if (nextOuter <= nextInner) c = outer.at(++i);
+		else c = inner.at(++k);
+		//Wind the same way as the regular grid (rows running the other way round flip it)
+		triangles.push_back(a);
+		triangles.push_back(flip ? c : b);
+		triangles.push_back(flip ? b : c);
+	}
+}
+
+
+//Vertex numbering of an adaptive mesh - patch corners, then U edge interiors, V edge interiors and patch interiors
+struct _NurbsSurfaceAdaptiveLayout {
+	WPUInt										numU, numV, numVerts;
+	std::vector<WPUInt>							spansU, spansV;
+	std::vector<WPFloat>						valuesU, valuesV;
+	std::vector<WPUInt>							edgesU, edgesV, innerU, innerV;
+	std::vector<WPUInt>							startU, startV, startP;
+	std::vector<bool>							stitched;
+};
+
+
+//Edge and interior counts plus vertex numbering from the patch segment counts (spans and values must already be set)
+static void _NurbsSurfaceAdaptiveLayoutBuild(const std::vector<WPUInt> &segments, _NurbsSurfaceAdaptiveLayout &layout) {
+	const WPUInt numU = layout.numU, numV = layout.numV;
+	WPUInt i, j, k, p, e, nU, nV;
+	//Shared edges take the finer count of the two patches on either side
+	layout.edgesU.assign((numV + 1) * numU, 0);
+	layout.edgesV.assign(numV * (numU + 1), 0);
+	for (j=0; j<=numV; j++) {
+		for (i=0; i<numU; i++) {
+			e = (j > 0) ? segments.at(((j-1) * numU + i) * 2) : 0;
+			if (j < numV) e = STDMAX(e, segments.at((j * numU + i) * 2));
+			layout.edgesU.at(j * numU + i) = e;
+		}
+	}
+	for (j=0; j<numV; j++) {
+		for (i=0; i<=numU; i++) {
+			e = (i > 0) ? segments.at((j * numU + i - 1) * 2 + 1) : 0;
+			if (i < numU) e = STDMAX(e, segments.at((j * numU + i) * 2 + 1));
+			layout.edgesV.at(j * (numU + 1) + i) = e;
+		}
+	}
+	//Patches that disagree with an edge are stitched to it around an interior ring (so need at least 2x2 segments)
+	layout.innerU.assign(numU * numV, 0);
+	layout.innerV.assign(numU * numV, 0);
+	layout.stitched.assign(numU * numV, false);
+	for (j=0; j<numV; j++) {
+		for (i=0; i<numU; i++) {
+			p = j * numU + i;
+			nU = segments.at(p*2);
+			nV = segments.at(p*2+1);
+			layout.stitched.at(p) = (layout.edgesU.at(j * numU + i) != nU) || (layout.edgesU.at((j+1) * numU + i) != nU) ||
+				(layout.edgesV.at(j * (numU + 1) + i) != nV) || (layout.edgesV.at(j * (numU + 1) + i + 1) != nV);
+			layout.innerU.at(p) = layout.stitched.at(p) ? STDMAX(nU, (WPUInt)2) : nU;
+			layout.innerV.at(p) = layout.stitched.at(p) ? STDMAX(nV, (WPUInt)2) : nV;
+		}
+	}
+	//Number the vertices group by group
+	layout.startU.assign(layout.edgesU.size(), 0);
+	layout.startV.assign(layout.edgesV.size(), 0);
+	layout.startP.assign(numU * numV, 0);
+	layout.numVerts = (numU + 1) * (numV + 1);
+	for (k=0; k<layout.edgesU.size(); k++) { layout.startU.at(k) = layout.numVerts; layout.numVerts += layout.edgesU.at(k) - 1; }
+	for (k=0; k<layout.edgesV.size(); k++) { layout.startV.at(k) = layout.numVerts; layout.numVerts += layout.edgesV.at(k) - 1; }
+	for (p=0; p<layout.startP.size(); p++) {
+		layout.startP.at(p) = layout.numVerts;
+		layout.numVerts += (layout.innerU.at(p) - 1) * (layout.innerV.at(p) - 1);
+	}
+}
+
+
+//Append count vertices from first to a list of (first, count) runs - touching runs are joined
+static void _NurbsSurfaceAddRun(std::vector<WPUInt> &runs, const WPUInt &first, const WPUInt &count) {
+	if (count == 0) return;
+	if (!runs.empty() && (runs.at(runs.size()-2) + runs.back() == first)) runs.back() += count;
+	else {
+		runs.push_back(first);
+		runs.push_back(count);
+	}
+}
+
+
+//Vertices of patches i0..i1 x j0..j1, packed in run order (corners, U edges, V edges, interiors - a row at a time).
+//	The whole surface is one run in vertex order.  A NULL vData only collects the runs.
+static void _NurbsSurfaceAdaptiveBlock(const _NurbsSurfaceAdaptiveJob &job, const _NurbsSurfaceAdaptiveLayout &layout,
+	const WPUInt &i0, const WPUInt &i1, const WPUInt &j0, const WPUInt &j1, std::vector<WPUInt> &runs,
+	GLfloat *vData, GLfloat *nData, GLfloat *tData) {
+	const WPUInt numU = layout.numU, numV = layout.numV;
+	WPUInt i, j, k, a, b, p, e, nU, nV, n = 0;
+	WPFloat u, v, du, dv;
+	//Corners
+	for (j=j0; j<=j1+1; j++) {
+		_NurbsSurfaceAddRun(runs, j * (numU + 1) + i0, i1 - i0 + 2);
+		if (vData == NULL) continue;
+		for (i=i0; i<=i1+1; i++)
+			_NurbsSurfaceAdaptiveVertex(job, layout.spansU.at(STDMIN(i, numU-1)), layout.spansV.at(STDMIN(j, numV-1)),
+				layout.valuesU.at(i), layout.valuesV.at(j), n++, vData, nData, tData);
+	}
+	//Edges running along U
+	for (j=j0; j<=j1+1; j++) {
+		k = j * numU;
+		_NurbsSurfaceAddRun(runs, layout.startU.at(k + i0), layout.startU.at(k + i1) + layout.edgesU.at(k + i1) - 1 - layout.startU.at(k + i0));
+		if (vData == NULL) continue;
+		for (i=i0; i<=i1; i++) {
+			e = layout.edgesU.at(k + i);
+			du = (layout.valuesU.at(i+1) - layout.valuesU.at(i)) / e;
+			for (a=1; a<e; a++)
+				_NurbsSurfaceAdaptiveVertex(job, layout.spansU.at(i), layout.spansV.at(STDMIN(j, numV-1)),
+					layout.valuesU.at(i) + du * a, layout.valuesV.at(j), n++, vData, nData, tData);
+		}
+	}
+	//Edges running along V
+	for (j=j0; j<=j1; j++) {
+		k = j * (numU + 1);
+		_NurbsSurfaceAddRun(runs, layout.startV.at(k + i0), layout.startV.at(k + i1 + 1) + layout.edgesV.at(k + i1 + 1) - 1 - layout.startV.at(k + i0));
+		if (vData == NULL) continue;
+		for (i=i0; i<=i1+1; i++) {
+			e = layout.edgesV.at(k + i);
+			dv = (layout.valuesV.at(j+1) - layout.valuesV.at(j)) / e;
+			for (b=1; b<e; b++)
+				_NurbsSurfaceAdaptiveVertex(job, layout.spansU.at(STDMIN(i, numU-1)), layout.spansV.at(j),
+					layout.valuesU.at(i), layout.valuesV.at(j) + dv * b, n++, vData, nData, tData);
+		}
+	}
+	//Patch interiors
+	for (j=j0; j<=j1; j++) {
+		k = j * numU;
+		p = k + i1;
+		_NurbsSurfaceAddRun(runs, layout.startP.at(k + i0),
+			layout.startP.at(p) + (layout.innerU.at(p) - 1) * (layout.innerV.at(p) - 1) - layout.startP.at(k + i0));
+		if (vData == NULL) continue;
+		for (i=i0; i<=i1; i++) {
+			p = k + i;
+			nU = layout.innerU.at(p);
+			nV = layout.innerV.at(p);
+			du = (layout.valuesU.at(i+1) - layout.valuesU.at(i)) / nU;
+			dv = (layout.valuesV.at(j+1) - layout.valuesV.at(j)) / nV;
+			for (b=1; b<nV; b++) {
+				v = layout.valuesV.at(j) + dv * b;
+				for (a=1; a<nU; a++) {
+					u = layout.valuesU.at(i) + du * a;
+					_NurbsSurfaceAdaptiveVertex(job, layout.spansU.at(i), layout.spansV.at(j), u, v, n++, vData, nData, tData);
+				}
+			}
+		}
+	}
+}
+
+
+//Shared state for mass properties - the surface plus optional u,v trim loops (closed, as u,v pairs)
+struct _NurbsSurfaceMassJob {
+	_NurbsSurfaceAdaptiveJob					geometry;
+	const std::vector< std::vector<WPFloat> >	*loops;
+};
+
+
+static bool _NurbsSurfaceInsideLoops(const std::vector< std::vector<WPFloat> > &loops, const WPFloat &u, const WPFloat &v) {
+	bool inside = false;
+	WPUInt i, j, n;
+	//Even-odd rule over every loop, so holes fall out
+	for (WPUInt l=0; l<loops.size(); l++) {
+		const std::vector<WPFloat> &loop = loops.at(l);
+		n = (WPUInt)loop.size() / 2;
+		for (i=0, j=n-1; i<n; j=i++) {
+			if (((loop[i*2+1] > v) != (loop[j*2+1] > v)) &&
+				(u < (loop[j*2] - loop[i*2]) * (v - loop[i*2+1]) / (loop[j*2+1] - loop[i*2+1]) + loop[i*2]))
+				inside = !inside;
+		}
+	}
+	return inside;
+}
+
+
+//Returns 1 for a cell inside the loops, 0 for one outside, and -1 if a loop may cross it
+static int _NurbsSurfaceClassifyCell(const std::vector< std::vector<WPFloat> > &loops, const WPFloat &u0, const WPFloat &u1,
+	const WPFloat &v0, const WPFloat &v1) {
+	WPUInt i, j, n;
+	WPFloat du, dv, s0, s1, s2, s3;
+	for (WPUInt l=0; l<loops.size(); l++) {
+		const std::vector<WPFloat> &loop = loops.at(l);
+		n = (WPUInt)loop.size() / 2;
+		for (i=0, j=n-1; i<n; j=i++) {
+			//Segment box against the cell box first
+			if ((STDMAX(loop[i*2], loop[j*2]) < u0) || (STDMIN(loop[i*2], loop[j*2]) > u1) ||
+				(STDMAX(loop[i*2+1], loop[j*2+1]) < v0) || (STDMIN(loop[i*2+1], loop[j*2+1]) > v1)) continue;
+			//Then the cell corners against the segment's line - all on one side means no crossing
+			du = loop[i*2] - loop[j*2];
+			dv = loop[i*2+1] - loop[j*2+1];
+			s0 = du * (v0 - loop[j*2+1]) - dv * (u0 - loop[j*2]);
+			s1 = du * (v0 - loop[j*2+1]) - dv * (u1 - loop[j*2]);
+			s2 = du * (v1 - loop[j*2+1]) - dv * (u0 - loop[j*2]);
+			s3 = du * (v1 - loop[j*2+1]) - dv * (u1 - loop[j*2]);
+			if (((s0 > 0.0) && (s1 > 0.0) && (s2 > 0.0) && (s3 > 0.0)) ||
+				((s0 < 0.0) && (s1 < 0.0) && (s2 < 0.0) && (s3 < 0.0))) continue;
+			return -1;
+		}
+	}
+	return _NurbsSurfaceInsideLoops(loops, (u0 + u1) * 0.5, (v0 + v1) * 0.5) ? 1 : 0;
+}
+
+
+static void _NurbsSurfaceMassGauss(const _NurbsSurfaceMassJob &job, const WPUInt &spanU, const WPUInt &spanV,
+	const WPFloat &u0, const WPFloat &u1, const WPFloat &v0, const WPFloat &v1, const bool &clip, WPFloat *sums) {
+	WPFloat hu = (u1 - u0) * 0.5, hv = (v1 - v0) * 0.5, u, v, w, p[3], d[6], n[3], x2, y2, z2;
+	WPUInt i, j, k;
+	for (k=0; k<NURBSSURFACE_MASS_TERMS; k++) sums[k] = 0.0;
+	for (j=0; j<NURBS_GAUSS_POINTS; j++) {
+		v = v0 + hv * (1.0 + WCNurbs::GaussNodes[j]);
+		for (i=0; i<NURBS_GAUSS_POINTS; i++) {
+			u = u0 + hu * (1.0 + WCNurbs::GaussNodes[i]);
+			if (clip && !_NurbsSurfaceInsideLoops(*job.loops, u, v)) continue;
+			_NurbsSurfaceSpanPoint(job.geometry, spanU, spanV, u, v, p, NULL, d);
+			//Area element Su x Sv
+			n[0] = d[1] * d[5] - d[2] * d[4];
+			n[1] = d[2] * d[3] - d[0] * d[5];
+			n[2] = d[0] * d[4] - d[1] * d[3];
+			w = WCNurbs::GaussWeights[i] * WCNurbs::GaussWeights[j] * hu * hv;
+			x2 = p[0] * p[0];
+			y2 = p[1] * p[1];
+			z2 = p[2] * p[2];
+			//Divergence theorem turns each volume integral into one over the surface
+			sums[0] += w * sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			sums[1] += w * (p[0] * n[0] + p[1] * n[1] + p[2] * n[2]) / 3.0;
+			sums[2] += w * x2 * n[0] * 0.5;
+			sums[3] += w * y2 * n[1] * 0.5;
+			sums[4] += w * z2 * n[2] * 0.5;
+			sums[5] += w * x2 * p[0] * n[0] / 3.0;
+			sums[6] += w * y2 * p[1] * n[1] / 3.0;
+			sums[7] += w * z2 * p[2] * n[2] / 3.0;
+			sums[8] += w * x2 * p[1] * n[0] * 0.5;
+			sums[9] += w * y2 * p[2] * n[1] * 0.5;
+			sums[10] += w * z2 * p[0] * n[2] * 0.5;
+		}
+	}
+}
+
+
+static void _NurbsSurfaceMassCell(const _NurbsSurfaceMassJob &job, const WPUInt &spanU, const WPUInt &spanV,
+	const WPFloat &u0, const WPFloat &u1, const WPFloat &v0, const WPFloat &v1, const WPFloat *whole,
+	const WPFloat &tolerance, const WPUInt &depth, WPFloat *sums) {
+	//Whole is NULL for cells a trim loop may cross
+	WPFloat um = (u0 + u1) * 0.5, vm = (v0 + v1) * 0.5, split[NURBSSURFACE_MASS_TERMS], quads[4][NURBSSURFACE_MASS_TERMS];
+	WPFloat bounds[4][4] = { { u0, um, v0, vm }, { um, u1, v0, vm }, { u0, um, vm, v1 }, { um, u1, vm, v1 } };
+	int state[4];
+	bool crossed = false;
+	WPUInt q, k;
+	for (k=0; k<NURBSSURFACE_MASS_TERMS; k++) split[k] = 0.0;
+	//Cells outside the trim loops drop out, cells crossed by one split down to full depth
+	for (q=0; q<4; q++) {
+		state[q] = (job.loops == NULL) ? 1 : _NurbsSurfaceClassifyCell(*job.loops, bounds[q][0], bounds[q][1], bounds[q][2], bounds[q][3]);
+		if (state[q] < 0) crossed = true;
+	}
+	crossed = crossed && (depth < NURBSSURFACE_MASS_TRIM_DEPTH);
+	//Integrate the four quarters (crossed ones only once they are small enough)
+	for (q=0; q<4; q++) {
+		if ((state[q] == 0) || (crossed && (state[q] < 0))) continue;
+		_NurbsSurfaceMassGauss(job, spanU, spanV, bounds[q][0], bounds[q][1], bounds[q][2], bounds[q][3], state[q] < 0, quads[q]);
+		for (k=0; k<NURBSSURFACE_MASS_TERMS; k++) split[k] += quads[q][k];
+	}
+	//Accept when the quarters agree with the whole
+	if ((!crossed) && ((depth >= NURBSSURFACE_MASS_MAX_DEPTH) || (state[0] < 0) || (state[1] < 0) || (state[2] < 0) || (state[3] < 0) ||
+		((whole != NULL) && (fabs(split[0] - whole[0]) <= tolerance)))) {
+		for (k=0; k<NURBSSURFACE_MASS_TERMS; k++) sums[k] += split[k];
+		return;
+	}
+	for (q=0; q<4; q++)
+		if (state[q] != 0) _NurbsSurfaceMassCell(job, spanU, spanV, bounds[q][0], bounds[q][1], bounds[q][2], bounds[q][3],
+			(crossed && (state[q] < 0)) ? NULL : quads[q], tolerance * 0.25, depth+1, sums);
+}
+
+
+//Shared state for point inversion - the surface, its hierarchy, the domain and the batch arrays
+struct _NurbsSurfaceInversionJob {
+	_NurbsSurfaceAdaptiveJob					geometry;
+	WPUInt										cpV;
+	const WCBezierHierarchy						*hierarchy;
+	WPFloat										uMin, uMax, vMin, vMax;
+	const WPFloat								*points;
+	WPFloat										*uv;
+	WPUInt										count;
+};
+
+
+static WPFloat _NurbsSurfaceInversionPoint(const _NurbsSurfaceInversionJob &job, const WPFloat &u, const WPFloat &v,
+	const WPFloat *point, WPFloat *r, WPFloat *d) {
+	WPFloat p[3];
+	_NurbsSurfaceSpanPoint(job.geometry, WCNurbs::FindSpan(job.geometry.cpU, job.geometry.degreeU, u, job.geometry.knotPointsU),
+		WCNurbs::FindSpan(job.cpV, job.geometry.degreeV, v, job.geometry.knotPointsV), u, v, p, NULL, d);
+	r[0] = p[0] - point[0];
+	r[1] = p[1] - point[1];
+	r[2] = p[2] - point[2];
+	return sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+}
+
+
+static WPFloat _NurbsSurfaceInvert(const _NurbsSurfaceInversionJob &job, const WPFloat *point, WPFloat &u, WPFloat &v) {
+	WPFloat r[3], d[6], nr[3], nd[6], a11, a12, a22, b1, b2, det, du, dv, nu, nv, dist, nextDist;
+	WPUInt iter, half, i;
+	//Seed from the closest hierarchy piece - global, so no local minimum traps
+	job.hierarchy->Distance(WCVector4(point[0], point[1], point[2], 1.0), u, v);
+	u = STDMAX(job.uMin, STDMIN(job.uMax, u));
+	v = STDMAX(job.vMin, STDMIN(job.vMax, v));
+	dist = _NurbsSurfaceInversionPoint(job, u, v, point, r, d);
+	//Gauss-Newton on the squared distance, clamped to the domain, never letting the distance grow
+	for (iter=0; iter<NURBSSURFACE_INVERSION_MAX_ITERATIONS; iter++) {
+		a11 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+		a12 = d[0] * d[3] + d[1] * d[4] + d[2] * d[5];
+		a22 = d[3] * d[3] + d[4] * d[4] + d[5] * d[5];
+		b1 = -(r[0] * d[0] + r[1] * d[1] + r[2] * d[2]);
+		b2 = -(r[0] * d[3] + r[1] * d[4] + r[2] * d[5]);
+		det = a11 * a22 - a12 * a12;
+		//Degenerate edges (poles, collapsed rows) - step each direction on its own
+		if (det <= NURBSSURFACE_INVERSION_EPSILON * a11 * a22) {
+			du = (a11 > 0.0) ? b1 / a11 : 0.0;
+			dv = (a22 > 0.0) ? b2 / a22 : 0.0;
+		}
+		else {
+			du = (b1 * a22 - b2 * a12) / det;
+			dv = (a11 * b2 - a12 * b1) / det;
+		}
+		//Halve the step until the distance drops
+		for (half=0; half<NURBSSURFACE_INVERSION_MAX_HALVINGS; half++, du *= 0.5, dv *= 0.5) {
+			nu = STDMAX(job.uMin, STDMIN(job.uMax, u + du));
+			nv = STDMAX(job.vMin, STDMIN(job.vMax, v + dv));
+			nextDist = _NurbsSurfaceInversionPoint(job, nu, nv, point, nr, nd);
+			if (nextDist <= dist) break;
+		}
+		if (half == NURBSSURFACE_INVERSION_MAX_HALVINGS) break;
+		du = nu - u;
+		dv = nv - v;
+		u = nu;
+		v = nv;
+		dist = nextDist;
+		for (i=0; i<3; i++) r[i] = nr[i];
+		for (i=0; i<6; i++) d[i] = nd[i];
+		if (fabs(du) + fabs(dv) < NURBSSURFACE_INVERSION_EPSILON) break;
+	}
+	return dist;
+}
+
+
+static void _NurbsSurfaceInversionTask(void *data, const WPUInt &index) {
+	_NurbsSurfaceInversionJob *job = (_NurbsSurfaceInversionJob*)data;
+	WPUInt last = STDMIN(job->count, (index + 1) * NURBSSURFACE_INVERSION_BLOCK);
+	for (WPUInt i=index*NURBSSURFACE_INVERSION_BLOCK; i<last; i++)
+		_NurbsSurfaceInvert(*job, job->points + i*4, job->uv[i*2], job->uv[i*2+1]);
+}
+
+
+/***********************************************~***************************************************/
+
+
+WSMassProperties::WSMassProperties() : area(0.0), volume(0.0), centroid(0.0, 0.0, 0.0, 1.0), seconds(0.0) {
+	for (WPUInt i=0; i<3; i++) this->moments[i] = 0.0;
+	for (WPUInt i=0; i<6; i++) this->products[i] = this->inertia[i] = 0.0;
+}
+
+
+void WSMassProperties::Add(const WSMassProperties &props, const bool &orientation) {
+	//Reversed faces flip the volume terms, but not the area
+	WPFloat sign = orientation ? 1.0 : -1.0;
+	this->area += props.area;
+	this->volume += sign * props.volume;
+	for (WPUInt i=0; i<3; i++) this->moments[i] += sign * props.moments[i];
+	for (WPUInt i=0; i<6; i++) this->products[i] += sign * props.products[i];
+}
+
+
+void WSMassProperties::Finish(void) {
+	WPUInt i;
+	//Shells with inward normals come out negative - flip them over
+	if (this->volume < 0.0) {
+		this->volume = -this->volume;
+		for (i=0; i<3; i++) this->moments[i] = -this->moments[i];
+		for (i=0; i<6; i++) this->products[i] = -this->products[i];
+	}
+	if (this->volume <= 0.0) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WSMassProperties::Finish - No enclosed volume.");
+		return;
+	}
+	WPFloat cx = this->moments[0] / this->volume, cy = this->moments[1] / this->volume, cz = this->moments[2] / this->volume;
+	this->centroid.Set(cx, cy, cz, 1.0);
+	//Tensor about the origin, moved to the centroid by the parallel axis theorem
+	this->inertia[0] = this->products[1] + this->products[2] - this->volume * (cy * cy + cz * cz);
+	this->inertia[1] = this->products[0] + this->products[2] - this->volume * (cx * cx + cz * cz);
+	this->inertia[2] = this->products[0] + this->products[1] - this->volume * (cx * cx + cy * cy);
+	this->inertia[3] = -(this->products[3] - this->volume * cx * cy);
+	this->inertia[4] = -(this->products[4] - this->volume * cy * cz);
+	this->inertia[5] = -(this->products[5] - this->volume * cz * cx);
+}
 
 
 /***********************************************~***************************************************/
@@ -513,84 +1184,51 @@ WCNurbsSurface::GenerateSurfaceMedium(const WPFloat &uStart, const WPFloat &uSto
 std::vector<GLfloat*>
 WCNurbsSurface::GenerateSurfaceLow(const WPFloat &uStart, const WPFloat &uStop, const WPUInt &lodU,
 	const WPFloat &vStart, const WPFloat &vStop, const WPUInt &lodV, const bool &server, std::vector<GLuint> &buffers) {
-	int vIndex, nIndex, tIndex, index;
-	WPFloat u = this->_knotPointsU[0];
-	WPFloat v = this->_knotPointsV[0];
-	WPFloat range = this->_knotPointsU[this->_kpU-1] - this->_knotPointsU[0];
-	WPFloat du = range / ((GLfloat)(lodU-1));
-	range = this->_knotPointsV[this->_kpV-1] - this->_knotPointsV[0];
-	WPFloat dv = range / ((GLfloat)(lodV-1));
 	WPUInt numVerts = lodU * lodV;
+	//Basis only depends on knots, degree and lod - reuse it when just the control points have moved
+	if (!this->_basisCacheU.IsValid(this->_cpU, this->_degreeU, this->_knotPointsU,
+		this->_knotPointsU[0], this->_knotPointsU[this->_kpU-1], lodU, 1) &&
+		!this->_basisCacheU.Build(this->_cpU, this->_degreeU, this->_knotPointsU,
+			this->_knotPointsU[0], this->_knotPointsU[this->_kpU-1], lodU, 1)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateSurfaceLow - Unable to build U basis cache.");
+		return std::vector<GLfloat*>();
+	}
+	if (!this->_basisCacheV.IsValid(this->_cpV, this->_degreeV, this->_knotPointsV,
+		this->_knotPointsV[0], this->_knotPointsV[this->_kpV-1], lodV, 1) &&
+		!this->_basisCacheV.Build(this->_cpV, this->_degreeV, this->_knotPointsV,
+			this->_knotPointsV[0], this->_knotPointsV[this->_kpV-1], lodV, 1)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateSurfaceLow - Unable to build V basis cache.");
+		return std::vector<GLfloat*>();
+	}
 
 	//Create a temporary array (NumVert vertices)
 	GLfloat *vData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_VERTEX];
 	GLfloat *nData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_NORMAL];
 	GLfloat *tData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_TEXCOORD];
-	WPFloat *bvU, *bvV;
+	//Flatten the control net into homogeneous coordinates
+	WPUInt numCP = this->_cpU * this->_cpV;
+	WPFloat *hcp = new WPFloat[numCP * 4];
 	WCVector4 pt;
-	int spanU, spanV;
-	WCVector4 S, Su, Sv, norm;
-	WPFloat D, Du, Dv;
-	
-	//Zero all of the indices
-	vIndex = nIndex = tIndex = 0;
-	//Loop through v
-	for (WPUInt i=0; i<lodV; i++) {
-		//Reset u each loop
-		u = this->_knotPointsU[0];
-		//Loop through u
-		for (WPUInt j=0; j<lodU; j++) {
-			/*** Calculate point and normal ***/
-			//Init the point values
-			S.Set(0.0, 0.0, 0.0, 0.0);
-			Su.Set(0.0, 0.0, 0.0, 0.0);
-			Sv.Set(0.0, 0.0, 0.0, 0.0);
-			D = Du = Dv = 0.0;
-			//Find the span and basis values up to second derivative
-			spanU = WCNurbs::FindSpan(this->_cpU, this->_degreeU, u, this->_knotPointsU);
-			bvU = WCNurbs::BasisValues(spanU, u, this->_degreeU, this->_knotPointsU, 1);
-			spanV = WCNurbs::FindSpan(this->_cpV, this->_degreeV, v, this->_knotPointsV);
-			bvV = WCNurbs::BasisValues(spanV, v, this->_degreeV, this->_knotPointsV, 1);
-			//Evaluate the point
-			for(WPUInt k=0; k<=this->_degreeV; k++) {
-				//Determine the index of the control point
-				index = (this->_cpU * (spanV - this->_degreeV + k)) + spanU - this->_degreeU;
-				for (WPUInt l=0; l<=this->_degreeU; l++) {
-					pt = this->_controlPoints.at(index);
-					S += pt * (pt.L() * bvU[l] * bvV[k]);
-					D += pt.L() * bvU[l] * bvV[k];
-					Su += pt * (pt.L() * bvU[l+this->_degreeU+1] * bvV[k]);
-					Du += pt.L() * bvU[l+this->_degreeU+1] * bvV[k];
-					Sv += pt * (pt.L() * bvU[l] * bvV[k+this->_degreeV+1]);
-					Dv += pt.L() * bvU[l] * bvV[k+this->_degreeV+1];
-					index++;
-				}
-			}
-			//Calculate final values
-			S /= D;
-			Su = (Su * D - S * Du) / (D * D);
-			Sv = (Sv * D - S * Dv) / (D * D);
-			//Make sure to delete the basis values
-			delete bvU;
-			delete bvV;
-			//Cross sU and sV and normalize to get normal vector
-			norm = (Su.CrossProduct(Sv)).Normalize(true);
-			//Place data into array
-			vData[vIndex++] = (GLfloat)S.I();
-			vData[vIndex++] = (GLfloat)S.J();
-			vData[vIndex++] = (GLfloat)S.K();
-			vData[vIndex++] = 1.0;
-			nData[nIndex++] = (GLfloat)norm.I();
-			nData[nIndex++] = (GLfloat)norm.J();
-			nData[nIndex++] = (GLfloat)norm.K();
-			nData[nIndex++] = 0.0;
-			tData[tIndex++] = (GLfloat)u;
-			tData[tIndex++] = (GLfloat)v;		
-			//Increment u (up to kp-1)
-			u = STDMIN(u+du, this->_knotPointsU[this->_kpU-1]);				
-		}
-		v = STDMIN(v+dv, this->_knotPointsV[this->_kpV-1]);
+	for (WPUInt i=0; i<numCP; i++) {
+		pt = this->_controlPoints.at(i);
+		hcp[i*4]   = pt.I() * pt.L();
+		hcp[i*4+1] = pt.J() * pt.L();
+		hcp[i*4+2] = pt.K() * pt.L();
+		hcp[i*4+3] = pt.L();
+	}
+	//Evaluate every sample from the cached basis - large grids are split into row tiles on the shared pool
+	if (numVerts < NURBSSURFACE_PARALLEL_CUTOFF)
+		_NurbsSurfaceCachedSamples(this->_basisCacheU, this->_basisCacheV, this->_degreeU, this->_degreeV, this->_cpU, hcp,
+			0, lodV-1, 0, lodU-1, vData, nData, tData);
+	else {
+		WCThreadPool *pool = WCThreadPool::Shared();
+		_NurbsSurfaceLowJob job = { &this->_basisCacheU, &this->_basisCacheV, this->_degreeU, this->_degreeV, this->_cpU,
+			lodU, lodV, 0, hcp, vData, nData, tData };
+		WPUInt numTiles = STDMIN(lodV, pool->ThreadCount() * 4);
+		job.rowsPerTile = (lodV + numTiles - 1) / numTiles;
+		pool->ParallelFor((lodV + job.rowsPerTile - 1) / job.rowsPerTile, _NurbsSurfaceLowTile, &job);
 	}
+	delete [] hcp;
 
 	//Check to see if server side buffers
 	if (server) {
@@ -644,6 +1282,281 @@ WCNurbsSurface::GenerateSurfaceLow(const WPFloat &uStart, const WPFloat &uStop,
 }
 
 
+std::vector<GLfloat*> WCNurbsSurface::GenerateSurfaceAdaptive(const WPFloat &chordTolerance, std::vector<WPUInt> &segments,
+	const bool &reuse, WPUInt &numVerts, WPUInt &numTriangles, std::vector<WPUInt> *runs) {
+	WPUInt i, j, k, a, b, p, nU, nV;
+	numVerts = numTriangles = 0;
+	if (runs != NULL) runs->clear();
+	//Each patch is one non-empty knot span in U and V
+	_NurbsSurfaceAdaptiveLayout layout;
+	std::vector<WPUInt> &spansU = layout.spansU, &spansV = layout.spansV;
+	for (i=this->_degreeU; i<this->_cpU; i++) if (this->_knotPointsU[i] < this->_knotPointsU[i+1]) spansU.push_back(i);
+	for (i=this->_degreeV; i<this->_cpV; i++) if (this->_knotPointsV[i] < this->_knotPointsV[i+1]) spansV.push_back(i);
+	WPUInt numU = layout.numU = (WPUInt)spansU.size(), numV = layout.numV = (WPUInt)spansV.size();
+	if ((numU == 0) || (numV == 0)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateSurfaceAdaptive - No non-empty knot spans.");
+		return std::vector<GLfloat*>();
+	}
+	//Knot values of the patch boundaries
+	layout.valuesU.resize(numU + 1);
+	layout.valuesV.resize(numV + 1);
+	for (i=0; i<numU; i++) layout.valuesU.at(i) = this->_knotPointsU[spansU.at(i)];
+	layout.valuesU.at(numU) = this->_knotPointsU[spansU.at(numU-1) + 1];
+	for (j=0; j<numV; j++) layout.valuesV.at(j) = this->_knotPointsV[spansV.at(j)];
+	layout.valuesV.at(numV) = this->_knotPointsV[spansV.at(numV-1) + 1];
+	//Flatten the control net into homogeneous coordinates
+	WPUInt numCP = this->_cpU * this->_cpV;
+	WPFloat *hcp = new WPFloat[numCP * 4];
+	WCVector4 pt;
+	for (i=0; i<numCP; i++) {
+		pt = this->_controlPoints.at(i);
+		hcp[i*4]   = pt.I() * pt.L();
+		hcp[i*4+1] = pt.J() * pt.L();
+		hcp[i*4+2] = pt.K() * pt.L();
+		hcp[i*4+3] = pt.L();
+	}
+	_NurbsSurfaceAdaptiveJob job = { this->_degreeU, this->_degreeV, this->_cpU, this->_knotPointsU, this->_knotPointsV, hcp };
+
+	/*** Segment counts for each patch come from its flatness ***/
+	bool keep = reuse && (segments.size() == numU * numV * 2);
+	if (!keep) segments.assign(numU * numV * 2, 0);
+	std::vector<WPUInt> previous;
+	if (keep && (runs != NULL)) previous = segments;
+	//Control point k only affects spans k to k+degree - clean patches keep their counts
+	WPUInt i0 = numU, i1 = 0, j0 = numV, j1 = 0;
+	for (i=0; i<numU; i++)
+		if ((spansU.at(i) >= this->_dirtyLowU) && (spansU.at(i) <= this->_dirtyHighU + this->_degreeU)) { i0 = STDMIN(i0, i); i1 = i; }
+	for (j=0; j<numV; j++)
+		if ((spansV.at(j) >= this->_dirtyLowV) && (spansV.at(j) <= this->_dirtyHighV + this->_degreeV)) { j0 = STDMIN(j0, j); j1 = j; }
+	for (j=0; j<numV; j++) {
+		for (i=0; i<numU; i++) {
+			if (keep && ((i < i0) || (i > i1) || (j < j0) || (j > j1))) continue;
+			p = j * numU + i;
+			_NurbsSurfacePatchSegments(job, spansU.at(i), spansV.at(j), chordTolerance, segments.at(p*2), segments.at(p*2+1));
+		}
+	}
+	_NurbsSurfaceAdaptiveLayoutBuild(segments, layout);
+	numVerts = layout.numVerts;
+	//Unchanged counts mean an unchanged mesh - only the dirty patches' vertices and normals move
+	if (keep && (runs != NULL) && (i0 <= i1) && (j0 <= j1) && (segments == previous)) {
+		_NurbsSurfaceAdaptiveBlock(job, layout, i0, i1, j0, j1, *runs, NULL, NULL, NULL);
+		WPUInt count = 0;
+		for (k=1; k<runs->size(); k+=2) count += runs->at(k);
+		GLfloat *vData = new GLfloat[count * NURBSSURFACE_FLOATS_PER_VERTEX];
+		GLfloat *nData = new GLfloat[count * NURBSSURFACE_FLOATS_PER_NORMAL];
+		runs->clear();
+		_NurbsSurfaceAdaptiveBlock(job, layout, i0, i1, j0, j1, *runs, vData, nData, NULL);
+		delete [] hcp;
+		std::vector<GLfloat*> retVals;
+		retVals.push_back(vData);			// Must be first
+		retVals.push_back(nData);			// Must be second
+		return retVals;
+	}
+
+	/*** Vertices - patch corners, then edge interiors, then patch interiors ***/
+	GLfloat *vData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_VERTEX];
+	GLfloat *nData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_NORMAL];
+	GLfloat *tData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_TEXCOORD];
+	std::vector<WPUInt> all;
+	_NurbsSurfaceAdaptiveBlock(job, layout, 0, numU - 1, 0, numV - 1, all, vData, nData, tData);
+	delete [] hcp;
+	const std::vector<WPUInt> &edgesU = layout.edgesU, &edgesV = layout.edgesV, &innerU = layout.innerU, &innerV = layout.innerV;
+	const std::vector<WPUInt> &startU = layout.startU, &startV = layout.startV, &startP = layout.startP;
+	const std::vector<bool> &stitched = layout.stitched;
+
+	/*** Triangles - regular patches are plain grids, stitched ones zip their edges to the interior ring ***/
+	std::vector<GLuint> triangles, grid, bottom, top, left, right, innerBottom, innerTop, innerLeft, innerRight;
+	for (j=0; j<numV; j++) {
+		for (i=0; i<numU; i++) {
+			p = j * numU + i;
+			nU = innerU.at(p);
+			nV = innerV.at(p);
+			//Gather the four edges of the patch (corner to corner, increasing parameter)
+			bottom.assign(1, (GLuint)(j * (numU + 1) + i));
+			top.assign(1, (GLuint)((j + 1) * (numU + 1) + i));
+			left.assign(1, (GLuint)(j * (numU + 1) + i));
+			right.assign(1, (GLuint)(j * (numU + 1) + i + 1));
+			for (k=1; k<edgesU.at(j * numU + i); k++) bottom.push_back((GLuint)(startU.at(j * numU + i) + k - 1));
+			for (k=1; k<edgesU.at((j + 1) * numU + i); k++) top.push_back((GLuint)(startU.at((j + 1) * numU + i) + k - 1));
+			for (k=1; k<edgesV.at(j * (numU + 1) + i); k++) left.push_back((GLuint)(startV.at(j * (numU + 1) + i) + k - 1));
+			for (k=1; k<edgesV.at(j * (numU + 1) + i + 1); k++) right.push_back((GLuint)(startV.at(j * (numU + 1) + i + 1) + k - 1));
+			bottom.push_back((GLuint)(j * (numU + 1) + i + 1));
+			top.push_back((GLuint)((j + 1) * (numU + 1) + i + 1));
+			left.push_back((GLuint)((j + 1) * (numU + 1) + i));
+			right.push_back((GLuint)((j + 1) * (numU + 1) + i + 1));
+			//Lattice of vertex indices for the patch
+			grid.assign((nU + 1) * (nV + 1), 0);
+			for (b=1; b<nV; b++)
+				for (a=1; a<nU; a++) grid.at(b * (nU + 1) + a) = (GLuint)(startP.at(p) + (b - 1) * (nU - 1) + a - 1);
+			if (!stitched.at(p)) {
+				for (a=0; a<=nU; a++) { grid.at(a) = bottom.at(a); grid.at(nV * (nU + 1) + a) = top.at(a); }
+				for (b=0; b<=nV; b++) { grid.at(b * (nU + 1)) = left.at(b); grid.at(b * (nU + 1) + nU) = right.at(b); }
+			}
+			//Quads of the lattice (the outer ring is left for stitching)
+			k = stitched.at(p) ? 1 : 0;
+			for (b=k; b<nV-k; b++) {
+				for (a=k; a<nU-k; a++) {
+					//Upper triangle
+					triangles.push_back(grid.at(b * (nU + 1) + a));
+					triangles.push_back(grid.at((b + 1) * (nU + 1) + a));
+					triangles.push_back(grid.at((b + 1) * (nU + 1) + a + 1));
+					//Lower triangle
+					triangles.push_back(grid.at(b * (nU + 1) + a));
+					triangles.push_back(grid.at((b + 1) * (nU + 1) + a + 1));
+					triangles.push_back(grid.at(b * (nU + 1) + a + 1));
+				}
+			}
+			if (!stitched.at(p)) continue;
+			//Interior ring, then stitch each edge to it
+			innerBottom.clear();
+			innerTop.clear();
+			innerLeft.clear();
+			innerRight.clear();
+			for (a=1; a<nU; a++) {
+				innerBottom.push_back(grid.at(nU + 1 + a));
+				innerTop.push_back(grid.at((nV - 1) * (nU + 1) + a));
+			}
+			for (b=1; b<nV; b++) {
+				innerLeft.push_back(grid.at(b * (nU + 1) + 1));
+				innerRight.push_back(grid.at(b * (nU + 1) + nU - 1));
+			}
+			_NurbsSurfaceStitch(bottom, innerBottom, false, triangles);
+			_NurbsSurfaceStitch(right, innerRight, false, triangles);
+			_NurbsSurfaceStitch(top, innerTop, true, triangles);
+			_NurbsSurfaceStitch(left, innerLeft, true, triangles);
+		}
+	}
+	//Copy out the index data
+	numTriangles = (WPUInt)triangles.size() / 3;
+	GLuint *iData = new GLuint[triangles.size()];
+	for (k=0; k<triangles.size(); k++) iData[k] = triangles.at(k);
+	//Return client buffers
+	std::vector<GLfloat*> retVals;
+	retVals.push_back(vData);			// Must be first
+	retVals.push_back(nData);			// Must be second
+	retVals.push_back(tData);			// Must be third
+	retVals.push_back((GLfloat*)iData);	// Must be fourth
+	return retVals;
+}
+
+
+std::vector<GLfloat*> WCNurbsSurface::GenerateSurfaceStored(const WPFloat &chordTolerance, std::vector<WPUInt> &segments,
+	WPUInt &numVerts, WPUInt &numTriangles) {
+	//Hold the store so it can not be replaced and freed mid lookup
+	WCTessellationStore *store = WCTessellationStore::AcquireActive();
+	//Without a store this is just a full regeneration
+	if (store == NULL) return this->GenerateSurfaceAdaptive(chordTolerance, segments, false, numVerts, numTriangles);
+	WPHash hash = this->ContentHash();
+	WCTessellationKey key(NULL, 0, NURBSSURFACE_CACHE_ADAPTIVE);
+	key.values[0] = chordTolerance;
+	WCTessellation tess;
+	//Warm load - counts are vertices, triangles, then the segment counts of each patch
+	if (store->Find(hash, key, tess)) {
+		if ((tess.buffers.size() == 4) && (tess.counts.size() >= 2)) {
+			WCTessellationStore::Release(store);
+			numVerts = tess.counts.at(0);
+			numTriangles = tess.counts.at(1);
+			segments.assign(tess.counts.begin() + 2, tess.counts.end());
+			return tess.buffers;
+		}
+		this->ReleaseBuffers(tess.buffers);
+	}
+	//Cold load - generate and write it out for next time
+	tess.buffers = this->GenerateSurfaceAdaptive(chordTolerance, segments, false, numVerts, numTriangles);
+	if (tess.buffers.size() < 4) {
+		WCTessellationStore::Release(store);
+		return tess.buffers;
+	}
+	tess.counts.clear();
+	tess.counts.push_back(numVerts);
+	tess.counts.push_back(numTriangles);
+	tess.counts.insert(tess.counts.end(), segments.begin(), segments.end());
+	std::vector<WPUInt> sizes(4);
+	sizes.at(NURBSSURFACE_VERTEX_BUFFER) = numVerts * NURBSSURFACE_FLOATS_PER_VERTEX;
+	sizes.at(NURBSSURFACE_NORMAL_BUFFER) = numVerts * NURBSSURFACE_FLOATS_PER_NORMAL;
+	sizes.at(NURBSSURFACE_TEXCOORD_BUFFER) = numVerts * NURBSSURFACE_FLOATS_PER_TEXCOORD;
+	sizes.at(NURBSSURFACE_INDEX_BUFFER) = numTriangles * 3;
+	store->Store(hash, key, tess, sizes);
+	WCTessellationStore::Release(store);
+	return tess.buffers;
+}
+
+
+void WCNurbsSurface::MarkControlPointsDirty(const WPUInt &lowU, const WPUInt &highU, const WPUInt &lowV, const WPUInt &highV) {
+	//Grow the dirty block (unless the whole surface is already dirty)
+	if (!this->_isFullyDirty) {
+		if (this->_dirtyLowU > this->_dirtyHighU) {
+			this->_dirtyLowU = lowU;
+			this->_dirtyHighU = highU;
+			this->_dirtyLowV = lowV;
+			this->_dirtyHighV = highV;
+		}
+		else {
+			this->_dirtyLowU = STDMIN(this->_dirtyLowU, lowU);
+			this->_dirtyHighU = STDMAX(this->_dirtyHighU, highU);
+			this->_dirtyLowV = STDMIN(this->_dirtyLowV, lowV);
+			this->_dirtyHighV = STDMAX(this->_dirtyHighV, highV);
+		}
+	}
+	//Bypass the override so the block is kept
+	this->_revision++;
+	this->WCVisualObject::IsVisualDirty(true);
+}
+
+
+WSMassProperties WCNurbsSurface::IntegrateMass(const WPFloat &tolerance, const std::vector< std::vector<WPFloat> > *loops) {
+	WSMassProperties props;
+	WPFloat start = WCThreadPool::Seconds();
+	//Each Bezier patch is one non-empty knot span in U and V
+	std::vector<WPUInt> spansU, spansV;
+	WPUInt i, j, k;
+	for (i=this->_degreeU; i<this->_cpU; i++) if (this->_knotPointsU[i] < this->_knotPointsU[i+1]) spansU.push_back(i);
+	for (i=this->_degreeV; i<this->_cpV; i++) if (this->_knotPointsV[i] < this->_knotPointsV[i+1]) spansV.push_back(i);
+	WPUInt numU = (WPUInt)spansU.size(), numV = (WPUInt)spansV.size();
+	if ((numU == 0) || (numV == 0)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::IntegrateMass - No non-empty knot spans.");
+		return props;
+	}
+	//Flatten the control net into homogeneous coordinates
+	WPUInt numCP = this->_cpU * this->_cpV;
+	WPFloat *hcp = new WPFloat[numCP * 4];
+	WCVector4 pt;
+	for (i=0; i<numCP; i++) {
+		pt = this->_controlPoints.at(i);
+		hcp[i*4]   = pt.I() * pt.L();
+		hcp[i*4+1] = pt.J() * pt.L();
+		hcp[i*4+2] = pt.K() * pt.L();
+		hcp[i*4+3] = pt.L();
+	}
+	_NurbsSurfaceMassJob job = { { this->_degreeU, this->_degreeV, this->_cpU, this->_knotPointsU, this->_knotPointsV, hcp }, loops };
+	WPFloat sums[NURBSSURFACE_MASS_TERMS], whole[NURBSSURFACE_MASS_TERMS], u0, u1, v0, v1;
+	for (k=0; k<NURBSSURFACE_MASS_TERMS; k++) sums[k] = 0.0;
+	//Share the area tolerance between the patches
+	WPFloat patchTolerance = tolerance / (numU * numV);
+	int state;
+	for (j=0; j<numV; j++) {
+		v0 = this->_knotPointsV[spansV.at(j)];
+		v1 = this->_knotPointsV[spansV.at(j)+1];
+		for (i=0; i<numU; i++) {
+			u0 = this->_knotPointsU[spansU.at(i)];
+			u1 = this->_knotPointsU[spansU.at(i)+1];
+			state = (loops == NULL) ? 1 : _NurbsSurfaceClassifyCell(*loops, u0, u1, v0, v1);
+			if (state == 0) continue;
+			if (state > 0) _NurbsSurfaceMassGauss(job, spansU.at(i), spansV.at(j), u0, u1, v0, v1, false, whole);
+			_NurbsSurfaceMassCell(job, spansU.at(i), spansV.at(j), u0, u1, v0, v1, (state > 0) ? whole : NULL, patchTolerance, 0, sums);
+		}
+	}
+	delete [] hcp;
+	//Unpack the sums
+	props.area = sums[0];
+	props.volume = sums[1];
+	for (k=0; k<3; k++) props.moments[k] = sums[2+k];
+	for (k=0; k<6; k++) props.products[k] = sums[5+k];
+	props.seconds = WCThreadPool::Seconds() - start;
+	return props;
+}
+
+
 std::vector<GLfloat*>
 WCNurbsSurface::GenerateSurfaceSize4(const WPFloat &uStart, const WPFloat &uStop, const WPUInt &lodU,
 	const WPFloat &vStart, const WPFloat &vStop, const WPUInt &lodV, const bool &server, std::vector<GLuint> &buffers) {
@@ -828,7 +1741,9 @@ WCNurbsSurface::WCNurbsSurface(WCGeometryContext *context, const WPUInt &degreeU
 	const std::vector<WCVector4> &controlPoints, const WCNurbsMode &modeU, const WCNurbsMode &modeV, const std::vector<WPFloat> &kpU, const std::vector<WPFloat> &kpV) : 
 	::WCGeometricSurface(context), _degreeU(degreeU), _degreeV(degreeV), _modeU(modeU), _modeV(modeV), 
 	_cpU(cpU), _cpV(cpV), _controlPoints(controlPoints), _kpU(0), _kpV(0), _knotPointsU(NULL), _knotPointsV(NULL),
-	_lengthU(0.0), _lengthV(0.0), _lodU(0), _lodV(0), _buffers(), _altBuffers() {
+	_lengthU(0.0), _lengthV(0.0), _lodU(0), _lodV(0), _buffers(), _altBuffers(), _tolerance(0.0), _numTriangles(0), _segments(),
+	_isFullyDirty(true), _dirtyLowU(1), _dirtyHighU(0), _dirtyLowV(1), _dirtyHighV(0), _revision(0),
+	_bezierRevision(0), _bezierPoints(), _bezierBreaksU(), _bezierBreaksV(), _hierarchy(NULL), _hierarchyRevision(0) {
 	//Check to make sure a CP collection was passed
 	if (this->_controlPoints.size() == 0) { 
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::WCNurbsSurface - Invalid control points collection."); return;	}
@@ -890,7 +1805,9 @@ WCNurbsSurface::WCNurbsSurface(WCGeometryContext *context, const WPUInt &degreeU
 WCNurbsSurface::WCNurbsSurface(const WCNurbsSurface &surf) : ::WCGeometricSurface(surf),
 	_degreeU(surf._degreeU), _degreeV(surf._degreeV), _modeU(surf._modeU), _modeV(surf._modeV), 
 	_cpU(surf._cpU), _cpV(surf._cpV), _controlPoints(surf._controlPoints), _kpU(surf._kpU), _kpV(surf._kpV), _knotPointsU(NULL), _knotPointsV(NULL),
-	_lengthU(surf._lengthU), _lengthV(surf._lengthV), _lodU(0), _lodV(0), _buffers(), _altBuffers() {
+	_lengthU(surf._lengthU), _lengthV(surf._lengthV), _lodU(0), _lodV(0), _buffers(), _altBuffers(), _tolerance(0.0), _numTriangles(0), _segments(),
+	_isFullyDirty(true), _dirtyLowU(1), _dirtyHighU(0), _dirtyLowV(1), _dirtyHighV(0), _revision(0),
+	_bezierRevision(0), _bezierPoints(), _bezierBreaksU(), _bezierBreaksV(), _hierarchy(NULL), _hierarchyRevision(0) {
 	//Need to load knot points
 	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface:: Copy Constructor - Not yet implemented.");
 	//Establish aligned bounding box
@@ -901,7 +1818,9 @@ WCNurbsSurface::WCNurbsSurface(const WCNurbsSurface &surf) : ::WCGeometricSurfac
 WCNurbsSurface::WCNurbsSurface(xercesc::DOMElement *element, WCSerialDictionary *dictionary) :
 	::WCGeometricSurface( WCSerializeableObject::ElementFromName(element,"GeometricSurface"), dictionary ),
 	_degreeU(0), _degreeV(0), _modeU(WCNurbsMode::Default()), _modeV(WCNurbsMode::Default()), _cpU(0), _cpV(0),
-	_controlPoints(), _kpU(0), _kpV(0), _knotPointsU(NULL), _knotPointsV(NULL), _lengthU(0.0), _lengthV(0.0), _buffers(), _altBuffers() {
+	_controlPoints(), _kpU(0), _kpV(0), _knotPointsU(NULL), _knotPointsV(NULL), _lengthU(0.0), _lengthV(0.0), _buffers(), _altBuffers(), _tolerance(0.0), _numTriangles(0), _segments(),
+	_isFullyDirty(true), _dirtyLowU(1), _dirtyHighU(0), _dirtyLowV(1), _dirtyHighV(0), _revision(0),
+	_bezierRevision(0), _bezierPoints(), _bezierBreaksU(), _bezierBreaksV(), _hierarchy(NULL), _hierarchyRevision(0) {
 	//Make sure element if not null
 	if (element == NULL) {
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::WCNurbsSurface - NULL Element passed.");
@@ -1004,8 +1923,12 @@ WCNurbsSurface::~WCNurbsSurface() {
 	//See if need to Delete the buffers
 	if (!this->_buffers.empty()) this->ReleaseBuffers(this->_buffers);
 	if (!this->_altBuffers.empty()) this->ReleaseBuffers(this->_altBuffers);
+	//Drop any cached tessellations
+	WCTessellationCache::Shared()->Invalidate(this);
 	//Clear the collection of control points
 	this->_controlPoints.clear();
+	//Delete the bounding hierarchy
+	if (this->_hierarchy != NULL) delete this->_hierarchy;
 	//Delete the knot point array
 	if (this->_knotPointsU != NULL) delete this->_knotPointsU;
 	if (this->_knotPointsV != NULL) delete this->_knotPointsV;
@@ -1014,6 +1937,55 @@ WCNurbsSurface::~WCNurbsSurface() {
 }
 
 
+void WCNurbsSurface::IsVisualDirty(const bool &status) {
+	//Any general change means a full regeneration, clean means nothing is pending
+	this->_isFullyDirty = status;
+	this->_dirtyLowU = this->_dirtyLowV = 1;
+	this->_dirtyHighU = this->_dirtyHighV = 0;
+	this->WCVisualObject::IsVisualDirty(status);
+}
+
+
+WPHash WCNurbsSurface::ContentHash(void) {
+	WCContentHash hash;
+	hash.Add(this->_degreeU);
+	hash.Add(this->_degreeV);
+	hash.Add(this->_cpU);
+	hash.Add(this->_cpV);
+	//Knot vectors and control net
+	for (WPUInt i=0; i<this->_kpU; i++) hash.Add(this->_knotPointsU[i]);
+	for (WPUInt i=0; i<this->_kpV; i++) hash.Add(this->_knotPointsV[i]);
+	for (WPUInt i=0; i<this->_controlPoints.size(); i++) hash.Add(this->_controlPoints.at(i));
+	return hash.Value();
+}
+
+
+void WCNurbsSurface::ControlPoints(const std::vector<WCVector4> &controlPoints) {
+	//Make sure number of control points is the same
+	if (controlPoints.size() != this->_cpU * this->_cpV) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsSurface::ControlPoints - Wrong number of points.");
+		return;
+	}
+	//Find the block of control points that actually changed
+	WPUInt lowU = this->_cpU, highU = 0, lowV = this->_cpV, highV = 0;
+	for (WPUInt i=0; i<controlPoints.size(); i++) {
+		if (this->_controlPoints.at(i) != controlPoints.at(i)) {
+			lowU = STDMIN(lowU, i % this->_cpU);
+			highU = STDMAX(highU, i % this->_cpU);
+			lowV = STDMIN(lowV, i / this->_cpU);
+			highV = i / this->_cpU;
+		}
+	}
+	//Nothing to do if nothing changed
+	if (lowV > highV) return;
+	//Update control points
+	this->_controlPoints = controlPoints;
+	//Only the patches touching the changed points need regenerating
+	this->MarkControlPointsDirty(lowU, highU, lowV, highV);
+	this->IsSerialDirty(true);
+}
+
+
 void WCNurbsSurface::Degree(const WPUInt &degreeU, const WPUInt &degreeV) {
 	WPUInt degU = degreeU;
 	WPUInt degV = degreeV;
@@ -1050,20 +2022,132 @@ void WCNurbsSurface::Degree(const WPUInt &degreeU, const WPUInt &degreeV) {
 	std::cout << "Degrees: " << this->_degreeU << " " << this->_degreeV << std::endl;
 /*** Debug ***/
 	//Mark the object as dirty
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 }
 
 
 WPFloat WCNurbsSurface::Area(const WPFloat &tolerance) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::Area Error - Not yet implemented.");
-	return 0.0;
+	return this->MassProperties(tolerance).area;
+}
+
+
+WSMassProperties WCNurbsSurface::MassProperties(const WPFloat &tolerance) {
+	//Whole surface - call Finish on the result if the surface is closed
+	return this->IntegrateMass(tolerance, NULL);
+}
+
+
+bool WCNurbsSurface::InvertPoint(const WCVector4 &point, WPFloat &u, WPFloat &v) {
+	WPFloat pt[4] = { point.I(), point.J(), point.K(), 1.0 }, uv[2];
+	if (!this->InvertPoints(pt, 1, uv)) return false;
+	u = uv[0];
+	v = uv[1];
+	return true;
+}
+
+
+bool WCNurbsSurface::InvertPoints(const WPFloat *points, const WPUInt &count, WPFloat *uv) {
+	//Make sure the inputs are reasonable
+	if ((points == NULL) || (uv == NULL)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::InvertPoints - NULL points or parameters.");
+		return false;
+	}
+	WPFloat uMin = this->_knotPointsU[this->_degreeU], uMax = this->_knotPointsU[this->_cpU];
+	WPFloat vMin = this->_knotPointsV[this->_degreeV], vMax = this->_knotPointsV[this->_cpV];
+	if ((uMax <= uMin) || (vMax <= vMin)) return false;
+	if (count == 0) return true;
+	//Build the hierarchy up front, the workers only read it
+	const WCBezierHierarchy *hierarchy = this->Hierarchy();
+	if (hierarchy == NULL) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::InvertPoints - No Bezier hierarchy.");
+		return false;
+	}
+	//Flatten the control net into homogeneous coordinates
+	WPUInt numCP = this->_cpU * this->_cpV;
+	WPFloat *hcp = new WPFloat[numCP * 4];
+	WCVector4 cp;
+	for (WPUInt i=0; i<numCP; i++) {
+		cp = this->_controlPoints.at(i);
+		hcp[i*4]   = cp.I() * cp.L();
+		hcp[i*4+1] = cp.J() * cp.L();
+		hcp[i*4+2] = cp.K() * cp.L();
+		hcp[i*4+3] = cp.L();
+	}
+	_NurbsSurfaceInversionJob job = { { this->_degreeU, this->_degreeV, this->_cpU, this->_knotPointsU, this->_knotPointsV, hcp },
+		this->_cpV, hierarchy, uMin, uMax, vMin, vMax, points, uv, count };
+	//Blocks of points - one block runs inline, more go to the shared pool
+	WPUInt blocks = (count + NURBSSURFACE_INVERSION_BLOCK - 1) / NURBSSURFACE_INVERSION_BLOCK;
+	if (blocks == 1) _NurbsSurfaceInversionTask(&job, 0);
+	else WCThreadPool::Shared()->ParallelFor(blocks, _NurbsSurfaceInversionTask, &job);
+	delete [] hcp;
+	return true;
+}
+
+
+WPUInt WCNurbsSurface::RayHits(const WCRay &ray, const WPFloat &tolerance, std::vector<WPFloat> &hits,
+	const std::vector< std::vector<WPFloat> > *loops) {
+	const WCBezierHierarchy *hierarchy = this->Hierarchy();
+	if (hierarchy == NULL) return 0;
+	//Only pieces whose boxes come within reach of the ray need a closer look
+	WPFloat reach = tolerance + hierarchy->Tolerance();
+	std::vector<WPUInt> pieces;
+	hierarchy->RayQuery(ray.Base(), ray.Direction(), reach, pieces);
+	WCVector4 base = ray.Base(), dir = ray.Direction();
+	base.L(0.0);
+	dir.L(0.0);
+	WPUInt pU = hierarchy->DegreeU(), last = (pU+1) * hierarchy->DegreeV() * 4, count = 0;
+	WPFloat b1, b2, t, det, u, v, margin1, margin2;
+	for (WPUInt i=0; i<pieces.size(); i++) {
+		//Pieces are flat to the hierarchy tolerance - test the two triangles across their corners
+		const WSBezierPiece &piece = hierarchy->Piece(pieces.at(i));
+		const WPFloat *hcp = hierarchy->PiecePoints(pieces.at(i));
+		WCVector4 c00(hcp[0] / hcp[3], hcp[1] / hcp[3], hcp[2] / hcp[3], 0.0);
+		WCVector4 c10(hcp[pU*4] / hcp[pU*4+3], hcp[pU*4+1] / hcp[pU*4+3], hcp[pU*4+2] / hcp[pU*4+3], 0.0);
+		WCVector4 c01(hcp[last] / hcp[last+3], hcp[last+1] / hcp[last+3], hcp[last+2] / hcp[last+3], 0.0);
+		WCVector4 c11(hcp[last+pU*4] / hcp[last+pU*4+3], hcp[last+pU*4+1] / hcp[last+pU*4+3], hcp[last+pU*4+2] / hcp[last+pU*4+3], 0.0);
+		for (WPUInt tri=0; tri<2; tri++) {
+			WCVector4 e1 = (tri == 0) ? c10 - c00 : c11 - c00;
+			WCVector4 e2 = (tri == 0) ? c11 - c00 : c01 - c00;
+			//Moller-Trumbore, with the barycentric range grown by the reach
+			WCVector4 pvec = dir.CrossProduct(e2);
+			det = e1.DotProduct(pvec);
+			if (fabs(det) < 1.0e-14) continue;
+			WCVector4 tvec = base - c00;
+			b1 = tvec.DotProduct(pvec) / det;
+			WCVector4 qvec = tvec.CrossProduct(e1);
+			b2 = dir.DotProduct(qvec) / det;
+			t = e2.DotProduct(qvec) / det;
+			margin1 = reach / STDMAX(e1.Magnitude(), 1.0e-14);
+			margin2 = reach / STDMAX(e2.Magnitude(), 1.0e-14);
+			if ((t < 0.0) || (b1 < -margin1) || (b2 < -margin2) || (b1 + b2 > 1.0 + margin1 + margin2)) continue;
+			b1 = STDMAX(0.0, b1);
+			b2 = STDMAX(0.0, b2);
+			if (b1 + b2 > 1.0) { b1 /= (b1 + b2); b2 = 1.0 - b1; }
+			u = (tri == 0) ? b1 + b2 : b1;
+			v = (tri == 0) ? b2 : b1 + b2;
+			u = piece.uMin + u * (piece.uMax - piece.uMin);
+			v = piece.vMin + v * (piece.vMax - piece.vMin);
+			if ((loops != NULL) && !_NurbsSurfaceInsideLoops(*loops, u, v)) continue;
+			hits.push_back(u);
+			hits.push_back(v);
+			hits.push_back(t);
+			count++;
+		}
+	}
+	return count;
+}
+
+
+bool WCNurbsSurface::InsideLoops(const std::vector< std::vector<WPFloat> > &loops, const WPFloat &u, const WPFloat &v) {
+	return _NurbsSurfaceInsideLoops(loops, u, v);
 }
 
 
 WCVisualObject* WCNurbsSurface::HitTest(const WCRay &ray, const WPFloat &tolerance) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::HitTest Error - Not yet implemented.");
-	return NULL;
+	std::vector<WPFloat> hits;
+	return (this->RayHits(ray, tolerance, hits) > 0) ? this : NULL;
 }
 
 
@@ -1072,6 +2156,7 @@ void WCNurbsSurface::ApplyTransform(const WCMatrix4 &transform) {
 	for (WPUInt i=0; i<this->_controlPoints.size(); i++)
 		this->_controlPoints.at(i) = transform * this->_controlPoints.at(i);
 	//Make sure curve is regenerated
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 }
@@ -1082,6 +2167,7 @@ void WCNurbsSurface::ApplyTranslation(const WCVector4 &translation) {
 	for (WPUInt i=0; i<this->_controlPoints.size(); i++)
 		this->_controlPoints.at(i) = this->_controlPoints.at(i) + translation;
 	//Make sure curve is regenerated
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 }
@@ -1094,26 +2180,15 @@ void WCNurbsSurface::Render(const GLuint &defaultProg, const WCColor &color, con
 	err = glGetError();
 	if (err != GL_NO_ERROR) CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::Start Render Error: " << std::hex << err);
 
-	//Determine best LOD values
-	WPFloat lengthU = WCNurbs::EstimateLengthU(this->_controlPoints, this->_cpU);
-	WPUInt lodU = STDMAX((WPUInt)(this->_cpU * 5), (WPUInt)(lengthU * sqrt(zoom) / NURBSSURFACE_RENDER_ACCURACY));
-	WPFloat lengthV = WCNurbs::EstimateLengthV(this->_controlPoints, this->_cpV);
-	WPUInt lodV = STDMAX((WPUInt)(this->_cpV * 5), (WPUInt)(lengthV * sqrt(zoom) / NURBSSURFACE_RENDER_ACCURACY));
-	WPFloat factorU = (WPFloat)this->_lodU / (WPFloat)lodU;
-	WPFloat factorV = (WPFloat)this->_lodV / (WPFloat)lodV;
-	//See if need to regenerate
-	if ((factorU < NURBSSURFACE_RENDER_LOWER) || (factorU > NURBSSURFACE_RENDER_UPPER) ||
-		(factorV < NURBSSURFACE_RENDER_LOWER) || (factorV > NURBSSURFACE_RENDER_UPPER))  {
-		//Set the new lod
-		this->_lodU = lodU;
-		this->_lodV = lodV;
-		//Mark as dirty
-		this->IsVisualDirty(true);
-	}
-	//Check to see if surface needs to be generated
+	//Tessellate to a chord height that shrinks as the view zooms in
+	WPFloat tolerance = NURBSSURFACE_RENDER_CHORD / STDMAX(zoom, NURBSSURFACE_EPSILON_ONE);
+	WPFloat factor = this->_tolerance / tolerance;
+	//See if need to regenerate (otherwise stay at the current tolerance)
+	if ((factor < NURBSSURFACE_RENDER_LOWER) || (factor > NURBSSURFACE_RENDER_UPPER)) this->IsVisualDirty(true);
+	else tolerance = this->_tolerance;
+	//Check to see if surface needs to be generated (only dirty patches are re-measured)
 	if (this->IsVisualDirty()) {
-		//Generate the server buffer of data
-		this->GenerateServerBuffers(0.0, 1.0, this->_lodU, 0.0, 1.0, this->_lodV, this->_buffers, true);
+		this->GenerateAdaptiveServerBuffers(tolerance, this->_buffers, this->_numTriangles);
 		//Mark as clean
 		this->IsVisualDirty(false);
 	}
@@ -1148,7 +2223,7 @@ void WCNurbsSurface::Render(const GLuint &defaultProg, const WCColor &color, con
 		glUseProgram(0);
 	}
 	//Draw the geometry
-	glDrawElements(GL_TRIANGLES, (this->_lodU-1)*(this->_lodV-1)*2*3, GL_UNSIGNED_INT, 0);
+	glDrawElements(GL_TRIANGLES, this->_numTriangles * 3, GL_UNSIGNED_INT, 0);
 	
 	/*** Draw done - now clean up ***/
 	
@@ -1168,6 +2243,7 @@ void WCNurbsSurface::Render(const GLuint &defaultProg, const WCColor &color, con
 
 void WCNurbsSurface::ReceiveNotice(WCObjectMsg msg, WCObject *sender) {
 	//Mark the surface as dirty
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 	//Estimate length values
@@ -1187,14 +2263,31 @@ WCVector4 WCNurbsSurface::Evaluate(const WPFloat &u, const WPFloat &v) {
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::Evaluate - U or V out of bounds.");
 		return WCVector4();
 	}
+	//Single Bezier patches evaluate each row in U, then the resulting column in V
+	if ((this->_modeU == WCNurbsMode::Bezier()) && (this->_modeV == WCNurbsMode::Bezier()) &&
+		(this->_cpU == this->_degreeU+1) && (this->_cpV == this->_degreeV+1)) {
+		WPFloat hcp[NURBS_BASIS_MAX_ORDER*4], column[NURBS_BASIS_MAX_ORDER*4], pt[4];
+		WCVector4 point;
+		for (WPUInt i=0; i<=this->_degreeV; i++) {
+			for (WPUInt j=0; j<=this->_degreeU; j++) {
+				point = this->_controlPoints.at(i * this->_cpU + j);
+				hcp[j*4]	= point.I() * point.L();
+				hcp[j*4+1]	= point.J() * point.L();
+				hcp[j*4+2]	= point.K() * point.L();
+				hcp[j*4+3]	= point.L();
+			}
+			if (!WCNurbs::EvaluateBezier(this->_degreeU, hcp, 4, evalU, column + i*4)) return WCVector4();
+		}
+		if (!WCNurbs::EvaluateBezier(this->_degreeV, column, 4, evalV, pt)) return WCVector4();
+		return WCVector4(pt[0] / pt[3], pt[1] / pt[3], pt[2] / pt[3], 1.0);
+	}
 	//Otherwise, find the span for the u and v values
 	WPUInt spanU = WCNurbs::FindSpan(this->_cpU, this->_degreeU, evalU, this->_knotPointsU);
 	WPUInt spanV = WCNurbs::FindSpan(this->_cpV, this->_degreeV, evalV, this->_knotPointsV);
 	//Calculate basis values for U and V
-	WPFloat* basisValuesU = WCNurbs::BasisValues(spanU, evalU, this->_degreeU, this->_knotPointsU);
-	if (basisValuesU == NULL) return WCVector4();		
-	WPFloat* basisValuesV = WCNurbs::BasisValues(spanV, evalV, this->_degreeV, this->_knotPointsV);	
-	if (basisValuesV == NULL) { delete basisValuesU; return WCVector4(); }
+	WPFloat basisValuesU[NURBS_BASIS_MAX_ORDER], basisValuesV[NURBS_BASIS_MAX_ORDER];
+	if (!WCNurbs::BasisValues(spanU, evalU, this->_degreeU, this->_knotPointsU, 0, basisValuesU)) return WCVector4();
+	if (!WCNurbs::BasisValues(spanV, evalV, this->_degreeV, this->_knotPointsV, 0, basisValuesV)) return WCVector4();
 	//Declare some temparary values
 	WCVector4 c;
 	int index;
@@ -1215,17 +2308,57 @@ WCVector4 WCNurbsSurface::Evaluate(const WPFloat &u, const WPFloat &v) {
 	c /= w;
 	//Set W = 1.0
 	c.L(1.0);
-	//Make sure to delete basis values
-	delete basisValuesU;
-	delete basisValuesV;
 	//Return the evaluated point
 	return c;
 }
 
 
 WCVector4 WCNurbsSurface::Derivative(const WPFloat &u, const WPUInt &uDer, const WPFloat &v, const WPUInt &vDer) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::Derivative - Not yet implemented.");
-	return WCVector4();
+	//Only the first partials are supported
+	if (uDer + vDer != 1) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::Derivative - Only first partial derivatives are supported.");
+		return WCVector4();
+	}
+	WCVector4 derU, derV;
+	this->EvaluatePartials(u, v, derU, derV);
+	return (uDer == 1) ? derU : derV;
+}
+
+
+WCVector4 WCNurbsSurface::EvaluatePartials(const WPFloat &u, const WPFloat &v, WCVector4 &derU, WCVector4 &derV) {
+	derU = derV = WCVector4();
+	//Bounds check the u and v values
+	if ((u < this->_knotPointsU[0]) || (u > this->_knotPointsU[this->_kpU-1]) ||
+		(v < this->_knotPointsV[0]) || (v > this->_knotPointsV[this->_kpV-1])) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::EvaluatePartials - U or V out of bounds.");
+		return WCVector4();
+	}
+	if ((this->_degreeU > NURBS_BASIS_MAX_DEGREE) || (this->_degreeV > NURBS_BASIS_MAX_DEGREE)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::EvaluatePartials - Degree exceeds NURBS_BASIS_MAX_DEGREE.");
+		return WCVector4();
+	}
+	//Only the (p+1)x(q+1) control points under the spans are needed - gather them on the stack
+	WPUInt spanU = WCNurbs::FindSpan(this->_cpU, this->_degreeU, u, this->_knotPointsU);
+	WPUInt spanV = WCNurbs::FindSpan(this->_cpV, this->_degreeV, v, this->_knotPointsV);
+	WPFloat hcp[NURBS_BASIS_MAX_VALUES * 4], p[3], d[6];
+	WCVector4 cp;
+	WPUInt index = 0;
+	for (WPUInt k=spanV-this->_degreeV; k<=spanV; k++) {
+		for (WPUInt l=spanU-this->_degreeU; l<=spanU; l++, index+=4) {
+			cp = this->_controlPoints.at(k * this->_cpU + l);
+			hcp[index]   = cp.I() * cp.L();
+			hcp[index+1] = cp.J() * cp.L();
+			hcp[index+2] = cp.K() * cp.L();
+			hcp[index+3] = cp.L();
+		}
+	}
+	//Shift the knots so the local patch sits at spans (p,q)
+	_NurbsSurfaceAdaptiveJob job = { this->_degreeU, this->_degreeV, this->_degreeU + 1,
+		this->_knotPointsU + spanU - this->_degreeU, this->_knotPointsV + spanV - this->_degreeV, hcp };
+	_NurbsSurfaceSpanPoint(job, this->_degreeU, this->_degreeV, u, v, p, NULL, d);
+	derU = WCVector4(d[0], d[1], d[2], 0.0);
+	derV = WCVector4(d[3], d[4], d[5], 0.0);
+	return WCVector4(p[0], p[1], p[2], 1.0);
 }
 
 
@@ -1236,162 +2369,37 @@ WCRay WCNurbsSurface::Tangent(const WPFloat &u, const WPFloat &v) {
 
 
 std::pair<WCVector4,WCVector4> WCNurbsSurface::PointInversion(const WCVector4 &point) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::PointInversion - Not yet implemented.");
-	//Special case for degree=1 curves
-	if ((this->_degreeU == 1) && (this->_degreeV == 1)) {
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::PointInversion - Not yet implemented for degree=1 surfaces.");
-		return std::make_pair(WCVector4(), WCVector4());
-	}
-	//Check for special generation cases, otherwise set the program
-//	if ((this->_controlPoints.size() == 4) && (this->_numVerts <= NURBSSURFACE_SIZE4_CUTOFF)) return this->GenerateSurfaceSize4();
-	//	if ((this->_degreeU == 1) && (this->_degreeV = 1)) return this->GenerateSurfaceOne();
-//	if ((this->_lodU > (WPUInt)this->_context->SurfaceMaxTextureSize()) || (this->_lodV > (WPUInt)this->_context->SurfaceMaxTextureSize())) {
-//		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateSurfaceMedium - LOD exceeds hardware Maximum Texture Size.");
-//		return this->GenerateSurfaceLow();
-//	}
-
-	//Check to see if surface needs to be generated
-	if (this->IsVisualDirty()) {
-		//Generate the curve - switch on performance level
-//		switch(this->_context->SurfacePerformanceLevel()) {
-//			case NURBSSURFACE_PERFLEVEL_HIGH: this->GenerateSurfaceHigh(); break;
-//			case NURBSSURFACE_PERFLEVEL_MEDIUM: this->GenerateSurfaceMedium(); break;
-//			case NURBSSURFACE_PERFLEVEL_LOW: this->GenerateSurfaceLow(); break;
-//		}
-		//Generate the index for the curve
-//		this->GenerateIndex();		
-		//Mark as clean
-		this->IsVisualDirty(true);
-	}
-	//Get base vector for point
-	WCVector4 refPoint = point;
-	refPoint.K(0.0);
-	WCVector4 curvePoint;
-	WPUInt i, j;
-	int index=-1;
-	WPFloat u, v, dist, minDist=10000000.0;
-
-	//Find the closest point on the surface
-	glBindBuffer(GL_ARRAY_BUFFER, this->_buffers[NURBSSURFACE_VERTEX_BUFFER]);
-	GLfloat *data = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_READ_ONLY);
-	//Loop through all points and find closest
-	for (i=0; i<(this->_lodU+1)*(this->_lodV+1); i++) {
-		//Create a point from the data set
-		j = i * NURBSSURFACE_FLOATS_PER_VERTEX;
-		curvePoint.Set(data[j], data[j+1], data[j+2], data[j+3]);
-		//Calculate distance from the reference point
-		curvePoint = refPoint - curvePoint;
-		dist = curvePoint.Magnitude();
-		if (dist < minDist) {
-			//Set the min distance
-			minDist = dist;
-			//Save the point index
-			index = i;
-		}
-	}
-	//Make sure to unmap the buffer
-	glUnmapBuffer(GL_ARRAY_BUFFER);
-	//Calculate the u,v value for the initial minimum point
-	u = (index % (this->_lodU+1)) * this->_knotPointsU[this->_kpU-1] / (this->_lodU+1);
-	v = (index / (this->_lodV+1)) * this->_knotPointsV[this->_kpV-1] / (this->_lodV+1);
-
-	//Initialize metrics
-	WPFloat *bvU, *bvV;
-	WCVector4 pt;
-	dist = minDist;
-	int spanU, spanV;
-	WCVector4 s, sU, sV, sUU, sVV, sUV, r;
-	WPFloat uNx, vNx, f, g, suMag, svMag, fu, fv, gu, gv, bottom, top;
-	//Loop until condition 1, 2, or 4 is met
-	int iterCount = 0;
-	while (iterCount <= NURBSSURFACE_INVERSION_MAX_ITERATIONS) {
-		//Init the point values
-		s.Set(0.0, 0.0, 0.0, 0.0);
-		sU.Set(0.0, 0.0, 0.0, 0.0);
-		sUU.Set(0.0, 0.0, 0.0, 0.0);
-		sUV.Set(0.0, 0.0, 0.0, 0.0);
-		sV.Set(0.0, 0.0, 0.0, 0.0);
-		sVV.Set(0.0, 0.0, 0.0, 0.0);
-		//Find the span and basis values up to second derivative
-		spanU = WCNurbs::FindSpan(this->_cpU, this->_degreeU, u, this->_knotPointsU);
-		bvU = WCNurbs::BasisValues(spanU, u, this->_degreeU, this->_knotPointsU, 2);
-		spanV = WCNurbs::FindSpan(this->_cpV, this->_degreeV, v, this->_knotPointsV);
-		bvV = WCNurbs::BasisValues(spanV, v, this->_degreeV, this->_knotPointsV, 2);
-		//Evaluate the point
-		for(i=0; i<=this->_degreeV; i++) {
-			//Determine the index of the control point
-			index = (this->_cpU * (spanV - this->_degreeV + i)) + spanU - this->_degreeU;
-			for (j=0; j<=this->_degreeU; j++) {
-				pt = this->_controlPoints.at(index);			
-				s = s + (pt * bvU[j] * bvV[i]);
-				sU = sU + (pt * bvU[j+this->_degreeU+1] * bvV[i]);
-				sV = sV + (pt * bvU[j] * bvV[i+this->_degreeV+1]);
-				sUU = sUU + (pt * bvU[j+2*(this->_degreeU+1)] * bvV[i]);
-				sVV = sVV + (pt * bvU[j] * bvV[i+2*(this->_degreeV+1)]);
-				sUV = sUV + (pt * bvU[j+this->_degreeU+1] * bvV[i+this->_degreeV+1]);
-				index++;
-			}
-		}
-		//Make sure to delete the basis values
-		delete bvU;
-		delete bvV;					
-		//Calculate metrics
-		r = s - refPoint;
-		dist = r.Magnitude();	
-		//Check for condition 1
-		if (dist < NURBSSURFACE_EPSILON_ONE) return std::make_pair(s, WCVector4(u,v,0.0));
-		
-		//Do some interim calculations
-		f = sU.DotProduct(r);
-		suMag = sU.Magnitude();
-		//Check condition 2 - part 1
-		if (( STDFABS(f) / (suMag * dist) ) <= NURBSSURFACE_EPSILON_TWO) return std::make_pair(s, WCVector4(u,v,0.0));					
-		//Now the other part
-		g = sV.DotProduct(r);
-		svMag = sV.Magnitude();
-		//Check condition 2 - part 2
-		if (( STDFABS(g) / (svMag * dist) ) <= NURBSSURFACE_EPSILON_TWO) return std::make_pair(s, WCVector4(u,v,0.0));		
-		
-		//Create 
-		fu = (suMag * suMag) + r.DotProduct(sUU);
-		fv = sU.DotProduct(sV) + r.DotProduct(sUV);
-		gu = fv;
-		gv = (svMag * svMag) + r.DotProduct(sVV);
-		bottom = (fu * gv) - (gu * fv);
-		//Check to make sure no div by zero
-		if (bottom == 0.0) {
-			CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::PointInverse - |A| is zero.");
-			return std::make_pair(s, WCVector4(u,v,0.0));
-		}
-		//Calculate delta u
-		top = (-f * gv) - (-g * fv);
-		uNx = top / bottom;
-		//Calculate delta v
-		top = (-g * fu) - (-f * gu);
-		vNx = top / bottom;												
-		
-		//Check condition 3
-		if (u + uNx < this->_knotPointsU[spanU]) uNx = 0;
-		if (u + uNx > this->_knotPointsU[spanU+1]) uNx = this->_knotPointsU[spanU+1] - u;	
-		if (v + vNx < this->_knotPointsV[spanV]) vNx = 0;
-		if (v + vNx > this->_knotPointsV[spanV+1]) vNx = this->_knotPointsV[spanV+1] - u;
-		
-		//Check condition 4
-		if ( (sU*uNx + sV*vNx).Magnitude() <= NURBSSURFACE_EPSILON_ONE) return std::make_pair(s, WCVector4(u,v,0.0));
-		
-		//Otherwise, increment u and v
-		u = u + uNx;
-		v = v + vNx;
-		//Increment loop interation counter
-		iterCount++;
-	}
-	return std::make_pair(s, WCVector4(u,v,0.0));
+	WPFloat u, v;
+	if (!this->InvertPoint(point, u, v)) return std::make_pair(WCVector4(), WCVector4());
+	return std::make_pair(this->Evaluate(u, v), WCVector4(u, v, 0.0));
 }
 
 
 std::vector<GLfloat*>
 WCNurbsSurface::GenerateClientBuffers(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lodU,
 	const WPFloat &vStart, const WPFloat &vStop, WPUInt &lodV, const bool &managed) {
+	//Managed buffers are shared through the tessellation cache
+	if (managed) {
+		WCTessellationKey key(this, this->_revision, NURBSSURFACE_CACHE_CLIENT);
+		key.values[0] = uStart;
+		key.values[1] = uStop;
+		key.values[2] = (WPFloat)lodU;
+		key.values[3] = vStart;
+		key.values[4] = vStop;
+		key.values[5] = (WPFloat)lodV;
+		WCTessellation tess;
+		if (!WCTessellationCache::Shared()->Acquire(key, tess)) {
+			tess.buffers = this->GenerateClientBuffers(uStart, uStop, lodU, vStart, vStop, lodV, false);
+			tess.counts.push_back(lodU);
+			tess.counts.push_back(lodV);
+			WPUInt bytes = lodU * lodV * (NURBSSURFACE_FLOATS_PER_VERTEX + NURBSSURFACE_FLOATS_PER_NORMAL +
+				NURBSSURFACE_FLOATS_PER_TEXCOORD) * sizeof(GLfloat) + (lodU - 1) * (lodV - 1) * 6 * sizeof(GLuint);
+			WCTessellationCache::Shared()->Insert(key, tess, bytes);
+		}
+		lodU = tess.counts.at(0);
+		lodV = tess.counts.at(1);
+		return tess.buffers;
+	}
 	//Make sure LOD >= 2
 	lodU = STDMAX(lodU, (WPUInt)2);
 	lodV = STDMAX(lodV, (WPUInt)2);
@@ -1425,6 +2433,8 @@ WCNurbsSurface::GenerateClientBuffers(const WPFloat &uStart, const WPFloat &uSto
 		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateClientBuffer - Unknown generation path.");
 		//throw error
 	}
+	//Nothing to index if the generator bailed out
+	if (buffers.empty()) return buffers;
 	//Generate index buffer
 	GLuint buffer = 0;
 	GLuint *indexBuffer = GenerateIndex(0.0, 1.0, lodU, 0.0, 1.0, lodV, false, buffer);
@@ -1441,21 +2451,97 @@ WCNurbsSurface::GenerateClientBuffers(const WPFloat &uStart, const WPFloat &uSto
 }
 
 
+std::vector< std::vector<GLfloat*> >
+WCNurbsSurface::GenerateClientBuffers(const std::vector<WCNurbsSurface*> &surfaces, WPUInt &lodU, WPUInt &lodV, const bool &managed) {
+	//Make sure LOD >= 2
+	lodU = STDMAX(lodU, (WPUInt)2);
+	lodV = STDMAX(lodV, (WPUInt)2);
+	std::vector< std::vector<GLfloat*> > buffers(surfaces.size());
+	_NurbsSurfaceBatchJob job;
+	job.surfaces = &surfaces;
+	job.buffers = &buffers;
+	job.lodU = lodU;
+	job.lodV = lodV;
+	job.managed = managed;
+	//Only the CPU paths may leave the calling thread - GL generation stays here
+	bool isCPU = (lodU * lodV < NURBSSURFACE_SIZE4_CUTOFF);
+	WPUInt lodU2, lodV2;
+	WCGeometryContext *context;
+	for (WPUInt i=0; i<surfaces.size(); i++) {
+		context = surfaces.at(i)->Context();
+		if (isCPU || (lodU > (WPUInt)context->CurveMaxTextureSize()) || (lodV > (WPUInt)context->CurveMaxTextureSize()) ||
+			(context->SurfacePerformanceLevel() == NURBSSURFACE_PERFLEVEL_LOW))
+			job.indices.push_back(i);
+		else {
+			lodU2 = lodU;
+			lodV2 = lodV;
+			buffers.at(i) = surfaces.at(i)->GenerateClientBuffers(0.0, 1.0, lodU2, 0.0, 1.0, lodV2, managed);
+		}
+	}
+	//Spread the CPU surfaces across the shared pool (nested tiling inside each surface runs inline)
+	WCThreadPool::Shared()->ParallelFor((WPUInt)job.indices.size(), _NurbsSurfaceBatchTask, &job);
+	return buffers;
+}
+
+
 void WCNurbsSurface::ReleaseBuffers(std::vector<GLfloat*> &buffers) {
-	//Make sure there are atleast 4 to delete
-	if (buffers.size() >= 4) {
-		delete buffers.at(NURBSSURFACE_VERTEX_BUFFER);
-		delete buffers.at(NURBSSURFACE_INDEX_BUFFER);
-		delete buffers.at(NURBSSURFACE_NORMAL_BUFFER);
-		delete buffers.at(NURBSSURFACE_TEXCOORD_BUFFER);
+	//Make sure there are atleast 4 to delete, managed buffers go back to the cache
+	if ((buffers.size() >= 4) && (!WCTessellationCache::Shared()->Release(buffers.at(NURBSSURFACE_VERTEX_BUFFER)))) {
+		delete [] buffers.at(NURBSSURFACE_VERTEX_BUFFER);
+		delete [] buffers.at(NURBSSURFACE_INDEX_BUFFER);
+		delete [] buffers.at(NURBSSURFACE_NORMAL_BUFFER);
+		delete [] buffers.at(NURBSSURFACE_TEXCOORD_BUFFER);
 	}
 	//Clear the list
 	buffers.clear();
 }
 
 
+std::vector<GLfloat*> WCNurbsSurface::GenerateAdaptiveBuffers(const WPFloat &chordTolerance, WPUInt &numVerts, WPUInt &numTriangles,
+	const bool &managed) {
+	//Managed buffers are shared through the tessellation cache
+	if (managed) {
+		WCTessellationKey key(this, this->_revision, NURBSSURFACE_CACHE_ADAPTIVE);
+		key.values[0] = chordTolerance;
+		WCTessellation tess;
+		if (!WCTessellationCache::Shared()->Acquire(key, tess)) {
+			std::vector<WPUInt> segments;
+			tess.buffers = this->GenerateSurfaceStored(chordTolerance, segments, numVerts, numTriangles);
+			tess.counts.push_back(numVerts);
+			tess.counts.push_back(numTriangles);
+			WPUInt bytes = numVerts * (NURBSSURFACE_FLOATS_PER_VERTEX + NURBSSURFACE_FLOATS_PER_NORMAL +
+				NURBSSURFACE_FLOATS_PER_TEXCOORD) * sizeof(GLfloat) + numTriangles * 3 * sizeof(GLuint);
+			WCTessellationCache::Shared()->Insert(key, tess, bytes);
+		}
+		numVerts = tess.counts.at(0);
+		numTriangles = tess.counts.at(1);
+		return tess.buffers;
+	}
+	//Every patch is measured from scratch
+	std::vector<WPUInt> segments;
+	return this->GenerateSurfaceAdaptive(chordTolerance, segments, false, numVerts, numTriangles);
+}
+
+
+std::vector< std::vector<GLfloat*> >
+WCNurbsSurface::GenerateAdaptiveBuffers(const std::vector<WCNurbsSurface*> &surfaces, const WPFloat &chordTolerance,
+	std::vector<WPUInt> &numTriangles, const bool &managed) {
+	std::vector< std::vector<GLfloat*> > buffers(surfaces.size());
+	numTriangles.assign(surfaces.size(), 0);
+	_NurbsSurfaceAdaptiveBatchJob job = { &surfaces, &buffers, &numTriangles, chordTolerance, managed };
+	//Adaptive tessellation never touches GL, so every surface can go to the shared pool
+	WCThreadPool::Shared()->ParallelFor((WPUInt)surfaces.size(), _NurbsSurfaceAdaptiveBatchTask, &job);
+	return buffers;
+}
+
+
 void WCNurbsSurface::GenerateServerBuffers(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lodU,
 	const WPFloat &vStart, const WPFloat &vStop, WPUInt &lodV, std::vector<GLuint> &buffers, const bool &managed) {
+	//Software contexts have no GL to hold the buffers - use GenerateClientBuffers
+	if ((this->_context != NULL) && this->_context->IsSoftware()) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateServerBuffers - No GL in a software context.");
+		return;
+	}
 	//Make sure LOD >= 2
 	lodU = STDMAX(lodU, (WPUInt)2);
 	lodV = STDMAX(lodV, (WPUInt)2);
@@ -1501,6 +2587,78 @@ void WCNurbsSurface::GenerateServerBuffers(const WPFloat &uStart, const WPFloat
 }
 
 
+std::vector<GLfloat*> WCNurbsSurface::UpdateAdaptiveBuffers(const WPFloat &chordTolerance, WPUInt &numVerts, WPUInt &numTriangles,
+	std::vector<WPUInt> &runs) {
+	//Patches away from a control point edit keep their segment counts (and their vertices if no count changes)
+	bool reuse = !this->_isFullyDirty && (this->_dirtyLowU <= this->_dirtyHighU) && (this->_tolerance == chordTolerance);
+	std::vector<GLfloat*> data;
+	runs.clear();
+	if (reuse) data = this->GenerateSurfaceAdaptive(chordTolerance, this->_segments, true, numVerts, numTriangles, &runs);
+	else data = this->GenerateSurfaceStored(chordTolerance, this->_segments, numVerts, numTriangles);
+	if (data.empty()) return data;
+	this->_tolerance = chordTolerance;
+	//The triangles only change with a full mesh
+	if (runs.empty()) this->_numTriangles = numTriangles;
+	else numTriangles = this->_numTriangles;
+	return data;
+}
+
+
+void WCNurbsSurface::GenerateAdaptiveServerBuffers(const WPFloat &chordTolerance, std::vector<GLuint> &buffers, WPUInt &numTriangles) {
+	//Make sure buffers has 4 elements
+	if (buffers.size() < 4) buffers = std::vector<GLuint>(4, 0);
+	//Nothing in VRAM to patch - start over
+	if ((buffers.at(NURBSSURFACE_VERTEX_BUFFER) == 0) || (buffers.at(NURBSSURFACE_NORMAL_BUFFER) == 0)) this->IsVisualDirty(true);
+	WPUInt numVerts, k;
+	std::vector<WPUInt> runs;
+	std::vector<GLfloat*> data = this->UpdateAdaptiveBuffers(chordTolerance, numVerts, numTriangles, runs);
+	if (data.empty()) return;
+	//Same mesh - overwrite just the moved vertices and normals, a run at a time
+	if (!runs.empty()) {
+		GLfloat *vData = data.at(NURBSSURFACE_VERTEX_BUFFER), *nData = data.at(NURBSSURFACE_NORMAL_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, buffers.at(NURBSSURFACE_VERTEX_BUFFER));
+		for (k=0; k<runs.size(); k+=2) {
+			glBufferSubData(GL_ARRAY_BUFFER, runs.at(k) * NURBSSURFACE_FLOATS_PER_VERTEX * sizeof(GLfloat),
+				runs.at(k+1) * NURBSSURFACE_FLOATS_PER_VERTEX * sizeof(GLfloat), vData);
+			vData += runs.at(k+1) * NURBSSURFACE_FLOATS_PER_VERTEX;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, buffers.at(NURBSSURFACE_NORMAL_BUFFER));
+		for (k=0; k<runs.size(); k+=2) {
+			glBufferSubData(GL_ARRAY_BUFFER, runs.at(k) * NURBSSURFACE_FLOATS_PER_NORMAL * sizeof(GLfloat),
+				runs.at(k+1) * NURBSSURFACE_FLOATS_PER_NORMAL * sizeof(GLfloat), nData);
+			nData += runs.at(k+1) * NURBSSURFACE_FLOATS_PER_NORMAL;
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		delete [] data.at(NURBSSURFACE_VERTEX_BUFFER);
+		delete [] data.at(NURBSSURFACE_NORMAL_BUFFER);
+		if (glGetError() != GL_NO_ERROR)
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateAdaptiveServerBuffers - Error at Updating Buffers.");
+		return;
+	}
+	//Load the vertex, normal, and texcoord buffers
+	GLuint tmpBuffer;
+	if (buffers.at(NURBSSURFACE_VERTEX_BUFFER) == 0) { glGenBuffers(1, &tmpBuffer); buffers.at(NURBSSURFACE_VERTEX_BUFFER) = tmpBuffer; }
+	glBindBuffer(GL_ARRAY_BUFFER, buffers.at(NURBSSURFACE_VERTEX_BUFFER));
+	glBufferData(GL_ARRAY_BUFFER, numVerts * NURBSSURFACE_FLOATS_PER_VERTEX * sizeof(GLfloat), data.at(NURBSSURFACE_VERTEX_BUFFER), GL_STATIC_DRAW);
+	if (buffers.at(NURBSSURFACE_NORMAL_BUFFER) == 0) { glGenBuffers(1, &tmpBuffer); buffers.at(NURBSSURFACE_NORMAL_BUFFER) = tmpBuffer; }
+	glBindBuffer(GL_ARRAY_BUFFER, buffers.at(NURBSSURFACE_NORMAL_BUFFER));
+	glBufferData(GL_ARRAY_BUFFER, numVerts * NURBSSURFACE_FLOATS_PER_NORMAL * sizeof(GLfloat), data.at(NURBSSURFACE_NORMAL_BUFFER), GL_STATIC_DRAW);
+	if (buffers.at(NURBSSURFACE_TEXCOORD_BUFFER) == 0) { glGenBuffers(1, &tmpBuffer); buffers.at(NURBSSURFACE_TEXCOORD_BUFFER) = tmpBuffer; }
+	glBindBuffer(GL_ARRAY_BUFFER, buffers.at(NURBSSURFACE_TEXCOORD_BUFFER));
+	glBufferData(GL_ARRAY_BUFFER, numVerts * NURBSSURFACE_FLOATS_PER_TEXCOORD * sizeof(GLfloat), data.at(NURBSSURFACE_TEXCOORD_BUFFER), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	//Load the index buffer
+	if (buffers.at(NURBSSURFACE_INDEX_BUFFER) == 0) { glGenBuffers(1, &tmpBuffer); buffers.at(NURBSSURFACE_INDEX_BUFFER) = tmpBuffer; }
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.at(NURBSSURFACE_INDEX_BUFFER));
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, numTriangles * 3 * sizeof(GLuint), data.at(NURBSSURFACE_INDEX_BUFFER), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	//Clean up and report errors
+	this->ReleaseBuffers(data);
+	if (glGetError() != GL_NO_ERROR)
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateAdaptiveServerBuffers - Error at Loading Buffers.");
+}
+
+
 void WCNurbsSurface::ReleaseBuffers(std::vector<GLuint> &buffers) {
 	//Make sure there are some values
 	if (buffers.size() >= 4) {
@@ -1516,6 +2674,11 @@ void WCNurbsSurface::ReleaseBuffers(std::vector<GLuint> &buffers) {
 
 void WCNurbsSurface::GenerateTextureBuffers(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lodU,
 	const WPFloat &vStart, const WPFloat &vStop, WPUInt &lodV, std::vector<GLuint> &textures, const bool &managed) {
+	//Software contexts have no GL to hold the textures
+	if ((this->_context != NULL) && this->_context->IsSoftware()) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateTextureBuffers - No GL in a software context.");
+		return;
+	}
 	//Make sure LOD >= 2
 	lodU = STDMAX(lodU, (WPUInt)2);
 	lodV = STDMAX(lodV, (WPUInt)2);
@@ -1619,33 +2782,209 @@ void WCNurbsSurface::ReleaseTextures(std::vector<GLuint> &textures) {
 }
 
 
-void WCNurbsSurface::InsertKnotU(const WPFloat &u, const WPUInt &multiplicity) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::InsertKnotU - Not yet implemented.");
+//Swap the two control point indices so U operations see one row per U index
+static void _NurbsSurfaceTranspose(const std::vector<WPFloat> &src, const WPUInt &rows, const WPUInt &cols,
+	std::vector<WPFloat> &dst) {
+	dst.resize(src.size());
+	for (WPUInt r=0; r<rows; r++)
+		for (WPUInt c=0; c<cols; c++)
+			memcpy(&dst[(c*rows + r)*4], &src[(r*cols + c)*4], 4 * sizeof(WPFloat));
 }
 
 
-void WCNurbsSurface::InsertKnotV(const WPFloat &v, const WPUInt &multiplicity) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::InsertKnotV - Not yet implemented.");
+void WCNurbsSurface::HomogeneousData(std::vector<WPFloat> &knotsU, std::vector<WPFloat> &knotsV, std::vector<WPFloat> &hcp) {
+	knotsU.assign(this->_knotPointsU, this->_knotPointsU + this->_kpU);
+	knotsV.assign(this->_knotPointsV, this->_knotPointsV + this->_kpV);
+	//Control points as (xw, yw, zw, w), one row of cpU per V index
+	hcp.resize(this->_controlPoints.size() * 4);
+	for (WPUInt i=0; i<this->_controlPoints.size(); i++) {
+		const WCVector4 &cp = this->_controlPoints[i];
+		hcp[i*4]   = cp.I() * cp.L();
+		hcp[i*4+1] = cp.J() * cp.L();
+		hcp[i*4+2] = cp.K() * cp.L();
+		hcp[i*4+3] = cp.L();
+	}
 }
 
 
-void WCNurbsSurface::RefineKnot(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::RefineKnot - Not yet implemented.");
+bool WCNurbsSurface::Redefine(const WPUInt &degreeU, const WPUInt &degreeV, const std::vector<WPFloat> &knotsU,
+	const std::vector<WPFloat> &knotsV, const std::vector<WPFloat> &hcp) {
+	WPUInt cpU = (WPUInt)knotsU.size() - degreeU - 1;
+	WPUInt cpV = (WPUInt)knotsV.size() - degreeV - 1;
+	//Make sure the result still fits the surface limits
+	if ((degreeU < 1) || (degreeV < 1) || (degreeU > NURBSSURFACE_MAX_DEGREE) || (degreeV > NURBSSURFACE_MAX_DEGREE) ||
+		(cpU * cpV > NURBSSURFACE_MAX_CONTROLPOINTS) || (cpU * cpV * 4 != hcp.size())) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCNurbsSurface::Redefine - Result exceeds surface limits (degree " << degreeU << "x" << degreeV
+			<< ", " << cpU << "x" << cpV << " control points).");
+		return false;
+	}
+	//Replace the knot vectors
+	if (this->_knotPointsU != NULL) delete [] this->_knotPointsU;
+	if (this->_knotPointsV != NULL) delete [] this->_knotPointsV;
+	this->_degreeU = degreeU;
+	this->_degreeV = degreeV;
+	this->_cpU = cpU;
+	this->_cpV = cpV;
+	this->_kpU = (WPUInt)knotsU.size();
+	this->_kpV = (WPUInt)knotsV.size();
+	this->_modeU = WCNurbsMode::Custom();
+	this->_modeV = WCNurbsMode::Custom();
+	this->_knotPointsU = WCNurbs::LoadCustomKnotPoints(knotsU);
+	this->_knotPointsV = WCNurbs::LoadCustomKnotPoints(knotsV);
+	//Back to Cartesian control points with weights
+	this->_controlPoints.resize(cpU * cpV);
+	for (WPUInt i=0; i<cpU*cpV; i++)
+		this->_controlPoints[i].Set(hcp[i*4] / hcp[i*4+3], hcp[i*4+1] / hcp[i*4+3], hcp[i*4+2] / hcp[i*4+3], hcp[i*4+3]);
+	this->_lengthU = WCNurbs::EstimateLengthU(this->_controlPoints, this->_cpU);
+	this->_lengthV = WCNurbs::EstimateLengthV(this->_controlPoints, this->_cpV);
+	this->_bounds->Set(this->_controlPoints);
+	//Mark the object as dirty
+	this->_revision++;
+	this->IsVisualDirty(true);
+	this->IsSerialDirty(true);
+	return true;
 }
 
 
-void WCNurbsSurface::RemoveKnot(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::RemoveKnot - Not yet implemented.");
+bool WCNurbsSurface::InsertKnotU(const WPFloat &u, const WPUInt &multiplicity) {
+	std::vector<WPFloat> knotsU, knotsV, hcp, rows;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	//U operations work on the transposed net
+	_NurbsSurfaceTranspose(hcp, this->_cpV, this->_cpU, rows);
+	if (WCNurbs::InsertKnot(this->_degreeU, knotsU, rows, this->_cpV * 4, u, multiplicity) == 0) return false;
+	_NurbsSurfaceTranspose(rows, (WPUInt)knotsU.size() - this->_degreeU - 1, this->_cpV, hcp);
+	return this->Redefine(this->_degreeU, this->_degreeV, knotsU, knotsV, hcp);
 }
 
 
-void WCNurbsSurface::ElevateDegree(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::ElevateDegree - Not yet implemented.");
+bool WCNurbsSurface::InsertKnotV(const WPFloat &v, const WPUInt &multiplicity) {
+	std::vector<WPFloat> knotsU, knotsV, hcp;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	if (WCNurbs::InsertKnot(this->_degreeV, knotsV, hcp, this->_cpU * 4, v, multiplicity) == 0) return false;
+	return this->Redefine(this->_degreeU, this->_degreeV, knotsU, knotsV, hcp);
+}
+
+
+bool WCNurbsSurface::RefineKnotU(const std::vector<WPFloat> &insert) {
+	std::vector<WPFloat> knotsU, knotsV, hcp, rows;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	_NurbsSurfaceTranspose(hcp, this->_cpV, this->_cpU, rows);
+	if (!WCNurbs::RefineKnots(this->_degreeU, knotsU, rows, this->_cpV * 4, insert)) return false;
+	_NurbsSurfaceTranspose(rows, (WPUInt)knotsU.size() - this->_degreeU - 1, this->_cpV, hcp);
+	return this->Redefine(this->_degreeU, this->_degreeV, knotsU, knotsV, hcp);
+}
+
+
+bool WCNurbsSurface::RefineKnotV(const std::vector<WPFloat> &insert) {
+	std::vector<WPFloat> knotsU, knotsV, hcp;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	if (!WCNurbs::RefineKnots(this->_degreeV, knotsV, hcp, this->_cpU * 4, insert)) return false;
+	return this->Redefine(this->_degreeU, this->_degreeV, knotsU, knotsV, hcp);
+}
+
+
+WPUInt WCNurbsSurface::RemoveKnotU(const WPFloat &u, const WPUInt &count, const WPFloat &tolerance) {
+	std::vector<WPFloat> knotsU, knotsV, hcp, rows;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	_NurbsSurfaceTranspose(hcp, this->_cpV, this->_cpU, rows);
+	WPUInt removed = WCNurbs::RemoveKnot(this->_degreeU, knotsU, rows, this->_cpV * 4, u, count, tolerance);
+	if (removed == 0) return 0;
+	_NurbsSurfaceTranspose(rows, (WPUInt)knotsU.size() - this->_degreeU - 1, this->_cpV, hcp);
+	return this->Redefine(this->_degreeU, this->_degreeV, knotsU, knotsV, hcp) ? removed : 0;
+}
+
+
+WPUInt WCNurbsSurface::RemoveKnotV(const WPFloat &v, const WPUInt &count, const WPFloat &tolerance) {
+	std::vector<WPFloat> knotsU, knotsV, hcp;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	WPUInt removed = WCNurbs::RemoveKnot(this->_degreeV, knotsV, hcp, this->_cpU * 4, v, count, tolerance);
+	if (removed == 0) return 0;
+	return this->Redefine(this->_degreeU, this->_degreeV, knotsU, knotsV, hcp) ? removed : 0;
+}
+
+
+bool WCNurbsSurface::ElevateDegree(const WPUInt &timesU, const WPUInt &timesV) {
+	std::vector<WPFloat> knotsU, knotsV, hcp, rows;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	WPUInt degreeU = this->_degreeU, degreeV = this->_degreeV;
+	//V first on the natural layout, then U on the transposed one
+	if (!WCNurbs::ElevateDegree(degreeV, knotsV, hcp, this->_cpU * 4, timesV)) return false;
+	WPUInt cpV = (WPUInt)knotsV.size() - degreeV - 1;
+	_NurbsSurfaceTranspose(hcp, cpV, this->_cpU, rows);
+	if (!WCNurbs::ElevateDegree(degreeU, knotsU, rows, cpV * 4, timesU)) return false;
+	_NurbsSurfaceTranspose(rows, (WPUInt)knotsU.size() - degreeU - 1, cpV, hcp);
+	return this->Redefine(degreeU, degreeV, knotsU, knotsV, hcp);
+}
+
+
+bool WCNurbsSurface::ReduceDegree(const bool &reduceU, const bool &reduceV, const WPFloat &tolerance) {
+	std::vector<WPFloat> knotsU, knotsV, hcp, rows;
+	this->HomogeneousData(knotsU, knotsV, hcp);
+	WPUInt degreeU = this->_degreeU, degreeV = this->_degreeV;
+	//Each direction gets half of the tolerance when both are reduced
+	WPFloat tol = (reduceU && reduceV) ? tolerance / 2.0 : tolerance;
+	if (reduceV && !WCNurbs::ReduceDegree(degreeV, knotsV, hcp, this->_cpU * 4, tol)) return false;
+	if (reduceU) {
+		WPUInt cpV = (WPUInt)knotsV.size() - degreeV - 1;
+		_NurbsSurfaceTranspose(hcp, cpV, this->_cpU, rows);
+		if (!WCNurbs::ReduceDegree(degreeU, knotsU, rows, cpV * 4, tol)) return false;
+		_NurbsSurfaceTranspose(rows, (WPUInt)knotsU.size() - degreeU - 1, cpV, hcp);
+	}
+	return this->Redefine(degreeU, degreeV, knotsU, knotsV, hcp);
+}
+
+
+WPUInt WCNurbsSurface::BezierPatches(const WPFloat* &points, const WPFloat* &breaksU, const WPFloat* &breaksV,
+	WPUInt &numU, WPUInt &numV) {
+	WPUInt pU = this->_degreeU, pV = this->_degreeV;
+	//Extract again only if the geometry has changed
+	if ((this->_bezierBreaksU.size() == 0) || (this->_bezierRevision != this->_revision)) {
+		std::vector<WPFloat> knotsU, knotsV, hcp, rows;
+		this->HomogeneousData(knotsU, knotsV, hcp);
+		WPUInt segV = WCNurbs::DecomposeBezier(pV, knotsV, hcp, this->_cpU * 4);
+		WPUInt cpV = segV * pV + 1;
+		_NurbsSurfaceTranspose(hcp, cpV, this->_cpU, rows);
+		WPUInt segU = (segV > 0) ? WCNurbs::DecomposeBezier(pU, knotsU, rows, cpV * 4) : 0;
+		WPUInt cpU = segU * pU + 1;
+		_NurbsSurfaceTranspose(rows, cpU, cpV, hcp);
+		this->_bezierBreaksU.clear();
+		this->_bezierBreaksV.clear();
+		this->_bezierPoints.resize(segU * segV * (pU+1) * (pV+1) * 4);
+		if (segU > 0) {
+			//Copy each patch out of the decomposed net, rows of pU+1 per V index
+			WPFloat *dst = this->_bezierPoints.size() ? &this->_bezierPoints[0] : NULL;
+			for (WPUInt j=0; j<segV; j++)
+				for (WPUInt i=0; i<segU; i++)
+					for (WPUInt b=0; b<=pV; b++, dst += (pU+1)*4)
+						memcpy(dst, &hcp[((j*pV + b)*cpU + i*pU)*4], (pU+1) * 4 * sizeof(WPFloat));
+			for (WPUInt i=0; i<segU; i++) this->_bezierBreaksU.push_back(knotsU[pU + i*pU]);
+			this->_bezierBreaksU.push_back(knotsU.back());
+			for (WPUInt j=0; j<segV; j++) this->_bezierBreaksV.push_back(knotsV[pV + j*pV]);
+			this->_bezierBreaksV.push_back(knotsV.back());
+		}
+		this->_bezierRevision = this->_revision;
+	}
+	numU = this->_bezierBreaksU.size() ? (WPUInt)this->_bezierBreaksU.size() - 1 : 0;
+	numV = this->_bezierBreaksV.size() ? (WPUInt)this->_bezierBreaksV.size() - 1 : 0;
+	points = this->_bezierPoints.size() ? &this->_bezierPoints[0] : NULL;
+	breaksU = numU ? &this->_bezierBreaksU[0] : NULL;
+	breaksV = numV ? &this->_bezierBreaksV[0] : NULL;
+	return numU * numV;
 }
 
 
-void WCNurbsSurface::ReduceDegree(void) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::ReduceDegree - Not yet implemented.");
+const WCBezierHierarchy* WCNurbsSurface::Hierarchy(const WPFloat &tolerance) {
+	//Rebuild only if the geometry or the tolerance has changed
+	if ((this->_hierarchy != NULL) && (this->_hierarchyRevision == this->_revision) &&
+		(this->_hierarchy->Tolerance() == tolerance)) return this->_hierarchy;
+	if (this->_hierarchy != NULL) delete this->_hierarchy;
+	this->_hierarchy = NULL;
+	const WPFloat *points, *breaksU, *breaksV;
+	WPUInt numU, numV;
+	if (this->BezierPatches(points, breaksU, breaksV, numU, numV) == 0) return NULL;
+	this->_hierarchy = new WCBezierHierarchy(this->_degreeU, this->_degreeV, numU, numV, points, breaksU, breaksV, tolerance);
+	this->_hierarchyRevision = this->_revision;
+	return this->_hierarchy;
 }
 
 
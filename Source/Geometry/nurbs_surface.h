@@ -33,6 +33,8 @@
 /*** Included Header Files ***/
 #include <Geometry/wgeol.h>
 #include <Geometry/geometric_types.h>
+#include <Geometry/nurbs.h>
+#include <Utility/tessellation_store.h>
 
 
 /*** Locally Defined Values ***/
@@ -66,16 +68,23 @@
 //Buffer Constants
 #define NURBSSURFACE_VERTEX_BUFFER				0
 #define NURBSSURFACE_NORMAL_BUFFER				1
-#define NURBSSURFACE_TEXCOORD_BUFFER			2
+#define NURBSSURFACE_TEXCOORD_BUFFER			2		//Raw knot u,v - not normalized to [0,1]
 #define NURBSSURFACE_INDEX_BUFFER				3
 //Accuracy Constants
 #define NURBSSURFACE_AREA_ACCURACY				0.001
+#define NURBSSURFACE_KNOT_TOLERANCE				0.001		//Default deviation for knot removal and degree reduction
+#define NURBSSURFACE_ADAPTIVE_PROBES			4			//Probe segments per patch side for flatness
+#define NURBSSURFACE_ADAPTIVE_MAX_SEGMENTS		64			//Max segments per patch side
+#define NURBSSURFACE_MASS_MAX_DEPTH				6			//Max quadrature cell splits per patch
+#define NURBSSURFACE_MASS_TRIM_DEPTH			7			//Quadrature cell splits along trim loops
+#define NURBSSURFACE_HIERARCHY_ACCURACY			0.001		//Default flatness of bounding hierarchy pieces
 //Performance Levels
 #define NURBSSURFACE_PERFLEVEL_HIGH				0
 #define NURBSSURFACE_PERFLEVEL_MEDIUM			1
 #define NURBSSURFACE_PERFLEVEL_LOW				2
 //Other Definitions
 #define NURBSSURFACE_SIZE4_CUTOFF				225
+#define NURBSSURFACE_PARALLEL_CUTOFF			16384
 
 
 /*** Namespace Declaration ***/
@@ -84,6 +93,26 @@ namespace __WILDCAT_NAMESPACE__ {
 
 /*** Class Predefines ***/
 class WCGeometryContext;
+class WCBezierHierarchy;
+
+
+/***********************************************~***************************************************/
+
+
+/*** Mass properties (unit density).  The surface integrals add up over the faces of a closed shell,
+	 then Finish derives the centroid and inertia tensor from them. ***/
+struct WSMassProperties {
+	WPFloat										area;												//!< Surface area
+	WPFloat										volume;												//!< Enclosed volume (closed shells only)
+	WPFloat										moments[3];											//!< First moments of volume - x, y, z
+	WPFloat										products[6];										//!< Second moments of volume - xx, yy, zz, xy, yz, zx
+	WCVector4									centroid;											//!< Centroid of the volume
+	WPFloat										inertia[6];											//!< Inertia tensor about the centroid - xx, yy, zz, xy, yz, zx
+	WPFloat										seconds;											//!< Wall time taken
+	WSMassProperties();																				//!< Default constructor - all zero
+	void Add(const WSMassProperties &props, const bool &orientation);								//!< Sum in a face (false if reversed)
+	void Finish(void);																				//!< Derive centroid and inertia from the sums
+};
 
 
 /***********************************************~***************************************************/
@@ -101,6 +130,19 @@ protected:
 	WPUInt										_lodU, _lodV;										//!< Values for LOD calculations
 	std::vector<GLuint>							_buffers;											//!< Data buffers - GPU for vertex, normal, index, and texcoords
 	std::vector<GLfloat*>						_altBuffers;										//!< Data buffers - CPU for vertex, normal, index, and texcoords
+	WPFloat										_tolerance;											//!< Chord height of the adaptive buffers
+	WPUInt										_numTriangles;										//!< Number of triangles in the adaptive buffers
+	std::vector<WPUInt>							_segments;											//!< U and V segment counts of each patch
+	WCNurbsBasisCache							_basisCacheU, _basisCacheV;							//!< Basis values for Low tessellation
+	bool										_isFullyDirty;										//!< Whole surface buffers need regenerating
+	WPUInt										_dirtyLowU, _dirtyHighU;							//!< U range of control points changed since generation
+	WPUInt										_dirtyLowV, _dirtyHighV;							//!< V range of control points changed since generation
+	WPUInt										_revision;											//!< Geometry revision - keys the tessellation cache
+	WPUInt										_bezierRevision;									//!< Revision the Bezier patches were extracted at
+	std::vector<WPFloat>						_bezierPoints;										//!< Homogeneous Bezier patches
+	std::vector<WPFloat>						_bezierBreaksU, _bezierBreaksV;						//!< Parametric breaks between the patches
+	WCBezierHierarchy							*_hierarchy;										//!< Bounding hierarchy over the Bezier patches
+	WPUInt										_hierarchyRevision;									//!< Revision the hierarchy was built at
 private:
 	//Private Methods
 	void ValidateClosure(void);																		//!< Check the closure of the surface
@@ -128,8 +170,24 @@ private:
 	GLuint* GenerateIndex(const WPFloat &uStart, const WPFloat &uStop, const WPUInt &lodU,			//!< Generate GL array index data
 												const WPFloat &vStart, const WPFloat &vStop, const WPUInt &lodV, 
 												const bool &server, GLuint &buffer);
+	std::vector<GLfloat*> GenerateSurfaceAdaptive(const WPFloat &chordTolerance,					//!< Generate a crack-free adaptive mesh (or just the dirty runs)
+												std::vector<WPUInt> &segments, const bool &reuse, WPUInt &numVerts, WPUInt &numTriangles,
+												std::vector<WPUInt> *runs=NULL);
+	std::vector<GLfloat*> GenerateSurfaceStored(const WPFloat &chordTolerance,						//!< Full adaptive mesh, loaded from the active store if possible
+												std::vector<WPUInt> &segments, WPUInt &numVerts, WPUInt &numTriangles);
+	void MarkControlPointsDirty(const WPUInt &lowU, const WPUInt &highU,							//!< Mark a block of control points as changed
+												const WPUInt &lowV, const WPUInt &highV);
+	void HomogeneousData(std::vector<WPFloat> &knotsU, std::vector<WPFloat> &knotsV,				//!< Copy out the knots and homogeneous control points
+												std::vector<WPFloat> &hcp);
+	bool Redefine(const WPUInt &degreeU, const WPUInt &degreeV, const std::vector<WPFloat> &knotsU,	//!< Replace degrees, knots and control points after a knot operation
+												const std::vector<WPFloat> &knotsV, const std::vector<WPFloat> &hcp);
 	//Hidden Constructors
 	WCNurbsSurface();																				//!< Deny access to default constructor
+protected:
+	WSMassProperties IntegrateMass(const WPFloat &tolerance,										//!< Gauss quadrature over the patches (clipped to u,v loops)
+												const std::vector< std::vector<WPFloat> > *loops);
+	WPUInt RayHits(const WCRay &ray, const WPFloat &tolerance, std::vector<WPFloat> &hits,			//!< Ray hits as u,v,t triples (inside u,v loops if given)
+												const std::vector< std::vector<WPFloat> > *loops=NULL);
 public:
 	//Constructors and Destructors
 	WCNurbsSurface(WCGeometryContext *context, const WPUInt &degreeU, const WPUInt &degreeV,		//!< Primary constructor
@@ -141,8 +199,12 @@ public:
 	virtual ~WCNurbsSurface();																		//!< Default destructor
 	
 	//General Access Methods
+	virtual void IsVisualDirty(const bool &status);													//!< Set the dirty flag (whole surface)
+	virtual inline bool IsVisualDirty(void) const	{ return this->WCVisualObject::IsVisualDirty(); }	//!< Get the dirty flag
+	inline WPUInt Revision(void) const			{ return this->_revision; }							//!< Get the geometry revision
+	virtual WPHash ContentHash(void);																//!< Hash of degrees, knots and control points
 	inline std::vector<WCVector4> ControlPoints(void){ return this->_controlPoints; }				//!< Get the control points
-	void ControlPoints(const std::vector<WCVector4> &controlPoints);								//!< Set the control points
+	void ControlPoints(const std::vector<WCVector4> &controlPoints);								//!< Set the control points (only changed patches regenerate)
 	inline WPUInt NumberControlPointsU(void) const	{ return this->_cpU; }							//!< Get the number of control points
 	inline WPUInt NumberControlPointsV(void) const	{ return this->_cpV; }							//!< Get the number of control points	
 	inline WPFloat* KnotPointsU(void)				{ return this->_knotPointsU; }					//!< Get the U knot points
@@ -162,6 +224,8 @@ public:
 	virtual WCVector4 Evaluate(const WPFloat &u, const WPFloat &v);									//!< Evaluate a specific point on the surface
 	virtual WCVector4 Derivative(const WPFloat &u, const WPUInt &uDer,								//!< Get the surface derivative
 												const WPFloat &v, const WPUInt &vDer);
+	WCVector4 EvaluatePartials(const WPFloat &u, const WPFloat &v,									//!< Point plus Su and Sv from one basis evaluation
+												WCVector4 &derU, WCVector4 &derV);
 	virtual WCRay Tangent(const WPFloat &u, const WPFloat &v);										//!< Get a tangential ray from the surface at u,v
 	virtual std::pair<WCVector4,WCVector4> PointInversion(const WCVector4 &point);					//!< Project from point to closest location on surface
 	virtual WCVisualObject* HitTest(const WCRay &ray, const WPFloat &tolerance);					//!< Hit test with a ray	
@@ -169,14 +233,30 @@ public:
 	virtual void ApplyTranslation(const WCVector4 &translation);									//!< Apply a linear translation to the object
 	virtual void Render(const GLuint &defaultProg, const WCColor &color, const WPFloat &zoom);		//!< Render the object
 	virtual void ReceiveNotice(WCObjectMsg msg, WCObject *sender);									//!< Receive messages from other objects
+	virtual WSMassProperties MassProperties(const WPFloat &tolerance=NURBSSURFACE_AREA_ACCURACY);	//!< Area, and volume terms for closed shells
+	bool InvertPoint(const WCVector4 &point, WPFloat &u, WPFloat &v);								//!< CPU point inversion - hierarchy seed then Newton
+	bool InvertPoints(const WPFloat *points, const WPUInt &count, WPFloat *uv);					//!< Invert many points (4 doubles in, u,v out, in parallel)
+	static bool InsideLoops(const std::vector< std::vector<WPFloat> > &loops,						//!< Even-odd test of u,v against closed u,v loops
+												const WPFloat &u, const WPFloat &v);
 
 	//Buffer Generation Methods
 	std::vector<GLfloat*> GenerateClientBuffers(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lodU,	//!< Generate uo to LOD (vert, tex, norm, index) - put in RAM
 												const WPFloat &vStart, const WPFloat &vStop, WPUInt &lodV, const bool &managed);
+	static std::vector< std::vector<GLfloat*> > GenerateClientBuffers(								//!< Generate client buffers for many surfaces in parallel
+												const std::vector<WCNurbsSurface*> &surfaces, WPUInt &lodU, WPUInt &lodV, const bool &managed);
 	void ReleaseBuffers(std::vector<GLfloat*> &buffers);											//!< Manage the release of buffer resources
+	std::vector<GLfloat*> GenerateAdaptiveBuffers(const WPFloat &chordTolerance,					//!< Generate an adaptive mesh (vert, norm, tex, index) - put in RAM
+												WPUInt &numVerts, WPUInt &numTriangles, const bool &managed=false);
+	static std::vector< std::vector<GLfloat*> > GenerateAdaptiveBuffers(							//!< Generate adaptive meshes for many surfaces in parallel
+												const std::vector<WCNurbsSurface*> &surfaces, const WPFloat &chordTolerance,
+												std::vector<WPUInt> &numTriangles, const bool &managed=false);
+	std::vector<GLfloat*> UpdateAdaptiveBuffers(const WPFloat &chordTolerance,						//!< Adaptive mesh after edits - just the moved (vert, norm) runs if the mesh holds
+												WPUInt &numVerts, WPUInt &numTriangles, std::vector<WPUInt> &runs);
 	void GenerateServerBuffers(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lodU,			//!< Generate uo to LOD (vert, tex, norm, index) - put in VRAM
 													const WPFloat &vStart, const WPFloat &vStop, WPUInt &lodV,
 													std::vector<GLuint> &buffers, const bool &managed);
+	void GenerateAdaptiveServerBuffers(const WPFloat &chordTolerance,								//!< Generate an adaptive mesh - put in VRAM
+												std::vector<GLuint> &buffers, WPUInt &numTriangles);
 	void ReleaseBuffers(std::vector<GLuint> &buffers);												//!< Manage the release of buffer resources
 	void GenerateTextureBuffers(const WPFloat &uStart, const WPFloat &uStop, WPUInt &lodU,			//!< Generate a texture buffer of the surface
 													const WPFloat &vStart, const WPFloat &vStop, WPUInt &lodV,
@@ -184,12 +264,20 @@ public:
 	void ReleaseTextures(std::vector<GLuint> &buffers);												//!< Manage the release of texture buffer resource
 
 	//Original Member Methods
-	void InsertKnotU(const WPFloat &u, const WPUInt &multiplicity=1);								//!< Insert a knot a parametric value u
-	void InsertKnotV(const WPFloat &v, const WPUInt &multiplicity=1);								//!< Insert a knot a parametric value v	
-	void RefineKnot(void);																			//!< Refine the curve with multiple knot insertions
-	void RemoveKnot(void);																			//!< Remove knots from the surface
-	void ElevateDegree(void);																		//!< Elevate the degree of the surface
-	void ReduceDegree(void);																		//!< Reduce the degree of the surface
+	bool InsertKnotU(const WPFloat &u, const WPUInt &multiplicity=1);								//!< Insert a knot a parametric value u
+	bool InsertKnotV(const WPFloat &v, const WPUInt &multiplicity=1);								//!< Insert a knot a parametric value v	
+	bool RefineKnotU(const std::vector<WPFloat> &knots);											//!< Refine the surface with multiple U knot insertions
+	bool RefineKnotV(const std::vector<WPFloat> &knots);											//!< Refine the surface with multiple V knot insertions
+	WPUInt RemoveKnotU(const WPFloat &u, const WPUInt &count=1,										//!< Remove a U knot within tolerance, returns the count removed
+												const WPFloat &tolerance=NURBSSURFACE_KNOT_TOLERANCE);
+	WPUInt RemoveKnotV(const WPFloat &v, const WPUInt &count=1,										//!< Remove a V knot within tolerance, returns the count removed
+												const WPFloat &tolerance=NURBSSURFACE_KNOT_TOLERANCE);
+	bool ElevateDegree(const WPUInt &timesU, const WPUInt &timesV);									//!< Elevate the degree of the surface
+	bool ReduceDegree(const bool &reduceU, const bool &reduceV,										//!< Reduce the degree of the surface by one within tolerance
+												const WPFloat &tolerance=NURBSSURFACE_KNOT_TOLERANCE);
+	WPUInt BezierPatches(const WPFloat* &points, const WPFloat* &breaksU,							//!< Homogeneous Bezier patches (v major) and breaks, returns the count (cached per revision)
+												const WPFloat* &breaksV, WPUInt &numU, WPUInt &numV);
+	const WCBezierHierarchy* Hierarchy(const WPFloat &tolerance=NURBSSURFACE_HIERARCHY_ACCURACY);	//!< Bounding hierarchy over the patches (built lazily, cached per revision)
 	
 	//Operator Overloads
 	WCNurbsSurface& operator=(const WCNurbsSurface &surface);										//!< Equals operator
@@ -34,6 +34,8 @@
 #include <Geometry/geometric_line.h>
 #include <Geometry/geometric_algorithms.h>
 #include <Geometry/ray.h>
+#include <Utility/thread_pool.h>
+#include <algorithm>
 
 
 /*** Locally Defined Values ***/
@@ -42,261 +44,151 @@
 #define TRIMSURFACE_EPSILON_TWO					0.0001
 #define TRIMSURFACE_EQUALITY_EPSILON			0.001
 #define TRIMSURFACE_RENDER_ACCURACY				0.20
+#define TRIMSURFACE_RENDER_CHORD				0.005
 #define TRIMSURFACE_RENDER_LOWER				0.85
 #define TRIMSURFACE_RENDER_UPPER				1.55
+#define TRIMSURFACE_GRID_CELLS					64
+#define TRIMSURFACE_SAMPLE_CLEARANCE			0.5
+#define TRIMSURFACE_MAX_PIECES					256
 
 
 /***********************************************~***************************************************/
 
 
-GLuint WCTrimmedNurbsSurface::PointInversionHigh(std::list<WCVector4> &boundaryList) {
-	GLuint numVerts = (GLuint)boundaryList.size();
-	//Get the surface data
-	WPUInt lodU=TRIMSURFACE_PI_TEX_SIZE, lodV=TRIMSURFACE_PI_TEX_SIZE;
-	std::vector<GLuint> buffers;
-	this->WCNurbsSurface::GenerateTextureBuffers(0.0, 1.0, lodU, 0.0, 1.0, lodV, buffers, true);
-	if ((lodU != TRIMSURFACE_PI_TEX_SIZE) || (lodV != TRIMSURFACE_PI_TEX_SIZE))
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::PointInversionHigh - Altered LOD.");
-	//Setup program, parameters, and surface texture
-	glUseProgram(this->_context->TrimInversionProgram());
-	glUniform2i(this->_context->TrimLocations()[TRIMSURFACE_LOC_PI_PARAMS], lodU, lodV);
-	//Set up texture
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, buffers.at(NURBSSURFACE_VERTEX_BUFFER));
-
-	/*** Setup input texture ***/
-	
-	//Allocate space for the input texture (w * h * RGBA)
-	GLuint texWidth = this->_context->TrimMaxTextureSize();
-	GLuint texHeight = (GLuint)ceil((GLfloat)numVerts / (GLfloat)texWidth);
-	GLfloat *pointData = new GLfloat[texWidth * texHeight * 4];
-	GLuint index = 0;
-	WCVector4 pt;
-	//Initialize data in the array
-	for (std::list<WCVector4>::iterator listIter=boundaryList.begin(); listIter != boundaryList.end(); listIter++) {
-		pt = (*listIter);
-		pointData[index*4] =   (GLfloat)pt.I();					//Set first position to x
-		pointData[index*4+1] = (GLfloat)pt.J();					//Set second position to y
-		pointData[index*4+2] = (GLfloat)pt.K();					//Set third position to z
-		pointData[index*4+3] = (GLfloat)1.0;					//Set fourth position to 1.0
-		index++;
+//Shared state for one GenerateTrimMask pass - each task fills a disjoint block of rows
+struct _TrimMaskJob {
+	const std::vector<WPFloat>					*edges;
+	WPUInt										width, height, rowsPerBlock;
+	GLubyte										*mask;
+};
+
+
+static void _TrimMaskBlock(void *data, const WPUInt &index) {
+	_TrimMaskJob *job = (_TrimMaskJob*)data;
+	const std::vector<WPFloat> &edges = *job->edges;
+	WPUInt first = index * job->rowsPerBlock;
+	WPUInt last = STDMIN(first + job->rowsPerBlock, job->height);
+	//Keep only the edges (x0,y0,x1,y1 in texels) that span some row centre of this block
+	std::vector<WPFloat> local;
+	WPFloat yMin = (WPFloat)first + 0.5, yMax = (WPFloat)last - 0.5;
+	WPUInt e, row, i;
+	for (e=0; e<edges.size(); e+=4) {
+		if ((STDMAX(edges[e+1], edges[e+3]) < yMin) || (STDMIN(edges[e+1], edges[e+3]) > yMax)) continue;
+		local.insert(local.end(), edges.begin()+e, edges.begin()+e+4);
 	}
-	//Setup and copy the data into the texture
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, this->_context->TrimInTex());
-	glTexSubImage2D(GL_TEXTURE_RECTANGLE_ARB, 0, 0, 0, texWidth, texHeight, GL_RGBA, GL_FLOAT, pointData);
-	//Check for errors
-	if (glGetError() != GL_NO_ERROR) 
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::PointInversionHigh - Setup Input Texture.");
-	//Delete data array
-	delete pointData;
+	//Even-odd scanline fill - an edge crosses a row when its ends sit on either side (half-open in y)
+	std::vector<WPFloat> crossings;
+	WPFloat y;
+	WPInt start, end;
+	for (row=first; row<last; row++) {
+		y = (WPFloat)row + 0.5;
+		crossings.clear();
+		for (e=0; e<local.size(); e+=4)
+			if ((local[e+1] <= y) != (local[e+3] <= y))
+				crossings.push_back(local[e] + (y - local[e+1]) * (local[e+2] - local[e]) / (local[e+3] - local[e+1]));
+		std::sort(crossings.begin(), crossings.end());
+		GLubyte *line = job->mask + row * job->width;
+		for (i=0; i+1<crossings.size(); i+=2) {
+			//Texel centres in [a, b) are inside
+			start = STDMAX((WPInt)0, (WPInt)ceil(crossings[i] - 0.5));
+			end = STDMIN((WPInt)job->width, (WPInt)ceil(crossings[i+1] - 0.5));
+			for (; start<end; start++) line[start] = 255;
+		}
+	}
+}
 
-	 /*** Setup and render ***/
-	
-	//Save the viewport and polygon mode bits
-	glPushAttrib(GL_VIEWPORT_BIT | GL_POLYGON_BIT | GL_TEXTURE_BIT | GL_ENABLE_BIT);
-	glPushClientAttrib(GL_ALL_ATTRIB_BITS);
-	//Disable some settings
-	glDisable(GL_BLEND);
-	glDisable(GL_DEPTH_TEST);
-	//Bind to framebuffer
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, this->_context->TrimFramebuffer());
-	//Set up the viewport and polygon mode
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-	glViewport(0, 0, texWidth, texHeight);
-	GLfloat vertData[] = { -1.0, -1.0, -1.0, 1.0, 1.0, 1.0, 1.0, -1.0 };
-	//Turn on vertex arrays
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, 0, vertData);
-	//--- Draw ---
-	glDrawArrays(GL_QUADS, 0, 4);
-	//Restore the viewport and polygon mode
-	glPopAttrib();
-	glPopClientAttrib();
-	//Do some error checking
-	if (glGetError() != GL_NO_ERROR) CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::GenerateSurfaceMedium - At Render.");
-	
-	/*** Save output textures into a VBO using PBO ***/
-
-	GLuint buffer;
-	glGenBuffers(1, &buffer);
-	//Bind to the PBO
-	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
-	glBufferData(GL_PIXEL_PACK_BUFFER, texHeight * texWidth * 4 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
-	//Read the pixel data
-	glReadPixels(0, 0, texWidth, texHeight, GL_RGBA, GL_FLOAT, NULL);
-	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-
-	/*** Restore the framebuffer and cleanup ***/
-
-	//Clean up the framebuffer object
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
-	//Release the surface buffers
-	this->ReleaseTextures(buffers);
-	//Bind back to no textures
-	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, 0);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, 0);
-/*** DEBUG ***
-	std::cout << "Point Inversion High: " << boundaryList.size() << std::endl;	
-	glBindBuffer(GL_ARRAY_BUFFER, buffer);
-	GLfloat *data2 = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_READ_ONLY);
-	for (int i=0; i<boundaryList.size(); i++) printf("\t%d: %f %f %f %f\n", i, data2[i*4], data2[i*4+1], data2[i*4+2], data2[i*4+3]);
-	glUnmapBuffer(GL_ARRAY_BUFFER);	
-/*** DEBUG ***/
-	//Should check for errors here
-	if (glGetError() != GL_NO_ERROR) CLOGGER_ERROR(WCLogManager::RootLogger(), "WCNurbsSurface::PointInversionHigh - At Cleanup.");
-	//Return the array of inverted data
-	return buffer;
+
+//Uniform grid over the trim segments (x0,y0,x1,y1) for clearance queries
+struct _TrimSegmentGrid {
+	std::vector<WPFloat>						segments;
+	std::vector< std::vector<WPUInt> >			cells;
+	WPFloat										xMin, yMin, cellX, cellY;
+	WPUInt										cellsX, cellsY;
+};
+
+
+static void _TrimSegmentGridBuild(_TrimSegmentGrid &grid, const std::vector< std::vector<WPFloat> > &loops) {
+	WPUInt l, i, j, n, a, b, x0, x1, y0, y1;
+	for (l=0; l<loops.size(); l++) {
+		n = loops[l].size() / 2;
+		for (i=0; i<n; i++) {
+			j = (i + 1) % n;
+			grid.segments.push_back(loops[l][i*2]);
+			grid.segments.push_back(loops[l][i*2+1]);
+			grid.segments.push_back(loops[l][j*2]);
+			grid.segments.push_back(loops[l][j*2+1]);
+		}
+	}
+	if (grid.segments.empty()) return;
+	WPFloat xMax = grid.xMin = grid.segments[0], yMax = grid.yMin = grid.segments[1];
+	for (i=0; i<grid.segments.size(); i+=2) {
+		grid.xMin = STDMIN(grid.xMin, grid.segments[i]);
+		xMax = STDMAX(xMax, grid.segments[i]);
+		grid.yMin = STDMIN(grid.yMin, grid.segments[i+1]);
+		yMax = STDMAX(yMax, grid.segments[i+1]);
+	}
+	//About one segment per cell
+	grid.cellsX = grid.cellsY = STDMAX((WPUInt)1, STDMIN((WPUInt)TRIMSURFACE_GRID_CELLS, (WPUInt)sqrt((WPFloat)grid.segments.size() / 4.0)));
+	grid.cellX = STDMAX(xMax - grid.xMin, TRIMSURFACE_EPSILON_ONE) / grid.cellsX;
+	grid.cellY = STDMAX(yMax - grid.yMin, TRIMSURFACE_EPSILON_ONE) / grid.cellsY;
+	grid.cells.resize(grid.cellsX * grid.cellsY);
+	for (i=0; i<grid.segments.size(); i+=4) {
+		x0 = STDMIN(grid.cellsX - 1, (WPUInt)((STDMIN(grid.segments[i], grid.segments[i+2]) - grid.xMin) / grid.cellX));
+		x1 = STDMIN(grid.cellsX - 1, (WPUInt)((STDMAX(grid.segments[i], grid.segments[i+2]) - grid.xMin) / grid.cellX));
+		y0 = STDMIN(grid.cellsY - 1, (WPUInt)((STDMIN(grid.segments[i+1], grid.segments[i+3]) - grid.yMin) / grid.cellY));
+		y1 = STDMIN(grid.cellsY - 1, (WPUInt)((STDMAX(grid.segments[i+1], grid.segments[i+3]) - grid.yMin) / grid.cellY));
+		for (b=y0; b<=y1; b++)
+			for (a=x0; a<=x1; a++) grid.cells[b * grid.cellsX + a].push_back(i);
+	}
 }
 
 
-GLuint WCTrimmedNurbsSurface::PointInversionLow(std::list<WCVector4> &boundaryList) {
-	//Setup a whole lot of variables
-	unsigned int numPoints = boundaryList.size();
-	GLint tmpVal = TRIMSURFACE_PI_TEX_SIZE * 4;
-	GLfloat minDist, dist, leftDist, rightDist, topDist, bottomDist, hSign, vSign, vValue, uValue, uDot, vDot, hDirMag, vDirMag;
-	WPUInt lodU=TRIMSURFACE_PI_TEX_SIZE, lodV=TRIMSURFACE_PI_TEX_SIZE;
-	//Get the surface data
-	std::vector<GLfloat*> buffers = this->WCNurbsSurface::GenerateClientBuffers(0.0, 1.0, lodU, 0.0, 1.0, lodV, true);
-	if ((lodU != TRIMSURFACE_PI_TEX_SIZE) || (lodV != TRIMSURFACE_PI_TEX_SIZE))
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::PointInversionLow - Altered LOD.");
-	GLfloat paraU = (GLfloat)(1.0 / (lodU - 1.0));
-	GLfloat paraV = (GLfloat)(1.0 / (lodV - 1.0));
-	GLfloat* surfData = buffers.at(0);
-	GLfloat* buffer = new GLfloat[numPoints * 4];
-	GLuint markIndex, markU, markV, ptIndex=0, surfIndex;
-	WCVector4 pt, surfPt, center, left, right, top, bottom, hPt, vPt, vDir, hDir, pDir;
-
-	//Loop through each point - trying to find surface vertex closest to point
-	for (std::list<WCVector4>::iterator ptIter=boundaryList.begin(); ptIter != boundaryList.end(); ptIter++) {
-		//Get the point
-		pt = *ptIter;
-		//Reset surfIndex
-		surfIndex = 0;
-		minDist = 100000.0;
-		//Loop and find the closest point on the surface
-		for (GLuint v=0; v<lodV; v++) {
-			for (GLuint u=0; u<lodU; u++) {
-				//Determine distance from point to surface point
-				surfPt.Set(surfData[surfIndex], surfData[surfIndex + 1], surfData[surfIndex + 2], 1.0);
-				dist = (GLfloat)surfPt.Distance(pt);
-				//Is this smaller than current smallest
-				if (dist <= minDist) {
-					//Capture the location
-					markIndex = surfIndex;
-					markU = u;
-					markV = v;
-					minDist = dist;
-				}
-				//Increment surfIndex
-				surfIndex += 4;
+static bool _TrimSegmentGridNear(const _TrimSegmentGrid &grid, const WPFloat &x, const WPFloat &y, const WPFloat &radius) {
+	if (grid.segments.empty()) return false;
+	//Cells covering the query box (clamped to the grid)
+	WPFloat fx0 = (x - radius - grid.xMin) / grid.cellX, fx1 = (x + radius - grid.xMin) / grid.cellX;
+	WPFloat fy0 = (y - radius - grid.yMin) / grid.cellY, fy1 = (y + radius - grid.yMin) / grid.cellY;
+	if ((fx1 < 0.0) || (fy1 < 0.0) || (fx0 >= grid.cellsX) || (fy0 >= grid.cellsY)) return false;
+	WPUInt x0 = (WPUInt)STDMAX(fx0, 0.0), x1 = STDMIN(grid.cellsX - 1, (WPUInt)fx1);
+	WPUInt y0 = (WPUInt)STDMAX(fy0, 0.0), y1 = STDMIN(grid.cellsY - 1, (WPUInt)fy1);
+	WPUInt a, b, k, s;
+	WPFloat dx, dy, px, py, t, len2;
+	for (b=y0; b<=y1; b++) {
+		for (a=x0; a<=x1; a++) {
+			const std::vector<WPUInt> &cell = grid.cells[b * grid.cellsX + a];
+			for (k=0; k<cell.size(); k++) {
+				s = cell[k];
+				//Closest point on the segment
+				dx = grid.segments[s+2] - grid.segments[s];
+				dy = grid.segments[s+3] - grid.segments[s+1];
+				px = x - grid.segments[s];
+				py = y - grid.segments[s+1];
+				len2 = dx * dx + dy * dy;
+				t = (len2 > 0.0) ? STDMAX(0.0, STDMIN(1.0, (px * dx + py * dy) / len2)) : 0.0;
+				px -= t * dx;
+				py -= t * dy;
+				if (px * px + py * py < radius * radius) return true;
 			}
 		}
-		//Now determine quadrant
-		center.Set(surfData[markIndex], surfData[markIndex+1], surfData[markIndex+2], 1.0);
-		//Set left point
-		if (markU > 0) {
-			left.Set(surfData[markIndex-4], surfData[markIndex-3], surfData[markIndex-2], 1.0);
-			leftDist = (GLfloat)pt.Distance(left);
-		}
-		else leftDist = 10000.0;
-		//Set the right point
-		if (markU <lodU-1) {
-			right.Set(surfData[markIndex+4], surfData[markIndex+5], surfData[markIndex+6], 1.0);
-			rightDist = (GLfloat)pt.Distance(right);
-		}
-		else rightDist = 10000.0;
-		//Set the bottom point
-		if (markV > 0) {
-			bottom.Set(surfData[markIndex-tmpVal], surfData[markIndex-tmpVal+1], surfData[markIndex-tmpVal+2], 1.0);
-			bottomDist = (GLfloat)pt.Distance(bottom);
-		}
-		else bottomDist = 10000.0;
-		//Set the top point
-		if (markV < lodV-1) {
-			top.Set(surfData[markIndex+tmpVal], surfData[markIndex+tmpVal+1], surfData[markIndex+tmpVal+2], 1.0);
-			topDist = (GLfloat)pt.Distance(top);
-		}
-		else topDist = 10000.0;
-		//Set the signs
-		if (leftDist < rightDist) { hSign = -1.0; hPt = left; }
-		else { hSign = 1.0; hPt = right; }
-		if (bottomDist < topDist) { vSign = -1.0; vPt = bottom; }
-		else { vSign = 1.0; vPt = top; }
-		//Convert from triangle values to [uv]
-		vDir = vPt - center;
-		vDirMag = (GLfloat)vDir.Magnitude();
-		hDir = hPt - center;
-		hDirMag = (GLfloat)hDir.Magnitude();
-		pDir = pt - center;
-		uDot = (GLfloat)hDir.DotProduct(pDir) / (hDirMag * hDirMag);
-		vDot = (GLfloat)vDir.DotProduct(pDir) / (vDirMag * vDirMag);
-		uValue = (paraU * (GLfloat)markU) + (uDot * paraU * hSign);
-		vValue = (paraV * (GLfloat)markV) + (vDot * paraV * vSign);
-		//Bound u and v [0,1]
-		uValue = STDMAX((GLfloat)0.0, STDMIN((GLfloat)1.0, uValue));
-		vValue = STDMAX((GLfloat)0.0, STDMIN((GLfloat)1.0, vValue));
-		//Record [u,v] value into buffer
-		buffer[ptIndex*4] = uValue;			// u value
-		buffer[ptIndex*4 + 1] = vValue;		// v value
-		buffer[ptIndex*4 + 2] = 0.0;		// non-value
-		buffer[ptIndex*4 + 3] = 1.0;		// non-value
-//		std::cout << ptIndex << ": " << pt << " --> U: " << uValue << ", V: " << vValue << ", UDot: " << uDot << ", VDot: " << vDot << std::endl;
-		ptIndex++;
 	}
-	//Release the surface buffers
-	this->ReleaseBuffers(buffers);
-/*** DEBUG ***
-	 for (int i=0; i<numPoints; i++)
-	 std::cout << i << ": " << buffer[i*4] << ", " << buffer[i*4+1] << std::endl;
-/*** DEBUG ***/
-
-	//Buffer the data into the VBO
-	GLuint vbo;
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * numPoints * 4, buffer, GL_STATIC_DRAW);
-	//Return the vbo
-	return vbo;
+	return false;
 }
 
 
-GLuint WCTrimmedNurbsSurface::GenerateTriangulation(std::list<GLuint> &triList) {
-	//Only perform is there are trim profiles
-	if (this->_profileList.size() == 0) return 0;
-	//Make sure there are not current items in the list
-	triList.clear();
-	
-	std::list<WCTrimProfile>::iterator profileIter;
-	std::list<WCVector4> boundaryList, fullList;
-	std::list<WCVector4>::iterator boundaryIter;
-	GLuint numVerts;//, *indexData;
+//Shared state for a batch of trimmed tessellations - each task owns one face
+struct _TrimTessellationBatchJob {
+	const std::vector<WCTrimmedNurbsSurface*>	*surfaces;
+	std::vector< std::vector<GLfloat*> >		*buffers;
+	std::vector<WPUInt>							*numTriangles;
+	WPFloat										chordTolerance;
+};
 
-	//Go through each profile
-	for (profileIter = this->_profileList.begin(); profileIter != this->_profileList.end(); profileIter++) {
-		//Generate complete boundary list for that profile
-		BuildBoundaryList( *profileIter, boundaryList, true );
-		numVerts = (GLint)boundaryList.size();
-		//Concatenate boundaryList to fullList
-		fullList.splice(fullList.end(), boundaryList);
-		//NumVerts is number of vertices from BuildBoundaryList
-		triList.push_back(numVerts);
-	}
-	//Invert all of the points (only u,v values)
-	GLuint vertBuffer;
-	if ((fullList.size() > 1) && (fullList.size() < 262144))
-		vertBuffer = this->PointInversionHigh(fullList);
-	else
-		vertBuffer = this->PointInversionLow(fullList);
-	
-	//Check for errors here
-	GLenum error = glGetError();
-	if (error != GL_NO_ERROR) {
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::GenerateTrimList - GL Error at cleanup: " << error);
-	}
-	//Return the buffer of vertices
-	return vertBuffer;
+
+static void _TrimTessellationBatchTask(void *data, const WPUInt &index) {
+	_TrimTessellationBatchJob *job = (_TrimTessellationBatchJob*)data;
+	WPUInt numVerts;
+	job->buffers->at(index) = job->surfaces->at(index)->GenerateTessellation(job->chordTolerance, numVerts,
+		job->numTriangles->at(index));
 }
 
 
@@ -379,20 +271,110 @@ WCTrimmedNurbsSurface::~WCTrimmedNurbsSurface() {
 
 
 WPFloat WCTrimmedNurbsSurface::Area(const WPFloat &tolerance) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::Area - Not yet implemented.");
-	return 0.0;
+	return this->MassProperties(tolerance).area;
+}
+
+
+void WCTrimmedNurbsSurface::TrimLoops(const WPFloat &tolerance, std::vector< std::vector<WPFloat> > &loops) {
+	//Walk each profile into a closed loop of u,v pairs (each curve skips its first point)
+	std::list<WCVector4> points;
+	std::list<WCVector4>::iterator pointIter;
+	std::list<WCTrimProfile>::iterator profileIter;
+	WCTrimProfile::iterator curveIter;
+	WCGeometricLine *line;
+	WCNurbsCurve *nurb;
+	GLfloat *data;
+	WPUInt i, count;
+	for (profileIter=this->_profileList.begin(); profileIter!=this->_profileList.end(); profileIter++) {
+		points.clear();
+		for (curveIter=(*profileIter).begin(); curveIter!=(*profileIter).end(); curveIter++) {
+			line = dynamic_cast<WCGeometricLine*>((*curveIter).first);
+			nurb = dynamic_cast<WCNurbsCurve*>((*curveIter).first);
+			if (line != NULL) points.push_back((*curveIter).second ? line->End() : line->Begin());
+			//Unmanaged, so faces can run on worker threads
+			else if (nurb != NULL) {
+				data = nurb->GenerateAdaptiveBuffer(tolerance, NURBSCURVE_ADAPTIVE_ANGLE, count, NULL, false);
+				for (i=1; i<count; i++) {
+					if ((*curveIter).second) points.push_back(WCVector4(data[i*4], data[i*4+1], data[i*4+2], 1.0));
+					else points.push_back(WCVector4(data[(count-1-i)*4], data[(count-1-i)*4+1], data[(count-1-i)*4+2], 1.0));
+				}
+				delete [] data;
+			}
+			else for (i=1; i<=TRIMSURFACE_MASS_SAMPLES; i++)
+				points.push_back((*curveIter).first->Evaluate((*curveIter).second ? (WPFloat)i / TRIMSURFACE_MASS_SAMPLES :
+					1.0 - (WPFloat)i / TRIMSURFACE_MASS_SAMPLES));
+		}
+		if (points.size() < 3) continue;
+		//Invert the boundary onto the surface in one batch
+		std::vector<WPFloat> packed;
+		for (pointIter=points.begin(); pointIter!=points.end(); pointIter++) {
+			packed.push_back((*pointIter).I());
+			packed.push_back((*pointIter).J());
+			packed.push_back((*pointIter).K());
+			packed.push_back(1.0);
+		}
+		loops.push_back(std::vector<WPFloat>(points.size() * 2));
+		if (!this->InvertPoints(&packed[0], (WPUInt)points.size(), &loops.back()[0])) loops.pop_back();
+	}
+}
+
+
+bool WCTrimmedNurbsSurface::GenerateTrimMask(const WPUInt &width, const WPUInt &height, const WPFloat &tolerance,
+	std::vector<GLubyte> &mask) {
+	//Make sure the mask has some size
+	if ((width == 0) || (height == 0)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::GenerateTrimMask - Zero mask size.");
+		return false;
+	}
+	mask.assign(width * height, 0);
+	//Invert the trims and scale them from the knot domain into texel units
+	std::vector< std::vector<WPFloat> > loops;
+	this->TrimLoops(tolerance, loops);
+	WPFloat uMin = this->_knotPointsU[this->_degreeU], uScale = width / (this->_knotPointsU[this->_cpU] - uMin);
+	WPFloat vMin = this->_knotPointsV[this->_degreeV], vScale = height / (this->_knotPointsV[this->_cpV] - vMin);
+	std::vector<WPFloat> edges;
+	WPUInt loop, i, j, count;
+	for (loop=0; loop<loops.size(); loop++) {
+		count = loops[loop].size() / 2;
+		for (i=0; i<count; i++) {
+			j = (i + 1) % count;
+			edges.push_back((loops[loop][i*2] - uMin) * uScale);
+			edges.push_back((loops[loop][i*2+1] - vMin) * vScale);
+			edges.push_back((loops[loop][j*2] - uMin) * uScale);
+			edges.push_back((loops[loop][j*2+1] - vMin) * vScale);
+		}
+	}
+	if (edges.empty()) return true;
+	//Fill blocks of rows on the shared pool
+	WCThreadPool *pool = WCThreadPool::Shared();
+	_TrimMaskJob job = { &edges, width, height, 0, &mask[0] };
+	WPUInt numBlocks = STDMIN(height, pool->ThreadCount() * 4);
+	job.rowsPerBlock = (height + numBlocks - 1) / numBlocks;
+	pool->ParallelFor((height + job.rowsPerBlock - 1) / job.rowsPerBlock, _TrimMaskBlock, &job);
+	return true;
+}
+
+
+WSMassProperties WCTrimmedNurbsSurface::MassProperties(const WPFloat &tolerance) {
+	std::vector< std::vector<WPFloat> > loops;
+	this->TrimLoops(tolerance, loops);
+	if (loops.empty()) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::MassProperties - No usable trim profiles.");
+		return this->IntegrateMass(tolerance, NULL);
+	}
+	return this->IntegrateMass(tolerance, &loops);
 }
 
 
 WCVector4 WCTrimmedNurbsSurface::Evaluate(const WPFloat &u, const WPFloat &v) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::Evaluate - Not yet implemented.");
-	return WCVector4();
+	//Trims do not change the underlying surface
+	return this->WCNurbsSurface::Evaluate(u, v);
 }
 
 
 WCVector4 WCTrimmedNurbsSurface::Derivative(const WPFloat &u, const WPUInt &uDer, const WPFloat &v, const WPUInt &vDer) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::Derivative - Not yet implemented.");
-	return WCVector4();
+	//Trims do not change the underlying surface
+	return this->WCNurbsSurface::Derivative(u, uDer, v, vDer);
 }
 
 
@@ -412,9 +394,47 @@ std::pair<WCVector4,WCVector4> WCTrimmedNurbsSurface::PointInversion(const WCVec
 }
 
 
+WPHash WCTrimmedNurbsSurface::ContentHash(void) {
+	//Start from the untrimmed surface
+	WCContentHash hash;
+	WPHash base = this->WCNurbsSurface::ContentHash();
+	hash.Add(&base, sizeof(WPHash));
+	hash.Add((WPUInt)this->_profileList.size());
+	//Mix in every trim curve and its orientation
+	WCNurbsCurve *nurb;
+	WCGeometricLine *line;
+	WPHash curveHash;
+	std::list<WCTrimProfile>::iterator profileIter;
+	WCTrimProfile::iterator curveIter;
+	for (profileIter=this->_profileList.begin(); profileIter!=this->_profileList.end(); profileIter++) {
+		hash.Add((WPUInt)(*profileIter).size());
+		for (curveIter=(*profileIter).begin(); curveIter!=(*profileIter).end(); curveIter++) {
+			hash.Add((WPUInt)(*curveIter).second);
+			nurb = dynamic_cast<WCNurbsCurve*>((*curveIter).first);
+			line = dynamic_cast<WCGeometricLine*>((*curveIter).first);
+			if (nurb != NULL) {
+				curveHash = nurb->ContentHash();
+				hash.Add(&curveHash, sizeof(WPHash));
+			}
+			else if (line != NULL) {
+				hash.Add(line->Begin());
+				hash.Add(line->End());
+			}
+			//Anything else is sampled
+			else for (WPUInt i=0; i<=TRIMSURFACE_HASH_SAMPLES; i++)
+				hash.Add((*curveIter).first->Evaluate((WPFloat)i / TRIMSURFACE_HASH_SAMPLES));
+		}
+	}
+	return hash.Value();
+}
+
+
 WCVisualObject* WCTrimmedNurbsSurface::HitTest(const WCRay &ray, const WPFloat &tolerance) {
-	CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::HitTest - Not yet implemented.");
-	return NULL;
+	//Hits on the base surface only count inside the trim loops
+	std::vector< std::vector<WPFloat> > loops;
+	std::vector<WPFloat> hits;
+	this->TrimLoops(STDMAX(tolerance, NURBSSURFACE_HIERARCHY_ACCURACY), loops);
+	return (this->RayHits(ray, tolerance, hits, loops.empty() ? NULL : &loops) > 0) ? this : NULL;
 }
 
 
@@ -422,32 +442,28 @@ void WCTrimmedNurbsSurface::Render(const GLuint &defaultProg, const WCColor &col
 	//Check to see if the surface is visible
 	if (!this->_isVisible) return;
 
-	//Determine best LOD values
-	WPFloat lengthU = WCNurbs::EstimateLengthU(this->_controlPoints, this->_cpU);
-	WPUInt lodU = STDMAX((WPUInt)(this->_cpU * 5), (WPUInt)(lengthU * sqrt(zoom) / TRIMSURFACE_RENDER_ACCURACY));
-	WPFloat lengthV = WCNurbs::EstimateLengthV(this->_controlPoints, this->_cpV);
-	WPUInt lodV = STDMAX((WPUInt)(this->_cpV * 5), (WPUInt)(lengthV * sqrt(zoom) / TRIMSURFACE_RENDER_ACCURACY));
-	WPFloat factorU = (WPFloat)this->_lodU / (WPFloat)lodU;
-	WPFloat factorV = (WPFloat)this->_lodV / (WPFloat)lodV;
-	//See if need to regenerate underlying surface
-	if ((factorU < TRIMSURFACE_RENDER_LOWER) || (factorU > TRIMSURFACE_RENDER_UPPER) ||
-		(factorV < TRIMSURFACE_RENDER_LOWER) || (factorV > TRIMSURFACE_RENDER_UPPER) ||
-		this->IsVisualDirty())  {
-		//Set the new lod
-		this->_lodU = lodU;
-		this->_lodV = lodV;
+	//Tessellate the underlying surface to a chord height that shrinks as the view zooms in
+	WPFloat tolerance = TRIMSURFACE_RENDER_CHORD / STDMAX(zoom, TRIMSURFACE_EPSILON_ONE);
+	WPFloat factor = this->_tolerance / tolerance;
+	//See if need to regenerate underlying surface (otherwise stay at the current tolerance)
+	if ((factor < TRIMSURFACE_RENDER_LOWER) || (factor > TRIMSURFACE_RENDER_UPPER)) this->IsVisualDirty(true);
+	else tolerance = this->_tolerance;
+	if (this->IsVisualDirty()) {
 		//Generate the server buffer of data
-		this->GenerateServerBuffers(0.0, 1.0, this->_lodU, 0.0, 1.0, this->_lodV, this->_buffers, true);
+		this->GenerateAdaptiveServerBuffers(tolerance, this->_buffers, this->_numTriangles);
 		//Mark as clean
 		this->IsVisualDirty(false);
 	}
+	//Trim texture size follows the surface size
+	WPFloat lengthU = WCNurbs::EstimateLengthU(this->_controlPoints, this->_cpU);
+	WPFloat lengthV = WCNurbs::EstimateLengthV(this->_controlPoints, this->_cpV);
 	//See if texture forces regen.
 	WPUInt texU = STDMIN((WPUInt)TRIMSURFACE_MAX_TEX_SIZE, (WPUInt)(lengthU * sqrt(zoom) / TRIMSURFACE_RENDER_ACCURACY) * 24);
 	WPUInt texV = STDMIN((WPUInt)TRIMSURFACE_MAX_TEX_SIZE, (WPUInt)(lengthV * sqrt(zoom) / TRIMSURFACE_RENDER_ACCURACY) * 24);
 	texU = STDMAX(texU, (WPUInt)16);
 	texV = STDMAX(texV, (WPUInt)16);
-	factorU = (WPFloat)this->_texWidth / (WPFloat)texU;
-	factorV = (WPFloat)this->_texHeight / (WPFloat)texV;
+	WPFloat factorU = (WPFloat)this->_texWidth / (WPFloat)texU;
+	WPFloat factorV = (WPFloat)this->_texHeight / (WPFloat)texV;
 	//Check to see if trim texture is dirty
 	if ((factorU < TRIMSURFACE_RENDER_LOWER) || (factorU > TRIMSURFACE_RENDER_UPPER) ||
 		(factorV < TRIMSURFACE_RENDER_LOWER) || (factorV > TRIMSURFACE_RENDER_UPPER) || this->IsTextureDirty()) {
@@ -499,8 +515,8 @@ void WCTrimmedNurbsSurface::Render(const GLuint &defaultProg, const WCColor &col
 	glUniform1i(loc, 0);
 	loc = glGetUniformLocation(this->_renderProg, "texSize");
 	glUniform2f(loc, (GLfloat)this->_texWidth, (GLfloat)this->_texHeight);
-	//Draw elements (*2 for each triangle in a lod box, *3 for each vertex in a triangle)
-	glDrawElements(GL_TRIANGLES, (this->_lodU-1)*(this->_lodV-1)*2*3, GL_UNSIGNED_INT, 0);
+	//Draw elements (*3 for each vertex in a triangle)
+	glDrawElements(GL_TRIANGLES, this->_numTriangles * 3, GL_UNSIGNED_INT, 0);
 	
 	/*** Draw done - now clean up ***/
 	
@@ -519,7 +535,8 @@ void WCTrimmedNurbsSurface::Render(const GLuint &defaultProg, const WCColor &col
 	
 
 void WCTrimmedNurbsSurface::ReceiveNotice(WCObjectMsg msg, WCObject *sender) {
-	//Mark the surface as dirty
+	//Trims changed - mark the surface as dirty
+	this->_revision++;
 	this->IsVisualDirty(true);
 	this->IsSerialDirty(true);
 	//Update any parents about dirtyness
@@ -528,24 +545,18 @@ void WCTrimmedNurbsSurface::ReceiveNotice(WCObjectMsg msg, WCObject *sender) {
 
 
 void WCTrimmedNurbsSurface::GenerateTrimTexture(GLuint &texWidth, GLuint &texHeight, GLuint &texture, const bool &managed) {
-	//Try to generate all of the tessellated trim profiles
-	std::list<GLuint> triList;
-	GLuint vertBuffer;
-	try {
-		//Generate the triangulations
-		vertBuffer = this->GenerateTriangulation(triList);
-	}
-	//Handle the error
-	catch (...) {
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::GenerateTrimTexture - Exception caught in GenerateTriangulations.");
-		return;
-	}
-
-	/*** Setup output texture and framebuffer ***/
+	//Software contexts have no GL to hold the texture - CPU work calls GenerateTrimMask directly
+	if ((this->_context != NULL) && this->_context->IsSoftware()) return;
+	//Rasterize the trims with about half a texel of chord error
+	WPFloat lengthU = WCNurbs::EstimateLengthU(this->_controlPoints, this->_cpU);
+	WPFloat lengthV = WCNurbs::EstimateLengthV(this->_controlPoints, this->_cpV);
+	WPFloat tolerance = 0.5 * STDMIN(lengthU / texWidth, lengthV / texHeight);
+	std::vector<GLubyte> mask;
+	if (!this->GenerateTrimMask(texWidth, texHeight, STDMAX(tolerance, TRIMSURFACE_EPSILON_ONE), mask)) return;
 
 	//Generate texture if needed
 	if (texture == 0) glGenTextures(1, &texture);
-	//Setup output texture
+	//Upload the mask (row 0 is the low v edge, as the shader expects)
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, texture);
@@ -553,129 +564,181 @@ void WCTrimmedNurbsSurface::GenerateTrimTexture(GLuint &texWidth, GLuint &texHei
 	glTexParameteri(GL_TEXTURE_RECTANGLE_ARB, GL_TEXTURE_WRAP_T, GL_CLAMP);
 	glTexParameteri(GL_TEXTURE_RECTANGLE_ARB, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_RECTANGLE_ARB, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexImage2D(GL_TEXTURE_RECTANGLE_ARB, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_FLOAT, NULL);
+	glTexImage2D(GL_TEXTURE_RECTANGLE_ARB, 0, GL_LUMINANCE8, texWidth, texHeight, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, &mask[0]);
 	//Make sure to unbind from the texture
 	glBindTexture(GL_TEXTURE_RECTANGLE_ARB, 0);
-	//Create and bind to the framebuffer
-	GLuint framebuffer, stencilRB;
-	glGenFramebuffersEXT(1, &framebuffer);
-	glGenRenderbuffersEXT(1, &stencilRB);
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, framebuffer);
-	glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_RECTANGLE_ARB, texture, 0);
-	//Initialize stencil renderbuffer
-	glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, stencilRB);
-	glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH_STENCIL_EXT, texWidth, texHeight);
-	glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_STENCIL_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, stencilRB);
-	//Clear the framebuffer and stencil renderbuffer
-	glClearStencil(0);
-	glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-
-	/*** Setup GL Environment ***/
-
-	//Make sure no programs are active
-	glUseProgram(0);
-	//Save the viewport and polygon mode bits
-	glPushAttrib(GL_VIEWPORT_BIT | GL_POLYGON_BIT | GL_ENABLE_BIT | GL_TEXTURE_BIT);
-	glPushClientAttrib(GL_CLIENT_ALL_ATTRIB_BITS);
-	//Set some GL state settings
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_CULL_FACE);
-	glEnable(GL_STENCIL_TEST);
-	glStencilFunc(GL_ALWAYS, 1, 1);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
-	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-	//Set up the viewport and polygon mode
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-	glViewport(0, 0, texWidth, texHeight);
-	//Push and clear the projection and modelview matrices
-	glMatrixMode(GL_PROJECTION);
-	glPushMatrix();
-	glLoadIdentity();
-	glOrtho(0.0, 1.0, 0.0, 1.0, -1.0, 1.0);
-	glMatrixMode(GL_MODELVIEW);
-	glPushMatrix();
-	glLoadIdentity();
-	
-	/*** Draw all of the trim triangulations ***/
-	
-	//Loop through each triangulation
-	GLuint index = 0;
-	std::list<GLuint>::iterator triIter;
-	for(triIter = triList.begin(); triIter != triList.end(); triIter++) {
-		//Setup vertex buffer
-		glBindBuffer(GL_ARRAY_BUFFER, vertBuffer );
-		glVertexPointer(4, GL_FLOAT, 0, NULL);
-		//Draw the trim
-		glDrawArrays(GL_TRIANGLE_FAN, index, *triIter );
-		//Increment the index
-		index += *triIter;
-	}
-	//Bind back to nothing
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	//Delete the vertex buffer
-	glDeleteBuffers(1, &vertBuffer);
-
-	/*** Draw a covering rectangle ***/
-
-	//Prepare to draw into color buffers
-	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-	glColor4f(1.0, 1.0, 1.0, 1.0);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-	glStencilFunc(GL_NOTEQUAL, 0, 1);
-	GLfloat vertData[] = { -1.0, -1.0, -1.0, 1.0, 1.0, 1.0, 1.0, -1.0 };
-	//Turn on vertex arrays
-	glVertexPointer(2, GL_FLOAT, 0, vertData);
-	//--- Draw ---
-	glDrawArrays(GL_QUADS, 0, 4);
-
-	/*** Restore the GL state ***/
-	
-	//Clean up the GL state
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);
-	glDeleteFramebuffersEXT(1, &framebuffer);
-	glDeleteRenderbuffersEXT(1, &stencilRB);
-	glPopAttrib();
-	glPopClientAttrib();
-	//Pop projection and modelview matrices
-	glPopMatrix();
-	glMatrixMode(GL_PROJECTION);
-	glPopMatrix();
 	//Check for errors
 	GLenum error = glGetError();
 	if (error != GL_NO_ERROR) {
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::GenerateTexture - Unspecified GL Error: " << error);
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::GenerateTrimTexture - Unspecified GL Error: " << error);
 	}
 }
 
 
 void WCTrimmedNurbsSurface::ReleaseTrimTexture(GLuint &texture) {
-	//For now just delete it
-	glDeleteTextures(1, &texture);
+	//For now just delete it (software contexts never make one)
+	if (texture != 0) glDeleteTextures(1, &texture);
 }
 
 
-void WCTrimmedNurbsSurface::GenerateTessellation(WPUInt &lodU, WPUInt &lodV, std::vector<GLfloat*> &buffers) {
-	//Generate dense trim texture
-	//...
-	//Generate lodU x lodV surface mesh
-	//...
-	//Generate all trim boundary points
-	//...
-
-	//Add all trim boundary points into triangle.c input structure (marked as boundary)
-	//and into output buffer
-	//...
-
-	//Look up all surface mesh point in texture to see if they are in or out
-	//add in vertices to both triangle.c (marked as interior) and output structures
-	//...
+std::vector<GLfloat*> WCTrimmedNurbsSurface::GenerateTessellation(const WPFloat &chordTolerance, WPUInt &numVerts, WPUInt &numTriangles) {
+	std::vector<GLfloat*> buffers;
+	numVerts = numTriangles = 0;
+	//Trim loops and the untrimmed adaptive mesh share the chord tolerance
+	std::vector< std::vector<WPFloat> > loops;
+	this->TrimLoops(chordTolerance, loops);
+	if (loops.empty()) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::GenerateTessellation - No trim loops.");
+		return buffers;
+	}
+	WPUInt baseVerts, baseTriangles, i, j, k, l;
+	std::vector<GLfloat*> base = this->WCNurbsSurface::GenerateAdaptiveBuffers(chordTolerance, baseVerts, baseTriangles, false);
+	if (base.size() < 4) return buffers;
+	GLfloat *baseTex = base.at(NURBSSURFACE_TEXCOORD_BUFFER);
+	GLuint *baseIndex = (GLuint*)base.at(NURBSSURFACE_INDEX_BUFFER);
+	//Scale u,v so parameter distances follow model distances (keeps the Delaunay triangles well shaped)
+	WPFloat uMin = this->_knotPointsU[this->_degreeU], uRange = this->_knotPointsU[this->_cpU] - uMin;
+	WPFloat vMin = this->_knotPointsV[this->_degreeV], vRange = this->_knotPointsV[this->_cpV] - vMin;
+	WPFloat scaleU = STDMAX(WCNurbs::EstimateLengthU(this->_controlPoints, this->_cpU), TRIMSURFACE_EPSILON_ONE) / uRange;
+	WPFloat scaleV = STDMAX(WCNurbs::EstimateLengthV(this->_controlPoints, this->_cpV), TRIMSURFACE_EPSILON_ONE) / vRange;
+	//Shortest base edge at each vertex (in scaled u,v)
+	std::vector<WPFloat> clearance(baseVerts, uRange * scaleU + vRange * scaleV);
+	WPFloat dx, dy, d, x, y, longest = 0.0;
+	for (k=0; k<baseTriangles*3; k++) {
+		i = baseIndex[k];
+		j = baseIndex[(k % 3 == 2) ? k - 2 : k + 1];
+		dx = (baseTex[i*2] - baseTex[j*2]) * scaleU;
+		dy = (baseTex[i*2+1] - baseTex[j*2+1]) * scaleV;
+		d = sqrt(dx * dx + dy * dy);
+		clearance[i] = STDMIN(clearance[i], d);
+		clearance[j] = STDMIN(clearance[j], d);
+		longest = STDMAX(longest, d);
+	}
+	//Coarse map of that spacing - cells without a vertex sit in the coarsest part of the mesh
+	WPUInt cells = TRIMSURFACE_GRID_CELLS, a, b;
+	std::vector<WPFloat> spacing(cells * cells, longest);
+	for (i=0; i<baseVerts; i++) {
+		a = STDMIN(cells - 1, (WPUInt)((baseTex[i*2] - uMin) / uRange * cells));
+		b = STDMIN(cells - 1, (WPUInt)((baseTex[i*2+1] - vMin) / vRange * cells));
+		spacing[b * cells + a] = STDMIN(spacing[b * cells + a], clearance[i]);
+	}
+	//Split trim chords down to the local spacing, or long slivers fan out from them and stand off the surface
+	std::vector< std::vector<WPFloat> > refined(loops.size()), scaled(loops.size());
+	WPUInt numLoop = 0, n, m, pieces;
+	WPFloat u0, v0, u1, v1, h;
+	for (l=0; l<loops.size(); l++) {
+		n = loops[l].size() / 2;
+		for (k=0; k<n; k++) {
+			u0 = loops[l][k*2];
+			v0 = loops[l][k*2+1];
+			u1 = loops[l][((k+1)%n)*2];
+			v1 = loops[l][((k+1)%n)*2+1];
+			h = longest;
+			for (m=0; m<3; m++) {
+				a = STDMIN(cells - 1, (WPUInt)(STDMAX(0.0, (u0 + (u1 - u0) * m * 0.5 - uMin) / uRange) * cells));
+				b = STDMIN(cells - 1, (WPUInt)(STDMAX(0.0, (v0 + (v1 - v0) * m * 0.5 - vMin) / vRange) * cells));
+				h = STDMIN(h, spacing[b * cells + a]);
+			}
+			dx = (u1 - u0) * scaleU;
+			dy = (v1 - v0) * scaleV;
+			pieces = (h > 0.0) ? STDMIN((WPUInt)TRIMSURFACE_MAX_PIECES, (WPUInt)ceil(sqrt(dx * dx + dy * dy) / h)) : 1;
+			pieces = STDMAX(pieces, (WPUInt)1);
+			for (m=0; m<pieces; m++) {
+				refined[l].push_back(u0 + (u1 - u0) * m / pieces);
+				refined[l].push_back(v0 + (v1 - v0) * m / pieces);
+				scaled[l].push_back((refined[l][refined[l].size()-2] - uMin) * scaleU);
+				scaled[l].push_back((refined[l].back() - vMin) * scaleV);
+			}
+		}
+		numLoop += refined[l].size() / 2;
+	}
+	//Base vertices closer to a trim than half their shortest edge would only make slivers
+	_TrimSegmentGrid grid;
+	_TrimSegmentGridBuild(grid, scaled);
+	std::vector<WPFloat> samples;
+	std::vector<WPUInt> sampleIndex;
+	for (i=0; i<baseVerts; i++) {
+		x = (baseTex[i*2] - uMin) * scaleU;
+		y = (baseTex[i*2+1] - vMin) * scaleV;
+		if (_TrimSegmentGridNear(grid, x, y, clearance[i] * TRIMSURFACE_SAMPLE_CLEARANCE)) continue;
+		samples.push_back(x);
+		samples.push_back(y);
+		sampleIndex.push_back(i);
+	}
+	//Triangulate with the trims as constraints - outside samples simply drop out
+	std::vector<GLuint> triangles;
+	if (!ConstrainedTriangulation2D(scaled, samples, triangles)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTrimmedNurbsSurface::GenerateTessellation - Triangulation failed.");
+		this->ReleaseBuffers(base);
+		return buffers;
+	}
+	//Number only the vertices the triangles use
+	std::vector<WPInt> remap(numLoop + sampleIndex.size(), -1);
+	for (k=0; k<triangles.size(); k++)
+		if (remap[triangles[k]] < 0) remap[triangles[k]] = (WPInt)numVerts++;
+	GLfloat *vData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_VERTEX];
+	GLfloat *nData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_NORMAL];
+	GLfloat *tData = new GLfloat[numVerts * NURBSSURFACE_FLOATS_PER_TEXCOORD];
+	//Trim points are evaluated on the surface
+	WCVector4 pt, nm;
+	WPFloat u, v;
+	for (l=0, i=0; l<refined.size(); l++) {
+		for (k=0; k<refined[l].size()/2; k++, i++) {
+			if (remap[i] < 0) continue;
+			j = (WPUInt)remap[i];
+			u = refined[l][k*2];
+			v = refined[l][k*2+1];
+			pt = this->WCNurbsSurface::Evaluate(u, v);
+			nm = this->WCNurbsSurface::Derivative(u, 1, v, 0).CrossProduct(this->WCNurbsSurface::Derivative(u, 0, v, 1));
+			if (nm.Magnitude() > 0.0) nm.Normalize(true);
+			vData[j*4]	 = (GLfloat)pt.I();
+			vData[j*4+1] = (GLfloat)pt.J();
+			vData[j*4+2] = (GLfloat)pt.K();
+			vData[j*4+3] = 1.0;
+			nData[j*4]	 = (GLfloat)nm.I();
+			nData[j*4+1] = (GLfloat)nm.J();
+			nData[j*4+2] = (GLfloat)nm.K();
+			nData[j*4+3] = 0.0;
+			tData[j*2]	 = (GLfloat)u;
+			tData[j*2+1] = (GLfloat)v;
+		}
+	}
+	//Samples copy the untrimmed mesh
+	GLfloat *baseVertex = base.at(NURBSSURFACE_VERTEX_BUFFER), *baseNormal = base.at(NURBSSURFACE_NORMAL_BUFFER);
+	for (k=0; k<sampleIndex.size(); k++, i++) {
+		if (remap[i] < 0) continue;
+		j = (WPUInt)remap[i];
+		memcpy(vData + j * 4, baseVertex + sampleIndex[k] * 4, 4 * sizeof(GLfloat));
+		memcpy(nData + j * 4, baseNormal + sampleIndex[k] * 4, 4 * sizeof(GLfloat));
+		memcpy(tData + j * 2, baseTex + sampleIndex[k] * 2, 2 * sizeof(GLfloat));
+	}
+	this->ReleaseBuffers(base);
+	//Flip to the untrimmed mesh winding (clockwise in u,v)
+	numTriangles = (WPUInt)triangles.size() / 3;
+	GLuint *iData = new GLuint[triangles.size()];
+	for (k=0; k<triangles.size(); k+=3) {
+		iData[k]   = (GLuint)remap[triangles[k]];
+		iData[k+1] = (GLuint)remap[triangles[k+2]];
+		iData[k+2] = (GLuint)remap[triangles[k+1]];
+	}
+	//Return client buffers
+	buffers.push_back(vData);			// Must be first
+	buffers.push_back(nData);			// Must be second
+	buffers.push_back(tData);			// Must be third
+	buffers.push_back((GLfloat*)iData);	// Must be fourth
+	return buffers;
+}
 
-	//Run triangle.c and get index buffer
-	//...
 
-	//Output correct data
-	//...
+std::vector< std::vector<GLfloat*> >
+WCTrimmedNurbsSurface::GenerateTessellation(const std::vector<WCTrimmedNurbsSurface*> &surfaces, const WPFloat &chordTolerance,
+	std::vector<WPUInt> &numTriangles) {
+	std::vector< std::vector<GLfloat*> > buffers(surfaces.size());
+	numTriangles.assign(surfaces.size(), 0);
+	_TrimTessellationBatchJob job = { &surfaces, &buffers, &numTriangles, chordTolerance };
+	//One face per task - inversion and triangulation never touch GL
+	WCThreadPool::Shared()->ParallelFor((WPUInt)surfaces.size(), _TrimTessellationBatchTask, &job);
+	return buffers;
 }
 
 
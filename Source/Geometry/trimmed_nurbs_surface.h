@@ -39,6 +39,8 @@
 //Size Constants
 #define TRIMSURFACE_MAX_TEX_SIZE				512
 #define TRIMSURFACE_PI_TEX_SIZE					32
+#define TRIMSURFACE_HASH_SAMPLES				16
+#define TRIMSURFACE_MASS_SAMPLES				32
 //Shader Location Constants
 #define TRIMSURFACE_LOC_PI_PARAMS				0
 #define TRIMSURFACE_LOC_PI_SURFDATA				1
@@ -69,10 +71,6 @@ protected:
 	GLuint										_texWidth, _texHeight;								//!< Trim texture width and height
 
 private:
-	//Private Methods
-	GLuint PointInversionHigh(std::list<WCVector4> &boundaryList);									//!< Invert list of points - GPU-based method
-	GLuint PointInversionLow(std::list<WCVector4> &boundaryList);									//!< Invert list of points - CPU-based method
-	GLuint GenerateTriangulation(std::list<GLuint> &triList);										//!< Generate vertex list
 	//Hidden Constructors
 	WCTrimmedNurbsSurface();																		//!< Deny access to default constructor
 public:
@@ -97,14 +95,23 @@ public:
 								 const WPFloat &v, const WPUInt &vDer);
 	virtual WCRay Tangent(const WPFloat &u, const WPFloat &v);										//!< Get a tangential ray from the surface at u,v
 	virtual std::pair<WCVector4,WCVector4> PointInversion(const WCVector4 &point);					//!< Project from point to closest location on surface
+	virtual WPHash ContentHash(void);																//!< Hash of the surface and all trim curves
 	virtual WCVisualObject* HitTest(const WCRay &ray, const WPFloat &tolerance);					//!< Hit test with a ray	
 	virtual void Render(const GLuint &defaultProg, const WCColor &color, const WPFloat &zoom);		//!< Render the object
 	virtual void ReceiveNotice(WCObjectMsg msg, WCObject *sender);									//!< Receive messages from other objects
+	virtual WSMassProperties MassProperties(const WPFloat &tolerance=NURBSSURFACE_AREA_ACCURACY);	//!< Mass properties of the trimmed region
 
 	//Original Member Functions
 	void GenerateTrimTexture(GLuint &texWidth, GLuint &texHeight, GLuint &texture, const bool &managed);//!< Generate trim texture
 	void ReleaseTrimTexture(GLuint &texture);														//!< Release the trim texture
-	void GenerateTessellation(WPUInt &lodU, WPUInt &lodV, std::vector<GLfloat*> &buffers);			//!< Generate tessellation of surface
+	std::vector<GLfloat*> GenerateTessellation(const WPFloat &chordTolerance,						//!< Trimmed mesh (vert, norm, tex, index) - put in RAM
+												WPUInt &numVerts, WPUInt &numTriangles);
+	static std::vector< std::vector<GLfloat*> > GenerateTessellation(								//!< Trimmed meshes for many surfaces in parallel
+												const std::vector<WCTrimmedNurbsSurface*> &surfaces, const WPFloat &chordTolerance,
+												std::vector<WPUInt> &numTriangles);
+	void TrimLoops(const WPFloat &tolerance, std::vector< std::vector<WPFloat> > &loops);			//!< Invert the profiles into closed u,v loops
+	bool GenerateTrimMask(const WPUInt &width, const WPUInt &height, const WPFloat &tolerance,		//!< Even-odd trim mask, row-major from v=0 (255 = kept)
+					std::vector<GLubyte> &mask);
 
 	//Operator Overloads
 	WCTrimmedNurbsSurface& operator=(const WCTrimmedNurbsSurface &surface);							//!< Equals operator
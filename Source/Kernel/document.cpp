@@ -63,28 +63,31 @@ void WCDocument::Initialize(void) {
 		//Set document root to self
 		this->_document = this;
 
-		//Create all of the layers for the document
-		this->_uiLayer = new WCUserInterfaceLayer(this->_scene);
-		this->_backgroundLayer = new WCBackgroundLayer(this->_scene);
+		//Setup undo-redo dictionary
+		this->_undoDictionary = new WCSerialDictionary();
 
-		//Register the layers
-		this->_scene->RegisterLayer(this->_backgroundLayer);
-		this->_scene->RegisterLayer(this->_uiLayer);
+		//Headless scenes have no GL context - skip the UI, background, tree view and toolbars
+		if (!this->_scene->IsHeadless()) {
+			//Create all of the layers for the document
+			this->_uiLayer = new WCUserInterfaceLayer(this->_scene);
+			this->_backgroundLayer = new WCBackgroundLayer(this->_scene);
 
-		//Create Feature TreeView
-		this->_treeView = new WCTreeView(this->_uiLayer);
+			//Register the layers
+			this->_scene->RegisterLayer(this->_backgroundLayer);
+			this->_scene->RegisterLayer(this->_uiLayer);
 
-		//Setup undo-redo dictionary
-		this->_undoDictionary = new WCSerialDictionary();
+			//Create Feature TreeView
+			this->_treeView = new WCTreeView(this->_uiLayer);
 
 #ifdef __WXWINDOWS__
-		//Get reference to toolbar manager
-		this->_toolbarManager = wxGetApp().Frame()->ToolbarManager();
+			//Get reference to toolbar manager
+			this->_toolbarManager = wxGetApp().Frame()->ToolbarManager();
 #else
-		//Create toolbar manager
-		std::string resourcesDirectory = _ResourceDirectory();
-		this->_toolbarManager = new WCToolbarManager(this, WCDocument::ToolbarManifest, resourcesDirectory, false);
+			//Create toolbar manager
+			std::string resourcesDirectory = _ResourceDirectory();
+			this->_toolbarManager = new WCToolbarManager(this, WCDocument::ToolbarManifest, resourcesDirectory, false);
 #endif
+		}
 
 		//Set the default units
 		this->_lengthUnit = WCUnitType::TypeFromName("Millimeter");
@@ -32,6 +32,7 @@
 #include <PartDesign/part.h>
 #include <PartDesign/part_feature.h>
 #include <RTVisualization/visualization.h>
+#include <Utility/tessellation_store.h>
 #include <boost/filesystem.hpp>
 
 
@@ -103,8 +104,8 @@ bool WCWildcatKernel::Initialize(const bool &logToFile, const WCLoggerLevel &log
 		WCDocumentTypeManager::RegisterType("Part",				"Wildcat Part Document",			".wildPart",	"wildpart.dtd",		new WCPartDocumentFactory());
 		WCDocumentTypeManager::RegisterType("Visualization",	"Wildcat Visualization Document",	".wildVis",		"wildvis.dtd",		new WCVisDocumentFactory());
 
-		//Create primary OpenGL context
-		WCWildcatKernel::CreateContext();
+		//Create primary OpenGL context - headless kernels have none, so documents get software geometry contexts
+		if (!WCWildcatKernel::_headless) WCWildcatKernel::CreateContext();
 	}
 	//Only catch Wildcat exceptions here
 	catch(WCException ex) {
@@ -132,6 +133,8 @@ bool WCWildcatKernel::Terminate(void) {
 	CLOGGER_WARN(WCLogManager::RootLogger(), "WCWildcatKernel::Shutting Down.");
 	//Terminate the managers
 	try {
+		//Close the tessellation store
+		WCTessellationStore::Activate(NULL);
 		//Destroy the context
 		WCWildcatKernel::DestroyContext();
 		//Terminate dialog manager
@@ -181,6 +184,8 @@ WCDocument* WCWildcatKernel::OpenDocument(const std::string &fullpath) {
 	//Get the appropraite factory
 	WCDocumentFactory *factory = WCDocumentTypeManager::FactoryFromType(extension);
 	WCDocument* document;
+	//Tessellations from the last session live next to the document
+	WCTessellationStore::Activate(new WCTessellationStore(fullpath + TESSELLATIONSTORE_EXTENSION));
 
 	//Create xml parser
 	xercesc::XercesDOMParser* parser = new xercesc::XercesDOMParser();
@@ -75,8 +75,8 @@ void WCPointLayer::GenerateBuffers(void) {
 	if (glGetError() != GL_NO_ERROR) 
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCPointLayer::GenerateBuffers - At Cleanup and Exit.");
 	//Delete arrays
-	delete vData;
-	delete cData;
+	delete [] vData;
+	delete [] cData;
 }
 
 
@@ -85,6 +85,8 @@ void WCPointLayer::GenerateBuffers(void) {
 
 WCPointLayer::WCPointLayer(WCScene *scene, std::string name) : ::WCLayer(scene, name), _renderProg(0),
 	_numVisible(0), _vertexBuffer(0), _colorBuffer(0) {
+	//Headless scenes never render - no buffers needed
+	if (this->_scene->IsHeadless()) return;
 	//Generate the two buffers
 	glGenBuffers(1, &this->_vertexBuffer);
 	glGenBuffers(1, &this->_colorBuffer);
@@ -93,8 +95,8 @@ WCPointLayer::WCPointLayer(WCScene *scene, std::string name) : ::WCLayer(scene,
 
 WCPointLayer::~WCPointLayer() {
 	//Delete the two buffers
-	glDeleteBuffers(1, &this->_vertexBuffer);
-	glDeleteBuffers(1, &this->_colorBuffer);
+	if (this->_vertexBuffer != 0) glDeleteBuffers(1, &this->_vertexBuffer);
+	if (this->_colorBuffer != 0) glDeleteBuffers(1, &this->_colorBuffer);
 }
 
 
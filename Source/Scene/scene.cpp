@@ -54,25 +54,27 @@ WCScene::WCScene(WCGLContext *copyContext) : :: WCSerializeableObject(),
 	_firstResponder(NULL), _cameraLayer(NULL), _topLayer(NULL), _bottomLayer(NULL),
 	_frameTickObject(NULL) {
 	std::string resourcesDirectory = _ResourceDirectory();
-	//Make sure there is a context to copy
-	ASSERT(copyContext);
-	//Create a new gl Context (copying from a root context)
-	this->_glContext = new WCGLContext(*copyContext);
-
-	//Check to see if GL1.5 is present
-	if(WCAdapter::HasGL15()) {
-		//Start new shader manager
-		this->_shaderManager = new WCShaderManager(WCScene::ShaderManifest, resourcesDirectory, false);
-	}
-	//Start new texture manager
-	this->_textureManager = new WCTextureManager(WCScene::TextureManifest, resourcesDirectory, false);
+	//A NULL copy context makes a headless scene - no GL objects and a software geometry context
+	if (copyContext != NULL) {
+		//Create a new gl Context (copying from a root context)
+		this->_glContext = new WCGLContext(*copyContext);
+
+		//Check to see if GL1.5 is present
+		if(WCAdapter::HasGL15()) {
+			//Start new shader manager
+			this->_shaderManager = new WCShaderManager(WCScene::ShaderManifest, resourcesDirectory, false);
+		}
+		//Start new texture manager
+		this->_textureManager = new WCTextureManager(WCScene::TextureManifest, resourcesDirectory, false);
 	
 #ifdef __WIN32__
-	this->_fontManager = new WCFontManager("", "", false);
+		this->_fontManager = new WCFontManager("", "", false);
 #endif
 
-	//Create new geometry context
-	this->_geomContext = new WCGeometryContext(this->_glContext, this->_shaderManager);
+		//Create new geometry context
+		this->_geomContext = new WCGeometryContext(this->_glContext, this->_shaderManager);
+	}
+	else this->_geomContext = new WCGeometryContext();
 
 	//Initialize the mouse button array
 	for (int i=0; i < SCENE_MAX_MOUSEBUTTONS; i++) this->_mouseButtons[i] = false;
@@ -82,6 +84,8 @@ WCScene::WCScene(WCGLContext *copyContext) : :: WCSerializeableObject(),
 	//Add in camera and selection layers
 	this->_cameraLayer = new WCCameraLayer(this);
 	this->RegisterLayer(this->_cameraLayer);
+	//Headless scenes have no GL state to set up
+	if (this->_glContext == NULL) return;
 	//Check for errors
 	if (glGetError() != GL_NO_ERROR) CLOGGER_ERROR(WCLogManager::RootLogger(), "WCScene::WCScene Error - Unspecified Errors.");
 
@@ -110,22 +114,24 @@ WCScene::WCScene(xercesc::DOMElement* element, WCSerialDictionary *dictionary, W
 	WCGUID guid = WCSerializeableObject::GetStringAttrib(element, "guid");
 	dictionary->InsertGUID(guid, this);
 
-	//Make sure there is a context to copy
-	ASSERT(copyContext);
-	//Create a new gl Context (copying from a root context)
-	this->_glContext = new WCGLContext(*copyContext);
+	//A NULL copy context makes a headless scene - no GL objects and a software geometry context
+	if (copyContext != NULL) {
+		//Create a new gl Context (copying from a root context)
+		this->_glContext = new WCGLContext(*copyContext);
 
-	//Start new shader manager
-	this->_shaderManager = new WCShaderManager(WCScene::ShaderManifest, resourcesDirectory, false);
-	//Start new texture manager
-	this->_textureManager = new WCTextureManager(WCScene::TextureManifest, resourcesDirectory, false);
+		//Start new shader manager
+		this->_shaderManager = new WCShaderManager(WCScene::ShaderManifest, resourcesDirectory, false);
+		//Start new texture manager
+		this->_textureManager = new WCTextureManager(WCScene::TextureManifest, resourcesDirectory, false);
 
 #ifdef __WIN32__
-	this->_fontManager = new WCFontManager("", "", false);
+		this->_fontManager = new WCFontManager("", "", false);
 #endif
 
-	//Create new geometry context
-	this->_geomContext = new WCGeometryContext(this->_glContext, this->_shaderManager);
+		//Create new geometry context
+		this->_geomContext = new WCGeometryContext(this->_glContext, this->_shaderManager);
+	}
+	else this->_geomContext = new WCGeometryContext();
 	//Register context guid
 	WCGUID contextGuid = WCSerializeableObject::GetStringAttrib(element, "contextGUID");
 	dictionary->InsertGUID(contextGuid, this->_geomContext);
@@ -140,6 +146,8 @@ WCScene::WCScene(xercesc::DOMElement* element, WCSerialDictionary *dictionary, W
 	//Add in camera and selection layers
 	this->_cameraLayer = new WCCameraLayer(this);
 	this->RegisterLayer(this->_cameraLayer);
+	//Headless scenes have no GL state to set up
+	if (this->_glContext == NULL) return;
 	//Check for errors
 	if (glGetError() != GL_NO_ERROR) CLOGGER_ERROR(WCLogManager::RootLogger(), "WCScene::WCScene Error - Unspecified Errors.");
 
@@ -479,6 +487,8 @@ WCAlignedBoundingBox WCScene::BoundingBox(void) {
 
 
 void WCScene::Render(void) {
+	//Headless scenes do not render
+	if (this->_glContext == NULL) return;
 	//Make sure the context is active
 	this->_glContext->MakeActive();
 	//Mark the scene as clean
@@ -587,3 +597,10 @@ GLuint WCScene::ProgramFromName(const std::string &name) {
 	if(this->_shaderManager == NULL)return 0;
 	return this->_shaderManager->ProgramFromName(name);
 }
+
+
+WSTexture* WCScene::TextureFromName(const std::string &name) {
+	// Get a texture from a name
+	if(this->_textureManager == NULL)return NULL;
+	return this->_textureManager->TextureFromName(name);
+}
@@ -157,6 +157,7 @@ public:
 	inline WCTextureManager* TextureManager(void) const	{ return this->_textureManager; }			//!< Get the scene's texture manager
 	inline WCFontManager* FontManager(void) const		{ return this->_fontManager; }				//!< Get the scene's font manager
 	inline WCGeometryContext* GeometryContext(void) const{ return this->_geomContext; }				//!< Get the scene's geometry context
+	inline bool IsHeadless(void) const					{ return this->_glContext == NULL; }		//!< Is the scene without an OpenGL context
 
 	//LightSource Methods
 	void RegisterLightSource(WCLightSource* light);													//!< Add a light source to the scene
@@ -175,8 +176,9 @@ public:
 	/*** Non-Member Functions ***/
 	friend std::ostream& operator<<(std::ostream& out, const WCScene &scene);						//!< Overloaded output operator
 	
-	//Shader Access Methods
+	//Shader and Texture Access Methods
 	GLuint ProgramFromName(const std::string &name);												//!< Get a program from a name
+	WSTexture* TextureFromName(const std::string &name);											//!< Get a texture from a name
 };
 
 
@@ -50,12 +50,8 @@
 WCTreeElement::WCTreeElement(WCTreeView *tree, std::string name, WCEventController *controller, WSTexture *icon) :
 	::WCObject(), _tree(tree), _name(name), _label(NULL), _controller(controller), _isSelected(false),
 	_isMouseOver(false), _isOpen(true), _icon(icon) {
-	//Make sure tree is not null
-	if (this->_tree == NULL) { 
-		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTreeElement::WCTreeElement - NULL TreeView passed."); 
-		//throw error
-		return; 
-	}
+	//No tree (headless document) - element only tracks hierarchy and selection
+	if (this->_tree == NULL) return;
 	//Create label for element
 	this->_label = new WCText(this->_tree->Layer()->Scene(), this->_name, WCColor(TREEVIEW_TEXT_COLOR),
 							  WCTextFont::Times(), WCTextStyle::Roman(), 16.0);
@@ -81,7 +77,7 @@ void WCTreeElement::IsSelected(const bool state) {
 	//Check to see if dirty
 	if (state != this->_isSelected) {
 		//Mark the tree as dirty
-		this->_tree->MarkDirty();
+		if (this->_tree != NULL) this->_tree->MarkDirty();
 		//Set the state
 		this->_isSelected = state;
 	}
@@ -33,6 +33,26 @@
 #include <Geometry/geometric_types.h>
 #include <Geometry/geometric_line.h>
 #include <Geometry/nurbs_curve.h>
+#include <Geometry/nurbs_surface.h>
+#include <Utility/thread_pool.h>
+
+
+/***********************************************~***************************************************/
+
+
+//Shared state for mass properties - one slot per face
+struct _TopologyMassJob {
+	std::vector<WSFaceUse*>						faces;
+	std::vector<WSMassProperties>				results;
+	WPFloat										tolerance;
+};
+
+
+static void _TopologyMassTask(void *data, const WPUInt &index) {
+	_TopologyMassJob *job = (_TopologyMassJob*)data;
+	WCNurbsSurface *surface = dynamic_cast<WCNurbsSurface*>(job->faces.at(index)->surface);
+	if (surface != NULL) job->results.at(index) = surface->MassProperties(job->tolerance);
+}
 
 
 /***********************************************~***************************************************/
@@ -225,6 +245,38 @@ void WCTopologyModel::AddShell(WSTopologyShell* shell) {
 }
 
 
+WSMassProperties WCTopologyModel::MassProperties(const WPFloat &tolerance, std::vector<WSMassProperties> *faceProperties) {
+	WPFloat start = WCThreadPool::Seconds();
+	_TopologyMassJob job;
+	job.tolerance = tolerance;
+	//Gather the faces of every shell
+	std::list<WSTopologyShell*>::iterator shellIter;
+	WSFaceUse *firstFU, *fu;
+	for (shellIter = this->_shellList.begin(); shellIter != this->_shellList.end(); shellIter++) {
+		firstFU = NULL;
+		fu = (*shellIter)->faceUses;
+		while ((fu != NULL) && (fu != firstFU)) {
+			job.faces.push_back(fu);
+			if (!firstFU) firstFU = fu;
+			fu = fu->next;
+		}
+	}
+	//Integrate the faces in parallel, then sum them in order
+	job.results.resize(job.faces.size());
+	WCThreadPool::Shared()->ParallelFor((WPUInt)job.faces.size(), _TopologyMassTask, &job);
+	WSMassProperties props;
+	for (WPUInt i=0; i<job.faces.size(); i++) {
+		if (dynamic_cast<WCNurbsSurface*>(job.faces.at(i)->surface) == NULL)
+			CLOGGER_WARN(WCLogManager::RootLogger(), "WCTopologyModel::MassProperties - Skipping face without a NURBS surface.");
+		props.Add(job.results.at(i), job.faces.at(i)->orientation);
+	}
+	props.Finish();
+	if (faceProperties != NULL) faceProperties->swap(job.results);
+	props.seconds = WCThreadPool::Seconds() - start;
+	return props;
+}
+
+
 xercesc::DOMElement* WCTopologyModel::Serialize(xercesc::DOMDocument *document, WCSerialDictionary *dictionary) {
 	//Insert self into dictionary
 	WCGUID guid = dictionary->InsertAddress(this);
@@ -44,6 +44,7 @@ namespace __WILDCAT_NAMESPACE__ {
 
 /*** Class Predefines ***/
 struct WSTopologyShell;
+struct WSMassProperties;
 
 
 /***********************************************~***************************************************/
@@ -64,6 +65,10 @@ public:
 	//General Access Methods
 	void AddShell(WSTopologyShell* shell);															//!< Add a shell to the model
 	inline std::list<WSTopologyShell*> ShellList(void) { return this->_shellList; }					//!< Get the list of shells
+
+	//Analysis Methods
+	WSMassProperties MassProperties(const WPFloat &tolerance,										//!< Mass properties of the shells (faces in parallel)
+												std::vector<WSMassProperties> *faceProperties=NULL);
 	
 	//Boolean Methods
 	WCTopologyModel* Slice(const WCMatrix4 &plane, const bool &retainBottom);						//!< Slice the model using the plane
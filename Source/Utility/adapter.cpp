@@ -405,6 +405,16 @@ char* adapterExtensions[ADAPTER_EXTENSION_COUNT] = {
 
 	//Set OpenGL version
 	char* version = (char*)glGetString(GL_VERSION);
+	//No current context (headless) - report no version, extensions or limits
+	if (version == NULL) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCAdapter::Initialize - No current GL context.");
+		WCAdapter::_extensions = new bool[ADAPTER_EXTENSION_COUNT];
+		for (int i=0; i<ADAPTER_EXTENSION_COUNT; i++) WCAdapter::_extensions[i] = false;
+		WCAdapter::_maxGeometryOutputVertices = 0;
+		WCAdapter::_max2DTextureSize = 0;
+		WCAdapter::_isInitialized = true;
+		return;
+	}
 	//Get version
 	switch (version[0]) {
 		//Must be versions 1.3, 1.4, or 1.5
@@ -422,7 +432,7 @@ char* adapterExtensions[ADAPTER_EXTENSION_COUNT] = {
 	//Allocate space for the extension array
 	WCAdapter::_extensions = new bool[ADAPTER_EXTENSION_COUNT];
 	for (int i=0; i<ADAPTER_EXTENSION_COUNT; i++) {
-		WCAdapter::_extensions[i] = (strstr(extensions, adapterExtensions[i]) != NULL);
+		WCAdapter::_extensions[i] = (extensions != NULL) && (strstr(extensions, adapterExtensions[i]) != NULL);
 	}
 		
 	/*** Get Limits ***/
@@ -231,16 +231,44 @@ WCMatrix4 WCMatrix4::operator*(const WPFloat &scalar) {
 
 
 WCVector4 WCMatrix4::operator*(const WCVector4 &v) const {
+//Two-wide SIMD optimization (SSE2 or NEON) - dot each row with v
+#ifdef __GOT_SIMD__
+	WCVector4 retVec;
+	for (int r=0; r<4; r++)
+		retVec._data.d[r] = WCSimd::Sum(WCSimd::Load(this->_data + r*4) * v._data.v[0] + WCSimd::Load(this->_data + r*4 + 2) * v._data.v[1]);
+	return retVec;
+//Default path
+#else
 	WCVector4 retVec(
 		(this->_data[0] *v._data.d[0]) + (this->_data[1] * v._data.d[1]) + (this->_data[2] * v._data.d[2]) + (this->_data[3] * v._data.d[3]),
 		(this->_data[4] *v._data.d[0]) + (this->_data[5] * v._data.d[1]) + (this->_data[6] * v._data.d[2]) + (this->_data[7] * v._data.d[3]),
 		(this->_data[8] *v._data.d[0]) + (this->_data[9] * v._data.d[1]) + (this->_data[10]* v._data.d[2]) + (this->_data[11]* v._data.d[3]),
 		(this->_data[12]*v._data.d[0]) + (this->_data[13]* v._data.d[1]) + (this->_data[14]* v._data.d[2]) + (this->_data[15]* v._data.d[3]));
 	return retVec;
+#endif
 }
 
 
 WCMatrix4 WCMatrix4::operator*(const WCMatrix4 &m) {
+//Two-wide SIMD optimization (SSE2 or NEON) - each result row is a sum of scaled rows of m
+#ifdef __GOT_SIMD__
+	WCMatrix4 retMat;
+	vDouble lo, hi, s;
+	for (int r=0; r<4; r++) {
+		s = WCSimd::Splat(this->_data[r*4]);
+		lo = s * WCSimd::Load(m._data);
+		hi = s * WCSimd::Load(m._data + 2);
+		for (int k=1; k<4; k++) {
+			s = WCSimd::Splat(this->_data[r*4 + k]);
+			lo += s * WCSimd::Load(m._data + k*4);
+			hi += s * WCSimd::Load(m._data + k*4 + 2);
+		}
+		WCSimd::Store(retMat._data + r*4, lo);
+		WCSimd::Store(retMat._data + r*4 + 2, hi);
+	}
+	return retMat;
+//Default path
+#else
 	WCMatrix4 retMat(
 		(this->_data[0] * m._data[0]) + (this->_data[1] * m._data[4]) + (this->_data[2] * m._data[8])  + (this->_data[3] * m._data[12]),
 		(this->_data[0] * m._data[1]) + (this->_data[1] * m._data[5]) + (this->_data[2] * m._data[9])  + (this->_data[3] * m._data[13]),
@@ -259,6 +287,7 @@ WCMatrix4 WCMatrix4::operator*(const WCMatrix4 &m) {
 		(this->_data[12]* m._data[2]) + (this->_data[13]* m._data[6]) + (this->_data[14]* m._data[10]) + (this->_data[15]* m._data[14]),
 		(this->_data[12]* m._data[3]) + (this->_data[13]* m._data[7]) + (this->_data[14]* m._data[11]) + (this->_data[15]* m._data[15]));
 	return retMat;
+#endif
 }
 
 
@@ -283,6 +312,89 @@ bool WCMatrix4::operator==(const WCMatrix4 &m) {
 	return false;
 }
 
+
+#ifdef __GOT_AVX2_DISPATCH__
+__attribute__((target("avx2,fma")))
+static void _TransformManyAVX2(const WPFloat *m, const WPFloat *in, WPFloat *out, const WPUInt &count) {
+	//Load the matrix columns once
+	__m256d c0 = _mm256_set_pd(m[12], m[8], m[4], m[0]);
+	__m256d c1 = _mm256_set_pd(m[13], m[9], m[5], m[1]);
+	__m256d c2 = _mm256_set_pd(m[14], m[10], m[6], m[2]);
+	__m256d c3 = _mm256_set_pd(m[15], m[11], m[7], m[3]);
+	__m256d r;
+	//Each result is a sum of columns scaled by the point
+	for (WPUInt i=0; i<count; i++) {
+		r = _mm256_mul_pd(c0, _mm256_broadcast_sd(in));
+		r = _mm256_fmadd_pd(c1, _mm256_broadcast_sd(in+1), r);
+		r = _mm256_fmadd_pd(c2, _mm256_broadcast_sd(in+2), r);
+		r = _mm256_fmadd_pd(c3, _mm256_broadcast_sd(in+3), r);
+		_mm256_storeu_pd(out, r);
+		in += 4;
+		out += 4;
+	}
+}
+#endif //__GOT_AVX2_DISPATCH__
+
+
+void WCMatrix4::TransformMany(const WPFloat *in, WPFloat *out, const WPUInt &count) const {
+	//Check for trivial case
+	if ((in == NULL) || (out == NULL)) return;
+#ifdef __GOT_AVX2_DISPATCH__
+	//Use the four-wide path if the cpu has it
+	if (WCSimd::HasAVX2()) {
+		_TransformManyAVX2(this->_data, in, out, count);
+		return;
+	}
+#endif
+	const WPFloat *m = this->_data;
+//Two-wide SIMD optimization (SSE2 or NEON) - columns split into upper and lower halves
+#ifdef __GOT_SIMD__
+	vDouble cLo[4], cHi[4], lo, hi, s;
+	WPFloat col[4];
+	for (int c=0; c<4; c++) {
+		col[0] = m[c];
+		col[1] = m[4+c];
+		col[2] = m[8+c];
+		col[3] = m[12+c];
+		cLo[c] = WCSimd::Load(col);
+		cHi[c] = WCSimd::Load(col + 2);
+	}
+	for (WPUInt i=0; i<count; i++) {
+		s = WCSimd::Splat(in[0]);
+		lo = cLo[0] * s;
+		hi = cHi[0] * s;
+		for (int c=1; c<4; c++) {
+			s = WCSimd::Splat(in[c]);
+			lo += cLo[c] * s;
+			hi += cHi[c] * s;
+		}
+		WCSimd::Store(out, lo);
+		WCSimd::Store(out + 2, hi);
+		in += 4;
+		out += 4;
+	}
+//Default path
+#else
+	WPFloat x, y, z, w;
+	for (WPUInt i=0; i<count; i++) {
+		x = in[0]; y = in[1]; z = in[2]; w = in[3];
+		out[0] = m[0]*x  + m[1]*y  + m[2]*z  + m[3]*w;
+		out[1] = m[4]*x  + m[5]*y  + m[6]*z  + m[7]*w;
+		out[2] = m[8]*x  + m[9]*y  + m[10]*z + m[11]*w;
+		out[3] = m[12]*x + m[13]*y + m[14]*z + m[15]*w;
+		in += 4;
+		out += 4;
+	}
+#endif
+}
+
+
+void WCMatrix4::TransformMany(std::vector<WCVector4> &points) const {
+	//Transform in place (WCVector4 is exactly four packed doubles)
+	if (points.empty()) return;
+	this->TransformMany(points.front()._data.d, points.front()._data.d, (WPUInt)points.size());
+}
+
 	
 WPFloat WCMatrix4::NormL2(void) {
 	WPFloat retVal = 1.0;
@@ -462,13 +574,9 @@ WCMatrix::~WCMatrix() {
 void WCMatrix::SetIdentity(void) {
 	//Set the entire matrix to zeros
 	memset(this->_data, 0, this->_numRow * this->_numCol * sizeof(WPFloat));
-	//Find the shorter dimension and work backwards towards 0,0
-#ifdef __APPLE__
-	for (WPUInt i = (WPUInt)STDMIN(this->_numRow, this->_numCol)-1; i >= 0; i--) {
-#endif
-#ifdef __WIN32__
-	for (WPUInt i = (WPUInt)STDMIN(this->_numRow, this->_numCol)-1; i >= 0; i--) {
-#endif
+	//Walk the diagonal of the shorter dimension
+	WPUInt size = (WPUInt)STDMIN(this->_numRow, this->_numCol);
+	for (WPUInt i=0; i<size; i++) {
 		//Set the element to 1.0
 		this->Set(i, i, 1.0);
 	}
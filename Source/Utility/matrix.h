@@ -43,7 +43,7 @@ namespace __WILDCAT_NAMESPACE__ {
 
 
 /*** Class Predefines ***/
-//None
+template <WPUInt R, WPUInt C> class WCMatrixN;
 
 
 /***********************************************~***************************************************/
@@ -101,6 +101,8 @@ public:
 	WPFloat Determinant(void);																		//!< Determinant
 	WCMatrix4 Inverse(void);																		//!< Inverse
 	WCMatrix4 Transpose(void);																		//!< Transpose
+	void TransformMany(const WPFloat *in, WPFloat *out, const WPUInt &count) const;					//!< Transform count 4-vectors (4 doubles each, in may equal out)
+	void TransformMany(std::vector<WCVector4> &points) const;										//!< Transform a vector of points in place
 	
 	//Friend Functions
 	friend std::ostream& operator<<(std::ostream& out, const WCMatrix4 &matrix);					//!< Overloaded output operator	
@@ -167,6 +169,146 @@ public:
 };
 
 
+/***********************************************~***************************************************/
+	//Fixed-size vector and matrix - storage is inline and the loop bounds are compile-time
+	//constants, so small products need no heap allocation and unroll fully.  Row-major like WCMatrix.
+/***********************************************~***************************************************/
+
+
+template <WPUInt N>
+class WCVectorN {
+private:
+	WPFloat										_data[N];											//!< Inline data
+public:
+	enum { Dimension = N };																			//!< Compile-time size
+	//Constructors and Destructors
+	WCVectorN()									{ for (WPUInt i=0; i<N; i++) this->_data[i] = 0.0; }	//!< Zero constructor
+	explicit WCVectorN(const WPFloat &value)	{ for (WPUInt i=0; i<N; i++) this->_data[i] = value; }	//!< Fill constructor
+	explicit WCVectorN(const WPFloat *data)		{ for (WPUInt i=0; i<N; i++) this->_data[i] = data[i]; }//!< Array constructor
+	
+	//General Access Methods
+	inline WPUInt Size(void) const				{ return N; }										//!< Get the vector size
+	inline void Set(const WPUInt &index, const WPFloat &value)	{ this->_data[index] = value; }		//!< Standard Set operation
+	inline WPFloat Get(const WPUInt &index) const				{ return this->_data[index]; }		//!< Standard Get operation
+	inline WPFloat* GetData(void)				{ return this->_data; }								//!< Return the data array
+	inline const WPFloat* GetData(void) const	{ return this->_data; }								//!< Return the const data array
+	
+	//Operators
+	inline WCVectorN operator+(const WCVectorN &v) const {											//!< Vector addition
+												WCVectorN r; for (WPUInt i=0; i<N; i++) r._data[i] = this->_data[i] + v._data[i]; return r; }
+	inline WCVectorN operator-(const WCVectorN &v) const {											//!< Vector subtraction
+												WCVectorN r; for (WPUInt i=0; i<N; i++) r._data[i] = this->_data[i] - v._data[i]; return r; }
+	inline WCVectorN operator*(const WPFloat &scalar) const {										//!< Scalar multiplication
+												WCVectorN r; for (WPUInt i=0; i<N; i++) r._data[i] = this->_data[i] * scalar; return r; }
+	template <WPUInt C>
+	inline WCVectorN<C> operator*(const WCMatrixN<N,C> &m) const {									//!< Row vector times matrix
+												WCVectorN<C> r; const WPFloat *d = m.GetData();
+												for (WPUInt j=0; j<C; j++) { WPFloat sum = 0.0;
+													for (WPUInt i=0; i<N; i++) sum += this->_data[i] * d[i*C+j];
+													r.Set(j, sum); }
+												return r; }
+
+	//Other Methods
+	inline WPFloat DotProduct(const WCVectorN &v) const {											//!< Return the dot product
+												WPFloat sum = 0.0; for (WPUInt i=0; i<N; i++) sum += this->_data[i] * v._data[i]; return sum; }
+	inline WPFloat NormL2(void) const			{ return sqrt(this->DotProduct(*this)); }			//!< L2 Norm
+};
+
+
+template <WPUInt R, WPUInt C>
+class WCMatrixN {
+private:
+	WPFloat										_data[R*C];											//!< Inline row-major data
+public:
+	enum { Rows = R, Columns = C };																	//!< Compile-time sizes
+	//Constructors and Destructors
+	WCMatrixN(const bool &identity=false) {															//!< Zero (or identity) constructor
+												for (WPUInt i=0; i<R*C; i++) this->_data[i] = 0.0;
+												if (identity) for (WPUInt i=0; (i<R) && (i<C); i++) this->_data[i*C+i] = 1.0; }
+	explicit WCMatrixN(const WPFloat *data)		{ for (WPUInt i=0; i<R*C; i++) this->_data[i] = data[i]; }	//!< Array constructor
+	
+	//General Access Methods
+	inline WPUInt GetNumRow(void) const			{ return R; }										//!< Get the number of rows
+	inline WPUInt GetNumCol(void) const 		{ return C; }										//!< Get the number of columns
+	inline void Set(const WPUInt &row, const WPUInt &col, const WPFloat &value) {					//!< Standard Set operation
+												this->_data[row*C+col] = value; }
+	inline WPFloat Get(const WPUInt &row, const WPUInt &col) const {								//!< Standard Get operation
+												return this->_data[row*C+col]; }
+	inline WPFloat* GetData(void)				{ return this->_data; }								//!< Return the data array
+	inline const WPFloat* GetData(void) const	{ return this->_data; }								//!< Return the const data array
+	
+	//Operators
+	inline WCMatrixN operator+(const WCMatrixN &m) const {											//!< Matrix addition
+												WCMatrixN r; for (WPUInt i=0; i<R*C; i++) r._data[i] = this->_data[i] + m._data[i]; return r; }
+	inline WCMatrixN operator-(const WCMatrixN &m) const {											//!< Matrix subtraction
+												WCMatrixN r; for (WPUInt i=0; i<R*C; i++) r._data[i] = this->_data[i] - m._data[i]; return r; }
+	inline WCMatrixN operator*(const WPFloat &scalar) const {										//!< Scalar multiplication
+												WCMatrixN r; for (WPUInt i=0; i<R*C; i++) r._data[i] = this->_data[i] * scalar; return r; }
+	inline WCVectorN<R> operator*(const WCVectorN<C> &v) const {									//!< Matrix times column vector
+												WCVectorN<R> r;
+												for (WPUInt i=0; i<R; i++) { WPFloat sum = 0.0;
+													for (WPUInt j=0; j<C; j++) sum += this->_data[i*C+j] * v.Get(j);
+													r.Set(i, sum); }
+												return r; }
+	template <WPUInt K>
+	inline WCMatrixN<R,K> operator*(const WCMatrixN<C,K> &m) const {								//!< Matrix multiplication
+												WCMatrixN<R,K> r; WPFloat *out = r.GetData(); const WPFloat *d = m.GetData();
+												for (WPUInt i=0; i<R; i++)
+													for (WPUInt k=0; k<C; k++) { WPFloat a = this->_data[i*C+k];
+														for (WPUInt j=0; j<K; j++) out[i*K+j] += a * d[k*K+j]; }
+												return r; }
+
+	//Other Functions
+	inline WCMatrixN<C,R> Transpose(void) const {													//!< Transpose
+												WCMatrixN<C,R> r;
+												for (WPUInt i=0; i<R; i++) for (WPUInt j=0; j<C; j++) r.Set(j, i, this->_data[i*C+j]);
+												return r; }
+	bool Solve(const WCVectorN<R> &b, WCVectorN<R> &x, const WPFloat &tolerance=0.0) const;		//!< Solve ax=b (square only), false if a pivot is within tolerance of singular
+};
+
+
+template <WPUInt R, WPUInt C>
+bool WCMatrixN<R,C>::Solve(const WCVectorN<R> &b, WCVectorN<R> &x, const WPFloat &tolerance) const {
+	//Only square systems - a non-square instantiation fails to compile here
+	typedef char _SquareMatrixOnly[(R == C) ? 1 : -1];
+	(void)sizeof(_SquareMatrixOnly);
+	//Gaussian elimination with partial pivoting on copies
+	WPFloat a[R*R], y[R], tmp, factor, limit = 0.0;
+	WPUInt i, j, k, pivot;
+	for (i=0; i<R*R; i++) {
+		a[i] = this->_data[i];
+		limit = STDMAX(limit, fabs(a[i]));
+	}
+	for (i=0; i<R; i++) y[i] = b.Get(i);
+	//Pivots at or below the tolerance (relative to the largest entry) count as singular
+	limit *= tolerance;
+	for (k=0; k<R; k++) {
+		//Find the largest pivot in this column
+		pivot = k;
+		for (i=k+1; i<R; i++) if (fabs(a[i*R+k]) > fabs(a[pivot*R+k])) pivot = i;
+		if (fabs(a[pivot*R+k]) <= limit) return false;
+		//Swap the rows if needed
+		if (pivot != k) {
+			for (j=0; j<R; j++) { tmp = a[k*R+j]; a[k*R+j] = a[pivot*R+j]; a[pivot*R+j] = tmp; }
+			tmp = y[k]; y[k] = y[pivot]; y[pivot] = tmp;
+		}
+		//Eliminate below the pivot
+		for (i=k+1; i<R; i++) {
+			factor = a[i*R+k] / a[k*R+k];
+			for (j=k; j<R; j++) a[i*R+j] -= factor * a[k*R+j];
+			y[i] -= factor * y[k];
+		}
+	}
+	//Back substitute
+	for (i=R; i>0; i--) {
+		tmp = y[i-1];
+		for (j=i; j<R; j++) tmp -= a[(i-1)*R+j] * x.Get(j);
+		x.Set(i-1, tmp / a[(i-1)*R+(i-1)]);
+	}
+	return true;
+}
+
+
 /***********************************************~***************************************************/
 
 
@@ -0,0 +1,327 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <Utility/tessellation_cache.h>
+#include <Utility/log_manager.h>
+
+
+/*** Static Member Initialization ***/
+WCTessellationCache* WCTessellationCache::_shared = NULL;
+WPUInt WCTessellationCache::_sharedBudget = TESSELLATIONCACHE_DEFAULT_BUDGET;
+#ifndef __WILDCAT_NO_THREADS__
+static pthread_mutex_t _sharedMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+/***********************************************~***************************************************/
+
+
+WCTessellationKey::WCTessellationKey(const void *obj, const WPUInt &rev, const WPUInt &type) :
+	object(obj), revision(rev), kind(type) {
+	for (WPUInt i=0; i<TESSELLATIONCACHE_MAX_VALUES; i++) this->values[i] = 0.0;
+}
+
+
+bool WCTessellationKey::operator<(const WCTessellationKey &key) const {
+	//Order by object, then revision, then kind, then values
+	if (this->object != key.object) return this->object < key.object;
+	if (this->revision != key.revision) return this->revision < key.revision;
+	if (this->kind != key.kind) return this->kind < key.kind;
+	for (WPUInt i=0; i<TESSELLATIONCACHE_MAX_VALUES; i++)
+		if (this->values[i] != key.values[i]) return this->values[i] < key.values[i];
+	return false;
+}
+
+
+/***********************************************~***************************************************/
+
+
+void WCTessellationCache::Lock(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&this->_mutex);
+#endif
+}
+
+
+void WCTessellationCache::Unlock(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&this->_mutex);
+#endif
+}
+
+
+void WCTessellationCache::Erase(_EntryIterator entry) {
+	//Drop it from the lookups before freeing - the handle key is the first buffer's address
+	//(stale entries are already out of the key map)
+	if (!entry->data.buffers.empty()) this->_handles.erase(entry->data.buffers.at(0));
+	if (!entry->isStale) this->_lookup.erase(entry->key);
+	//Now free the buffers
+	for (WPUInt i=0; i<entry->data.buffers.size(); i++)
+		if (entry->data.buffers.at(i) != NULL) delete [] entry->data.buffers.at(i);
+	this->_bytes -= entry->bytes;
+	this->_entries.erase(entry);
+}
+
+
+void WCTessellationCache::Trim(void) {
+	//Walk from least recently used, skipping anything still handed out
+	_EntryIterator iter = this->_entries.end();
+	while ((this->_bytes > this->_budget) && (iter != this->_entries.begin())) {
+		--iter;
+		if (iter->refCount != 0) continue;
+		_EntryIterator victim = iter++;
+		this->Erase(victim);
+		this->_evictions++;
+	}
+}
+
+
+/***********************************************~***************************************************/
+
+
+WCTessellationCache::WCTessellationCache(const WPUInt &budget) : _entries(), _lookup(), _handles(),
+	_budget(budget), _bytes(0), _hits(0), _misses(0), _evictions(0) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_init(&this->_mutex, NULL);
+#endif
+}
+
+
+WCTessellationCache::~WCTessellationCache() {
+	//Warn about anything still handed out, then free everything
+	for (_EntryIterator iter=this->_entries.begin(); iter!=this->_entries.end(); iter++) {
+		if (iter->refCount != 0)
+			CLOGGER_WARN(WCLogManager::RootLogger(), "WCTessellationCache::~WCTessellationCache - Freeing a referenced tessellation.");
+		for (WPUInt i=0; i<iter->data.buffers.size(); i++)
+			if (iter->data.buffers.at(i) != NULL) delete [] iter->data.buffers.at(i);
+	}
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_destroy(&this->_mutex);
+#endif
+}
+
+
+WPUInt WCTessellationCache::Budget(void) {
+	this->Lock();
+	WPUInt budget = this->_budget;
+	this->Unlock();
+	return budget;
+}
+
+
+void WCTessellationCache::Budget(const WPUInt &budget) {
+	this->Lock();
+	this->_budget = budget;
+	this->Trim();
+	this->Unlock();
+}
+
+
+WPUInt WCTessellationCache::Bytes(void) {
+	this->Lock();
+	WPUInt bytes = this->_bytes;
+	this->Unlock();
+	return bytes;
+}
+
+
+WPUInt WCTessellationCache::Count(void) {
+	this->Lock();
+	WPUInt count = (WPUInt)this->_entries.size();
+	this->Unlock();
+	return count;
+}
+
+
+WPUInt WCTessellationCache::Hits(void) {
+	this->Lock();
+	WPUInt hits = this->_hits;
+	this->Unlock();
+	return hits;
+}
+
+
+WPUInt WCTessellationCache::Misses(void) {
+	this->Lock();
+	WPUInt misses = this->_misses;
+	this->Unlock();
+	return misses;
+}
+
+
+WPUInt WCTessellationCache::Evictions(void) {
+	this->Lock();
+	WPUInt evictions = this->_evictions;
+	this->Unlock();
+	return evictions;
+}
+
+
+bool WCTessellationCache::Acquire(const WCTessellationKey &key, WCTessellation &data) {
+	this->Lock();
+	std::map<WCTessellationKey,_EntryIterator>::iterator iter = this->_lookup.find(key);
+	if (iter == this->_lookup.end()) {
+		this->_misses++;
+		this->Unlock();
+		return false;
+	}
+	//Reference it and move it to the front
+	_EntryIterator entry = iter->second;
+	entry->refCount++;
+	this->_entries.splice(this->_entries.begin(), this->_entries, entry);
+	data = entry->data;
+	this->_hits++;
+	this->Unlock();
+	return true;
+}
+
+
+void WCTessellationCache::Insert(const WCTessellationKey &key, WCTessellation &data, const WPUInt &bytes) {
+	//Nothing to hold on to
+	if (data.buffers.empty() || (data.buffers.at(0) == NULL)) return;
+	this->Lock();
+	std::map<WCTessellationKey,_EntryIterator>::iterator iter = this->_lookup.find(key);
+	//Another thread got here first - use its copy and drop ours
+	if (iter != this->_lookup.end()) {
+		for (WPUInt i=0; i<data.buffers.size(); i++)
+			if (data.buffers.at(i) != NULL) delete [] data.buffers.at(i);
+		_EntryIterator entry = iter->second;
+		entry->refCount++;
+		this->_entries.splice(this->_entries.begin(), this->_entries, entry);
+		data = entry->data;
+		this->Unlock();
+		return;
+	}
+	//Add the new entry, already handed out to the caller
+	this->_entries.push_front(_Entry(key));
+	_EntryIterator entry = this->_entries.begin();
+	entry->data = data;
+	entry->bytes = bytes;
+	entry->refCount = 1;
+	this->_lookup.insert(std::make_pair(key, entry));
+	this->_handles.insert(std::make_pair(data.buffers.at(0), entry));
+	this->_bytes += bytes;
+	this->Trim();
+	this->Unlock();
+}
+
+
+bool WCTessellationCache::Release(GLfloat *buffer) {
+	this->Lock();
+	std::map<GLfloat*,_EntryIterator>::iterator iter = this->_handles.find(buffer);
+	if (iter == this->_handles.end()) {
+		this->Unlock();
+		return false;
+	}
+	_EntryIterator entry = iter->second;
+	if (entry->refCount > 0) entry->refCount--;
+	//Stale entries go as soon as the last user is done, others wait for the budget
+	if ((entry->refCount == 0) && (entry->isStale)) this->Erase(entry);
+	else this->Trim();
+	this->Unlock();
+	return true;
+}
+
+
+void WCTessellationCache::Invalidate(const void *object) {
+	this->Lock();
+	_EntryIterator iter = this->_entries.begin();
+	while (iter != this->_entries.end()) {
+		_EntryIterator entry = iter++;
+		if (entry->key.object != object) continue;
+		//Free it now, or hide it from lookups until it is released
+		if (entry->refCount == 0) this->Erase(entry);
+		else if (!entry->isStale) {
+			this->_lookup.erase(entry->key);
+			entry->isStale = true;
+		}
+	}
+	this->Unlock();
+}
+
+
+void WCTessellationCache::Clear(void) {
+	this->Lock();
+	_EntryIterator iter = this->_entries.begin();
+	while (iter != this->_entries.end()) {
+		_EntryIterator entry = iter++;
+		if (entry->refCount == 0) this->Erase(entry);
+	}
+	this->Unlock();
+}
+
+
+void WCTessellationCache::ResetStatistics(void) {
+	this->Lock();
+	this->_hits = 0;
+	this->_misses = 0;
+	this->_evictions = 0;
+	this->Unlock();
+}
+
+
+/***********************************************~***************************************************/
+
+
+WCTessellationCache* WCTessellationCache::Shared(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&_sharedMutex);
+#endif
+	//Create the cache on first use
+	if (WCTessellationCache::_shared == NULL)
+		WCTessellationCache::_shared = new WCTessellationCache(WCTessellationCache::_sharedBudget);
+	WCTessellationCache *cache = WCTessellationCache::_shared;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_sharedMutex);
+#endif
+	return cache;
+}
+
+
+void WCTessellationCache::SharedBudget(const WPUInt &budget) {
+	//Record the budget and apply it to a live cache
+	WCTessellationCache::_sharedBudget = (budget == 0) ? TESSELLATIONCACHE_DEFAULT_BUDGET : budget;
+	WCTessellationCache::Shared()->Budget(WCTessellationCache::_sharedBudget);
+}
+
+
+void WCTessellationCache::Terminate(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&_sharedMutex);
+#endif
+	if (WCTessellationCache::_shared != NULL) delete WCTessellationCache::_shared;
+	WCTessellationCache::_shared = NULL;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_sharedMutex);
+#endif
+}
+
+
+/***********************************************~***************************************************/
+
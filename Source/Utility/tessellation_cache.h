@@ -0,0 +1,142 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+#ifndef __WUTIL_TESSELLATION_CACHE_H__
+#define __WUTIL_TESSELLATION_CACHE_H__
+
+
+/*** Included Header Files ***/
+#include <Utility/wutil.h>
+#ifndef __WILDCAT_NO_THREADS__
+#include <pthread.h>
+#endif
+
+
+/*** Locally Defined Values ***/
+#define TESSELLATIONCACHE_DEFAULT_BUDGET		67108864	//Bytes held by the shared cache (64MB)
+#define TESSELLATIONCACHE_MAX_VALUES			6
+
+
+/*** Namespace Declaration ***/
+namespace __WILDCAT_NAMESPACE__ {
+
+
+/*** Class Predefines ***/
+//None
+
+
+/***********************************************~***************************************************/
+
+
+//Identifies one tessellation: which object, which revision of its geometry, and how it was generated
+struct WCTessellationKey {
+	const void									*object;											//!< Owning object
+	WPUInt										revision;											//!< Geometry revision of the owner
+	WPUInt										kind;												//!< Owner defined generation path
+	WPFloat										values[TESSELLATIONCACHE_MAX_VALUES];				//!< Parameter range, LOD, tolerance...
+	//Constructors
+	WCTessellationKey(const void *obj, const WPUInt &rev, const WPUInt &type);						//!< Primary constructor (values zeroed)
+	//Operators
+	bool operator<(const WCTessellationKey &key) const;												//!< Strict ordering for the cache map
+};
+
+
+//The buffers of one tessellation plus whatever counts the owner needs to use them
+struct WCTessellation {
+	std::vector<GLfloat*>						buffers;											//!< Client buffers (freed by the cache)
+	std::vector<WPUInt>							counts;												//!< Resulting LODs, vertex or triangle counts
+	std::vector<WPFloat>						params;												//!< Optional parametric values per vertex
+};
+
+
+/***********************************************~***************************************************/
+
+
+class WCTessellationCache {
+private:
+	//Internal entry - lives in the LRU list, most recently used at the front
+	struct _Entry {
+		WCTessellationKey						key;
+		WCTessellation							data;
+		WPUInt									bytes, refCount;
+		bool									isStale;
+		_Entry(const WCTessellationKey &k) : key(k), data(), bytes(0), refCount(0), isStale(false) { }
+	};
+	typedef std::list<_Entry>::iterator			_EntryIterator;
+	std::list<_Entry>							_entries;											//!< All entries in LRU order
+	std::map<WCTessellationKey,_EntryIterator>	_lookup;											//!< Live entries by key
+	std::map<GLfloat*,_EntryIterator>			_handles;											//!< Entries by first buffer
+	WPUInt										_budget, _bytes;									//!< Byte budget and bytes held
+	WPUInt										_hits, _misses, _evictions;							//!< Statistics
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_t								_mutex;												//!< Guards all cache state
+#endif
+	static WCTessellationCache					*_shared;											//!< Shared cache instance
+	static WPUInt								_sharedBudget;										//!< Budget for the shared cache
+	//Hidden Methods
+	WCTessellationCache(const WCTessellationCache &cache);											//!< Deny access to copy constructor
+	WCTessellationCache& operator=(const WCTessellationCache &cache);								//!< Deny access to equals operator
+	void Lock(void);																				//!< Acquire the cache mutex
+	void Unlock(void);																				//!< Release the cache mutex
+	void Erase(_EntryIterator entry);																//!< Free an entry's buffers and drop it
+	void Trim(void);																				//!< Evict unreferenced entries until under budget
+public:
+	//Constructors and Destructors
+	WCTessellationCache(const WPUInt &budget);														//!< Primary constructor
+	~WCTessellationCache();																			//!< Default destructor - frees every entry
+
+	//Member Access Methods
+	WPUInt Budget(void);																			//!< Get the byte budget
+	void Budget(const WPUInt &budget);																//!< Set the byte budget (evicts as needed)
+	WPUInt Bytes(void);																				//!< Get the bytes currently held
+	WPUInt Count(void);																				//!< Get the number of entries
+	WPUInt Hits(void);																				//!< Get the number of hits
+	WPUInt Misses(void);																			//!< Get the number of misses
+	WPUInt Evictions(void);																			//!< Get the number of evictions
+
+	//Original Member Methods
+	bool Acquire(const WCTessellationKey &key, WCTessellation &data);								//!< Look up and reference a tessellation
+	void Insert(const WCTessellationKey &key, WCTessellation &data, const WPUInt &bytes);			//!< Take ownership of a new, referenced tessellation
+	bool Release(GLfloat *buffer);																	//!< Drop a reference (false if not cached)
+	void Invalidate(const void *object);															//!< Drop every tessellation of an object
+	void Clear(void);																				//!< Drop every unreferenced tessellation
+	void ResetStatistics(void);																		//!< Zero the hit, miss and eviction counters
+
+	//Static Methods
+	static WCTessellationCache* Shared(void);														//!< Get the shared cache (created on first use)
+	static void SharedBudget(const WPUInt &budget);													//!< Set the shared cache budget (0 = default)
+	static void Terminate(void);																	//!< Destroy the shared cache
+};
+
+
+/***********************************************~***************************************************/
+
+
+}	   // End Wildcat Namespace
+#endif //__WUTIL_TESSELLATION_CACHE_H__
+
@@ -0,0 +1,516 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <Utility/tessellation_store.h>
+#include <Utility/log_manager.h>
+#include <Utility/vector.h>
+#ifndef __WIN32__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+/*** Locally Defined Values ***/
+#define TESSELLATIONSTORE_ENDIAN				0x01020304
+#define TESSELLATIONSTORE_RECORD				0x54455353	//'TESS'
+#define TESSELLATIONSTORE_MAX_BUFFERS			8
+#define TESSELLATIONSTORE_FNV_OFFSET			14695981039346656037ULL
+#define TESSELLATIONSTORE_FNV_PRIME				1099511628211ULL
+
+
+//File header - any mismatch means the whole file is rebuilt
+struct _TessellationStoreHeader {
+	char										magic[8];
+	unsigned int								version, endian, floatSize, doubleSize;
+};
+
+
+//Record header - followed by buffer sizes, counts, params and then buffer data
+struct _TessellationStoreRecord {
+	unsigned int								marker, kind;
+	WPHash										hash, checksum;
+	WPFloat										values[TESSELLATIONCACHE_MAX_VALUES];
+	unsigned int								numCounts, numParams, numBuffers, reserved;
+};
+
+
+/*** Static Member Initialization ***/
+WCTessellationStore* WCTessellationStore::_active = NULL;
+#ifndef __WILDCAT_NO_THREADS__
+static pthread_mutex_t _activeMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+/***********************************************~***************************************************/
+
+
+static _TessellationStoreHeader _TessellationStoreExpectedHeader(void) {
+	//The header this build writes and accepts
+	_TessellationStoreHeader header;
+	memcpy(header.magic, TESSELLATIONSTORE_MAGIC, 8);
+	header.version = TESSELLATIONSTORE_VERSION;
+	header.endian = TESSELLATIONSTORE_ENDIAN;
+	header.floatSize = sizeof(GLfloat);
+	header.doubleSize = sizeof(WPFloat);
+	return header;
+}
+
+
+static WPUInt _TessellationStorePayloadSize(const _TessellationStoreRecord &record, const unsigned int *sizes) {
+	//Everything after the record header
+	WPUInt size = record.numBuffers * sizeof(unsigned int) + record.numCounts * sizeof(WPHash) + record.numParams * sizeof(WPFloat);
+	for (WPUInt i=0; i<record.numBuffers; i++) size += sizes[i] * sizeof(GLfloat);
+	return size;
+}
+
+
+/***********************************************~***************************************************/
+
+
+WCContentHash::WCContentHash() : _value(TESSELLATIONSTORE_FNV_OFFSET) {
+	//Nothing else to do for now
+}
+
+
+void WCContentHash::Add(const void *data, const WPUInt &bytes) {
+	const unsigned char *ptr = (const unsigned char*)data;
+	for (WPUInt i=0; i<bytes; i++) {
+		this->_value ^= (WPHash)ptr[i];
+		this->_value *= TESSELLATIONSTORE_FNV_PRIME;
+	}
+}
+
+
+void WCContentHash::Add(const WPUInt &value) {
+	//Widen so the hash does not depend on the size of long
+	WPHash wide = (WPHash)value;
+	this->Add(&wide, sizeof(WPHash));
+}
+
+
+void WCContentHash::Add(const WPFloat &value) {
+	//Fold -0 into 0 so equal values hash equally
+	WPFloat tmp = (value == 0.0) ? 0.0 : value;
+	this->Add(&tmp, sizeof(WPFloat));
+}
+
+
+void WCContentHash::Add(const WCVector4 &vector) {
+	this->Add(vector.I());
+	this->Add(vector.J());
+	this->Add(vector.K());
+	this->Add(vector.L());
+}
+
+
+/***********************************************~***************************************************/
+
+
+bool WCTessellationStore::_Key::operator<(const _Key &key) const {
+	//Order by hash, then kind, then values
+	if (this->hash != key.hash) return this->hash < key.hash;
+	if (this->kind != key.kind) return this->kind < key.kind;
+	for (WPUInt i=0; i<TESSELLATIONCACHE_MAX_VALUES; i++)
+		if (this->values[i] != key.values[i]) return this->values[i] < key.values[i];
+	return false;
+}
+
+
+void WCTessellationStore::Lock(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&this->_mutex);
+#endif
+}
+
+
+void WCTessellationStore::Unlock(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&this->_mutex);
+#endif
+}
+
+
+void WCTessellationStore::Map(void) {
+#ifndef __WIN32__
+	//Map the whole file read-only
+	int fd = open(this->_path.c_str(), O_RDONLY);
+	if (fd < 0) return;
+	struct stat info;
+	if ((fstat(fd, &info) == 0) && (info.st_size > 0)) {
+		void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			this->_data = (const char*)data;
+			this->_size = (WPUInt)info.st_size;
+			this->_isMapped = true;
+		}
+	}
+	close(fd);
+#else
+	//No mapping here - read the file in one go
+	std::ifstream file(this->_path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open()) return;
+	WPUInt size = (WPUInt)file.tellg();
+	if (size == 0) return;
+	char *data = new char[size];
+	file.seekg(0, std::ios::beg);
+	file.read(data, size);
+	this->_data = data;
+	this->_size = size;
+#endif
+	if (this->_data == NULL) return;
+
+	//Check the file header
+	_TessellationStoreHeader header, expected = _TessellationStoreExpectedHeader();
+	if (this->_size < sizeof(_TessellationStoreHeader)) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCTessellationStore::Map - " << this->_path << " is too short, rebuilding.");
+		return;
+	}
+	memcpy(&header, this->_data, sizeof(_TessellationStoreHeader));
+	if (memcmp(&header, &expected, sizeof(_TessellationStoreHeader)) != 0) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCTessellationStore::Map - " << this->_path << " is out of date, rebuilding.");
+		return;
+	}
+	//Index every complete record
+	WPUInt offset = sizeof(_TessellationStoreHeader), payload;
+	_TessellationStoreRecord record;
+	unsigned int sizes[TESSELLATIONSTORE_MAX_BUFFERS];
+	while (offset + sizeof(_TessellationStoreRecord) <= this->_size) {
+		memcpy(&record, this->_data + offset, sizeof(_TessellationStoreRecord));
+		if ((record.marker != TESSELLATIONSTORE_RECORD) || (record.numBuffers > TESSELLATIONSTORE_MAX_BUFFERS)) break;
+		if (offset + sizeof(_TessellationStoreRecord) + record.numBuffers * sizeof(unsigned int) > this->_size) break;
+		memcpy(sizes, this->_data + offset + sizeof(_TessellationStoreRecord), record.numBuffers * sizeof(unsigned int));
+		payload = _TessellationStorePayloadSize(record, sizes);
+		if (payload > this->_size - offset - sizeof(_TessellationStoreRecord)) break;
+		_Key key;
+		key.hash = record.hash;
+		key.kind = record.kind;
+		for (WPUInt i=0; i<TESSELLATIONCACHE_MAX_VALUES; i++) key.values[i] = record.values[i];
+		this->_index[key] = offset;
+		offset += sizeof(_TessellationStoreRecord) + payload;
+	}
+	this->_validEnd = offset;
+	//A clean file can be appended to directly
+	if (this->_validEnd == this->_size) this->_isClean = true;
+	else CLOGGER_WARN(WCLogManager::RootLogger(), "WCTessellationStore::Map - Dropping damaged tail of " << this->_path);
+}
+
+
+void WCTessellationStore::Unmap(void) {
+	if (this->_data == NULL) return;
+#ifndef __WIN32__
+	if (this->_isMapped) munmap((void*)this->_data, (size_t)this->_size);
+#else
+	delete [] (char*)this->_data;
+#endif
+	this->_data = NULL;
+	this->_size = 0;
+	this->_isMapped = false;
+}
+
+
+bool WCTessellationStore::Repair(void) {
+	//Nothing to do if the file ends with a good record
+	if (this->_isClean) return true;
+	//No usable records - start a fresh file
+	if (this->_validEnd == 0) {
+		std::ofstream file(this->_path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		_TessellationStoreHeader header = _TessellationStoreExpectedHeader();
+		file.write((const char*)&header, sizeof(_TessellationStoreHeader));
+		if (!file.good()) {
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTessellationStore::Repair - Unable to write " << this->_path);
+			return false;
+		}
+	}
+	//Cut the damaged tail off (records past it are never read)
+	else {
+#ifndef __WIN32__
+		if (truncate(this->_path.c_str(), (off_t)this->_validEnd) != 0) {
+#else
+		std::ofstream file(this->_path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(this->_data, this->_validEnd);
+		if (!file.good()) {
+#endif
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTessellationStore::Repair - Unable to truncate " << this->_path);
+			return false;
+		}
+	}
+	this->_isClean = true;
+	return true;
+}
+
+
+WCTessellationStore::_Key WCTessellationStore::MakeKey(const WPHash &hash, const WCTessellationKey &key) {
+	_Key diskKey;
+	diskKey.hash = hash;
+	diskKey.kind = key.kind;
+	for (WPUInt i=0; i<TESSELLATIONCACHE_MAX_VALUES; i++) diskKey.values[i] = key.values[i];
+	return diskKey;
+}
+
+
+WPHash WCTessellationStore::Checksum(const char *header, const WPUInt &headerSize, const char *payload, const WPUInt &payloadSize) {
+	//Hash the record header (with a zero checksum field) and the payload
+	WCContentHash hash;
+	hash.Add(header, headerSize);
+	hash.Add(payload, payloadSize);
+	return hash.Value();
+}
+
+
+/***********************************************~***************************************************/
+
+
+WCTessellationStore::WCTessellationStore(const std::string &path) : _path(path), _data(NULL), _size(0), _validEnd(0),
+	_isMapped(false), _isClean(false), _index(), _written(), _hits(0), _misses(0), _rejects(0), _users(0) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_init(&this->_mutex, NULL);
+#endif
+	//Map and index whatever is already on disk
+	this->Map();
+}
+
+
+WCTessellationStore::~WCTessellationStore() {
+	this->Unmap();
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_destroy(&this->_mutex);
+#endif
+}
+
+
+WPUInt WCTessellationStore::Count(void) {
+	this->Lock();
+	WPUInt count = (WPUInt)this->_index.size();
+	this->Unlock();
+	return count;
+}
+
+
+WPUInt WCTessellationStore::Hits(void) {
+	this->Lock();
+	WPUInt hits = this->_hits;
+	this->Unlock();
+	return hits;
+}
+
+
+WPUInt WCTessellationStore::Misses(void) {
+	this->Lock();
+	WPUInt misses = this->_misses;
+	this->Unlock();
+	return misses;
+}
+
+
+WPUInt WCTessellationStore::Rejects(void) {
+	this->Lock();
+	WPUInt rejects = this->_rejects;
+	this->Unlock();
+	return rejects;
+}
+
+
+bool WCTessellationStore::Find(const WPHash &hash, const WCTessellationKey &key, WCTessellation &data) {
+	this->Lock();
+	std::map<_Key,WPUInt>::iterator iter = this->_index.find(WCTessellationStore::MakeKey(hash, key));
+	if (iter == this->_index.end()) {
+		this->_misses++;
+		this->Unlock();
+		return false;
+	}
+	//Check the record against its checksum
+	const char *recordData = this->_data + iter->second;
+	_TessellationStoreRecord record;
+	memcpy(&record, recordData, sizeof(_TessellationStoreRecord));
+	WPHash checksum = record.checksum;
+	record.checksum = 0;
+	const char *payload = recordData + sizeof(_TessellationStoreRecord);
+	unsigned int sizes[TESSELLATIONSTORE_MAX_BUFFERS];
+	memcpy(sizes, payload, record.numBuffers * sizeof(unsigned int));
+	WPUInt payloadSize = _TessellationStorePayloadSize(record, sizes);
+	if (WCTessellationStore::Checksum((const char*)&record, sizeof(_TessellationStoreRecord), payload, payloadSize) != checksum) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCTessellationStore::Find - Corrupt record in " << this->_path << ", regenerating.");
+		this->_index.erase(iter);
+		this->_rejects++;
+		this->Unlock();
+		return false;
+	}
+	//Copy the record out into fresh client buffers
+	payload += record.numBuffers * sizeof(unsigned int);
+	WPHash count;
+	data.counts.resize(record.numCounts);
+	for (WPUInt i=0; i<record.numCounts; i++) {
+		memcpy(&count, payload, sizeof(WPHash));
+		data.counts.at(i) = (WPUInt)count;
+		payload += sizeof(WPHash);
+	}
+	data.params.resize(record.numParams);
+	if (record.numParams > 0) memcpy(&data.params[0], payload, record.numParams * sizeof(WPFloat));
+	payload += record.numParams * sizeof(WPFloat);
+	data.buffers.resize(record.numBuffers);
+	for (WPUInt i=0; i<record.numBuffers; i++) {
+		data.buffers.at(i) = new GLfloat[sizes[i]];
+		memcpy(data.buffers.at(i), payload, sizes[i] * sizeof(GLfloat));
+		payload += sizes[i] * sizeof(GLfloat);
+	}
+	this->_hits++;
+	this->Unlock();
+	return true;
+}
+
+
+bool WCTessellationStore::Store(const WPHash &hash, const WCTessellationKey &key, const WCTessellation &data,
+	const std::vector<WPUInt> &sizes) {
+	//Make sure the sizes describe the buffers
+	if ((sizes.size() != data.buffers.size()) || (sizes.size() > TESSELLATIONSTORE_MAX_BUFFERS)) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTessellationStore::Store - Buffer sizes do not match buffers.");
+		return false;
+	}
+	this->Lock();
+	_Key diskKey = WCTessellationStore::MakeKey(hash, key);
+	//Already on disk
+	if ((this->_index.find(diskKey) != this->_index.end()) || (this->_written.find(diskKey) != this->_written.end())) {
+		this->Unlock();
+		return true;
+	}
+	if (!this->Repair()) {
+		this->Unlock();
+		return false;
+	}
+	//Lay out the payload
+	_TessellationStoreRecord record;
+	record.marker = TESSELLATIONSTORE_RECORD;
+	record.kind = (unsigned int)key.kind;
+	record.hash = hash;
+	record.checksum = 0;
+	for (WPUInt i=0; i<TESSELLATIONCACHE_MAX_VALUES; i++) record.values[i] = key.values[i];
+	record.numCounts = (unsigned int)data.counts.size();
+	record.numParams = (unsigned int)data.params.size();
+	record.numBuffers = (unsigned int)data.buffers.size();
+	record.reserved = 0;
+	unsigned int diskSizes[TESSELLATIONSTORE_MAX_BUFFERS];
+	for (WPUInt i=0; i<record.numBuffers; i++) diskSizes[i] = (unsigned int)sizes.at(i);
+	std::vector<char> payload(_TessellationStorePayloadSize(record, diskSizes));
+	char *ptr = &payload[0];
+	memcpy(ptr, diskSizes, record.numBuffers * sizeof(unsigned int));
+	ptr += record.numBuffers * sizeof(unsigned int);
+	WPHash count;
+	for (WPUInt i=0; i<record.numCounts; i++) {
+		count = (WPHash)data.counts.at(i);
+		memcpy(ptr, &count, sizeof(WPHash));
+		ptr += sizeof(WPHash);
+	}
+	if (record.numParams > 0) memcpy(ptr, &data.params[0], record.numParams * sizeof(WPFloat));
+	ptr += record.numParams * sizeof(WPFloat);
+	for (WPUInt i=0; i<record.numBuffers; i++) {
+		memcpy(ptr, data.buffers.at(i), diskSizes[i] * sizeof(GLfloat));
+		ptr += diskSizes[i] * sizeof(GLfloat);
+	}
+	record.checksum = WCTessellationStore::Checksum((const char*)&record, sizeof(_TessellationStoreRecord), &payload[0], payload.size());
+	//Append it
+	std::ofstream file(this->_path.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+	file.write((const char*)&record, sizeof(_TessellationStoreRecord));
+	file.write(&payload[0], payload.size());
+	if (!file.good()) {
+		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCTessellationStore::Store - Unable to write " << this->_path);
+		//A partial record leaves a damaged tail
+		this->_isClean = false;
+		this->Unlock();
+		return false;
+	}
+	this->_written.insert(diskKey);
+	this->Unlock();
+	return true;
+}
+
+
+/***********************************************~***************************************************/
+
+
+WCTessellationStore* WCTessellationStore::Active(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&_activeMutex);
+#endif
+	WCTessellationStore *store = WCTessellationStore::_active;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_activeMutex);
+#endif
+	return store;
+}
+
+
+WCTessellationStore* WCTessellationStore::AcquireActive(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&_activeMutex);
+#endif
+	//Pool workers hold the store for the whole lookup, so Activate can not free it underneath them
+	WCTessellationStore *store = WCTessellationStore::_active;
+	if (store != NULL) store->_users++;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_activeMutex);
+#endif
+	return store;
+}
+
+
+void WCTessellationStore::Release(WCTessellationStore *store) {
+	if (store == NULL) return;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&_activeMutex);
+#endif
+	bool isLast = (--store->_users == 0);
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_activeMutex);
+#endif
+	//Last holder of a replaced store frees it
+	if (isLast) delete store;
+}
+
+
+void WCTessellationStore::Activate(WCTessellationStore *store) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&_activeMutex);
+#endif
+	WCTessellationStore *previous = WCTessellationStore::_active;
+	if (previous == store) previous = NULL;
+	//The active slot holds its own reference
+	else if (store != NULL) store->_users++;
+	WCTessellationStore::_active = store;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_activeMutex);
+#endif
+	//Drop the slot's reference to the previous store (freed now unless a worker still holds it)
+	WCTessellationStore::Release(previous);
+}
+
+
+/***********************************************~***************************************************/
+
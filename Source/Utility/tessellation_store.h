@@ -0,0 +1,148 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+#ifndef __WUTIL_TESSELLATION_STORE_H__
+#define __WUTIL_TESSELLATION_STORE_H__
+
+
+/*** Included Header Files ***/
+#include <Utility/wutil.h>
+#include <Utility/tessellation_cache.h>
+#ifndef __WILDCAT_NO_THREADS__
+#include <pthread.h>
+#endif
+
+
+/*** Locally Defined Values ***/
+#define TESSELLATIONSTORE_EXTENSION				".tesscache"
+#define TESSELLATIONSTORE_MAGIC					"WCTESS\r\n"
+#define TESSELLATIONSTORE_VERSION				1
+
+
+/*** Namespace Declaration ***/
+namespace __WILDCAT_NAMESPACE__ {
+
+
+/*** Class Predefines ***/
+class WCVector4;
+
+
+/***********************************************~***************************************************/
+
+
+//64-bit content hash value
+typedef unsigned long long WPHash;
+
+
+//Running FNV-1a hash over geometry content
+class WCContentHash {
+private:
+	WPHash										_value;												//!< Current hash value
+public:
+	//Constructors and Destructors
+	WCContentHash();																				//!< Default constructor
+
+	//Member Access Methods
+	inline WPHash Value(void) const				{ return this->_value; }							//!< Get the hash value
+
+	//Original Member Methods
+	void Add(const void *data, const WPUInt &bytes);												//!< Mix in raw bytes
+	void Add(const WPUInt &value);																	//!< Mix in an integer
+	void Add(const WPFloat &value);																	//!< Mix in a float (-0 hashes as 0)
+	void Add(const WCVector4 &vector);																//!< Mix in all four components
+};
+
+
+/***********************************************~***************************************************/
+
+
+class WCTessellationStore {
+private:
+	//Key of one record on disk
+	struct _Key {
+		WPHash									hash;
+		WPUInt									kind;
+		WPFloat									values[TESSELLATIONCACHE_MAX_VALUES];
+		bool operator<(const _Key &key) const;
+	};
+	std::string									_path;												//!< Cache file path
+	const char									*_data;												//!< Mapped (or read) file contents
+	WPUInt										_size;												//!< Bytes in _data
+	WPUInt										_validEnd;											//!< End of the last good record
+	bool										_isMapped;											//!< True if _data is memory mapped
+	bool										_isClean;											//!< File ends with a good record
+	std::map<_Key,WPUInt>						_index;												//!< Record offsets in _data
+	std::set<_Key>								_written;											//!< Records appended this session
+	WPUInt										_hits, _misses, _rejects;							//!< Statistics
+	WPUInt										_users;												//!< Active slot plus each AcquireActive holder
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_t								_mutex;												//!< Guards all store state
+#endif
+	static WCTessellationStore					*_active;											//!< Store used by geometry (may be NULL)
+	//Hidden Methods
+	WCTessellationStore(const WCTessellationStore &store);											//!< Deny access to copy constructor
+	WCTessellationStore& operator=(const WCTessellationStore &store);								//!< Deny access to equals operator
+	void Lock(void);																				//!< Acquire the store mutex
+	void Unlock(void);																				//!< Release the store mutex
+	void Map(void);																					//!< Map the file and index its records
+	void Unmap(void);																				//!< Release the file contents
+	bool Repair(void);																				//!< Cut the file back to its good records
+	static _Key MakeKey(const WPHash &hash, const WCTessellationKey &key);							//!< Build a disk key
+	static WPHash Checksum(const char *header, const WPUInt &headerSize,							//!< Checksum of a record
+												const char *payload, const WPUInt &payloadSize);
+public:
+	//Constructors and Destructors
+	WCTessellationStore(const std::string &path);													//!< Primary constructor - opens or creates the file
+	~WCTessellationStore();																			//!< Default destructor
+
+	//Member Access Methods
+	inline std::string Path(void) const			{ return this->_path; }								//!< Get the file path
+	WPUInt Count(void);																				//!< Get the number of usable records
+	WPUInt Hits(void);																				//!< Get the number of records loaded
+	WPUInt Misses(void);																			//!< Get the number of lookups not found
+	WPUInt Rejects(void);																			//!< Get the number of records failing integrity checks
+
+	//Original Member Methods
+	bool Find(const WPHash &hash, const WCTessellationKey &key, WCTessellation &data);				//!< Load a record into new client buffers
+	bool Store(const WPHash &hash, const WCTessellationKey &key,										//!< Append a record (buffer sizes in floats)
+												const WCTessellation &data, const std::vector<WPUInt> &sizes);
+
+	//Static Methods - a replaced store lives until its last holder releases it
+	static WCTessellationStore* Active(void);														//!< Peek at the active store (only safe on the activating thread)
+	static WCTessellationStore* AcquireActive(void);												//!< Get a held reference to the active store (NULL if none)
+	static void Release(WCTessellationStore *store);												//!< Drop a reference from AcquireActive
+	static void Activate(WCTessellationStore *store);												//!< Replace the active store (taking ownership)
+};
+
+
+/***********************************************~***************************************************/
+
+
+}	   // End Wildcat Namespace
+#endif //__WUTIL_TESSELLATION_STORE_H__
+
@@ -0,0 +1,271 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <Utility/thread_pool.h>
+#include <Utility/log_manager.h>
+#include <time.h>
+#ifndef __WIN32__
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
+
+/*** Static Member Initialization ***/
+WCThreadPool* WCThreadPool::_shared = NULL;
+WPUInt WCThreadPool::_sharedThreads = 0;
+#ifndef __WILDCAT_NO_THREADS__
+static pthread_mutex_t _sharedMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t _taskKey;
+static pthread_once_t _taskKeyOnce = PTHREAD_ONCE_INIT;
+#endif
+
+
+/***********************************************~***************************************************/
+
+
+#ifndef __WILDCAT_NO_THREADS__
+static void _ThreadPoolMakeKey(void) {
+	pthread_key_create(&_taskKey, NULL);
+}
+
+
+//Per thread flag - set while the thread is running work for any pool
+static bool _ThreadPoolInTask(void) {
+	pthread_once(&_taskKeyOnce, _ThreadPoolMakeKey);
+	return pthread_getspecific(_taskKey) != NULL;
+}
+
+
+static void _ThreadPoolInTask(const bool &inTask) {
+	pthread_once(&_taskKeyOnce, _ThreadPoolMakeKey);
+	pthread_setspecific(_taskKey, inTask ? (void*)1 : NULL);
+}
+#endif
+
+
+/***********************************************~***************************************************/
+
+
+void* WCThreadPool::ThreadEntryPoint(void *pool) {
+	//Run the worker loop for the pool
+	((WCThreadPool*)pool)->WorkerLoop();
+	return NULL;
+}
+
+
+void WCThreadPool::WorkerLoop(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	WPUInt index;
+	//Workers only ever run pool tasks
+	_ThreadPoolInTask(true);
+	pthread_mutex_lock(&this->_mutex);
+	while (true) {
+		//Sleep until there is an unclaimed index or shutdown
+		while (!this->_isShutdown && ((this->_task == NULL) || (this->_next >= this->_count)))
+			pthread_cond_wait(&this->_workCondition, &this->_mutex);
+		if (this->_isShutdown) break;
+		//Claim an index and run it outside of the lock
+		index = this->_next++;
+		WCThreadPoolTask task = this->_task;
+		void *data = this->_data;
+		pthread_mutex_unlock(&this->_mutex);
+		task(data, index);
+		pthread_mutex_lock(&this->_mutex);
+		//Wake the caller when the last index finishes
+		if (++this->_done == this->_count) pthread_cond_broadcast(&this->_doneCondition);
+	}
+	pthread_mutex_unlock(&this->_mutex);
+#endif
+}
+
+
+/***********************************************~***************************************************/
+
+
+WCThreadPool::WCThreadPool(const WPUInt &numThreads) : _numThreads(STDMAX(numThreads, (WPUInt)1)),
+	_task(NULL), _data(NULL), _count(0), _next(0), _done(0), _isShutdown(false) {
+#ifdef __WILDCAT_NO_THREADS__
+	//Everything runs on the calling thread
+	this->_numThreads = 1;
+#else
+	//Bound the number of threads
+	if (this->_numThreads > THREADPOOL_MAX_THREADS) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCThreadPool::WCThreadPool - Limiting to " << THREADPOOL_MAX_THREADS << " threads.");
+		this->_numThreads = THREADPOOL_MAX_THREADS;
+	}
+	pthread_mutex_init(&this->_mutex, NULL);
+	pthread_cond_init(&this->_workCondition, NULL);
+	pthread_cond_init(&this->_doneCondition, NULL);
+	pthread_cond_init(&this->_idleCondition, NULL);
+	//The caller is one of the threads, so start one less worker
+	pthread_t thread;
+	for (WPUInt i=1; i<this->_numThreads; i++) {
+		int retVal = pthread_create(&thread, NULL, WCThreadPool::ThreadEntryPoint, this);
+		if (retVal != 0) {
+			CLOGGER_ERROR(WCLogManager::RootLogger(), "WCThreadPool::WCThreadPool - Bad return from pthread_create: " << retVal);
+			break;
+		}
+		this->_threads.push_back(thread);
+	}
+	this->_numThreads = (WPUInt)this->_threads.size() + 1;
+#endif
+}
+
+
+WCThreadPool::~WCThreadPool() {
+#ifndef __WILDCAT_NO_THREADS__
+	//Let a running job finish, then tell all workers to exit and wait for them
+	pthread_mutex_lock(&this->_mutex);
+	while (this->_task != NULL) pthread_cond_wait(&this->_idleCondition, &this->_mutex);
+	this->_isShutdown = true;
+	pthread_cond_broadcast(&this->_workCondition);
+	pthread_mutex_unlock(&this->_mutex);
+	for (WPUInt i=0; i<this->_threads.size(); i++) pthread_join(this->_threads.at(i), NULL);
+	pthread_cond_destroy(&this->_workCondition);
+	pthread_cond_destroy(&this->_doneCondition);
+	pthread_cond_destroy(&this->_idleCondition);
+	pthread_mutex_destroy(&this->_mutex);
+#endif
+}
+
+
+void WCThreadPool::ParallelFor(const WPUInt &count, WCThreadPoolTask task, void *data) {
+	//Nothing to do
+	if ((count == 0) || (task == NULL)) return;
+#ifndef __WILDCAT_NO_THREADS__
+	//Run inline if single threaded, trivially small, or nested inside a task (the workers may all be busy with the outer job)
+	if ((this->_threads.empty()) || (count == 1) || _ThreadPoolInTask()) {
+		for (WPUInt i=0; i<count; i++) task(data, i);
+		return;
+	}
+	pthread_mutex_lock(&this->_mutex);
+	//Another thread's job holds the pool - wait for it to go idle
+	while (this->_task != NULL) pthread_cond_wait(&this->_idleCondition, &this->_mutex);
+	//Publish the job and wake the workers
+	this->_task = task;
+	this->_data = data;
+	this->_count = count;
+	this->_next = 0;
+	this->_done = 0;
+	pthread_cond_broadcast(&this->_workCondition);
+	//Help out until every index is claimed
+	WPUInt index;
+	_ThreadPoolInTask(true);
+	while (this->_next < this->_count) {
+		index = this->_next++;
+		pthread_mutex_unlock(&this->_mutex);
+		task(data, index);
+		pthread_mutex_lock(&this->_mutex);
+		++this->_done;
+	}
+	_ThreadPoolInTask(false);
+	//Wait for the stragglers and go idle
+	while (this->_done < this->_count) pthread_cond_wait(&this->_doneCondition, &this->_mutex);
+	this->_task = NULL;
+	this->_data = NULL;
+	pthread_cond_broadcast(&this->_idleCondition);
+	pthread_mutex_unlock(&this->_mutex);
+#else
+	for (WPUInt i=0; i<count; i++) task(data, i);
+#endif
+}
+
+
+/***********************************************~***************************************************/
+
+
+WPUInt WCThreadPool::ProcessorCount(void) {
+#if defined(__WIN32__) && !defined(__WILDCAT_NO_THREADS__)
+	int count = pthread_num_processors_np();
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	long count = 1;
+#endif
+	return (count > 0) ? (WPUInt)count : 1;
+}
+
+
+WPFloat WCThreadPool::Seconds(void) {
+#ifdef __WIN32__
+	//The Windows clock counts wall time
+	return (WPFloat)clock() / (WPFloat)CLOCKS_PER_SEC;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (WPFloat)tv.tv_sec + (WPFloat)tv.tv_usec * 0.000001;
+#endif
+}
+
+
+WCThreadPool* WCThreadPool::Shared(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_lock(&_sharedMutex);
+#endif
+	//Create the pool on first use
+	if (WCThreadPool::_shared == NULL) {
+		WPUInt numThreads = WCThreadPool::_sharedThreads;
+		if (numThreads == 0) numThreads = WCThreadPool::ProcessorCount();
+		WCThreadPool::_shared = new WCThreadPool(numThreads);
+	}
+	WCThreadPool *pool = WCThreadPool::_shared;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_sharedMutex);
+#endif
+	return pool;
+}
+
+
+void WCThreadPool::SharedThreadCount(const WPUInt &numThreads) {
+	//Drop the current pool, the next Shared call builds one of the new size
+	WCThreadPool::Terminate();
+	WCThreadPool::_sharedThreads = numThreads;
+}
+
+
+void WCThreadPool::Terminate(void) {
+#ifndef __WILDCAT_NO_THREADS__
+	//A task would wait on its own job forever
+	if (_ThreadPoolInTask()) {
+		CLOGGER_WARN(WCLogManager::RootLogger(), "WCThreadPool::Terminate - Not allowed from inside a pool task.");
+		return;
+	}
+	pthread_mutex_lock(&_sharedMutex);
+#endif
+	//The destructor waits for a running job to finish
+	if (WCThreadPool::_shared != NULL) delete WCThreadPool::_shared;
+	WCThreadPool::_shared = NULL;
+#ifndef __WILDCAT_NO_THREADS__
+	pthread_mutex_unlock(&_sharedMutex);
+#endif
+}
+
+
+/***********************************************~***************************************************/
+
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* Copyright (c) 2007, 2008, CerroKai Development
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of CerroKai Development nor the
+*       names of its contributors may be used to endorse or promote products
+*       derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+* EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+* DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+********************************************************************************/
+
+
+#ifndef __WUTIL_THREAD_POOL_H__
+#define __WUTIL_THREAD_POOL_H__
+
+
+/*** Included Header Files ***/
+#include <Utility/wutil.h>
+#ifndef __WILDCAT_NO_THREADS__
+#include <pthread.h>
+#endif
+
+
+/*** Locally Defined Values ***/
+#define THREADPOOL_MAX_THREADS					64
+
+
+/*** Namespace Declaration ***/
+namespace __WILDCAT_NAMESPACE__ {
+
+
+/*** Class Predefines ***/
+//None
+
+
+/***********************************************~***************************************************/
+
+
+//Work item callback - called once for each index in [0, count)
+typedef void (*WCThreadPoolTask)(void *data, const WPUInt &index);
+
+
+//One job at a time - ParallelFor from another thread waits its turn, from inside a task it runs inline.
+//Terminate waits for the running job, but pointers from Shared must not be used across it.
+class WCThreadPool {
+private:
+	WPUInt										_numThreads;										//!< Number of worker threads
+#ifndef __WILDCAT_NO_THREADS__
+	std::vector<pthread_t>						_threads;											//!< Worker threads
+	pthread_mutex_t								_mutex;												//!< Guards all job state
+	pthread_cond_t								_workCondition, _doneCondition, _idleCondition;		//!< Signals for new work, completion, and idle
+#endif
+	WCThreadPoolTask							_task;												//!< Current task (NULL if idle)
+	void										*_data;												//!< Current task data
+	WPUInt										_count, _next, _done;								//!< Job size, next index, finished count
+	bool										_isShutdown;										//!< Workers exit when set
+	static WCThreadPool							*_shared;											//!< Shared pool instance
+	static WPUInt								_sharedThreads;										//!< Thread count for the shared pool
+	//Hidden Methods
+	WCThreadPool(const WCThreadPool &pool);															//!< Deny access to copy constructor
+	WCThreadPool& operator=(const WCThreadPool &pool);												//!< Deny access to equals operator
+	static void* ThreadEntryPoint(void *pool);														//!< Worker thread entry point
+	void WorkerLoop(void);																			//!< Worker loop, runs until shutdown
+public:
+	//Constructors and Destructors
+	WCThreadPool(const WPUInt &numThreads);															//!< Primary constructor (total threads, including the caller)
+	~WCThreadPool();																				//!< Default destructor - waits for a running job, joins all workers
+
+	//Member Access Methods
+	inline WPUInt ThreadCount(void) const		{ return this->_numThreads; }						//!< Get the number of threads
+
+	//Original Member Methods
+	void ParallelFor(const WPUInt &count, WCThreadPoolTask task, void *data);						//!< Run task for every index and wait (caller helps, one job at a time)
+
+	//Static Methods
+	static WPUInt ProcessorCount(void);																//!< Number of online processors
+	static WPFloat Seconds(void);																	//!< Wall clock time in seconds (for timing jobs)
+	static WCThreadPool* Shared(void);																//!< Get the shared pool (created on first use)
+	static void SharedThreadCount(const WPUInt &numThreads);										//!< Set the shared pool size (0 = processor count) - see Terminate
+	static void Terminate(void);																	//!< Destroy the shared pool once its running job ends (ignored inside a task)
+};
+
+
+/***********************************************~***************************************************/
+
+
+}	   // End Wildcat Namespace
+#endif //__WUTIL_THREAD_POOL_H__
+
@@ -43,6 +43,34 @@
 #endif
 
 
+/*** Included Linux Header Files ***/
+#if !defined(__APPLE__) && !defined(__WIN32__)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+#endif
+
+
+/*** SIMD Selection ***/
+//__GOT_SIMD__ means vDouble is a native two-wide double vector with arithmetic operators
+#ifndef __WILDCAT_NO_SIMD__
+#if defined(__APPLE__) && defined(__SSE2__)
+#define __GOT_SIMD__
+#elif !defined(__APPLE__) && !defined(__WIN32__) && (defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__)))
+#define __GOT_SIMD__
+#endif
+//__GOT_AVX2_DISPATCH__ means batched kernels may switch to AVX2/FMA at runtime
+#if !defined(__APPLE__) && !defined(__WIN32__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define __GOT_AVX2_DISPATCH__
+#endif
+#endif //__WILDCAT_NO_SIMD__
+
+
 /*** Namespace Declaration ***/
 namespace __WILDCAT_NAMESPACE__ {
 
@@ -88,6 +116,18 @@ typedef ULONGLONG								WPTime;
 #endif //__WIN32__
 
 
+/*** Linux Definitions ***/
+#if !defined(__APPLE__) && !defined(__WIN32__)
+#if defined(__GOT_SIMD__) && defined(__SSE2__)
+typedef __m128d									vDouble;
+#elif defined(__GOT_SIMD__)
+typedef float64x2_t								vDouble;
+#else
+typedef double									vDouble;
+#endif
+#endif
+
+
 /*** Constant Definitions ***/
 #ifndef M_E
 	#define M_E									2.71828182845904523536028747135266250   /* e */
@@ -152,8 +152,8 @@ void WCVector4::FromElement(xercesc::DOMElement *element) {
 
 WCVector4 WCVector4::operator+(const WCVector4 &vector) const {
 	WCVector4 result;
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	result._data.v[0] = this->_data.v[0] + vector._data.v[0];
 	result._data.v[1] = this->_data.v[1] + vector._data.v[1];
 //Default path
@@ -169,8 +169,8 @@ WCVector4 WCVector4::operator+(const WCVector4 &vector) const {
 
 WCVector4 WCVector4::operator-(const WCVector4 &vector) const {
 	WCVector4 result;
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	result._data.v[0] = this->_data.v[0] - vector._data.v[0];
 	result._data.v[1] = this->_data.v[1] - vector._data.v[1];
 //Default path
@@ -186,8 +186,8 @@ WCVector4 WCVector4::operator-(const WCVector4 &vector) const {
 
 WCVector4 WCVector4::operator*(const WPFloat &scalar) const {
 	WCVector4 result;
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	vDouble S = { scalar, scalar };
 	result._data.v[0] = this->_data.v[0] * S;
 	result._data.v[1] = this->_data.v[1] * S;
@@ -206,8 +206,8 @@ WCVector4 WCVector4::operator*(const WPFloat &scalar) const {
 WCVector4 WCVector4::operator/(const WPFloat &scalar) const {
 	WCVector4 result;
 	WPFloat recip = 1.0 / scalar;
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	vDouble R = { recip, recip };
 	result._data.v[0] = this->_data.v[0] * R;
 	result._data.v[1] = this->_data.v[1] * R;
@@ -238,8 +238,8 @@ WCMatrix4 WCVector4::operator*(const WCVector4 &vector) const {
 
 
 WCVector4& WCVector4::operator+=(const WPFloat &scalar) {
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	vDouble S = { scalar, scalar };
 	this->_data.v[0] += S;
 	this->_data.v[1] += S;
@@ -255,8 +255,8 @@ WCVector4& WCVector4::operator+=(const WPFloat &scalar) {
 
 
 WCVector4& WCVector4::operator+=(const WCVector4 &vector) {
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	this->_data.v[0] += vector._data.v[0];
 	this->_data.v[1] += vector._data.v[1];
 //Default path
@@ -271,8 +271,8 @@ WCVector4& WCVector4::operator+=(const WCVector4 &vector) {
 
 
 WCVector4& WCVector4::operator-=(const WPFloat &scalar) {
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	vDouble S = { scalar, scalar };
 	this->_data.v[0] -= S;
 	this->_data.v[1] -= S;
@@ -288,8 +288,8 @@ WCVector4& WCVector4::operator-=(const WPFloat &scalar) {
 
 
 WCVector4& WCVector4::operator-=(const WCVector4 &vector) {
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	this->_data.v[0] -= vector._data.v[0];
 	this->_data.v[1] -= vector._data.v[1];
 //Default path
@@ -304,8 +304,8 @@ WCVector4& WCVector4::operator-=(const WCVector4 &vector) {
 
 
 WCVector4& WCVector4::operator*=(const WPFloat &scalar) {
-//Apple specific optimization
-#if defined(__APPLE__) && defined(__SSE2__)
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
 	vDouble S = { scalar, scalar };
 	this->_data.v[0] *= S;
 	this->_data.v[1] *= S;
@@ -321,10 +321,18 @@ WCVector4& WCVector4::operator*=(const WPFloat &scalar) {
 
 
 WCVector4& WCVector4::operator/=(const WPFloat &scalar) {
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
+	vDouble S = { scalar, scalar };
+	this->_data.v[0] /= S;
+	this->_data.v[1] /= S;
+//Default path
+#else
 	this->_data.d[0] /= scalar;
 	this->_data.d[1] /= scalar;
 	this->_data.d[2] /= scalar;
 	this->_data.d[3] /= scalar;			
+#endif
 	return *this;
 }
 
@@ -355,11 +363,26 @@ bool WCVector4::operator!=(const WCVector4 &vector) {
 
 
 WCVector4 WCVector4::operator*(const WCMatrix4 &m) const {
+//Two-wide SIMD optimization (SSE2 or NEON) - sum of scaled matrix rows
+#ifdef __GOT_SIMD__
+	WCVector4 retVec;
+	vDouble lo = WCSimd::Splat(this->_data.d[0]) * WCSimd::Load(m._data);
+	vDouble hi = WCSimd::Splat(this->_data.d[0]) * WCSimd::Load(m._data + 2);
+	for (int r=1; r<4; r++) {
+		lo += WCSimd::Splat(this->_data.d[r]) * WCSimd::Load(m._data + r*4);
+		hi += WCSimd::Splat(this->_data.d[r]) * WCSimd::Load(m._data + r*4 + 2);
+	}
+	retVec._data.v[0] = lo;
+	retVec._data.v[1] = hi;
+	return retVec;
+//Default path
+#else
 	WCVector4 retVec(this->_data.d[0]*m._data[0] + this->_data.d[1]*m._data[4] + this->_data.d[2]*m._data[8] + this->_data.d[3]*m._data[12], 
 					 this->_data.d[0]*m._data[1] + this->_data.d[1]*m._data[5] + this->_data.d[2]*m._data[9] + this->_data.d[3]*m._data[13], 
 					 this->_data.d[0]*m._data[2] + this->_data.d[1]*m._data[6] + this->_data.d[2]*m._data[10] + this->_data.d[3]*m._data[14], 
 					 this->_data.d[0]*m._data[3] + this->_data.d[1]*m._data[7] + this->_data.d[2]*m._data[11] + this->_data.d[3]*m._data[15]);
 	return retVec;
+#endif
 }
 
 
@@ -430,9 +453,15 @@ WPFloat WCVector4::NormInf(void) const {
 
 
 WPFloat WCVector4::DotProduct(const WCVector4 &vector) const {
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
+	return WCSimd::Sum(this->_data.v[0] * vector._data.v[0] + this->_data.v[1] * vector._data.v[1]);
+//Default path
+#else
 	WPFloat retVal( this->_data.d[0] * vector._data.d[0] + this->_data.d[1] * vector._data.d[1] +
 					this->_data.d[2] * vector._data.d[2] + this->_data.d[3] * vector._data.d[3] );
 	return retVal;
+#endif
 }
 
 
@@ -444,6 +473,57 @@ WCVector4 WCVector4::CrossProduct(const WCVector4 &vector) const {
 }
 
 
+#ifdef __GOT_AVX2_DISPATCH__
+__attribute__((target("avx2,fma")))
+static void _DotProductManyAVX2(const WPFloat *a, const WPFloat *b, WPFloat *out, const WPUInt &count) {
+	WPUInt i = 0;
+	__m256d p0, p1, p2, p3, h01, h23;
+	//Four dot products at a time - products, pairwise add, then fold the halves
+	for (; i+4<=count; i+=4) {
+		p0 = _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+		p1 = _mm256_mul_pd(_mm256_loadu_pd(a+4), _mm256_loadu_pd(b+4));
+		p2 = _mm256_mul_pd(_mm256_loadu_pd(a+8), _mm256_loadu_pd(b+8));
+		p3 = _mm256_mul_pd(_mm256_loadu_pd(a+12), _mm256_loadu_pd(b+12));
+		h01 = _mm256_hadd_pd(p0, p1);
+		h23 = _mm256_hadd_pd(p2, p3);
+		_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_permute2f128_pd(h01, h23, 0x20), _mm256_permute2f128_pd(h01, h23, 0x31)));
+		a += 16;
+		b += 16;
+	}
+	//Finish any remainder
+	for (; i<count; i++) {
+		out[i] = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+		a += 4;
+		b += 4;
+	}
+}
+#endif //__GOT_AVX2_DISPATCH__
+
+
+void WCVector4::DotProductMany(const WPFloat *a, const WPFloat *b, WPFloat *out, const WPUInt &count) {
+	//Check for trivial case
+	if ((a == NULL) || (b == NULL) || (out == NULL)) return;
+#ifdef __GOT_AVX2_DISPATCH__
+	//Use the four-wide path if the cpu has it
+	if (WCSimd::HasAVX2()) {
+		_DotProductManyAVX2(a, b, out, count);
+		return;
+	}
+#endif
+	for (WPUInt i=0; i<count; i++) {
+//Two-wide SIMD optimization (SSE2 or NEON)
+#ifdef __GOT_SIMD__
+		out[i] = WCSimd::Sum(WCSimd::Load(a) * WCSimd::Load(b) + WCSimd::Load(a+2) * WCSimd::Load(b+2));
+//Default path
+#else
+		out[i] = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+#endif
+		a += 4;
+		b += 4;
+	}
+}
+
+
 /***********************************************~***************************************************/
 
 
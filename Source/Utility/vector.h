@@ -49,6 +49,29 @@ namespace __WILDCAT_NAMESPACE__ {
 /***********************************************~***************************************************/
 
 
+class WCSimd {
+public:
+#ifdef __GOT_SIMD__
+	//Two-wide double helpers (unaligned safe)
+	static inline vDouble Load(const WPFloat *data)	{ vDouble v; memcpy(&v, data, sizeof(vDouble)); return v; }	//!< Load two doubles
+	static inline void Store(WPFloat *data, const vDouble &v)	{ memcpy(data, &v, sizeof(vDouble)); }		//!< Store two doubles
+	static inline vDouble Splat(const WPFloat &value)	{ vDouble v = { value, value }; return v; }			//!< Fill both lanes
+	static inline WPFloat Sum(const vDouble &v)	{ WPFloat d[2]; memcpy(d, &v, sizeof(vDouble)); return d[0] + d[1]; }	//!< Horizontal sum
+#endif //__GOT_SIMD__
+	static inline bool HasAVX2(void) {																//!< Can AVX2/FMA kernels run on this cpu
+#ifdef __GOT_AVX2_DISPATCH__
+												static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+												return avx2;
+#else
+												return false;
+#endif
+												}
+};
+
+
+/***********************************************~***************************************************/
+
+
 class WCVector4 {
 private:
 	union { WPFloat d[4]; vDouble v[2]; }		_data;												//!< Actual data in the vector
@@ -113,6 +136,7 @@ public:
 	WPFloat NormInf(void) const;																	//!< Infinity Norm
 	WPFloat DotProduct(const WCVector4 &vector) const;												//!< Return the dot product
 	WCVector4 CrossProduct(const WCVector4 &vector) const;											//!< Return the cross product
+	static void DotProductMany(const WPFloat *a, const WPFloat *b, WPFloat *out, const WPUInt &count);	//!< Dot count pairs of 4-vectors (4 doubles each)
 	
 	//Friend classes
 	friend std::ostream& operator<<(std::ostream& out, const WCVector4 &vec);						//!< Overloaded output operator
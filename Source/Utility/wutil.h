@@ -92,7 +92,7 @@ inline double round(const double &n) {
 
 //Configuration Values
 #define __WILDCAT_DEBUG_LOGGER__
-#define __WILDCAT_NO_THREADS__
+//#define __WILDCAT_NO_THREADS__
 
 //Define Logger Values
 #define LOGGER_DEBUG							1
@@ -47,13 +47,13 @@ WCPart::WCPart(const std::string &name, const std::string &directory) : ::WCDocu
 	_pointLayer(NULL), _lineLayer(NULL), _curveLayer(NULL), _surfaceLayer(NULL),
 	_pointMap(), _lineMap(), _curveMap(), _surfaceMap(), _topologyModel(NULL) {
 	//Set up default surface renderer
-	WCPartFeature::DefaultSurfaceRenderer = this->_scene->ShaderManager()->ProgramFromName("scn_basiclight");
+	WCPartFeature::DefaultSurfaceRenderer = this->_scene->ProgramFromName("scn_basiclight");
 	//Check feature name
 	if (this->_name == "") this->_name = this->RootName() + ".1";
 	//Create event handler
 	this->_controller = new WCPartController(this);
 	//Create tree element
-	WSTexture* partIcon = this->_scene->TextureManager()->TextureFromName("part32");
+	WSTexture* partIcon = this->_scene->TextureFromName("part32");
 	this->_treeElement = new WCTreeElement(this->_treeView, this->_name, this->_controller, partIcon);
 	//Create the topology model
 	this->_topologyModel = new WCTopologyModel();
@@ -81,7 +81,8 @@ WCPart::WCPart(const std::string &name, const std::string &directory) : ::WCDocu
 	this->_workbench = new WCPartWorkbench(this);
 	this->_workbench->Retain(*this);
 	this->_workbench->CreateInitialObjects();
-	if (this->_document == this)
+	//Headless parts are never interactive - do not enter the workbench
+	if ((this->_document == this) && (!this->_scene->IsHeadless()))
 		this->EnterWorkbench(this->_workbench);
 }
 
@@ -100,7 +101,7 @@ WCPart::WCPart(xercesc::DOMElement *element, WCSerialDictionary *dictionary) :
 	//Create event handler
 	this->_controller = new WCPartController(this);
 	//Create tree element
-	WSTexture* partIcon = this->_scene->TextureManager()->TextureFromName("part32");
+	WSTexture* partIcon = this->_scene->TextureFromName("part32");
 	this->_treeElement = new WCTreeElement(this->_treeView, this->_name, this->_controller, partIcon);
 	//Create the topology model
 	this->_topologyModel = new WCTopologyModel();
@@ -127,7 +128,7 @@ WCPart::WCPart(xercesc::DOMElement *element, WCSerialDictionary *dictionary) :
 	//Create workbench and enter it
 	this->_workbench = new WCPartWorkbench(this);
 	this->_workbench->Retain(*this);
-	if (this->_document == this)
+	if ((this->_document == this) && (!this->_scene->IsHeadless()))
 		this->EnterWorkbench(this->_workbench);
 
 	//Create part features
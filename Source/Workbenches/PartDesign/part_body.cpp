@@ -41,7 +41,7 @@ void WCPartBody::Initialize(void) {
 	//Create event handler
 	this->_controller = new WCPartBodyController(this);
 	//Create tree element
-	WSTexture* bodyIcon = this->_document->Scene()->TextureManager()->TextureFromName("body32");
+	WSTexture* bodyIcon = this->_document->Scene()->TextureFromName("body32");
 	this->_treeElement = new WCTreeElement(this->_document->TreeView(), this->_name, this->_controller, bodyIcon);
 	//Add tree view element
 	this->_creator->TreeElement()->AddLastChild(this->_treeElement);
@@ -76,7 +76,7 @@ WCPartBody::WCPartBody(xercesc::DOMElement *element, WCSerialDictionary *diction
 //	//Create event handler
 //	this->_controller = new WCPartBodyController(this);
 //	//Create tree element
-//	WSTexture* bodyIcon = this->_document->Scene()->TextureManager()->TextureFromName("body32");
+//	WSTexture* bodyIcon = this->_document->Scene()->TextureFromName("body32");
 //	this->_treeElement = new WCTreeElement(this->_document->TreeView(), this->_name, this->_controller, bodyIcon);
 //	//Add tree view element
 //	this->_creator->TreeElement()->AddLastChild(this->_treeElement);
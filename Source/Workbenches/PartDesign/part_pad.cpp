@@ -719,7 +719,7 @@ void WCPartPad::Initialize(void) {
 	//Create event handler
 	this->_controller = new WCPartPadController(this);
 	//Create tree element
-	WSTexture* padIcon = this->_document->Scene()->TextureManager()->TextureFromName("pad32");
+	WSTexture* padIcon = this->_document->Scene()->TextureFromName("pad32");
 	this->_treeElement = new WCTreeElement(this->_document->TreeView(), this->_name, this->_controller, padIcon);
 
 	//Add profiles as children
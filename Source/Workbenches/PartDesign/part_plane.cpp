@@ -90,7 +90,7 @@ void WCPartPlane::Initialize(void) {
 	//Create event handler
 	this->_controller = new WCPartPlaneController(this);
 	//Create tree element
-	WSTexture* planeIcon = this->_document->Scene()->TextureManager()->TextureFromName("plane32");
+	WSTexture* planeIcon = this->_document->Scene()->TextureFromName("plane32");
 	this->_treeElement = new WCTreeElement(this->_document->TreeView(), this->_name, this->_controller, planeIcon);
 	//Add tree view element
 	this->_creator->TreeElement()->AddLastChild(this->_treeElement);
@@ -100,8 +100,8 @@ void WCPartPlane::Initialize(void) {
 	//Set default visibility
 	this->_isVisible = PARTPLANE_DEFAULT_VISIBILITY;
 	
-	//Generate the VBO
-	glGenBuffers(1, &this->_buffer);
+	//Generate the VBO (headless scenes never render)
+	if (!this->_document->Scene()->IsHeadless()) glGenBuffers(1, &this->_buffer);
 	//Mark as dirty
 	this->_isFeatureDirty = true;
 	//Retain the the camera) (get ModelView updates)
@@ -156,7 +156,7 @@ WCPartPlane::~WCPartPlane() {
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCPartPlane::~WCPartPlane - Problem removing feature from part.");	
 	}
 	//Delete the VBO
-	glDeleteBuffers(1, &this->_buffer);
+	if (this->_buffer != 0) glDeleteBuffers(1, &this->_buffer);
 	//Release the camera
 	this->_document->Scene()->ActiveCamera()->Release(*this);
 }
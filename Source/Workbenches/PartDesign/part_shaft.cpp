@@ -521,7 +521,7 @@ void WCPartShaft::Initialize(void) {
 	//Create event handler
 	this->_controller = new WCPartShaftController(this);
 	//Create tree element
-	WSTexture* shaftIcon = this->_document->Scene()->TextureManager()->TextureFromName("shaft32");
+	WSTexture* shaftIcon = this->_document->Scene()->TextureFromName("shaft32");
 	this->_treeElement = new WCTreeElement(this->_document->TreeView(), this->_name, this->_controller, shaftIcon);
 	//Add profiles as children
 	std::list<WCSketchProfile*>::iterator profIter;
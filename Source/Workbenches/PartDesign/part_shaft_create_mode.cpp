@@ -131,7 +131,7 @@ void WCModePartShaftCreate::ProcessProfiles(const std::list<WCSketchProfile*> &p
 	for (pointIter = inputList.begin(); pointIter != inputList.end(); pointIter++)
 		(*pointIter) = this->_axis->Sketch()->ReferencePlane()->InverseTransformMatrix() * (*pointIter);
 	//Determine convex hull
-	this->_convexHull = ConvexHull2D(inputList, 0.0001);
+	this->_convexHull = ConvexHull2D(inputList);
 	//Convert convexHull back to 3D space
 	for (pointIter = this->_convexHull.begin(); pointIter != this->_convexHull.end(); pointIter++)
 		(*pointIter) = this->_axis->Sketch()->ReferencePlane()->TransformMatrix() * (*pointIter);
@@ -49,7 +49,8 @@
 /***********************************************~***************************************************/
 
 
-WCPartWorkbench::WCPartWorkbench(WCPart *part) : ::WCWorkbench(part, "Part Designer"), _part(part) {
+WCPartWorkbench::WCPartWorkbench(WCPart *part) : ::WCWorkbench(part, "Part Designer"), _part(part),
+	_compass(NULL), _frameRateMonitor(NULL) {
 	//Make sure part is not null
 	ASSERT(part);
 
@@ -62,8 +63,8 @@ WCPartWorkbench::WCPartWorkbench(WCPart *part) : ::WCWorkbench(part, "Part Desig
 	this->_keyMap->AddMapping( WCKeyEvent(127), WCUserMessage("delete") );
 	this->_keyMap->AddMapping( WCKeyEvent('x'), WCUserMessage("export") );
 	
-	//Create UI objects if part is root document
-	if (this->_part->Document() == this->_part) {
+	//Create UI objects if part is root document (headless parts have no UI layer)
+	if ((this->_part->Document() == this->_part) && (part->UserInterfaceLayer() != NULL)) {
 		this->_compass = new WCCompass(part->UserInterfaceLayer());
 		this->_compass->SetPlacement(WCPlacement::LowerLeft());
 		this->_frameRateMonitor = new WCFrameRateMonitor(part->UserInterfaceLayer());
@@ -103,9 +104,12 @@ bool WCPartWorkbench::OnEnter(void) {
 	//Call to the base OnEnter
 	this->WCWorkbench::OnEnter();
 	//Show part only design toolbars
-	this->_part->Document()->ToolbarManager()->ToolbarFromName("Standard")->IsVisible(true);
-	this->_part->Document()->ToolbarManager()->ToolbarFromName("View")->IsVisible(true);
-	this->_part->Document()->ToolbarManager()->ToolbarFromName("Part Design")->IsVisible(true);
+	WCToolbarManager *toolbars = this->_part->Document()->ToolbarManager();
+	if (toolbars != NULL) {
+		toolbars->ToolbarFromName("Standard")->IsVisible(true);
+		toolbars->ToolbarFromName("View")->IsVisible(true);
+		toolbars->ToolbarFromName("Part Design")->IsVisible(true);
+	}
 	//Return true
 	return true;
 }
@@ -113,9 +117,12 @@ bool WCPartWorkbench::OnEnter(void) {
 
 bool WCPartWorkbench::OnExit(void) {
 	//Hide part design toolbars
-	this->_part->Document()->ToolbarManager()->ToolbarFromName("Standard")->IsVisible(false);
-	this->_part->Document()->ToolbarManager()->ToolbarFromName("View")->IsVisible(false);
-	this->_part->Document()->ToolbarManager()->ToolbarFromName("Part Design")->IsVisible(false);
+	WCToolbarManager *toolbars = this->_part->Document()->ToolbarManager();
+	if (toolbars != NULL) {
+		toolbars->ToolbarFromName("Standard")->IsVisible(false);
+		toolbars->ToolbarFromName("View")->IsVisible(false);
+		toolbars->ToolbarFromName("Part Design")->IsVisible(false);
+	}
 	//Call to the base OnExit
 	this->WCWorkbench::OnExit();
 	//Return true
@@ -49,10 +49,10 @@ void WCSketch::Initialize(void) {
 	//Create constraint solver
 	this->_planner = new WCConstraintPlanner();
 	//Get tree element icons
-	WSTexture* sketchIcon = this->_document->Scene()->TextureManager()->TextureFromName("sketch32");
-	WSTexture* constraintIcon = this->_document->Scene()->TextureManager()->TextureFromName("constraint32");
-	WSTexture* folderIcon = this->_document->Scene()->TextureManager()->TextureFromName("folder32");
-	WSTexture* profileIcon = this->_document->Scene()->TextureManager()->TextureFromName("profile32");
+	WSTexture* sketchIcon = this->_document->Scene()->TextureFromName("sketch32");
+	WSTexture* constraintIcon = this->_document->Scene()->TextureFromName("constraint32");
+	WSTexture* folderIcon = this->_document->Scene()->TextureFromName("folder32");
+	WSTexture* profileIcon = this->_document->Scene()->TextureFromName("profile32");
 	//Create tree elements
 	this->_treeElement = new WCTreeElement(this->_document->TreeView(), this->_name, this->_controller, sketchIcon);
 	this->_refTreeElement = new WCTreeElement(this->_document->TreeView(), "References", this->_controller, folderIcon);
@@ -381,7 +381,7 @@ public:
 							(GLfloat)ul.I(), (GLfloat)ul.J(), (GLfloat)ul.K(),
 							(GLfloat)ur.I(), (GLfloat)ur.J(), (GLfloat)ur.K(), 
 							(GLfloat)lr.I(), (GLfloat)lr.J(), (GLfloat)lr.K()};
-		WSTexture *tex = wb->Feature()->Document()->Scene()->TextureManager()->TextureFromName("concentric32");
+		WSTexture *tex = wb->Feature()->Document()->Scene()->TextureFromName("concentric32");
 		GLfloat texCoords[8] = { 0.0, 0.0, 
 								 0.0, tex->_height, 
 								 tex->_width, tex->_height, 
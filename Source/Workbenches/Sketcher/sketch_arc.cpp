@@ -97,9 +97,9 @@ void WCSketchArc::Initialize(void) {
 	//Get icon texture (depends on arc type)
 	WSTexture *arcIcon;
 	if (this->_type == WCSketchArcType::ThreePoint())
-		arcIcon = this->_document->Scene()->TextureManager()->TextureFromName("threePointArc32");
+		arcIcon = this->_document->Scene()->TextureFromName("threePointArc32");
 	else
-		arcIcon = this->_document->Scene()->TextureManager()->TextureFromName("twoPointArc32");
+		arcIcon = this->_document->Scene()->TextureFromName("twoPointArc32");
 	//Create tree element and add into the tree (beneath the sketch features element)
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, arcIcon);
 	this->_sketch->FeaturesTreeElement()->AddLastChild(this->_treeElement);
@@ -69,7 +69,7 @@ void WCSketchAxis::Initialize(void) {
 	part->Workbench()->SelectionManager()->AddObject(this, this->_controller);
 
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture *axisIcon = this->_document->Scene()->TextureManager()->TextureFromName("axisLine32");
+	WSTexture *axisIcon = this->_document->Scene()->TextureFromName("axisLine32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, axisIcon);
 	this->_sketch->FeaturesTreeElement()->AddLastChild(this->_treeElement);
 }
@@ -94,7 +94,7 @@ void WCSketchCircle::Initialize(void) {
 	this->_centerPoint->Retain(*this);
 
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture *circleIcon = this->_document->Scene()->TextureManager()->TextureFromName("centerCircle32");
+	WSTexture *circleIcon = this->_document->Scene()->TextureFromName("centerCircle32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, circleIcon);
 	this->_sketch->FeaturesTreeElement()->AddLastChild(this->_treeElement);
 }
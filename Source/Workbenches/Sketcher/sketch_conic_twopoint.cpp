@@ -85,7 +85,7 @@ WCSketchConicTwoPoint::WCSketchConicTwoPoint(WCSketch *sketch, const std::string
 		return;
 	}
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture *icon = this->_document->Scene()->TextureManager()->TextureFromName("conic32");
+	WSTexture *icon = this->_document->Scene()->TextureFromName("conic32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, icon);
 	this->_sketch->FeaturesTreeElement()->AddLastChild(this->_treeElement);
 }
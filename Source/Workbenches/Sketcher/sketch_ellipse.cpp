@@ -113,7 +113,7 @@ void WCSketchEllipse::Initialize(void) {
 	this->_minorPoint->Retain(*this);
 
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture *ellipseIcon = this->_document->Scene()->TextureManager()->TextureFromName("ellipse32");
+	WSTexture *ellipseIcon = this->_document->Scene()->TextureFromName("ellipse32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, ellipseIcon);
 	this->_sketch->FeaturesTreeElement()->AddLastChild(this->_treeElement);
 }
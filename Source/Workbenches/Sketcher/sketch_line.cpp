@@ -51,7 +51,7 @@ void WCSketchLine::Initialize(void) {
 		return;
 	}
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture *lineIcon = this->_document->Scene()->TextureManager()->TextureFromName("line32");
+	WSTexture *lineIcon = this->_document->Scene()->TextureFromName("line32");
 	this->_treeElement = new WCTreeElement(	this->_sketch->Document()->TreeView(), this->_name, this->_controller, lineIcon);
 	this->_sketch->FeaturesTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
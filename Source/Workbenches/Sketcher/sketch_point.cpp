@@ -51,7 +51,7 @@ void WCSketchPoint::Initialize(void) {
 	}
 
 	//Create tree element and add into the tree (beneath the sketch features element)
-	WSTexture *pointIcon = this->_document->Scene()->TextureManager()->TextureFromName("point32");
+	WSTexture *pointIcon = this->_document->Scene()->TextureFromName("point32");
 	this->_treeElement = new WCTreeElement(this->_sketch->Document()->TreeView(), this->_name, this->_controller, pointIcon);
 	this->_sketch->FeaturesTreeElement()->AddLastChild(this->_treeElement);
 	//Inject constraints into sketch planner
@@ -262,7 +262,7 @@ void WCSketchProfile::Initialize(void) {
 		return;
 	}
 	//Create tree element and add into the tree (beneath the sketch profiles element)
-	WSTexture *profileIcon = this->_document->Scene()->TextureManager()->TextureFromName("profile32");
+	WSTexture *profileIcon = this->_document->Scene()->TextureFromName("profile32");
 	this->_treeElement = new WCTreeElement(this->_sketch->Document()->TreeView(), this->_name, this->_controller, profileIcon);
 	this->_sketch->ProfilesTreeElement()->AddLastChild(this->_treeElement);
 	
@@ -430,42 +430,31 @@ WPInt WCSketchProfile::IsOnRight(const WCSketchAxis *axis) {
 /*** IsInside Algorithm ***
  * This algorithm determines if the passed point is inside or outside of the primary profile.  The caller is responsible
  *	for checking to make sure profile is closed.  Here are the details of the algorithm:
- *		1) A line is created from the passed point to a point very far away (assumed to always be outside of the profile)
- *		2) The line is intersected with all of the curves of the profile
- *		3) The number of intersections is returned.  Even is outside, odd is inside.
+ *		1) The detailed boundary of the profile and the point are projected onto the sketch plane
+ *		2) Each boundary segment straddling the point's height is tested against a ray to the right of the point using the
+ *			exact orientation predicate, so no tolerances are needed
+ *		3) The number of crossings is returned.  Even is outside, odd is inside.
 ***/
 WPUInt WCSketchProfile::IsInside(const WCVector4 &point) {
-	//Form a geometric line from way far away to the point
-	WCVector4 p2(100000.0, 8128.0, 0.0, 1.0);
-	p2 = this->_sketch->ReferencePlane()->TransformMatrix() * p2;
-	WCGeometricLine *line = new WCGeometricLine(point, p2);
-	WCGeometricLine *iterLine;
-	WCNurbsCurve* iterCurve;
-	unsigned int flags = INTERSECT_GEN_NONE;
-	//Try intersecting that line with all curves in the profile
-	WPFloat count = 0.0;
-	std::list<WCIntersectionResult> hits;
-	std::list<WCIntersectionResult>::iterator hitsIter;
-	std::list< std::pair<WCGeometricCurve*,bool> >::iterator iter;
-	for (iter = this->_curveList.begin(); iter != this->_curveList.end(); iter++) {
-		//Determine type of curve
-		iterLine = dynamic_cast<WCGeometricLine*>((*iter).first);
-		if (!iterLine) iterCurve = dynamic_cast<WCNurbsCurve*>((*iter).first);
-		//Try the intersection
-		if (iterLine) hits = GeometricIntersection(line, iterLine, SKETCH_PROFILE_DEFAULT_TOLERANCE, flags);
-		else hits = GeometricIntersection(iterCurve, line, SKETCH_PROFILE_DEFAULT_TOLERANCE, flags);
-		//Adjust hits count
-		for (hitsIter = hits.begin(); hitsIter != hits.end(); hitsIter++) {
-			//Adjust for boundary hit
-			if ((iterLine && (*hitsIter).rightBoundary) || ((!iterLine && (*hitsIter).leftBoundary)) ) count += 0.5;
-			//Half for a boundary hit, whole for a non-boundary hit
-			else count++;
-		}
+	std::list<WCVector4> boundaryList;
+	this->BoundaryList(true, boundaryList);
+	if (boundaryList.empty()) return 0;
+	WCMatrix4 toPlaneMatrix( this->_sketch->ReferencePlane()->InverseTransformMatrix() );
+	WCVector4 pt = toPlaneMatrix * point, start, end = toPlaneMatrix * boundaryList.back();
+	WPUInt count = 0;
+	WPFloat orient;
+	std::list<WCVector4>::iterator boundaryIter;
+	for (boundaryIter = boundaryList.begin(); boundaryIter != boundaryList.end(); boundaryIter++) {
+		start = end;
+		end = toPlaneMatrix * (*boundaryIter);
+		//Only segments with one end above the point can cross the ray
+		if ((start.J() > pt.J()) == (end.J() > pt.J())) continue;
+		//Crossing is right of the point when the point is left of the upward segment
+		orient = Orient2D(start.I(), start.J(), end.I(), end.J(), pt.I(), pt.J());
+		if ((end.J() > start.J()) ? (orient > 0.0) : (orient < 0.0)) count++;
 	}
-	//Delete the line
-	delete line;
 	//Return the count
-	return (WPUInt)ceil(count);
+	return count;
 }
 
 
@@ -474,7 +463,7 @@ WPUInt WCSketchProfile::IsInside(const WCVector4 &point) {
  *	they do not intersect two profiles can be distinct or one profile can also be either inside or outside of the other.  All
  *	return values are the status of the passed profile as is relates to the primary profile.
  *	Here is the algorithm:
- *		1) Intersect all curves from profile A with all curves from profile B
+ *		1) Intersect all curves from profile A with all curves from profile B (line pairs use the exact segment predicate)
  *		2) Any intersection results in a return type of Intersect
  *		3) If no intersections then check to see if any point from profile B is inside A, likewise a point from A is in B
  *		4) Returns from these tests are used to categorize as distinct, inside, or outside
@@ -483,6 +472,7 @@ WCProfileType WCSketchProfile::Categorize(WCSketchProfile *profile) {
 	std::list<WCIntersectionResult> hits;
 	WCGeometricLine *firstLine, *secondLine;
 	WCNurbsCurve *firstCurve, *secondCurve;
+	WCMatrix4 toPlaneMatrix( this->_sketch->ReferencePlane()->InverseTransformMatrix() );
 
 	//Intersect all curves of profile with this
 	std::list< std::pair<WCGeometricCurve*,bool> >::iterator firstIter, secondIter;
@@ -496,9 +486,15 @@ WCProfileType WCSketchProfile::Categorize(WCSketchProfile *profile) {
 			//Figure out type of second curve
 			secondLine = dynamic_cast<WCGeometricLine*> ((*secondIter).first);
 			if (!secondLine) secondCurve = dynamic_cast<WCNurbsCurve*> ((*secondIter).first);
+			//Line pairs use the exact segment test in the sketch plane
+			if (firstLine && secondLine) {
+				WCVector4 p1 = toPlaneMatrix * firstLine->Begin(), q1 = toPlaneMatrix * firstLine->End();
+				WCVector4 p2 = toPlaneMatrix * secondLine->Begin(), q2 = toPlaneMatrix * secondLine->End();
+				if (SegmentsIntersect2D(p1.I(), p1.J(), q1.I(), q1.J(), p2.I(), p2.J(), q2.I(), q2.J())) return WCProfileType::Intersect();
+				continue;
+			}
 			//Itersect the two based on type
-			if (firstLine && secondLine)		hits = GeometricIntersection(firstLine, secondLine, SKETCHPROFILE_TOLERANCE, INTERSECT_GEN_NONE);
-			else if (firstLine && !secondLine)	hits = GeometricIntersection(secondCurve, firstLine, SKETCHPROFILE_TOLERANCE, INTERSECT_GEN_NONE);
+			if (firstLine && !secondLine)	hits = GeometricIntersection(secondCurve, firstLine, SKETCHPROFILE_TOLERANCE, INTERSECT_GEN_NONE);
 			else if (!firstLine && secondLine)	hits = GeometricIntersection(firstCurve, secondLine, SKETCHPROFILE_TOLERANCE, INTERSECT_GEN_NONE);
 			else								hits = GeometricIntersection(firstCurve, secondCurve, SKETCHPROFILE_TOLERANCE, INTERSECT_GEN_NONE);
 			//If there are hits, then there is some intersection
@@ -523,29 +519,38 @@ WCProfileType WCSketchProfile::Categorize(WCSketchProfile *profile) {
 
 /*** Triangulate Algorithm ***
  * This fundamental algorithm generates a vertex buffer and index buffer that triangulate the closed linear profile.
- *	First a detailed boundary list of the profile is generated.  This list is processed by the TriangulatePolygon routine.  See
- *	the details of this routine for more information.  It simply returns the index data which is then loaded into a buffer.
- *	The boundary point data is also loaded into a buffer.
+ *	Detailed boundary lists of the profile and of any hole profiles are projected onto the sketch plane and passed to the
+ *	TriangulatePolygon routine, which ear-clips the outer loop and holes together.  It returns contiguous index data which
+ *	is then loaded into a buffer.  The boundary point data is also loaded into a buffer.
 ***/
-GLuint WCSketchProfile::Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer) {
-	//Put all vertices into a list
-	std::list<WCVector4> boundaryList;
+GLuint WCSketchProfile::Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer, const std::list<WCSketchProfile*> &holes) {
+	//Gather the outer boundary followed by each hole boundary
+	std::list<WCVector4> boundaryList, holeList;
+	std::vector<WPUInt> holeStarts;
 	this->BoundaryList(true, boundaryList);
+	std::list<WCSketchProfile*>::const_iterator holeIter;
+	for (holeIter = holes.begin(); holeIter != holes.end(); holeIter++) {
+		holeList.clear();
+		(*holeIter)->BoundaryList(true, holeList);
+		holeStarts.push_back((WPUInt)boundaryList.size());
+		boundaryList.splice(boundaryList.end(), holeList);
+	}
 	std::list<WCVector4>::iterator boundaryIter;
 	//Define some arrays and variables
 	int numVerts = (int)boundaryList.size();
 	WCVector4 tmpVec;
-	std::list<WCVector4> vertList;
+	std::vector<WPFloat> planePoints;
+	std::vector<GLuint> indices;
 	int vertIndex = 0;
 	GLfloat *vertData = new GLfloat[numVerts * 3];
-	GLint* indexData;
 	WCMatrix4 toPlaneMatrix( this->_sketch->ReferencePlane()->InverseTransformMatrix() );
 	
 	//Process list
 	for (boundaryIter = boundaryList.begin(); boundaryIter != boundaryList.end(); boundaryIter++) {
-		//Project onto plane and put into list
+		//Project onto plane and keep the in-plane coordinates
 		tmpVec = toPlaneMatrix * (*boundaryIter);
-		vertList.push_back(tmpVec);
+		planePoints.push_back(tmpVec.I());
+		planePoints.push_back(tmpVec.J());
 		//Also place into vertex buffer array
 		vertData[vertIndex*3] = (GLfloat)(*boundaryIter).I();
 		vertData[vertIndex*3+1] = (GLfloat)(*boundaryIter).J();
@@ -554,8 +559,8 @@ GLuint WCSketchProfile::Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer) {
 		vertIndex++;
 	}
 
-	//Expects verts in CW order, outputs triangles in CW order
-	indexData = TriangulatePolygon(vertList);
+	//Outputs triangles in the same order as the outer boundary
+	GLuint numTris = (GLuint)TriangulatePolygon(planePoints, holeStarts, indices);
 
 	//Put vertices and index array into VBOs
 	glGenBuffers(1, &vertexBuffer);
@@ -565,9 +570,8 @@ GLuint WCSketchProfile::Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer) {
 	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 3 * numVerts, vertData, GL_STATIC_DRAW);
 	//Load index buffer
 	glBindBuffer(GL_ARRAY_BUFFER, indexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLint) * 3 * (numVerts-2), indexData, GL_STATIC_DRAW);
-	//Make sure to delete the index array
-	delete indexData;
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), indices.empty() ? NULL : &indices[0], GL_STATIC_DRAW);
+	//Make sure to delete the vertex array
 	delete vertData;
 /*** DEBUG ***
 	std::cout << "Triangulate Verts(" << vertexBuffer << "): " << numVerts << std::endl;
@@ -575,10 +579,10 @@ GLuint WCSketchProfile::Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer) {
 	GLfloat *data2 = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_READ_ONLY);
 	for (int i=0; i<numVerts; i++) printf("\t%d V: %f %f %f\n", i, data2[i*3], data2[i*3+1], data2[i*3+2]);
 	glUnmapBuffer(GL_ARRAY_BUFFER);
-	std::cout << "Triangulate Index(" << indexBuffer << "): " << numVerts-2 << std::endl;
+	std::cout << "Triangulate Index(" << indexBuffer << "): " << numTris << std::endl;
 	glBindBuffer(GL_ARRAY_BUFFER, indexBuffer);	
 	GLint *data3 = (GLint*)glMapBuffer(GL_ARRAY_BUFFER, GL_READ_ONLY);
-	for (int i=0; i<numVerts-2; i++) printf("\t%d I: %d %d %d\n", i, data3[i*3], data3[i*3+1], data3[i*3+2]);
+	for (GLuint i=0; i<numTris; i++) printf("\t%d I: %d %d %d\n", i, data3[i*3], data3[i*3+1], data3[i*3+2]);
 	glUnmapBuffer(GL_ARRAY_BUFFER);
 /*** DEBUG ***/
 	//Return to unbound state
@@ -590,7 +594,7 @@ GLuint WCSketchProfile::Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer) {
 		CLOGGER_ERROR(WCLogManager::RootLogger(), "WCSketchProfile::Triangulate - Unspecified GL Error.");
 	}
 	//Return the number of triangles
-	return numVerts - 2;
+	return numTris;
 }
 
 
@@ -134,7 +134,8 @@ public:
 	inline void BoundaryList(const bool &detailed, std::list<WCVector4> &outputList,				//!< Output list of boundary points
 												const WPFloat &tol=NURBSCURVE_LENGTH_ACCURACY) { 
 												return BuildBoundaryList(this->_curveList, outputList, detailed, tol); }
-	GLuint Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer);									//!< Triangulate the profile (if possible)
+	GLuint Triangulate(GLuint &vertexBuffer, GLuint &indexBuffer,									//!< Triangulate the profile (if possible)
+												const std::list<WCSketchProfile*> &holes=std::list<WCSketchProfile*>());
 
 	//Overloaded Operators
 	bool operator==(const WCSketchProfile &profile);												//!< Equality operator
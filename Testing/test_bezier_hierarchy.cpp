@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * Copyright (c) 2007, 2008, CerroKai Development
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of CerroKai Development nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <gtest/gtest.h>
+#include <Geometry/bezier_hierarchy.h>
+#include <Geometry/nurbs_curve.h>
+#include <Geometry/nurbs_surface.h>
+#include <Geometry/ray.h>
+#include <algorithm>
+
+
+/***********************************************~***************************************************/
+
+
+static WCNurbsCurve* _HierarchyTestHalfCircle(const WPFloat &z) {
+	WPFloat w = sqrt(0.5);
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(2.0, 0.0, z, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, z, w) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, z, 1.0) );
+	controlPoints.push_back( WCVector4(-2.0, 2.0, z, w) );
+	controlPoints.push_back( WCVector4(-2.0, 0.0, z, 1.0) );
+	WPFloat kp[] = { 0.0, 0.0, 0.0, 0.5, 0.5, 1.0, 1.0, 1.0 };
+	return new WCNurbsCurve(NULL, 2, controlPoints, WCNurbsMode::Custom(), std::vector<WPFloat>(kp, kp + 8));
+}
+
+
+static WCNurbsSurface* _HierarchyTestWave(void) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<5; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, sin((WPFloat)(u * v)), 1.0) );
+	return new WCNurbsSurface(NULL, 3, 3, 5, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+}
+
+
+static bool _HierarchyTestByStart(const WSBezierPiece &a, const WSBezierPiece &b) {
+	return (a.uMin < b.uMin) || ((a.uMin == b.uMin) && (a.vMin < b.vMin));
+}
+
+
+/***********************************************~***************************************************/
+
+
+// Tests that curve pieces tile the parameter range and sit inside their node boxes.
+TEST(WCBezierHierarchyTest, CurvePieces) {
+	WCNurbsCurve *curve = _HierarchyTestHalfCircle(0.0);
+	const WCBezierHierarchy *coarse = curve->Hierarchy(0.1);
+	ASSERT_TRUE(coarse != NULL);
+	WPUInt coarseCount = coarse->NumberPieces();
+	const WCBezierHierarchy *fine = curve->Hierarchy(0.0001);
+	ASSERT_TRUE(fine != NULL);
+	EXPECT_GT(fine->NumberPieces(), coarseCount);
+	EXPECT_EQ(fine, curve->Hierarchy(0.0001));
+	//Pieces end to end from 0 to 1
+	std::vector<WSBezierPiece> pieces;
+	for (WPUInt i=0; i<fine->NumberPieces(); i++) pieces.push_back(fine->Piece(i));
+	std::sort(pieces.begin(), pieces.end(), _HierarchyTestByStart);
+	EXPECT_NEAR(0.0, pieces.front().uMin, 1e-12);
+	EXPECT_NEAR(1.0, pieces.back().uMax, 1e-12);
+	for (WPUInt i=1; i<pieces.size(); i++) EXPECT_NEAR(pieces.at(i-1).uMax, pieces.at(i).uMin, 1e-12);
+	//Every leaf box holds its pieces, and the root holds the curve
+	for (WPUInt n=0; n<fine->NumberNodes(); n++) {
+		const WSBezierNode &node = fine->Node(n);
+		for (WPUInt i=node.first; i<node.first+node.count; i++)
+			for (WPUInt k=0; k<3; k++) {
+				EXPECT_LE(node.lo[k], fine->Piece(i).lo[k]);
+				EXPECT_GE(node.hi[k], fine->Piece(i).hi[k]);
+			}
+	}
+	for (WPUInt i=0; i<=16; i++) {
+		WCVector4 pt = curve->Evaluate((WPFloat)i / 16.0);
+		EXPECT_LE(fine->Node(0).lo[0] - 1e-12, pt.I());
+		EXPECT_GE(fine->Node(0).hi[1] + 1e-12, pt.J());
+	}
+	//Changing the curve rebuilds the hierarchy
+	curve->ApplyTranslation(WCVector4(0.0, 0.0, 1.0, 0.0));
+	const WCBezierHierarchy *moved = curve->Hierarchy(0.0001);
+	ASSERT_TRUE(moved != NULL);
+	EXPECT_NEAR(1.0, moved->Node(0).lo[2], 1e-12);
+	delete curve;
+}
+
+
+// Tests ray picking of curves and surfaces through the hierarchy.
+TEST(WCBezierHierarchyTest, HitTest) {
+	WCNurbsCurve *curve = _HierarchyTestHalfCircle(0.0);
+	WCVector4 down(0.0, 0.0, -1.0, 0.0);
+	WPFloat w = sqrt(0.5);
+	EXPECT_EQ(curve, curve->HitTest(WCRay(WCVector4(0.0, 2.0, 5.0, 1.0), down), 0.01));
+	EXPECT_EQ(curve, curve->HitTest(WCRay(WCVector4(2.0 * w, 2.0 * w + 0.005, 5.0, 1.0), down), 0.01));
+	EXPECT_TRUE(curve->HitTest(WCRay(WCVector4(0.0, 0.0, 5.0, 1.0), down), 0.01) == NULL);
+	EXPECT_TRUE(curve->HitTest(WCRay(WCVector4(0.0, 2.1, 5.0, 1.0), down), 0.01) == NULL);
+	//Pointing away misses
+	EXPECT_TRUE(curve->HitTest(WCRay(WCVector4(0.0, 2.0, 5.0, 1.0), WCVector4(0.0, 0.0, 1.0, 0.0)), 0.01) == NULL);
+	delete curve;
+
+	WCNurbsSurface *surface = _HierarchyTestWave();
+	EXPECT_EQ(surface, surface->HitTest(WCRay(WCVector4(2.0, 2.0, 10.0, 1.0), down), 0.001));
+	EXPECT_EQ(surface, surface->HitTest(WCRay(WCVector4(0.5, 3.7, -10.0, 1.0), WCVector4(0.0, 0.0, 1.0, 0.0)), 0.001));
+	EXPECT_TRUE(surface->HitTest(WCRay(WCVector4(5.0, 2.0, 10.0, 1.0), down), 0.001) == NULL);
+	EXPECT_TRUE(surface->HitTest(WCRay(WCVector4(2.0, 2.0, 10.0, 1.0), WCVector4(1.0, 0.0, 0.0, 0.0)), 0.001) == NULL);
+	delete surface;
+}
+
+
+// Tests closest point distances and parameters against known values.
+TEST(WCBezierHierarchyTest, Distance) {
+	WCNurbsCurve *curve = _HierarchyTestHalfCircle(0.0);
+	const WCBezierHierarchy *hierarchy = curve->Hierarchy(0.0001);
+	WPFloat u, v;
+	EXPECT_NEAR(3.0, hierarchy->Distance(WCVector4(0.0, 5.0, 0.0, 1.0), u, v), 0.001);
+	EXPECT_NEAR(0.5, u, 0.01);
+	EXPECT_NEAR(1.0, hierarchy->Distance(WCVector4(-3.0, 0.0, 0.0, 1.0), u, v), 0.001);
+	EXPECT_NEAR(1.0, u, 0.01);
+	delete curve;
+
+	WCNurbsSurface *surface = _HierarchyTestWave();
+	hierarchy = surface->Hierarchy(0.0001);
+	ASSERT_TRUE(hierarchy != NULL);
+	EXPECT_TRUE(hierarchy->IsSurface());
+	for (WPUInt i=1; i<8; i++) {
+		WCVector4 pt = surface->Evaluate((WPFloat)i / 8.0, 1.0 - (WPFloat)i / 9.0);
+		EXPECT_LT(hierarchy->Distance(pt, u, v), 0.001);
+		WCVector4 near = surface->Evaluate(u, v);
+		EXPECT_LT((near - pt).Magnitude(), 0.01);
+	}
+	//Off the surface, against a dense sampling
+	WCVector4 point(1.3, 0.4, 2.0, 1.0);
+	WPFloat sampled = 1.0e10;
+	for (WPUInt j=0; j<=100; j++)
+		for (WPUInt i=0; i<=100; i++) {
+			WCVector4 pt = surface->Evaluate((WPFloat)i / 100.0, (WPFloat)j / 100.0);
+			sampled = STDMIN(sampled, (pt - point).Magnitude());
+		}
+	EXPECT_NEAR(sampled, hierarchy->Distance(point, u, v), 0.001);
+	EXPECT_NEAR(sampled, (surface->Evaluate(u, v) - point).Magnitude(), 0.001);
+	delete surface;
+}
+
+
+// Tests the broad phase between crossing and separated curves.
+TEST(WCBezierHierarchyTest, Overlaps) {
+	WCNurbsCurve *arc = _HierarchyTestHalfCircle(0.0);
+	WCNurbsCurve *above = _HierarchyTestHalfCircle(5.0);
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(0.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(0.0, 3.0, 0.0, 1.0) );
+	WCNurbsCurve *line = new WCNurbsCurve(NULL, 1, controlPoints, WCNurbsMode::Default(), std::vector<WPFloat>());
+	const WCBezierHierarchy *a = arc->Hierarchy(0.0001);
+	const WCBezierHierarchy *b = line->Hierarchy(0.0001);
+	ASSERT_TRUE((a != NULL) && (b != NULL));
+	std::vector< std::pair<WPUInt,WPUInt> > pairs;
+	a->Overlaps(*b, 0.0, pairs);
+	ASSERT_FALSE(pairs.empty());
+	//Every candidate is near the crossing at the top of the arc
+	for (WPUInt i=0; i<pairs.size(); i++) {
+		EXPECT_LE(a->Piece(pairs.at(i).first).uMin, 0.5 + 0.05);
+		EXPECT_GE(a->Piece(pairs.at(i).first).uMax, 0.5 - 0.05);
+	}
+	pairs.clear();
+	a->Overlaps(*above->Hierarchy(0.0001), 0.1, pairs);
+	EXPECT_TRUE(pairs.empty());
+	a->Overlaps(*above->Hierarchy(0.0001), 5.0, pairs);
+	EXPECT_FALSE(pairs.empty());
+	delete arc;
+	delete above;
+	delete line;
+}
+
+
+/***********************************************~***************************************************/
+
@@ -0,0 +1,214 @@
+/*******************************************************************************
+ * Copyright (c) 2007, 2008, CerroKai Development
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of CerroKai Development nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ********************************************************************************/
+
+
+
+/*** Included Header Files ***/
+#include <gtest/gtest.h>
+#include <Geometry/geometric_algorithms.h>
+
+
+/*** Locally Defined Values ***/
+#define GEOMALGTEST_TOLERANCE			1.0e-9
+
+
+/***********************************************~***************************************************/
+
+
+static void _Loop(std::vector<WPFloat> &points, const WPFloat &cx, const WPFloat &cy, const WPFloat &radius,
+	const WPFloat &wave, const WPUInt &count, const bool &clockwise) {
+	//Wavy circle, optionally wound clockwise
+	WPFloat angle, r;
+	for (WPUInt i=0; i<count; i++) {
+		angle = 2.0 * M_PI * (WPFloat)i / (WPFloat)count;
+		if (clockwise) angle = -angle;
+		r = radius * (1.0 + wave * cos(angle * 12.0));
+		points.push_back(cx + r * cos(angle));
+		points.push_back(cy + r * sin(angle));
+	}
+}
+
+
+static WPFloat _Area(const std::vector<WPFloat> &points, const std::vector<GLuint> &triangles, WPUInt &flipped) {
+	//Signed area of the triangles, counting those wound against the majority
+	WPFloat area = 0.0, a;
+	WPUInt positive = 0;
+	for (WPUInt i=0; i<triangles.size(); i+=3) {
+		const WPFloat *p0 = &points[triangles[i]*2], *p1 = &points[triangles[i+1]*2], *p2 = &points[triangles[i+2]*2];
+		a = 0.5 * ((p1[0] - p0[0]) * (p2[1] - p0[1]) - (p2[0] - p0[0]) * (p1[1] - p0[1]));
+		if (a > 0.0) positive++;
+		area += a;
+	}
+	flipped = STDMIN(positive, (WPUInt)triangles.size() / 3 - positive);
+	return area;
+}
+
+
+static WPFloat _LoopArea(const std::vector<WPFloat> &points, const WPUInt &start, const WPUInt &end) {
+	WPFloat area = 0.0;
+	for (WPUInt i=start, j=end-1; i<end; j=i++)
+		area += 0.5 * (points[j*2] * points[i*2+1] - points[i*2] * points[j*2+1]);
+	return area;
+}
+
+
+// Tests a square with a square hole, in both windings.
+TEST(WCGeometricAlgorithmsTest, TriangulateWithHole) {
+	WPFloat outer[] = { 0.0, 0.0,  4.0, 0.0,  4.0, 4.0,  0.0, 4.0 };
+	WPFloat inner[] = { 1.0, 1.0,  1.0, 3.0,  3.0, 3.0,  3.0, 1.0 };
+	std::vector<WPFloat> points(outer, outer + 8);
+	points.insert(points.end(), inner, inner + 8);
+	std::vector<WPUInt> holes(1, 4);
+	std::vector<GLuint> triangles;
+	WPUInt flipped;
+	EXPECT_EQ((WPUInt)8, TriangulatePolygon(points, holes, triangles));
+	EXPECT_EQ((WPUInt)24, triangles.size());
+	EXPECT_NEAR(12.0, _Area(points, triangles, flipped), GEOMALGTEST_TOLERANCE);
+	EXPECT_EQ((WPUInt)0, flipped);
+	//A clockwise outer loop gives clockwise triangles
+	std::vector<WPFloat> reversed;
+	for (WPUInt i=4; i>0; i--) reversed.insert(reversed.end(), &outer[(i-1)*2], &outer[(i-1)*2] + 2);
+	reversed.insert(reversed.end(), inner, inner + 8);
+	EXPECT_EQ((WPUInt)8, TriangulatePolygon(reversed, holes, triangles));
+	EXPECT_NEAR(-12.0, _Area(reversed, triangles, flipped), GEOMALGTEST_TOLERANCE);
+	EXPECT_EQ((WPUInt)0, flipped);
+	//Degenerate input
+	EXPECT_EQ((WPUInt)0, TriangulatePolygon(std::vector<WPFloat>(outer, outer + 4), std::vector<WPUInt>(), triangles));
+	EXPECT_TRUE(triangles.empty());
+}
+
+
+// Tests a concave comb that the old ear clipper walked quadratically.
+TEST(WCGeometricAlgorithmsTest, TriangulateComb) {
+	std::vector<WPFloat> points;
+	WPUInt teeth = 50, i;
+	for (i=0; i<teeth; i++) {
+		points.push_back((WPFloat)i * 2.0);
+		points.push_back(10.0);
+		points.push_back((WPFloat)i * 2.0 + 1.0);
+		points.push_back(10.0);
+		points.push_back((WPFloat)i * 2.0 + 1.0);
+		points.push_back(1.0);
+		points.push_back((WPFloat)i * 2.0 + 2.0);
+		points.push_back(1.0);
+	}
+	points.push_back((WPFloat)teeth * 2.0);
+	points.push_back(0.0);
+	points.push_back(0.0);
+	points.push_back(0.0);
+	//Built clockwise - reverse to counter-clockwise
+	std::vector<WPFloat> ccw;
+	for (i=(WPUInt)points.size()/2; i>0; i--) ccw.insert(ccw.end(), &points[(i-1)*2], &points[(i-1)*2] + 2);
+	std::vector<GLuint> triangles;
+	WPUInt flipped, numTris = TriangulatePolygon(ccw, std::vector<WPUInt>(), triangles);
+	EXPECT_EQ((WPUInt)ccw.size() / 2 - 2, numTris);
+	EXPECT_NEAR(_LoopArea(ccw, 0, (WPUInt)ccw.size() / 2), _Area(ccw, triangles, flipped), GEOMALGTEST_TOLERANCE);
+	EXPECT_EQ((WPUInt)0, flipped);
+}
+
+
+// Tests a large wavy loop with several holes through the z-order path.
+TEST(WCGeometricAlgorithmsTest, TriangulateLarge) {
+	std::vector<WPFloat> points;
+	std::vector<WPUInt> holes;
+	_Loop(points, 0.0, 0.0, 10.0, 0.05, 20000, false);
+	for (WPUInt i=0; i<4; i++) {
+		holes.push_back((WPUInt)points.size() / 2);
+		_Loop(points, (i % 2) ? 4.0 : -4.0, (i / 2) ? 4.0 : -4.0, 2.0, 0.1, 500, false);
+	}
+	WPFloat expected = _LoopArea(points, 0, holes[0]);
+	for (WPUInt i=0; i<holes.size(); i++)
+		expected -= STDFABS(_LoopArea(points, holes[i], (i + 1 < holes.size()) ? holes[i+1] : (WPUInt)points.size() / 2));
+	std::vector<GLuint> triangles;
+	WPUInt flipped, numTris = TriangulatePolygon(points, holes, triangles);
+	//Every hole adds two triangles through its bridge
+	EXPECT_EQ((WPUInt)points.size() / 2 - 2 + 2 * holes.size(), numTris);
+	EXPECT_NEAR(expected, _Area(points, triangles, flipped), 1.0e-6);
+	EXPECT_EQ((WPUInt)0, flipped);
+}
+
+
+// Tests that orientation near a line matches the exact sign where the plain formula breaks down.
+TEST(WCGeometricAlgorithmsTest, Orient2DNearDegenerate) {
+	WPFloat step = ldexp(1.0, -53), px, py, naive;
+	WPUInt naiveWrong = 0;
+	for (int i=0; i<32; i++) {
+		for (int j=0; j<32; j++) {
+			px = 0.5 + i * step;
+			py = 0.5 + j * step;
+			//Left of the line y = x exactly when j > i
+			int expected = (j > i) ? 1 : ((j < i) ? -1 : 0);
+			WPFloat orient = Orient2D(12.0, 12.0, 24.0, 24.0, px, py);
+			EXPECT_EQ(expected, (orient > 0.0) ? 1 : ((orient < 0.0) ? -1 : 0));
+			naive = (24.0 - 12.0) * (py - 12.0) - (24.0 - 12.0) * (px - 12.0);
+			if ((naive > 0.0) != (expected > 0)) naiveWrong++;
+		}
+	}
+	//The grid is meant to defeat the unfiltered determinant
+	EXPECT_LT((WPUInt)0, naiveWrong);
+	//Sided helpers follow the same sign
+	EXPECT_TRUE(IsOnRight2D(12.0, 12.0, 24.0, 24.0, 0.5 + step, 0.5));
+	EXPECT_FALSE(IsOnRight2D(12.0, 12.0, 24.0, 24.0, 0.5, 0.5 + step));
+}
+
+
+// Tests in-circle signs for cocircular and nearly cocircular points.
+TEST(WCGeometricAlgorithmsTest, InCircle2D) {
+	WPFloat c = 1048576.0;
+	EXPECT_EQ(0.0, InCircle2D(c + 1.0, c, c, c + 1.0, c - 1.0, c, c, c - 1.0));
+	EXPECT_LT(0.0, InCircle2D(c + 1.0, c, c, c + 1.0, c - 1.0, c, c, c - 1.0 + ldexp(1.0, -30)));
+	EXPECT_GT(0.0, InCircle2D(c + 1.0, c, c, c + 1.0, c - 1.0, c, c, c - 1.0 - ldexp(1.0, -30)));
+	//The exact path agrees with the filter on easy input
+	EXPECT_LT(0.0, InCircle2DExact(1.0, 0.0, 0.0, 1.0, -1.0, 0.0, 0.0, 0.0));
+	EXPECT_GT(0.0, Orient2DExact(0.0, 0.0, 0.0, 1.0, 1.0, 0.0));
+}
+
+
+// Tests segment intersection for crossing, touching, overlapping and disjoint segments.
+TEST(WCGeometricAlgorithmsTest, SegmentsIntersect2D) {
+	EXPECT_TRUE(SegmentsIntersect2D(0.0, 0.0, 2.0, 2.0, 0.0, 2.0, 2.0, 0.0));
+	EXPECT_TRUE(SegmentsIntersect2D(0.0, 0.0, 2.0, 0.0, 1.0, 0.0, 1.0, 3.0));
+	EXPECT_TRUE(SegmentsIntersect2D(0.0, 0.0, 2.0, 0.0, 1.0, 0.0, 3.0, 0.0));
+	EXPECT_FALSE(SegmentsIntersect2D(0.0, 0.0, 2.0, 0.0, 3.0, 0.0, 4.0, 0.0));
+	EXPECT_FALSE(SegmentsIntersect2D(0.0, 0.0, 2.0, 0.0, 1.0, 0.1, 1.0, 3.0));
+}
+
+
+// Tests that the hull drops interior, collinear and repeated points and winds clockwise to the low point.
+TEST(WCGeometricAlgorithmsTest, ConvexHull2D) {
+	std::list<WCVector4> points;
+	WPFloat coords[] = { 1.0, 1.0,  2.0, 0.0,  0.0, 2.0,  2.0, 2.0,  0.0, 0.0,  1.0, 0.0,  2.0, 1.0,  0.0, 0.0,  1.0, 2.0,  0.5, 1.5 };
+	for (WPUInt i=0; i<10; i++) points.push_back(WCVector4(coords[i*2], coords[i*2+1], 0.0, 1.0));
+	std::list<WCVector4> hull = ConvexHull2D(points);
+	ASSERT_EQ((WPUInt)4, hull.size());
+	WPFloat expected[] = { 0.0, 2.0,  2.0, 2.0,  2.0, 0.0,  0.0, 0.0 };
+	WPUInt i = 0;
+	for (std::list<WCVector4>::iterator iter = hull.begin(); iter != hull.end(); iter++, i++) {
+		EXPECT_EQ(expected[i*2], (*iter).I());
+		EXPECT_EQ(expected[i*2+1], (*iter).J());
+	}
+}
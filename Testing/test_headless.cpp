@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright (c) 2007, 2008, CerroKai Development
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of CerroKai Development nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ********************************************************************************/
+
+
+
+/*** Included Header Files ***/
+#include <gtest/gtest.h>
+#include <Kernel/wildcat_kernel.h>
+#include <Scene/scene.h>
+#include <Geometry/geometry_context.h>
+#include <PartDesign/part.h>
+#include <PartDesign/part_body.h>
+
+
+/***********************************************~***************************************************/
+
+
+// Tests that a headless kernel builds a part document with no GL, UI or toolbar state.
+TEST(WCHeadlessTest, PartDocument) {
+	ASSERT_TRUE(WCWildcatKernel::Initialize(false, WCLoggerLevel::Error(), "", true));
+	EXPECT_TRUE(WCWildcatKernel::IsHeadless());
+	EXPECT_TRUE(WCWildcatKernel::Context() == NULL);
+
+	WCPart *part = dynamic_cast<WCPart*>(WCWildcatKernel::CreateDocument(".wildPart", "Headless", ""));
+	ASSERT_TRUE(part != NULL);
+	//Scene is software only
+	WCScene *scene = part->Scene();
+	ASSERT_TRUE(scene != NULL);
+	EXPECT_TRUE(scene->IsHeadless());
+	EXPECT_TRUE(scene->ShaderManager() == NULL);
+	EXPECT_TRUE(scene->TextureManager() == NULL);
+	EXPECT_TRUE(scene->GeometryContext() != NULL);
+	EXPECT_EQ((GLuint)0, scene->ProgramFromName("scn_basiclight"));
+	EXPECT_TRUE(scene->TextureFromName("part32") == NULL);
+	//No UI layers, tree view or toolbars
+	EXPECT_TRUE(part->UserInterfaceLayer() == NULL);
+	EXPECT_TRUE(part->BackgroundLayer() == NULL);
+	EXPECT_TRUE(part->TreeView() == NULL);
+	EXPECT_TRUE(part->ToolbarManager() == NULL);
+	//Initial features still exist
+	EXPECT_TRUE(part->FeatureFromName("xy plane") != NULL);
+	EXPECT_TRUE(part->FeatureFromName("yz plane") != NULL);
+	EXPECT_TRUE(part->FeatureFromName("zx plane") != NULL);
+	ASSERT_TRUE(part->Body() != NULL);
+	EXPECT_EQ(std::string("PartBody"), part->Body()->GetName());
+
+	EXPECT_TRUE(WCWildcatKernel::Terminate());
+}
+
+
+/***********************************************~***************************************************/
+
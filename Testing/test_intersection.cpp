@@ -0,0 +1,379 @@
+/*******************************************************************************
+ * Copyright (c) 2007, 2008, CerroKai Development
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of CerroKai Development nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <gtest/gtest.h>
+#include <Geometry/geometric_intersection.h>
+#include <Geometry/geometric_point.h>
+#include <Geometry/geometric_line.h>
+#include <Geometry/nurbs_curve.h>
+#include <Geometry/nurbs_surface.h>
+
+
+/***********************************************~***************************************************/
+
+
+static WCNurbsCurve* _IntersectionTestHalfCircle(void) {
+	WPFloat w = sqrt(0.5);
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(-2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(-2.0, 0.0, 0.0, 1.0) );
+	WPFloat kp[] = { 0.0, 0.0, 0.0, 0.5, 0.5, 1.0, 1.0, 1.0 };
+	return new WCNurbsCurve(NULL, 2, controlPoints, WCNurbsMode::Custom(), std::vector<WPFloat>(kp, kp + 8));
+}
+
+
+static WCNurbsCurve* _IntersectionTestLine(const WCVector4 &begin, const WCVector4 &end) {
+	std::vector<WCVector4> controlPoints;
+	//Straight quadratic - degree one curves carry no knot vector
+	controlPoints.push_back(begin);
+	controlPoints.push_back((begin + end) * 0.5);
+	controlPoints.push_back(end);
+	return new WCNurbsCurve(NULL, 2, controlPoints, WCNurbsMode::Bezier(), std::vector<WPFloat>());
+}
+
+
+static WCNurbsSurface* _IntersectionTestWave(void) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<5; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, sin((WPFloat)(u * v)), 1.0) );
+	return new WCNurbsSurface(NULL, 3, 3, 5, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+}
+
+
+//Flat quadratic patch through three corners
+static WCNurbsSurface* _IntersectionTestPlane(const WCVector4 &origin, const WCVector4 &uEdge, const WCVector4 &vEdge) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<3; v++)
+		for (WPUInt u=0; u<3; u++)
+			controlPoints.push_back(origin + uEdge * (0.5 * u) + vEdge * (0.5 * v));
+	return new WCNurbsSurface(NULL, 2, 2, 3, 3, controlPoints, WCNurbsMode::Bezier(), WCNurbsMode::Bezier());
+}
+
+
+/***********************************************~***************************************************/
+
+
+// Tests single, double and missed crossings of a circular arc and a line.
+TEST(WCCurveIntersectionTest, Crossings) {
+	WCNurbsCurve *arc = _IntersectionTestHalfCircle();
+	WCNurbsCurve *vertical = _IntersectionTestLine(WCVector4(0.0, -1.0, 0.0, 1.0), WCVector4(0.0, 3.0, 0.0, 1.0));
+	WCNurbsCurve *horizontal = _IntersectionTestLine(WCVector4(-3.0, 1.0, 0.0, 1.0), WCVector4(3.0, 1.0, 0.0, 1.0));
+	WCNurbsCurve *above = _IntersectionTestLine(WCVector4(-3.0, 3.0, 0.0, 1.0), WCVector4(3.0, 3.0, 0.0, 1.0));
+	std::vector<WCIntersectionResult> results;
+	//Crossing at the top of the arc
+	ASSERT_EQ(1u, CurveCurveIntersection(arc, vertical, 0.0001, 0, results));
+	EXPECT_EQ(IntersectPoint, results[0].type);
+	EXPECT_NEAR(0.5, results[0].leftParam.I(), 1e-6);
+	EXPECT_NEAR(0.75, results[0].rightParam.I(), 1e-6);
+	EXPECT_FALSE(results[0].leftBoundary);
+	EXPECT_TRUE(results[0].object == NULL);
+	//Two crossings at x = -/+ sqrt(3), ordered along the arc
+	results.clear();
+	ASSERT_EQ(2u, CurveCurveIntersection(arc, horizontal, 0.0001, 0, results));
+	WCVector4 first = arc->Evaluate(results[0].leftParam.I());
+	WCVector4 second = arc->Evaluate(results[1].leftParam.I());
+	EXPECT_NEAR(sqrt(3.0), first.I(), 1e-6);
+	EXPECT_NEAR(-sqrt(3.0), second.I(), 1e-6);
+	EXPECT_NEAR(first.I(), horizontal->Evaluate(results[0].rightParam.I()).I(), 1e-6);
+	//Clear miss appends nothing
+	results.clear();
+	EXPECT_EQ(0u, CurveCurveIntersection(arc, above, 0.0001, 0, results));
+	EXPECT_TRUE(results.empty());
+	//List interface agrees and creates points on request
+	std::list<WCIntersectionResult> list = GeometricIntersection(arc, horizontal, 0.0001, INTERSECT_GEN_POINTS);
+	ASSERT_EQ(2u, list.size());
+	for (std::list<WCIntersectionResult>::iterator iter = list.begin(); iter != list.end(); iter++) {
+		EXPECT_TRUE((*iter).object != NULL);
+		delete (*iter).object;
+	}
+	delete arc;
+	delete vertical;
+	delete horizontal;
+	delete above;
+}
+
+
+// Tests tangential contact, boundary hits and boundary culling.
+TEST(WCCurveIntersectionTest, TangentAndBoundary) {
+	WCNurbsCurve *arc = _IntersectionTestHalfCircle();
+	WCNurbsCurve *tangent = _IntersectionTestLine(WCVector4(-1.0, 2.0, 0.0, 1.0), WCVector4(1.0, 2.0, 0.0, 1.0));
+	WCNurbsCurve *base = _IntersectionTestLine(WCVector4(-3.0, 0.0, 0.0, 1.0), WCVector4(3.0, 0.0, 0.0, 1.0));
+	std::vector<WCIntersectionResult> results;
+	//Line touching the top of the arc
+	ASSERT_EQ(1u, CurveCurveIntersection(arc, tangent, 0.0001, 0, results));
+	EXPECT_NEAR(0.5, results[0].leftParam.I(), 0.01);
+	EXPECT_NEAR(0.5, results[0].rightParam.I(), 0.01);
+	//Base line passes through both arc end points
+	results.clear();
+	ASSERT_EQ(2u, CurveCurveIntersection(arc, base, 0.0001, 0, results));
+	EXPECT_TRUE(results[0].leftBoundary);
+	EXPECT_FALSE(results[0].rightBoundary);
+	EXPECT_TRUE(results[1].leftBoundary);
+	results.clear();
+	EXPECT_EQ(0u, CurveCurveIntersection(arc, base, 0.0001, INTERSECT_CULL_BOUNDARY, results));
+	delete arc;
+	delete tangent;
+	delete base;
+}
+
+
+// Tests that coincident curves, including degree one polylines, give a single overlap.
+TEST(WCCurveIntersectionTest, Overlap) {
+	WCNurbsCurve *arc = _IntersectionTestHalfCircle();
+	WCNurbsCurve *copy = _IntersectionTestHalfCircle();
+	std::vector<WCIntersectionResult> results;
+	EXPECT_EQ(0u, CurveCurveIntersection(arc, arc, 0.0001, 0, results));
+	ASSERT_EQ(1u, CurveCurveIntersection(arc, copy, 0.0001, INTERSECT_GEN_CURVES, results));
+	EXPECT_EQ(IntersectCurve, results[0].type);
+	EXPECT_NEAR(0.0, results[0].leftParam.I(), 0.01);
+	EXPECT_NEAR(1.0, results[0].leftParam.J(), 0.01);
+	//Overlap curve runs along the arc
+	WCNurbsCurve *overlap = dynamic_cast<WCNurbsCurve*>(results[0].object);
+	ASSERT_TRUE(overlap != NULL);
+	for (WPUInt i=0; i<=8; i++) {
+		WPFloat u = (WPFloat)i / 8.0;
+		EXPECT_NEAR(2.0, overlap->Evaluate(u).Distance(WCVector4(0.0, 0.0, 0.0, 1.0)), 1e-6);
+	}
+	EXPECT_NEAR(0.0, overlap->Evaluate(0.0).Distance(WCVector4(2.0, 0.0, 0.0, 1.0)), 0.001);
+	EXPECT_NEAR(0.0, overlap->Evaluate(1.0).Distance(WCVector4(-2.0, 0.0, 0.0, 1.0)), 0.001);
+	delete overlap;
+	//Quarter arc along the first half of the half circle
+	std::vector<WCVector4> controlPoints = arc->ControlPoints();
+	controlPoints.resize(3);
+	WCNurbsCurve *quarter = new WCNurbsCurve(NULL, 2, controlPoints, WCNurbsMode::Bezier(), std::vector<WPFloat>());
+	results.clear();
+	ASSERT_EQ(1u, CurveCurveIntersection(arc, quarter, 0.0001, INTERSECT_GEN_CURVES, results));
+	EXPECT_EQ(IntersectCurve, results[0].type);
+	EXPECT_NEAR(0.0, results[0].leftParam.I(), 0.01);
+	EXPECT_NEAR(0.5, results[0].leftParam.J(), 0.01);
+	overlap = dynamic_cast<WCNurbsCurve*>(results[0].object);
+	ASSERT_TRUE(overlap != NULL);
+	EXPECT_NEAR(0.0, overlap->Evaluate(1.0).Distance(WCVector4(0.0, 2.0, 0.0, 1.0)), 0.001);
+	delete overlap;
+	delete quarter;
+	delete arc;
+	delete copy;
+	//Degree one polylines sharing their middle leg merge too
+	std::vector<WCVector4> leftPoints, rightPoints;
+	leftPoints.push_back( WCVector4(0.0, 0.0, 0.0, 1.0) );
+	leftPoints.push_back( WCVector4(1.0, 0.0, 0.0, 1.0) );
+	leftPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	leftPoints.push_back( WCVector4(3.0, 1.0, 0.0, 1.0) );
+	rightPoints.push_back( WCVector4(1.0, -1.0, 0.0, 1.0) );
+	rightPoints.push_back( WCVector4(1.0, 0.0, 0.0, 1.0) );
+	rightPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	rightPoints.push_back( WCVector4(2.0, 1.0, 0.0, 1.0) );
+	WCNurbsCurve *leftPolyline = new WCNurbsCurve(NULL, 1, leftPoints, WCNurbsMode::Default(), std::vector<WPFloat>());
+	WCNurbsCurve *rightPolyline = new WCNurbsCurve(NULL, 1, rightPoints, WCNurbsMode::Default(), std::vector<WPFloat>());
+	results.clear();
+	ASSERT_EQ(1u, CurveCurveIntersection(leftPolyline, rightPolyline, 0.0001, INTERSECT_GEN_CURVES, results));
+	EXPECT_EQ(IntersectCurve, results[0].type);
+	EXPECT_NEAR(1.0 / 3.0, results[0].leftParam.I(), 0.01);
+	EXPECT_NEAR(2.0 / 3.0, results[0].leftParam.J(), 0.01);
+	overlap = dynamic_cast<WCNurbsCurve*>(results[0].object);
+	ASSERT_TRUE(overlap != NULL);
+	EXPECT_EQ(1u, overlap->Degree());
+	EXPECT_NEAR(0.0, overlap->ControlPoints().front().Distance(WCVector4(1.0, 0.0, 0.0, 1.0)), 0.001);
+	EXPECT_NEAR(0.0, overlap->ControlPoints().back().Distance(WCVector4(2.0, 0.0, 0.0, 1.0)), 0.001);
+	delete overlap;
+	delete leftPolyline;
+	delete rightPolyline;
+}
+
+
+// Tests boundary flags and boundary culling on overlaps that reach the curve ends.
+TEST(WCCurveIntersectionTest, OverlapBoundary) {
+	WCNurbsCurve *first = _IntersectionTestLine(WCVector4(0.0, 0.0, 0.0, 1.0), WCVector4(2.0, 0.0, 0.0, 1.0));
+	WCNurbsCurve *second = _IntersectionTestLine(WCVector4(1.0, 0.0, 0.0, 1.0), WCVector4(3.0, 0.0, 0.0, 1.0));
+	WCNurbsCurve *inner = _IntersectionTestLine(WCVector4(0.5, 0.0, 0.0, 1.0), WCVector4(1.5, 0.0, 0.0, 1.0));
+	std::vector<WCIntersectionResult> results;
+	//End to end - the overlap runs from the start of one curve to the end of the other
+	ASSERT_EQ(1u, CurveCurveIntersection(first, second, 0.0001, 0, results));
+	EXPECT_EQ(IntersectCurve, results[0].type);
+	EXPECT_NEAR(0.5, results[0].leftParam.I(), 1e-6);
+	EXPECT_NEAR(1.0, results[0].leftParam.J(), 1e-6);
+	EXPECT_TRUE(results[0].leftBoundary);
+	EXPECT_TRUE(results[0].rightBoundary);
+	results.clear();
+	EXPECT_EQ(0u, CurveCurveIntersection(first, second, 0.0001, INTERSECT_CULL_BOUNDARY, results));
+	//Overlap inside the left curve only touches the ends of the right one
+	ASSERT_EQ(1u, CurveCurveIntersection(first, inner, 0.0001, 0, results));
+	EXPECT_EQ(IntersectCurve, results[0].type);
+	EXPECT_FALSE(results[0].leftBoundary);
+	EXPECT_TRUE(results[0].rightBoundary);
+	results.clear();
+	EXPECT_EQ(0u, CurveCurveIntersection(first, inner, 0.0001, INTERSECT_CULL_BOUNDARY, results));
+	delete first;
+	delete second;
+	delete inner;
+}
+
+
+// Tests crossings, misses and a collinear overlap of a curve and a line segment.
+TEST(WCCurveIntersectionTest, Line) {
+	WCNurbsCurve *arc = _IntersectionTestHalfCircle();
+	WCGeometricLine horizontal(WCVector4(-3.0, 1.0, 0.0, 1.0), WCVector4(3.0, 1.0, 0.0, 1.0));
+	WCGeometricLine above(WCVector4(-3.0, 3.0, 0.0, 1.0), WCVector4(3.0, 3.0, 0.0, 1.0));
+	std::vector<WCIntersectionResult> results;
+	//Two crossings at x = -/+ sqrt(3), ordered along the arc, line parameter from Begin
+	ASSERT_EQ(2u, CurveLineIntersection(arc, &horizontal, 0.0001, 0, results));
+	EXPECT_EQ(IntersectPoint, results[0].type);
+	EXPECT_NEAR(sqrt(3.0), arc->Evaluate(results[0].leftParam.I()).I(), 1e-6);
+	EXPECT_NEAR((3.0 + sqrt(3.0)) / 6.0, results[0].rightParam.I(), 1e-6);
+	EXPECT_NEAR((3.0 - sqrt(3.0)) / 6.0, results[1].rightParam.I(), 1e-6);
+	EXPECT_FALSE(results[0].leftBoundary);
+	EXPECT_FALSE(results[0].rightBoundary);
+	results.clear();
+	EXPECT_EQ(0u, CurveLineIntersection(arc, &above, 0.0001, 0, results));
+	//Straight curve lying along the middle of the line is a linear overlap
+	WCNurbsCurve *straight = _IntersectionTestLine(WCVector4(-1.0, 1.0, 0.0, 1.0), WCVector4(2.0, 1.0, 0.0, 1.0));
+	std::list<WCIntersectionResult> list = GeometricIntersection(straight, &horizontal, 0.0001, INTERSECT_GEN_LINES);
+	ASSERT_EQ(1u, list.size());
+	EXPECT_EQ(IntersectLine, list.front().type);
+	EXPECT_NEAR(0.0, list.front().leftParam.I(), 1e-6);
+	EXPECT_NEAR(1.0, list.front().leftParam.J(), 1e-6);
+	EXPECT_NEAR(2.0 / 6.0, list.front().rightParam.I(), 1e-6);
+	EXPECT_NEAR(5.0 / 6.0, list.front().rightParam.J(), 1e-6);
+	EXPECT_TRUE(list.front().leftBoundary);
+	WCGeometricLine *overlap = dynamic_cast<WCGeometricLine*>(list.front().object);
+	ASSERT_TRUE(overlap != NULL);
+	EXPECT_NEAR(0.0, overlap->Begin().Distance(WCVector4(-1.0, 1.0, 0.0, 1.0)), 1e-6);
+	EXPECT_NEAR(0.0, overlap->End().Distance(WCVector4(2.0, 1.0, 0.0, 1.0)), 1e-6);
+	delete overlap;
+	delete straight;
+	delete arc;
+}
+
+
+// Tests points and line segments against a surface.
+TEST(WCSurfaceIntersectionTest, PointAndLine) {
+	WCNurbsSurface *wave = _IntersectionTestWave();
+	//Point on the surface and point above it
+	WCVector4 onSurface = wave->Evaluate(0.3, 0.6);
+	WCGeometricPoint on(onSurface), off(onSurface + WCVector4(0.0, 0.0, 0.5, 0.0));
+	std::list<WCIntersectionResult> list = GeometricIntersection(wave, &on, 0.0001, 0);
+	ASSERT_EQ(1u, list.size());
+	EXPECT_NEAR(0.3, list.front().leftParam.I(), 1e-6);
+	EXPECT_NEAR(0.6, list.front().leftParam.J(), 1e-6);
+	EXPECT_EQ(0u, GeometricIntersection(wave, &off, 0.0001, 0).size());
+	//Vertical segment through the surface, and one that stops short
+	WCGeometricLine through(WCVector4(2.5, 1.5, -5.0, 1.0), WCVector4(2.5, 1.5, 5.0, 1.0));
+	WCGeometricLine shortLine(WCVector4(2.5, 1.5, -5.0, 1.0), WCVector4(2.5, 1.5, -3.0, 1.0));
+	std::vector<WCIntersectionResult> results;
+	ASSERT_EQ(1u, SurfaceLineIntersection(wave, &through, 0.0001, 0, results));
+	WCVector4 hit = wave->Evaluate(results[0].leftParam.I(), results[0].leftParam.J());
+	EXPECT_NEAR(2.5, hit.I(), 1e-6);
+	EXPECT_NEAR(1.5, hit.J(), 1e-6);
+	EXPECT_NEAR(hit.K(), -5.0 + 10.0 * results[0].rightParam.I(), 1e-6);
+	EXPECT_FALSE(results[0].leftBoundary);
+	EXPECT_FALSE(results[0].rightBoundary);
+	results.clear();
+	EXPECT_EQ(0u, SurfaceLineIntersection(wave, &shortLine, 0.0001, 0, results));
+	//Reversed arguments swap the parameters
+	list = GeometricIntersection(&through, wave, 0.0001, 0);
+	ASSERT_EQ(1u, list.size());
+	EXPECT_NEAR(hit.K(), -5.0 + 10.0 * list.front().leftParam.I(), 1e-6);
+	delete wave;
+}
+
+
+// Tests a curve that dips through a surface twice.
+TEST(WCSurfaceIntersectionTest, Curve) {
+	WCNurbsSurface *wave = _IntersectionTestWave();
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(0.5, 0.5, -3.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 8.0, 1.0) );
+	controlPoints.push_back( WCVector4(3.5, 3.5, -3.0, 1.0) );
+	WCNurbsCurve *arch = new WCNurbsCurve(NULL, 2, controlPoints, WCNurbsMode::Bezier(), std::vector<WPFloat>());
+	std::vector<WCIntersectionResult> results;
+	ASSERT_EQ(2u, SurfaceCurveIntersection(wave, arch, 0.0001, 0, results));
+	for (WPUInt i=0; i<results.size(); i++) {
+		EXPECT_EQ(IntersectPoint, results[i].type);
+		WCVector4 onSurface = wave->Evaluate(results[i].leftParam.I(), results[i].leftParam.J());
+		EXPECT_NEAR(0.0, onSurface.Distance(arch->Evaluate(results[i].rightParam.I())), 0.0001);
+	}
+	EXPECT_GT(fabs(results[0].rightParam.I() - results[1].rightParam.I()), 0.1);
+	//Lifted clear of the surface there is nothing
+	arch->ApplyTranslation(WCVector4(0.0, 0.0, 10.0, 0.0));
+	results.clear();
+	EXPECT_EQ(0u, SurfaceCurveIntersection(wave, arch, 0.0001, 0, results));
+	delete arch;
+	delete wave;
+}
+
+
+// Tests marching a surface-surface curve from edge to edge.
+TEST(WCSurfaceIntersectionTest, SurfaceSurface) {
+	WCNurbsSurface *wave = _IntersectionTestWave();
+	WCNurbsSurface *slice = _IntersectionTestPlane(WCVector4(2.0, -1.0, -3.0, 1.0), WCVector4(0.0, 6.0, 0.0, 0.0), WCVector4(0.0, 0.0, 6.0, 0.0));
+	std::vector<WCIntersectionResult> results;
+	ASSERT_EQ(1u, SurfaceSurfaceIntersection(wave, slice, 0.0001, INTERSECT_GEN_CURVES, results));
+	EXPECT_EQ(IntersectCurve, results[0].type);
+	EXPECT_TRUE(results[0].leftBoundary);
+	EXPECT_FALSE(results[0].rightBoundary);
+	//Runs across the wave from one v edge to the other
+	WCVector4 start = wave->Evaluate(results[0].leftParam.I(), results[0].leftParam.J());
+	WCVector4 end = wave->Evaluate(results[0].leftParam.K(), results[0].leftParam.L());
+	EXPECT_NEAR(4.0, fabs(end.J() - start.J()), 1e-6);
+	//The curve lies on both surfaces
+	WCNurbsCurve *curve = dynamic_cast<WCNurbsCurve*>(results[0].object);
+	ASSERT_TRUE(curve != NULL);
+	WPFloat u, v;
+	for (WPUInt i=0; i<=32; i++) {
+		WCVector4 pt = curve->Evaluate((WPFloat)i / 32.0);
+		EXPECT_NEAR(2.0, pt.I(), 0.001);
+		ASSERT_TRUE(wave->InvertPoint(pt, u, v));
+		EXPECT_NEAR(0.0, wave->Evaluate(u, v).Distance(pt), 0.001);
+	}
+	delete curve;
+	//Cut level with the wave, and clear above it
+	WCNurbsSurface *level = _IntersectionTestPlane(WCVector4(-1.0, -1.0, 0.3, 1.0), WCVector4(6.0, 0.0, 0.0, 0.0), WCVector4(0.0, 6.0, 0.0, 0.0));
+	WCNurbsSurface *above = _IntersectionTestPlane(WCVector4(-1.0, -1.0, 3.0, 1.0), WCVector4(6.0, 0.0, 0.0, 0.0), WCVector4(0.0, 6.0, 0.0, 0.0));
+	results.clear();
+	EXPECT_LT(0u, SurfaceSurfaceIntersection(wave, level, 0.0001, 0, results));
+	for (WPUInt i=0; i<results.size(); i++) {
+		EXPECT_NEAR(0.3, wave->Evaluate(results[i].leftParam.I(), results[i].leftParam.J()).K(), 0.0001);
+		EXPECT_NEAR(0.3, wave->Evaluate(results[i].leftParam.K(), results[i].leftParam.L()).K(), 0.0001);
+	}
+	results.clear();
+	EXPECT_EQ(0u, SurfaceSurfaceIntersection(wave, above, 0.0001, 0, results));
+	EXPECT_EQ(0u, SurfaceSurfaceIntersection(wave, wave, 0.0001, 0, results));
+	delete level;
+	delete above;
+	delete slice;
+	delete wave;
+}
+
+
+/***********************************************~***************************************************/
+
@@ -0,0 +1,1164 @@
+/*******************************************************************************
+ * Copyright (c) 2007, 2008, CerroKai Development
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of CerroKai Development nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <gtest/gtest.h>
+#include <Geometry/nurbs.h>
+#include <Geometry/nurbs_curve.h>
+#include <Geometry/nurbs_surface.h>
+#include <Geometry/trimmed_nurbs_surface.h>
+#include <Geometry/geometry_context.h>
+#include <Geometry/geometric_line.h>
+#include <Geometry/ray.h>
+#include <Utility/tessellation_cache.h>
+#include <time.h>
+#include <map>
+
+
+/*** Locally Defined Values ***/
+#define NURBSTEST_DEGREE				3
+#define NURBSTEST_NUM_CP				12
+#define NURBSTEST_BENCH_ITERATIONS		500000
+#define NURBSTEST_BENCH_LOD				100000
+
+
+/***********************************************~***************************************************/
+
+
+// The fixture for testing class WCNurbs.
+class WCNurbsTest : public testing::Test {
+protected:
+	WPFloat										*_knotPoints;
+	virtual void SetUp()						{ this->_knotPoints = WCNurbs::LoadDefaultKnotPoints(NURBSTEST_NUM_CP + NURBSTEST_DEGREE + 1, NURBSTEST_DEGREE); }
+	virtual void TearDown()						{ delete [] this->_knotPoints; }
+};
+
+
+// Tests that the workspace and allocating basis functions agree.
+TEST_F(WCNurbsTest, BasisValuesWorkspaceMatchesAllocating) {
+	WPFloat workspace[NURBS_BASIS_MAX_VALUES];
+	for (WPUInt i=0; i<=100; i++) {
+		WPFloat u = (WPFloat)i / 100.0;
+		WPUInt span = WCNurbs::FindSpan(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, u, this->_knotPoints);
+		WPFloat *ders = WCNurbs::BasisValues(span, u, NURBSTEST_DEGREE, this->_knotPoints, 2);
+		ASSERT_TRUE(WCNurbs::BasisValues(span, u, NURBSTEST_DEGREE, this->_knotPoints, 2, workspace));
+		for (WPUInt j=0; j<3*(NURBSTEST_DEGREE+1); j++) EXPECT_DOUBLE_EQ(ders[j], workspace[j]);
+		delete [] ders;
+	}
+}
+
+
+// Tests partition of unity and that the first derivatives sum to zero.
+TEST_F(WCNurbsTest, BasisValuesPartitionOfUnity) {
+	WPFloat workspace[NURBS_BASIS_MAX_VALUES];
+	for (WPUInt i=0; i<=100; i++) {
+		WPFloat u = (WPFloat)i / 100.0;
+		WPUInt span = WCNurbs::FindSpan(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, u, this->_knotPoints);
+		WCNurbs::BasisValues(span, u, NURBSTEST_DEGREE, this->_knotPoints, 1, workspace);
+		WPFloat sum = 0.0, derSum = 0.0;
+		for (WPUInt j=0; j<=NURBSTEST_DEGREE; j++) {
+			sum += workspace[j];
+			derSum += workspace[j+NURBSTEST_DEGREE+1];
+		}
+		EXPECT_NEAR(1.0, sum, 1e-10);
+		EXPECT_NEAR(0.0, derSum, 1e-9);
+	}
+}
+
+
+// Tests that degrees beyond the workspace bound are rejected.
+TEST_F(WCNurbsTest, BasisValuesRejectsLargeDegree) {
+	WPFloat workspace[NURBS_BASIS_MAX_VALUES];
+	EXPECT_FALSE(WCNurbs::BasisValues(NURBS_BASIS_MAX_DEGREE+1, 0.5, NURBS_BASIS_MAX_DEGREE+1, this->_knotPoints, 0, workspace));
+}
+
+
+// Tests that the basis cache matches direct evaluation and tracks its key.
+TEST_F(WCNurbsTest, BasisCacheMatchesDirect) {
+	WCNurbsBasisCache cache;
+	WPFloat workspace[NURBS_BASIS_MAX_VALUES];
+	EXPECT_FALSE(cache.IsValid(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, this->_knotPoints, 0.0, 1.0, 33, 1));
+	ASSERT_TRUE(cache.Build(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, this->_knotPoints, 0.0, 1.0, 33, 1));
+	EXPECT_TRUE(cache.IsValid(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, this->_knotPoints, 0.0, 1.0, 33, 1));
+	EXPECT_FALSE(cache.IsValid(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, this->_knotPoints, 0.0, 1.0, 34, 1));
+	for (WPUInt i=0; i<33; i++) {
+		WPFloat u = (WPFloat)i / 32.0;
+		WPUInt span = WCNurbs::FindSpan(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, u, this->_knotPoints);
+		EXPECT_DOUBLE_EQ(u, cache.Parameter(i));
+		EXPECT_EQ(span, cache.Span(i));
+		WCNurbs::BasisValues(span, u, NURBSTEST_DEGREE, this->_knotPoints, 1, workspace);
+		for (WPUInt j=0; j<2*(NURBSTEST_DEGREE+1); j++) EXPECT_DOUBLE_EQ(workspace[j], cache.Values(i)[j]);
+	}
+	//Moving a knot must invalidate the cache
+	this->_knotPoints[NURBSTEST_DEGREE+2] += 0.01;
+	EXPECT_FALSE(cache.IsValid(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, this->_knotPoints, 0.0, 1.0, 33, 1));
+}
+
+
+// Tests that Horner, de Casteljau and subdivision agree for every specialized degree.
+TEST_F(WCNurbsTest, BezierEvaluators) {
+	WPFloat hcp[NURBS_BASIS_MAX_ORDER*4], left[NURBS_BASIS_MAX_ORDER*4], right[NURBS_BASIS_MAX_ORDER*4];
+	WPFloat pt[4], ptDC[4], der[4], lo[4], hi[4], half[4];
+	for (WPUInt i=0; i<NURBS_BASIS_MAX_ORDER*4; i++) hcp[i] = ((i % 4) == 3) ? 1.0 + 0.25 * sin((WPFloat)i) : sin((WPFloat)i * 0.7);
+	for (WPUInt degree=1; degree<=NURBS_BASIS_MAX_DEGREE; degree++) {
+		ASSERT_TRUE(WCNurbs::SubdivideBezier(degree, hcp, 4, 0.3, left, right));
+		for (WPUInt i=0; i<=10; i++) {
+			WPFloat u = (WPFloat)i / 10.0;
+			ASSERT_TRUE(WCNurbs::EvaluateBezier(degree, hcp, 4, u, pt));
+			ASSERT_TRUE(WCNurbs::EvaluateBezierDerivative(degree, hcp, 4, u, ptDC, der));
+			WCNurbs::EvaluateBezier(degree, hcp, 4, STDMAX(0.0, u - 1e-6), lo);
+			WCNurbs::EvaluateBezier(degree, hcp, 4, STDMIN(1.0, u + 1e-6), hi);
+			for (WPUInt k=0; k<4; k++) {
+				EXPECT_NEAR(pt[k], ptDC[k], 1e-12);
+				EXPECT_NEAR(der[k], (hi[k] - lo[k]) / (STDMIN(1.0, u + 1e-6) - STDMAX(0.0, u - 1e-6)), 1e-4);
+			}
+			//Each half reproduces its part of the original
+			WCNurbs::EvaluateBezier(degree, left, 4, u, half);
+			WCNurbs::EvaluateBezier(degree, hcp, 4, 0.3 * u, pt);
+			for (WPUInt k=0; k<4; k++) EXPECT_NEAR(pt[k], half[k], 1e-12);
+			WCNurbs::EvaluateBezier(degree, right, 4, u, half);
+			WCNurbs::EvaluateBezier(degree, hcp, 4, 0.3 + 0.7 * u, pt);
+			for (WPUInt k=0; k<4; k++) EXPECT_NEAR(pt[k], half[k], 1e-12);
+		}
+	}
+	EXPECT_FALSE(WCNurbs::EvaluateBezier(0, hcp, 4, 0.5, pt));
+	EXPECT_FALSE(WCNurbs::EvaluateBezier(NURBS_BASIS_MAX_DEGREE+1, hcp, 4, 0.5, pt));
+}
+
+
+// Benchmark allocating versus workspace basis evaluation.
+TEST_F(WCNurbsTest, BasisValuesBenchmark) {
+	WPFloat workspace[NURBS_BASIS_MAX_VALUES], *ders, sumAlloc = 0.0, sumWork = 0.0, u;
+	WPUInt span, i;
+	//Time the allocating version
+	clock_t start = clock();
+	for (i=0; i<NURBSTEST_BENCH_ITERATIONS; i++) {
+		u = (WPFloat)i / NURBSTEST_BENCH_ITERATIONS;
+		span = WCNurbs::FindSpan(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, u, this->_knotPoints);
+		ders = WCNurbs::BasisValues(span, u, NURBSTEST_DEGREE, this->_knotPoints, 1);
+		sumAlloc += ders[0];
+		delete [] ders;
+	}
+	clock_t allocTime = clock() - start;
+	//Time the workspace version
+	start = clock();
+	for (i=0; i<NURBSTEST_BENCH_ITERATIONS; i++) {
+		u = (WPFloat)i / NURBSTEST_BENCH_ITERATIONS;
+		span = WCNurbs::FindSpan(NURBSTEST_NUM_CP, NURBSTEST_DEGREE, u, this->_knotPoints);
+		WCNurbs::BasisValues(span, u, NURBSTEST_DEGREE, this->_knotPoints, 1, workspace);
+		sumWork += workspace[0];
+	}
+	clock_t workTime = clock() - start;
+	//Timings go to the test report (--gtest_output), only the results are checked
+	RecordProperty("AllocatingMicroseconds", (int)(allocTime * 1000000.0 / CLOCKS_PER_SEC));
+	RecordProperty("WorkspaceMicroseconds", (int)(workTime * 1000000.0 / CLOCKS_PER_SEC));
+	EXPECT_DOUBLE_EQ(sumAlloc, sumWork);
+}
+
+
+// Tests that batched curve evaluation matches point evaluation.
+TEST(WCNurbsCurveTest, EvaluateManyMatchesEvaluate) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<NURBSTEST_NUM_CP; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), cos((WPFloat)i), 1.0) );
+	WCNurbsCurve curve(NULL, NURBSTEST_DEGREE, controlPoints, WCNurbsMode::Default());
+	//Evenly spaced range
+	WPFloat data[4 * 101];
+	curve.EvaluateMany(0.0, 1.0, 101, data);
+	for (WPUInt i=0; i<=100; i++) {
+		WCVector4 pt = curve.Evaluate((WPFloat)i / 100.0);
+		EXPECT_NEAR(pt.I(), data[i*4], 1e-10);
+		EXPECT_NEAR(pt.J(), data[i*4+1], 1e-10);
+		EXPECT_NEAR(pt.K(), data[i*4+2], 1e-10);
+	}
+	//Unordered parameter array
+	WPFloat params[] = { 0.9, 0.1, 0.5, 1.0, 0.0, 0.33 };
+	curve.EvaluateMany(params, 6, data);
+	for (WPUInt i=0; i<6; i++) {
+		WCVector4 pt = curve.Evaluate(params[i]);
+		EXPECT_NEAR(pt.I(), data[i*4], 1e-10);
+		EXPECT_NEAR(pt.J(), data[i*4+1], 1e-10);
+		EXPECT_NEAR(pt.K(), data[i*4+2], 1e-10);
+	}
+}
+
+
+// Tests that Bezier mode evaluation matches the Bernstein polynomial sum.
+TEST(WCNurbsCurveTest, EvaluateBezier) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<=3; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), cos((WPFloat)i), 1.0) );
+	WCNurbsCurve curve(NULL, 3, controlPoints, WCNurbsMode::Bezier());
+	for (WPUInt i=0; i<=10; i++) {
+		WPFloat u = (WPFloat)i / 10.0, s = 1.0 - u;
+		WPFloat b[4] = { s*s*s, 3.0*u*s*s, 3.0*u*u*s, u*u*u };
+		WCVector4 ref(0.0, 0.0, 0.0, 0.0);
+		for (WPUInt j=0; j<=3; j++) ref += controlPoints.at(j) * b[j];
+		WCVector4 pt = curve.Evaluate(u);
+		EXPECT_NEAR(ref.I(), pt.I(), 1e-12);
+		EXPECT_NEAR(ref.J(), pt.J(), 1e-12);
+		EXPECT_NEAR(ref.K(), pt.K(), 1e-12);
+	}
+}
+
+
+// Tests that a rational Bezier quarter circle stays on the circle with tangents normal to the radius.
+TEST(WCNurbsCurveTest, EvaluateRationalBezier) {
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, sqrt(2.0) / 2.0) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	WCNurbsCurve curve(NULL, 2, controlPoints, WCNurbsMode::Bezier());
+	for (WPUInt i=0; i<=20; i++) {
+		WPFloat u = (WPFloat)i / 20.0;
+		WCVector4 pt = curve.Evaluate(u);
+		EXPECT_NEAR(2.0, sqrt(pt.I() * pt.I() + pt.J() * pt.J()), 1e-12);
+		WCRay ray = curve.Tangent(u);
+		EXPECT_NEAR(pt.I(), ray.Base().I(), 1e-12);
+		EXPECT_NEAR(pt.J(), ray.Base().J(), 1e-12);
+		EXPECT_NEAR(0.0, pt.I() * ray.Direction().I() + pt.J() * ray.Direction().J(), 1e-12);
+	}
+}
+
+
+// Tests that a single Bezier patch evaluates like the equivalent clamped surface.
+TEST(WCNurbsSurfaceTest, EvaluateBezierPatch) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<3; v++)
+		for (WPUInt u=0; u<4; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, sin((WPFloat)(u + v)), 1.0 + 0.1 * (WPFloat)(u * v)) );
+	WCNurbsSurface bezier(NULL, 3, 2, 4, 3, controlPoints, WCNurbsMode::Bezier(), WCNurbsMode::Bezier());
+	WCNurbsSurface clamped(NULL, 3, 2, 4, 3, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	for (WPUInt i=0; i<=8; i++)
+		for (WPUInt j=0; j<=8; j++) {
+			WCVector4 a = bezier.Evaluate((WPFloat)i / 8.0, (WPFloat)j / 8.0);
+			WCVector4 b = clamped.Evaluate((WPFloat)i / 8.0, (WPFloat)j / 8.0);
+			EXPECT_NEAR(b.I(), a.I(), 1e-12);
+			EXPECT_NEAR(b.J(), a.J(), 1e-12);
+			EXPECT_NEAR(b.K(), a.K(), 1e-12);
+		}
+}
+
+
+// Tests that the point and partials from one basis evaluation match Evaluate and central differences.
+TEST(WCNurbsSurfaceTest, EvaluatePartials) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<6; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, sin((WPFloat)(u * v)), 1.0 + 0.1 * (WPFloat)((u + v) % 3)) );
+	WCNurbsSurface surface(NULL, 3, 2, 6, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	WPFloat h = 1e-6;
+	for (WPUInt i=1; i<8; i++)
+		for (WPUInt j=1; j<8; j++) {
+			WPFloat u = (WPFloat)i / 8.0, v = (WPFloat)j / 8.0;
+			WCVector4 derU, derV;
+			WCVector4 point = surface.EvaluatePartials(u, v, derU, derV);
+			WCVector4 expected = surface.Evaluate(u, v);
+			WCVector4 diffU = (surface.Evaluate(u + h, v) - surface.Evaluate(u - h, v)) / (2.0 * h);
+			WCVector4 diffV = (surface.Evaluate(u, v + h) - surface.Evaluate(u, v - h)) / (2.0 * h);
+			EXPECT_NEAR(expected.I(), point.I(), 1e-12);
+			EXPECT_NEAR(expected.J(), point.J(), 1e-12);
+			EXPECT_NEAR(expected.K(), point.K(), 1e-12);
+			EXPECT_NEAR(diffU.I(), derU.I(), 1e-6);
+			EXPECT_NEAR(diffU.K(), derU.K(), 1e-6);
+			EXPECT_NEAR(diffV.J(), derV.J(), 1e-6);
+			EXPECT_NEAR(diffV.K(), derV.K(), 1e-6);
+			EXPECT_NEAR(derU.K(), surface.Derivative(u, 1, v, 0).K(), 1e-12);
+			EXPECT_NEAR(derV.K(), surface.Derivative(u, 0, v, 1).K(), 1e-12);
+		}
+}
+
+
+// Tests that setting control points only dirties the curve on a real change.
+TEST(WCNurbsCurveTest, ControlPointsOnlyDirtyWhenChanged) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<NURBSTEST_NUM_CP; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), cos((WPFloat)i), 1.0) );
+	WCNurbsCurve curve(NULL, NURBSTEST_DEGREE, controlPoints, WCNurbsMode::Default());
+	curve.IsVisualDirty(false);
+	//Setting identical points leaves the curve clean
+	curve.ControlPoints(controlPoints);
+	EXPECT_FALSE(curve.IsVisualDirty());
+	//Moving a single point dirties it and updates the net
+	controlPoints.at(5) = WCVector4(5.0, 2.0, 0.0, 1.0);
+	curve.ControlPoints(controlPoints);
+	EXPECT_TRUE(curve.IsVisualDirty());
+	WCVector4 pt = curve.ControlPoints().at(5);
+	EXPECT_DOUBLE_EQ(2.0, pt.J());
+	//Wrong sized input is rejected
+	curve.IsVisualDirty(false);
+	controlPoints.pop_back();
+	curve.ControlPoints(controlPoints);
+	EXPECT_FALSE(curve.IsVisualDirty());
+}
+
+
+// Tests that batched evaluation of a rational arc stays on the circle.
+TEST(WCNurbsCurveTest, EvaluateManyRational) {
+	//Half circle of radius 2 from two quarter arcs
+	WPFloat w = sqrt(0.5);
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(-2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(-2.0, 0.0, 0.0, 1.0) );
+	WPFloat kp[] = { 0.0, 0.0, 0.0, 0.5, 0.5, 1.0, 1.0, 1.0 };
+	std::vector<WPFloat> knotPoints(kp, kp + 8);
+	WCNurbsCurve curve(NULL, 2, controlPoints, WCNurbsMode::Custom(), knotPoints);
+	GLfloat data[4 * 64];
+	curve.EvaluateMany(0.0, 1.0, 64, data);
+	for (WPUInt i=0; i<64; i++)
+		EXPECT_NEAR(2.0, sqrt(data[i*4]*data[i*4] + data[i*4+1]*data[i*4+1]), 1e-5);
+}
+
+
+// Tests that adaptive tessellation stays within the chord tolerance and spends vertices only where the curve bends.
+TEST(WCNurbsCurveTest, AdaptiveChordTolerance) {
+	//Straight line with a single bump in the middle
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<NURBSTEST_NUM_CP; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, ((i == 5) || (i == 6)) ? 1.0 : 0.0, 0.0, 1.0) );
+	WCNurbsCurve curve(NULL, NURBSTEST_DEGREE, controlPoints, WCNurbsMode::Default());
+	WPFloat tol = 0.001;
+	WPUInt count;
+	std::vector<WPFloat> params;
+	GLfloat *data = curve.GenerateAdaptiveBuffer(tol, NURBSCURVE_ADAPTIVE_ANGLE, count, &params);
+	ASSERT_EQ(count, params.size());
+	EXPECT_DOUBLE_EQ(0.0, params.front());
+	EXPECT_DOUBLE_EQ(1.0, params.back());
+	//Uniform sampling would need about length / sqrt(8 * tol * radius) everywhere
+	EXPECT_LT(count, (WPUInt)150);
+	for (WPUInt i=0; i<count; i++) {
+		//Vertices lie on the curve
+		WCVector4 pt = curve.Evaluate(params.at(i));
+		EXPECT_NEAR(pt.I(), data[i*4], 1e-5);
+		EXPECT_NEAR(pt.J(), data[i*4+1], 1e-5);
+		if (i == 0) continue;
+		EXPECT_LT(params.at(i-1), params.at(i));
+		//Sample the curve between vertices and measure the distance to the chord
+		WCVector4 p0(data[i*4-4], data[i*4-3], data[i*4-2], 1.0), p1(data[i*4], data[i*4+1], data[i*4+2], 1.0);
+		WCVector4 chord = p1 - p0;
+		for (WPUInt j=1; j<4; j++) {
+			WCVector4 d = curve.Evaluate(params.at(i-1) + (params.at(i) - params.at(i-1)) * j / 4.0) - p0;
+			d.L(0.0);
+			WPFloat t = d.DotProduct(chord) / chord.DotProduct(chord);
+			EXPECT_LT((d - chord * t).Magnitude(), 2.0 * tol);
+		}
+	}
+	curve.ReleaseBuffer(data);
+}
+
+
+// Tests that the length of a half circle converges with the adaptive polyline.
+TEST(WCNurbsCurveTest, LengthOfArc) {
+	WPFloat w = sqrt(0.5);
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(-2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(-2.0, 0.0, 0.0, 1.0) );
+	WPFloat kp[] = { 0.0, 0.0, 0.0, 0.5, 0.5, 1.0, 1.0, 1.0 };
+	std::vector<WPFloat> knotPoints(kp, kp + 8);
+	WCNurbsCurve curve(NULL, 2, controlPoints, WCNurbsMode::Custom(), knotPoints);
+	EXPECT_NEAR(2.0 * M_PI, curve.Length(0.01), 0.02);
+	EXPECT_NEAR(2.0 * M_PI, curve.Length(0.00001), 0.0001);
+}
+
+
+// Tests that degree one curves measure as their control polygon.
+TEST(WCNurbsCurveTest, LengthOfPolyline) {
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(0.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(3.0, 4.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(3.0, 4.0, 5.0, 1.0) );
+	WCNurbsCurve curve(NULL, 1, controlPoints, WCNurbsMode::Default(), std::vector<WPFloat>());
+	EXPECT_NEAR(10.0, curve.Length(1e-6), 1e-12);
+	//Each segment covers half of the parametric range
+	EXPECT_NEAR(2.5, curve.LengthAtParameter(0.25, 1e-6), 1e-12);
+	EXPECT_NEAR(7.5, curve.LengthAtParameter(0.75, 1e-6), 1e-12);
+	EXPECT_NEAR(0.25, curve.ParameterAtLength(2.5, 1e-6), 1e-12);
+	EXPECT_NEAR(0.75, curve.ParameterAtLength(7.5, 1e-6), 1e-12);
+	EXPECT_NE((WPHash)0, curve.ContentHash());
+}
+
+
+// Tests that a curve dropped to degree one keeps measuring as its control polygon.
+TEST(WCNurbsCurveTest, LengthAfterDegreeOne) {
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(0.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(3.0, 4.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(3.0, 4.0, 5.0, 1.0) );
+	controlPoints.push_back( WCVector4(3.0, 4.0, 10.0, 1.0) );
+	WCNurbsCurve curve(NULL, 2, controlPoints, WCNurbsMode::Default(), std::vector<WPFloat>());
+	curve.Length(1e-6);
+	//The old knot vector stays behind, the polyline path must still be taken
+	ASSERT_EQ((WPUInt)1, curve.Degree(1));
+	EXPECT_NEAR(15.0, curve.Length(1e-6), 1e-12);
+	EXPECT_NEAR(2.5, curve.LengthAtParameter(1.0 / 6.0, 1e-6), 1e-12);
+	EXPECT_NEAR(12.5, curve.LengthAtParameter(5.0 / 6.0, 1e-6), 1e-12);
+	EXPECT_NEAR(1.0 / 6.0, curve.ParameterAtLength(2.5, 1e-6), 1e-12);
+	EXPECT_NEAR(5.0 / 6.0, curve.ParameterAtLength(12.5, 1e-6), 1e-12);
+}
+
+
+// Tests arc length queries and reparameterization on a rational half circle.
+TEST(WCNurbsCurveTest, ArcLengthTable) {
+	WPFloat w = sqrt(0.5);
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(-2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(-2.0, 0.0, 0.0, 1.0) );
+	WPFloat kp[] = { 0.0, 0.0, 0.0, 0.5, 0.5, 1.0, 1.0, 1.0 };
+	std::vector<WPFloat> knotPoints(kp, kp + 8);
+	WCNurbsCurve curve(NULL, 2, controlPoints, WCNurbsMode::Custom(), knotPoints);
+	EXPECT_NEAR(2.0 * M_PI, curve.Length(1e-9), 1e-9);
+	EXPECT_NEAR(M_PI, curve.LengthAtParameter(0.5, 1e-9), 1e-9);
+	EXPECT_NEAR(0.5, curve.ParameterAtLength(M_PI, 1e-9), 1e-9);
+	//Round trip through an interior point
+	WPFloat s = curve.LengthAtParameter(0.3, 1e-9);
+	EXPECT_NEAR(0.3, curve.ParameterAtLength(s, 1e-9), 1e-8);
+	//Points evenly spaced by length subtend equal chords
+	std::vector<WPFloat> params = curve.ParametersByLength(9, 1e-9);
+	ASSERT_EQ((WPUInt)9, params.size());
+	WCVector4 p0 = curve.Evaluate(params.at(0)), p1;
+	WPFloat chord = 2.0 * 2.0 * sin(M_PI / 16.0);
+	for (WPUInt i=1; i<9; i++) {
+		p1 = curve.Evaluate(params.at(i));
+		EXPECT_NEAR(chord, p1.Distance(p0), 1e-7);
+		p0 = p1;
+	}
+}
+
+
+// Builds a rational half circle of radius two as two quarter arcs.
+static WCNurbsCurve* _NurbsTestHalfCircle(void) {
+	WPFloat w = sqrt(0.5);
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(-2.0, 2.0, 0.0, w) );
+	controlPoints.push_back( WCVector4(-2.0, 0.0, 0.0, 1.0) );
+	WPFloat kp[] = { 0.0, 0.0, 0.0, 0.5, 0.5, 1.0, 1.0, 1.0 };
+	return new WCNurbsCurve(NULL, 2, controlPoints, WCNurbsMode::Custom(), std::vector<WPFloat>(kp, kp + 8));
+}
+
+
+// Checks that a curve still evaluates to the given points at evenly spaced parameters.
+static void _NurbsTestSameCurve(WCNurbsCurve *curve, const std::vector<WCVector4> &points, const WPFloat &tolerance) {
+	for (WPUInt i=0; i<points.size(); i++) {
+		WCVector4 pt = curve->Evaluate((WPFloat)i / (WPFloat)(points.size() - 1));
+		EXPECT_NEAR(points.at(i).I(), pt.I(), tolerance);
+		EXPECT_NEAR(points.at(i).J(), pt.J(), tolerance);
+		EXPECT_NEAR(points.at(i).K(), pt.K(), tolerance);
+	}
+}
+
+
+// Tests that knot insertion, refinement and removal leave the curve unchanged.
+TEST(WCNurbsCurveTest, KnotInsertionAndRemoval) {
+	WCNurbsCurve *curve = _NurbsTestHalfCircle();
+	std::vector<WCVector4> points;
+	for (WPUInt i=0; i<=32; i++) points.push_back( curve->Evaluate((WPFloat)i / 32.0) );
+	WPUInt revision = curve->Revision();
+	//Multiplicity is capped at the degree
+	EXPECT_TRUE(curve->InsertKnot(0.3, 3));
+	EXPECT_EQ((WPUInt)7, curve->NumberControlPoints());
+	EXPECT_NE(revision, curve->Revision());
+	EXPECT_FALSE(curve->InsertKnot(0.3));
+	std::vector<WPFloat> insert;
+	insert.push_back(0.7);
+	insert.push_back(0.1);
+	insert.push_back(0.7);
+	EXPECT_TRUE(curve->RefineKnot(insert));
+	EXPECT_EQ((WPUInt)10, curve->NumberControlPoints());
+	EXPECT_EQ((WPUInt)13, curve->NumberKnotPoints());
+	_NurbsTestSameCurve(curve, points, 1e-12);
+	//Knots outside the domain are rejected
+	insert.assign(1, 1.0);
+	EXPECT_FALSE(curve->RefineKnot(insert));
+	//The inserted knots come back out, the original C1 joint at 0.5 does not
+	EXPECT_EQ((WPUInt)2, curve->RemoveKnot(0.7, 2, 1e-9));
+	EXPECT_EQ((WPUInt)2, curve->RemoveKnot(0.3, 2, 1e-9));
+	EXPECT_EQ((WPUInt)1, curve->RemoveKnot(0.1, 1, 1e-9));
+	EXPECT_EQ((WPUInt)0, curve->RemoveKnot(0.5, 1, 1e-9));
+	EXPECT_EQ((WPUInt)5, curve->NumberControlPoints());
+	_NurbsTestSameCurve(curve, points, 1e-12);
+	delete curve;
+}
+
+
+// Tests that degree elevation is exact and degree reduction only succeeds within tolerance.
+TEST(WCNurbsCurveTest, DegreeElevationAndReduction) {
+	WCNurbsCurve *curve = _NurbsTestHalfCircle();
+	std::vector<WCVector4> points;
+	for (WPUInt i=0; i<=32; i++) points.push_back( curve->Evaluate((WPFloat)i / 32.0) );
+	//Each quarter gains two points, the joint keeps its continuity
+	EXPECT_TRUE(curve->ElevateDegree(2));
+	EXPECT_EQ((WPUInt)4, curve->Degree());
+	EXPECT_EQ((WPUInt)9, curve->NumberControlPoints());
+	_NurbsTestSameCurve(curve, points, 1e-12);
+	EXPECT_TRUE(curve->ReduceDegree(1e-9));
+	EXPECT_TRUE(curve->ReduceDegree(1e-9));
+	EXPECT_EQ((WPUInt)2, curve->Degree());
+	EXPECT_EQ((WPUInt)5, curve->NumberControlPoints());
+	_NurbsTestSameCurve(curve, points, 1e-10);
+	delete curve;
+	//A genuine cubic can not be reduced tightly, and stays unchanged
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<NURBSTEST_NUM_CP; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), cos((WPFloat)i), 1.0) );
+	WCNurbsCurve cubic(NULL, NURBSTEST_DEGREE, controlPoints, WCNurbsMode::Default());
+	WPUInt revision = cubic.Revision();
+	EXPECT_FALSE(cubic.ReduceDegree(1e-6));
+	EXPECT_EQ((WPUInt)NURBSTEST_DEGREE, cubic.Degree());
+	EXPECT_EQ(revision, cubic.Revision());
+	//Elevation past the curve limits is refused
+	EXPECT_FALSE(cubic.ElevateDegree(NURBSCURVE_MAX_DEGREE));
+}
+
+
+// Tests that Bezier segments evaluate like the curve and are cached per revision.
+TEST(WCNurbsCurveTest, BezierSegments) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<NURBSTEST_NUM_CP; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), cos((WPFloat)i), 1.0 + 0.1 * (WPFloat)(i % 3)) );
+	WCNurbsCurve curve(NULL, NURBSTEST_DEGREE, controlPoints, WCNurbsMode::Default());
+	const WPFloat *points, *breaks;
+	WPUInt segments = curve.BezierSegments(points, breaks);
+	ASSERT_EQ((WPUInt)(NURBSTEST_NUM_CP - NURBSTEST_DEGREE), segments);
+	EXPECT_EQ(0.0, breaks[0]);
+	EXPECT_EQ(1.0, breaks[segments]);
+	WPFloat hpt[4];
+	for (WPUInt k=0; k<segments; k++) {
+		const WPFloat *segment = points + k * (NURBSTEST_DEGREE + 1) * 4;
+		for (WPUInt i=0; i<=4; i++) {
+			WPFloat t = (WPFloat)i / 4.0;
+			ASSERT_TRUE(WCNurbs::EvaluateBezier(NURBSTEST_DEGREE, segment, 4, t, hpt));
+			WCVector4 pt = curve.Evaluate(breaks[k] + t * (breaks[k+1] - breaks[k]));
+			EXPECT_NEAR(pt.I(), hpt[0] / hpt[3], 1e-12);
+			EXPECT_NEAR(pt.J(), hpt[1] / hpt[3], 1e-12);
+			EXPECT_NEAR(pt.K(), hpt[2] / hpt[3], 1e-12);
+		}
+	}
+	//Same revision reuses the extraction, a change rebuilds it
+	const WPFloat *again, *againBreaks;
+	curve.BezierSegments(again, againBreaks);
+	EXPECT_EQ(points, again);
+	curve.InsertKnot(0.5);
+	EXPECT_EQ(segments + 1, curve.BezierSegments(again, againBreaks));
+}
+
+
+// Tests that managed curve buffers are shared until the geometry changes.
+TEST(WCNurbsCurveTest, ManagedBuffersAreCached) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<NURBSTEST_NUM_CP; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), cos((WPFloat)i), 1.0) );
+	WCNurbsCurve curve(NULL, NURBSTEST_DEGREE, controlPoints, WCNurbsMode::Default());
+	WCTessellationCache *cache = WCTessellationCache::Shared();
+	cache->ResetStatistics();
+	WPUInt countA, countB;
+	GLfloat *a = curve.GenerateAdaptiveBuffer(0.001, NURBSCURVE_ADAPTIVE_ANGLE, countA, NULL, true);
+	GLfloat *b = curve.GenerateAdaptiveBuffer(0.001, NURBSCURVE_ADAPTIVE_ANGLE, countB, NULL, true);
+	EXPECT_EQ(a, b);
+	EXPECT_EQ(countA, countB);
+	EXPECT_EQ((WPUInt)1, cache->Hits());
+	curve.ReleaseBuffer(a);
+	curve.ReleaseBuffer(b);
+	//A view change (zoom) redraws but keeps the revision and the cached tessellation
+	WPUInt revision = curve.Revision();
+	curve.IsVisualDirty(true);
+	EXPECT_EQ(revision, curve.Revision());
+	a = curve.GenerateAdaptiveBuffer(0.001, NURBSCURVE_ADAPTIVE_ANGLE, countA, NULL, true);
+	EXPECT_EQ(b, a);
+	EXPECT_EQ((WPUInt)2, cache->Hits());
+	curve.ReleaseBuffer(a);
+	//Moving a control point gives a fresh tessellation
+	controlPoints.at(5) = WCVector4(5.0, 2.0, 0.0, 1.0);
+	curve.ControlPoints(controlPoints);
+	GLfloat *c = curve.GenerateAdaptiveBuffer(0.001, NURBSCURVE_ADAPTIVE_ANGLE, countA, NULL, true);
+	EXPECT_EQ((WPUInt)2, cache->Misses());
+	curve.ReleaseBuffer(c);
+}
+
+
+// Tests that a flat bicubic surface tessellates to two triangles per patch.
+TEST(WCNurbsSurfaceTest, AdaptivePlanarPatches) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<6; v++)
+		for (WPUInt u=0; u<6; u++)
+			controlPoints.push_back( WCVector4((WPFloat)(u * u), (WPFloat)v, 0.0, 1.0) );
+	WCNurbsSurface surface(NULL, 3, 3, 6, 6, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	WPUInt numVerts, numTriangles;
+	std::vector<GLfloat*> buffers = surface.GenerateAdaptiveBuffers(0.001, numVerts, numTriangles);
+	ASSERT_EQ((WPUInt)4, buffers.size());
+	EXPECT_EQ((WPUInt)16, numVerts);
+	EXPECT_EQ((WPUInt)18, numTriangles);
+	surface.ReleaseBuffers(buffers);
+}
+
+
+// Tests that a control point edit only rewrites the vertices of the patches it touches.
+TEST(WCNurbsSurfaceTest, AdaptiveDirtyPatches) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<12; v++)
+		for (WPUInt u=0; u<12; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, 0.0, 1.0) );
+	WCNurbsSurface surface(NULL, 3, 3, 12, 12, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	WPUInt numVerts, numTriangles, fullVerts, fullTriangles, count = 0, i, k, c;
+	std::vector<WPUInt> runs;
+	//First mesh is always a full one (9 x 9 flat patches)
+	std::vector<GLfloat*> mesh = surface.UpdateAdaptiveBuffers(0.001, numVerts, numTriangles, runs);
+	ASSERT_EQ((WPUInt)4, mesh.size());
+	EXPECT_TRUE(runs.empty());
+	EXPECT_EQ((WPUInt)100, numVerts);
+	surface.IsVisualDirty(false);
+	//Sliding a point within the plane keeps every segment count - only the 4 x 4 patches it touches are redone
+	controlPoints.at(6 * 12 + 6) = WCVector4(6.2, 6.1, 0.0, 1.0);
+	surface.ControlPoints(controlPoints);
+	std::vector<GLfloat*> moved = surface.UpdateAdaptiveBuffers(0.001, numVerts, numTriangles, runs);
+	ASSERT_EQ((WPUInt)2, moved.size());
+	ASSERT_FALSE(runs.empty());
+	EXPECT_EQ((WPUInt)100, numVerts);
+	EXPECT_EQ((WPUInt)162, numTriangles);
+	//Patch the old mesh with the runs - it must match a fresh full mesh
+	for (k=0; k<runs.size(); k+=2) {
+		for (i=0; i<runs[k+1]; i++, count++) {
+			for (c=0; c<4; c++) {
+				mesh[NURBSSURFACE_VERTEX_BUFFER][(runs[k] + i) * 4 + c] = moved[NURBSSURFACE_VERTEX_BUFFER][count * 4 + c];
+				mesh[NURBSSURFACE_NORMAL_BUFFER][(runs[k] + i) * 4 + c] = moved[NURBSSURFACE_NORMAL_BUFFER][count * 4 + c];
+			}
+		}
+	}
+	EXPECT_EQ((WPUInt)25, count);
+	std::vector<GLfloat*> full = surface.GenerateAdaptiveBuffers(0.001, fullVerts, fullTriangles);
+	ASSERT_EQ(numVerts, fullVerts);
+	for (i=0; i<numVerts * 4; i++) {
+		EXPECT_FLOAT_EQ(full[NURBSSURFACE_VERTEX_BUFFER][i], mesh[NURBSSURFACE_VERTEX_BUFFER][i]);
+		EXPECT_FLOAT_EQ(full[NURBSSURFACE_NORMAL_BUFFER][i], mesh[NURBSSURFACE_NORMAL_BUFFER][i]);
+	}
+	surface.ReleaseBuffers(full);
+	delete [] moved[NURBSSURFACE_VERTEX_BUFFER];
+	delete [] moved[NURBSSURFACE_NORMAL_BUFFER];
+	surface.IsVisualDirty(false);
+	//Lifting it out of the plane refines the patches, so the whole mesh comes back
+	controlPoints.at(6 * 12 + 6) = WCVector4(6.2, 6.1, 1.0, 1.0);
+	surface.ControlPoints(controlPoints);
+	moved = surface.UpdateAdaptiveBuffers(0.001, numVerts, numTriangles, runs);
+	ASSERT_EQ((WPUInt)4, moved.size());
+	EXPECT_TRUE(runs.empty());
+	EXPECT_GT(numVerts, (WPUInt)100);
+	surface.ReleaseBuffers(moved);
+	surface.ReleaseBuffers(mesh);
+}
+
+
+// Tests that a bumped surface mesh is watertight and within the chord tolerance.
+TEST(WCNurbsSurfaceTest, AdaptiveCrackFree) {
+	WPFloat tolerance = 0.002;
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<7; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, (u == 5) && (v == 3) ? 2.0 : 0.0, 1.0) );
+	WCNurbsSurface surface(NULL, 3, 3, 7, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	WPUInt numVerts, numTriangles;
+	std::vector<GLfloat*> buffers = surface.GenerateAdaptiveBuffers(tolerance, numVerts, numTriangles);
+	ASSERT_EQ((WPUInt)4, buffers.size());
+	GLfloat *verts = buffers.at(NURBSSURFACE_VERTEX_BUFFER);
+	GLfloat *tex = buffers.at(NURBSSURFACE_TEXCOORD_BUFFER);
+	GLuint *index = (GLuint*)buffers.at(NURBSSURFACE_INDEX_BUFFER);
+	//Flat patches far from the bump stay coarse while the bump is refined
+	EXPECT_GT(numTriangles, (WPUInt)(4 * 2 * 2));
+	EXPECT_LT(numTriangles, (WPUInt)(4 * 2 * 64 * 64));
+	//Every interior edge is shared by exactly two oppositely wound triangles
+	std::map<std::pair<GLuint,GLuint>,WPUInt> edges;
+	for (WPUInt i=0; i<numTriangles; i++)
+		for (WPUInt k=0; k<3; k++)
+			edges[std::make_pair(index[i*3+k], index[i*3+(k+1)%3])]++;
+	std::map<std::pair<GLuint,GLuint>,WPUInt>::iterator iter;
+	for (iter=edges.begin(); iter!=edges.end(); iter++) {
+		EXPECT_EQ((WPUInt)1, iter->second);
+		if (edges.count(std::make_pair(iter->first.second, iter->first.first)) == 0) {
+			GLfloat *a = tex + iter->first.first * 2, *b = tex + iter->first.second * 2;
+			bool onBoundary = ((a[0] == b[0]) && ((a[0] == 0.0) || (a[0] == 1.0))) ||
+							  ((a[1] == b[1]) && ((a[1] == 0.0) || (a[1] == 1.0)));
+			EXPECT_TRUE(onBoundary);
+		}
+	}
+	//The surface at each triangle's centroid lies near the triangle's plane
+	for (WPUInt i=0; i<numTriangles; i++) {
+		GLuint i0 = index[i*3], i1 = index[i*3+1], i2 = index[i*3+2];
+		WCVector4 p0(verts[i0*4], verts[i0*4+1], verts[i0*4+2], 0.0);
+		WCVector4 p1(verts[i1*4], verts[i1*4+1], verts[i1*4+2], 0.0);
+		WCVector4 p2(verts[i2*4], verts[i2*4+1], verts[i2*4+2], 0.0);
+		WCVector4 normal = (p1 - p0).CrossProduct(p2 - p0);
+		normal.Normalize(true);
+		WPFloat u = (tex[i0*2] + tex[i1*2] + tex[i2*2]) / 3.0;
+		WPFloat v = (tex[i0*2+1] + tex[i1*2+1] + tex[i2*2+1]) / 3.0;
+		WCVector4 pt = surface.Evaluate(u, v);
+		pt.L(0.0);
+		EXPECT_LT(fabs((pt - p0).DotProduct(normal)), 2.0 * tolerance);
+	}
+	surface.ReleaseBuffers(buffers);
+}
+
+
+// Tests that a reopened store warm loads the same mesh for an identical surface.
+TEST(WCNurbsSurfaceTest, StoreWarmLoad) {
+	std::string path = std::string("nurbs_test.wildPart") + TESSELLATIONSTORE_EXTENSION;
+	remove(path.c_str());
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<5; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, sin((WPFloat)(u * v)), 1.0) );
+	WPUInt coldVerts, coldTriangles, warmVerts, warmTriangles;
+	WCTessellationStore::Activate(new WCTessellationStore(path));
+	WCNurbsSurface *cold = new WCNurbsSurface(NULL, 3, 3, 5, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	std::vector<GLfloat*> coldBuffers = cold->GenerateAdaptiveBuffers(0.01, coldVerts, coldTriangles, true);
+	//A new session with a new object only shares the content
+	WCTessellationStore::Activate(new WCTessellationStore(path));
+	EXPECT_EQ((WPUInt)1, WCTessellationStore::Active()->Count());
+	WCNurbsSurface *warm = new WCNurbsSurface(NULL, 3, 3, 5, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	EXPECT_EQ(cold->ContentHash(), warm->ContentHash());
+	std::vector<GLfloat*> warmBuffers = warm->GenerateAdaptiveBuffers(0.01, warmVerts, warmTriangles, true);
+	EXPECT_EQ((WPUInt)1, WCTessellationStore::Active()->Hits());
+	ASSERT_EQ(coldVerts, warmVerts);
+	ASSERT_EQ(coldTriangles, warmTriangles);
+	for (WPUInt i=0; i<coldVerts * 4; i++) EXPECT_EQ(coldBuffers.at(0)[i], warmBuffers.at(0)[i]);
+	for (WPUInt i=0; i<coldTriangles * 3; i++) EXPECT_EQ(coldBuffers.at(3)[i], warmBuffers.at(3)[i]);
+	cold->ReleaseBuffers(coldBuffers);
+	warm->ReleaseBuffers(warmBuffers);
+	//Any control point change gives a new hash
+	controlPoints.at(7).K(controlPoints.at(7).K() + 0.001);
+	warm->ControlPoints(controlPoints);
+	EXPECT_NE(cold->ContentHash(), warm->ContentHash());
+	delete cold;
+	delete warm;
+	WCTessellationStore::Activate(NULL);
+	remove(path.c_str());
+}
+
+
+// Builds a bilinear face from a corner and its two edges (outward normal is edgeU x edgeV).
+static WCNurbsSurface* _NurbsTestFace(const WCVector4 &corner, const WCVector4 &edgeU, const WCVector4 &edgeV) {
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back(corner);
+	controlPoints.push_back(corner + edgeU);
+	controlPoints.push_back(corner + edgeV);
+	controlPoints.push_back(corner + edgeU + edgeV);
+	return new WCNurbsSurface(NULL, 1, 1, 2, 2, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+}
+
+
+// Tests area, volume, centroid and inertia of a rational sphere.
+TEST(WCNurbsSurfaceTest, SphereMassProperties) {
+	WPFloat r = 2.0, w = sqrt(0.5);
+	//Circle in U, half circle meridian in V
+	WPFloat cu[9][3] = { {1,0,1}, {1,1,w}, {0,1,1}, {-1,1,w}, {-1,0,1}, {-1,-1,w}, {0,-1,1}, {1,-1,w}, {1,0,1} };
+	WPFloat cv[5][3] = { {0,-r,1}, {r,-r,w}, {r,0,1}, {r,r,w}, {0,r,1} };
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<9; u++)
+			controlPoints.push_back( WCVector4(1.0 + cv[v][0] * cu[u][0], -1.0 + cv[v][0] * cu[u][1], 0.5 + cv[v][1], cu[u][2] * cv[v][2]) );
+	WPFloat kpu[] = { 0.0, 0.0, 0.0, 0.25, 0.25, 0.5, 0.5, 0.75, 0.75, 1.0, 1.0, 1.0 };
+	WPFloat kpv[] = { 0.0, 0.0, 0.0, 0.5, 0.5, 1.0, 1.0, 1.0 };
+	WCNurbsSurface sphere(NULL, 2, 2, 9, 5, controlPoints, WCNurbsMode::Custom(), WCNurbsMode::Custom(),
+		std::vector<WPFloat>(kpu, kpu + 12), std::vector<WPFloat>(kpv, kpv + 8));
+	EXPECT_NEAR(4.0 * M_PI * r * r, sphere.Area(1e-8), 1e-6);
+	WSMassProperties props = sphere.MassProperties(1e-8);
+	props.Finish();
+	WPFloat volume = 4.0 / 3.0 * M_PI * r * r * r;
+	EXPECT_NEAR(volume, props.volume, 1e-6);
+	EXPECT_NEAR(1.0, props.centroid.I(), 1e-8);
+	EXPECT_NEAR(-1.0, props.centroid.J(), 1e-8);
+	EXPECT_NEAR(0.5, props.centroid.K(), 1e-8);
+	for (WPUInt i=0; i<3; i++) {
+		EXPECT_NEAR(0.4 * volume * r * r, props.inertia[i], 1e-5);
+		EXPECT_NEAR(0.0, props.inertia[3+i], 1e-6);
+	}
+}
+
+
+// Tests that trim loops clip the integrated region and that points invert onto the surface.
+TEST(WCNurbsSurfaceTest, TrimmedArea) {
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(0.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, 1.0) );
+	WCGeometricLine a(WCVector4(0.2, 0.2, 0.0, 1.0), WCVector4(1.8, 0.2, 0.0, 1.0));
+	WCGeometricLine b(WCVector4(1.8, 0.2, 0.0, 1.0), WCVector4(0.2, 1.8, 0.0, 1.0));
+	WCGeometricLine c(WCVector4(0.2, 1.8, 0.0, 1.0), WCVector4(0.2, 0.2, 0.0, 1.0));
+	WCTrimProfile profile;
+	profile.push_back(std::make_pair((WCGeometricCurve*)&a, true));
+	profile.push_back(std::make_pair((WCGeometricCurve*)&b, true));
+	profile.push_back(std::make_pair((WCGeometricCurve*)&c, true));
+	WCTrimmedNurbsSurface surface(NULL, std::list<WCTrimProfile>(1, profile), 1, 1, 2, 2, controlPoints,
+		WCNurbsMode::Default(), WCNurbsMode::Default());
+	WPFloat u, v;
+	ASSERT_TRUE(surface.InvertPoint(WCVector4(1.5, 0.5, 0.3, 1.0), u, v));
+	EXPECT_NEAR(0.75, u, 1e-10);
+	EXPECT_NEAR(0.25, v, 1e-10);
+	EXPECT_NEAR(1.28, surface.Area(1e-6), 0.005);
+}
+
+
+// Tests the CPU trim mask against the trimmed area fraction.
+TEST(WCNurbsSurfaceTest, TrimMask) {
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(0.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, 1.0) );
+	WCGeometricLine a(WCVector4(0.2, 0.2, 0.0, 1.0), WCVector4(1.8, 0.2, 0.0, 1.0));
+	WCGeometricLine b(WCVector4(1.8, 0.2, 0.0, 1.0), WCVector4(0.2, 1.8, 0.0, 1.0));
+	WCGeometricLine c(WCVector4(0.2, 1.8, 0.0, 1.0), WCVector4(0.2, 0.2, 0.0, 1.0));
+	WCTrimProfile profile;
+	profile.push_back(std::make_pair((WCGeometricCurve*)&a, true));
+	profile.push_back(std::make_pair((WCGeometricCurve*)&b, true));
+	profile.push_back(std::make_pair((WCGeometricCurve*)&c, true));
+	WCTrimmedNurbsSurface surface(NULL, std::list<WCTrimProfile>(1, profile), 1, 1, 2, 2, controlPoints,
+		WCNurbsMode::Default(), WCNurbsMode::Default());
+	std::vector<GLubyte> mask;
+	EXPECT_FALSE(surface.GenerateTrimMask(0, 64, 1e-3, mask));
+	ASSERT_TRUE(surface.GenerateTrimMask(64, 80, 1e-3, mask));
+	ASSERT_EQ((size_t)(64 * 80), mask.size());
+	WPUInt inside = 0;
+	for (WPUInt i=0; i<mask.size(); i++) if (mask[i] != 0) inside++;
+	EXPECT_NEAR(0.32, (WPFloat)inside / mask.size(), 0.01);
+	//Texel centres at (u,v) = (0.3,0.3) and (0.85,0.1125) are kept, (0.8,0.8) and (0.05,0.5) are not
+	EXPECT_EQ(255, mask[24 * 64 + 19]);
+	EXPECT_EQ(255, mask[8 * 64 + 54]);
+	EXPECT_EQ(0, mask[63 * 64 + 51]);
+	EXPECT_EQ(0, mask[39 * 64 + 3]);
+}
+
+
+// Tests that the constrained tessellation covers exactly the trimmed region, holes included.
+TEST(WCNurbsSurfaceTest, TrimmedTessellation) {
+	std::vector<WCVector4> controlPoints;
+	controlPoints.push_back( WCVector4(0.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 0.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(0.0, 2.0, 0.0, 1.0) );
+	controlPoints.push_back( WCVector4(2.0, 2.0, 0.0, 1.0) );
+	WCVector4 outer[4] = { WCVector4(0.2, 0.2, 0.0, 1.0), WCVector4(1.8, 0.2, 0.0, 1.0), WCVector4(1.8, 1.8, 0.0, 1.0), WCVector4(0.2, 1.8, 0.0, 1.0) };
+	WCVector4 inner[4] = { WCVector4(0.8, 0.8, 0.0, 1.0), WCVector4(0.8, 1.2, 0.0, 1.0), WCVector4(1.2, 1.2, 0.0, 1.0), WCVector4(1.2, 0.8, 0.0, 1.0) };
+	std::vector<WCGeometricLine*> lines;
+	WCTrimProfile outerProfile, innerProfile;
+	for (WPUInt i=0; i<4; i++) {
+		lines.push_back(new WCGeometricLine(outer[i], outer[(i+1)%4]));
+		outerProfile.push_back(std::make_pair((WCGeometricCurve*)lines.back(), true));
+		lines.push_back(new WCGeometricLine(inner[i], inner[(i+1)%4]));
+		innerProfile.push_back(std::make_pair((WCGeometricCurve*)lines.back(), true));
+	}
+	std::list<WCTrimProfile> profiles;
+	profiles.push_back(outerProfile);
+	profiles.push_back(innerProfile);
+	std::vector<WCTrimmedNurbsSurface*> surfaces;
+	surfaces.push_back(new WCTrimmedNurbsSurface(NULL, profiles, 1, 1, 2, 2, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default()));
+	surfaces.push_back(new WCTrimmedNurbsSurface(NULL, std::list<WCTrimProfile>(1, outerProfile), 1, 1, 2, 2, controlPoints,
+		WCNurbsMode::Default(), WCNurbsMode::Default()));
+	std::vector<WPUInt> numTriangles;
+	std::vector< std::vector<GLfloat*> > buffers = WCTrimmedNurbsSurface::GenerateTessellation(surfaces, 1e-3, numTriangles);
+	ASSERT_EQ((size_t)2, buffers.size());
+	WPFloat expected[2] = { 2.4, 2.56 };
+	for (WPUInt s=0; s<2; s++) {
+		ASSERT_EQ((size_t)4, buffers.at(s).size());
+		GLfloat *vData = buffers.at(s).at(NURBSSURFACE_VERTEX_BUFFER), *nData = buffers.at(s).at(NURBSSURFACE_NORMAL_BUFFER);
+		GLuint *iData = (GLuint*)buffers.at(s).at(NURBSSURFACE_INDEX_BUFFER);
+		ASSERT_GT(numTriangles.at(s), (WPUInt)0);
+		//Sum the facet areas - every facet winds against the surface normal like the untrimmed mesh
+		WPFloat area = 0.0;
+		for (WPUInt t=0; t<numTriangles.at(s); t++) {
+			WCVector4 a(vData[iData[t*3]*4], vData[iData[t*3]*4+1], vData[iData[t*3]*4+2], 0.0);
+			WCVector4 b(vData[iData[t*3+1]*4], vData[iData[t*3+1]*4+1], vData[iData[t*3+1]*4+2], 0.0);
+			WCVector4 c(vData[iData[t*3+2]*4], vData[iData[t*3+2]*4+1], vData[iData[t*3+2]*4+2], 0.0);
+			WCVector4 cross = (b - a).CrossProduct(c - a);
+			EXPECT_LT(cross.K() * nData[iData[t*3]*4+2], 0.0);
+			area += 0.5 * cross.Magnitude();
+		}
+		EXPECT_NEAR(expected[s], area, 1e-5);
+		surfaces.at(s)->ReleaseBuffers(buffers.at(s));
+		delete surfaces.at(s);
+	}
+	for (WPUInt i=0; i<lines.size(); i++) delete lines.at(i);
+}
+
+
+// Tests that oriented faces sum to the mass properties of a closed cube.
+TEST(WCNurbsSurfaceTest, CubeMassProperties) {
+	WCVector4 o(1.0, 2.0, 3.0, 1.0), x(1.0, 0.0, 0.0, 0.0), y(0.0, 1.0, 0.0, 0.0), z(0.0, 0.0, 1.0, 0.0);
+	std::vector<WCNurbsSurface*> surfaces;
+	surfaces.push_back(_NurbsTestFace(o, z, y));
+	surfaces.push_back(_NurbsTestFace(o + x, y, z));
+	surfaces.push_back(_NurbsTestFace(o, x, z));
+	surfaces.push_back(_NurbsTestFace(o + y, z, x));
+	surfaces.push_back(_NurbsTestFace(o, y, x));
+	//Last face is built inward and marked as reversed
+	surfaces.push_back(_NurbsTestFace(o + z, y, x));
+	WSMassProperties props;
+	for (WPUInt i=0; i<surfaces.size(); i++) {
+		EXPECT_NEAR(1.0, surfaces.at(i)->Area(1e-9), 1e-12);
+		props.Add(surfaces.at(i)->MassProperties(1e-9), i != 5);
+	}
+	props.Finish();
+	EXPECT_NEAR(6.0, props.area, 1e-12);
+	EXPECT_NEAR(1.0, props.volume, 1e-12);
+	EXPECT_NEAR(1.5, props.centroid.I(), 1e-12);
+	EXPECT_NEAR(2.5, props.centroid.J(), 1e-12);
+	EXPECT_NEAR(3.5, props.centroid.K(), 1e-12);
+	for (WPUInt i=0; i<3; i++) {
+		EXPECT_NEAR(1.0 / 6.0, props.inertia[i], 1e-10);
+		EXPECT_NEAR(0.0, props.inertia[3+i], 1e-10);
+	}
+	for (WPUInt i=0; i<surfaces.size(); i++) delete surfaces.at(i);
+}
+
+
+// Tests knot refinement, degree changes and Bezier extraction on a rational surface.
+TEST(WCNurbsSurfaceTest, KnotRefinementAndBezierPatches) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<4; v++)
+		for (WPUInt u=0; u<4; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, sin((WPFloat)(u + 2*v)), 1.0 + 0.1 * (WPFloat)(u * v)) );
+	WCNurbsSurface surface(NULL, 2, 2, 4, 4, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	std::vector<WCVector4> points;
+	for (WPUInt i=0; i<=8; i++)
+		for (WPUInt j=0; j<=8; j++)
+			points.push_back( surface.Evaluate((WPFloat)i / 8.0, (WPFloat)j / 8.0) );
+	EXPECT_TRUE(surface.InsertKnotU(0.3));
+	std::vector<WPFloat> insert;
+	insert.push_back(0.2);
+	insert.push_back(0.6);
+	EXPECT_TRUE(surface.RefineKnotV(insert));
+	EXPECT_TRUE(surface.ElevateDegree(1, 1));
+	EXPECT_EQ((WPUInt)3, surface.DegreeU());
+	EXPECT_EQ((WPUInt)8, surface.NumberControlPointsU());
+	EXPECT_EQ((WPUInt)10, surface.NumberControlPointsV());
+	for (WPUInt i=0; i<=8; i++)
+		for (WPUInt j=0; j<=8; j++) {
+			WCVector4 pt = surface.Evaluate((WPFloat)i / 8.0, (WPFloat)j / 8.0);
+			EXPECT_NEAR(points.at(i*9+j).I(), pt.I(), 1e-12);
+			EXPECT_NEAR(points.at(i*9+j).J(), pt.J(), 1e-12);
+			EXPECT_NEAR(points.at(i*9+j).K(), pt.K(), 1e-12);
+		}
+	//Each patch matches the surface over its own parameter box
+	const WPFloat *patches, *breaksU, *breaksV;
+	WPUInt numU, numV;
+	ASSERT_EQ((WPUInt)12, surface.BezierPatches(patches, breaksU, breaksV, numU, numV));
+	ASSERT_EQ((WPUInt)3, numU);
+	WPFloat row[16], hpt[4];
+	const WPFloat *patch = patches + (1*numU + 2) * 16 * 4;
+	for (WPUInt i=0; i<=4; i++)
+		for (WPUInt j=0; j<=4; j++) {
+			WPFloat s = (WPFloat)i / 4.0, t = (WPFloat)j / 4.0;
+			for (WPUInt b=0; b<4; b++) WCNurbs::EvaluateBezier(3, patch + b*16, 4, s, row + b*4);
+			WCNurbs::EvaluateBezier(3, row, 4, t, hpt);
+			WCVector4 pt = surface.Evaluate(breaksU[2] + s * (breaksU[3] - breaksU[2]), breaksV[1] + t * (breaksV[2] - breaksV[1]));
+			EXPECT_NEAR(pt.I(), hpt[0] / hpt[3], 1e-12);
+			EXPECT_NEAR(pt.J(), hpt[1] / hpt[3], 1e-12);
+			EXPECT_NEAR(pt.K(), hpt[2] / hpt[3], 1e-12);
+		}
+	//Reduction recovers the biquadratic shape and the inserted knots come back out
+	EXPECT_TRUE(surface.ReduceDegree(true, true, 1e-9));
+	EXPECT_EQ((WPUInt)2, surface.DegreeV());
+	EXPECT_EQ((WPUInt)1, surface.RemoveKnotU(0.3, 1, 1e-9));
+	EXPECT_EQ((WPUInt)1, surface.RemoveKnotV(0.6, 1, 1e-9));
+	EXPECT_EQ((WPUInt)1, surface.RemoveKnotV(0.2, 1, 1e-9));
+	EXPECT_EQ((WPUInt)4, surface.NumberControlPointsU());
+	EXPECT_EQ((WPUInt)4, surface.NumberControlPointsV());
+	for (WPUInt i=0; i<=8; i++)
+		for (WPUInt j=0; j<=8; j++)
+			EXPECT_NEAR(points.at(i*9+j).K(), surface.Evaluate((WPFloat)i / 8.0, (WPFloat)j / 8.0).K(), 1e-9);
+}
+
+
+// Tests single and batched point inversion onto a rational arc, including off the ends and out of plane.
+TEST(WCNurbsCurveTest, PointInversion) {
+	WCNurbsCurve *curve = _NurbsTestHalfCircle();
+	const WPUInt count = 1000;
+	std::vector<WPFloat> points(count * 4), params(count);
+	for (WPUInt i=0; i<count; i++) {
+		WPFloat angle = M_PI * (i + 0.5) / count;
+		points[i*4] = 3.0 * cos(angle);
+		points[i*4+1] = 3.0 * sin(angle);
+		points[i*4+2] = (i % 2) ? 0.5 : 0.0;
+		points[i*4+3] = 1.0;
+	}
+	ASSERT_TRUE(curve->InvertPoints(&points[0], count, &params[0]));
+	for (WPUInt i=0; i<count; i++) {
+		WCVector4 pt = curve->Evaluate(params[i]);
+		EXPECT_NEAR(points[i*4] * 2.0 / 3.0, pt.I(), 1e-8);
+		EXPECT_NEAR(points[i*4+1] * 2.0 / 3.0, pt.J(), 1e-8);
+	}
+	//Beyond the ends clamps to them
+	std::pair<WCVector4,WPFloat> result = curve->PointInversion(WCVector4(3.0, -1.0, 0.0, 1.0));
+	EXPECT_NEAR(0.0, result.second, 1e-12);
+	result = curve->PointInversion(WCVector4(0.0, 3.0, 1.0, 1.0));
+	EXPECT_NEAR(0.5, result.second, 1e-8);
+	EXPECT_NEAR(2.0, result.first.J(), 1e-8);
+	delete curve;
+}
+
+
+// Tests that batched surface inversion recovers the parameters of points on the surface.
+TEST(WCNurbsSurfaceTest, PointInversion) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<5; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, 0.5 * sin((WPFloat)(u * v)), 1.0 + 0.1 * (WPFloat)((u + v) % 3)) );
+	WCNurbsSurface surface(NULL, 3, 3, 5, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	const WPUInt side = 40;
+	std::vector<WPFloat> points(side * side * 4), uv(side * side * 2);
+	for (WPUInt j=0; j<side; j++)
+		for (WPUInt i=0; i<side; i++) {
+			WCVector4 pt = surface.Evaluate((i + 0.5) / side, (j + 0.5) / side);
+			points[(j*side+i)*4] = pt.I();
+			points[(j*side+i)*4+1] = pt.J();
+			points[(j*side+i)*4+2] = pt.K();
+			points[(j*side+i)*4+3] = 1.0;
+		}
+	ASSERT_TRUE(surface.InvertPoints(&points[0], side * side, &uv[0]));
+	for (WPUInt j=0; j<side; j++)
+		for (WPUInt i=0; i<side; i++) {
+			EXPECT_NEAR((i + 0.5) / side, uv[(j*side+i)*2], 1e-7);
+			EXPECT_NEAR((j + 0.5) / side, uv[(j*side+i)*2+1], 1e-7);
+		}
+	//Single inversion matches, and points past an edge clamp onto it
+	WPFloat u, v;
+	ASSERT_TRUE(surface.InvertPoint(WCVector4(points[0], points[1], points[2], 1.0), u, v));
+	EXPECT_NEAR(uv[0], u, 1e-12);
+	EXPECT_NEAR(uv[1], v, 1e-12);
+	std::pair<WCVector4,WCVector4> result = surface.PointInversion(WCVector4(6.0, 2.0, 0.0, 1.0));
+	EXPECT_NEAR(1.0, result.second.I(), 1e-12);
+}
+
+
+// Tests that global interpolation passes through every data point and keeps the ends.
+TEST(WCNurbsCurveTest, GlobalInterpolation) {
+	std::vector<WCVector4> points;
+	for (WPUInt i=0; i<12; i++)
+		points.push_back( WCVector4(0.5 * (WPFloat)i, sin(0.5 * (WPFloat)i), 0.1 * (WPFloat)(i % 3), 1.0) );
+	WCNurbsCurve *curve = WCNurbsCurve::GlobalInterpolation(NULL, points, 3);
+	ASSERT_TRUE(curve != NULL);
+	EXPECT_NEAR(0.0, curve->Evaluate(0.0).Distance(points.front()), 1e-10);
+	EXPECT_NEAR(0.0, curve->Evaluate(1.0).Distance(points.back()), 1e-10);
+	for (WPUInt i=0; i<points.size(); i++)
+		EXPECT_NEAR(0.0, curve->PointInversion(points.at(i)).first.Distance(points.at(i)), 1e-8);
+	delete curve;
+	//Too few points for the degree lowers it, a single point is rejected
+	points.resize(3);
+	curve = WCNurbsCurve::GlobalInterpolation(NULL, points, 3);
+	ASSERT_TRUE(curve != NULL);
+	EXPECT_EQ((WPUInt)2, curve->Degree());
+	EXPECT_NEAR(0.0, curve->PointInversion(points.at(1)).first.Distance(points.at(1)), 1e-8);
+	delete curve;
+	points.resize(1);
+	EXPECT_TRUE(WCNurbsCurve::GlobalInterpolation(NULL, points, 3) == NULL);
+}
+
+
+// Tests that a software context makes no GL objects and generates curves and surfaces on the CPU.
+TEST(WCNurbsCurveTest, SoftwareContext) {
+	WCGeometryContext context;
+	EXPECT_TRUE(context.IsSoftware());
+	EXPECT_EQ((WPUInt)NURBSCURVE_PERFLEVEL_LOW, context.CurvePerformanceLevel());
+	EXPECT_EQ((WPUInt)NURBSSURFACE_PERFLEVEL_LOW, context.SurfacePerformanceLevel());
+	EXPECT_TRUE(context.ShaderManager() == NULL);
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<6; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), 0.0, 1.0) );
+	WCNurbsCurve curve(&context, 3, controlPoints, WCNurbsMode::Default(), std::vector<WPFloat>());
+	WPUInt lod = 64;
+	GLfloat *data = curve.GenerateClientBuffer(0.0, 1.0, lod, false);
+	ASSERT_TRUE(data != NULL);
+	for (WPUInt i=0; i<lod; i+=7) {
+		WCVector4 pt = curve.Evaluate((WPFloat)i / (WPFloat)(lod - 1));
+		EXPECT_NEAR(pt.I(), data[i*4], 1e-5);
+		EXPECT_NEAR(pt.J(), data[i*4+1], 1e-5);
+	}
+	curve.ReleaseBuffer(data);
+	//Server buffers need GL, so none is made
+	GLuint buffer = 0;
+	curve.GenerateServerBuffer(0.0, 1.0, lod, buffer, false);
+	EXPECT_EQ((GLuint)0, buffer);
+	controlPoints.clear();
+	for (WPUInt v=0; v<5; v++)
+		for (WPUInt u=0; u<5; u++)
+			controlPoints.push_back( WCVector4((WPFloat)u, (WPFloat)v, sin((WPFloat)(u * v)), 1.0) );
+	WCNurbsSurface surface(&context, 3, 3, 5, 5, controlPoints, WCNurbsMode::Default(), WCNurbsMode::Default());
+	WPUInt lodU = 100, lodV = 100;
+	std::vector<GLfloat*> buffers = surface.GenerateClientBuffers(0.0, 1.0, lodU, 0.0, 1.0, lodV, false);
+	ASSERT_EQ(4u, buffers.size());
+	WCVector4 corner = surface.Evaluate(1.0, 1.0);
+	EXPECT_NEAR(corner.K(), buffers[0][(lodU * lodV - 1) * 4 + 2], 1e-5);
+	surface.ReleaseBuffers(buffers);
+}
+
+
+// Benchmark per-point versus batched curve evaluation.
+TEST(WCNurbsCurveTest, EvaluateManyBenchmark) {
+	std::vector<WCVector4> controlPoints;
+	for (WPUInt i=0; i<NURBSTEST_NUM_CP; i++)
+		controlPoints.push_back( WCVector4((WPFloat)i, sin((WPFloat)i), cos((WPFloat)i), 1.0) );
+	WCNurbsCurve curve(NULL, NURBSTEST_DEGREE, controlPoints, WCNurbsMode::Default());
+	GLfloat *points = new GLfloat[NURBSTEST_BENCH_LOD * 4];
+	GLfloat *data = new GLfloat[NURBSTEST_BENCH_LOD * 4];
+	WPFloat du = 1.0 / (NURBSTEST_BENCH_LOD - 1);
+	WCVector4 pt;
+	//Time the per-point loop
+	clock_t start = clock();
+	for (WPUInt i=0; i<NURBSTEST_BENCH_LOD; i++) {
+		pt = curve.Evaluate(du * i);
+		points[i*4] = (GLfloat)pt.I();
+		points[i*4+1] = (GLfloat)pt.J();
+		points[i*4+2] = (GLfloat)pt.K();
+		points[i*4+3] = (GLfloat)pt.L();
+	}
+	clock_t pointTime = clock() - start;
+	//Time the batched version
+	start = clock();
+	curve.EvaluateMany(0.0, 1.0, NURBSTEST_BENCH_LOD, data);
+	clock_t batchTime = clock() - start;
+	//Timings go to the test report (--gtest_output), only the results are checked
+	RecordProperty("PerPointMicroseconds", (int)(pointTime * 1000000.0 / CLOCKS_PER_SEC));
+	RecordProperty("BatchedMicroseconds", (int)(batchTime * 1000000.0 / CLOCKS_PER_SEC));
+	for (WPUInt i=0; i<NURBSTEST_BENCH_LOD * 4; i++) ASSERT_NEAR(points[i], data[i], 1e-5);
+	delete [] points;
+	delete [] data;
+}
+
+
+/***********************************************~***************************************************/
+
+
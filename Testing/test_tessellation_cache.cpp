@@ -0,0 +1,293 @@
+/*******************************************************************************
+ * Copyright (c) 2007, 2008, CerroKai Development
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of CerroKai Development nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <gtest/gtest.h>
+#include <Utility/tessellation_cache.h>
+#include <Utility/tessellation_store.h>
+#include <stdio.h>
+
+
+/*** Locally Defined Values ***/
+#define TESSCACHETEST_FLOATS			256
+#define TESSCACHETEST_BYTES				(TESSCACHETEST_FLOATS * sizeof(GLfloat))
+#define TESSCACHETEST_STORE				"tessellation_test.wildPart" TESSELLATIONSTORE_EXTENSION
+
+
+/***********************************************~***************************************************/
+
+
+static WCTessellationKey _Key(const void *object, const WPUInt &revision, const WPFloat &lod) {
+	//Client buffer style key for a fake object
+	WCTessellationKey key(object, revision, 0);
+	key.values[0] = lod;
+	return key;
+}
+
+
+static GLfloat* _Insert(WCTessellationCache &cache, const WCTessellationKey &key) {
+	//Hand a fresh buffer to the cache, still referenced by the caller
+	WCTessellation tess;
+	tess.buffers.push_back(new GLfloat[TESSCACHETEST_FLOATS]);
+	tess.counts.push_back(TESSCACHETEST_FLOATS);
+	cache.Insert(key, tess, TESSCACHETEST_BYTES);
+	return tess.buffers.at(0);
+}
+
+
+// Tests hits, misses and that keys differ by object, revision and values.
+TEST(WCTessellationCacheTest, HitsAndMisses) {
+	WCTessellationCache cache(TESSCACHETEST_BYTES * 8);
+	int a, b;
+	WCTessellation tess;
+	EXPECT_FALSE(cache.Acquire(_Key(&a, 0, 16.0), tess));
+	GLfloat *buffer = _Insert(cache, _Key(&a, 0, 16.0));
+	EXPECT_TRUE(cache.Release(buffer));
+	//Same key hits and hands back the same buffer
+	ASSERT_TRUE(cache.Acquire(_Key(&a, 0, 16.0), tess));
+	EXPECT_EQ(buffer, tess.buffers.at(0));
+	EXPECT_EQ((WPUInt)TESSCACHETEST_FLOATS, tess.counts.at(0));
+	EXPECT_TRUE(cache.Release(buffer));
+	//Any key difference misses
+	EXPECT_FALSE(cache.Acquire(_Key(&b, 0, 16.0), tess));
+	EXPECT_FALSE(cache.Acquire(_Key(&a, 1, 16.0), tess));
+	EXPECT_FALSE(cache.Acquire(_Key(&a, 0, 32.0), tess));
+	EXPECT_EQ((WPUInt)1, cache.Hits());
+	EXPECT_EQ((WPUInt)4, cache.Misses());
+	//Unknown buffers are not the cache's to release
+	GLfloat other[4];
+	EXPECT_FALSE(cache.Release(other));
+}
+
+
+// Tests least recently used eviction under the byte budget.
+TEST(WCTessellationCacheTest, EvictsLeastRecentlyUsed) {
+	WCTessellationCache cache(TESSCACHETEST_BYTES * 3);
+	int a;
+	WCTessellation tess;
+	for (WPUInt i=0; i<3; i++) cache.Release(_Insert(cache, _Key(&a, 0, (WPFloat)i)));
+	EXPECT_EQ((WPUInt)(TESSCACHETEST_BYTES * 3), cache.Bytes());
+	//Touch the oldest so the second becomes the victim
+	ASSERT_TRUE(cache.Acquire(_Key(&a, 0, 0.0), tess));
+	cache.Release(tess.buffers.at(0));
+	cache.Release(_Insert(cache, _Key(&a, 0, 3.0)));
+	EXPECT_EQ((WPUInt)1, cache.Evictions());
+	EXPECT_EQ((WPUInt)3, cache.Count());
+	EXPECT_FALSE(cache.Acquire(_Key(&a, 0, 1.0), tess));
+	EXPECT_TRUE(cache.Acquire(_Key(&a, 0, 0.0), tess));
+	cache.Release(tess.buffers.at(0));
+	//Shrinking the budget evicts down to it
+	cache.Budget(TESSCACHETEST_BYTES);
+	EXPECT_EQ((WPUInt)1, cache.Count());
+	EXPECT_EQ((WPUInt)TESSCACHETEST_BYTES, cache.Bytes());
+}
+
+
+// Tests that referenced tessellations survive eviction and invalidation until released.
+TEST(WCTessellationCacheTest, ReferencedEntriesAreKept) {
+	WCTessellationCache cache(TESSCACHETEST_BYTES);
+	int a;
+	WCTessellation tess;
+	GLfloat *first = _Insert(cache, _Key(&a, 0, 0.0));
+	GLfloat *second = _Insert(cache, _Key(&a, 0, 1.0));
+	//Both are handed out, so the cache runs over budget
+	EXPECT_EQ((WPUInt)2, cache.Count());
+	EXPECT_EQ((WPUInt)0, cache.Evictions());
+	//Releasing one lets it go
+	cache.Release(first);
+	EXPECT_EQ((WPUInt)1, cache.Count());
+	EXPECT_EQ((WPUInt)1, cache.Evictions());
+	//Invalidation hides the other but keeps it alive for its user
+	cache.Invalidate(&a);
+	EXPECT_FALSE(cache.Acquire(_Key(&a, 0, 1.0), tess));
+	EXPECT_EQ((WPUInt)1, cache.Count());
+	second[0] = 1.0f;
+	EXPECT_TRUE(cache.Release(second));
+	EXPECT_EQ((WPUInt)0, cache.Count());
+	EXPECT_EQ((WPUInt)0, cache.Bytes());
+}
+
+
+// Tests that a second insert of the same key keeps the first tessellation.
+TEST(WCTessellationCacheTest, DuplicateInsert) {
+	WCTessellationCache cache(TESSCACHETEST_BYTES * 4);
+	int a;
+	GLfloat *first = _Insert(cache, _Key(&a, 0, 0.0));
+	GLfloat *second = _Insert(cache, _Key(&a, 0, 0.0));
+	EXPECT_EQ(first, second);
+	EXPECT_EQ((WPUInt)1, cache.Count());
+	//Both references must be released before it can go
+	cache.Release(first);
+	cache.Release(second);
+	cache.Clear();
+	EXPECT_EQ((WPUInt)0, cache.Count());
+}
+
+
+
+static void _StoreRecord(WCTessellationStore &store, const WPHash &hash, const WPFloat &lod) {
+	//One buffer of known values, a count and two params
+	WCTessellation tess;
+	tess.buffers.push_back(new GLfloat[TESSCACHETEST_FLOATS]);
+	for (WPUInt i=0; i<TESSCACHETEST_FLOATS; i++) tess.buffers.at(0)[i] = (GLfloat)i * (GLfloat)lod;
+	tess.counts.push_back(TESSCACHETEST_FLOATS);
+	tess.params.push_back(0.25);
+	tess.params.push_back(lod);
+	EXPECT_TRUE(store.Store(hash, _Key(NULL, 0, lod), tess, std::vector<WPUInt>(1, TESSCACHETEST_FLOATS)));
+	delete [] tess.buffers.at(0);
+}
+
+
+static long _FileSize(const char *path) {
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) return -1;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+
+// Tests that records written in one session load in the next.
+TEST(WCTessellationStoreTest, RoundTrip) {
+	remove(TESSCACHETEST_STORE);
+	WCTessellation tess;
+	{
+		WCTessellationStore store(TESSCACHETEST_STORE);
+		EXPECT_EQ((WPUInt)0, store.Count());
+		EXPECT_FALSE(store.Find(42, _Key(NULL, 0, 2.0), tess));
+		_StoreRecord(store, 42, 2.0);
+		_StoreRecord(store, 42, 3.0);
+		_StoreRecord(store, 43, 2.0);
+	}
+	WCTessellationStore store(TESSCACHETEST_STORE);
+	EXPECT_EQ((WPUInt)3, store.Count());
+	ASSERT_TRUE(store.Find(42, _Key(NULL, 0, 3.0), tess));
+	ASSERT_EQ((WPUInt)1, tess.buffers.size());
+	EXPECT_EQ((WPUInt)TESSCACHETEST_FLOATS, tess.counts.at(0));
+	ASSERT_EQ((WPUInt)2, tess.params.size());
+	EXPECT_EQ(3.0, tess.params.at(1));
+	for (WPUInt i=0; i<TESSCACHETEST_FLOATS; i++) EXPECT_EQ((GLfloat)i * 3.0f, tess.buffers.at(0)[i]);
+	delete [] tess.buffers.at(0);
+	//The object and revision of the key do not matter on disk
+	EXPECT_FALSE(store.Find(44, _Key(NULL, 0, 2.0), tess));
+	EXPECT_EQ((WPUInt)1, store.Hits());
+	EXPECT_EQ((WPUInt)1, store.Misses());
+	remove(TESSCACHETEST_STORE);
+}
+
+
+// Tests that a corrupt record is rejected and a damaged tail is cut off.
+TEST(WCTessellationStoreTest, IntegrityChecks) {
+	remove(TESSCACHETEST_STORE);
+	{
+		WCTessellationStore store(TESSCACHETEST_STORE);
+		_StoreRecord(store, 7, 1.0);
+		_StoreRecord(store, 7, 2.0);
+	}
+	long size = _FileSize(TESSCACHETEST_STORE);
+	//Flip a byte in the last buffer and append some garbage
+	FILE *file = fopen(TESSCACHETEST_STORE, "r+b");
+	ASSERT_TRUE(file != NULL);
+	fseek(file, size - 8, SEEK_SET);
+	fputc(0x5A, file);
+	fseek(file, 0, SEEK_END);
+	fputs("garbage", file);
+	fclose(file);
+	WCTessellation tess;
+	{
+		WCTessellationStore store(TESSCACHETEST_STORE);
+		EXPECT_EQ((WPUInt)2, store.Count());
+		EXPECT_FALSE(store.Find(7, _Key(NULL, 0, 2.0), tess));
+		EXPECT_EQ((WPUInt)1, store.Rejects());
+		ASSERT_TRUE(store.Find(7, _Key(NULL, 0, 1.0), tess));
+		delete [] tess.buffers.at(0);
+		//Writing again first removes the garbage
+		_StoreRecord(store, 8, 1.0);
+	}
+	WCTessellationStore store(TESSCACHETEST_STORE);
+	EXPECT_EQ((WPUInt)3, store.Count());
+	EXPECT_TRUE(store.Find(8, _Key(NULL, 0, 1.0), tess));
+	delete [] tess.buffers.at(0);
+	remove(TESSCACHETEST_STORE);
+}
+
+
+// Tests that a file from another version is discarded and rebuilt.
+TEST(WCTessellationStoreTest, VersionMismatch) {
+	FILE *file = fopen(TESSCACHETEST_STORE, "wb");
+	ASSERT_TRUE(file != NULL);
+	fputs("WCTESS\r\nold version data that is long enough", file);
+	fclose(file);
+	{
+		WCTessellationStore store(TESSCACHETEST_STORE);
+		EXPECT_EQ((WPUInt)0, store.Count());
+		_StoreRecord(store, 9, 1.0);
+	}
+	WCTessellationStore store(TESSCACHETEST_STORE);
+	EXPECT_EQ((WPUInt)1, store.Count());
+	remove(TESSCACHETEST_STORE);
+}
+
+
+// Tests that a replaced store stays usable until its last holder releases it.
+TEST(WCTessellationStoreTest, ActivateWhileHeld) {
+	remove(TESSCACHETEST_STORE);
+	WCTessellationStore::Activate(new WCTessellationStore(TESSCACHETEST_STORE));
+	WCTessellationStore *held = WCTessellationStore::AcquireActive();
+	ASSERT_TRUE(held != NULL);
+	EXPECT_EQ(held, WCTessellationStore::Active());
+	//Replacing the store only drops the active slot's reference
+	WCTessellationStore::Activate(NULL);
+	EXPECT_TRUE(WCTessellationStore::Active() == NULL);
+	EXPECT_TRUE(WCTessellationStore::AcquireActive() == NULL);
+	WCTessellation tess;
+	EXPECT_FALSE(held->Find(11, _Key(NULL, 0, 1.0), tess));
+	EXPECT_EQ((WPUInt)1, held->Misses());
+	_StoreRecord(*held, 11, 1.0);
+	WCTessellationStore::Release(held);
+	remove(TESSCACHETEST_STORE);
+}
+
+
+// Tests that equal content hashes equally and any change alters the hash.
+TEST(WCTessellationStoreTest, ContentHash) {
+	WCContentHash a, b, c;
+	a.Add((WPUInt)3);
+	a.Add(0.0);
+	b.Add((WPUInt)3);
+	b.Add(-0.0);
+	c.Add((WPUInt)3);
+	c.Add(1e-12);
+	EXPECT_EQ(a.Value(), b.Value());
+	EXPECT_NE(a.Value(), c.Value());
+}
+
+
+/***********************************************~***************************************************/
+
@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * Copyright (c) 2007, 2008, CerroKai Development
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of CerroKai Development nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY CerroKai Development ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CerroKai Development BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ********************************************************************************/
+
+
+/*** Included Header Files ***/
+#include <gtest/gtest.h>
+#include <Utility/thread_pool.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <stdio.h>
+
+
+/*** Locally Defined Values ***/
+#define THREADPOOLTEST_COUNT			1000
+#define THREADPOOLTEST_BENCH_ROWS		256
+#define THREADPOOLTEST_BENCH_WORK		20000
+
+
+/***********************************************~***************************************************/
+
+
+static void _MarkIndex(void *data, const WPUInt &index) {
+	//Count how many times each index runs
+	((WPUInt*)data)[index]++;
+}
+
+
+static void _NestedIndex(void *data, const WPUInt &index) {
+	//Nested jobs must run inline on the calling thread
+	WPUInt *counts = (WPUInt*)data;
+	WCThreadPool::Shared()->ParallelFor(4, _MarkIndex, counts + index * 4);
+}
+
+
+//Shared between a test and the job it runs on another thread
+struct _ThreadPoolTestJob {
+	WCThreadPool								*pool;
+	pthread_t									threads[64];
+	volatile WPUInt								started;
+};
+
+
+static void _SlowIndex(void *data, const WPUInt &index) {
+	//Record the running thread, slowly enough that the workers all join in
+	_ThreadPoolTestJob *job = (_ThreadPoolTestJob*)data;
+	job->started = 1;
+	usleep(1000);
+	job->threads[index] = pthread_self();
+}
+
+
+static void* _RunSlowJob(void *data) {
+	_ThreadPoolTestJob *job = (_ThreadPoolTestJob*)data;
+	job->pool->ParallelFor(64, _SlowIndex, job);
+	return NULL;
+}
+
+
+//Count the distinct threads that ran a job
+static WPUInt _ThreadPoolTestThreads(const _ThreadPoolTestJob &job) {
+	WPUInt count = 0, i, j;
+	for (i=0; i<64; i++) {
+		for (j=0; (j < i) && !pthread_equal(job.threads[i], job.threads[j]); j++) ;
+		if (j == i) count++;
+	}
+	return count;
+}
+
+
+static void _WorkRow(void *data, const WPUInt &index) {
+	//Synthetic per-row tessellation cost
+	WPFloat sum = 0.0;
+	for (WPUInt i=0; i<THREADPOOLTEST_BENCH_WORK; i++) sum += sin((WPFloat)(index * THREADPOOLTEST_BENCH_WORK + i) * 0.001);
+	((WPFloat*)data)[index] = sum;
+}
+
+
+static double _WallSeconds(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec * 1e-6;
+}
+
+
+// Tests that every index runs exactly once for several pool sizes.
+TEST(WCThreadPoolTest, EveryIndexOnce) {
+	WPUInt counts[THREADPOOLTEST_COUNT];
+	for (WPUInt threads=1; threads<=8; threads*=2) {
+		WCThreadPool pool(threads);
+		EXPECT_EQ(threads, pool.ThreadCount());
+		for (WPUInt i=0; i<THREADPOOLTEST_COUNT; i++) counts[i] = 0;
+		pool.ParallelFor(THREADPOOLTEST_COUNT, _MarkIndex, counts);
+		for (WPUInt i=0; i<THREADPOOLTEST_COUNT; i++) EXPECT_EQ((WPUInt)1, counts[i]);
+		//Reuse the same workers for a second job
+		pool.ParallelFor(THREADPOOLTEST_COUNT, _MarkIndex, counts);
+		for (WPUInt i=0; i<THREADPOOLTEST_COUNT; i++) EXPECT_EQ((WPUInt)2, counts[i]);
+	}
+}
+
+
+// Tests that a job issued from inside a job completes instead of deadlocking.
+TEST(WCThreadPoolTest, NestedJobs) {
+	WPUInt counts[64 * 4];
+	for (WPUInt i=0; i<64*4; i++) counts[i] = 0;
+	WCThreadPool::SharedThreadCount(4);
+	WCThreadPool::Shared()->ParallelFor(64, _NestedIndex, counts);
+	for (WPUInt i=0; i<64*4; i++) EXPECT_EQ((WPUInt)1, counts[i]);
+	WCThreadPool::SharedThreadCount(0);
+	EXPECT_EQ(WCThreadPool::ProcessorCount(), WCThreadPool::Shared()->ThreadCount());
+	WCThreadPool::Terminate();
+}
+
+
+// Tests that jobs from two threads at once both run in parallel rather than one inline.
+TEST(WCThreadPoolTest, ConcurrentCallers) {
+	WCThreadPool pool(4);
+	_ThreadPoolTestJob first, second;
+	first.pool = second.pool = &pool;
+	first.started = second.started = 0;
+	pthread_t thread;
+	ASSERT_EQ(0, pthread_create(&thread, NULL, _RunSlowJob, &first));
+	while (!first.started) usleep(100);
+	//The pool is busy - this waits its turn instead of running serially
+	_RunSlowJob(&second);
+	pthread_join(thread, NULL);
+	EXPECT_GT(_ThreadPoolTestThreads(first), (WPUInt)1);
+	EXPECT_GT(_ThreadPoolTestThreads(second), (WPUInt)1);
+}
+
+
+// Tests that resizing the shared pool waits for a job running on another thread.
+TEST(WCThreadPoolTest, ResizeWhileRunning) {
+	_ThreadPoolTestJob job;
+	WCThreadPool::SharedThreadCount(4);
+	job.pool = WCThreadPool::Shared();
+	job.started = 0;
+	for (WPUInt i=0; i<64; i++) job.threads[i] = pthread_self();
+	pthread_t thread;
+	ASSERT_EQ(0, pthread_create(&thread, NULL, _RunSlowJob, &job));
+	while (!job.started) usleep(100);
+	WCThreadPool::SharedThreadCount(2);
+	//Every index finished on a pool thread before the old pool went away
+	for (WPUInt i=0; i<64; i++) EXPECT_FALSE(pthread_equal(pthread_self(), job.threads[i]));
+	EXPECT_EQ((WPUInt)2, WCThreadPool::Shared()->ThreadCount());
+	pthread_join(thread, NULL);
+	WCThreadPool::Terminate();
+}
+
+
+// Benchmark row-parallel work for increasing thread counts (results must not depend on the count).
+TEST(WCThreadPoolTest, ScalingBenchmark) {
+	WPFloat serial[THREADPOOLTEST_BENCH_ROWS], parallel[THREADPOOLTEST_BENCH_ROWS];
+	WCThreadPool single(1);
+	double start = _WallSeconds();
+	single.ParallelFor(THREADPOOLTEST_BENCH_ROWS, _WorkRow, serial);
+	double base = _WallSeconds() - start;
+	//Timings go to the test report (--gtest_output), only the results are checked
+	RecordProperty("Threads1Microseconds", (int)(base * 1000000.0));
+	char key[32];
+	WPUInt maxThreads = STDMAX((WPUInt)4, STDMIN(WCThreadPool::ProcessorCount(), (WPUInt)16));
+	for (WPUInt threads=2; threads<=maxThreads; threads*=2) {
+		WCThreadPool pool(threads);
+		start = _WallSeconds();
+		pool.ParallelFor(THREADPOOLTEST_BENCH_ROWS, _WorkRow, parallel);
+		double elapsed = _WallSeconds() - start;
+		sprintf(key, "Threads%luMicroseconds", threads);
+		RecordProperty(key, (int)(elapsed * 1000000.0));
+		for (WPUInt i=0; i<THREADPOOLTEST_BENCH_ROWS; i++) EXPECT_EQ(serial[i], parallel[i]);
+	}
+}
+
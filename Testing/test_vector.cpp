@@ -30,10 +30,12 @@
 #include <gtest/gtest.h>
 #include <Utility/vector.h>
 #include <Utility/matrix.h>
+#include <time.h>
 
 
 /*** Locally Defined Values ***/
-//None
+#define VECTORTEST_BENCH_COUNT			4096
+#define VECTORTEST_BENCH_REPEAT			500
 
 
 /***********************************************~***************************************************/
@@ -379,5 +381,173 @@ WCVector4 CrossProduct(const WCVector4 &vector) const;											//!< Return the
 */
  
  
+// Tests the dot product.
+TEST(WCVector4Test, DotProduct) {
+	WCVector4 vec1(1.0, 2.0, 3.0, 4.0);
+	WCVector4 vec2(10.0, 20.0, 30.0, 40.0);
+	EXPECT_DOUBLE_EQ(300.0, vec1.DotProduct(vec2));
+}
+
+
+// Tests that batched dot products match single dot products (odd count hits the remainder path).
+TEST(WCVector4Test, DotProductMany) {
+	WPFloat a[4*7], b[4*7], out[7];
+	for (int i=0; i<4*7; i++) {
+		a[i] = sin((WPFloat)i);
+		b[i] = cos((WPFloat)i * 0.5);
+	}
+	WCVector4::DotProductMany(a, b, out, 7);
+	for (int i=0; i<7; i++) {
+		WCVector4 va(a + i*4), vb(b + i*4);
+		EXPECT_NEAR(va.DotProduct(vb), out[i], 1e-12);
+	}
+}
+
+
+// Tests matrix times vector and vector times matrix.
+TEST(WCMatrix4Test, VectorMultiplication) {
+	WCMatrix4 mat(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0, 13.0, 14.0, 15.0, 16.0);
+	WCVector4 vec(1.0, -1.0, 2.0, 0.5);
+	WCVector4 col = mat * vec;
+	EXPECT_DOUBLE_EQ(7.0, col.I());
+	EXPECT_DOUBLE_EQ(17.0, col.J());
+	EXPECT_DOUBLE_EQ(27.0, col.K());
+	EXPECT_DOUBLE_EQ(37.0, col.L());
+	WCVector4 row = vec * mat;
+	EXPECT_DOUBLE_EQ(20.5, row.I());
+	EXPECT_DOUBLE_EQ(23.0, row.J());
+	EXPECT_DOUBLE_EQ(25.5, row.K());
+	EXPECT_DOUBLE_EQ(28.0, row.L());
+}
+
+
+// Tests matrix multiplication against a plain triple loop.
+TEST(WCMatrix4Test, MatrixMultiplication) {
+	WCMatrix4 a, b;
+	for (int i=0; i<4; i++)
+		for (int j=0; j<4; j++) {
+			a.Set(i, j, (WPFloat)(i * 4 + j) - 3.5);
+			b.Set(i, j, 1.0 / (WPFloat)(i + j + 1));
+		}
+	WCMatrix4 c = a * b;
+	for (int i=0; i<4; i++)
+		for (int j=0; j<4; j++) {
+			WPFloat sum = 0.0;
+			for (int k=0; k<4; k++) sum += a.Get(i, k) * b.Get(k, j);
+			EXPECT_NEAR(sum, c.Get(i, j), 1e-12);
+		}
+}
+
+
+// Tests that batched transforms match single transforms (including in place).
+TEST(WCMatrix4Test, TransformMany) {
+	WCMatrix4 mat(0.5, 2.0, -3.0, 4.0, 5.0, 0.25, 7.0, -8.0, 9.0, 1.0, 1.5, 12.0, 0.0, 0.0, 0.0, 1.0);
+	std::vector<WCVector4> points;
+	for (int i=0; i<9; i++) points.push_back( WCVector4(sin((WPFloat)i), cos((WPFloat)i), (WPFloat)i, 1.0) );
+	std::vector<WCVector4> expected;
+	for (int i=0; i<9; i++) expected.push_back( mat * points.at(i) );
+	mat.TransformMany(points);
+	for (int i=0; i<9; i++) {
+		EXPECT_NEAR(expected.at(i).I(), points.at(i).I(), 1e-12);
+		EXPECT_NEAR(expected.at(i).J(), points.at(i).J(), 1e-12);
+		EXPECT_NEAR(expected.at(i).K(), points.at(i).K(), 1e-12);
+		EXPECT_NEAR(expected.at(i).L(), points.at(i).L(), 1e-12);
+	}
+}
+
+
+// Tests fixed-size matrix products against a direct sum.
+TEST(WCMatrixNTest, Multiplication) {
+	WPFloat aData[12], bData[8];
+	for (int i=0; i<12; i++) aData[i] = (WPFloat)i * 0.5 - 2.0;
+	for (int i=0; i<8; i++) bData[i] = 1.0 / (WPFloat)(i + 1);
+	WCMatrixN<3,4> a(aData);
+	WCMatrixN<4,2> b(bData);
+	WCMatrixN<3,2> c = a * b;
+	for (int i=0; i<3; i++)
+		for (int j=0; j<2; j++) {
+			WPFloat sum = 0.0;
+			for (int k=0; k<4; k++) sum += aData[i*4+k] * bData[k*2+j];
+			EXPECT_NEAR(sum, c.Get(i, j), 1e-12);
+		}
+	//Row vector product and transpose
+	WCVectorN<3> v(1.0);
+	WCVectorN<4> vb = v * a;
+	WCVectorN<4> vt = a.Transpose() * v;
+	for (int j=0; j<4; j++) {
+		EXPECT_NEAR(aData[j] + aData[4+j] + aData[8+j], vb.Get(j), 1e-12);
+		EXPECT_NEAR(vb.Get(j), vt.Get(j), 1e-12);
+	}
+}
+
+
+// Tests the fixed-size linear solver.
+TEST(WCMatrixNTest, Solve) {
+	WPFloat aData[9] = { 0.0, 2.0, 1.0,  1.0, 1.0, 0.0,  3.0, 0.0, 4.0 };
+	WCMatrixN<3,3> a(aData);
+	WPFloat xData[3] = { 1.0, -2.0, 0.5 };
+	WCVectorN<3> x(xData), b = a * x, solved;
+	EXPECT_TRUE(a.Solve(b, solved));
+	for (int i=0; i<3; i++) EXPECT_NEAR(xData[i], solved.Get(i), 1e-12);
+	WPFloat sData[4] = { 1.0, 2.0, 2.0, 4.0 };
+	WCMatrixN<2,2> singular(sData);
+	WCVectorN<2> unused;
+	EXPECT_FALSE(singular.Solve(WCVectorN<2>(1.0), unused));
+	//Nearly singular systems are only rejected with a tolerance
+	sData[3] = 4.0 + 1e-14;
+	WCMatrixN<2,2> nearly(sData);
+	EXPECT_TRUE(nearly.Solve(WCVectorN<2>(1.0), unused));
+	EXPECT_FALSE(nearly.Solve(WCVectorN<2>(1.0), unused, 1e-12));
+}
+
+
+// Benchmark scalar per-point transforms and dots versus the batched kernels.
+TEST(WCMatrix4Test, BatchedKernelBenchmark) {
+	WCMatrix4 mat(0.5, 2.0, -3.0, 4.0, 5.0, 0.25, 7.0, -8.0, 9.0, 1.0, 1.5, 12.0, 0.0, 0.0, 0.0, 1.0);
+	WPFloat *in = new WPFloat[VECTORTEST_BENCH_COUNT * 4];
+	WPFloat *out = new WPFloat[VECTORTEST_BENCH_COUNT * 4];
+	WPFloat *dots = new WPFloat[VECTORTEST_BENCH_COUNT];
+	const WPFloat *m = mat.GetData();
+	for (int i=0; i<VECTORTEST_BENCH_COUNT * 4; i++) in[i] = (WPFloat)(i % 97) * 0.01;
+	memset(out, 0, VECTORTEST_BENCH_COUNT * 4 * sizeof(WPFloat));
+	memset(dots, 0, VECTORTEST_BENCH_COUNT * sizeof(WPFloat));
+	//Scalar transforms
+	clock_t start = clock();
+	for (int n=0; n<VECTORTEST_BENCH_REPEAT; n++)
+		for (int i=0; i<VECTORTEST_BENCH_COUNT; i++) {
+			const WPFloat *p = in + i*4;
+			for (int r=0; r<4; r++)
+				out[i*4+r] = m[r*4]*p[0] + m[r*4+1]*p[1] + m[r*4+2]*p[2] + m[r*4+3]*p[3];
+		}
+	clock_t scalarTime = clock() - start;
+	WPFloat scalarCheck = out[VECTORTEST_BENCH_COUNT * 4 - 3];
+	//Batched transforms
+	start = clock();
+	for (int n=0; n<VECTORTEST_BENCH_REPEAT; n++) mat.TransformMany(in, out, VECTORTEST_BENCH_COUNT);
+	clock_t batchTime = clock() - start;
+	EXPECT_NEAR(scalarCheck, out[VECTORTEST_BENCH_COUNT * 4 - 3], 1e-9);
+	//Scalar dots
+	start = clock();
+	for (int n=0; n<VECTORTEST_BENCH_REPEAT; n++)
+		for (int i=0; i<VECTORTEST_BENCH_COUNT; i++)
+			dots[i] = in[i*4]*out[i*4] + in[i*4+1]*out[i*4+1] + in[i*4+2]*out[i*4+2] + in[i*4+3]*out[i*4+3];
+	clock_t scalarDotTime = clock() - start;
+	scalarCheck = dots[VECTORTEST_BENCH_COUNT - 1];
+	//Batched dots
+	start = clock();
+	for (int n=0; n<VECTORTEST_BENCH_REPEAT; n++) WCVector4::DotProductMany(in, out, dots, VECTORTEST_BENCH_COUNT);
+	clock_t batchDotTime = clock() - start;
+	EXPECT_NEAR(scalarCheck, dots[VECTORTEST_BENCH_COUNT - 1], 1e-9);
+	//Timings go to the test report (--gtest_output), only the results are checked
+	RecordProperty("ScalarTransformMicroseconds", (int)(scalarTime * 1000000.0 / CLOCKS_PER_SEC));
+	RecordProperty("BatchedTransformMicroseconds", (int)(batchTime * 1000000.0 / CLOCKS_PER_SEC));
+	RecordProperty("ScalarDotMicroseconds", (int)(scalarDotTime * 1000000.0 / CLOCKS_PER_SEC));
+	RecordProperty("BatchedDotMicroseconds", (int)(batchDotTime * 1000000.0 / CLOCKS_PER_SEC));
+	delete [] in;
+	delete [] out;
+	delete [] dots;
+}
+ 
+ 
 /***********************************************~***************************************************/
 